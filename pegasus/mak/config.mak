@@ -1467,6 +1467,29 @@ else
   endif
 endif
 
+##==============================================================================
+##
+## PEGASUS_ENABLE_HTTP_COMPRESSION
+##
+##     Enables gzip and deflate compression of HTTP message bodies. The CIM
+##     Server compresses CIM-XML and WS-Management responses for clients that
+##     send an Accept-Encoding header, and the client library requests and
+##     decodes compressed responses. Requires zlib.
+##
+##==============================================================================
+
+ifndef PEGASUS_ENABLE_HTTP_COMPRESSION
+  PEGASUS_ENABLE_HTTP_COMPRESSION=false
+endif
+
+ifeq ($(PEGASUS_ENABLE_HTTP_COMPRESSION),true)
+  DEFINES += -DPEGASUS_ENABLE_HTTP_COMPRESSION
+else
+  ifneq ($(PEGASUS_ENABLE_HTTP_COMPRESSION),false)
+    $(error "PEGASUS_ENABLE_HTTP_COMPRESSION must be true or false")
+  endif
+endif
+
 ## ======================================================================
 ##
 ## PLATFORM_CORE_PATTERN
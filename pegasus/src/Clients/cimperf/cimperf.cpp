@@ -32,7 +32,9 @@
 /* This is a simplistic display program for the CIMOM performance
     characteristics.
     This version simply gets the instances of the performace class and displays
-    the resulting average counts.
+    the resulting average counts, or with the -H option the percentiles of
+    the server time, provider time and response size per operation type and
+    the provider time percentiles per provider module.
     TODO  KS
     1. Convert to use the correct class when it is available.
     2. Get the header information from the class, not fixed.
@@ -236,6 +238,9 @@ void GetOptions(
         {"password","",false,Option::STRING, 0, 0, "w",
                 "login password for user"},
 
+        {"histogram", "false", false, Option::BOOLEAN, 0, 0, "H",
+                "Displays the p50/p90/p99/p999 percentiles "},
+
     };
     const Uint32 NUM_OPTIONS = sizeof(optionsTable) / sizeof(optionsTable[0]);
 
@@ -370,6 +375,175 @@ const char* opTypeToOpName(Uint16 type)
     return opName;
 }
 
+// The percentile instances have an InstanceID of the form
+// CIM_CIMOMStatisticalData_<OperationType or module>_<percentile>
+static const char _HISTOGRAM_INSTANCE_ID_PREFIX[] = "CIM_CIMOMStatisticalData_";
+
+static String _getStringProperty(const CIMInstance& instance, const char* name)
+{
+    String value;
+    Uint32 pos = instance.findProperty(name);
+
+    if (pos != PEG_NOT_FOUND)
+    {
+        CIMValue v = instance.getProperty(pos).getValue();
+
+        if (!v.isNull() && v.getType() == CIMTYPE_STRING)
+        {
+            v.get(value);
+        }
+    }
+
+    return value;
+}
+
+static Boolean _isHistogramInstance(const CIMInstance& instance)
+{
+    return String::compare(
+        _getStringProperty(instance, "InstanceID"),
+        _HISTOGRAM_INSTANCE_ID_PREFIX,
+        sizeof(_HISTOGRAM_INSTANCE_ID_PREFIX) - 1) == 0;
+}
+
+// Returns false if the instance has no (non-null) value for the property
+static Boolean _getUint64Property(
+    const CIMInstance& instance,
+    const char* name,
+    Uint64& value)
+{
+    Uint32 pos = instance.findProperty(name);
+
+    if (pos == PEG_NOT_FOUND)
+    {
+        return false;
+    }
+
+    CIMValue v = instance.getProperty(pos).getValue();
+
+    if (v.isNull())
+    {
+        return false;
+    }
+
+    if (v.getType() == CIMTYPE_DATETIME)
+    {
+        CIMDateTime dateTime;
+        v.get(dateTime);
+        value = dateTime.toMicroSeconds();
+        return true;
+    }
+
+    if (v.getType() == CIMTYPE_UINT64)
+    {
+        v.get(value);
+        return true;
+    }
+
+    return false;
+}
+
+static void _printHistogramRow(
+    const char* label,
+    const Uint64* values,
+    Uint32 count)
+{
+    printf("  %-25s", label);
+
+    for (Uint32 i = 0; i < count; i++)
+    {
+        printf("%11" PEGASUS_64BIT_CONVERSION_WIDTH "u", values[i]);
+    }
+
+    printf("\n");
+}
+
+/* Prints the percentile instances, which are grouped by operation type or
+   provider module, one table for each group. */
+
+static void _printHistograms(const Array<CIMInstance>& instances)
+{
+    const Uint32 MAX_PERCENTILES = 8;
+    Uint32 inst = 0;
+
+    while (inst < instances.size())
+    {
+        if (!_isHistogramInstance(instances[inst]))
+        {
+            inst++;
+            continue;
+        }
+
+        // The OtherOperationType is "<OperationType or module> <percentile>"
+        String other =
+            _getStringProperty(instances[inst], "OtherOperationType");
+        Uint32 blank = other.reverseFind(' ');
+        String group = other.subString(0, blank);
+
+        Uint64 count = 0;
+        _getUint64Property(instances[inst], "NumberOfOperations", count);
+
+        String percentiles[MAX_PERCENTILES];
+        Uint64 serverTime[MAX_PERCENTILES];
+        Uint64 providerTime[MAX_PERCENTILES];
+        Uint64 responseSize[MAX_PERCENTILES];
+        Boolean hasServerTime = true;
+        Boolean hasResponseSize = true;
+        Uint32 n = 0;
+
+        for (; inst < instances.size() && n < MAX_PERCENTILES; inst++)
+        {
+            other = _getStringProperty(instances[inst], "OtherOperationType");
+            blank = other.reverseFind(' ');
+
+            if (!_isHistogramInstance(instances[inst]) ||
+                blank == PEG_NOT_FOUND ||
+                other.subString(0, blank) != group)
+            {
+                break;
+            }
+
+            percentiles[n] = other.subString(blank + 1);
+            providerTime[n] = 0;
+            _getUint64Property(
+                instances[inst], "ProviderElapsedTime", providerTime[n]);
+            hasServerTime = _getUint64Property(
+                instances[inst], "CimomElapsedTime", serverTime[n]) &&
+                hasServerTime;
+            hasResponseSize = _getUint64Property(
+                instances[inst], "ResponseSize", responseSize[n]) &&
+                hasResponseSize;
+            n++;
+        }
+
+        if (n == 0)
+        {
+            // Not a percentile of an operation type or module
+            inst++;
+            continue;
+        }
+
+        printf("%s: %" PEGASUS_64BIT_CONVERSION_WIDTH "u requests\n",
+            (const char*)group.getCString(), count);
+        printf("  %-25s", " ");
+        for (Uint32 i = 0; i < n; i++)
+        {
+            printf("%11s", (const char*)percentiles[i].getCString());
+        }
+        printf("\n");
+
+        if (hasServerTime)
+        {
+            _printHistogramRow("Server Time (usec)", serverTime, n);
+        }
+        _printHistogramRow("Provider Time (usec)", providerTime, n);
+        if (hasResponseSize)
+        {
+            _printHistogramRow("Response Size (bytes)", responseSize, n);
+        }
+        printf("\n");
+    }
+}
+
 int main(int argc, char** argv)
 {
 
@@ -484,6 +658,12 @@ int main(int argc, char** argv)
             includeQualifiers,
             includeClassOrigin);
 
+        if (om.isTrue("histogram"))
+        {
+            _printHistograms(instances);
+            return 0;
+        }
+
         // First print the header for table of values
         printf("%-25s%10s %10s %10s %10s %10s\n",
             "Operation", "Number of", "Server", "Provider", "Request",
@@ -509,6 +689,12 @@ int main(int argc, char** argv)
         {
             CIMInstance instance = instances[inst];
 
+            // The percentiles are displayed with the -H option
+            if (_isHistogramInstance(instance))
+            {
+                continue;
+            }
+
             // Get the request type property for this instance.
             // Note that for the moment it is simply an integer.
             Uint32 pos;
@@ -533,6 +719,16 @@ int main(int argc, char** argv)
                 statName = "UNKNOWN";
             }
 
+            // The instances of OperationType "Other" other than InvokeMethod
+            // are named by the OtherOperationType
+            String otherOperationType =
+                _getStringProperty(instance, "OtherOperationType");
+            CString otherName = otherOperationType.getCString();
+            if (otherOperationType.size())
+            {
+                statName = otherName;
+            }
+
             // Get number of requests property - "NumberofOperations"
             Uint64 numberOfRequests = 0;
             if ((pos = instance.findProperty("NumberOfOperations")) !=
@@ -470,6 +470,55 @@ CIMValue CIMClient::invokeMethod(
         outParameters);
 }
 
+Array<CIMInstance> CIMClient::openEnumerateInstances(
+    String& enumerationContext,
+    Boolean& endOfSequence,
+    const CIMNamespaceName& nameSpace,
+    const CIMName& className,
+    Boolean deepInheritance,
+    Boolean includeClassOrigin,
+    const CIMPropertyList& propertyList,
+    const String& filterQueryLanguage,
+    const String& filterQuery,
+    Uint32 operationTimeout,
+    Boolean continueOnError,
+    Uint32 maxObjectCount)
+{
+    return _rep->openEnumerateInstances(
+        enumerationContext,
+        endOfSequence,
+        nameSpace,
+        className,
+        deepInheritance,
+        includeClassOrigin,
+        propertyList,
+        filterQueryLanguage,
+        filterQuery,
+        operationTimeout,
+        continueOnError,
+        maxObjectCount).getInstances();
+}
+
+Array<CIMInstance> CIMClient::pullInstancesWithPath(
+    String& enumerationContext,
+    Boolean& endOfSequence,
+    const CIMNamespaceName& nameSpace,
+    Uint32 maxObjectCount)
+{
+    return _rep->pullInstancesWithPath(
+        enumerationContext,
+        endOfSequence,
+        nameSpace,
+        maxObjectCount).getInstances();
+}
+
+void CIMClient::closeEnumeration(
+    const String& enumerationContext,
+    const CIMNamespaceName& nameSpace)
+{
+    _rep->closeEnumeration(enumerationContext, nameSpace);
+}
+
 void CIMClient::registerClientOpPerformanceDataHandler(
     ClientOpPerformanceDataHandler& handler)
 {
@@ -943,6 +943,110 @@ public:
         const Array<CIMParamValue>& inParameters,
         Array<CIMParamValue>& outParameters);
 
+    /**
+        Opens a pull enumeration of the CIM Instances of a specified Class and
+        its subclasses in a target namespace, and returns the first
+        Instances.  The server keeps at most about maxObjectCount Instances
+        of the enumeration in memory while it waits for the next
+        pullInstancesWithPath() call.
+
+        @param enumerationContext Output String that identifies the open
+            enumeration in subsequent pullInstancesWithPath() and
+            closeEnumeration() calls.
+        @param endOfSequence Output Boolean set to true if the returned
+            Instances complete the enumeration, in which case the server has
+            closed it.
+        @param nameSpace A CIMNamespaceName that specifies the target namespace.
+        @param className A CIMName that specifies the CIM Class for which to
+            enumerate Instances.
+        @param deepInheritance A Boolean indicating whether the Instances
+            include the Properties added by subclasses of className.
+        @param includeClassOrigin A Boolean indicating whether the CLASSORIGIN
+            attribute is included in the returned Properties.
+        @param propertyList A CIMPropertyList that limits the Properties
+            included in the returned Instances.
+        @param filterQueryLanguage The language of filterQuery.  Not supported
+            by the OpenPegasus server; must be empty.
+        @param filterQuery A query that filters the returned Instances.  Not
+            supported by the OpenPegasus server; must be empty.
+        @param operationTimeout The number of seconds the server keeps the
+            enumeration open between two operations.  Zero selects the server
+            default.
+        @param continueOnError Whether the enumeration continues after an
+            error.  Not supported by the OpenPegasus server; must be false.
+        @param maxObjectCount The maximum number of Instances to return.
+
+        @return An Array of zero or more CIMInstance objects with their full
+            paths.
+
+        @exception CIMException If the CIM Server fails to perform the
+            requested operation.  See DSP0200 for specific CIM Status Codes
+            that may be expected.
+        @exception Exception If an error occurs while sending the request or
+            receiving the response.
+    */
+    Array<CIMInstance> openEnumerateInstances(
+        String& enumerationContext,
+        Boolean& endOfSequence,
+        const CIMNamespaceName& nameSpace,
+        const CIMName& className,
+        Boolean deepInheritance = true,
+        Boolean includeClassOrigin = false,
+        const CIMPropertyList& propertyList = CIMPropertyList(),
+        const String& filterQueryLanguage = String::EMPTY,
+        const String& filterQuery = String::EMPTY,
+        Uint32 operationTimeout = 0,
+        Boolean continueOnError = false,
+        Uint32 maxObjectCount = 0);
+
+    /**
+        Returns the next Instances of an enumeration opened by
+        openEnumerateInstances().
+
+        @param enumerationContext The String returned by
+            openEnumerateInstances() or by the previous pullInstancesWithPath()
+            call; updated on output.
+        @param endOfSequence Output Boolean set to true if the returned
+            Instances complete the enumeration, in which case the server has
+            closed it.
+        @param nameSpace The CIMNamespaceName given to
+            openEnumerateInstances().
+        @param maxObjectCount The maximum number of Instances to return.
+
+        @return An Array of zero or more CIMInstance objects with their full
+            paths.
+
+        @exception CIMException If the CIM Server fails to perform the
+            requested operation.  See DSP0200 for specific CIM Status Codes
+            that may be expected.
+        @exception Exception If an error occurs while sending the request or
+            receiving the response.
+    */
+    Array<CIMInstance> pullInstancesWithPath(
+        String& enumerationContext,
+        Boolean& endOfSequence,
+        const CIMNamespaceName& nameSpace,
+        Uint32 maxObjectCount);
+
+    /**
+        Closes an enumeration opened by openEnumerateInstances() before
+        its end of sequence.
+
+        @param enumerationContext The String returned by the last open or pull
+            operation.
+        @param nameSpace The CIMNamespaceName given to
+            openEnumerateInstances().
+
+        @exception CIMException If the CIM Server fails to perform the
+            requested operation.  See DSP0200 for specific CIM Status Codes
+            that may be expected.
+        @exception Exception If an error occurs while sending the request or
+            receiving the response.
+    */
+    void closeEnumeration(
+        const String& enumerationContext,
+        const CIMNamespaceName& nameSpace);
+
     /**
         Registers a ClientOpPerformanceDataHandler object.  The specified
         object is called with performance data relative to each operation
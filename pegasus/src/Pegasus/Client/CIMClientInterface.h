@@ -244,6 +244,30 @@ public:
         const CIMName& methodName,
         const Array<CIMParamValue>& inParameters,
         Array<CIMParamValue>& outParameters) = 0;
+
+    virtual CIMResponseData openEnumerateInstances(
+        String& enumerationContext,
+        Boolean& endOfSequence,
+        const CIMNamespaceName& nameSpace,
+        const CIMName& className,
+        Boolean deepInheritance,
+        Boolean includeClassOrigin,
+        const CIMPropertyList& propertyList,
+        const String& filterQueryLanguage,
+        const String& filterQuery,
+        Uint32 operationTimeout,
+        Boolean continueOnError,
+        Uint32 maxObjectCount) = 0;
+
+    virtual CIMResponseData pullInstancesWithPath(
+        String& enumerationContext,
+        Boolean& endOfSequence,
+        const CIMNamespaceName& nameSpace,
+        Uint32 maxObjectCount) = 0;
+
+    virtual void closeEnumeration(
+        const String& enumerationContext,
+        const CIMNamespaceName& nameSpace) = 0;
 };
 
 PEGASUS_NAMESPACE_END
@@ -58,6 +58,7 @@ CIMClientRep::CIMClientRep(Uint32 timeoutMilliseconds)
     _doReconnect(false),
     _binaryRequest(false),
     _binaryResponse(false),
+    _compactBinary(false),
     _localConnect(false)
 {
     //
@@ -157,11 +158,14 @@ void CIMClientRep::_connect(bool binaryRequest, bool binaryResponse)
         connectHost.append(portStr);
     }
 
+    bool compactBinary = _compactBinary && !_localConnect;
+
     AutoPtr<CIMOperationRequestEncoder> requestEncoder(
         new CIMOperationRequestEncoder(
             httpConnection.get(), connectHost, &_authenticator, showOutput,
             binaryRequest,
-            binaryResponse));
+            binaryResponse || compactBinary,
+            compactBinary));
 
     _responseDecoder.reset(responseDecoder.release());
     _httpConnection = httpConnection.release();
@@ -1015,6 +1019,97 @@ CIMValue CIMClientRep::invokeMethod(
     return response->retValue;
 }
 
+CIMResponseData CIMClientRep::openEnumerateInstances(
+    String& enumerationContext,
+    Boolean& endOfSequence,
+    const CIMNamespaceName& nameSpace,
+    const CIMName& className,
+    Boolean deepInheritance,
+    Boolean includeClassOrigin,
+    const CIMPropertyList& propertyList,
+    const String& filterQueryLanguage,
+    const String& filterQuery,
+    Uint32 operationTimeout,
+    Boolean continueOnError,
+    Uint32 maxObjectCount)
+{
+    AutoPtr<CIMRequestMessage> request(
+        new CIMOpenEnumerateInstancesRequestMessage(
+            String::EMPTY,
+            nameSpace,
+            className,
+            deepInheritance,
+            includeClassOrigin,
+            propertyList,
+            filterQueryLanguage,
+            filterQuery,
+            operationTimeout,
+            continueOnError,
+            maxObjectCount,
+            QueueIdStack()));
+
+    Message* message = _doRequest(
+        request, CIM_OPEN_ENUMERATE_INSTANCES_RESPONSE_MESSAGE);
+
+    CIMOpenEnumerateInstancesResponseMessage* response =
+        (CIMOpenEnumerateInstancesResponseMessage*)message;
+
+    AutoPtr<CIMOpenEnumerateInstancesResponseMessage> destroyer(response);
+
+    enumerationContext = response->enumerationContext;
+    endOfSequence = response->endOfSequence;
+
+    return response->getResponseData();
+}
+
+CIMResponseData CIMClientRep::pullInstancesWithPath(
+    String& enumerationContext,
+    Boolean& endOfSequence,
+    const CIMNamespaceName& nameSpace,
+    Uint32 maxObjectCount)
+{
+    AutoPtr<CIMRequestMessage> request(
+        new CIMPullInstancesWithPathRequestMessage(
+            String::EMPTY,
+            nameSpace,
+            enumerationContext,
+            maxObjectCount,
+            QueueIdStack()));
+
+    Message* message = _doRequest(
+        request, CIM_PULL_INSTANCES_WITH_PATH_RESPONSE_MESSAGE);
+
+    CIMPullInstancesWithPathResponseMessage* response =
+        (CIMPullInstancesWithPathResponseMessage*)message;
+
+    AutoPtr<CIMPullInstancesWithPathResponseMessage> destroyer(response);
+
+    enumerationContext = response->enumerationContext;
+    endOfSequence = response->endOfSequence;
+
+    return response->getResponseData();
+}
+
+void CIMClientRep::closeEnumeration(
+    const String& enumerationContext,
+    const CIMNamespaceName& nameSpace)
+{
+    AutoPtr<CIMRequestMessage> request(
+        new CIMCloseEnumerationRequestMessage(
+            String::EMPTY,
+            nameSpace,
+            enumerationContext,
+            QueueIdStack()));
+
+    Message* message =
+        _doRequest(request, CIM_CLOSE_ENUMERATION_RESPONSE_MESSAGE);
+
+    CIMCloseEnumerationResponseMessage* response =
+        (CIMCloseEnumerationResponseMessage*)message;
+
+    AutoPtr<CIMCloseEnumerationResponseMessage> destroyer(response);
+}
+
 Message* CIMClientRep::_doRequest(
     AutoPtr<CIMRequestMessage>& request,
     MessageType expectedResponseMessageType)
@@ -1187,6 +1282,13 @@ Message* CIMClientRep::_doRequest(
                     throw responseException;
                 }
 
+                // A server answering in the compact binary encoding also
+                // accepts requests in it.
+                if (cimResponse->compactBinaryResponse && _requestEncoder.get())
+                {
+                    _requestEncoder->setBinaryRequest(true);
+                }
+
                 // Get the Content-Languages from the response's
                 // operationContext and make available through the
                 // CIMClient API
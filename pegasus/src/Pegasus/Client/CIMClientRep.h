@@ -290,6 +290,30 @@ public:
         Array<CIMParamValue>& outParameters
     );
 
+    virtual CIMResponseData openEnumerateInstances(
+        String& enumerationContext,
+        Boolean& endOfSequence,
+        const CIMNamespaceName& nameSpace,
+        const CIMName& className,
+        Boolean deepInheritance,
+        Boolean includeClassOrigin,
+        const CIMPropertyList& propertyList,
+        const String& filterQueryLanguage,
+        const String& filterQuery,
+        Uint32 operationTimeout,
+        Boolean continueOnError,
+        Uint32 maxObjectCount);
+
+    virtual CIMResponseData pullInstancesWithPath(
+        String& enumerationContext,
+        Boolean& endOfSequence,
+        const CIMNamespaceName& nameSpace,
+        Uint32 maxObjectCount);
+
+    virtual void closeEnumeration(
+        const String& enumerationContext,
+        const CIMNamespaceName& nameSpace);
+
     void registerClientOpPerformanceDataHandler(
         ClientOpPerformanceDataHandler & handler);
 
@@ -299,6 +323,13 @@ public:
 
     void setBinaryRequest(bool x) { _binaryRequest = x; }
 
+    /** Asks remote servers for the compact binary encoding. Requests are
+        sent as XML until the server has answered in that encoding, so
+        servers without it (or with enableRemoteBinaryProtocol=false) keep
+        working. Has no effect on local connections.
+    */
+    void setCompactBinary(bool x) { _compactBinary = x; }
+
 private:
 
     void _connect(bool binaryRequest, bool binaryResponse);
@@ -340,6 +371,7 @@ private:
     ContentLanguageList responseContentLanguages;
     bool _binaryRequest;
     bool _binaryResponse;
+    bool _compactBinary;
     bool _localConnect;
 };
 
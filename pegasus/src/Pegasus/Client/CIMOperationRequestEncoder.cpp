@@ -48,7 +48,8 @@ CIMOperationRequestEncoder::CIMOperationRequestEncoder(
     ClientAuthenticator* authenticator,
     Uint32 showOutput,
     bool binaryRequest,
-    bool binaryResponse)
+    bool binaryResponse,
+    bool compactBinary)
     :
     MessageQueue(PEGASUS_QUEUENAME_OPREQENCODER),
     _outputQueue(outputQueue),
@@ -56,7 +57,8 @@ CIMOperationRequestEncoder::CIMOperationRequestEncoder(
     _authenticator(authenticator),
     _showOutput(showOutput),
     _binaryRequest(binaryRequest),
-    _binaryResponse(binaryResponse)
+    _binaryResponse(binaryResponse),
+    _compactBinary(compactBinary)
 {
     dataStore_prt=NULL;
 }
@@ -88,7 +90,8 @@ void CIMOperationRequestEncoder::handleEnqueue()
             Buffer buf;
 
             if (BinaryCodec::encodeRequest(buf, _hostName,
-                _authenticator->buildRequestAuthHeader(), msg, _binaryResponse))
+                _authenticator->buildRequestAuthHeader(), msg, _binaryResponse,
+                _compactBinary))
             {
                 _sendRequest(buf);
                 return;
@@ -220,6 +223,21 @@ void CIMOperationRequestEncoder::handleEnqueue()
                 (CIMInvokeMethodRequestMessage*)message);
             break;
 
+        case CIM_OPEN_ENUMERATE_INSTANCES_REQUEST_MESSAGE:
+            _encodeOpenEnumerateInstancesRequest(
+                (CIMOpenEnumerateInstancesRequestMessage*)message);
+            break;
+
+        case CIM_PULL_INSTANCES_WITH_PATH_REQUEST_MESSAGE:
+            _encodePullInstancesWithPathRequest(
+                (CIMPullInstancesWithPathRequestMessage*)message);
+            break;
+
+        case CIM_CLOSE_ENUMERATION_REQUEST_MESSAGE:
+            _encodeCloseEnumerationRequest(
+                (CIMCloseEnumerationRequestMessage*)message);
+            break;
+
         default:
             // Unexpected message type
             PEGASUS_ASSERT(0);
@@ -257,7 +275,7 @@ void CIMOperationRequestEncoder::_encodeCreateClassRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
     _sendRequest(buffer);
 }
 
@@ -290,7 +308,7 @@ void CIMOperationRequestEncoder::_encodeGetClassRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -311,7 +329,7 @@ void CIMOperationRequestEncoder::_encodeModifyClassRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -336,7 +354,7 @@ void CIMOperationRequestEncoder::_encodeEnumerateClassNamesRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -372,7 +390,7 @@ void CIMOperationRequestEncoder::_encodeEnumerateClassesRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -394,7 +412,7 @@ void CIMOperationRequestEncoder::_encodeDeleteClassRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -415,7 +433,7 @@ void CIMOperationRequestEncoder::_encodeCreateInstanceRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -452,7 +470,7 @@ void CIMOperationRequestEncoder::_encodeGetInstanceRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -480,7 +498,7 @@ void CIMOperationRequestEncoder::_encodeModifyInstanceRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -502,7 +520,7 @@ void CIMOperationRequestEncoder::_encodeEnumerateInstanceNamesRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -541,7 +559,7 @@ void CIMOperationRequestEncoder::_encodeEnumerateInstancesRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -562,7 +580,7 @@ void CIMOperationRequestEncoder::_encodeDeleteInstanceRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -586,7 +604,7 @@ void CIMOperationRequestEncoder::_encodeGetPropertyRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -614,7 +632,7 @@ void CIMOperationRequestEncoder::_encodeSetPropertyRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -634,7 +652,7 @@ void CIMOperationRequestEncoder::_encodeSetQualifierRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -656,7 +674,7 @@ void CIMOperationRequestEncoder::_encodeGetQualifierRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -674,7 +692,7 @@ void CIMOperationRequestEncoder::_encodeEnumerateQualifiersRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -696,7 +714,7 @@ void CIMOperationRequestEncoder::_encodeDeleteQualifierRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -730,7 +748,7 @@ void CIMOperationRequestEncoder::_encodeReferenceNamesRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -774,7 +792,7 @@ void CIMOperationRequestEncoder::_encodeReferencesRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -821,7 +839,7 @@ void CIMOperationRequestEncoder::_encodeAssociatorNamesRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -878,7 +896,7 @@ void CIMOperationRequestEncoder::_encodeAssociatorsRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -902,7 +920,7 @@ void CIMOperationRequestEncoder::_encodeExecQueryRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params, _binaryResponse);
+        params, _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -918,7 +936,7 @@ void CIMOperationRequestEncoder::_encodeInvokeMethodRequest(
             AcceptLanguageListContainer::NAME)).getLanguages(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        _binaryResponse);
+        _binaryResponse, _compactBinary);
 
     _sendRequest(buffer);
 }
@@ -926,6 +944,107 @@ void CIMOperationRequestEncoder::_encodeInvokeMethodRequest(
 // Enqueue the buffer to the ouptut queue with a conditional display.
 // This function is only enabled if the Pegasus Client trace is enabled.
 // Uses parameter to determine whether to send to console to log.
+// The pull operations return paths with their instances, which the binary
+// response encoding does not carry, so their responses are requested as XML.
+
+void CIMOperationRequestEncoder::_encodeOpenEnumerateInstancesRequest(
+    CIMOpenEnumerateInstancesRequestMessage* message)
+{
+    Buffer params;
+
+    XmlWriter::appendClassNameIParameter(
+        params, "ClassName", message->className);
+
+    if (message->deepInheritance != true)
+        XmlWriter::appendBooleanIParameter(params, "DeepInheritance", false);
+
+    if (message->includeClassOrigin != false)
+        XmlWriter::appendBooleanIParameter(
+            params, "IncludeClassOrigin", true);
+
+    if (!message->propertyList.isNull())
+        XmlWriter::appendPropertyListIParameter(
+            params, message->propertyList);
+
+    if (message->filterQueryLanguage.size())
+        XmlWriter::appendStringIParameter(
+            params, "FilterQueryLanguage", message->filterQueryLanguage);
+
+    if (message->filterQuery.size())
+        XmlWriter::appendStringIParameter(
+            params, "FilterQuery", message->filterQuery);
+
+    if (message->operationTimeout != 0)
+        XmlWriter::appendPropertyValueIParameter(
+            params, "OperationTimeout", CIMValue(message->operationTimeout));
+
+    if (message->continueOnError != false)
+        XmlWriter::appendBooleanIParameter(params, "ContinueOnError", true);
+
+    XmlWriter::appendPropertyValueIParameter(
+        params, "MaxObjectCount", CIMValue(message->maxObjectCount));
+
+    Buffer buffer = XmlWriter::formatSimpleIMethodReqMessage(_hostName,
+        message->nameSpace, CIMName("OpenEnumerateInstances"),
+        message->messageId,
+        message->getHttpMethod(),
+        _authenticator->buildRequestAuthHeader(),
+        ((AcceptLanguageListContainer)message->operationContext.get(
+            AcceptLanguageListContainer::NAME)).getLanguages(),
+        ((ContentLanguageListContainer)message->operationContext.get(
+            ContentLanguageListContainer::NAME)).getLanguages(),
+        params, false);
+
+    _sendRequest(buffer);
+}
+
+void CIMOperationRequestEncoder::_encodePullInstancesWithPathRequest(
+    CIMPullInstancesWithPathRequestMessage* message)
+{
+    Buffer params;
+
+    XmlWriter::appendStringIParameter(
+        params, "EnumerationContext", message->enumerationContext);
+
+    XmlWriter::appendPropertyValueIParameter(
+        params, "MaxObjectCount", CIMValue(message->maxObjectCount));
+
+    Buffer buffer = XmlWriter::formatSimpleIMethodReqMessage(_hostName,
+        message->nameSpace, CIMName("PullInstancesWithPath"),
+        message->messageId,
+        message->getHttpMethod(),
+        _authenticator->buildRequestAuthHeader(),
+        ((AcceptLanguageListContainer)message->operationContext.get(
+            AcceptLanguageListContainer::NAME)).getLanguages(),
+        ((ContentLanguageListContainer)message->operationContext.get(
+            ContentLanguageListContainer::NAME)).getLanguages(),
+        params, false);
+
+    _sendRequest(buffer);
+}
+
+void CIMOperationRequestEncoder::_encodeCloseEnumerationRequest(
+    CIMCloseEnumerationRequestMessage* message)
+{
+    Buffer params;
+
+    XmlWriter::appendStringIParameter(
+        params, "EnumerationContext", message->enumerationContext);
+
+    Buffer buffer = XmlWriter::formatSimpleIMethodReqMessage(_hostName,
+        message->nameSpace, CIMName("CloseEnumeration"),
+        message->messageId,
+        message->getHttpMethod(),
+        _authenticator->buildRequestAuthHeader(),
+        ((AcceptLanguageListContainer)message->operationContext.get(
+            AcceptLanguageListContainer::NAME)).getLanguages(),
+        ((ContentLanguageListContainer)message->operationContext.get(
+            ContentLanguageListContainer::NAME)).getLanguages(),
+        params, false);
+
+    _sendRequest(buffer);
+}
+
 void CIMOperationRequestEncoder::_sendRequest(Buffer& buffer)
 {
 #ifdef PEGASUS_CLIENT_TRACE_ENABLE
@@ -53,6 +53,8 @@ public:
         @param outputQueue queue to receive encoded HTTP messages.
         @param hostName Name of the target host for the encoded requests.
             I.e., the value of the HTTP Host header.
+        @param compactBinary if true, binary requests and responses use the
+            compact OpenPegasus binary encoding instead of the local one.
     */
     CIMOperationRequestEncoder(
         MessageQueue* outputQueue,
@@ -60,7 +62,8 @@ public:
         ClientAuthenticator* authenticator,
         Uint32 showOutput,
         bool binaryRequest = false,
-        bool binaryResponse = false);
+        bool binaryResponse = false,
+        bool compactBinary = false);
 
     /** Destructor. */
     ~CIMOperationRequestEncoder();
@@ -75,6 +78,12 @@ public:
      */
     void setDataStorePointer(ClientPerfDataStore* perfDataStore_ptr);
 
+    /** Switches the encoding of the following requests between XML and
+        binary. A client asking for compact binary responses sends XML
+        requests until the server has answered in the compact encoding.
+    */
+    void setBinaryRequest(bool x) { _binaryRequest = x; }
+
 private:
 
     void _encodeCreateClassRequest(
@@ -149,6 +158,15 @@ private:
     void _encodeInvokeMethodRequest(
         CIMInvokeMethodRequestMessage* message);
 
+    void _encodeOpenEnumerateInstancesRequest(
+        CIMOpenEnumerateInstancesRequestMessage* message);
+
+    void _encodePullInstancesWithPathRequest(
+        CIMPullInstancesWithPathRequestMessage* message);
+
+    void _encodeCloseEnumerationRequest(
+        CIMCloseEnumerationRequestMessage* message);
+
     void _sendRequest(Buffer& buffer);
 
     MessageQueue* _outputQueue;
@@ -159,6 +177,7 @@ private:
     ClientPerfDataStore* dataStore_prt;
     bool _binaryRequest;
     bool _binaryResponse;
+    bool _compactBinary;
 };
 
 PEGASUS_NAMESPACE_END
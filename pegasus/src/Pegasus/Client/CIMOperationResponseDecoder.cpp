@@ -40,6 +40,9 @@
 #include <Pegasus/Common/CIMMessage.h>
 #include <Pegasus/Common/Exception.h>
 #include <Pegasus/Common/BinaryCodec.h>
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+# include <Pegasus/Common/HTTPContentCoding.h>
+#endif
 #include "CIMOperationResponseDecoder.h"
 
 #include <Pegasus/Common/MessageLoader.h>
@@ -311,6 +314,7 @@ void CIMOperationResponseDecoder::_handleHTTPMessage(HTTPMessage* httpMessage)
     // ex. text/xml;Charset="utf8"
     const char* cimContentType;
     bool binaryResponse = false;
+    bool compactBinaryResponse = false;
 
     if (HTTPMessage::lookupHeader(
             headers, "Content-Type", cimContentType, true))
@@ -320,14 +324,15 @@ void CIMOperationResponseDecoder::_handleHTTPMessage(HTTPMessage* httpMessage)
 
         if (!HTTPMessage::parseContentTypeHeader(
                 cimContentType, type, charset) ||
-            ((!String::equalNoCase(type, "application/xml") &&
-             !String::equalNoCase(type, "text/xml")) ||
-            !String::equalNoCase(charset, "utf-8"))
+            (((!String::equalNoCase(type, "application/xml") &&
+               !String::equalNoCase(type, "text/xml")) ||
+              !String::equalNoCase(charset, "utf-8"))
 #if defined(PEGASUS_ENABLE_PROTOCOL_BINARY)
-            && !(binaryResponse=String::equalNoCase(
-                type, "application/x-openpegasus"))
+             && !(binaryResponse=String::equalNoCase(
+                 type, "application/x-openpegasus"))
 #endif
-        )
+             && !(compactBinaryResponse=String::equalNoCase(
+                 type, "application/x-openpegasus-compact"))))
         {
             CIMClientMalformedHTTPException* malformedHTTPException = new
                 CIMClientMalformedHTTPException(
@@ -340,6 +345,8 @@ void CIMOperationResponseDecoder::_handleHTTPMessage(HTTPMessage* httpMessage)
             _outputQueue->enqueue(response);
             return;
         }
+
+        binaryResponse = binaryResponse || compactBinaryResponse;
     }
     // comment out the error rejection code if the content-type header does
     //    not exist
@@ -413,6 +420,48 @@ void CIMOperationResponseDecoder::_handleHTTPMessage(HTTPMessage* httpMessage)
     content = httpMessage->message.getData() +
         httpMessage->message.size() - contentLength;
 
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+    //
+    // Decompress the content if the server applied a content coding:
+    //
+
+    Buffer decodedContent;
+    const char* contentEncoding;
+
+    if (HTTPMessage::lookupHeader(
+            headers, "Content-Encoding", contentEncoding, false))
+    {
+        HTTPContentCoding::Coding coding;
+
+        if (!HTTPContentCoding::parseContentEncoding(
+                contentEncoding, coding) ||
+            !HTTPContentCoding::decompress(
+                coding, content, contentLength, decodedContent))
+        {
+            MessageLoaderParms mlParms(
+                "Client.CIMOperationResponseDecoder.INVALID_CONTENT_ENCODING",
+                "The response body could not be decoded using the "
+                    "Content-Encoding \"$0\".",
+                contentEncoding);
+            String mlString(MessageLoader::getMessage(mlParms));
+
+            CIMClientMalformedHTTPException* malformedHTTPException =
+                new CIMClientMalformedHTTPException(mlString);
+
+            ClientExceptionMessage * response =
+                new ClientExceptionMessage(malformedHTTPException);
+
+            response->setCloseConnect(cimReconnect);
+
+            _outputQueue->enqueue(response);
+            return;
+        }
+
+        content = decodedContent.getData();
+        contentLength = decodedContent.size();
+    }
+#endif
+
     //
     // If it is a method response, then dispatch it to be handled:
     //
@@ -441,7 +490,8 @@ void CIMOperationResponseDecoder::_handleHTTPMessage(HTTPMessage* httpMessage)
     dataStore->setResponseSize(contentLength);
     dataStore->setEndNetworkTime(networkEndTime);
     _handleMethodResponse(content, contentLength,
-        httpMessage->contentLanguages, cimReconnect, binaryResponse);
+        httpMessage->contentLanguages, cimReconnect, binaryResponse,
+        compactBinaryResponse);
 }
 
 void CIMOperationResponseDecoder::_handleMethodResponse(
@@ -449,7 +499,8 @@ void CIMOperationResponseDecoder::_handleMethodResponse(
     Uint32 contentLength,
     const ContentLanguageList& contentLanguages,
     Boolean cimReconnect,
-    Boolean binaryResponse)
+    Boolean binaryResponse,
+    Boolean compactBinaryResponse)
 {
     Message* response = 0;
 
@@ -464,7 +515,8 @@ void CIMOperationResponseDecoder::_handleMethodResponse(
         CIMBuffer in((char*)content, contentLength);
         CIMBufferReleaser buf_(in);
 
-        CIMResponseMessage* msg = BinaryCodec::decodeResponse(in);
+        CIMResponseMessage* msg =
+            BinaryCodec::decodeResponse(in, compactBinaryResponse);
 
         msg->operationContext.set(
             ContentLanguageListContainer(contentLanguages));
@@ -650,6 +702,18 @@ void CIMOperationResponseDecoder::_handleMethodResponse(
             else if (System::strcasecmp(iMethodResponseName, "ExecQuery") == 0)
                 response = _decodeExecQueryResponse(
                     parser, messageId, isEmptyTag);
+            else if (System::strcasecmp(
+                         iMethodResponseName, "OpenEnumerateInstances") == 0)
+                response = _decodeOpenEnumerateInstancesResponse(
+                    parser, messageId, isEmptyTag);
+            else if (System::strcasecmp(
+                         iMethodResponseName, "PullInstancesWithPath") == 0)
+                response = _decodePullInstancesWithPathResponse(
+                    parser, messageId, isEmptyTag);
+            else if (System::strcasecmp(
+                         iMethodResponseName, "CloseEnumeration") == 0)
+                response = _decodeCloseEnumerationResponse(
+                    parser, messageId, isEmptyTag);
             else
             {
                 MessageLoaderParms mlParms(
@@ -1731,6 +1795,165 @@ CIMExecQueryResponseMessage*
     return msg;
 }
 
+//
+// Decodes the body of an OpenEnumerateInstances or PullInstancesWithPath
+// response: the instances with their paths, followed by the EndOfSequence
+// and EnumerationContext output parameters.
+//
+static void _decodeOpenOrPullResponse(
+    XmlParser& parser,
+    Boolean isEmptyImethodresponseTag,
+    CIMException& cimException,
+    Array<CIMInstance>& instances,
+    Boolean& endOfSequence,
+    String& enumerationContext)
+{
+    XmlEntry entry;
+
+    if (!isEmptyImethodresponseTag)
+    {
+        if (XmlReader::getErrorElement(parser, cimException))
+        {
+            return;
+        }
+
+        if (XmlReader::testStartTagOrEmptyTag(parser, entry, "IRETURNVALUE"))
+        {
+            if (entry.type != XmlEntry::EMPTY_TAG)
+            {
+                CIMInstance instance;
+
+                while (XmlReader::getValueInstanceWithPathElement(
+                           parser, instance))
+                {
+                    instances.append(instance);
+                }
+
+                XmlReader::expectEndTag(parser, "IRETURNVALUE");
+            }
+        }
+
+        CIMParamValue paramValue;
+
+        while (XmlReader::getParamValueElement(parser, paramValue))
+        {
+            const CIMValue& value = paramValue.getValue();
+            String name = paramValue.getParameterName();
+
+            if (System::strcasecmp(
+                    name.getCString(), "EndOfSequence") == 0 &&
+                value.getType() == CIMTYPE_BOOLEAN && !value.isNull())
+            {
+                value.get(endOfSequence);
+            }
+            else if (System::strcasecmp(
+                         name.getCString(), "EnumerationContext") == 0 &&
+                     value.getType() == CIMTYPE_STRING && !value.isNull())
+            {
+                value.get(enumerationContext);
+            }
+        }
+    }
+}
+
+CIMOpenEnumerateInstancesResponseMessage*
+    CIMOperationResponseDecoder::_decodeOpenEnumerateInstancesResponse(
+        XmlParser& parser,
+        const String& messageId,
+        Boolean isEmptyImethodresponseTag)
+{
+    CIMException cimException;
+    Array<CIMInstance> instances;
+    Boolean endOfSequence = false;
+    String enumerationContext;
+
+    _decodeOpenOrPullResponse(
+        parser,
+        isEmptyImethodresponseTag,
+        cimException,
+        instances,
+        endOfSequence,
+        enumerationContext);
+
+    CIMOpenEnumerateInstancesResponseMessage* msg;
+
+    msg = new CIMOpenEnumerateInstancesResponseMessage(
+        messageId,
+        cimException,
+        QueueIdStack());
+
+    msg->getResponseData().setInstances(instances);
+    msg->endOfSequence = endOfSequence;
+    msg->enumerationContext = enumerationContext;
+    return msg;
+}
+
+CIMPullInstancesWithPathResponseMessage*
+    CIMOperationResponseDecoder::_decodePullInstancesWithPathResponse(
+        XmlParser& parser,
+        const String& messageId,
+        Boolean isEmptyImethodresponseTag)
+{
+    CIMException cimException;
+    Array<CIMInstance> instances;
+    Boolean endOfSequence = false;
+    String enumerationContext;
+
+    _decodeOpenOrPullResponse(
+        parser,
+        isEmptyImethodresponseTag,
+        cimException,
+        instances,
+        endOfSequence,
+        enumerationContext);
+
+    CIMPullInstancesWithPathResponseMessage* msg;
+
+    msg = new CIMPullInstancesWithPathResponseMessage(
+        messageId,
+        cimException,
+        QueueIdStack());
+
+    msg->getResponseData().setInstances(instances);
+    msg->endOfSequence = endOfSequence;
+    msg->enumerationContext = enumerationContext;
+    return msg;
+}
+
+CIMCloseEnumerationResponseMessage*
+    CIMOperationResponseDecoder::_decodeCloseEnumerationResponse(
+        XmlParser& parser,
+        const String& messageId,
+        Boolean isEmptyImethodresponseTag)
+{
+    XmlEntry entry;
+    CIMException cimException;
+
+    if (!isEmptyImethodresponseTag)
+    {
+        if (XmlReader::getErrorElement(parser, cimException))
+        {
+            return new CIMCloseEnumerationResponseMessage(
+                messageId,
+                cimException,
+                QueueIdStack());
+        }
+
+        if (XmlReader::testStartTagOrEmptyTag(parser, entry, "IRETURNVALUE"))
+        {
+            if (entry.type != XmlEntry::EMPTY_TAG)
+            {
+                XmlReader::expectEndTag(parser, "IRETURNVALUE");
+            }
+        }
+    }
+
+    return new CIMCloseEnumerationResponseMessage(
+        messageId,
+        cimException,
+        QueueIdStack());
+}
+
 CIMInvokeMethodResponseMessage*
     CIMOperationResponseDecoder::_decodeInvokeMethodResponse(
         XmlParser& parser,
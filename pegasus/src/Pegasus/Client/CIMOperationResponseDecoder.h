@@ -107,7 +107,8 @@ private:
         Uint32 contentLength,
         const ContentLanguageList& contentLanguages,
         Boolean reconnect,
-        bool binaryResponse);
+        bool binaryResponse,
+        bool compactBinaryResponse);
 
     CIMCreateClassResponseMessage* _decodeCreateClassResponse(
         XmlParser& parser,
@@ -225,6 +226,23 @@ private:
         const String& messageId,
         Boolean isEmptyImethodresponseTag);
 
+    CIMOpenEnumerateInstancesResponseMessage*
+        _decodeOpenEnumerateInstancesResponse(
+            XmlParser& parser,
+            const String& messageId,
+            Boolean isEmptyImethodresponseTag);
+
+    CIMPullInstancesWithPathResponseMessage*
+        _decodePullInstancesWithPathResponse(
+            XmlParser& parser,
+            const String& messageId,
+            Boolean isEmptyImethodresponseTag);
+
+    CIMCloseEnumerationResponseMessage* _decodeCloseEnumerationResponse(
+        XmlParser& parser,
+        const String& messageId,
+        Boolean isEmptyImethodresponseTag);
+
     CIMInvokeMethodResponseMessage* _decodeInvokeMethodResponse(
         XmlParser& parser,
         const String& messageId,
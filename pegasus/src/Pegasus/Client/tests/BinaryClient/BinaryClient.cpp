@@ -30,6 +30,7 @@
 //%/////////////////////////////////////////////////////////////////////////////
 
 #include <cstdlib>
+#include <cstring>
 #include <Pegasus/Common/Config.h>
 #include <Pegasus/Common/Print.h>
 #include <Pegasus/Client/CIMClient.h>
@@ -40,10 +41,11 @@ PEGASUS_USING_PEGASUS;
 
 //==============================================================================
 //
-// TestBinaryClient host port
+// TestBinaryClient host port [compact]
 //
 //     This program enumerates instances of CIM_ManagedElement using the
-//     OpenPegasus binary protocol.
+//     OpenPegasus binary protocol. With "compact", it asks for the compact
+//     encoding the server offers when enableRemoteBinaryProtocol is true.
 //
 //==============================================================================
 
@@ -53,13 +55,19 @@ static void _SetBinaryResponse(CIMClient& client, Boolean flag)
     rep->setBinaryResponse(flag);
 }
 
+static void _SetCompactBinary(CIMClient& client, Boolean flag)
+{
+    CIMClientRep* rep = *(reinterpret_cast<CIMClientRep**>(&client));
+    rep->setCompactBinary(flag);
+}
+
 int main(int argc, char** argv)
 {
     // Check args:
 
-    if (argc != 3)
+    if (argc != 3 && !(argc == 4 && strcmp(argv[3], "compact") == 0))
     {
-        cerr << "Usage: " << argv[0] << " host port" << endl;
+        cerr << "Usage: " << argv[0] << " host port [compact]" << endl;
         exit(1);
     }
 
@@ -78,6 +86,7 @@ int main(int argc, char** argv)
 
     CIMClient client;
     _SetBinaryResponse(client, true);
+    _SetCompactBinary(client, argc == 4);
 
     try
     {
@@ -86,6 +95,14 @@ int main(int argc, char** argv)
         Array<CIMInstance> result = client.enumerateInstances("root/cimv2",
             "CIM_ManagedElement");
 
+        // Once the server has answered in the compact encoding, the
+        // requests are sent in it too.
+        if (argc == 4)
+        {
+            result = client.enumerateInstances("root/cimv2",
+                "CIM_ManagedElement");
+        }
+
         for (Uint32 i = 0; i < result.size(); i++)
         {
 #if defined(PEGASUS_DEBUG)
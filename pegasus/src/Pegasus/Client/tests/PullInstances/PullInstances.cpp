@@ -0,0 +1,255 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Client/CIMClient.h>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+const CIMNamespaceName NAMESPACE = CIMNamespaceName("root/PG_InterOp");
+const CIMName CLASSNAME = CIMName("PG_Provider");
+
+static Boolean verbose;
+
+static Boolean _containsPath(
+    const Array<CIMInstance>& instances,
+    const CIMObjectPath& path)
+{
+    for (Uint32 i = 0; i < instances.size(); i++)
+    {
+        CIMObjectPath p = instances[i].getPath();
+        p.setHost(String::EMPTY);
+        p.setNameSpace(CIMNamespaceName());
+
+        if (p == path)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static Array<CIMInstance> _pullAll(
+    CIMClient& client,
+    Uint32 openCount,
+    Uint32 pullCount)
+{
+    String enumerationContext;
+    Boolean endOfSequence = false;
+
+    Array<CIMInstance> instances = client.openEnumerateInstances(
+        enumerationContext,
+        endOfSequence,
+        NAMESPACE,
+        CLASSNAME,
+        true,
+        false,
+        CIMPropertyList(),
+        String::EMPTY,
+        String::EMPTY,
+        0,
+        false,
+        openCount);
+
+    PEGASUS_TEST_ASSERT(instances.size() <= openCount);
+
+    while (!endOfSequence)
+    {
+        PEGASUS_TEST_ASSERT(enumerationContext.size() != 0);
+
+        Array<CIMInstance> pulled = client.pullInstancesWithPath(
+            enumerationContext, endOfSequence, NAMESPACE, pullCount);
+
+        PEGASUS_TEST_ASSERT(pulled.size() <= pullCount);
+        instances.appendArray(pulled);
+    }
+
+    return instances;
+}
+
+static void _testPullAll(CIMClient& client)
+{
+    Array<CIMInstance> expected = client.enumerateInstances(
+        NAMESPACE, CLASSNAME, true, false);
+    PEGASUS_TEST_ASSERT(expected.size() > 1);
+
+    Uint32 counts[] = { 0, 1, 2, 1000 };
+
+    for (Uint32 i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+    {
+        Array<CIMInstance> instances =
+            _pullAll(client, counts[i], counts[i] ? counts[i] : 1);
+
+        PEGASUS_TEST_ASSERT(instances.size() == expected.size());
+
+        for (Uint32 j = 0; j < instances.size(); j++)
+        {
+            // The pull operations return full instance paths
+            PEGASUS_TEST_ASSERT(
+                instances[j].getPath().getNameSpace() == NAMESPACE);
+            PEGASUS_TEST_ASSERT(instances[j].getPath().getHost().size());
+            PEGASUS_TEST_ASSERT(
+                _containsPath(instances, expected[j].getPath()));
+        }
+    }
+
+    if (verbose)
+    {
+        cout << "Pulled " << expected.size() << " instances" << endl;
+    }
+}
+
+static void _testCloseEnumeration(CIMClient& client)
+{
+    String enumerationContext;
+    Boolean endOfSequence = false;
+
+    Array<CIMInstance> instances = client.openEnumerateInstances(
+        enumerationContext,
+        endOfSequence,
+        NAMESPACE,
+        CLASSNAME,
+        true,
+        false,
+        CIMPropertyList(),
+        String::EMPTY,
+        String::EMPTY,
+        0,
+        false,
+        1);
+
+    PEGASUS_TEST_ASSERT(instances.size() == 1);
+    PEGASUS_TEST_ASSERT(!endOfSequence);
+
+    client.closeEnumeration(enumerationContext, NAMESPACE);
+
+    // The closed context can no longer be used
+    try
+    {
+        client.pullInstancesWithPath(
+            enumerationContext, endOfSequence, NAMESPACE, 1);
+        PEGASUS_TEST_ASSERT(false);
+    }
+    catch (CIMException& e)
+    {
+        PEGASUS_TEST_ASSERT(
+            e.getCode() == CIM_ERR_INVALID_ENUMERATION_CONTEXT);
+    }
+
+    try
+    {
+        client.closeEnumeration(enumerationContext, NAMESPACE);
+        PEGASUS_TEST_ASSERT(false);
+    }
+    catch (CIMException& e)
+    {
+        PEGASUS_TEST_ASSERT(
+            e.getCode() == CIM_ERR_INVALID_ENUMERATION_CONTEXT);
+    }
+}
+
+static void _testErrors(CIMClient& client)
+{
+    String enumerationContext;
+    Boolean endOfSequence = false;
+
+    try
+    {
+        client.openEnumerateInstances(
+            enumerationContext,
+            endOfSequence,
+            NAMESPACE,
+            CLASSNAME,
+            true,
+            false,
+            CIMPropertyList(),
+            "WQL",
+            "SELECT * FROM PG_Provider");
+        PEGASUS_TEST_ASSERT(false);
+    }
+    catch (CIMException& e)
+    {
+        PEGASUS_TEST_ASSERT(
+            e.getCode() == CIM_ERR_FILTERED_ENUMERATION_NOT_SUPPORTED);
+    }
+
+    try
+    {
+        client.openEnumerateInstances(
+            enumerationContext,
+            endOfSequence,
+            NAMESPACE,
+            CIMName("NoSuchClass"));
+        PEGASUS_TEST_ASSERT(false);
+    }
+    catch (CIMException& e)
+    {
+        PEGASUS_TEST_ASSERT(e.getCode() == CIM_ERR_INVALID_CLASS);
+    }
+
+    try
+    {
+        client.pullInstancesWithPath(
+            enumerationContext, endOfSequence, NAMESPACE, 1);
+        PEGASUS_TEST_ASSERT(false);
+    }
+    catch (CIMException& e)
+    {
+        PEGASUS_TEST_ASSERT(
+            e.getCode() == CIM_ERR_INVALID_ENUMERATION_CONTEXT);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    try
+    {
+        CIMClient client;
+        client.connectLocal();
+
+        _testPullAll(client);
+        _testCloseEnumeration(client);
+        _testErrors(client);
+    }
+    catch (Exception& e)
+    {
+        cerr << "Error: " << e.getMessage() << endl;
+        exit(1);
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
@@ -0,0 +1,185 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/Constants.h>
+#include <Pegasus/Common/System.h>
+#include <Pegasus/Common/FileSystem.h>
+#include <Pegasus/Common/StringConversion.h>
+#include <Pegasus/General/Stopwatch.h>
+#include <Pegasus/Client/CIMClient.h>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+/*
+ * Measures the rate at which a client opens HTTPS connections to the
+ * cimserver, each performing one operation, once with a new SSLContext per
+ * connection (always a full handshake) and once with the same SSLContext
+ * (the session of the previous connection is offered for resumption).
+ *
+ * The cimserver must be configured with enableHttpsConnection=true and
+ * enableAuthentication=false.  The second rate only improves when session
+ * resumption is enabled, with sslSessionCacheSize or
+ * enableSSLSessionTickets.
+ *
+ * Usage: TestPegClientSSLHandshakeRate [host [port [connections]]]
+ */
+
+static String randPath;
+
+static void _connectAndQuery(
+    const String& host,
+    Uint32 port,
+    const SSLContext& sslContext)
+{
+    CIMClient client;
+    client.connect(host, port, sslContext, String::EMPTY, String::EMPTY);
+
+    // The operation reads the response, and with it the session tickets
+    // the server sends after a TLS 1.3 handshake
+    Array<CIMName> classNames = client.enumerateClassNames(
+        PEGASUS_NAMESPACENAME_INTEROP, CIMName(), false);
+    PEGASUS_TEST_ASSERT(classNames.size() > 0);
+
+    client.disconnect();
+}
+
+static double _measure(
+    const String& host,
+    Uint32 port,
+    Uint32 connections,
+    Boolean reuseContext)
+{
+    SSLContext sharedContext(String::EMPTY, NULL, randPath);
+
+    // Establish the session the measured connections resume
+    if (reuseContext)
+    {
+        _connectAndQuery(host, port, sharedContext);
+    }
+
+    Stopwatch stopwatch;
+    stopwatch.start();
+
+    for (Uint32 i = 0; i < connections; i++)
+    {
+        if (reuseContext)
+        {
+            _connectAndQuery(host, port, sharedContext);
+        }
+        else
+        {
+            _connectAndQuery(
+                host, port, SSLContext(String::EMPTY, NULL, randPath));
+        }
+    }
+
+    stopwatch.stop();
+
+    return connections / stopwatch.getElapsed();
+}
+
+int main(int argc, char** argv)
+{
+#ifdef PEGASUS_HAS_SSL
+    String host = "localhost";
+    Uint32 port = System::lookupPort(
+        WBEM_HTTPS_SERVICE_NAME, WBEM_DEFAULT_HTTPS_PORT);
+    Uint32 connections = 200;
+
+    if (argc > 4)
+    {
+        cerr << "Usage: " << argv[0] << " [host [port [connections]]]"
+            << endl;
+        return 1;
+    }
+
+    if (argc > 1)
+    {
+        host = argv[1];
+    }
+
+    Uint64 v;
+
+    if (argc > 2)
+    {
+        if (!StringConversion::decimalStringToUint64(argv[2], v) ||
+            v == 0 || v > 65535)
+        {
+            cerr << argv[0] << ": invalid port " << argv[2] << endl;
+            return 1;
+        }
+        port = (Uint32)v;
+    }
+
+    if (argc > 3)
+    {
+        if (!StringConversion::decimalStringToUint64(argv[3], v) ||
+            v == 0 || v > 1000000)
+        {
+            cerr << argv[0] << ": invalid connection count " << argv[3]
+                << endl;
+            return 1;
+        }
+        connections = (Uint32)v;
+    }
+
+# ifdef PEGASUS_SSL_RANDOMFILE
+    randPath = FileSystem::getAbsolutePath(
+        getenv("PEGASUS_HOME"), PEGASUS_SSLCLIENT_RANDOMFILE);
+# endif
+
+    try
+    {
+        double fullRate = _measure(host, port, connections, false);
+        double resumedRate = _measure(host, port, connections, true);
+
+        cout << "Connections per second to " << host << ":" << port
+            << ", full handshake: " << fullRate
+            << ", resumable session: " << resumedRate
+            << " (" << resumedRate / fullRate << "x)" << endl;
+    }
+    catch (Exception& e)
+    {
+        cerr << "Error: " << e.getMessage() << endl;
+        cerr << "Root cause could be enableHttpsConnection=false" << endl;
+        return 1;
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+#else
+    cout << argv[0] << " +++++ PEGASUS_HAS_SSL not defined: skipped" << endl;
+#endif
+
+    return 0;
+}
@@ -39,6 +39,7 @@
 #include <Pegasus/Common/Message.h>
 #include <Pegasus/Common/MessageQueue.h>
 #include <Pegasus/Common/Thread.h>
+#include <Pegasus/Common/PooledAllocator.h>
 
 PEGASUS_NAMESPACE_BEGIN
 
@@ -57,6 +58,16 @@ public:
     AsyncOpNode();
     ~AsyncOpNode();
 
+    static void* operator new(size_t size)
+    {
+        return PooledAllocator::allocate(size);
+    }
+
+    static void operator delete(void* ptr, size_t size)
+    {
+        PooledAllocator::deallocate(ptr, size);
+    }
+
     void setRequest(Message* request);
     Message* getRequest();
     Message* removeRequest();
@@ -35,6 +35,7 @@
 #include "CIMBuffer.h"
 #include "StringConversion.h"
 #include "Print.h"
+#include "LanguageParser.h"
 
 #define ENABLE_VALIDATION
 
@@ -50,6 +51,9 @@
 #define INCLUDE_CLASS_ORIGIN    (1 << 2)
 #define DEEP_INHERITANCE        (1 << 3)
 
+// The message after the header uses the compact encoding of CIMBuffer.
+#define COMPACT_ENCODING        (1 << 16)
+
 PEGASUS_NAMESPACE_BEGIN
 
 //==============================================================================
@@ -180,6 +184,17 @@ static void _putHeader(
     const String& messageId,
     Operation operation)
 {
+    // The header itself is never compact, so that the reader can find the
+    // encoding of the rest of the message in its flags.
+
+    bool compact = out.isCompact();
+
+    if (compact)
+    {
+        out.setCompact(false);
+        flags |= COMPACT_ENCODING;
+    }
+
     // [MAGIC]
     out.putUint32(_MAGIC);
 
@@ -194,13 +209,16 @@ static void _putHeader(
 
     // [OPERATION]
     out.putUint32(operation);
+
+    out.setCompact(compact);
 }
 
 static bool _getHeader(
     CIMBuffer& in,
     Uint32& flags,
     String& messageId,
-    Operation& operation_)
+    Operation& operation_,
+    bool compact)
 {
     Uint32 magic;
     Uint32 version;
@@ -240,6 +258,13 @@ static bool _getHeader(
         operation_ = Operation(op);
     }
 
+    // The encoding must be the one of the content type the message came
+    // with, which is checked against the configuration of the receiver.
+    if (((flags & COMPACT_ENCODING) != 0) != compact)
+        return false;
+
+    in.setCompact(compact);
+
     return true;
 }
 
@@ -3082,7 +3107,8 @@ void BinaryCodec::hexDump(const void* data, size_t size)
 CIMOperationRequestMessage* BinaryCodec::decodeRequest(
     const Buffer& in,
     Uint32 queueId,
-    Uint32 returnQueueId)
+    Uint32 returnQueueId,
+    bool compact)
 {
     CIMBuffer buf((char*)in.getData(), in.size());
     CIMBufferReleaser buf_(buf);
@@ -3097,7 +3123,7 @@ CIMOperationRequestMessage* BinaryCodec::decodeRequest(
     Operation operation;
 
 
-    if (!_getHeader(buf, flags, messageId, operation))
+    if (!_getHeader(buf, flags, messageId, operation, compact))
     {
         return 0;
     }
@@ -3177,8 +3203,8 @@ CIMOperationRequestMessage* BinaryCodec::decodeRequest(
            return _decodeExecQueryRequest(
                 buf, queueId, returnQueueId, messageId);
         default:
-            // Unexpected message type
-            PEGASUS_ASSERT(0);
+            // Not an operation request (e.g. OP_IndicationDelivery, which
+            // is sent to listeners only).
             return 0;
     }
 }
@@ -3190,16 +3216,18 @@ CIMOperationRequestMessage* BinaryCodec::decodeRequest(
 //==============================================================================
 
 CIMResponseMessage* BinaryCodec::decodeResponse(
-    const Buffer& in)
+    const Buffer& in,
+    bool compact)
 {
     CIMBuffer buf((char*)in.getData(), in.size());
     CIMBufferReleaser buf_(buf);
 
-    return decodeResponse(buf);
+    return decodeResponse(buf, compact);
 }
 
 CIMResponseMessage* BinaryCodec::decodeResponse(
-    CIMBuffer& buf)
+    CIMBuffer& buf,
+    bool compact)
 {
     // Turn on validation:
 #if defined(ENABLE_VALIDATION)
@@ -3210,7 +3238,7 @@ CIMResponseMessage* BinaryCodec::decodeResponse(
     String messageId;
     Operation operation;
 
-    if (!_getHeader(buf, flags, messageId, operation))
+    if (!_getHeader(buf, flags, messageId, operation, compact))
     {
         throw CIMException(CIM_ERR_FAILED, "Corrupt binary message header");
         return 0;
@@ -3301,6 +3329,8 @@ CIMResponseMessage* BinaryCodec::decodeResponse(
     if (!msg)
         throw CIMException(CIM_ERR_FAILED, "Received corrupted binary message");
 
+    msg->compactBinaryResponse = (flags & COMPACT_ENCODING) != 0;
+
     return msg;
 }
 
@@ -3310,7 +3340,7 @@ CIMResponseMessage* BinaryCodec::decodeResponse(
 //
 //==============================================================================
 
-Buffer BinaryCodec::formatSimpleIMethodRspMessage(
+static Buffer _formatSimpleIMethodRspMessage(
     const CIMName& iMethodName,
     const String& messageId,
     HttpMethod httpMethod,
@@ -3318,7 +3348,7 @@ Buffer BinaryCodec::formatSimpleIMethodRspMessage(
     const Buffer& body,
     Uint64 serverResponseTime,
     Boolean isFirst,
-    Boolean isLast)
+    bool compact)
 {
     Buffer out;
 
@@ -3326,11 +3356,12 @@ Buffer BinaryCodec::formatSimpleIMethodRspMessage(
     {
         // Write HTTP header:
         XmlWriter::appendMethodResponseHeader(out, httpMethod,
-            httpContentLanguages, 0, serverResponseTime, true);
+            httpContentLanguages, 0, serverResponseTime, true, compact);
 
         // Binary message header:
         CIMBuffer cb(128);
-        _putHeader(cb, 0, messageId, _NameToOp(iMethodName));
+        _putHeader(cb, compact ? COMPACT_ENCODING : 0, messageId,
+            _NameToOp(iMethodName));
         out.append(cb.getData(), cb.size());
     }
 
@@ -3342,6 +3373,34 @@ Buffer BinaryCodec::formatSimpleIMethodRspMessage(
     return out;
 }
 
+Buffer BinaryCodec::formatSimpleIMethodRspMessage(
+    const CIMName& iMethodName,
+    const String& messageId,
+    HttpMethod httpMethod,
+    const ContentLanguageList& httpContentLanguages,
+    const Buffer& body,
+    Uint64 serverResponseTime,
+    Boolean isFirst,
+    Boolean isLast)
+{
+    return _formatSimpleIMethodRspMessage(iMethodName, messageId, httpMethod,
+        httpContentLanguages, body, serverResponseTime, isFirst, false);
+}
+
+Buffer BinaryCodec::formatSimpleIMethodCompactRspMessage(
+    const CIMName& iMethodName,
+    const String& messageId,
+    HttpMethod httpMethod,
+    const ContentLanguageList& httpContentLanguages,
+    const Buffer& body,
+    Uint64 serverResponseTime,
+    Boolean isFirst,
+    Boolean isLast)
+{
+    return _formatSimpleIMethodRspMessage(iMethodName, messageId, httpMethod,
+        httpContentLanguages, body, serverResponseTime, isFirst, true);
+}
+
 //==============================================================================
 //
 // BinaryCodec::encodeRequest()
@@ -3353,11 +3412,14 @@ bool BinaryCodec::encodeRequest(
     const char* host,
     const String& authHeader,
     CIMOperationRequestMessage* msg,
-    bool binaryResponse)
+    bool binaryResponse,
+    bool compact)
 {
     CIMBuffer buf;
     CIMName name;
 
+    buf.setCompact(compact);
+
     switch (msg->getType())
     {
         case CIM_ENUMERATE_INSTANCES_REQUEST_MESSAGE:
@@ -3529,8 +3591,8 @@ bool BinaryCodec::encodeRequest(
         }
 
         default:
-            // Unexpected message type
-            PEGASUS_ASSERT(0);
+            // Not supported by the binary protocol (e.g. pull operations);
+            // the caller encodes the request as XML instead.
             return false;
     }
 
@@ -3548,7 +3610,8 @@ bool BinaryCodec::encodeRequest(
             ContentLanguageListContainer::NAME)).getLanguages(),
         buf.size(),
         true, /* binaryRequest */
-        binaryResponse);
+        binaryResponse,
+        compact);
 
     out.append(buf.getData(), buf.size());
 
@@ -3568,6 +3631,8 @@ bool BinaryCodec::encodeResponseBody(
 {
     CIMBuffer buf;
 
+    buf.setCompact(msg->compactBinaryResponse);
+
     switch (msg->getType())
     {
         case CIM_ENUMERATE_INSTANCES_RESPONSE_MESSAGE:
@@ -3756,4 +3821,185 @@ bool BinaryCodec::encodeResponseBody(
     return true;
 }
 
+//==============================================================================
+//
+// ExportIndication
+//
+//==============================================================================
+
+void BinaryCodec::encodeExportIndicationRequest(
+    Buffer& out,
+    const String& messageId,
+    const Array<CIMInstance>& indications,
+    const Array<ContentLanguageList>& contentLanguages)
+{
+    PEGASUS_ASSERT(indications.size() == contentLanguages.size());
+
+    CIMBuffer buf;
+    buf.setCompact(true);
+
+    _putHeader(buf, 0, messageId, OP_IndicationDelivery);
+
+    // [COUNT]
+    buf.putUint32(indications.size());
+
+    for (Uint32 i = 0; i < indications.size(); i++)
+    {
+        // [CONTENT-LANGUAGES]
+        buf.putString(
+            LanguageParser::buildContentLanguageHeader(contentLanguages[i]));
+
+        // [INDICATION]
+        buf.putInstance(indications[i]);
+    }
+
+    out.append(buf.getData(), buf.size());
+}
+
+bool BinaryCodec::decodeExportIndicationRequest(
+    const Buffer& in,
+    String& messageId,
+    Array<CIMInstance>& indications,
+    Array<ContentLanguageList>& contentLanguages)
+{
+    CIMBuffer buf((char*)in.getData(), in.size());
+    CIMBufferReleaser buf_(buf);
+
+    // Turn on validation:
+#if defined(ENABLE_VALIDATION)
+    buf.setValidate(true);
+#endif
+
+    Uint32 flags;
+    Operation operation;
+
+    if (!_getHeader(buf, flags, messageId, operation, true) ||
+        operation != OP_IndicationDelivery)
+    {
+        return false;
+    }
+
+    // [COUNT]
+    Uint32 count;
+
+    if (!buf.getUint32(count))
+        return false;
+
+    indications.clear();
+    contentLanguages.clear();
+
+    for (Uint32 i = 0; i < count; i++)
+    {
+        // [CONTENT-LANGUAGES]
+        String languages;
+
+        if (!buf.getString(languages))
+            return false;
+
+        // An indication without content languages has an empty string here,
+        // which is not a valid Content-Language header value.
+        if (languages.size() == 0)
+        {
+            contentLanguages.append(ContentLanguageList());
+        }
+        else
+        {
+            try
+            {
+                contentLanguages.append(
+                    LanguageParser::parseContentLanguageHeader(languages));
+            }
+            catch (Exception&)
+            {
+                return false;
+            }
+        }
+
+        // [INDICATION]
+        CIMInstance indication;
+
+        if (!buf.getInstance(indication))
+            return false;
+
+        indications.append(indication);
+    }
+
+    return true;
+}
+
+void BinaryCodec::encodeExportIndicationResponse(
+    Buffer& out,
+    const String& messageId,
+    const Array<CIMException>& results)
+{
+    CIMBuffer buf;
+    buf.setCompact(true);
+
+    _putHeader(buf, 0, messageId, OP_IndicationDelivery);
+
+    // [COUNT]
+    buf.putUint32(results.size());
+
+    for (Uint32 i = 0; i < results.size(); i++)
+    {
+        // [CODE]
+        buf.putUint32(results[i].getCode());
+
+        // [MESSAGE]
+        buf.putString(results[i].getMessage());
+    }
+
+    out.append(buf.getData(), buf.size());
+}
+
+bool BinaryCodec::decodeExportIndicationResponse(
+    const Buffer& in,
+    String& messageId,
+    Array<CIMException>& results)
+{
+    CIMBuffer buf((char*)in.getData(), in.size());
+    CIMBufferReleaser buf_(buf);
+
+    // Turn on validation:
+#if defined(ENABLE_VALIDATION)
+    buf.setValidate(true);
+#endif
+
+    Uint32 flags;
+    Operation operation;
+
+    if (!_getHeader(buf, flags, messageId, operation, true) ||
+        operation != OP_IndicationDelivery)
+    {
+        return false;
+    }
+
+    // [COUNT]
+    Uint32 count;
+
+    if (!buf.getUint32(count))
+        return false;
+
+    results.clear();
+
+    for (Uint32 i = 0; i < count; i++)
+    {
+        // [CODE]
+        Uint32 code;
+
+        if (!buf.getUint32(code))
+            return false;
+
+        // [MESSAGE]
+        String message;
+
+        if (!buf.getString(message))
+            return false;
+
+        results.append(CIMException(CIMStatusCode(code), message));
+    }
+
+    return true;
+}
+
 PEGASUS_NAMESPACE_END
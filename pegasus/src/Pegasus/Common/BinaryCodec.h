@@ -43,7 +43,9 @@
 PEGASUS_NAMESPACE_BEGIN
 
 /** This is the coder-decoder (codec) for the OpenPegasus proprietary binary
-    protocol.
+    protocol. Local connections use the aligned encoding of CIMBuffer, remote
+    clients its compact encoding (see CIMBuffer::setCompact()). The message
+    header tells the decoder which one a message uses.
 */
 class PEGASUS_COMMON_LINKAGE BinaryCodec
 {
@@ -57,23 +59,29 @@ public:
         const char* host,
         const String& authenticationHeader,
         CIMOperationRequestMessage* msg,
-        bool binaryResponse);
+        bool binaryResponse,
+        bool compact = false);
 
     static bool encodeResponseBody(
         Buffer& out,
         const CIMResponseMessage* msg,
         CIMName& name);
 
+    // The decoders fail on a message whose encoding is not the expected
+    // one, compact or aligned.
     static CIMOperationRequestMessage* decodeRequest(
         const Buffer& in,
         Uint32 queueId,
-        Uint32 returnQueueId);
+        Uint32 returnQueueId,
+        bool compact = false);
 
     static CIMResponseMessage* decodeResponse(
-        const Buffer& in);
+        const Buffer& in,
+        bool compact = false);
 
     static CIMResponseMessage* decodeResponse(
-        CIMBuffer& in);
+        CIMBuffer& in,
+        bool compact = false);
 
     static Buffer formatSimpleIMethodRspMessage(
         const CIMName& iMethodName,
@@ -85,6 +93,47 @@ public:
         Boolean isFirst,
         Boolean isLast);
 
+    // Same as formatSimpleIMethodRspMessage() for a body in the compact
+    // encoding.
+    static Buffer formatSimpleIMethodCompactRspMessage(
+        const CIMName& iMethodName,
+        const String& messageId,
+        HttpMethod httpMethod,
+        const ContentLanguageList& httpContentLanguages,
+        const Buffer& body,
+        Uint64 serverResponseTime,
+        Boolean isFirst,
+        Boolean isLast);
+
+    /** Encodes a batch of indications as the content of a single
+        ExportIndication request to an OpenPegasus listener, in the compact
+        encoding.
+    */
+    static void encodeExportIndicationRequest(
+        Buffer& out,
+        const String& messageId,
+        const Array<CIMInstance>& indications,
+        const Array<ContentLanguageList>& contentLanguages);
+
+    static bool decodeExportIndicationRequest(
+        const Buffer& in,
+        String& messageId,
+        Array<CIMInstance>& indications,
+        Array<ContentLanguageList>& contentLanguages);
+
+    /** Encodes the response to an ExportIndication request, with the
+        result of each indication in the order of the request.
+    */
+    static void encodeExportIndicationResponse(
+        Buffer& out,
+        const String& messageId,
+        const Array<CIMException>& results);
+
+    static bool decodeExportIndicationResponse(
+        const Buffer& in,
+        String& messageId,
+        Array<CIMException>& results);
+
 private:
 
     BinaryCodec();
@@ -71,6 +71,13 @@ CIMMessage* CIMBinMsgDeserializer::deserialize(
     if (!in.getBoolean(binaryResponse))
         return 0;
 
+    // [compactBinaryResponse]
+
+    Boolean compactBinaryResponse;
+
+    if (!in.getBoolean(compactBinaryResponse))
+        return 0;
+
     // [type]
 
     MessageType type;
@@ -145,6 +152,7 @@ CIMMessage* CIMBinMsgDeserializer::deserialize(
     msg->messageId = messageID;
     msg->binaryRequest = binaryRequest;
     msg->binaryResponse = binaryResponse;
+    msg->compactBinaryResponse = compactBinaryResponse;
 #ifndef PEGASUS_DISABLE_PERFINST
     msg->setServerStartTime(serverStartTimeMicroseconds);
     msg->setProviderTime(providerTimeMicroseconds);
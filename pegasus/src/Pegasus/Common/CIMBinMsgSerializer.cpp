@@ -51,6 +51,9 @@ void CIMBinMsgSerializer::serialize(
     // [binaryResponse]
     out.putBoolean(cimMessage->binaryResponse);
 
+    // [compactBinaryResponse]
+    out.putBoolean(cimMessage->compactBinaryResponse);
+
     // [type]
     out.putUint32(Uint32(cimMessage->getType()));
 
@@ -48,6 +48,8 @@
 #include "Buffer.h"
 #include "BinaryCodec.h"
 #include "SCMOStreamer.h"
+#include "HashTable.h"
+#include "CommonUTF.h"
 
 #define INSTANCE_MAGIC 0xD6EF2219
 #define CLASS_MAGIC 0xA8D7DE41
@@ -130,6 +132,65 @@ static inline bool _validNamespaceName(const String& str)
     return CIMNamespaceName::legal(str);
 }
 
+// The names of a segment of a compact message (see CIMBuffer::setCompact()).
+// A name is written as 0 followed by the name the first time, and as its
+// position in the table plus one after that. The writer looks names up in
+// the index, the reader keeps them in the order of arrival. Class and
+// property names share a table; namespace names, which are checked
+// differently, have their own.
+struct CIMBufferNameTable
+{
+    typedef HashTable<String, Uint32, EqualFunc<String>, HashFunc<String> >
+        Index;
+
+    CIMBufferNameTable() : index(64)
+    {
+    }
+
+    void clear()
+    {
+        if (index.size())
+            index.clear();
+
+        names.clear();
+    }
+
+    Index index;
+    Array<String> names;
+};
+
+struct CIMBufferNames
+{
+    CIMBufferNameTable tables[2];
+};
+
+// Returns the number of bytes of the UTF-8 form of the given UTF-16 data.
+// Unpaired surrogates are counted as three bytes each.
+static inline size_t _utf8Size(const Uint16* p, Uint32 n)
+{
+    size_t size = n;
+
+    for (const Uint16* end = p + n; p != end; p++)
+    {
+        if (*p >= 0x80)
+        {
+            if (*p < 0x800)
+                size += 1;
+            else if (*p >= 0xD800 && *p <= 0xDBFF && p + 1 != end &&
+                p[1] >= 0xDC00 && p[1] <= 0xDFFF)
+            {
+                // Four bytes for the surrogate pair.
+                size += 2;
+                p++;
+            }
+            else
+                size += 2;
+        }
+    }
+
+    return size;
+}
+
 void CIMBuffer::_create(size_t size)
 {
     if (size < 1024)
@@ -155,17 +216,20 @@ void CIMBuffer::_create(size_t size)
     _ptr = _data;
 }
 
-CIMBuffer::CIMBuffer(size_t size) : _swap(0), _validate(0)
+CIMBuffer::CIMBuffer(size_t size) :
+    _swap(0), _validate(0), _compact(0), _names(0)
 {
     _create(size);
 }
 
-CIMBuffer::CIMBuffer() : _data(0), _end(0), _ptr(0), _swap(0), _validate(0)
+CIMBuffer::CIMBuffer() :
+    _data(0), _end(0), _ptr(0), _swap(0), _validate(0), _compact(0), _names(0)
 {
 }
 
 CIMBuffer::~CIMBuffer()
 {
+    delete _names;
     free(_data);
 }
 
@@ -204,8 +268,186 @@ void CIMBuffer::_grow(size_t size)
 
 }
 
+bool CIMBuffer::_getVarUint(Uint64& x, size_t maxBytes)
+{
+    const Uint8* p = (const Uint8*)_ptr;
+    const Uint8* end = (const Uint8*)_end;
+
+    if (size_t(end - p) < maxBytes)
+        maxBytes = end - p;
+
+    x = 0;
+
+    for (size_t i = 0; i < maxBytes; i++)
+    {
+        x |= Uint64(p[i] & 0x7F) << (7 * i);
+
+        if (p[i] < 0x80)
+        {
+            _ptr += i + 1;
+            return true;
+        }
+    }
+
+    // Truncated or too long.
+    return false;
+}
+
+void CIMBuffer::_putUTF8(const String& x)
+{
+    const Uint16* p = (const Uint16*)x.getChar16Data();
+    Uint32 n = x.size();
+    size_t size = _utf8Size(p, n);
+
+    _putVarUint32(Uint32(size));
+
+    if (size_t(_end - _ptr) < size)
+        _grow(size);
+
+    Uint8* q = (Uint8*)_ptr;
+
+    if (size == n)
+    {
+        // 7-bit ASCII
+        for (Uint32 i = 0; i < n; i++)
+            q[i] = Uint8(p[i]);
+    }
+    else
+    {
+        for (const Uint16* end = p + n; p != end; p++)
+        {
+            Uint32 c = *p;
+
+            if (c < 0x80)
+            {
+                *q++ = Uint8(c);
+            }
+            else if (c < 0x800)
+            {
+                *q++ = Uint8(0xC0 | (c >> 6));
+                *q++ = Uint8(0x80 | (c & 0x3F));
+            }
+            else if (c >= 0xD800 && c <= 0xDBFF && p + 1 != end &&
+                p[1] >= 0xDC00 && p[1] <= 0xDFFF)
+            {
+                c = 0x10000 + ((c - 0xD800) << 10) + (*++p - 0xDC00);
+                *q++ = Uint8(0xF0 | (c >> 18));
+                *q++ = Uint8(0x80 | ((c >> 12) & 0x3F));
+                *q++ = Uint8(0x80 | ((c >> 6) & 0x3F));
+                *q++ = Uint8(0x80 | (c & 0x3F));
+            }
+            else
+            {
+                *q++ = Uint8(0xE0 | (c >> 12));
+                *q++ = Uint8(0x80 | ((c >> 6) & 0x3F));
+                *q++ = Uint8(0x80 | (c & 0x3F));
+            }
+        }
+    }
+
+    _ptr += size;
+}
+
+bool CIMBuffer::_getUTF8(String& x)
+{
+    Uint32 n;
+
+    if (!_getVarUint32(n))
+        return false;
+
+    if (size_t(_end - _ptr) < n)
+        return false;
+
+    if (n)
+    {
+        try
+        {
+            x.assign(_ptr, n);
+        }
+        catch (const Exception&)
+        {
+            // Not well-formed UTF-8.
+            return false;
+        }
+
+        if (_validate &&
+            !_validString((const Uint16*)x.getChar16Data(), x.size()))
+        {
+            return false;
+        }
+    }
+    else
+        x.clear();
+
+    _ptr += n;
+    return true;
+}
+
+void CIMBuffer::_putCompactName(Uint32 table, const String& x)
+{
+    if (!_names)
+        _names = new CIMBufferNames;
+
+    CIMBufferNameTable& t = _names->tables[table];
+    Uint32 pos;
+
+    if (t.index.lookup(x, pos))
+    {
+        _putVarUint32(pos + 1);
+        return;
+    }
+
+    t.index.insert(x, t.index.size());
+    _putVarUint32(0);
+    _putUTF8(x);
+}
+
+bool CIMBuffer::_getCompactName(Uint32 table, String& x)
+{
+    if (!_names)
+        _names = new CIMBufferNames;
+
+    CIMBufferNameTable& t = _names->tables[table];
+    Uint32 ref;
+
+    if (!_getVarUint32(ref))
+        return false;
+
+    if (ref)
+    {
+        if (ref > t.names.size())
+            return false;
+
+        x = t.names[ref - 1];
+        return true;
+    }
+
+    // Validate a new name once, as it enters the table.
+
+    if (!_getUTF8(x))
+        return false;
+
+    if (_validate &&
+        !(table == _NAMES ? _validName(x) : _validNamespaceName(x)))
+    {
+        return false;
+    }
+
+    t.names.append(x);
+    return true;
+}
+
+void CIMBuffer::_clearNames()
+{
+    _names->tables[_NAMES].clear();
+    _names->tables[_NAMESPACE_NAMES].clear();
+}
+
 bool CIMBuffer::getString(String& x)
 {
+    if (_compact)
+        return _getUTF8(x);
+
     Uint32 n;
 
     if (!getUint32(n))
@@ -238,7 +480,12 @@ bool CIMBuffer::getName(CIMName& x)
 {
     String tmp;
 
-    if (_validate)
+    if (_compact)
+    {
+        if (!_getCompactName(_NAMES, tmp))
+            return false;
+    }
+    else if (_validate)
     {
         // Get string without validation since we will validate name below.
 
@@ -266,7 +513,12 @@ bool CIMBuffer::getNamespaceName(CIMNamespaceName& x)
 {
     String tmp;
 
-    if (_validate)
+    if (_compact)
+    {
+        if (!_getCompactName(_NAMESPACE_NAMES, tmp))
+            return false;
+    }
+    else if (_validate)
     {
         // Get string without validation since we will validate namespace below.
 
@@ -1732,6 +1984,12 @@ bool CIMBuffer::getParamValue(CIMParamValue& x)
 
 void CIMBuffer::putPresent(Boolean flag)
 {
+    if (_compact)
+    {
+        putBoolean(flag);
+        return;
+    }
+
     if (flag)
         putUint32(PRESENT_MAGIC);
     else
@@ -1740,6 +1998,9 @@ void CIMBuffer::putPresent(Boolean flag)
 
 bool CIMBuffer::getPresent(Boolean& flag)
 {
+    if (_compact)
+        return getBoolean(flag);
+
     Uint32 tmp;
 
     if (!getUint32(tmp))
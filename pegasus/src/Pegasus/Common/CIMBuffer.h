@@ -68,7 +68,13 @@ PEGASUS_NAMESPACE_BEGIN
     the same as his own. If so, the data is used as is. Otherwise, the
     reader calls CIMBuffer::setSwap(true) to cause subsequent get calls to
     swap data ordering.
+
+    For remote connections, where message size matters more, CIMBuffer also
+    supports a compact encoding (see setCompact()).
 */
+
+struct CIMBufferNames;
+
 class PEGASUS_COMMON_LINKAGE CIMBuffer
 {
 public:
@@ -84,6 +90,8 @@ public:
         _end = data + size;
         _swap = 0;
         _validate = 0;
+        _compact = 0;
+        _names = 0;
     }
 
     ~CIMBuffer();
@@ -98,6 +106,26 @@ public:
         _validate = x ? 1 : 0;
     }
 
+    /** Selects the compact encoding for subsequent put and get calls. It
+        is used by the remote binary protocol. Integers are written as
+        variable-length quantities (7 bits per byte, signed values
+        zig-zag encoded), strings as UTF-8 and nothing is padded. Each
+        name (see putName() and putNamespaceName()) is written once per
+        segment; later occurrences refer to it by number. A segment
+        starts with each type marker (see putTypeMarker()). The compact
+        encoding does not depend on byte order, so setSwap() has no effect
+        on it. Data cannot be accessed in place (see getFastChar16Array()).
+    */
+    void setCompact(bool x)
+    {
+        _compact = x ? 1 : 0;
+    }
+
+    bool isCompact() const
+    {
+        return _compact != 0;
+    }
+
     bool more() const
     {
         return _ptr != _end;
@@ -145,6 +173,12 @@ public:
 
     void putBoolean(Boolean x)
     {
+        if (_compact)
+        {
+            _putByte(x ? 1 : 0);
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -154,6 +188,12 @@ public:
 
     void putUint8(Uint8 x)
     {
+        if (_compact)
+        {
+            _putByte(x);
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -163,6 +203,12 @@ public:
 
     void putSint8(Sint8 x)
     {
+        if (_compact)
+        {
+            _putByte(Uint8(x));
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -172,6 +218,12 @@ public:
 
     void putUint16(Uint16 x)
     {
+        if (_compact)
+        {
+            _putVarUint32(x);
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -181,6 +233,12 @@ public:
 
     void putSint16(Sint16 x)
     {
+        if (_compact)
+        {
+            _putVarUint32(_zigZag32(x));
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -190,6 +248,12 @@ public:
 
     void putUint32(Uint32 x)
     {
+        if (_compact)
+        {
+            _putVarUint32(x);
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -199,6 +263,12 @@ public:
 
     void putSint32(Sint32 x)
     {
+        if (_compact)
+        {
+            _putVarUint32(_zigZag32(x));
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -208,6 +278,12 @@ public:
 
     void putUint64(Uint64 x)
     {
+        if (_compact)
+        {
+            _putVarUint64(x);
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -217,6 +293,12 @@ public:
 
     void putSint64(Sint64 x)
     {
+        if (_compact)
+        {
+            _putVarUint64(_zigZag64(x));
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -226,6 +308,14 @@ public:
 
     void putReal32(Real32 x)
     {
+        if (_compact)
+        {
+            Uint32 bits;
+            memcpy(&bits, &x, sizeof(bits));
+            _putFixed32(bits);
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -235,6 +325,14 @@ public:
 
     void putReal64(Real64 x)
     {
+        if (_compact)
+        {
+            Uint64 bits;
+            memcpy(&bits, &x, sizeof(bits));
+            _putFixed64(bits);
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -244,6 +342,12 @@ public:
 
     void putChar16(Char16 x)
     {
+        if (_compact)
+        {
+            _putVarUint32(Uint16(x));
+            return;
+        }
+
         if (_end - _ptr < 8)
             _grow(sizeof(x));
 
@@ -253,7 +357,7 @@ public:
 
     void putBytes(const void* data, size_t size)
     {
-        size_t r = round(size);
+        size_t r = _pad(size);
 
         if (_end - _ptr < ptrdiff_t(r))
             _grow(r);
@@ -264,6 +368,12 @@ public:
 
     void putString(const String& x)
     {
+        if (_compact)
+        {
+            _putUTF8(x);
+            return;
+        }
+
         Uint32 n = x.size();
         putUint32(n);
         putBytes(x.getChar16Data(), n * sizeof(Char16));
@@ -273,6 +383,20 @@ public:
     // data will be read as String later
     void putUTF8AsString(const char * x, size_t x_size)
     {
+        if (_compact)
+        {
+            // The compact encoding already uses UTF-8.
+            if (0 == x)
+                x_size = 0;
+
+            _putVarUint32(Uint32(x_size));
+
+            if (x_size)
+                putBytes(x, x_size);
+
+            return;
+        }
+
         if (0 == x_size || 0 == x)
         {
             putUint32(0);
@@ -303,7 +427,7 @@ public:
         Uint32 n = x.size();
         putUint32(n);
 
-        size_t r = round(n);
+        size_t r = _pad(n);
 
         if (_end - _ptr < ptrdiff_t(r))
             _grow(r);
@@ -332,6 +456,14 @@ public:
     {
         Uint32 n = x.size();
         putUint32(n);
+
+        if (_compact)
+        {
+            for (Uint32 i = 0; i < n; i++)
+                putUint16(x[i]);
+            return;
+        }
+
         putBytes(x.getData(), n * sizeof(Uint16));
     }
 
@@ -339,6 +471,14 @@ public:
     {
         Uint32 n = x.size();
         putUint32(n);
+
+        if (_compact)
+        {
+            for (Uint32 i = 0; i < n; i++)
+                putSint16(x[i]);
+            return;
+        }
+
         putBytes(x.getData(), n * sizeof(Sint16));
     }
 
@@ -346,6 +486,14 @@ public:
     {
         Uint32 n = x.size();
         putUint32(n);
+
+        if (_compact)
+        {
+            for (Uint32 i = 0; i < n; i++)
+                putUint32(x[i]);
+            return;
+        }
+
         putBytes(x.getData(), n * sizeof(Uint32));
     }
 
@@ -353,6 +501,14 @@ public:
     {
         Uint32 n = x.size();
         putUint32(n);
+
+        if (_compact)
+        {
+            for (Uint32 i = 0; i < n; i++)
+                putSint32(x[i]);
+            return;
+        }
+
         putBytes(x.getData(), n * sizeof(Sint32));
     }
 
@@ -360,6 +516,14 @@ public:
     {
         Uint32 n = x.size();
         putUint32(n);
+
+        if (_compact)
+        {
+            for (Uint32 i = 0; i < n; i++)
+                putUint64(x[i]);
+            return;
+        }
+
         putBytes(x.getData(), n * sizeof(Uint64));
     }
 
@@ -367,6 +531,14 @@ public:
     {
         Uint32 n = x.size();
         putUint32(n);
+
+        if (_compact)
+        {
+            for (Uint32 i = 0; i < n; i++)
+                putSint64(x[i]);
+            return;
+        }
+
         putBytes(x.getData(), n * sizeof(Sint64));
     }
 
@@ -374,6 +546,14 @@ public:
     {
         Uint32 n = x.size();
         putUint32(n);
+
+        if (_compact)
+        {
+            for (Uint32 i = 0; i < n; i++)
+                putReal32(x[i]);
+            return;
+        }
+
         putBytes(x.getData(), n * sizeof(Real32));
     }
 
@@ -381,6 +561,14 @@ public:
     {
         Uint32 n = x.size();
         putUint32(n);
+
+        if (_compact)
+        {
+            for (Uint32 i = 0; i < n; i++)
+                putReal64(x[i]);
+            return;
+        }
+
         putBytes(x.getData(), n * sizeof(Real64));
     }
 
@@ -388,6 +576,14 @@ public:
     {
         Uint32 n = x.size();
         putUint32(n);
+
+        if (_compact)
+        {
+            for (Uint32 i = 0; i < n; i++)
+                putChar16(x[i]);
+            return;
+        }
+
         putBytes(x.getData(), n * sizeof(Char16));
     }
 
@@ -411,7 +607,7 @@ public:
 
     bool getBytes(void* data, size_t size)
     {
-        size_t r = round(size);
+        size_t r = _pad(size);
 
         if (_end - _ptr < ptrdiff_t(r))
             return false;
@@ -423,6 +619,17 @@ public:
 
     bool getBoolean(Boolean& x)
     {
+        if (_compact)
+        {
+            Uint8 tmp;
+
+            if (!_getByte(tmp))
+                return false;
+
+            x = tmp != 0;
+            return true;
+        }
+
         if (_end - _ptr < 8)
             return false;
 
@@ -433,6 +640,9 @@ public:
 
     bool getUint8(Uint8& x)
     {
+        if (_compact)
+            return _getByte(x);
+
         if (_end - _ptr < 8)
             return false;
 
@@ -443,6 +653,9 @@ public:
 
     bool getSint8(Sint8& x)
     {
+        if (_compact)
+            return _getByte(*((Uint8*)(void*)&x));
+
         if (_end - _ptr < 8)
             return false;
 
@@ -453,6 +666,17 @@ public:
 
     bool getUint16(Uint16& x)
     {
+        if (_compact)
+        {
+            Uint32 tmp;
+
+            if (!(_getVarUint32(tmp) && tmp <= 0xFFFF))
+                return false;
+
+            x = Uint16(tmp);
+            return true;
+        }
+
         if (_end - _ptr < 8)
             return false;
 
@@ -467,6 +691,17 @@ public:
 
     bool getSint16(Sint16& x)
     {
+        if (_compact)
+        {
+            Uint32 tmp;
+
+            if (!(_getVarUint32(tmp) && tmp <= 0xFFFF))
+                return false;
+
+            x = Sint16(_unZigZag32(tmp));
+            return true;
+        }
+
         if (_end - _ptr < 8)
             return false;
 
@@ -481,6 +716,9 @@ public:
 
     bool getUint32(Uint32& x)
     {
+        if (_compact)
+            return _getVarUint32(x);
+
         if (_end - _ptr < 8)
             return false;
 
@@ -495,6 +733,17 @@ public:
 
     bool getSint32(Sint32& x)
     {
+        if (_compact)
+        {
+            Uint32 tmp;
+
+            if (!_getVarUint32(tmp))
+                return false;
+
+            x = _unZigZag32(tmp);
+            return true;
+        }
+
         if (_end - _ptr < 8)
             return false;
 
@@ -509,6 +758,9 @@ public:
 
     bool getUint64(Uint64& x)
     {
+        if (_compact)
+            return _getVarUint64(x);
+
         if (_end - _ptr < 8)
             return false;
 
@@ -523,6 +775,17 @@ public:
 
     bool getSint64(Sint64& x)
     {
+        if (_compact)
+        {
+            Uint64 tmp;
+
+            if (!_getVarUint64(tmp))
+                return false;
+
+            x = _unZigZag64(tmp);
+            return true;
+        }
+
         if (_end - _ptr < 8)
             return false;
 
@@ -537,6 +800,17 @@ public:
 
     bool getReal32(Real32& x)
     {
+        if (_compact)
+        {
+            Uint32 bits;
+
+            if (!_getFixed32(bits))
+                return false;
+
+            memcpy(&x, &bits, sizeof(x));
+            return true;
+        }
+
         if (_end - _ptr < 8)
             return false;
 
@@ -551,6 +825,17 @@ public:
 
     bool getReal64(Real64& x)
     {
+        if (_compact)
+        {
+            Uint64 bits;
+
+            if (!_getFixed64(bits))
+                return false;
+
+            memcpy(&x, &bits, sizeof(x));
+            return true;
+        }
+
         if (_end - _ptr < 8)
             return false;
 
@@ -565,6 +850,17 @@ public:
 
     bool getChar16(Char16& x)
     {
+        if (_compact)
+        {
+            Uint32 tmp;
+
+            if (!(_getVarUint32(tmp) && tmp <= 0xFFFF))
+                return false;
+
+            x = Char16(Uint16(tmp));
+            return true;
+        }
+
         if (_end - _ptr < 8)
             return false;
 
@@ -617,7 +913,7 @@ public:
         if (!getUint32(n))
             return false;
 
-        size_t r = round(n);
+        size_t r = _pad(n);
 
         if (_end - _ptr < ptrdiff_t(r))
             return false;
@@ -638,7 +934,7 @@ public:
         if (!getUint32(n))
             return false;
 
-        size_t r = round(n * sizeof(Uint8));
+        size_t r = _pad(n * sizeof(Uint8));
 
         if (_end - _ptr < ptrdiff_t(r))
             return false;
@@ -655,7 +951,7 @@ public:
         if (!getUint32(n))
             return false;
 
-        size_t r = round(n * sizeof(Sint8));
+        size_t r = _pad(n * sizeof(Sint8));
 
         if (_end - _ptr < ptrdiff_t(r))
             return false;
@@ -672,6 +968,9 @@ public:
         if (!getUint32(n))
             return false;
 
+        if (_compact)
+            return _getCompactA(x, n, &CIMBuffer::getUint16);
+
         size_t r = round(n * sizeof(Uint16));
 
         if (_end - _ptr < ptrdiff_t(r))
@@ -693,6 +992,9 @@ public:
         if (!getUint32(n))
             return false;
 
+        if (_compact)
+            return _getCompactA(x, n, &CIMBuffer::getSint16);
+
         size_t r = round(n * sizeof(Sint16));
 
         if (_end - _ptr < ptrdiff_t(r))
@@ -714,6 +1016,9 @@ public:
         if (!getUint32(n))
             return false;
 
+        if (_compact)
+            return _getCompactA(x, n, &CIMBuffer::getUint32);
+
         size_t r = round(n * sizeof(Uint32));
 
         if (_end - _ptr < ptrdiff_t(r))
@@ -735,6 +1040,9 @@ public:
         if (!getUint32(n))
             return false;
 
+        if (_compact)
+            return _getCompactA(x, n, &CIMBuffer::getSint32);
+
         size_t r = round(n * sizeof(Sint32));
 
         if (_end - _ptr < ptrdiff_t(r))
@@ -756,6 +1064,9 @@ public:
         if (!getUint32(n))
             return false;
 
+        if (_compact)
+            return _getCompactA(x, n, &CIMBuffer::getUint64);
+
         size_t r = round(n * sizeof(Uint64));
 
         if (_end - _ptr < ptrdiff_t(r))
@@ -777,6 +1088,9 @@ public:
         if (!getUint32(n))
             return false;
 
+        if (_compact)
+            return _getCompactA(x, n, &CIMBuffer::getSint64);
+
         size_t r = round(n * sizeof(Sint64));
 
         if (_end - _ptr < ptrdiff_t(r))
@@ -798,6 +1112,9 @@ public:
         if (!getUint32(n))
             return false;
 
+        if (_compact)
+            return _getCompactA(x, n, &CIMBuffer::getReal32);
+
         size_t r = round(n * sizeof(Real32));
 
         if (_end - _ptr < ptrdiff_t(r))
@@ -819,6 +1136,9 @@ public:
         if (!getUint32(n))
             return false;
 
+        if (_compact)
+            return _getCompactA(x, n, &CIMBuffer::getReal64);
+
         size_t r = round(n * sizeof(Real64));
 
         if (_end - _ptr < ptrdiff_t(r))
@@ -840,6 +1160,9 @@ public:
         if (!getUint32(n))
             return false;
 
+        if (_compact)
+            return _getCompactA(x, n, &CIMBuffer::getChar16);
+
         size_t r = round(n * sizeof(Char16));
 
         if (_end - _ptr < ptrdiff_t(r))
@@ -860,6 +1183,10 @@ public:
     // of the CIMBuffer.
     bool getFastChar16Array(Char16** x, Uint32& n)
     {
+        // The compact encoding holds strings as UTF-8.
+        if (_compact)
+            return false;
+
         if (!getUint32(n))
             return false;
 
@@ -986,11 +1313,23 @@ public:
 
     void putName(const CIMName& x)
     {
+        if (_compact)
+        {
+            _putCompactName(_NAMES, x.getString());
+            return;
+        }
+
         putString(x.getString());
     }
 
     void putNamespaceName(const CIMNamespaceName& x)
     {
+        if (_compact)
+        {
+            _putCompactName(_NAMESPACE_NAMES, x.getString());
+            return;
+        }
+
         putString(x.getString());
     }
 
@@ -1016,12 +1355,12 @@ public:
 
         for (Uint32 i = 0; i < n; i++)
         {
-            String tmp;
+            CIMName tmp;
 
-            if (!getString(tmp))
+            if (!getName(tmp))
                 return false;
 
-            x.append(CIMNameCast(tmp));
+            x.append(tmp);
         }
 
         return true;
@@ -1213,13 +1552,22 @@ public:
 
     bool getPresent(Boolean& flag);
 
+    // A type marker starts a segment that can be decoded on its own, so
+    // the compact encoding forgets the names seen so far.
+
     void putTypeMarker(Uint32 typeMarker)
     {
+        if (_names)
+            _clearNames();
+
         putUint32(typeMarker);
     }
 
     bool getTypeMarker(Uint32& typeMarker)
     {
+        if (_names)
+            _clearNames();
+
         return getUint32(typeMarker);
     }
 
@@ -1229,16 +1577,201 @@ private:
 
     void _grow(size_t size);
 
+    // Compact encoding helpers:
+
+    enum { _NAMES, _NAMESPACE_NAMES };
+
+    size_t _pad(size_t size) const
+    {
+        return _compact ? size : round(size);
+    }
+
+    static Uint32 _zigZag32(Sint32 x)
+    {
+        return (Uint32(x) << 1) ^ Uint32(x >> 31);
+    }
+
+    static Sint32 _unZigZag32(Uint32 x)
+    {
+        return Sint32(x >> 1) ^ -Sint32(x & 1);
+    }
+
+    static Uint64 _zigZag64(Sint64 x)
+    {
+        return (Uint64(x) << 1) ^ Uint64(x >> 63);
+    }
+
+    static Sint64 _unZigZag64(Uint64 x)
+    {
+        return Sint64(x >> 1) ^ -Sint64(x & 1);
+    }
+
+    void _putByte(Uint8 x)
+    {
+        if (_end == _ptr)
+            _grow(1);
+
+        *((Uint8*)_ptr++) = x;
+    }
+
+    bool _getByte(Uint8& x)
+    {
+        if (_end == _ptr)
+            return false;
+
+        x = *((Uint8*)_ptr++);
+        return true;
+    }
+
+    void _putVarUint32(Uint32 x)
+    {
+        if (_end - _ptr < 5)
+            _grow(5);
+
+        Uint8* p = (Uint8*)_ptr;
+
+        while (x >= 0x80)
+        {
+            *p++ = Uint8(x) | 0x80;
+            x >>= 7;
+        }
+
+        *p++ = Uint8(x);
+        _ptr = (char*)p;
+    }
+
+    void _putVarUint64(Uint64 x)
+    {
+        if (_end - _ptr < 10)
+            _grow(10);
+
+        Uint8* p = (Uint8*)_ptr;
+
+        while (x >= 0x80)
+        {
+            *p++ = Uint8(x) | 0x80;
+            x >>= 7;
+        }
+
+        *p++ = Uint8(x);
+        _ptr = (char*)p;
+    }
+
+    bool _getVarUint32(Uint32& x)
+    {
+        // Most values in a message fit in one byte.
+        if (_end != _ptr && *((Uint8*)_ptr) < 0x80)
+        {
+            x = *((Uint8*)_ptr++);
+            return true;
+        }
+
+        Uint64 tmp;
+
+        if (!_getVarUint(tmp, 5) || tmp > 0xFFFFFFFF)
+            return false;
+
+        x = Uint32(tmp);
+        return true;
+    }
+
+    bool _getVarUint64(Uint64& x)
+    {
+        return _getVarUint(x, 10);
+    }
+
+    bool _getVarUint(Uint64& x, size_t maxBytes);
+
+    // Real values are written as their bit patterns, low byte first.
+
+    void _putFixed32(Uint32 x)
+    {
+        if (_end - _ptr < 4)
+            _grow(4);
+
+        for (size_t i = 0; i < 4; i++, x >>= 8)
+            *((Uint8*)_ptr++) = Uint8(x);
+    }
+
+    void _putFixed64(Uint64 x)
+    {
+        if (_end - _ptr < 8)
+            _grow(8);
+
+        for (size_t i = 0; i < 8; i++, x >>= 8)
+            *((Uint8*)_ptr++) = Uint8(x);
+    }
+
+    bool _getFixed32(Uint32& x)
+    {
+        if (_end - _ptr < 4)
+            return false;
+
+        const Uint8* p = (const Uint8*)_ptr;
+        x = Uint32(p[0]) | (Uint32(p[1]) << 8) | (Uint32(p[2]) << 16) |
+            (Uint32(p[3]) << 24);
+        _ptr += 4;
+        return true;
+    }
+
+    bool _getFixed64(Uint64& x)
+    {
+        Uint32 lo;
+        Uint32 hi;
+
+        if (_end - _ptr < 8 || !_getFixed32(lo) || !_getFixed32(hi))
+            return false;
+
+        x = Uint64(lo) | (Uint64(hi) << 32);
+        return true;
+    }
+
+    template<class T>
+    bool _getCompactA(Array<T>& x, Uint32 n, bool (CIMBuffer::*get)(T&))
+    {
+        // Every element takes at least one byte.
+        if (size_t(_end - _ptr) < n)
+            return false;
+
+        x.reserveCapacity(x.size() + n);
+
+        for (Uint32 i = 0; i < n; i++)
+        {
+            T tmp;
+
+            if (!(this->*get)(tmp))
+                return false;
+
+            x.append(tmp);
+        }
+
+        return true;
+    }
+
+    void _putUTF8(const String& x);
+
+    bool _getUTF8(String& x);
+
+    void _putCompactName(Uint32 table, const String& x);
+
+    bool _getCompactName(Uint32 table, String& x);
+
+    void _clearNames();
+
     void _putMagic(Uint32 magic)
     {
 #if defined(PEGASUS_USE_MAGIC)
-        putUint32(magic);
+        if (!_compact)
+            putUint32(magic);
 #endif
     }
 
     bool _testMagic(Uint32 magic)
     {
 #if defined(PEGASUS_USE_MAGIC)
+        if (_compact)
+            return true;
+
         Uint32 tmp;
 
         if (!getUint32(tmp))
@@ -1382,6 +1915,10 @@ private:
 
     int _swap;
     int _validate;
+    int _compact;
+
+    // The names seen so far in the current segment of a compact message.
+    CIMBufferNames* _names;
 };
 
 
@@ -53,6 +53,7 @@ void CIMResponseMessage::syncAttributes(const CIMRequestMessage* request)
 #endif
     binaryRequest = request->binaryRequest;
     binaryResponse = request->binaryResponse;
+    compactBinaryResponse = request->compactBinaryResponse;
 }
 
 CIMResponseMessage* CIMGetClassRequestMessage::buildResponse() const
@@ -341,6 +342,41 @@ CIMResponseMessage* CIMInvokeMethodRequestMessage::buildResponse() const
     return response.release();
 }
 
+CIMResponseMessage*
+    CIMOpenEnumerateInstancesRequestMessage::buildResponse() const
+{
+    AutoPtr<CIMOpenEnumerateInstancesResponseMessage> response(
+        new CIMOpenEnumerateInstancesResponseMessage(
+            messageId,
+            CIMException(),
+            queueIds.copyAndPop()));
+    response->syncAttributes(this);
+    return response.release();
+}
+
+CIMResponseMessage*
+    CIMPullInstancesWithPathRequestMessage::buildResponse() const
+{
+    AutoPtr<CIMPullInstancesWithPathResponseMessage> response(
+        new CIMPullInstancesWithPathResponseMessage(
+            messageId,
+            CIMException(),
+            queueIds.copyAndPop()));
+    response->syncAttributes(this);
+    return response.release();
+}
+
+CIMResponseMessage* CIMCloseEnumerationRequestMessage::buildResponse() const
+{
+    AutoPtr<CIMCloseEnumerationResponseMessage> response(
+        new CIMCloseEnumerationResponseMessage(
+            messageId,
+            CIMException(),
+            queueIds.copyAndPop()));
+    response->syncAttributes(this);
+    return response.release();
+}
+
 CIMResponseMessage* CIMProcessIndicationRequestMessage::buildResponse() const
 {
     AutoPtr<CIMProcessIndicationResponseMessage> response(
@@ -555,6 +591,7 @@ CIMMessage::CIMMessage(
 
     binaryRequest = false;
     binaryResponse = false;
+    compactBinaryResponse = false;
 }
 
 #ifndef PEGASUS_DISABLE_PERFINST
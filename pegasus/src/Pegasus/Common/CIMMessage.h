@@ -146,6 +146,13 @@ public:
     // as the "Accept" header is "application/x-openpegasus".
     Boolean binaryResponse;
 
+    // This flag indicates that the binary response to this message uses
+    // the compact encoding of the remote binary protocol. This means the
+    // original request's "Accept" HTTP header had a value of
+    // "application/x-openpegasus-compact". On the client, it indicates that
+    // the response was received in the compact encoding.
+    Boolean compactBinaryResponse;
+
 private:
 
     ThreadType _languageContextThreadId;
@@ -971,6 +978,104 @@ public:
     Array<CIMParamValue> inParameters;
 };
 
+class PEGASUS_COMMON_LINKAGE CIMOpenEnumerateInstancesRequestMessage
+    : public CIMOperationRequestMessage
+{
+public:
+    CIMOpenEnumerateInstancesRequestMessage(
+        const String& messageId_,
+        const CIMNamespaceName& nameSpace_,
+        const CIMName& className_,
+        Boolean deepInheritance_,
+        Boolean includeClassOrigin_,
+        const CIMPropertyList& propertyList_,
+        const String& filterQueryLanguage_,
+        const String& filterQuery_,
+        Uint32 operationTimeout_,
+        Boolean continueOnError_,
+        Uint32 maxObjectCount_,
+        const QueueIdStack& queueIds_,
+        const String& authType_ = String::EMPTY,
+        const String& userName_ = String::EMPTY)
+    : CIMOperationRequestMessage(
+        CIM_OPEN_ENUMERATE_INSTANCES_REQUEST_MESSAGE, messageId_, queueIds_,
+         authType_, userName_,
+         nameSpace_, className_),
+        deepInheritance(deepInheritance_),
+        includeClassOrigin(includeClassOrigin_),
+        propertyList(propertyList_),
+        filterQueryLanguage(filterQueryLanguage_),
+        filterQuery(filterQuery_),
+        operationTimeout(operationTimeout_),
+        continueOnError(continueOnError_),
+        maxObjectCount(maxObjectCount_)
+    {
+    }
+
+    virtual CIMResponseMessage* buildResponse() const;
+
+    Boolean deepInheritance;
+    Boolean includeClassOrigin;
+    CIMPropertyList propertyList;
+    String filterQueryLanguage;
+    String filterQuery;
+    // Seconds; zero selects the server default
+    Uint32 operationTimeout;
+    Boolean continueOnError;
+    Uint32 maxObjectCount;
+};
+
+class PEGASUS_COMMON_LINKAGE CIMPullInstancesWithPathRequestMessage
+    : public CIMOperationRequestMessage
+{
+public:
+    CIMPullInstancesWithPathRequestMessage(
+        const String& messageId_,
+        const CIMNamespaceName& nameSpace_,
+        const String& enumerationContext_,
+        Uint32 maxObjectCount_,
+        const QueueIdStack& queueIds_,
+        const String& authType_ = String::EMPTY,
+        const String& userName_ = String::EMPTY)
+    : CIMOperationRequestMessage(
+        CIM_PULL_INSTANCES_WITH_PATH_REQUEST_MESSAGE, messageId_, queueIds_,
+         authType_, userName_,
+         nameSpace_, CIMName()),
+        enumerationContext(enumerationContext_),
+        maxObjectCount(maxObjectCount_)
+    {
+    }
+
+    virtual CIMResponseMessage* buildResponse() const;
+
+    String enumerationContext;
+    Uint32 maxObjectCount;
+};
+
+class PEGASUS_COMMON_LINKAGE CIMCloseEnumerationRequestMessage
+    : public CIMOperationRequestMessage
+{
+public:
+    CIMCloseEnumerationRequestMessage(
+        const String& messageId_,
+        const CIMNamespaceName& nameSpace_,
+        const String& enumerationContext_,
+        const QueueIdStack& queueIds_,
+        const String& authType_ = String::EMPTY,
+        const String& userName_ = String::EMPTY)
+    : CIMOperationRequestMessage(
+        CIM_CLOSE_ENUMERATION_REQUEST_MESSAGE, messageId_, queueIds_,
+         authType_, userName_,
+         nameSpace_, CIMName()),
+        enumerationContext(enumerationContext_)
+    {
+    }
+
+    virtual CIMResponseMessage* buildResponse() const;
+
+    String enumerationContext;
+};
+
 class PEGASUS_COMMON_LINKAGE CIMProcessIndicationRequestMessage
     : public CIMRequestMessage
 {
@@ -1916,6 +2021,83 @@ public:
     CIMName methodName;
 };
 
+/**
+    Common base of the responses to the open and pull operations.  Each
+    carries a portion of the enumeration result, the enumeration context
+    to continue with and whether the enumeration is exhausted.
+*/
+class PEGASUS_COMMON_LINKAGE CIMOpenOrPullResponseDataMessage
+    : public CIMResponseMessage
+{
+public:
+    CIMOpenOrPullResponseDataMessage(
+        MessageType type_,
+        const String& messageId_,
+        const CIMException& cimException_,
+        const QueueIdStack& queueIds_)
+    : CIMResponseMessage(type_, messageId_, cimException_, queueIds_),
+      endOfSequence(false),
+      _responseData(CIMResponseData::RESP_INSTANCES)
+    {
+    }
+
+    CIMResponseData& getResponseData()
+    {
+        return _responseData;
+    }
+
+    String enumerationContext;
+    Boolean endOfSequence;
+
+private:
+
+    CIMResponseData _responseData;
+};
+
+class PEGASUS_COMMON_LINKAGE CIMOpenEnumerateInstancesResponseMessage
+    : public CIMOpenOrPullResponseDataMessage
+{
+public:
+    CIMOpenEnumerateInstancesResponseMessage(
+        const String& messageId_,
+        const CIMException& cimException_,
+        const QueueIdStack& queueIds_)
+    : CIMOpenOrPullResponseDataMessage(
+        CIM_OPEN_ENUMERATE_INSTANCES_RESPONSE_MESSAGE,
+        messageId_, cimException_, queueIds_)
+    {
+    }
+};
+
+class PEGASUS_COMMON_LINKAGE CIMPullInstancesWithPathResponseMessage
+    : public CIMOpenOrPullResponseDataMessage
+{
+public:
+    CIMPullInstancesWithPathResponseMessage(
+        const String& messageId_,
+        const CIMException& cimException_,
+        const QueueIdStack& queueIds_)
+    : CIMOpenOrPullResponseDataMessage(
+        CIM_PULL_INSTANCES_WITH_PATH_RESPONSE_MESSAGE,
+        messageId_, cimException_, queueIds_)
+    {
+    }
+};
+
+class PEGASUS_COMMON_LINKAGE CIMCloseEnumerationResponseMessage
+    : public CIMResponseMessage
+{
+public:
+    CIMCloseEnumerationResponseMessage(
+        const String& messageId_,
+        const CIMException& cimException_,
+        const QueueIdStack& queueIds_)
+    : CIMResponseMessage(CIM_CLOSE_ENUMERATION_RESPONSE_MESSAGE,
+        messageId_, cimException_, queueIds_)
+    {
+    }
+};
+
 class PEGASUS_COMMON_LINKAGE CIMProcessIndicationResponseMessage
     : public CIMResponseMessage
 {
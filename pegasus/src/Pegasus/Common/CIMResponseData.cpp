@@ -123,6 +123,7 @@ bool CIMResponseData::setBinary(CIMBuffer& in, bool hasLen)
         size_t remainingDataLength = in.capacity() - in.size();
         _binaryData.append((Uint8*)in.getPtr(), remainingDataLength);
     }
+    _compactBinary = in.isCompact();
     _encoding |= RESP_ENC_BINARY;
     PEG_METHOD_EXIT();
     return true;
@@ -299,12 +300,59 @@ void CIMResponseData::appendResponseData(const CIMResponseData & x)
     _nameSpacesData.appendArray(x._nameSpacesData);
 }
 
+void CIMResponseData::moveInstances(CIMResponseData& from, Uint32 count)
+{
+    PEGASUS_DEBUG_ASSERT(_dataType == RESP_INSTANCES);
+    PEGASUS_DEBUG_ASSERT(from._dataType == RESP_INSTANCES);
+
+    Array<CIMInstance>& fromInstances = from.getInstances();
+    Array<CIMInstance>& toInstances = getInstances();
+
+    if (count > fromInstances.size())
+    {
+        count = fromInstances.size();
+    }
+
+    if (count)
+    {
+        toInstances.append(fromInstances.getData(), count);
+        fromInstances.remove(0, count);
+        _encoding |= RESP_ENC_CIM;
+    }
+}
+
+Uint32 CIMResponseData::size()
+{
+    _resolveToCIM();
+
+    switch (_dataType)
+    {
+        case RESP_INSTNAMES:
+        case RESP_OBJECTPATHS:
+            return _instanceNames.size();
+        case RESP_INSTANCE:
+        case RESP_INSTANCES:
+            return _instances.size();
+        case RESP_OBJECTS:
+            return _objects.size();
+    }
+
+    return 0;
+}
+
 // Encoding responses into output format
 void CIMResponseData::encodeBinaryResponse(CIMBuffer& out)
 {
     PEG_METHOD_ENTER(TRC_DISPATCHER,
         "CIMResponseData::encodeBinaryResponse");
 
+    // The compact encoding is only defined for the C++ objects; the binary
+    // data of the provider agents and SCMO are in the aligned encoding.
+    if (out.isCompact())
+    {
+        _resolveToCIM();
+    }
+
     // Need to do a complete job here by transferring all contained data
     // into binary format and handing it out in the CIMBuffer
     if (RESP_ENC_BINARY == (_encoding & RESP_ENC_BINARY))
@@ -560,13 +608,39 @@ void CIMResponseData::completeHostNameAndNamespace(
     }
 }
 
-void CIMResponseData::encodeXmlResponse(Buffer& out)
+// Reserves the output buffer for the XML encoding of the instances at once,
+// instead of copying it each time it grows.
+static void _reserveXmlSize(Buffer& out, const Array<SCMOInstance>& instances)
+{
+    Uint64 size =
+        out.size() + SCMOXmlWriter::estimateInstanceElementsSize(instances);
+
+    // Larger buffers fail anyway
+    if (size <= 0x3FFFFFFF)
+    {
+        out.reserveCapacity(Uint32(size));
+    }
+}
+
+void CIMResponseData::encodeXmlResponse(Buffer& out, Boolean isPull)
 {
     PEG_TRACE((TRC_XML, Tracer::LEVEL3,
         "CIMResponseData::encodeXmlResponse(encoding=%X,content=%X)",
         _encoding,
         _dataType));
 
+    if (isPull)
+    {
+        // The pull operations return instances with their full paths
+        PEGASUS_DEBUG_ASSERT(_dataType == RESP_INSTANCES);
+        _resolveToCIM();
+        for (Uint32 i = 0, n = _instances.size(); i < n; i++)
+        {
+            XmlWriter::appendValueInstanceWithPathElement(out, _instances[i]);
+        }
+        return;
+    }
+
     // already existing Internal XML does not need to be encoded further
     // binary input is not actually impossible here, but we have an established
     // fallback
@@ -717,6 +791,7 @@ void CIMResponseData::encodeXmlResponse(Buffer& out)
             }
             case RESP_INSTANCES:
             {
+                _reserveXmlSize(out, _scmoInstances);
                 for (Uint32 i = 0, n = _scmoInstances.size(); i < n; i++)
                 {
                     SCMOXmlWriter::appendValueSCMOInstanceElement(
@@ -727,6 +802,7 @@ void CIMResponseData::encodeXmlResponse(Buffer& out)
             }
             case RESP_OBJECTS:
             {
+                _reserveXmlSize(out, _scmoInstances);
                 for (Uint32 i = 0; i < _scmoInstances.size(); i++)
                 {
                     SCMOXmlWriter::appendValueObjectWithPathElement(
@@ -936,6 +1012,7 @@ void CIMResponseData::_resolveBinary()
         "CIMResponseData::_resolveBinary");
 
     CIMBuffer in((char*)_binaryData.getData(), _binaryData.size());
+    in.setCompact(_compactBinary);
 
     while (in.more())
     {
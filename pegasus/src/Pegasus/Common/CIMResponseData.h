@@ -68,7 +68,7 @@ public:
     };
 
     CIMResponseData(ResponseDataContent content):
-        _encoding(0),_dataType(content)
+        _encoding(0),_dataType(content),_compactBinary(false)
     {};
 
     CIMResponseData(const CIMResponseData & x):
@@ -79,6 +79,7 @@ public:
         _hostsData(x._hostsData),
         _nameSpacesData(x._nameSpacesData),
         _binaryData(x._binaryData),
+        _compactBinary(x._compactBinary),
         _defaultNamespace(x._defaultNamespace),
         _defaultHostname(x._defaultHostname),
         _instanceNames(x._instanceNames),
@@ -163,6 +164,15 @@ public:
     // single ResponseData object
     void appendResponseData(const CIMResponseData & x);
 
+    // Function used by the enumeration contexts of the pull operations to
+    // move up to count instances from the front of another CIMResponseData
+    // object to the end of this one.  Both objects are resolved to the C++
+    // representation.
+    void moveInstances(CIMResponseData& from, Uint32 count);
+
+    // Number of objects held, resolves the data to the C++ representation
+    Uint32 size();
+
     // Function used by CMPI layer to complete the namespace on all data held
     // Input (x) has to have a valid namespace
     void completeNamespace(const SCMOInstance * x);
@@ -176,12 +186,15 @@ public:
 
     // Encoding responses
 
-    // binary format used with Provider Agents and OP Clients
+    // binary format used with Provider Agents and OP Clients. A compact
+    // CIMBuffer (remote clients) receives the data as C++ objects.
     void encodeBinaryResponse(CIMBuffer& out);
     // Xml format used with Provider Agents only
     void encodeInternalXmlResponse(CIMBuffer& out);
     // official Xml format(CIM over Http) used to communicate to clients
-    void encodeXmlResponse(Buffer& out);
+    // The pull operations return instances as VALUE.INSTANCEWITHPATH
+    // elements instead of VALUE.NAMEDINSTANCE.
+    void encodeXmlResponse(Buffer& out, Boolean isPull = false);
 
 private:
 
@@ -227,6 +240,8 @@ private:
 
     // For binary encoding.
     Array<Uint8> _binaryData;
+    // Whether _binaryData uses the compact encoding of CIMBuffer
+    Boolean _compactBinary;
     CIMNamespaceName _defaultNamespace;
     String _defaultHostname;
 
@@ -53,7 +53,18 @@ static const char* _cimMessages[] =
     "CIM_ERR_QUERY_LANGUAGE_NOT_SUPPORTED",
     "CIM_ERR_INVALID_QUERY",
     "CIM_ERR_METHOD_NOT_AVAILABLE",
-    "CIM_ERR_METHOD_NOT_FOUND"
+    "CIM_ERR_METHOD_NOT_FOUND",
+    "CIM_ERR_UNEXPECTED_RESPONSE",
+    "CIM_ERR_INVALID_RESPONSE_DESTINATION",
+    "CIM_ERR_NAMESPACE_NOT_EMPTY",
+    "CIM_ERR_INVALID_ENUMERATION_CONTEXT",
+    "CIM_ERR_INVALID_OPERATION_TIMEOUT",
+    "CIM_ERR_PULL_HAS_BEEN_ABANDONED",
+    "CIM_ERR_PULL_CANNOT_BE_ABANDONED",
+    "CIM_ERR_FILTERED_ENUMERATION_NOT_SUPPORTED",
+    "CIM_ERR_CONTINUATION_ON_ERROR_NOT_SUPPORTED",
+    "CIM_ERR_SERVER_LIMITS_EXCEEDED",
+    "CIM_ERR_SERVER_IS_SHUTTING_DOWN"
 };
 
 // l10n TODO - the first func should go away when all Pegasus is globalized
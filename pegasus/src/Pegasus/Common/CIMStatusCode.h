@@ -134,7 +134,68 @@ enum CIMStatusCode
     /**
         The specified extrinsic method does not exist.
     */
-    CIM_ERR_METHOD_NOT_FOUND = 17
+    CIM_ERR_METHOD_NOT_FOUND = 17,
+
+    /**
+        The server did not receive a valid response from the WBEM listener
+        or the response was unexpected.
+    */
+    CIM_ERR_UNEXPECTED_RESPONSE = 18,
+
+    /**
+        The specified destination for the asynchronous response is not valid.
+    */
+    CIM_ERR_INVALID_RESPONSE_DESTINATION = 19,
+
+    /**
+        The specified namespace is not empty.
+    */
+    CIM_ERR_NAMESPACE_NOT_EMPTY = 20,
+
+    /**
+        The enumeration context supplied is not valid.
+    */
+    CIM_ERR_INVALID_ENUMERATION_CONTEXT = 21,
+
+    /**
+        The requested operation timeout is not supported by the server.
+    */
+    CIM_ERR_INVALID_OPERATION_TIMEOUT = 22,
+
+    /**
+        The pull operation has been abandoned due to the execution of a
+        concurrent CloseEnumeration operation on the same enumeration.
+    */
+    CIM_ERR_PULL_HAS_BEEN_ABANDONED = 23,
+
+    /**
+        The attempt to abandon a concurrent pull operation on the same
+        enumeration failed.
+    */
+    CIM_ERR_PULL_CANNOT_BE_ABANDONED = 24,
+
+    /**
+        Filtering of enumeration results is not supported for the requested
+        operation.
+    */
+    CIM_ERR_FILTERED_ENUMERATION_NOT_SUPPORTED = 25,
+
+    /**
+        Continuation of the enumeration after an error is not supported.
+    */
+    CIM_ERR_CONTINUATION_ON_ERROR_NOT_SUPPORTED = 26,
+
+    /**
+        The server has failed the operation based upon exceeding server
+        limits.
+    */
+    CIM_ERR_SERVER_LIMITS_EXCEEDED = 27,
+
+    /**
+        The server is in the process of shutting down and cannot process
+        the operation at this time.
+    */
+    CIM_ERR_SERVER_IS_SHUTTING_DOWN = 28
 };
 
 PEGASUS_COMMON_LINKAGE const char* cimStatusCodeToString(CIMStatusCode code);
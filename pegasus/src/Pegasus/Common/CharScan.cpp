@@ -0,0 +1,676 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include "CharScan.h"
+
+// The SIMD kernels are built with GCC (and compatible compilers) for x86
+// processors with SSE2, the AVX2 kernels need the target attribute and the
+// runtime processor check of GCC 4.9.
+#if defined(__GNUC__) && defined(__SSE2__) && \
+    (defined(__x86_64__) || defined(__i386__))
+# define PEGASUS_CHARSCAN_SSE2
+# include <emmintrin.h>
+# if defined(__clang__) || (GCC_VERSION >= 40900)
+#  define PEGASUS_CHARSCAN_AVX2
+#  include <immintrin.h>
+# endif
+#endif
+
+PEGASUS_NAMESPACE_BEGIN
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Scalar implementation
+//
+////////////////////////////////////////////////////////////////////////////////
+
+const char* CharScan::findXmlBreakScalar(const char* p, char c1, char c2)
+{
+    while (!_isBreak(*p, c1, c2))
+    {
+        p++;
+    }
+
+    return p;
+}
+
+const char* CharScan::findXmlDelimiterScalar(
+    const char* p,
+    char c1,
+    char c2,
+    Uint32& line)
+{
+    while (*p != c1 && *p != c2 && *p)
+    {
+        if (*p == '\n')
+        {
+            line++;
+        }
+
+        p++;
+    }
+
+    return p;
+}
+
+const char* CharScan::skipXmlWhiteSpaceScalar(const char* p, Uint32& line)
+{
+    while (CharSet::isXmlWhiteSpace(Uint8(*p)))
+    {
+        if (*p == '\n')
+        {
+            line++;
+        }
+
+        p++;
+    }
+
+    return p;
+}
+
+const char* CharScan::findXmlEscapeScalar(const char* p, const char* end)
+{
+    while (p != end && !_isEscape(Uint8(*p)))
+    {
+        p++;
+    }
+
+    return p;
+}
+
+const Uint16* CharScan::findXmlEscapeScalar(
+    const Uint16* p,
+    const Uint16* end)
+{
+    while (p != end && !_isEscape(*p) && !_isDoubleSpace(p, end))
+    {
+        p++;
+    }
+
+    return p;
+}
+
+#ifdef PEGASUS_CHARSCAN_SSE2
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// SSE2 kernels
+//
+// Each kernel computes a bit mask of the characters of an aligned block
+// which end the scan. The bits of the characters before the start of the
+// string in the first block are cleared.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+static inline Uint32 _breakMaskSSE2(
+    const char* block,
+    __m128i v1,
+    __m128i v2,
+    __m128i space)
+{
+    __m128i v = _mm_load_si128((const __m128i*)block);
+
+    // Unsigned v <= 0x20 is max(v, 0x20) == 0x20
+    __m128i m = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, v1), _mm_cmpeq_epi8(v, v2)),
+        _mm_cmpeq_epi8(_mm_max_epu8(v, space), space));
+
+    return Uint32(_mm_movemask_epi8(m));
+}
+
+static const char* _findXmlBreakSSE2(const char* p, char c1, char c2)
+{
+    const __m128i v1 = _mm_set1_epi8(c1);
+    const __m128i v2 = _mm_set1_epi8(c2);
+    const __m128i space = _mm_set1_epi8(0x20);
+
+    Uint32 offset = Uint32(size_t(p) & 15);
+    const char* block = p - offset;
+    Uint32 mask = _breakMaskSSE2(block, v1, v2, space) & (0xFFFFU << offset);
+
+    while (!mask)
+    {
+        block += 16;
+        mask = _breakMaskSSE2(block, v1, v2, space);
+    }
+
+    return block + __builtin_ctz(mask);
+}
+
+static inline Uint32 _delimiterMaskSSE2(
+    const char* block,
+    __m128i v1,
+    __m128i v2,
+    Uint32& newlines)
+{
+    __m128i v = _mm_load_si128((const __m128i*)block);
+    __m128i m = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(v, v1), _mm_cmpeq_epi8(v, v2)),
+        _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+
+    newlines = Uint32(_mm_movemask_epi8(
+        _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+    return Uint32(_mm_movemask_epi8(m));
+}
+
+static const char* _findXmlDelimiterSSE2(
+    const char* p,
+    char c1,
+    char c2,
+    Uint32& line)
+{
+    const __m128i v1 = _mm_set1_epi8(c1);
+    const __m128i v2 = _mm_set1_epi8(c2);
+
+    Uint32 offset = Uint32(size_t(p) & 15);
+    const char* block = p - offset;
+    Uint32 newlines;
+    Uint32 mask = _delimiterMaskSSE2(block, v1, v2, newlines);
+    mask &= 0xFFFFU << offset;
+    newlines &= 0xFFFFU << offset;
+
+    while (!mask)
+    {
+        line += __builtin_popcount(newlines);
+        block += 16;
+        mask = _delimiterMaskSSE2(block, v1, v2, newlines);
+    }
+
+    Uint32 end = __builtin_ctz(mask);
+    line += __builtin_popcount(newlines & ((1U << end) - 1));
+
+    return block + end;
+}
+
+static inline Uint32 _whiteSpaceMaskSSE2(
+    const char* block,
+    Uint32& newlines)
+{
+    __m128i v = _mm_load_si128((const __m128i*)block);
+    __m128i nl = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+    __m128i m = _mm_or_si128(
+        _mm_or_si128(nl, _mm_cmpeq_epi8(v, _mm_set1_epi8(' '))),
+        _mm_or_si128(
+            _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')),
+            _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'))));
+
+    newlines = Uint32(_mm_movemask_epi8(nl));
+    return Uint32(_mm_movemask_epi8(m));
+}
+
+static const char* _skipXmlWhiteSpaceSSE2(const char* p, Uint32& line)
+{
+    Uint32 offset = Uint32(size_t(p) & 15);
+    const char* block = p - offset;
+    Uint32 newlines;
+
+    // The characters before the start count as white space, which is not
+    // a newline
+    Uint32 before = ~(0xFFFFU << offset) & 0xFFFFU;
+    Uint32 mask = _whiteSpaceMaskSSE2(block, newlines) | before;
+    newlines &= ~before;
+
+    while (mask == 0xFFFF)
+    {
+        line += __builtin_popcount(newlines);
+        block += 16;
+        mask = _whiteSpaceMaskSSE2(block, newlines);
+    }
+
+    Uint32 end = __builtin_ctz(~mask);
+    line += __builtin_popcount(newlines & ((1U << end) - 1));
+
+    return block + end;
+}
+
+//
+// The escape kernels use unaligned loads of the whole blocks within the
+// string and scan the rest with the scalar implementation.
+//
+
+// Returns the characters of v below 0x20 and " & ' < >. The pairs '&' '\''
+// and '<' '>' differ in one bit only.
+static inline __m128i _escapeSSE2(__m128i v)
+{
+    return _mm_or_si128(
+        _mm_or_si128(
+            _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1F)), v),
+            _mm_cmpeq_epi8(v, _mm_set1_epi8('"'))),
+        _mm_or_si128(
+            _mm_cmpeq_epi8(
+                _mm_or_si128(v, _mm_set1_epi8(1)), _mm_set1_epi8('\'')),
+            _mm_cmpeq_epi8(
+                _mm_or_si128(v, _mm_set1_epi8(2)), _mm_set1_epi8('>'))));
+}
+
+static const char* _findXmlEscapeSSE2(const char* p, const char* end)
+{
+    const __m128i del = _mm_set1_epi8(0x7F);
+
+    for (; end - p >= 16; p += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        Uint32 mask = Uint32(_mm_movemask_epi8(
+            _mm_or_si128(_escapeSSE2(v), _mm_cmpeq_epi8(v, del))));
+
+        if (mask)
+        {
+            return p + __builtin_ctz(mask);
+        }
+    }
+
+    return CharScan::findXmlEscapeScalar(p, end);
+}
+
+static const Uint16* _findXmlEscape16SSE2(const Uint16* p, const Uint16* end)
+{
+    const __m128i del = _mm_set1_epi8(0x7F);
+    const __m128i space = _mm_set1_epi8(' ');
+
+    for (; end - p >= 16; p += 16)
+    {
+        // The signed saturation maps the characters from 0x100 to 0x7FFF to
+        // 0xFF and those from 0x8000 on to 0, both are escaped
+        __m128i v = _mm_packus_epi16(
+            _mm_loadu_si128((const __m128i*)p),
+            _mm_loadu_si128((const __m128i*)(p + 8)));
+        Uint32 mask = Uint32(_mm_movemask_epi8(_mm_or_si128(
+            _escapeSSE2(v), _mm_cmpeq_epi8(_mm_max_epu8(v, del), v))));
+
+        // A space followed by a space, the last one may be followed by the
+        // first character of the next block
+        Uint32 spaces = Uint32(_mm_movemask_epi8(_mm_cmpeq_epi8(v, space)));
+
+        if (p + 16 != end && p[16] == ' ')
+        {
+            spaces |= 0x10000;
+        }
+
+        mask |= spaces & (spaces >> 1);
+
+        if (mask)
+        {
+            return p + __builtin_ctz(mask);
+        }
+    }
+
+    return CharScan::findXmlEscapeScalar(p, end);
+}
+
+#endif /* PEGASUS_CHARSCAN_SSE2 */
+
+#ifdef PEGASUS_CHARSCAN_AVX2
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// AVX2 kernels, the same as the SSE2 kernels with 32 character blocks
+//
+////////////////////////////////////////////////////////////////////////////////
+
+__attribute__((target("avx2")))
+static inline Uint32 _breakMaskAVX2(
+    const char* block,
+    __m256i v1,
+    __m256i v2,
+    __m256i space)
+{
+    __m256i v = _mm256_load_si256((const __m256i*)block);
+    __m256i m = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, v1), _mm256_cmpeq_epi8(v, v2)),
+        _mm256_cmpeq_epi8(_mm256_max_epu8(v, space), space));
+
+    return Uint32(_mm256_movemask_epi8(m));
+}
+
+__attribute__((target("avx2")))
+static const char* _findXmlBreakAVX2(const char* p, char c1, char c2)
+{
+    const __m256i v1 = _mm256_set1_epi8(c1);
+    const __m256i v2 = _mm256_set1_epi8(c2);
+    const __m256i space = _mm256_set1_epi8(0x20);
+
+    Uint32 offset = Uint32(size_t(p) & 31);
+    const char* block = p - offset;
+    Uint32 mask =
+        _breakMaskAVX2(block, v1, v2, space) & (0xFFFFFFFFU << offset);
+
+    while (!mask)
+    {
+        block += 32;
+        mask = _breakMaskAVX2(block, v1, v2, space);
+    }
+
+    return block + __builtin_ctz(mask);
+}
+
+__attribute__((target("avx2")))
+static inline Uint32 _delimiterMaskAVX2(
+    const char* block,
+    __m256i v1,
+    __m256i v2,
+    Uint32& newlines)
+{
+    __m256i v = _mm256_load_si256((const __m256i*)block);
+    __m256i m = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, v1), _mm256_cmpeq_epi8(v, v2)),
+        _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+
+    newlines = Uint32(_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'))));
+    return Uint32(_mm256_movemask_epi8(m));
+}
+
+__attribute__((target("avx2")))
+static const char* _findXmlDelimiterAVX2(
+    const char* p,
+    char c1,
+    char c2,
+    Uint32& line)
+{
+    const __m256i v1 = _mm256_set1_epi8(c1);
+    const __m256i v2 = _mm256_set1_epi8(c2);
+
+    Uint32 offset = Uint32(size_t(p) & 31);
+    const char* block = p - offset;
+    Uint32 newlines;
+    Uint32 mask = _delimiterMaskAVX2(block, v1, v2, newlines);
+    mask &= 0xFFFFFFFFU << offset;
+    newlines &= 0xFFFFFFFFU << offset;
+
+    while (!mask)
+    {
+        line += __builtin_popcount(newlines);
+        block += 32;
+        mask = _delimiterMaskAVX2(block, v1, v2, newlines);
+    }
+
+    // end is below 32, the delimiter is in the block
+    Uint32 end = __builtin_ctz(mask);
+    line += __builtin_popcount(newlines & ((1U << end) - 1));
+
+    return block + end;
+}
+
+__attribute__((target("avx2")))
+static inline Uint32 _whiteSpaceMaskAVX2(
+    const char* block,
+    Uint32& newlines)
+{
+    __m256i v = _mm256_load_si256((const __m256i*)block);
+    __m256i nl = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+    __m256i m = _mm256_or_si256(
+        _mm256_or_si256(nl, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '))),
+        _mm256_or_si256(
+            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t')),
+            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+
+    newlines = Uint32(_mm256_movemask_epi8(nl));
+    return Uint32(_mm256_movemask_epi8(m));
+}
+
+__attribute__((target("avx2")))
+static const char* _skipXmlWhiteSpaceAVX2(const char* p, Uint32& line)
+{
+    Uint32 offset = Uint32(size_t(p) & 31);
+    const char* block = p - offset;
+    Uint32 newlines;
+
+    // Shifting a 32 bit value by 32 is undefined, offset is below 32
+    Uint32 before = offset ? ~(0xFFFFFFFFU << offset) : 0;
+    Uint32 mask = _whiteSpaceMaskAVX2(block, newlines) | before;
+    newlines &= ~before;
+
+    while (mask == 0xFFFFFFFFU)
+    {
+        line += __builtin_popcount(newlines);
+        block += 32;
+        mask = _whiteSpaceMaskAVX2(block, newlines);
+    }
+
+    Uint32 end = __builtin_ctz(~mask);
+    line += __builtin_popcount(newlines & ((1U << end) - 1));
+
+    return block + end;
+}
+
+__attribute__((target("avx2")))
+static inline __m256i _escapeAVX2(__m256i v)
+{
+    return _mm256_or_si256(
+        _mm256_or_si256(
+            _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1F)), v),
+            _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"'))),
+        _mm256_or_si256(
+            _mm256_cmpeq_epi8(
+                _mm256_or_si256(v, _mm256_set1_epi8(1)),
+                _mm256_set1_epi8('\'')),
+            _mm256_cmpeq_epi8(
+                _mm256_or_si256(v, _mm256_set1_epi8(2)),
+                _mm256_set1_epi8('>'))));
+}
+
+__attribute__((target("avx2")))
+static const char* _findXmlEscapeAVX2(const char* p, const char* end)
+{
+    const __m256i del = _mm256_set1_epi8(0x7F);
+
+    for (; end - p >= 32; p += 32)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        Uint32 mask = Uint32(_mm256_movemask_epi8(
+            _mm256_or_si256(_escapeAVX2(v), _mm256_cmpeq_epi8(v, del))));
+
+        if (mask)
+        {
+            return p + __builtin_ctz(mask);
+        }
+    }
+
+    return CharScan::findXmlEscapeScalar(p, end);
+}
+
+__attribute__((target("avx2")))
+static const Uint16* _findXmlEscape16AVX2(const Uint16* p, const Uint16* end)
+{
+    const __m256i del = _mm256_set1_epi8(0x7F);
+    const __m256i space = _mm256_set1_epi8(' ');
+
+    for (; end - p >= 32; p += 32)
+    {
+        // The pack works on 128 bit lanes, the permutation restores the
+        // order of the characters
+        __m256i v = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(
+                _mm256_loadu_si256((const __m256i*)p),
+                _mm256_loadu_si256((const __m256i*)(p + 16))),
+            0xD8);
+        Uint32 mask = Uint32(_mm256_movemask_epi8(_mm256_or_si256(
+            _escapeAVX2(v), _mm256_cmpeq_epi8(_mm256_max_epu8(v, del), v))));
+
+        // The space at the end of the block is tested separately, the
+        // 64 bit value keeps the bit of the following character
+        Uint64 spaces =
+            Uint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, space)));
+
+        if (p + 32 != end && p[32] == ' ')
+        {
+            spaces |= PEGASUS_UINT64_LITERAL(0x100000000);
+        }
+
+        mask |= Uint32(spaces & (spaces >> 1));
+
+        if (mask)
+        {
+            return p + __builtin_ctz(mask);
+        }
+    }
+
+    return CharScan::findXmlEscapeScalar(p, end);
+}
+
+#endif /* PEGASUS_CHARSCAN_AVX2 */
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Runtime selection of the kernels
+//
+// The function pointers initially refer to selection functions, which
+// replace them with the best kernel for the processor on the first call.
+// Concurrent first calls select the same kernel.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef PEGASUS_CHARSCAN_AVX2
+static Boolean _haveAVX2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+}
+#endif
+
+const char* (*CharScan::_findXmlBreak)(const char* p, char c1, char c2) =
+    CharScan::_selectFindXmlBreak;
+
+const char* (*CharScan::_findXmlDelimiter)(
+    const char* p, char c1, char c2, Uint32& line) =
+    CharScan::_selectFindXmlDelimiter;
+
+const char* (*CharScan::_skipXmlWhiteSpace)(const char* p, Uint32& line) =
+    CharScan::_selectSkipXmlWhiteSpace;
+
+const char* (*CharScan::_findXmlEscape)(const char* p, const char* end) =
+    CharScan::_selectFindXmlEscape;
+
+const Uint16* (*CharScan::_findXmlEscape16)(
+    const Uint16* p, const Uint16* end) =
+    CharScan::_selectFindXmlEscape16;
+
+const char* CharScan::_selectFindXmlBreak(const char* p, char c1, char c2)
+{
+    const char* (*kernel)(const char*, char, char) = findXmlBreakScalar;
+
+#ifdef PEGASUS_CHARSCAN_SSE2
+    kernel = _findXmlBreakSSE2;
+#endif
+#ifdef PEGASUS_CHARSCAN_AVX2
+    if (_haveAVX2())
+    {
+        kernel = _findXmlBreakAVX2;
+    }
+#endif
+
+    _findXmlBreak = kernel;
+    return kernel(p, c1, c2);
+}
+
+const char* CharScan::_selectFindXmlDelimiter(
+    const char* p,
+    char c1,
+    char c2,
+    Uint32& line)
+{
+    const char* (*kernel)(const char*, char, char, Uint32&) =
+        findXmlDelimiterScalar;
+
+#ifdef PEGASUS_CHARSCAN_SSE2
+    kernel = _findXmlDelimiterSSE2;
+#endif
+#ifdef PEGASUS_CHARSCAN_AVX2
+    if (_haveAVX2())
+    {
+        kernel = _findXmlDelimiterAVX2;
+    }
+#endif
+
+    _findXmlDelimiter = kernel;
+    return kernel(p, c1, c2, line);
+}
+
+const char* CharScan::_selectSkipXmlWhiteSpace(
+    const char* p,
+    Uint32& line)
+{
+    const char* (*kernel)(const char*, Uint32&) = skipXmlWhiteSpaceScalar;
+
+#ifdef PEGASUS_CHARSCAN_SSE2
+    kernel = _skipXmlWhiteSpaceSSE2;
+#endif
+#ifdef PEGASUS_CHARSCAN_AVX2
+    if (_haveAVX2())
+    {
+        kernel = _skipXmlWhiteSpaceAVX2;
+    }
+#endif
+
+    _skipXmlWhiteSpace = kernel;
+    return kernel(p, line);
+}
+
+const char* CharScan::_selectFindXmlEscape(const char* p, const char* end)
+{
+    const char* (*kernel)(const char*, const char*) = findXmlEscapeScalar;
+
+#ifdef PEGASUS_CHARSCAN_SSE2
+    kernel = _findXmlEscapeSSE2;
+#endif
+#ifdef PEGASUS_CHARSCAN_AVX2
+    if (_haveAVX2())
+    {
+        kernel = _findXmlEscapeAVX2;
+    }
+#endif
+
+    _findXmlEscape = kernel;
+    return kernel(p, end);
+}
+
+const Uint16* CharScan::_selectFindXmlEscape16(
+    const Uint16* p,
+    const Uint16* end)
+{
+    const Uint16* (*kernel)(const Uint16*, const Uint16*) =
+        findXmlEscapeScalar;
+
+#ifdef PEGASUS_CHARSCAN_SSE2
+    kernel = _findXmlEscape16SSE2;
+#endif
+#ifdef PEGASUS_CHARSCAN_AVX2
+    if (_haveAVX2())
+    {
+        kernel = _findXmlEscape16AVX2;
+    }
+#endif
+
+    _findXmlEscape16 = kernel;
+    return kernel(p, end);
+}
+
+PEGASUS_NAMESPACE_END
@@ -0,0 +1,238 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#ifndef Pegasus_CharScan_h
+#define Pegasus_CharScan_h
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/Linkage.h>
+#include <Pegasus/Common/CharSet.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+/*  This class provides the scanning functions used by the XmlParser and
+    the XmlGenerator to skip runs of characters which need no processing.
+    On x86 processors they test 16 (SSE2) or 32 (AVX2) characters at a time,
+    the AVX2 kernels are selected at runtime when the processor supports
+    them. Other platforms and compilers use the scalar implementation.
+
+    The strings passed to the XmlParser functions must be null-terminated.
+    Their SIMD kernels use aligned loads, which may read beyond the null
+    terminator, but never beyond the aligned block containing it and thus
+    never into an unmapped page. The findXmlEscape() functions take the end
+    of the string instead and never read beyond it.
+*/
+class PEGASUS_COMMON_LINKAGE CharScan
+{
+public:
+
+    /**
+        Returns a pointer to the first character of the string which is
+        c1, c2 or a character up to 0x20, which includes the XML white
+        space characters, other control characters and the null terminator.
+     */
+    static const char* findXmlBreak(const char* p, char c1, char c2)
+    {
+        // Most values and runs of white space in CIM-XML are short, they
+        // are scanned here without calling the kernel
+        for (const char* end = p + _SCALAR_LENGTH; p != end; p++)
+        {
+            if (_isBreak(*p, c1, c2))
+            {
+                return p;
+            }
+        }
+
+        return _findXmlBreak(p, c1, c2);
+    }
+
+    /**
+        Returns a pointer to the first character of the string which is not
+        XML white space, and adds the number of newlines skipped to line.
+     */
+    static const char* skipXmlWhiteSpace(const char* p, Uint32& line)
+    {
+        for (const char* end = p + _SCALAR_LENGTH; p != end; p++)
+        {
+            if (!CharSet::isXmlWhiteSpace(Uint8(*p)))
+            {
+                return p;
+            }
+
+            if (*p == '\n')
+            {
+                line++;
+            }
+        }
+
+        return _skipXmlWhiteSpace(p, line);
+    }
+
+    /**
+        Returns a pointer to the first character of the string which is
+        c1, c2 or the null terminator, and adds the number of newlines
+        passed to line.
+     */
+    static const char* findXmlDelimiter(
+        const char* p,
+        char c1,
+        char c2,
+        Uint32& line)
+    {
+        for (const char* end = p + _SCALAR_LENGTH; p != end; p++)
+        {
+            if (*p == c1 || *p == c2 || !*p)
+            {
+                return p;
+            }
+
+            if (*p == '\n')
+            {
+                line++;
+            }
+        }
+
+        return _findXmlDelimiter(p, c1, c2, line);
+    }
+
+    /**
+        Returns a pointer to the first character of the UTF-8 string from p
+        to end which must be escaped in XML output: a character below 0x20,
+        0x7F or one of " & ' < >, or end if there is none. The bytes of
+        multibyte characters are not escaped.
+     */
+    static const char* findXmlEscape(const char* p, const char* end)
+    {
+        const char* scalarEnd =
+            (end - p > _SCALAR_LENGTH) ? p + _SCALAR_LENGTH : end;
+
+        for (; p != scalarEnd; p++)
+        {
+            if (_isEscape(Uint8(*p)))
+            {
+                return p;
+            }
+        }
+
+        return (p == end) ? p : _findXmlEscape(p, end);
+    }
+
+    /**
+        Returns a pointer to the first character of the UTF-16 string from p
+        to end which XmlGenerator::appendSpecial() does not copy as it is: a
+        character below 0x20, from 0x7F on or one of " & ' < >, or a space
+        followed by another space. Returns end if there is none.
+     */
+    static const Uint16* findXmlEscape(const Uint16* p, const Uint16* end)
+    {
+        const Uint16* scalarEnd =
+            (end - p > _SCALAR_LENGTH) ? p + _SCALAR_LENGTH : end;
+
+        for (; p != scalarEnd; p++)
+        {
+            if (_isEscape(*p) || _isDoubleSpace(p, end))
+            {
+                return p;
+            }
+        }
+
+        return (p == end) ? p : _findXmlEscape16(p, end);
+    }
+
+    static const char* findXmlBreakScalar(const char* p, char c1, char c2);
+
+    static const char* findXmlDelimiterScalar(
+        const char* p,
+        char c1,
+        char c2,
+        Uint32& line);
+
+    static const char* skipXmlWhiteSpaceScalar(const char* p, Uint32& line);
+
+    static const char* findXmlEscapeScalar(const char* p, const char* end);
+
+    static const Uint16* findXmlEscapeScalar(
+        const Uint16* p,
+        const Uint16* end);
+
+private:
+
+    // Number of characters scanned before calling the kernels
+    enum { _SCALAR_LENGTH = 16 };
+
+    static Boolean _isBreak(char c, char c1, char c2)
+    {
+        return (Uint8(c) <= 0x20) || (c == c1) || (c == c2);
+    }
+
+    // The characters below 0x40 which are escaped are those below 0x20 and
+    // " & ' < >, the bits of this mask. From 0x7F on, the UTF-8 bytes are
+    // copied unchanged, the UTF-16 characters are escaped.
+    static Boolean _isEscape(Uint8 c)
+    {
+        return (c < 0x40) ?
+            ((PEGASUS_UINT64_LITERAL(0x500000C4FFFFFFFF) >> c) & 1) != 0 :
+            c == 0x7F;
+    }
+
+    static Boolean _isEscape(Uint16 c)
+    {
+        return (c < 0x40) ?
+            ((PEGASUS_UINT64_LITERAL(0x500000C4FFFFFFFF) >> c) & 1) != 0 :
+            c >= 0x7F;
+    }
+
+    static Boolean _isDoubleSpace(const Uint16* p, const Uint16* end)
+    {
+        return (*p == ' ') && (p + 1 != end) && (p[1] == ' ');
+    }
+
+    // The kernels selected for the processor
+    static const char* (*_findXmlBreak)(const char* p, char c1, char c2);
+    static const char* (*_findXmlDelimiter)(
+        const char* p, char c1, char c2, Uint32& line);
+    static const char* (*_skipXmlWhiteSpace)(const char* p, Uint32& line);
+    static const char* (*_findXmlEscape)(const char* p, const char* end);
+    static const Uint16* (*_findXmlEscape16)(
+        const Uint16* p, const Uint16* end);
+
+    static const char* _selectFindXmlBreak(const char* p, char c1, char c2);
+    static const char* _selectFindXmlDelimiter(
+        const char* p, char c1, char c2, Uint32& line);
+    static const char* _selectSkipXmlWhiteSpace(const char* p, Uint32& line);
+    static const char* _selectFindXmlEscape(const char* p, const char* end);
+    static const Uint16* _selectFindXmlEscape16(
+        const Uint16* p, const Uint16* end);
+};
+
+PEGASUS_NAMESPACE_END
+
+#endif /* Pegasus_CharScan_h */
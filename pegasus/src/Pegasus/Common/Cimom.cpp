@@ -117,20 +117,27 @@ Boolean cimom::route_async(AsyncOpNode *op)
     if (_routed_queue_shutdown.get() > 0)
         return false;
 
-    return _routed_ops.enqueue(op);
+    // All the operations for one destination go through the same routing
+    // thread, which keeps them in order.
+    Uint32 index =
+        op->_op_dest->getQueueId() % PEGASUS_CIMOM_ROUTING_THREADS;
+
+    return _routed_ops[index].enqueue(op);
 }
 
 ThreadReturnType PEGASUS_THREAD_CDECL cimom::_routing_proc(void *parm)
 {
     Thread* myself = reinterpret_cast<Thread *>(parm);
-    cimom* dispatcher = reinterpret_cast<cimom *>(myself->get_parm());
+    AsyncQueue<AsyncOpNode>* routedOps =
+        reinterpret_cast<AsyncQueue<AsyncOpNode> *>(myself->get_parm());
+    cimom* dispatcher = _global_this;
     AsyncOpNode *op = 0;
 
     try
     {
         while (dispatcher->_die.get() == 0)
         {
-            op = dispatcher->_routed_ops.dequeue_wait();
+            op = routedOps->dequeue_wait();
 
             if (op == 0)
             {
@@ -205,22 +212,26 @@ ThreadReturnType PEGASUS_THREAD_CDECL cimom::_routing_proc(void *parm)
 
 cimom::cimom()
     : MessageQueue(PEGASUS_QUEUENAME_METADISPATCHER),
-      _routed_ops(),
-      _routing_thread(_routing_proc, this, false),
       _die(0),
       _routed_queue_shutdown(0)
 {
     _global_this = this;
 
-    ThreadStatus tr = PEGASUS_THREAD_OK;
-    while ((tr = _routing_thread.run()) != PEGASUS_THREAD_OK)
+    for (Uint32 i = 0; i < PEGASUS_CIMOM_ROUTING_THREADS; i++)
     {
-        if (tr == PEGASUS_THREAD_INSUFFICIENT_RESOURCES)
-            Threads::yield();
-        else
-            throw Exception(
-                MessageLoaderParms("Common.Cimom.NOT_ENOUGH_THREADS",
-                    "Cannot allocate thread for Cimom class"));
+        _routing_threads[i] =
+            new Thread(_routing_proc, &_routed_ops[i], false);
+
+        ThreadStatus tr = PEGASUS_THREAD_OK;
+        while ((tr = _routing_threads[i]->run()) != PEGASUS_THREAD_OK)
+        {
+            if (tr == PEGASUS_THREAD_INSUFFICIENT_RESOURCES)
+                Threads::yield();
+            else
+                throw Exception(
+                    MessageLoaderParms("Common.Cimom.NOT_ENOUGH_THREADS",
+                        "Cannot allocate thread for Cimom class"));
+        }
     }
 }
 
@@ -238,10 +249,14 @@ cimom::~cimom()
     msg->op->_op_dest = _global_this;
     msg->op->_request.reset(msg);
 
-    Boolean done = _routed_ops.enqueue(msg->op);
+    Boolean done = route_async(msg->op);
     PEGASUS_ASSERT(done);
 
-    _routing_thread.join();
+    for (Uint32 i = 0; i < PEGASUS_CIMOM_ROUTING_THREADS; i++)
+    {
+        _routing_threads[i]->join();
+        delete _routing_threads[i];
+    }
 
     PEGASUS_ASSERT(_routed_queue_shutdown.get());
     PEGASUS_ASSERT(_die.get());
@@ -364,30 +379,34 @@ void cimom::_handle_cimom_op(AsyncOpNode *op)
     PEGASUS_ASSERT( msg->getType() ==  ASYNC_IOCLOSE);
     _global_this->_routed_queue_shutdown = 1;
     _make_response(msg, async_results::OK);
-    // All services are shutdown, empty out the queue
-    for(;;)
+    // All services are shutdown, empty out the queues
+    for (Uint32 i = 0; i < PEGASUS_CIMOM_ROUTING_THREADS; i++)
     {
-        AsyncOpNode* operation = 0;
-        try
+        for(;;)
         {
-            operation = _global_this->_routed_ops.dequeue();
-            if (operation)
+            AsyncOpNode* operation = 0;
+            try
             {
-                _global_this->cache_op(operation);
+                operation = _global_this->_routed_ops[i].dequeue();
+                if (operation)
+                {
+                    _global_this->cache_op(operation);
+                }
+                else
+                {
+                    break;
+                }
             }
-            else
+            catch (...)
             {
-                break;
+                 break;
             }
         }
-        catch (...)
-        {
-             break;
-        }
+        // shutdown the AsyncQueue, which also wakes up and exits the
+        // routing thread serving it.
+        _global_this->_routed_ops[i].close();
     }
-    // shutdown the AsyncQueue
-    _global_this->_routed_ops.close();
-    // exit the routing thread.
+    // exit the routing threads.
     _die++;
 }
 
@@ -33,6 +33,7 @@
 #define Pegasus_Cimom_h
 
 #include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/Constants.h>
 #include <Pegasus/Common/InternalException.h>
 #include <Pegasus/Common/MessageQueue.h>
 #include <Pegasus/Common/AsyncQueue.h>
@@ -77,11 +78,14 @@ protected:
       static void _complete_op_node(AsyncOpNode* op);
 
 private:
-    AsyncQueue<AsyncOpNode> _routed_ops;
+    // Operations are spread over the routing threads by destination queue
+    // so that the operations sent to one service are still delivered to it
+    // in the order in which they were routed.
+    AsyncQueue<AsyncOpNode> _routed_ops[PEGASUS_CIMOM_ROUTING_THREADS];
 
     static ThreadReturnType PEGASUS_THREAD_CDECL _routing_proc(void*);
 
-    Thread _routing_thread;
+    Thread* _routing_threads[PEGASUS_CIMOM_ROUTING_THREADS];
 
     void _handle_cimom_op(AsyncOpNode* op);
 
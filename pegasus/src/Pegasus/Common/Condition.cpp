@@ -30,6 +30,7 @@
 //%/////////////////////////////////////////////////////////////////////////////
 
 #include "Condition.h"
+#include "Time.h"
 #include "PegasusAssert.h"
 #include "Exception.h"
 #include "System.h"
@@ -64,6 +65,20 @@ void Condition::wait(Mutex& lock)
     pthread_cond_wait(&_rep.cond, &lock._rep.mutex);
 }
 
+Boolean Condition::time_wait(Mutex& lock, Uint32 milliseconds)
+{
+    struct timeval now;
+    struct timespec waittime;
+    gettimeofday(&now, NULL);
+
+    Uint32 usec = now.tv_usec + (milliseconds % 1000) * 1000;
+    waittime.tv_sec = now.tv_sec + milliseconds / 1000 + usec / 1000000;
+    waittime.tv_nsec = (usec % 1000000) * 1000;
+
+    int r = pthread_cond_timedwait(&_rep.cond, &lock._rep.mutex, &waittime);
+    return !((r == -1 && errno == ETIMEDOUT) || (r == ETIMEDOUT));
+}
+
 #endif /* PEGASUS_HAVE_PTHREADS */
 
 //==============================================================================
@@ -156,6 +171,32 @@ void Condition::wait(Mutex& mutex)
     ResetEvent(waiter->event);
 }
 
+Boolean Condition::time_wait(Mutex& mutex, Uint32 milliseconds)
+{
+    ConditionWaiter* waiter = _get_waiter();
+    _rep.waiters.insert_back(waiter);
+
+    size_t count = mutex._rep.count;
+
+    for (size_t i = 0; i < count; i++)
+        mutex.unlock();
+
+    DWORD rc = WaitForSingleObject(waiter->event, milliseconds);
+    PEGASUS_DEBUG_ASSERT(rc == WAIT_OBJECT_0 || rc == WAIT_TIMEOUT);
+
+    for (size_t i = 0; i < count; i++)
+        mutex.lock();
+
+    // A signal may have removed the waiter after the wait timed out.
+
+    if (_rep.waiters.contains(waiter))
+        _rep.waiters.remove(waiter);
+
+    ResetEvent(waiter->event);
+
+    return rc == WAIT_OBJECT_0;
+}
+
 #endif /* PEGASUS_HAVE_WINDOWS_THREADS */
 
 PEGASUS_NAMESPACE_END
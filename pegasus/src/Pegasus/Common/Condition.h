@@ -95,6 +95,13 @@ public:
 
     void wait(Mutex& mutex);
 
+    /**
+        Waits like wait() for at most the given time.
+        @return true if the condition was signaled, false if the time
+            elapsed first.
+    */
+    Boolean time_wait(Mutex& mutex, Uint32 milliseconds);
+
 private:
     Condition(const Condition&);
     Condition& operator=(const Condition&);
@@ -174,6 +174,147 @@
 #define PEGASUS_SSL_ACCEPT_TIMEOUT_SECONDS 20
 #define PEGASUS_PROVIDER_IDLE_TIMEOUT_SECONDS 300
 
+/*
+ * Upper bound for the connectionMonitors config property
+ */
+
+#define PEGASUS_MAX_CONNECTION_MONITORS 64
+
+/*
+ * Upper bound for the cimxmlIndicationDeliveryThreads config property
+ */
+
+#define PEGASUS_MAX_CIMXML_INDICATION_DELIVERY_THREADS 16
+
+/*
+ * Default and upper bound for the number of SCMOClass definitions cached
+ * by the SCMOClassCache (scmoClassCacheSize config property)
+ */
+
+#define PEGASUS_DEFAULT_SCMO_CLASS_CACHE_SIZE 256
+#define PEGASUS_DEFAULT_SCMO_CLASS_CACHE_SIZE_STRING "256"
+#define PEGASUS_MAX_SCMO_CLASS_CACHE_SIZE 65536
+
+/*
+ * Default and upper bound for the number of class definitions cached by
+ * the CIMRepository (repositoryClassCacheSize config property)
+ */
+
+#define PEGASUS_DEFAULT_REPOSITORY_CLASS_CACHE_SIZE 1024
+#define PEGASUS_DEFAULT_REPOSITORY_CLASS_CACHE_SIZE_STRING "1024"
+#define PEGASUS_MAX_REPOSITORY_CLASS_CACHE_SIZE 65536
+
+/*
+ * Number of the variants of a class (local only, without qualifiers or
+ * without class origin) which the CIMRepository caches besides the complete
+ * class
+ */
+
+#define PEGASUS_MAX_REPOSITORY_CLASS_VARIANTS 2
+
+/*
+ * Number of repository instances the CIMOperationRequestDispatcher decodes
+ * and forwards in one response when it enumerates a class
+ */
+
+#define PEGASUS_REPOSITORY_ENUMERATION_BATCH_SIZE 1000
+
+/*
+ * Default and upper bound for the number of verified credentials cached
+ * by the PAM Basic authenticator (basicAuthenticationCacheSize config
+ * property)
+ */
+
+#define PEGASUS_DEFAULT_BASIC_AUTHENTICATION_CACHE_SIZE_STRING "256"
+#define PEGASUS_MAX_BASIC_AUTHENTICATION_CACHE_SIZE 65536
+
+/*
+ * Limits of the pull operations: the operation timeout used when the client
+ * does not specify one, the largest operation timeout accepted (seconds)
+ * and the largest MaxObjectCount accepted
+ */
+
+#define PEGASUS_DEFAULT_PULL_OPERATION_TIMEOUT_SECONDS 30
+#define PEGASUS_MAX_PULL_OPERATION_TIMEOUT_SECONDS 90
+#define PEGASUS_MAX_PULL_OBJECT_COUNT 10000
+
+/*
+ * Limits of the number of instances cached by the open enumeration contexts
+ * of the pull operations (including the WS-Management enumerations), in
+ * total and per user.  No new enumeration is opened while a limit is reached,
+ * and an open enumeration whose instances would exceed a limit fails with
+ * CIM_ERR_SERVER_LIMITS_EXCEEDED.
+ */
+
+#define PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES 200000
+#define PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES_PER_USER 50000
+
+/*
+ * Smallest number of cached instances at which the enumeration of a pull
+ * operation waits for the client to pull, whatever the MaxObjectCount of
+ * the client (which may be zero); one repository batch
+ */
+
+#define PEGASUS_MIN_ENUMERATION_CACHE_LIMIT 1000
+
+/*
+ * Largest size (bytes) to which a compressed HTTP message body is
+ * decompressed; a body that inflates beyond it is rejected as invalid
+ */
+
+#ifndef PEGASUS_MAX_DECOMPRESSED_MESSAGE_SIZE
+# define PEGASUS_MAX_DECOMPRESSED_MESSAGE_SIZE 0x10000000
+#endif
+
+/*
+ * Upper bound of the number of TLS sessions the CIM Server caches for
+ * resumption (sslSessionCacheSize config property), default and upper
+ * bound of the lifetime (seconds) of a cached session or session ticket
+ * (sslSessionTimeout config property), and the number of sessions an
+ * SSLContext keeps for resuming client connections, one per server.
+ */
+
+#define PEGASUS_MAX_SSL_SESSION_CACHE_SIZE 1048576
+#define PEGASUS_DEFAULT_SSL_SESSION_TIMEOUT_SECONDS_STRING "300"
+#define PEGASUS_MAX_SSL_SESSION_TIMEOUT_SECONDS 86400
+#define PEGASUS_MAX_SSL_CLIENT_SESSIONS 64
+
+/*
+ * Number of threads the cimom meta-dispatcher uses to route asynchronous
+ * operations to the services
+ */
+
+#ifndef PEGASUS_CIMOM_ROUTING_THREADS
+# define PEGASUS_CIMOM_ROUTING_THREADS 4
+#endif
+
+/*
+ * Largest block size served from the free lists of the PooledAllocator,
+ * the number of blocks a per-thread free list holds at most and the number
+ * of blocks of one size class the shared depot holds at most
+ */
+
+#define PEGASUS_ALLOCATION_POOL_MAX_SIZE 512
+#define PEGASUS_ALLOCATION_POOL_LIST_SIZE 32
+#define PEGASUS_ALLOCATION_POOL_DEPOT_SIZE 512
+
+/*
+ * Default and upper bound for the number of work requests the service
+ * thread pool queues when no thread is available (serviceThreadPoolQueueSize
+ * config property), the default of the serviceThreadPoolMaxThreads config
+ * property, the upper bound of the serviceThreadPoolMinThreads and
+ * serviceThreadPoolMaxThreads config properties, and the longest time
+ * (milliseconds) the server connection monitors hold back new requests
+ * while a thread pool is saturated
+ */
+
+#define PEGASUS_DEFAULT_SERVICE_THREAD_POOL_QUEUE_SIZE 1024
+#define PEGASUS_DEFAULT_SERVICE_THREAD_POOL_QUEUE_SIZE_STRING "1024"
+#define PEGASUS_MAX_SERVICE_THREAD_POOL_QUEUE_SIZE 65536
+#define PEGASUS_DEFAULT_SERVICE_THREAD_POOL_MAX_THREADS_STRING "256"
+#define PEGASUS_MAX_SERVICE_THREAD_POOL_THREADS 32767
+#define PEGASUS_THREAD_POOL_ADMISSION_WAIT_MSEC 1000
+
 
 
 /*
@@ -38,6 +38,7 @@
 #include "TLS.h"
 #include "HTTPAcceptor.h"
 #include "HTTPConnection.h"
+#include "MonitorPool.h"
 #include "HostAddress.h"
 #include "Tracer.h"
 #include <Pegasus/Common/MessageLoader.h>
@@ -137,6 +138,7 @@ HTTPAcceptor::HTTPAcceptor(Monitor* monitor,
                            ReadWriteSem* sslContextObjectLock)
    : Base(PEGASUS_QUEUENAME_HTTPACCEPTOR),  // ATTN: Need unique names?
      _monitor(monitor),
+     _connectionMonitors(0),
      _outputMessageQueue(outputMessageQueue),
      _rep(0),
      _entry_index(-1),
@@ -239,7 +241,7 @@ void HTTPAcceptor::handleEnqueue(Message *message)
 
                if (socket == closeConnectionMessage->socket)
                {
-                   _monitor->unsolicitSocketMessages(socket);
+                   connection->_monitor->unsolicitSocketMessages(socket);
                    _rep->connections.remove(i);
                    delete connection;
                    break;
@@ -643,6 +645,11 @@ void HTTPAcceptor::setSocketWriteTimeout(Uint32 socketWriteTimeout)
     _socketWriteTimeout = socketWriteTimeout;
 }
 
+void HTTPAcceptor::setConnectionMonitors(MonitorPool* connectionMonitors)
+{
+    _connectionMonitors = connectionMonitors;
+}
+
 void HTTPAcceptor::unbind()
 {
     if (_rep)
@@ -684,7 +691,7 @@ void HTTPAcceptor::destroyConnections()
 
             // Unsolicit SocketMessages:
 
-            _monitor->unsolicitSocketMessages(socket);
+            connection->_monitor->unsolicitSocketMessages(socket);
 
             // Destroy the connection (causing it to close):
 
@@ -881,10 +888,15 @@ void HTTPAcceptor::_acceptConnection()
         return;
     }
 
+    // Select the monitor which services the new connection:
+
+    Monitor* connectionMonitor =
+        _connectionMonitors ? _connectionMonitors->selectMonitor() : _monitor;
+
     // Create a new connection and add it to the connection list:
 
     AutoPtr<HTTPConnection> connection(new HTTPConnection(
-        _monitor,
+        connectionMonitor,
         mp_socket,
         ipAddress,
         this,
@@ -903,10 +915,15 @@ void HTTPAcceptor::_acceptConnection()
         Time::gettimeofday(&connection->_acceptPendingStartTime);
     }
 
+    // Lock the connection list before soliciting events, since a connection
+    // serviced by a MonitorPool thread may be closed (and removed from the
+    // list) as soon as it is registered.
+    AutoMutex autoMut(_rep->_connection_mut);
+
     // Solicit events on this new connection's socket:
     int index;
 
-    if (-1 ==  (index = _monitor->solicitSocketMessages(
+    if (-1 ==  (index = connectionMonitor->solicitSocketMessages(
             connection->getSocket(),
             SocketMessage::READ | SocketMessage::EXCEPTION,
             connection->getQueueId(), MonitorEntry::TYPE_CONNECTION)) )
@@ -918,7 +935,6 @@ void HTTPAcceptor::_acceptConnection()
     }
 
     connection->_entry_index = index;
-    AutoMutex autoMut(_rep->_connection_mut);
     _rep->connections.append(connection.get());
     connection.release();
 }
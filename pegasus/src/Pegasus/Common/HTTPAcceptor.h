@@ -45,6 +45,7 @@ PEGASUS_NAMESPACE_BEGIN
 
 class HTTPAcceptorRep;
 class Monitor;
+class MonitorPool;
 /** Instances of this class listen on a port and accept conections.
 */
 class PEGASUS_COMMON_LINKAGE HTTPAcceptor : public MessageQueue
@@ -128,6 +129,15 @@ public:
 
     static void setSocketWriteTimeout(Uint32 socketWriteTimeout);
 
+    /** Sets the pool of Monitors that service the connections accepted by
+        this acceptor.  If no pool is set (the default), connections are
+        serviced by the Monitor passed to the constructor.  Must be called
+        before bind().
+        @param connectionMonitors the pool to use; it must remain valid
+        until the connections of this acceptor have been destroyed.
+    */
+    void setConnectionMonitors(MonitorPool* connectionMonitors);
+
 private:
 
     void _acceptConnection();
@@ -136,6 +146,7 @@ private:
     cimom *_meta_dispatcher;
 
     Monitor* _monitor;
+    MonitorPool* _connectionMonitors;
     MessageQueue* _outputMessageQueue;
     HTTPAcceptorRep* _rep;
 
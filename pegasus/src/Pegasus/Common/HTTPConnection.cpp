@@ -52,6 +52,10 @@
 #endif
 #include <Pegasus/Common/XmlWriter.h>
 
+#ifdef PEGASUS_HAS_EPOLL
+# include <poll.h>
+#endif
+
 PEGASUS_USING_STD;
 
 PEGASUS_NAMESPACE_BEGIN
@@ -89,6 +93,10 @@ static const char headerNameCode[] = "CIMStatusCode";
 static const char headerNameDescription[] = "CIMStatusCodeDescription";
 static const char headerNameOperation[] = "CIMOperation";
 static const char headerNameContentLanguage[] = "Content-Language";
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+static const char headerNameAcceptEncoding[] = "Accept-Encoding";
+static const char headerNameContentEncoding[] = "Content-Encoding";
+#endif
 
 // the names comes from the HTTP specification on chunked transfer encoding
 
@@ -121,6 +129,57 @@ static const Uint32 chunkExtensionTerminatorLength =
 // the number of bytes it takes to place a Uint32 into a string (minus null)
 static const Uint32 numberAsStringLength = 10;
 
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+// non-chunked responses with a smaller body are not worth compressing
+static const Uint32 httpCompressionMinimumSize = 1024;
+
+/*
+ * Replace the body of a complete (non-chunked) response with its compressed
+ * form. A Content-Encoding line is added to the header and the padded
+ * content-length number written by XmlWriter is overlayed with the size of
+ * the compressed body.
+ */
+static void _compressContent(
+    Buffer& message,
+    Uint32 contentLength,
+    HTTPContentCoding::Coding coding)
+{
+    Uint32 headerLength = message.size() - contentLength;
+    const char* data = message.getData();
+
+    Buffer compressed(headerLength + contentLength / 4);
+
+    // copy the header without the empty line that terminates it
+    compressed.append(data, headerLength - headerLineTerminatorLength);
+    compressed << headerNameContentEncoding << headerNameTerminator <<
+        HTTPContentCoding::getName(coding) << headerLineTerminator <<
+        headerLineTerminator;
+    Uint32 compressedHeaderLength = compressed.size();
+
+    HTTPContentCoding(coding).compress(
+        data + headerLength, contentLength, true, compressed);
+
+    char* compressedStart = (char*) compressed.getData();
+    char save = compressedStart[compressedHeaderLength];
+    compressedStart[compressedHeaderLength] = 0;
+    char* contentLengthStart =
+        strstr(compressedStart, headerNameContentLength);
+    compressedStart[compressedHeaderLength] = save;
+
+    if (contentLengthStart)
+    {
+        char* contentLengthNumberStart = contentLengthStart +
+            headerNameContentLengthLength + headerNameTerminatorLength;
+        save = contentLengthNumberStart[numberAsStringLength];
+        sprintf(contentLengthNumberStart, "%.10u",
+            compressed.size() - compressedHeaderLength);
+        contentLengthNumberStart[numberAsStringLength] = save;
+    }
+
+    message.swap(compressed);
+}
+#endif
+
 /*
  * given an HTTP status code, return the description. not all codes are listed
  * here. Unmapped codes result in the internal error string.
@@ -175,9 +234,13 @@ static void _throwEventFailure(
     }                                                                         \
     while (0)
 
-static inline Uint32 _Min(Uint32 x, Uint32 y)
+static inline void _appendSegment(
+    Array<SocketWriteSegment>& segments,
+    const char* data,
+    Uint32 size)
 {
-    return x < y ? x : y;
+    SocketWriteSegment segment = { data, size };
+    segments.append(segment);
 }
 
 // Used to test signal handling
@@ -196,6 +259,12 @@ void * sigabrt_generator(void * parm)
 
 Uint32 HTTPConnection::_idleConnectionTimeoutSeconds = 0;
 
+// Totals of the responses sent by the server connections
+static Mutex _responseStatisticsMutex;
+static Uint64 _responsesSent = 0;
+static Uint64 _responseBytesSent = 0;
+static Uint64 _responseBytesCopiedTotal = 0;
+
 #ifndef PEGASUS_INTEGERS_BOUNDARY_ALIGNED
 Mutex HTTPConnection::_idleConnectionTimeoutSecondsMutex;
 #endif
@@ -217,6 +286,17 @@ Uint32 HTTPConnection::getIdleConnectionTimeout()
     return _idleConnectionTimeoutSeconds;
 }
 
+void HTTPConnection::getResponseStatistics(
+    Uint64& responses,
+    Uint64& bytesSent,
+    Uint64& bytesCopied)
+{
+    AutoMutex lock(_responseStatisticsMutex);
+    responses = _responsesSent;
+    bytesSent = _responseBytesSent;
+    bytesCopied = _responseBytesCopiedTotal;
+}
+
 /*
     Note: This method is called in client code for reconnecting with the Server
     and can also be used in the server code to check the connection status  and
@@ -288,6 +368,12 @@ HTTPConnection::HTTPConnection(
     _responsePending = false;
     _connectionRequestCount = 0;
     _transferEncodingChunkOffset = 0;
+    _outgoingSegmentsSize = 0;
+    _responseBytesCopied = 0;
+    _responseBytesWritten = 0;
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+    _acceptContentCoding = HTTPContentCoding::IDENTITY;
+#endif
 
     PEG_TRACE((TRC_HTTP, Tracer::LEVEL3,
         "Connection IP address = %s",(const char*)_ipAddress.getCString()));
@@ -480,10 +566,17 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
             if (isFirst == true)
             {
                 _incomingBuffer.clear();
+                _outgoingSegments.clear();
+                _outgoingSegmentsSize = 0;
+                _responseBytesCopied = 0;
+                _responseBytesWritten = 0;
                 // tracks the message coming from above
                 _transferEncodingChunkOffset = 0;
                 _mpostPrefix.clear();
                 cimException = CIMException();
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+                _chunkContentCoding.reset();
+#endif
             }
             else
             {
@@ -562,18 +655,19 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
 
                 if (isFirst == false)
                 {
-                    // subsequent chunks from the server, just append
-
-                    messageLength += _incomingBuffer.size();
-                    _incomingBuffer.reserveCapacity(messageLength+1);
-                    _incomingBuffer.append(buffer.getData(), buffer.size());
-                    buffer.clear();
-                    // null terminate
-                    messageStart = (char *) _incomingBuffer.getData();
-                    messageStart[messageLength] = 0;
-                    // put back in buffer, so the httpMessage parser can work
-                    // below
+                    // subsequent chunks from the server are kept as they
+                    // are and sent after the first one, without copying
+                    // them into one buffer
+                    _outgoingSegmentsSize += buffer.size();
+                    _outgoingSegments.append(Buffer());
+                    _outgoingSegments[_outgoingSegments.size() - 1].swap(
+                        buffer);
+
+                    // put the first chunk back in buffer, so the httpMessage
+                    // parser can work below
                     _incomingBuffer.swap(buffer);
+                    messageStart = (char *) buffer.getData();
+                    messageLength = buffer.size();
                 }
 
                 if (isLast == false)
@@ -589,12 +683,36 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
                         buffer.clear();
                         // discard all data collected to this point
                         _incomingBuffer.clear();
+                        _outgoingSegments.clear();
+                        _outgoingSegmentsSize = 0;
                         String messageS = cimException.getMessage();
                         CString messageC = messageS.getCString();
                         messageStart = (char *) (const char *) messageC;
                         messageLength = (Uint32)strlen(messageStart);
                         buffer.reserveCapacity(messageLength+1);
                         buffer.append(messageStart, messageLength);
+                        _responseBytesCopied += messageLength;
+                        // null terminate
+                        messageStart = (char *) buffer.getData();
+                        messageStart[messageLength] = 0;
+                    }
+                    else if (_outgoingSegments.size() &&
+                        _isContiguousResponseRequired())
+                    {
+                        // the content is modified as a whole below, so the
+                        // chunks are appended to the first one
+                        buffer.reserveCapacity(
+                            messageLength + _outgoingSegmentsSize + 1);
+                        for (Uint32 i = 0; i < _outgoingSegments.size(); i++)
+                        {
+                            buffer.append(
+                                _outgoingSegments[i].getData(),
+                                _outgoingSegments[i].size());
+                        }
+                        _responseBytesCopied += _outgoingSegmentsSize;
+                        _outgoingSegments.clear();
+                        _outgoingSegmentsSize = 0;
+                        messageLength = buffer.size();
                         // null terminate
                         messageStart = (char *) buffer.getData();
                         messageStart[messageLength] = 0;
@@ -632,6 +750,9 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
                 Boolean isValid = httpMessage.parseStatusLine(
                     startLine, httpVersion, httpStatusCode, reasonPhrase);
                 Uint32 headerLength = messageLength - contentLength;
+
+                // the content continues in the chunks kept aside
+                contentLength += _outgoingSegmentsSize;
                 char save = messageStart[headerLength];
                 messageStart[headerLength] = 0;
 
@@ -785,12 +906,29 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
                             buffer.insert(
                                 insertOffset, messageStart, messageLength);
                             messageLength = buffer.size();
+                            _responseBytesCopied += messageLength;
                             // null terminate
                             messageStart = (char *) buffer.getData();
                             messageStart[messageLength] = 0;
                             bytesRemaining = messageLength;
                         } // if there were any content languages
 
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+                        // compress the body if the client accepts a content
+                        // coding and the body is large enough to benefit
+                        if (_acceptContentCoding !=
+                                HTTPContentCoding::IDENTITY &&
+                            contentLengthStart &&
+                            contentLength >= httpCompressionMinimumSize)
+                        {
+                            _compressContent(
+                                buffer, contentLength, _acceptContentCoding);
+                            messageLength = buffer.size();
+                            messageStart = (char *) buffer.getData();
+                            bytesRemaining = messageLength;
+                        }
+#endif
+
 #ifdef PEGASUS_KERBEROS_AUTHENTICATION
                         // The following is processing to wrap (encrypt) the
                         // response from the server when using kerberos
@@ -859,8 +997,11 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
 
         SignalHandler::ignore(PEGASUS_SIGPIPE);
 
-        const char *sendStart = messageStart;
-        Sint32 bytesWritten = 0;
+        // The header, the chunk framing and the data are collected as
+        // segments and sent with one gathered write, without copying the data
+        // into one buffer
+        Array<SocketWriteSegment> segments;
+        Buffer trailer;
 
         if (isFirst == true && isChunkResponse == true && bytesToWrite > 0)
         {
@@ -868,116 +1009,94 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
 
             // dont include header terminator yet
             Uint32 headerLength = bytesToWrite;
-            bytesToWrite -= headerLineTerminatorLength;
-            PEG_TRACE_CSTRING(TRC_HTTP, Tracer::LEVEL4,
-                "HTTPConnection::_handleWriteEvent: "
-                    "Sending header for chunked reponses.");
-
-            bytesWritten = _socket->write(sendStart, bytesToWrite);
-            if (bytesWritten < 0)
-                _socketWriteError();
-            totalBytesWritten += bytesWritten;
-            bytesRemaining -= bytesWritten;
+            _appendSegment(
+                segments,
+                messageStart,
+                headerLength - headerLineTerminatorLength);
 
             // put in trailer header.
-            Buffer trailer;
             trailer << headerNameTrailer << headerNameTerminator <<
                 _mpostPrefix << headerNameCode <<    headerValueSeparator <<
                 _mpostPrefix << headerNameDescription << headerValueSeparator <<
                 headerNameContentLanguage << headerLineTerminator;
-            sendStart = trailer.getData();
-            bytesToWrite = trailer.size();
-
-            PEG_TRACE_CSTRING(TRC_HTTP, Tracer::LEVEL4,
-                "HTTPConnection::_handleWriteEvent: "
-                    "Sending trailer header for chunked responses.");
-
-            bytesWritten = _socket->write(sendStart, bytesToWrite);
 
-            if (bytesWritten < 0)
-                _socketWriteError();
-            totalBytesWritten += bytesWritten;
-            // the trailer is outside the header buffer, so dont include in
-            // tracking variables
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+            // the chunk data is compressed as one stream; announce its coding
+            if (_acceptContentCoding != HTTPContentCoding::IDENTITY)
+            {
+                _chunkContentCoding.reset(
+                    new HTTPContentCoding(_acceptContentCoding));
+                trailer << headerNameContentEncoding << headerNameTerminator <<
+                    HTTPContentCoding::getName(_acceptContentCoding) <<
+                    headerLineTerminator;
+            }
+#endif
+            _appendSegment(segments, trailer.getData(), trailer.size());
 
             // now send header terminator
-            bytesToWrite = headerLineTerminatorLength;
-            sendStart = messageStart + headerLength - bytesToWrite;
-
-            PEG_TRACE_CSTRING(TRC_HTTP, Tracer::LEVEL4,
-                "HTTPConnection::_handleWriteEvent: "
-                    "Sending header terminator for chunked responses.");
-
-            bytesWritten = _socket->write(sendStart, bytesToWrite);
-            if (bytesWritten < 0)
-                _socketWriteError();
-            totalBytesWritten += bytesWritten;
-            bytesRemaining -= bytesWritten;
+            _appendSegment(
+                segments,
+                messageStart + headerLength - headerLineTerminatorLength,
+                headerLineTerminatorLength);
 
             messageStart += headerLength;
             messageLength -= headerLength;
-            sendStart = messageStart;
-            bytesWritten = 0;
-            bytesToWrite = bytesRemaining;
+            bytesRemaining -= headerLength;
         } // if first chunk of chunked response
 
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+        // compress the data of this chunk. Each chunk is flushed so the client
+        // can decode it on arrival; the last chunk terminates the stream.
+        Buffer compressedChunk;
+
+        if (isChunkResponse == true && _chunkContentCoding.get() &&
+            (bytesRemaining > 0 || isLast == true))
+        {
+            _chunkContentCoding->compress(
+                messageStart + messageLength - bytesRemaining,
+                bytesRemaining, isLast, compressedChunk);
+            messageStart = (char *) compressedChunk.getData();
+            messageLength = compressedChunk.size();
+            bytesRemaining = messageLength;
+        }
+#endif
+
         // room enough for hex string representing chunk length and terminator
         char chunkLine[sizeof(Uint32)*2 + chunkLineTerminatorLength+1];
+        Buffer chunkTrailer;
 
-        for (; bytesRemaining > 0; )
+        if (bytesRemaining > 0)
         {
             if (isChunkResponse == true)
             {
                 // send chunk line containing hex string and chunk line
                 // terminator
-                sprintf(chunkLine, "%x%s", bytesToWrite, chunkLineTerminator);
-                sendStart = chunkLine;
-                Sint32 chunkBytesToWrite = (Sint32)strlen(sendStart);
-
-                PEG_TRACE_CSTRING(TRC_HTTP, Tracer::LEVEL4,
-                    "HTTPConnection::_handleWriteEvent: "
-                        "Sending chunk with chunk line terminator.");
-
-                bytesWritten = _socket->write(sendStart, chunkBytesToWrite);
-                if (bytesWritten < 0)
-                    _socketWriteError();
-                totalBytesWritten += bytesWritten;
+                sprintf(chunkLine, "%x%s", bytesRemaining, chunkLineTerminator);
+                _appendSegment(
+                    segments, chunkLine, (Uint32)strlen(chunkLine));
             }
 
-            // for chunking, we will send the entire chunk data in one send, but
-            // for non-chunking, we will send incrementally
-            else bytesToWrite = _Min(bytesRemaining, bytesToWrite);
+            _appendSegment(
+                segments,
+                messageStart + messageLength - bytesRemaining,
+                bytesRemaining);
 
-            // send non-chunked data
-            //
-            // Socket writes larger than 64K cause some platforms to return
-            //  errors. When the socket write can't send the full buffer at
-            //  one time, subtract the bytes sent and loop until the whole
-            //  buffer has gone.  Use httpTcpBufferSize for maximum send size.
-            //
-            for (; bytesRemaining > 0; )
+            // the chunks of a non-chunked response which were kept aside
+            for (Uint32 i = 0; i < _outgoingSegments.size(); i++)
             {
-              sendStart = messageStart + messageLength - bytesRemaining;
-              bytesToWrite = _Min(httpTcpBufferSize, bytesRemaining);
-
-              PEG_TRACE_CSTRING(TRC_HTTP, Tracer::LEVEL4,
-                  "HTTPConnection::_handleWriteEvent: "
-                      "Sending non-chunked data.");
-
-              bytesWritten = _socket->write(sendStart, bytesToWrite);
-              if (bytesWritten < 0)
-                  _socketWriteError();
-              totalBytesWritten += bytesWritten;
-              bytesRemaining -= bytesWritten;
+                _appendSegment(
+                    segments,
+                    _outgoingSegments[i].getData(),
+                    _outgoingSegments[i].size());
             }
+            messageLength += _outgoingSegmentsSize;
 
             if (isChunkResponse == true)
             {
                 // send chunk terminator, on the last chunk, it is the chunk
                 // body terminator
-                Buffer trailer;
                 Boolean traceTrailer = false;
-                trailer << chunkLineTerminator;
+                chunkTrailer << chunkLineTerminator;
 
                 // on the last chunk, attach the last chunk termination
                 // sequence: 0 + last chunk terminator + optional trailer +
@@ -985,10 +1104,7 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
 
                 if (isLast == true)
                 {
-                    if (bytesRemaining > 0)
-                        _throwEventFailure(httpStatusInternal,
-                            "more bytes after indicated last chunk");
-                    trailer << "0" << chunkLineTerminator;
+                    chunkTrailer << "0" << chunkLineTerminator;
                     Uint32 httpStatus = cimException.getCode();
 
                     if (httpStatus != 0)
@@ -997,13 +1113,14 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
                         sprintf(httpStatusP, "%u",httpStatus);
 
                         traceTrailer = true;
-                        trailer << _mpostPrefix << headerNameCode <<
+                        chunkTrailer << _mpostPrefix << headerNameCode <<
                             headerNameTerminator << httpStatusP <<
                             headerLineTerminator;
                         const String& httpDescription =
                             cimException.getMessage();
                         if (httpDescription.size() != 0)
-                            trailer << _mpostPrefix << headerNameDescription <<
+                            chunkTrailer << _mpostPrefix <<
+                                headerNameDescription <<
                                 headerNameTerminator << httpDescription <<
                                 headerLineTerminator;
                     }
@@ -1012,7 +1129,7 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
                     if (contentLanguages.size() != 0)
                     {
                         traceTrailer = true;
-                        trailer << _mpostPrefix
+                        chunkTrailer << _mpostPrefix
                             << headerNameContentLanguage << headerNameTerminator
                             << LanguageParser::buildContentLanguageHeader(
                                    contentLanguages)
@@ -1020,7 +1137,7 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
                     }
 
                     // now add chunkBodyTerminator
-                    trailer << chunkBodyTerminator;
+                    chunkTrailer << chunkBodyTerminator;
                 } // if isLast
 
                 if (traceTrailer)
@@ -1028,22 +1145,30 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
                     PEG_TRACE((TRC_XML_IO, Tracer::LEVEL4,
                         "<!-- Trailer: queue id: %u -->\n%s",
                         getQueueId(),
-                        trailer.getData()));
+                        chunkTrailer.getData()));
                 }
-                sendStart = trailer.getData();
-                Sint32 chunkBytesToWrite = (Sint32) trailer.size();
-
-                PEG_TRACE_CSTRING(TRC_HTTP, Tracer::LEVEL4,
-                    "HTTPConnection::_handleWriteEvent: "
-                        "Sending the last chunk with chunk body terminator");
-
-                bytesWritten = _socket->write(sendStart, chunkBytesToWrite);
-                if (bytesWritten < 0)
-                    _socketWriteError();
-                totalBytesWritten += bytesWritten;
+                _appendSegment(
+                    segments, chunkTrailer.getData(), chunkTrailer.size());
             } // isChunkResponse == true
+        }
 
-        } // for all bytes in message
+        if (segments.size())
+        {
+            PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
+                "HTTPConnection::_handleWriteEvent: "
+                    "Sending %u segments%s.",
+                segments.size(),
+                isChunkResponse ? " of chunked response" : ""));
+
+            // Socket writes larger than 64K cause some platforms to return
+            // errors, so no write sends more than httpTcpBufferSize bytes
+            Sint32 bytesWritten = _socket->writev(
+                segments.getData(), segments.size(), httpTcpBufferSize);
+            if (bytesWritten < 0)
+                _socketWriteError();
+            totalBytesWritten += bytesWritten;
+            _responseBytesWritten += bytesWritten;
+        }
 
     } // try
 
@@ -1080,7 +1205,13 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
     if (isLast == true)
     {
         _incomingBuffer.clear();
+        _outgoingSegments.clear();
+        _outgoingSegmentsSize = 0;
         _transferEncodingTEValues.clear();
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+        _acceptContentCoding = HTTPContentCoding::IDENTITY;
+        _chunkContentCoding.reset();
+#endif
 
         // Reset the transfer encoding chunk offset. If it is not reset here,
         // then a request sent with chunked encoding may not be properly read
@@ -1096,14 +1227,26 @@ Boolean HTTPConnection::_handleWriteEvent(HTTPMessage& httpMessage)
         if (httpStatusString.size() == 0)
         {
             PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
-                "A response has been sent (%d of %u bytes have been written). "
+                "A response has been sent (%d of %u bytes have been written, "
+                    "%u bytes were copied). "
                     "A total of %u requests have been processed on this "
                     "connection.",
                 totalBytesWritten,
                 messageLength,
+                _responseBytesCopied,
                 _connectionRequestCount));
         }
 
+        if (_isClient() == false)
+        {
+            AutoMutex lock(_responseStatisticsMutex);
+            _responsesSent++;
+            _responseBytesSent += _responseBytesWritten;
+            _responseBytesCopiedTotal += _responseBytesCopied;
+        }
+        _responseBytesCopied = 0;
+        _responseBytesWritten = 0;
+
         //
         // Since we are done writing, update the status of entry to IDLE
         // and notify the Monitor.
@@ -1427,6 +1570,14 @@ void HTTPConnection::_getContentLengthAndContentOffset()
                         contentLanguages.clear();
                     }
                 }
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+                else if (!_isClient() &&
+                    System::strcasecmp(line, headerNameAcceptEncoding) == 0)
+                {
+                    _acceptContentCoding =
+                        HTTPContentCoding::parseAcceptEncoding(valueStart);
+                }
+#endif
                 else if (System::strcasecmp(line, headerNameTransferTE) == 0)
                 {
                     if (gotTransferTE)
@@ -1572,6 +1723,30 @@ void HTTPConnection::setSocketWriteTimeout(Uint32 socketWriteTimeout)
 }
 
 
+/*
+ * determine if the chunks of a non-chunked response must be joined before the
+ * response is sent, because its content is modified as a whole (content
+ * language header, compression or kerberos wrapping)
+ */
+
+Boolean HTTPConnection::_isContiguousResponseRequired()
+{
+    if (contentLanguages.size() != 0)
+        return true;
+
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+    if (_acceptContentCoding != HTTPContentCoding::IDENTITY)
+        return true;
+#endif
+
+#ifdef PEGASUS_KERBEROS_AUTHENTICATION
+    if (_authInfo->getSecurityAssociation())
+        return true;
+#endif
+
+    return false;
+}
+
 // determine if the current code being executed is on the client side
 
 Boolean HTTPConnection::_isClient()
@@ -2304,11 +2479,21 @@ Boolean HTTPConnection::run(Uint32 milliseconds)
 {
     Boolean handled_events = false;
     int events = 0;
+#ifdef PEGASUS_HAS_EPOLL
+    // The Monitor does not limit socket numbers to FD_SETSIZE when it uses
+    // epoll, so poll() must be used to check the socket here.
+    struct pollfd pfd;
+    pfd.fd = getSocket();
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    events = poll(&pfd, 1, 0);
+#else
     fd_set fdread;
     struct timeval tv = { 0, 1 };
     FD_ZERO(&fdread);
     FD_SET(getSocket(), &fdread);
     events = select(FD_SETSIZE, &fdread, NULL, NULL, &tv);
+#endif
 
     if (events == PEGASUS_SOCKET_ERROR)
         return false;
@@ -2316,7 +2501,11 @@ Boolean HTTPConnection::run(Uint32 milliseconds)
     if (events)
     {
         events = 0;
+#ifdef PEGASUS_HAS_EPOLL
+        if (pfd.revents)
+#else
         if (FD_ISSET(getSocket(), &fdread))
+#endif
         {
             events |= SocketMessage::READ;
             Message *msg = new SocketMessage(getSocket(), events);
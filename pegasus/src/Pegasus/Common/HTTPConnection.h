@@ -47,6 +47,10 @@
 #include <Pegasus/Common/ContentLanguageList.h>
 #include <Pegasus/Common/Buffer.h>
 #include <Pegasus/Common/PegasusAssert.h>
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+# include <Pegasus/Common/AutoPtr.h>
+# include <Pegasus/Common/HTTPContentCoding.h>
+#endif
 
 PEGASUS_NAMESPACE_BEGIN
 
@@ -102,6 +106,16 @@ public:
     static void setIdleConnectionTimeout(Uint32 idleConnectionTimeout);
     static Uint32 getIdleConnectionTimeout();
 
+    /**
+        Returns the totals of the responses sent by the server connections:
+        the number of responses, the bytes written to the sockets and the
+        bytes the connections copied while assembling the responses.
+    */
+    static void getResponseStatistics(
+        Uint64& responses,
+        Uint64& bytesSent,
+        Uint64& bytesCopied);
+
     Boolean closeConnectionOnTimeout(struct timeval* timeNow);
 
     // This method is called in Client code to decide reconnection with 
@@ -155,6 +169,7 @@ private:
     void _handleReadEventFailure(const String& httpStatusWithDetail,
                                  const String& cimError = String());
     void _handleReadEventTransferEncoding();
+    Boolean _isContiguousResponseRequired();
     Boolean _isClient();
 
     Monitor* _monitor;
@@ -224,9 +239,26 @@ private:
     // list of TE values from client
     Array<String> _transferEncodingTEValues;
 
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+    // content coding selected from the Accept-Encoding header of the request
+    HTTPContentCoding::Coding _acceptContentCoding;
+
+    // compression stream of the chunked response currently being sent
+    AutoPtr<HTTPContentCoding> _chunkContentCoding;
+#endif
+
     // 2 digit prefix on http header if mpost was used
     String _mpostPrefix;
 
+    // chunks of a non-chunked response that follow the first one, which is
+    // kept in _incomingBuffer. They are sent after it in one gathered write.
+    Array<Buffer> _outgoingSegments;
+    Uint32 _outgoingSegmentsSize;
+
+    // bytes copied while assembling and written for the current response
+    Uint32 _responseBytesCopied;
+    Uint64 _responseBytesWritten;
+
     // Holds time since this connection is idle.
     struct timeval _idleStartTime;
 
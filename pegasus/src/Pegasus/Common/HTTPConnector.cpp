@@ -368,11 +368,12 @@ HTTPConnection* HTTPConnector::connect(
     // mp_socket now has responsibility for closing the socket handle
     socketPtr.release();
 
-    if (mp_socket->connect(timeoutMilliseconds) < 0)
+    char scratch[22];
+    Uint32 n;
+    const char * portStr = Uint32ToString(scratch, portNumber, n);
+
+    if (mp_socket->connect(timeoutMilliseconds, host + ":" + portStr) < 0)
     {
-        char scratch[22];
-        Uint32 n;
-        const char * portStr = Uint32ToString(scratch, portNumber, n);
         MessageLoaderParms parms(
             "Common.HTTPConnector.CONNECTION_FAILED_TO",
             "Cannot connect to $0:$1. Connection failed.",
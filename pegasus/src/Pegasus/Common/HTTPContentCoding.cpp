@@ -0,0 +1,325 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <zlib.h>
+#include <Pegasus/Common/HTTPContentCoding.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/System.h>
+#include <Pegasus/Common/Tracer.h>
+
+PEGASUS_USING_STD;
+
+PEGASUS_NAMESPACE_BEGIN
+
+// zlib window size; adding 16 selects the gzip wrapper and adding 32 makes
+// inflate detect either the gzip or the zlib wrapper.
+static const int _WINDOW_BITS = 15;
+
+// The level trades compression ratio for CPU. XML compresses well even at
+// the fastest level and the server compresses every large response.
+static const int _COMPRESSION_LEVEL = Z_BEST_SPEED;
+
+static const Uint32 _OUTPUT_CHUNK_SIZE = 16384;
+
+static inline Boolean _isSpace(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+static Boolean _equalToken(const char* token, Uint32 length, const char* name)
+{
+    return strlen(name) == length &&
+        System::strncasecmp(token, length, name, length);
+}
+
+HTTPContentCoding::Coding HTTPContentCoding::parseAcceptEncoding(
+    const char* acceptEncoding)
+{
+    // -1 means not listed, 0 means refused (q=0), 1 means acceptable.
+    int gzip = -1;
+    int deflate = -1;
+    int any = -1;
+
+    const char* p = acceptEncoding;
+
+    while (*p)
+    {
+        while (_isSpace(*p) || *p == ',')
+            p++;
+
+        const char* token = p;
+
+        while (*p && *p != ',' && *p != ';' && !_isSpace(*p))
+            p++;
+
+        Uint32 tokenLength = (Uint32)(p - token);
+        int acceptable = 1;
+
+        // Look for a quality value among the parameters of the coding.
+        while (*p && *p != ',')
+        {
+            if (*p == ';')
+            {
+                p++;
+                while (_isSpace(*p))
+                    p++;
+
+                if ((*p == 'q' || *p == 'Q') && p[1] == '=')
+                {
+                    acceptable = atof(p + 2) > 0 ? 1 : 0;
+                }
+            }
+            else
+            {
+                p++;
+            }
+        }
+
+        if (tokenLength == 0)
+            continue;
+
+        if (_equalToken(token, tokenLength, "gzip") ||
+            _equalToken(token, tokenLength, "x-gzip"))
+        {
+            gzip = acceptable;
+        }
+        else if (_equalToken(token, tokenLength, "deflate"))
+        {
+            deflate = acceptable;
+        }
+        else if (_equalToken(token, tokenLength, "*"))
+        {
+            any = acceptable;
+        }
+    }
+
+    if (gzip == 1 || (gzip == -1 && any == 1))
+        return GZIP;
+
+    if (deflate == 1 || (deflate == -1 && any == 1))
+        return DEFLATE;
+
+    return IDENTITY;
+}
+
+Boolean HTTPContentCoding::parseContentEncoding(
+    const char* contentEncoding,
+    Coding& coding)
+{
+    while (_isSpace(*contentEncoding))
+        contentEncoding++;
+
+    Uint32 length = (Uint32)strlen(contentEncoding);
+
+    while (length && _isSpace(contentEncoding[length - 1]))
+        length--;
+
+    if (_equalToken(contentEncoding, length, "gzip") ||
+        _equalToken(contentEncoding, length, "x-gzip"))
+    {
+        coding = GZIP;
+    }
+    else if (_equalToken(contentEncoding, length, "deflate"))
+    {
+        coding = DEFLATE;
+    }
+    else if (_equalToken(contentEncoding, length, "identity"))
+    {
+        coding = IDENTITY;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+const char* HTTPContentCoding::getName(Coding coding)
+{
+    switch (coding)
+    {
+        case GZIP:
+            return "gzip";
+        case DEFLATE:
+            return "deflate";
+        default:
+            return "identity";
+    }
+}
+
+Boolean HTTPContentCoding::decompress(
+    Coding coding,
+    const char* data,
+    Uint32 size,
+    Buffer& out,
+    Uint32 maxSize)
+{
+    if (coding == IDENTITY)
+    {
+        if (size > maxSize)
+            return false;
+
+        out.append(data, size);
+        return true;
+    }
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+
+    if (inflateInit2(&stream, _WINDOW_BITS + 32) != Z_OK)
+    {
+        throw PEGASUS_STD(bad_alloc)();
+    }
+
+    stream.next_in = (Bytef*)data;
+    stream.avail_in = size;
+
+    // XML typically compresses by a factor of ten or more.  The hint is only
+    // a guess, so it is capped rather than trusted.
+    Uint32 hint = size < maxSize / 8 ? size * 8 : maxSize;
+
+    if (hint <= 0xFFFFFFFF - out.size())
+        out.reserveCapacity(out.size() + hint);
+
+    char chunk[_OUTPUT_CHUNK_SIZE];
+    Uint32 remaining = maxSize;
+    int rc;
+
+    do
+    {
+        stream.next_out = (Bytef*)chunk;
+        stream.avail_out = sizeof(chunk);
+
+        rc = inflate(&stream, Z_NO_FLUSH);
+
+        if (rc == Z_MEM_ERROR)
+        {
+            inflateEnd(&stream);
+            throw PEGASUS_STD(bad_alloc)();
+        }
+
+        Uint32 produced = (Uint32)(sizeof(chunk) - stream.avail_out);
+
+        if (produced > remaining)
+        {
+            inflateEnd(&stream);
+            PEG_TRACE((TRC_HTTP, Tracer::LEVEL1,
+                "HTTPContentCoding::decompress: %s data of %u bytes "
+                    "decompresses to more than %u bytes",
+                getName(coding),
+                size,
+                maxSize));
+            return false;
+        }
+
+        remaining -= produced;
+        out.append(chunk, produced);
+    }
+    while (rc == Z_OK);
+
+    inflateEnd(&stream);
+
+    if (rc != Z_STREAM_END)
+    {
+        PEG_TRACE((TRC_HTTP, Tracer::LEVEL1,
+            "HTTPContentCoding::decompress: invalid %s data, zlib error %d",
+            getName(coding),
+            rc));
+        return false;
+    }
+
+    return true;
+}
+
+HTTPContentCoding::HTTPContentCoding(Coding coding)
+    : _coding(coding), _stream(0)
+{
+    PEGASUS_ASSERT(coding != IDENTITY);
+
+    z_stream* stream = new z_stream;
+    memset(stream, 0, sizeof(z_stream));
+
+    int windowBits = _WINDOW_BITS;
+
+    if (coding == GZIP)
+        windowBits += 16;
+
+    if (deflateInit2(stream, _COMPRESSION_LEVEL, Z_DEFLATED, windowBits,
+            8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        delete stream;
+        throw PEGASUS_STD(bad_alloc)();
+    }
+
+    _stream = stream;
+}
+
+HTTPContentCoding::~HTTPContentCoding()
+{
+    z_stream* stream = (z_stream*)_stream;
+    deflateEnd(stream);
+    delete stream;
+}
+
+void HTTPContentCoding::compress(
+    const char* data,
+    Uint32 size,
+    Boolean finish,
+    Buffer& out)
+{
+    z_stream* stream = (z_stream*)_stream;
+
+    stream->next_in = (Bytef*)data;
+    stream->avail_in = size;
+
+    int flush = finish ? Z_FINISH : Z_SYNC_FLUSH;
+    char chunk[_OUTPUT_CHUNK_SIZE];
+
+    // Loop until deflate() leaves space in the output chunk, which means
+    // that all input has been consumed and the flush is complete.
+    do
+    {
+        stream->next_out = (Bytef*)chunk;
+        stream->avail_out = sizeof(chunk);
+
+        int rc = deflate(stream, flush);
+        PEGASUS_ASSERT(rc != Z_STREAM_ERROR);
+
+        out.append(chunk, (Uint32)(sizeof(chunk) - stream->avail_out));
+    }
+    while (stream->avail_out == 0);
+}
+
+PEGASUS_NAMESPACE_END
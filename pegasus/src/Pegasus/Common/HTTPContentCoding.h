@@ -0,0 +1,144 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+#ifndef Pegasus_HTTPContentCoding_h
+#define Pegasus_HTTPContentCoding_h
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/Constants.h>
+#include <Pegasus/Common/Linkage.h>
+#include <Pegasus/Common/Buffer.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+/**
+    HTTPContentCoding implements the "gzip" and "deflate" HTTP content codings
+    (RFC 2616, section 3.5) which may be applied to the body of CIM-XML and
+    WS-Management responses.  An instance holds the state of one compression
+    stream, so a chunked response can be compressed one chunk at a time.
+
+    The implementation is based on zlib and is only built when
+    PEGASUS_ENABLE_HTTP_COMPRESSION is defined.
+*/
+class PEGASUS_COMMON_LINKAGE HTTPContentCoding
+{
+public:
+
+    enum Coding
+    {
+        IDENTITY,
+        GZIP,
+        DEFLATE
+    };
+
+    /**
+        Selects the preferred content coding from the value of an
+        Accept-Encoding request header.  gzip is preferred over deflate.
+        Codings listed with a quality value of zero are not selected.
+        @param acceptEncoding The header value.
+        @return The selected coding, or IDENTITY if neither gzip nor deflate
+            is acceptable.
+    */
+    static Coding parseAcceptEncoding(const char* acceptEncoding);
+
+    /**
+        Parses the value of a Content-Encoding header.
+        @param contentEncoding The header value.
+        @param coding Receives the coding.
+        @return false if the coding is not supported.
+    */
+    static Boolean parseContentEncoding(
+        const char* contentEncoding,
+        Coding& coding);
+
+    /**
+        Returns the token used for the coding in HTTP headers.
+    */
+    static const char* getName(Coding coding);
+
+    /**
+        Decompresses a complete message body.
+        @param coding The coding applied to the data.
+        @param data The compressed data.
+        @param size The number of bytes of compressed data.
+        @param out The decompressed data is appended to this buffer.
+        @param maxSize The largest number of bytes the data may decompress
+            to.  Decompression stops as soon as more would be produced, so a
+            small body with an extreme compression ratio cannot exhaust the
+            memory of the receiver.
+        @return false if the data is not a valid stream of the given coding
+            or decompresses to more than maxSize bytes.
+    */
+    static Boolean decompress(
+        Coding coding,
+        const char* data,
+        Uint32 size,
+        Buffer& out,
+        Uint32 maxSize = PEGASUS_MAX_DECOMPRESSED_MESSAGE_SIZE);
+
+    /**
+        Constructs a compression stream for the given coding, which must not
+        be IDENTITY.
+    */
+    HTTPContentCoding(Coding coding);
+
+    ~HTTPContentCoding();
+
+    /**
+        Compresses the data and appends the output to out.  Unless finish is
+        true, the stream is flushed to a byte boundary so that everything
+        compressed so far can be decoded by the receiver; this allows each
+        chunk of a chunked response to be sent as soon as it is available.
+        When finish is true the stream is terminated and no further data may
+        be compressed.
+        @param data The data to compress.
+        @param size The number of bytes of data.
+        @param finish true if this is the last data of the stream.
+        @param out The compressed data is appended to this buffer.
+    */
+    void compress(const char* data, Uint32 size, Boolean finish, Buffer& out);
+
+    Coding getCoding() const
+    {
+        return _coding;
+    }
+
+private:
+
+    HTTPContentCoding(const HTTPContentCoding&);
+    HTTPContentCoding& operator=(const HTTPContentCoding&);
+
+    Coding _coding;
+    void* _stream;
+};
+
+PEGASUS_NAMESPACE_END
+
+#endif /* Pegasus_HTTPContentCoding_h */
@@ -174,7 +174,14 @@ static const char* _MESSAGE_TYPE_STRINGS[] =
     "CIM_INDICATION_SERVICE_DISABLED_RESPONSE_MESSAGE",
 
     "PROVAGT_GET_SCMOCLASS_REQUEST_MESSAGE",
-    "PROVAGT_GET_SCMOCLASS_RESPONSE_MESSAGE"
+    "PROVAGT_GET_SCMOCLASS_RESPONSE_MESSAGE",
+
+    "CIM_OPEN_ENUMERATE_INSTANCES_REQUEST_MESSAGE",
+    "CIM_OPEN_ENUMERATE_INSTANCES_RESPONSE_MESSAGE",
+    "CIM_PULL_INSTANCES_WITH_PATH_REQUEST_MESSAGE",
+    "CIM_PULL_INSTANCES_WITH_PATH_RESPONSE_MESSAGE",
+    "CIM_CLOSE_ENUMERATION_REQUEST_MESSAGE",
+    "CIM_CLOSE_ENUMERATION_RESPONSE_MESSAGE"
 
 };
 
@@ -248,6 +255,14 @@ CIMOperationType Message::convertMessageTypetoCIMOpType(MessageType type)
 
         case CIM_ENUMERATE_INSTANCES_REQUEST_MESSAGE:
         case CIM_ENUMERATE_INSTANCES_RESPONSE_MESSAGE:
+        // The pull operations are accounted as part of the instance
+        // enumeration they carry out.
+        case CIM_OPEN_ENUMERATE_INSTANCES_REQUEST_MESSAGE:
+        case CIM_OPEN_ENUMERATE_INSTANCES_RESPONSE_MESSAGE:
+        case CIM_PULL_INSTANCES_WITH_PATH_REQUEST_MESSAGE:
+        case CIM_PULL_INSTANCES_WITH_PATH_RESPONSE_MESSAGE:
+        case CIM_CLOSE_ENUMERATION_REQUEST_MESSAGE:
+        case CIM_CLOSE_ENUMERATION_RESPONSE_MESSAGE:
              enum_type = CIMOPTYPE_ENUMERATE_INSTANCES;
              break;
 
@@ -39,6 +39,7 @@
 #include <Pegasus/Common/Linkage.h>
 #include <Pegasus/Common/CIMOperationType.h>
 #include <Pegasus/Common/Linkable.h>
+#include <Pegasus/Common/PooledAllocator.h>
 
 PEGASUS_NAMESPACE_BEGIN
 
@@ -186,6 +187,13 @@ enum MessageType
     PROVAGT_GET_SCMOCLASS_REQUEST_MESSAGE,
     PROVAGT_GET_SCMOCLASS_RESPONSE_MESSAGE,
 
+    CIM_OPEN_ENUMERATE_INSTANCES_REQUEST_MESSAGE,
+    CIM_OPEN_ENUMERATE_INSTANCES_RESPONSE_MESSAGE,
+    CIM_PULL_INSTANCES_WITH_PATH_REQUEST_MESSAGE,
+    CIM_PULL_INSTANCES_WITH_PATH_RESPONSE_MESSAGE,
+    CIM_CLOSE_ENUMERATION_REQUEST_MESSAGE,
+    CIM_CLOSE_ENUMERATION_RESPONSE_MESSAGE,
+
     NUMBER_OF_MESSAGES
 };
 
@@ -220,6 +228,18 @@ public:
 
     virtual ~Message();
 
+    // Messages are allocated from the per-thread pools of the
+    // PooledAllocator (see PooledAllocator.h).
+    static void* operator new(size_t size)
+    {
+        return PooledAllocator::allocate(size);
+    }
+
+    static void operator delete(void* ptr, size_t size)
+    {
+        PooledAllocator::deallocate(ptr, size);
+    }
+
     // NOTE: The compiler default implementation of the copy constructor
     // is used for this class.
 
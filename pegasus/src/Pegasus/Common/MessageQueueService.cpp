@@ -201,8 +201,13 @@ MessageQueueService::MessageQueueService(
         //  _thread_pool = new ThreadPool(initial_cnt, "MessageQueueService",
         //   minimum_cnt, maximum_cnt, deallocateWait);
         //
-        _thread_pool =
-            new ThreadPool(0, "MessageQueueService", 0, 0, deallocateWait);
+        _thread_pool = new ThreadPool(
+            0,
+            "MessageQueueService",
+            0,
+            0,
+            deallocateWait,
+            PEGASUS_DEFAULT_SERVICE_THREAD_POOL_QUEUE_SIZE);
     }
     _service_count++;
 
@@ -701,8 +706,17 @@ AsyncReply *MessageQueueService::SendWait(AsyncRequest* request)
         (void *)0,
         ASYNC_OPFLAGS_PSEUDO_CALLBACK);
 
+    // A service thread that waits here must not keep the service that
+    // handles the request from getting a thread.
+    Boolean waiting = _thread_pool && _thread_pool->beginWait();
+
     request->op->_client_sem.wait();
 
+    if (waiting)
+    {
+        _thread_pool->endWait();
+    }
+
     AsyncReply* rpl = static_cast<AsyncReply *>(request->op->removeResponse());
     rpl->op = 0;
 
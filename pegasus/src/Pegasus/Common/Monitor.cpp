@@ -39,6 +39,8 @@
 #include <Pegasus/Common/HTTPConnection.h>
 #include <Pegasus/Common/HTTPAcceptor.h>
 #include <Pegasus/Common/MessageQueueService.h>
+#include <Pegasus/Common/ThreadPool.h>
+#include <Pegasus/Common/Constants.h>
 #include <Pegasus/Common/Exception.h>
 #include "ArrayIterator.h"
 #include "HostAddress.h"
@@ -334,8 +336,34 @@ void Tickler::_uninitialize()
 Monitor::Monitor()
    : _stopConnections(0),
      _stopConnectionsSem(0),
-     _solicitSocketCount(0)
+     _solicitSocketCount(0),
+     _connectionCount(0),
+     _dyingEntriesPending(false),
+     _lastTimeoutCheck(0),
+     _admissionControl(false),
+     _poller(MonitorPoller::create())
 {
+    _initialize();
+}
+
+Monitor::Monitor(MonitorPoller* poller)
+   : _stopConnections(0),
+     _stopConnectionsSem(0),
+     _solicitSocketCount(0),
+     _connectionCount(0),
+     _dyingEntriesPending(false),
+     _lastTimeoutCheck(0),
+     _admissionControl(false),
+     _poller(poller)
+{
+    _initialize();
+}
+
+void Monitor::_initialize()
+{
+    PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
+        "Monitor: using %s poller", _poller->getName()));
+
     int numberOfMonitorEntriesToAllocate = MAX_NUMBER_OF_MONITOR_ENTRIES;
     _entries.reserveCapacity(numberOfMonitorEntriesToAllocate);
 
@@ -346,6 +374,7 @@ Monitor::Monitor()
         1,
         MonitorEntry::STATUS_IDLE,
         MonitorEntry::TYPE_TICKLER));
+    _poller->addSocket(_tickler.getReadHandle(), 0);
 
     // Start the count at 1 because _entries[0] is the Tickler
     for (int i = 1; i < numberOfMonitorEntriesToAllocate; i++)
@@ -371,15 +400,76 @@ void Monitor::setState(
 {
     AutoMutex autoEntryMutex(_entriesMutex);
     // Set the state to requested state
-    _entries[index].status = status;
+    _setStatus(index, status);
+}
+
+void Monitor::_setStatus(Uint32 index, Uint32 status)
+{
+    MonitorEntry& entry = _entries[index];
+    Boolean wasIdle = (entry.status == MonitorEntry::STATUS_IDLE);
+    Boolean isIdle = (status == MonitorEntry::STATUS_IDLE);
+
+    entry.status = status;
+
+    if (status == MonitorEntry::STATUS_DYING)
+    {
+        _dyingEntriesPending = true;
+    }
+
+    // Only IDLE entries are owned by the Monitor, so only their sockets
+    // are watched by the poller.
+    if (wasIdle != isIdle && entry.socket != PEGASUS_INVALID_SOCKET)
+    {
+        if (isIdle)
+        {
+            _poller->addSocket(entry.socket, index);
+        }
+        else
+        {
+            _poller->removeSocket(entry.socket);
+        }
+    }
+}
+
+void Monitor::_checkConnectionTimeouts(struct timeval* timeNow)
+{
+    ArrayIterator<MonitorEntry> entries(_entries);
+
+    for (Uint32 indx = 0; indx < entries.size(); indx++)
+    {
+        if ((entries[indx].status == MonitorEntry::STATUS_IDLE) &&
+            entries[indx].type == MonitorEntry::TYPE_CONNECTION)
+        {
+            MessageQueue* q = MessageQueue::lookup(entries[indx].queueId);
+            PEGASUS_ASSERT(q != 0);
+            HTTPConnection *dst = reinterpret_cast<HTTPConnection *>(q);
+            dst->_entry_index = indx;
+            dst->closeConnectionOnTimeout(timeNow);
+        }
+    }
 }
 
 void Monitor::run(Uint32 milliseconds)
 {
-    struct timeval tv = {milliseconds/1000, milliseconds%1000*1000};
+    // Hold back new requests while a thread pool is saturated.  The wait
+    // is bounded, so the connections are still served (more slowly) if
+    // the thread pool stays saturated.
+    if (_admissionControl)
+    {
+        Uint32 admissionWait = milliseconds;
+        if (admissionWait > PEGASUS_THREAD_POOL_ADMISSION_WAIT_MSEC)
+        {
+            admissionWait = PEGASUS_THREAD_POOL_ADMISSION_WAIT_MSEC;
+        }
 
-    fd_set fdread;
-    FD_ZERO(&fdread);
+        if (!ThreadPool::waitForAdmission(admissionWait))
+        {
+            PEG_TRACE((TRC_HTTP, Tracer::LEVEL2,
+                "Monitor::run: A thread pool is still saturated after "
+                    "%u milliseconds.",
+                admissionWait));
+        }
+    }
 
     AutoMutex autoEntryMutex(_entriesMutex);
 
@@ -399,12 +489,12 @@ void Monitor::run(Uint32 milliseconds)
                         entries[indx].status == MonitorEntry::STATUS_DYING)
                     {
                         // remove the entry
-                        entries[indx].status = MonitorEntry::STATUS_EMPTY;
+                        _setStatus(indx, MonitorEntry::STATUS_EMPTY);
                     }
                     else
                     {
                         // set status to DYING
-                        entries[indx].status = MonitorEntry::STATUS_DYING;
+                        _setStatus(indx, MonitorEntry::STATUS_DYING);
                     }
                 }
             }
@@ -413,103 +503,80 @@ void Monitor::run(Uint32 milliseconds)
         _stopConnectionsSem.signal();
     }
 
-    for (Uint32 indx = 0; indx < entries.size(); indx++)
+    // Only scan for closed connections when an entry has been set to
+    // DYING since the last scan (or was left DYING by it).
+    if (_dyingEntriesPending)
     {
-        const MonitorEntry& entry = entries[indx];
+        _dyingEntriesPending = false;
 
-        if ((entry.status == MonitorEntry::STATUS_DYING) &&
-            (entry.type == MonitorEntry::TYPE_CONNECTION))
+        for (Uint32 indx = 0; indx < entries.size(); indx++)
         {
-            MessageQueue *q = MessageQueue::lookup(entry.queueId);
-            PEGASUS_ASSERT(q != 0);
-            HTTPConnection &h = *static_cast<HTTPConnection *>(q);
-
-            if (h._connectionClosePending == false)
-                continue;
+            const MonitorEntry& entry = entries[indx];
 
-            // NOTE: do not attempt to delete while there are pending responses
-            // coming thru. The last response to come thru after a
-            // _connectionClosePending will reset _responsePending to false
-            // and then cause the monitor to rerun this code and clean up.
-            // (see HTTPConnection.cpp)
-
-            if (h._responsePending == true)
+            if ((entry.status == MonitorEntry::STATUS_DYING) &&
+                (entry.type == MonitorEntry::TYPE_CONNECTION))
             {
-                PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
-                    "Monitor::run - Ignoring connection delete request "
-                        "because responses are still pending. "
-                        "connection=0x%p, socket=%d\n",
-                    (void *)&h, h.getSocket()));
-                continue;
-            }
-            h._connectionClosePending = false;
-            HTTPAcceptor &o = h.getOwningAcceptor();
-            Message* message= new CloseConnectionMessage(entry.socket);
-            message->dest = o.getQueueId();
-
-            // HTTPAcceptor is responsible for closing the connection.
-            // The lock is released to allow HTTPAcceptor to call
-            // unsolicitSocketMessages to free the entry.
-            // Once HTTPAcceptor completes processing of the close
-            // connection, the lock is re-requested and processing of
-            // the for loop continues.  This is safe with the current
-            // implementation of the entries object.  Note that the
-            // loop condition accesses the entries.size() on each
-            // iteration, so that a change in size while the mutex is
-            // unlocked will not result in an ArrayIndexOutOfBounds
-            // exception.
-
-            _entriesMutex.unlock();
-            o.enqueue(message);
-            _entriesMutex.lock();
-
-            // After enqueue a message and the autoEntryMutex has been
-            // released and locked again, the array of _entries can be
-            // changed. The ArrayIterator has be reset with the original
-            // _entries.
-            entries.reset(_entries);
-        }
-    }
+                MessageQueue *q = MessageQueue::lookup(entry.queueId);
+                PEGASUS_ASSERT(q != 0);
+                HTTPConnection &h = *static_cast<HTTPConnection *>(q);
 
-    Uint32 _idleEntries = 0;
+                if (h._connectionClosePending == false)
+                {
+                    _dyingEntriesPending = true;
+                    continue;
+                }
 
-    /*
-        We will keep track of the maximum socket number and pass this value
-        to the kernel as a parameter to SELECT.  This loop seems like a good
-        place to calculate the max file descriptor (maximum socket number)
-        because we have to traverse the entire array.
-    */
-    SocketHandle maxSocketCurrentPass = 0;
-    for (Uint32 indx = 0; indx < entries.size(); indx++)
-    {
-        if (maxSocketCurrentPass < entries[indx].socket)
-            maxSocketCurrentPass = entries[indx].socket;
+                // NOTE: do not attempt to delete while there are pending
+                // responses coming thru. The last response to come thru
+                // after a _connectionClosePending will reset
+                // _responsePending to false and then cause the monitor to
+                // rerun this code and clean up. (see HTTPConnection.cpp)
 
-        if (entries[indx].status == MonitorEntry::STATUS_IDLE)
-        {
-            _idleEntries++;
-            FD_SET(entries[indx].socket, &fdread);
+                if (h._responsePending == true)
+                {
+                    PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
+                        "Monitor::run - Ignoring connection delete request "
+                            "because responses are still pending. "
+                            "connection=0x%p, socket=%d\n",
+                        (void *)&h, h.getSocket()));
+                    _dyingEntriesPending = true;
+                    continue;
+                }
+                h._connectionClosePending = false;
+                HTTPAcceptor &o = h.getOwningAcceptor();
+                Message* message= new CloseConnectionMessage(entry.socket);
+                message->dest = o.getQueueId();
+
+                // HTTPAcceptor is responsible for closing the connection.
+                // The lock is released to allow HTTPAcceptor to call
+                // unsolicitSocketMessages to free the entry.
+                // Once HTTPAcceptor completes processing of the close
+                // connection, the lock is re-requested and processing of
+                // the for loop continues.  This is safe with the current
+                // implementation of the entries object.  Note that the
+                // loop condition accesses the entries.size() on each
+                // iteration, so that a change in size while the mutex is
+                // unlocked will not result in an ArrayIndexOutOfBounds
+                // exception.
+
+                _entriesMutex.unlock();
+                o.enqueue(message);
+                _entriesMutex.lock();
+
+                // After enqueue a message and the autoEntryMutex has been
+                // released and locked again, the array of _entries can be
+                // changed. The ArrayIterator has be reset with the original
+                // _entries.
+                entries.reset(_entries);
+            }
         }
     }
 
-    /*
-        Add 1 then assign maxSocket accordingly. We add 1 to account for
-        descriptors starting at 0.
-    */
-    maxSocketCurrentPass++;
+    _poller->prepare(_entries);
 
     _entriesMutex.unlock();
 
-    //
-    // The first argument to select() is ignored on Windows and it is not
-    // a socket value.  The original code assumed that the number of sockets
-    // and a socket value have the same type.  On Windows they do not.
-    //
-#ifdef PEGASUS_OS_TYPE_WINDOWS
-    int events = select(0, &fdread, NULL, NULL, &tv);
-#else
-    int events = select(maxSocketCurrentPass, &fdread, NULL, NULL, &tv);
-#endif
+    int events = _poller->wait(milliseconds, _readyEntries);
     int selectErrno = getSocketError();
 
     _entriesMutex.lock();
@@ -525,7 +592,8 @@ void Monitor::run(Uint32 milliseconds)
     if (events == PEGASUS_SOCKET_ERROR)
     {
         PEG_TRACE((TRC_HTTP, Tracer::LEVEL1,
-            "Monitor::run - select() returned error %d.", selectErrno));
+            "Monitor::run - %s poller returned error %d.",
+            _poller->getName(), selectErrno));
         // The EBADF error indicates that one or more or the file
         // descriptions was not valid. This could indicate that
         // the entries structure has been corrupted or that
@@ -536,125 +604,116 @@ void Monitor::run(Uint32 milliseconds)
     else if (events)
     {
         PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
-            "Monitor::run select event received events = %d, monitoring %d "
-                "idle entries",
-            events, _idleEntries));
-        for (Uint32 indx = 0; indx < entries.size(); indx++)
+            "Monitor::run %s event received events = %d",
+            _poller->getName(), events));
+
+        for (Uint32 i = 0; i < _readyEntries.size(); i++)
         {
+            Uint32 indx = _readyEntries[i].index;
+
             // The Monitor should only look at entries in the table that are
-            // IDLE (i.e., owned by the Monitor).
-            if ((entries[indx].status == MonitorEntry::STATUS_IDLE) &&
-                (FD_ISSET(entries[indx].socket, &fdread)))
+            // IDLE (i.e., owned by the Monitor).  The entry may have been
+            // removed or reused while the mutex was unlocked, in which case
+            // the event is stale and is ignored.
+            if (indx >= entries.size() ||
+                entries[indx].socket != _readyEntries[i].socket ||
+                entries[indx].status != MonitorEntry::STATUS_IDLE)
             {
-                MessageQueue* q = MessageQueue::lookup(entries[indx].queueId);
-                PEGASUS_ASSERT(q != 0);
-                PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
-                    "Monitor::run indx = %d, queueId = %d, q = %p",
-                    indx, entries[indx].queueId, q));
+                continue;
+            }
+
+            MessageQueue* q = MessageQueue::lookup(entries[indx].queueId);
+            PEGASUS_ASSERT(q != 0);
+            PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
+                "Monitor::run indx = %d, queueId = %d, q = %p",
+                indx, entries[indx].queueId, q));
 
-                try
+            try
+            {
+                if (entries[indx].type == MonitorEntry::TYPE_CONNECTION)
                 {
-                    if (entries[indx].type == MonitorEntry::TYPE_CONNECTION)
+                    PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
+                        "entries[%d].type is TYPE_CONNECTION",
+                        indx));
+
+                    HTTPConnection *dst =
+                        reinterpret_cast<HTTPConnection *>(q);
+                    dst->_entry_index = indx;
+
+                    // Update idle start time because we have received some
+                    // data. Any data is good data at this point, and we'll
+                    // keep the connection alive, even if we've exceeded
+                    // the idleConnectionTimeout, which will be checked
+                    // when we call closeConnectionOnTimeout() next.
+                    Time::gettimeofday(&dst->_idleStartTime);
+
+                    // Check for accept pending (ie. SSL handshake pending)
+                    // or idle connection timeouts for sockets from which
+                    // we received data (avoiding extra queue lookup below).
+                    if (!dst->closeConnectionOnTimeout(&timeNow))
                     {
                         PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
-                            "entries[%d].type is TYPE_CONNECTION",
-                            indx));
-
-                        HTTPConnection *dst =
-                            reinterpret_cast<HTTPConnection *>(q);
-                        dst->_entry_index = indx;
-
-                        // Update idle start time because we have received some
-                        // data. Any data is good data at this point, and we'll
-                        // keep the connection alive, even if we've exceeded
-                        // the idleConnectionTimeout, which will be checked
-                        // when we call closeConnectionOnTimeout() next.
-                        Time::gettimeofday(&dst->_idleStartTime);
-
-                        // Check for accept pending (ie. SSL handshake pending)
-                        // or idle connection timeouts for sockets from which
-                        // we received data (avoiding extra queue lookup below).
-                        if (!dst->closeConnectionOnTimeout(&timeNow))
+                            "Entering HTTPConnection::run() for "
+                                "indx = %d, queueId = %d, q = %p",
+                            indx, entries[indx].queueId, q));
+
+                        try
                         {
-                            PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
-                                "Entering HTTPConnection::run() for "
-                                    "indx = %d, queueId = %d, q = %p",
-                                indx, entries[indx].queueId, q));
-
-                            try
-                            {
-                                dst->run(1);
-                            }
-                            catch (...)
-                            {
-                                PEG_TRACE_CSTRING(TRC_HTTP, Tracer::LEVEL1,
-                                    "Caught exception from "
-                                    "HTTPConnection::run()");
-                            }
-                            PEG_TRACE_CSTRING(TRC_HTTP, Tracer::LEVEL4,
-                                "Exited HTTPConnection::run()");
+                            dst->run(1);
                         }
+                        catch (...)
+                        {
+                            PEG_TRACE_CSTRING(TRC_HTTP, Tracer::LEVEL1,
+                                "Caught exception from "
+                                "HTTPConnection::run()");
+                        }
+                        PEG_TRACE_CSTRING(TRC_HTTP, Tracer::LEVEL4,
+                            "Exited HTTPConnection::run()");
                     }
-                    else if (entries[indx].type == MonitorEntry::TYPE_TICKLER)
-                    {
-                        _tickler.reset();
-                    }
-                    else
-                    {
-                        PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
-                            "Non-connection entry, indx = %d, has been "
-                                "received.",
-                            indx));
-                        Message* msg = new SocketMessage(
-                            entries[indx].socket, SocketMessage::READ);
-                        entries[indx].status = MonitorEntry::STATUS_BUSY;
-                        _entriesMutex.unlock();
-                        q->enqueue(msg);
-                        _entriesMutex.lock();
-
-                        // After enqueue a message and the autoEntryMutex has
-                        // been released and locked again, the array of
-                        // entries can be changed. The ArrayIterator has to be
-                        // reset with the latest _entries.
-                        entries.reset(_entries);
-                        entries[indx].status = MonitorEntry::STATUS_IDLE;
-                    }
                 }
-                catch (...)
+                else if (entries[indx].type == MonitorEntry::TYPE_TICKLER)
+                {
+                    _tickler.reset();
+                }
+                else
                 {
+                    PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
+                        "Non-connection entry, indx = %d, has been "
+                            "received.",
+                        indx));
+                    Message* msg = new SocketMessage(
+                        entries[indx].socket, SocketMessage::READ);
+
+                    // The entry is only BUSY while this thread delivers the
+                    // message, so its socket is left registered with the
+                    // poller.
+                    entries[indx].status = MonitorEntry::STATUS_BUSY;
+                    _entriesMutex.unlock();
+                    q->enqueue(msg);
+                    _entriesMutex.lock();
+
+                    // After enqueue a message and the autoEntryMutex has
+                    // been released and locked again, the array of
+                    // entries can be changed. The ArrayIterator has to be
+                    // reset with the latest _entries.
+                    entries.reset(_entries);
+                    entries[indx].status = MonitorEntry::STATUS_IDLE;
                 }
             }
-            // else check for accept pending (ie. SSL handshake pending) or
-            // idle connection timeouts for sockets from which we did not
-            // receive data.
-            else if ((entries[indx].status == MonitorEntry::STATUS_IDLE) &&
-                entries[indx].type == MonitorEntry::TYPE_CONNECTION)
-
+            catch (...)
             {
-                MessageQueue* q = MessageQueue::lookup(entries[indx].queueId);
-                PEGASUS_ASSERT(q != 0);
-                HTTPConnection *dst = reinterpret_cast<HTTPConnection *>(q);
-                dst->_entry_index = indx;
-                dst->closeConnectionOnTimeout(&timeNow);
             }
         }
     }
-    // else if "events" is zero (ie. select timed out) then we still need
-    // to check if there are any pending SSL handshakes that have timed out.
-    else
+
+    // Check for accept pending (ie. SSL handshake pending) or idle
+    // connection timeouts.  Both timeouts have a granularity of one second,
+    // so the IDLE connections only need to be visited once per second
+    // rather than on every wakeup.
+    if (timeNow.tv_sec != _lastTimeoutCheck)
     {
-        for (Uint32 indx = 0; indx < entries.size(); indx++)
-        {
-            if ((entries[indx].status == MonitorEntry::STATUS_IDLE) &&
-                entries[indx].type == MonitorEntry::TYPE_CONNECTION)
-            {
-                MessageQueue* q = MessageQueue::lookup(entries[indx].queueId);
-                PEGASUS_ASSERT(q != 0);
-                HTTPConnection *dst = reinterpret_cast<HTTPConnection *>(q);
-                dst->_entry_index = indx;
-                dst->closeConnectionOnTimeout(&timeNow);
-            }
-        }
+        _lastTimeoutCheck = timeNow.tv_sec;
+        _checkConnectionTimeouts(&timeNow);
     }
 }
 
@@ -705,8 +764,14 @@ int Monitor::solicitSocketMessages(
                 _entries[index].socket = socket;
                 _entries[index].queueId  = queueId;
                 _entries[index].type = type;
-                _entries[index].status = MonitorEntry::STATUS_IDLE;
+                _setStatus(index, MonitorEntry::STATUS_IDLE);
+
+                if (type == MonitorEntry::TYPE_CONNECTION)
+                {
+                    _connectionCount++;
+                }
 
+                PEG_METHOD_EXIT();
                 return (int)index;
             }
         }
@@ -733,6 +798,12 @@ void Monitor::unsolicitSocketMessages(SocketHandle socket)
     {
         if (_entries[index].socket == socket)
         {
+            if (_entries[index].type == MonitorEntry::TYPE_CONNECTION &&
+                _entries[index].status != MonitorEntry::STATUS_EMPTY)
+            {
+                _connectionCount--;
+            }
+            _setStatus(index, MonitorEntry::STATUS_EMPTY);
             _entries[index].reset();
             _solicitSocketCount--;
             break;
@@ -41,6 +41,7 @@
 #include <Pegasus/Common/Sharable.h>
 #include <Pegasus/Common/Linkage.h>
 #include <Pegasus/Common/AutoPtr.h>
+#include <Pegasus/Common/MonitorPoller.h>
 
 PEGASUS_NAMESPACE_BEGIN
 
@@ -225,13 +226,25 @@ private:
     In this example, the monitor is run for five seconds. The run method
     returns after the first message is occurs or five seconds has transpired
     (whichever occurs first).
+
+    The wait for socket activity is delegated to a MonitorPoller.  Sockets
+    are registered with the poller as their entries become IDLE and removed
+    when they leave that state, so with the epoll poller the cost of a
+    wakeup depends on the number of ready sockets rather than on the number
+    of connections.
 */
 class PEGASUS_COMMON_LINKAGE Monitor
 {
 public:
-    /** Default constructor. */
+    /** Default constructor.  Uses the best poller available on this
+        platform (see MonitorPoller::create()). */
     Monitor();
 
+    /** Constructs a Monitor which uses the given poller.
+        @param poller the poller to use.  The Monitor takes ownership of it.
+    */
+    Monitor(MonitorPoller* poller);
+
     /** This destruct deletes all handlers which were installed. */
     ~Monitor();
 
@@ -279,8 +292,47 @@ public:
      */
     void stopListeningForConnections(Boolean wait);
 
+    /** Returns the name of the polling mechanism used by this monitor.
+     */
+    const char* getPollerName() const
+    {
+        return _poller->getName();
+    }
+
+    /** Returns the number of connections currently registered with this
+        monitor.  The value is read without locking the entries.
+     */
+    Uint32 getConnectionCount() const
+    {
+        return _connectionCount.get();
+    }
+
+    /** Enables or disables admission control.  With admission control
+        enabled, run() holds back reading new requests for up to
+        PEGASUS_THREAD_POOL_ADMISSION_WAIT_MSEC while a thread pool is
+        saturated (see ThreadPool::waitForAdmission()).
+     */
+    void setAdmissionControl(Boolean admissionControl)
+    {
+        _admissionControl = admissionControl;
+    }
+
 private:
 
+    void _initialize();
+
+    /**
+        Sets the status of the given entry and keeps the poller interest
+        set in sync with it.  The _entriesMutex must be locked.
+    */
+    void _setStatus(Uint32 index, Uint32 status);
+
+    /**
+        Checks all IDLE connections for SSL accept and idle connection
+        timeouts.  The _entriesMutex must be locked.
+    */
+    void _checkConnectionTimeouts(struct timeval* timeNow);
+
     Array<MonitorEntry> _entries;
     /**
         This mutex must be locked when accessing the _entries array or any
@@ -294,7 +346,26 @@ private:
     /** tracks how many times solicitSocketCount() has been called */
     Uint32 _solicitSocketCount;
 
+    /** Number of TYPE_CONNECTION entries (see getConnectionCount()) */
+    AtomicInt _connectionCount;
+
+    /**
+        Set when an entry may be in the DYING state, so that run() only
+        scans the entries for closed connections when there may be some.
+    */
+    Boolean _dyingEntriesPending;
+
+    /** The time (in seconds) of the last connection timeout check. */
+    Sint64 _lastTimeoutCheck;
+
+    Boolean _admissionControl;
+
     Tickler _tickler;
+
+    AutoPtr<MonitorPoller> _poller;
+
+    /** Sockets reported ready by the last wait (used by run() only). */
+    Array<MonitorPoller::ReadyEntry> _readyEntries;
 };
 
 PEGASUS_NAMESPACE_END
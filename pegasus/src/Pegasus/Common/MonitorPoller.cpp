@@ -0,0 +1,281 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include "Network.h"
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/Monitor.h>
+#include <Pegasus/Common/MonitorPoller.h>
+#include <Pegasus/Common/Tracer.h>
+#include <Pegasus/Common/Exception.h>
+#include <Pegasus/Common/MessageLoader.h>
+#include <errno.h>
+
+#ifdef PEGASUS_HAS_EPOLL
+# include <sys/epoll.h>
+#endif
+
+PEGASUS_USING_STD;
+
+PEGASUS_NAMESPACE_BEGIN
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MonitorPoller
+//
+////////////////////////////////////////////////////////////////////////////////
+
+MonitorPoller::~MonitorPoller()
+{
+}
+
+MonitorPoller* MonitorPoller::create()
+{
+#ifdef PEGASUS_HAS_EPOLL
+    try
+    {
+        return new EpollMonitorPoller();
+    }
+    catch (Exception& e)
+    {
+        PEG_TRACE((TRC_HTTP, Tracer::LEVEL1,
+            "MonitorPoller::create - falling back to select(): %s",
+            (const char*)e.getMessage().getCString()));
+    }
+#endif
+
+    return new SelectMonitorPoller();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// SelectMonitorPoller
+//
+////////////////////////////////////////////////////////////////////////////////
+
+SelectMonitorPoller::SelectMonitorPoller()
+    : _maxSocket(0)
+{
+    FD_ZERO(&_fdread);
+}
+
+SelectMonitorPoller::~SelectMonitorPoller()
+{
+}
+
+const char* SelectMonitorPoller::getName() const
+{
+    return "select";
+}
+
+void SelectMonitorPoller::addSocket(SocketHandle, Uint32)
+{
+    // The fd_set is rebuilt from the entries table on each pass.
+}
+
+void SelectMonitorPoller::removeSocket(SocketHandle)
+{
+}
+
+void SelectMonitorPoller::prepare(const Array<MonitorEntry>& entries)
+{
+    FD_ZERO(&_fdread);
+    _watched.clear();
+
+    /*
+        We will keep track of the maximum socket number and pass this value
+        to the kernel as a parameter to SELECT.
+    */
+    _maxSocket = 0;
+
+    for (Uint32 indx = 0; indx < entries.size(); indx++)
+    {
+        if (_maxSocket < entries[indx].socket)
+            _maxSocket = entries[indx].socket;
+
+        if (entries[indx].status == MonitorEntry::STATUS_IDLE)
+        {
+            ReadyEntry watched;
+            watched.index = indx;
+            watched.socket = entries[indx].socket;
+            _watched.append(watched);
+            FD_SET(entries[indx].socket, &_fdread);
+        }
+    }
+
+    /*
+        Add 1 then assign maxSocket accordingly. We add 1 to account for
+        descriptors starting at 0.
+    */
+    _maxSocket++;
+}
+
+int SelectMonitorPoller::wait(Uint32 milliseconds, Array<ReadyEntry>& ready)
+{
+    struct timeval tv = {milliseconds/1000, milliseconds%1000*1000};
+
+    ready.clear();
+
+    //
+    // The first argument to select() is ignored on Windows and it is not
+    // a socket value.  The original code assumed that the number of sockets
+    // and a socket value have the same type.  On Windows they do not.
+    //
+#ifdef PEGASUS_OS_TYPE_WINDOWS
+    int events = select(0, &_fdread, NULL, NULL, &tv);
+#else
+    int events = select(_maxSocket, &_fdread, NULL, NULL, &tv);
+#endif
+
+    if (events > 0)
+    {
+        for (Uint32 i = 0; i < _watched.size(); i++)
+        {
+            if (FD_ISSET(_watched[i].socket, &_fdread))
+            {
+                ready.append(_watched[i]);
+            }
+        }
+    }
+
+    return events;
+}
+
+#ifdef PEGASUS_HAS_EPOLL
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// EpollMonitorPoller
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Maximum number of events returned by a single epoll_wait() call.  Any
+// remaining ready sockets are reported by the next call.
+#define MAX_EPOLL_EVENTS 256
+
+EpollMonitorPoller::EpollMonitorPoller()
+{
+    // The size argument is only a hint (and ignored by current kernels).
+    _epollFd = epoll_create(MAX_EPOLL_EVENTS);
+
+    if (_epollFd == -1)
+    {
+        MessageLoaderParms parms(
+            "Common.Monitor.EPOLL_CREATE",
+            "Received error number $0 while creating the epoll instance.",
+            errno);
+        throw Exception(parms);
+    }
+
+    fcntl(_epollFd, F_SETFD, FD_CLOEXEC);
+}
+
+EpollMonitorPoller::~EpollMonitorPoller()
+{
+    close(_epollFd);
+}
+
+const char* EpollMonitorPoller::getName() const
+{
+    return "epoll";
+}
+
+void EpollMonitorPoller::addSocket(SocketHandle socket, Uint32 index)
+{
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+
+    // Keep both the entry index and the socket so that stale events for a
+    // reused entry can be detected by the Monitor.
+    event.data.u64 = (Uint64(index) << 32) | Uint32(socket);
+
+    if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, socket, &event) == -1)
+    {
+        // The descriptor may still be registered if it was closed and
+        // reused before it was removed.
+        if (errno != EEXIST ||
+            epoll_ctl(_epollFd, EPOLL_CTL_MOD, socket, &event) == -1)
+        {
+            PEG_TRACE((TRC_HTTP, Tracer::LEVEL1,
+                "EpollMonitorPoller::addSocket - epoll_ctl() failed for "
+                    "socket %d, errno = %d",
+                socket, errno));
+        }
+    }
+}
+
+void EpollMonitorPoller::removeSocket(SocketHandle socket)
+{
+    // A closed descriptor is dropped from the interest set by the kernel,
+    // so EBADF and ENOENT are expected here and can be ignored.
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    epoll_ctl(_epollFd, EPOLL_CTL_DEL, socket, &event);
+}
+
+void EpollMonitorPoller::prepare(const Array<MonitorEntry>&)
+{
+    // The interest set is maintained incrementally.
+}
+
+int EpollMonitorPoller::wait(Uint32 milliseconds, Array<ReadyEntry>& ready)
+{
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+
+    ready.clear();
+
+    int timeout = milliseconds > 0x7fffffff ? -1 : int(milliseconds);
+    int count = epoll_wait(_epollFd, events, MAX_EPOLL_EVENTS, timeout);
+
+    if (count == -1)
+    {
+        // An interrupted wait is treated like a timeout.
+        return errno == EINTR ? 0 : PEGASUS_SOCKET_ERROR;
+    }
+
+    ready.reserveCapacity(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        // EPOLLHUP and EPOLLERR are reported as read events, matching the
+        // behavior of select().
+        ReadyEntry entry;
+        entry.index = Uint32(events[i].data.u64 >> 32);
+        entry.socket = SocketHandle(events[i].data.u64 & 0xffffffff);
+        ready.append(entry);
+    }
+
+    return count;
+}
+
+#endif /* PEGASUS_HAS_EPOLL */
+
+PEGASUS_NAMESPACE_END
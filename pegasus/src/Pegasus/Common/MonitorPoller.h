@@ -0,0 +1,179 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#ifndef Pegasus_MonitorPoller_h
+#define Pegasus_MonitorPoller_h
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/ArrayInternal.h>
+#include <Pegasus/Common/Socket.h>
+#include <Pegasus/Common/Linkage.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+class MonitorEntry;
+
+/**
+    The MonitorPoller class is the readiness notification backend used by
+    the Monitor.  The Monitor registers a socket with the poller when its
+    entry becomes IDLE (i.e., owned by the Monitor) and removes it when the
+    entry leaves the IDLE state, so the poller only watches sockets the
+    Monitor is allowed to dispatch.
+
+    Two implementations exist:
+
+    <ul>
+    <li> EpollMonitorPoller keeps a kernel interest set which is updated
+         incrementally, so a wakeup costs only the number of ready sockets
+         and the number of sockets is not limited by FD_SETSIZE. It is
+         used when PEGASUS_HAS_EPOLL is defined. </li>
+    <li> SelectMonitorPoller rebuilds an fd_set from the entries on each
+         pass.  It is the fallback on all other platforms. </li>
+    </ul>
+*/
+class PEGASUS_COMMON_LINKAGE MonitorPoller
+{
+public:
+
+    /** Identifies a socket reported as ready by wait(). */
+    struct ReadyEntry
+    {
+        Uint32 index;
+        SocketHandle socket;
+    };
+
+    virtual ~MonitorPoller();
+
+    /**
+        Creates the best poller available on this platform.  Falls back
+        to the select() poller if the preferred one cannot be initialized.
+    */
+    static MonitorPoller* create();
+
+    /** Returns the name of the polling mechanism (for tracing). */
+    virtual const char* getName() const = 0;
+
+    /**
+        Starts watching the given socket for read events.
+        @param socket the socket to watch.
+        @param index the index of the socket's entry in the Monitor
+            entries table.
+    */
+    virtual void addSocket(SocketHandle socket, Uint32 index) = 0;
+
+    /**
+        Stops watching the given socket.
+    */
+    virtual void removeSocket(SocketHandle socket) = 0;
+
+    /**
+        Captures whatever state the poller needs from the entries table
+        before wait() is called.  Called with the Monitor entries mutex
+        locked.
+    */
+    virtual void prepare(const Array<MonitorEntry>& entries) = 0;
+
+    /**
+        Waits for read events on the watched sockets.  Called with the
+        Monitor entries mutex unlocked.
+        @param milliseconds the maximum time to wait.
+        @param ready receives the sockets which are ready for reading.
+        @return the number of ready sockets, 0 on timeout, or
+            PEGASUS_SOCKET_ERROR on failure.
+    */
+    virtual int wait(Uint32 milliseconds, Array<ReadyEntry>& ready) = 0;
+};
+
+/**
+    MonitorPoller implementation based on select().
+*/
+class PEGASUS_COMMON_LINKAGE SelectMonitorPoller : public MonitorPoller
+{
+public:
+
+    SelectMonitorPoller();
+
+    virtual ~SelectMonitorPoller();
+
+    virtual const char* getName() const;
+
+    virtual void addSocket(SocketHandle socket, Uint32 index);
+
+    virtual void removeSocket(SocketHandle socket);
+
+    virtual void prepare(const Array<MonitorEntry>& entries);
+
+    virtual int wait(Uint32 milliseconds, Array<ReadyEntry>& ready);
+
+private:
+
+    Array<ReadyEntry> _watched;
+    fd_set _fdread;
+    SocketHandle _maxSocket;
+};
+
+#ifdef PEGASUS_HAS_EPOLL
+
+/**
+    MonitorPoller implementation based on the Linux epoll interface.
+*/
+class PEGASUS_COMMON_LINKAGE EpollMonitorPoller : public MonitorPoller
+{
+public:
+
+    /**
+        Constructs an EpollMonitorPoller.
+        @exception Exception if the epoll instance cannot be created.
+    */
+    EpollMonitorPoller();
+
+    virtual ~EpollMonitorPoller();
+
+    virtual const char* getName() const;
+
+    virtual void addSocket(SocketHandle socket, Uint32 index);
+
+    virtual void removeSocket(SocketHandle socket);
+
+    virtual void prepare(const Array<MonitorEntry>& entries);
+
+    virtual int wait(Uint32 milliseconds, Array<ReadyEntry>& ready);
+
+private:
+
+    int _epollFd;
+};
+
+#endif /* PEGASUS_HAS_EPOLL */
+
+PEGASUS_NAMESPACE_END
+
+#endif /* Pegasus_MonitorPoller_h */
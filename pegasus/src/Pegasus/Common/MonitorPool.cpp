@@ -0,0 +1,228 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/MonitorPool.h>
+#include <Pegasus/Common/HTTPConnection.h>
+#include <Pegasus/Common/Constants.h>
+#include <Pegasus/Common/Tracer.h>
+#include <Pegasus/Common/Exception.h>
+#include <Pegasus/Common/MessageLoader.h>
+
+PEGASUS_USING_STD;
+
+PEGASUS_NAMESPACE_BEGIN
+
+// The pool threads are woken by a tickle when the pool is stopped, so the
+// run timeout only bounds the time between connection timeout checks when a
+// Monitor is otherwise idle.  It is the smallest of the SSL accept timeout
+// and the idleConnectionTimeout, which may be changed while the server runs.
+static Uint32 _getRunTimeoutMilliseconds()
+{
+    Uint32 seconds = PEGASUS_SSL_ACCEPT_TIMEOUT_SECONDS;
+    Uint32 idleConnectionTimeout = HTTPConnection::getIdleConnectionTimeout();
+
+    if (idleConnectionTimeout && idleConnectionTimeout < seconds)
+    {
+        seconds = idleConnectionTimeout;
+    }
+
+    return seconds * 1000;
+}
+
+MonitorPool::MonitorPool(Uint32 numMonitors, AssignmentPolicy policy)
+    : _policy(policy),
+      _nextMonitor(0),
+      _stopThreads(0)
+{
+    PEGASUS_ASSERT(numMonitors > 0);
+
+    _monitors.reserveCapacity(numMonitors);
+    for (Uint32 i = 0; i < numMonitors; i++)
+    {
+        _monitors.append(new Monitor());
+    }
+    _threadParms.reset(new ThreadParm[numMonitors]);
+}
+
+MonitorPool::~MonitorPool()
+{
+    stop();
+
+    for (Uint32 i = 0; i < _monitors.size(); i++)
+    {
+        delete _monitors[i];
+    }
+}
+
+void MonitorPool::start()
+{
+    PEG_METHOD_ENTER(TRC_HTTP, "MonitorPool::start()");
+
+    _stopThreads = 0;
+
+    for (Uint32 i = 0; i < _monitors.size(); i++)
+    {
+        _threadParms[i].pool = this;
+        _threadParms[i].monitor = _monitors[i];
+
+        AutoPtr<Thread> thread(new Thread(_run, &_threadParms[i], false));
+
+        ThreadStatus rtn;
+        while ((rtn = thread->run()) != PEGASUS_THREAD_OK)
+        {
+            if (rtn == PEGASUS_THREAD_INSUFFICIENT_RESOURCES)
+            {
+                Threads::yield();
+            }
+            else
+            {
+                PEG_METHOD_EXIT();
+                throw Exception(MessageLoaderParms(
+                    "Common.MonitorPool.THREAD_CREATE_FAILED",
+                    "Failed to create a connection monitor thread."));
+            }
+        }
+
+        _threads.append(thread.release());
+    }
+
+    PEG_TRACE((TRC_HTTP, Tracer::LEVEL3,
+        "MonitorPool::start - started %u connection monitors",
+        _monitors.size()));
+
+    PEG_METHOD_EXIT();
+}
+
+void MonitorPool::stop()
+{
+    if (_threads.size() == 0)
+    {
+        return;
+    }
+
+    PEG_METHOD_ENTER(TRC_HTTP, "MonitorPool::stop()");
+
+    _stopThreads = 1;
+
+    for (Uint32 i = 0; i < _monitors.size(); i++)
+    {
+        _monitors[i]->tickle();
+    }
+
+    for (Uint32 i = 0; i < _threads.size(); i++)
+    {
+        _threads[i]->join();
+        delete _threads[i];
+    }
+    _threads.clear();
+
+    PEG_METHOD_EXIT();
+}
+
+Monitor* MonitorPool::selectMonitor()
+{
+    Uint32 n = _monitors.size();
+
+    if (_policy == LEAST_LOADED)
+    {
+        // The connection counts are read without locking, so the choice
+        // may be slightly stale under concurrent accepts; that only
+        // affects the balance, not correctness.
+        Uint32 best = 0;
+        Uint32 bestCount = _monitors[0]->getConnectionCount();
+
+        for (Uint32 i = 1; i < n && bestCount; i++)
+        {
+            Uint32 count = _monitors[i]->getConnectionCount();
+            if (count < bestCount)
+            {
+                best = i;
+                bestCount = count;
+            }
+        }
+
+        return _monitors[best];
+    }
+
+    Uint32 next = _nextMonitor.get();
+    _nextMonitor = (next + 1) % n;
+    return _monitors[next % n];
+}
+
+Boolean MonitorPool::parseAssignmentPolicy(
+    const String& value,
+    AssignmentPolicy& policy)
+{
+    if (String::equalNoCase(value, "roundRobin"))
+    {
+        policy = ROUND_ROBIN;
+        return true;
+    }
+
+    if (String::equalNoCase(value, "leastLoaded"))
+    {
+        policy = LEAST_LOADED;
+        return true;
+    }
+
+    return false;
+}
+
+ThreadReturnType PEGASUS_THREAD_CDECL MonitorPool::_run(void* parm)
+{
+    Thread* myself = reinterpret_cast<Thread*>(parm);
+    ThreadParm* threadParm =
+        reinterpret_cast<ThreadParm*>(myself->get_parm());
+
+    while (threadParm->pool->_stopThreads.get() == 0)
+    {
+        try
+        {
+            threadParm->monitor->run(_getRunTimeoutMilliseconds());
+        }
+        catch (Exception& e)
+        {
+            PEG_TRACE((TRC_HTTP, Tracer::LEVEL1,
+                "Exception caught in MonitorPool::_run: %s",
+                (const char*)e.getMessage().getCString()));
+        }
+        catch (...)
+        {
+            PEG_TRACE_CSTRING(TRC_HTTP, Tracer::LEVEL1,
+                "Unknown exception caught in MonitorPool::_run");
+        }
+    }
+
+    return 0;
+}
+
+PEGASUS_NAMESPACE_END
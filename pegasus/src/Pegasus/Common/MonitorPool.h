@@ -0,0 +1,141 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#ifndef Pegasus_MonitorPool_h
+#define Pegasus_MonitorPool_h
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/ArrayInternal.h>
+#include <Pegasus/Common/AtomicInt.h>
+#include <Pegasus/Common/Monitor.h>
+#include <Pegasus/Common/Thread.h>
+#include <Pegasus/Common/AutoPtr.h>
+#include <Pegasus/Common/Linkage.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+/**
+    A MonitorPool is a set of Monitors, each run by its own thread, which
+    service the connections accepted by one or more HTTPAcceptors.  The
+    acceptor sockets themselves remain on the Monitor passed to the
+    HTTPAcceptor constructor.
+
+    Each Monitor in the pool has its own Tickler and entries table, so
+    connections assigned to different Monitors do not contend for the same
+    entries mutex and their read processing runs on separate threads.
+    A new connection is assigned to a Monitor either round-robin or to the
+    Monitor with the fewest connections.
+*/
+class PEGASUS_COMMON_LINKAGE MonitorPool
+{
+public:
+
+    enum AssignmentPolicy
+    {
+        ROUND_ROBIN,
+        LEAST_LOADED
+    };
+
+    /**
+        Constructs a MonitorPool.  The threads are not started until
+        start() is called.
+        @param numMonitors the number of Monitors (and threads) in the pool.
+        @param policy how new connections are assigned to the Monitors.
+    */
+    MonitorPool(Uint32 numMonitors, AssignmentPolicy policy);
+
+    /**
+        Stops the threads (if still running) and deletes the Monitors.
+        All connections must have been unsolicited from the Monitors
+        before the pool is destroyed.
+    */
+    ~MonitorPool();
+
+    /**
+        Starts one thread per Monitor.
+        @exception Exception if a thread cannot be created.
+    */
+    void start();
+
+    /**
+        Stops all threads and waits for them to exit.  The Monitors remain
+        valid until the pool is destroyed.
+    */
+    void stop();
+
+    /**
+        Selects the Monitor for a new connection according to the
+        assignment policy.
+    */
+    Monitor* selectMonitor();
+
+    Uint32 size() const
+    {
+        return _monitors.size();
+    }
+
+    Monitor* getMonitor(Uint32 index)
+    {
+        return _monitors[index];
+    }
+
+    /**
+        Parses the value of the connectionMonitorAssignment config property.
+        @return true if the value is valid.
+    */
+    static Boolean parseAssignmentPolicy(
+        const String& value,
+        AssignmentPolicy& policy);
+
+private:
+
+    MonitorPool(const MonitorPool&);
+    MonitorPool& operator=(const MonitorPool&);
+
+    struct ThreadParm
+    {
+        MonitorPool* pool;
+        Monitor* monitor;
+    };
+
+    static ThreadReturnType PEGASUS_THREAD_CDECL _run(void* parm);
+
+    Array<Monitor*> _monitors;
+    AutoArrayPtr<ThreadParm> _threadParms;
+    Array<Thread*> _threads;
+    AssignmentPolicy _policy;
+    AtomicInt _nextMonitor;
+    AtomicInt _stopThreads;
+};
+
+PEGASUS_NAMESPACE_END
+
+#endif /* Pegasus_MonitorPool_h */
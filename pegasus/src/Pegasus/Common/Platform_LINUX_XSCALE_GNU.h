@@ -89,6 +89,9 @@
 # define PEGASUS_HAS_GETIFADDRS
 #endif
 
+/* epoll() is available on all supported Linux kernels */
+#define PEGASUS_HAS_EPOLL
+
 /* use POSIX read-write locks on this platform */
 #define PEGASUS_USE_POSIX_RWLOCK
 
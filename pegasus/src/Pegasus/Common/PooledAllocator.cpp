@@ -0,0 +1,293 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <new>
+#include <Pegasus/Common/PooledAllocator.h>
+#include <Pegasus/Common/Constants.h>
+#include <Pegasus/Common/Mutex.h>
+#include <Pegasus/Common/Thread.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+// Block sizes are rounded up to a multiple of the granularity, which keeps
+// the blocks aligned for any type.
+static const size_t _GRANULARITY = 16;
+static const size_t _SIZE_CLASSES =
+    PEGASUS_ALLOCATION_POOL_MAX_SIZE / _GRANULARITY;
+
+// Number of blocks moved between a thread free list and the depot at once
+static const Uint32 _BATCH_SIZE = PEGASUS_ALLOCATION_POOL_LIST_SIZE / 2;
+
+// The counts of a thread are added to the global statistics after this
+// many allocations.
+static const Uint32 _STATISTICS_BATCH = 1024;
+
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+struct FreeList
+{
+    FreeBlock* head;
+    Uint32 count;
+};
+
+struct ThreadCache
+{
+    FreeList lists[_SIZE_CLASSES];
+    Uint32 hits;
+    Uint32 misses;
+};
+
+struct Depot
+{
+    Mutex mutex;
+    FreeList list;
+};
+
+static Depot _depots[_SIZE_CLASSES];
+
+static Mutex _statisticsMutex;
+static Uint64 _hits = 0;
+static Uint64 _misses = 0;
+
+// Unlinks up to n blocks from the front of the list and returns them as a
+// chain.
+static FreeBlock* _takeBlocks(FreeList& list, Uint32 n)
+{
+    FreeBlock* first = list.head;
+    FreeBlock* last = 0;
+    Uint32 taken = 0;
+
+    for (FreeBlock* block = first; block && taken < n; block = block->next)
+    {
+        last = block;
+        taken++;
+    }
+
+    if (last)
+    {
+        list.head = last->next;
+        list.count -= taken;
+        last->next = 0;
+    }
+
+    return first;
+}
+
+static void _putBlocks(FreeList& list, FreeBlock* first, Uint32 n)
+{
+    FreeBlock* last = first;
+
+    while (last->next)
+    {
+        last = last->next;
+    }
+
+    last->next = list.head;
+    list.head = first;
+    list.count += n;
+}
+
+static void _deleteBlocks(FreeBlock* block)
+{
+    while (block)
+    {
+        FreeBlock* next = block->next;
+        ::operator delete(block);
+        block = next;
+    }
+}
+
+static void _flushStatistics(ThreadCache* cache)
+{
+    AutoMutex autoMut(_statisticsMutex);
+    _hits += cache->hits;
+    _misses += cache->misses;
+    cache->hits = 0;
+    cache->misses = 0;
+}
+
+// Called when the Thread object is destroyed, returns the cached blocks to
+// the heap.
+static void _deleteThreadCache(void* data)
+{
+    ThreadCache* cache = reinterpret_cast<ThreadCache*>(data);
+
+    _flushStatistics(cache);
+
+    for (size_t i = 0; i < _SIZE_CLASSES; i++)
+    {
+        _deleteBlocks(cache->lists[i].head);
+    }
+
+    ::operator delete(cache);
+}
+
+static ThreadCache* _getThreadCache()
+{
+    Thread* thread = Thread::getCurrent();
+
+    if (!thread)
+    {
+        return 0;
+    }
+
+    ThreadCache* cache = reinterpret_cast<ThreadCache*>(
+        thread->reference_tsd(TSD_ALLOCATION_POOL));
+    thread->dereference_tsd();
+
+    if (!cache)
+    {
+        cache = reinterpret_cast<ThreadCache*>(
+            ::operator new(sizeof(ThreadCache), std::nothrow));
+
+        if (cache)
+        {
+            memset(cache, 0, sizeof(ThreadCache));
+            thread->put_tsd(
+                TSD_ALLOCATION_POOL,
+                _deleteThreadCache,
+                sizeof(ThreadCache),
+                cache);
+        }
+    }
+
+    return cache;
+}
+
+void* PooledAllocator::allocate(size_t size)
+{
+    if (size == 0 || size > PEGASUS_ALLOCATION_POOL_MAX_SIZE)
+    {
+        return ::operator new(size);
+    }
+
+    size_t index = (size - 1) / _GRANULARITY;
+    ThreadCache* cache = _getThreadCache();
+
+    if (!cache)
+    {
+        return ::operator new((index + 1) * _GRANULARITY);
+    }
+
+    FreeList& list = cache->lists[index];
+
+    if (!list.head)
+    {
+        Depot& depot = _depots[index];
+        AutoMutex autoMut(depot.mutex);
+        Uint32 n = depot.list.count < _BATCH_SIZE ?
+            depot.list.count : _BATCH_SIZE;
+
+        if (n)
+        {
+            list.head = _takeBlocks(depot.list, n);
+            list.count = n;
+        }
+    }
+
+    void* ptr = _takeBlocks(list, 1);
+
+    if (ptr)
+    {
+        cache->hits++;
+    }
+    else
+    {
+        ptr = ::operator new((index + 1) * _GRANULARITY);
+        cache->misses++;
+    }
+
+    if (cache->hits + cache->misses >= _STATISTICS_BATCH)
+    {
+        _flushStatistics(cache);
+    }
+
+    return ptr;
+}
+
+void PooledAllocator::deallocate(void* ptr, size_t size)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    if (size == 0 || size > PEGASUS_ALLOCATION_POOL_MAX_SIZE)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    size_t index = (size - 1) / _GRANULARITY;
+    ThreadCache* cache = _getThreadCache();
+
+    if (!cache)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+
+    FreeList& list = cache->lists[index];
+
+    if (list.count >= PEGASUS_ALLOCATION_POOL_LIST_SIZE)
+    {
+        FreeBlock* batch = _takeBlocks(list, _BATCH_SIZE);
+        Depot& depot = _depots[index];
+        {
+            AutoMutex autoMut(depot.mutex);
+
+            if (depot.list.count + _BATCH_SIZE <=
+                PEGASUS_ALLOCATION_POOL_DEPOT_SIZE)
+            {
+                _putBlocks(depot.list, batch, _BATCH_SIZE);
+                batch = 0;
+            }
+        }
+        _deleteBlocks(batch);
+    }
+
+    FreeBlock* block = reinterpret_cast<FreeBlock*>(ptr);
+    block->next = 0;
+    _putBlocks(list, block, 1);
+}
+
+void PooledAllocator::getStatistics(Uint64& hits, Uint64& misses)
+{
+    AutoMutex autoMut(_statisticsMutex);
+    hits = _hits;
+    misses = _misses;
+}
+
+PEGASUS_NAMESPACE_END
@@ -0,0 +1,77 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#ifndef Pegasus_PooledAllocator_h
+#define Pegasus_PooledAllocator_h
+
+#include <cstddef>
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/Linkage.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+/**
+    PooledAllocator provides the memory for the objects that are allocated
+    and released at a high rate while requests pass between the services,
+    the AsyncOpNode and Message objects. These classes route their
+    operator new and delete to it.
+
+    Each Pegasus Thread keeps a free list of released blocks per size class
+    (in its thread specific data), so an allocation is served without any
+    lock whenever the thread has released a block of the same size class
+    before. Since requests are usually allocated by one thread and released
+    by another, a full free list passes half of its blocks to a shared depot
+    and an empty one takes a batch of blocks from the depot, one lock per
+    batch. The blocks beyond the depot capacity
+    (PEGASUS_ALLOCATION_POOL_DEPOT_SIZE per size class), the blocks larger
+    than PEGASUS_ALLOCATION_POOL_MAX_SIZE and all the blocks of the threads
+    that have no Thread object go to the heap.
+*/
+class PEGASUS_COMMON_LINKAGE PooledAllocator
+{
+public:
+
+    static void* allocate(size_t size);
+
+    static void deallocate(void* ptr, size_t size);
+
+    /**
+        Returns the number of allocations served from a free list (hits)
+        and from the heap (misses). The counts of a thread are added in
+        batches, so the most recent allocations of the running threads may
+        not be included yet.
+    */
+    static void getStatistics(Uint64& hits, Uint64& misses);
+};
+
+PEGASUS_NAMESPACE_END
+
+#endif /* Pegasus_PooledAllocator_h */
@@ -32,11 +32,20 @@
 
 #include <Pegasus/Common/SCMOClassCache.h>
 #include <Pegasus/Common/CIMNameCast.h>
+#include <Pegasus/Common/Threads.h>
+#include <cctype>
+#include <cstring>
 
 PEGASUS_NAMESPACE_BEGIN
 
 PEGASUS_USING_STD;
 
+/**
+    Number of hits counted by a reader stripe after which a lookup adds them
+    to the hit statistics, well before the 32 bit counter wraps.
+*/
+#define PEGASUS_SCMO_CLASS_CACHE_HIT_FOLD 0x40000000
+
 SCMOClassCache* SCMOClassCache::_theInstance = 0;
 
 void SCMOClassCache::destroy()
@@ -56,80 +65,278 @@ SCMOClassCache* SCMOClassCache::getInstance()
 
 #ifdef PEGASUS_USE_SCMO_CLASS_CACHE
 
+SCMOClassCache::SCMOClassCache()
+    : _resolveCallBack(NULL),
+      _hits(0),
+      _dying(false)
+{
+    for (Uint32 i = 0; i < PEGASUS_SCMO_CLASS_CACHE_SHARDS; i++)
+    {
+        _shards[i].table = 0;
+        _shards[i].retired = 0;
+        _shards[i].capacity = 0;
+        _shards[i].hand = 0;
+        _shards[i].generation = 0;
+        _shards[i].misses = 0;
+        _shards[i].evictions = 0;
+    }
+
+    setCapacity(PEGASUS_SCMO_CLASS_CACHE_SIZE);
+}
+
 SCMOClassCache::~SCMOClassCache()
 {
     // Signal to all callers and work in progress that the SMOClassCache
     // will be destroyed soon.
-    // As from now, no other caller can get the the lock. They are blocked out.
+    // As from now, no other caller can get a cache entry.
     _dying = true;
 
+    // No modification retires a snapshot after the lock of its shard was
+    // taken here.
+    SCMBClassCacheTable* tables[PEGASUS_SCMO_CLASS_CACHE_SHARDS];
+    SCMBClassCacheTable* retired[PEGASUS_SCMO_CLASS_CACHE_SHARDS];
+
+    for (Uint32 i = 0; i < PEGASUS_SCMO_CLASS_CACHE_SHARDS; i++)
+    {
+        SCMBClassCacheShard& shard = _shards[i];
+        AutoMutex modifyLock(shard.lock);
+
+        tables[i] = shard.table;
+        retired[i] = shard.retired;
+        shard.table = 0;
+        shard.retired = 0;
+    }
+
+    // Wait for the lookups which started before.
+    _synchronize();
+
     // Cleanup the class cache
-    for (Uint32 i = 0 ; i < PEGASUS_SCMO_CLASS_CACHE_SIZE; i++)
+    for (Uint32 i = 0; i < PEGASUS_SCMO_CLASS_CACHE_SHARDS; i++)
     {
-        delete _theCache[i].data;
+        _deleteTable(tables[i], true);
+        _deleteRetired(retired[i]);
     }
 }
 
-Uint64 SCMOClassCache::_generateKey(
-    const char* className,
-    Uint32 classNameLen,
-    const char* nameSpaceName,
-    Uint32 nameSpaceNameLen)
+SCMBClassCacheReaders& SCMOClassCache::_getReaders()
 {
-    Uint64 key = 0;
+    // The address of a local variable identifies the stack of the calling
+    // thread without a system call. Threads sharing a stripe are correct,
+    // they only write to the same cache line.
+    int local;
+    Uint64 x = Uint64((size_t)&local >> 16) *
+        PEGASUS_UINT64_LITERAL(0x9e3779b97f4a7c15);
+
+    return _readers[
+        Uint32(x >> 32) & (PEGASUS_SCMO_CLASS_CACHE_READER_STRIPES - 1)];
+}
 
-    key  =  (Uint64(classNameLen) << 48 ) |
-            (Uint64(className[0]) << 40 ) |
-            (Uint64(className[classNameLen-1]) << 32 ) |
-            (Uint64(nameSpaceNameLen) << 16 ) |
-            (Uint64(nameSpaceName[0]) << 8 ) |
-            Uint64(nameSpaceName[nameSpaceNameLen-1]);
+Boolean SCMOClassCache::_advanceEpoch()
+{
+    // A lookup reads the epoch, increments the counter of its parity and
+    // then reads the snapshot. The epoch advances only once the counters
+    // of the parity the next epoch reuses have drained, so a lookup which
+    // counted itself before a snapshot was retired holds back one of the
+    // two advances after the one that may have checked the counters before
+    // the retirement (see PEGASUS_SCMO_CLASS_CACHE_GRACE_EPOCHS).
 
-    return key;
+    Uint32 parity = (_epoch.get() + 1) & 1;
+
+    for (Uint32 i = 0; i < PEGASUS_SCMO_CLASS_CACHE_READER_STRIPES; i++)
+    {
+        if (_readers[i].active[parity].get() != 0)
+        {
+            return false;
+        }
+    }
+
+    _epoch.inc();
+    return true;
 }
 
-inline Boolean SCMOClassCache::_lockEntry(Uint32 index)
+void SCMOClassCache::_tryAdvanceEpoch()
 {
-    // The lock is implemented as a spin loop, since the action to
-    // verify for the right cache entry is very short.
+    if (_graceLock.try_lock())
+    {
+        _advanceEpoch();
+        _graceLock.unlock();
+    }
+}
+
+void SCMOClassCache::_synchronize()
+{
+    AutoMutex graceLock(_graceLock);
+
+    Uint32 start = _epoch.get();
 
-    if ( _dying )
+    while (_epoch.get() - start < PEGASUS_SCMO_CLASS_CACHE_GRACE_EPOCHS)
     {
-        // The cache is going to be destroyed.
-        // The caller will never get the lock.
-        return false;
+        if (!_advanceEpoch())
+        {
+            Threads::yield();
+        }
     }
+}
+
+SCMBClassCacheTable* SCMOClassCache::_retireTable(
+    SCMBClassCacheShard& shard,
+    SCMBClassCacheTable* table,
+    SCMOClass* removed)
+{
+    table->retiredClass = removed;
+    table->retiredEpoch = _epoch.get();
+    table->nextRetired = shard.retired;
+    shard.retired = table;
 
-    while ( true )
+    SCMBClassCacheTable* reclaimed = 0;
+    SCMBClassCacheTable** link = &shard.retired;
+
+    while (*link)
     {
-        if ( _dying )
+        SCMBClassCacheTable* retired = *link;
+
+        if (_epoch.get() - retired->retiredEpoch >=
+                PEGASUS_SCMO_CLASS_CACHE_GRACE_EPOCHS)
         {
-            // The cache is going to be destroyed.
-            // The caller will never get the lock.
-            break;
+            *link = retired->nextRetired;
+            retired->nextRetired = reclaimed;
+            reclaimed = retired;
         }
+        else
+        {
+            link = &retired->nextRetired;
+        }
+    }
+
+    return reclaimed;
+}
+
+void SCMOClassCache::_deleteRetired(SCMBClassCacheTable* retired)
+{
+    while (retired)
+    {
+        SCMBClassCacheTable* next = retired->nextRetired;
+        delete retired->retiredClass;
+        _deleteTable(retired, false);
+        retired = next;
+    }
+}
+
+SCMBClassCacheTable* SCMOClassCache::_newTable(Uint32 capacity)
+{
+    if (capacity == 0)
+    {
+        return 0;
+    }
+
+    // Use at least two buckets per entry to keep the chains short.
+    Uint32 bucketCount = 1;
+    while (bucketCount < capacity * 2)
+    {
+        bucketCount <<= 1;
+    }
+
+    SCMBClassCacheTable* table = new SCMBClassCacheTable;
+    table->capacity = capacity;
+    table->used = 0;
+    table->bucketMask = bucketCount - 1;
+    table->nextRetired = 0;
+    table->retiredClass = 0;
+    table->retiredEpoch = 0;
+
+    table->entries = new SCMBClassCacheEntry[capacity];
+    for (Uint32 j = 0; j < capacity; j++)
+    {
+        table->entries[j].key = 0;
+        table->entries[j].data = 0;
+        table->entries[j].next = 0;
+    }
+
+    table->buckets = new Uint32[bucketCount];
+    memset(table->buckets, 0, bucketCount * sizeof(Uint32));
+
+    return table;
+}
+
+SCMBClassCacheTable* SCMOClassCache::_copyTable(
+    const SCMBClassCacheTable* table)
+{
+    SCMBClassCacheTable* copy = _newTable(table->capacity);
 
-        // If the lock counter not 1,an other caller is reading the entry.
-        if ( _theCache[index].lock.get() == 1 )
+    copy->used = table->used;
+
+    for (Uint32 j = 0; j < table->used; j++)
+    {
+        copy->entries[j].key = table->entries[j].key;
+        copy->entries[j].data = table->entries[j].data;
+        copy->entries[j].next = table->entries[j].next;
+        copy->entries[j].referenced.set(table->entries[j].referenced.get());
+    }
+
+    memcpy(copy->buckets, table->buckets,
+        (table->bucketMask + 1) * sizeof(Uint32));
+
+    return copy;
+}
+
+void SCMOClassCache::_deleteTable(
+    SCMBClassCacheTable* table,
+    Boolean deleteClasses)
+{
+    if (!table)
+    {
+        return;
+    }
+
+    if (deleteClasses)
+    {
+        for (Uint32 j = 0; j < table->used; j++)
         {
-            // Decrement the atomic lock counter and test if we do have lock:
-            // _theCache[index].lock == 0
-            if ( _theCache[index].lock.decAndTestIfZero() )
-            {
-                // We do have lock!
-                return true;
-            }
+            delete table->entries[j].data;
         }
-        // I did not get the lock. So signal the scheduer to change the active
-        // thread to allow other threads to proceed. This also prevents from
-        // looping in a tight loop that causes a dead look due to the
-        // lock obtaining thread does not get any time ot finsh his work.
-#ifdef PEGASUS_DEBUG
-        _contentionCount.inc();
-#endif
-        Threads::yield();
     }
-    return false;
+
+    delete [] table->entries;
+    delete [] table->buckets;
+    delete table;
+}
+
+Uint64 SCMOClassCache::_generateKey(
+    const char* className,
+    Uint32 classNameLen,
+    const char* nameSpaceName,
+    Uint32 nameSpaceNameLen)
+{
+    // FNV-1a hash of the name space and the class name. Names compare
+    // case insensitive, so US-ASCII characters are hashed as lower case.
+    // Names which differ only in the case of non US-ASCII characters get
+    // different keys; at worst such a class is cached twice.
+
+    Uint64 key = PEGASUS_UINT64_LITERAL(14695981039346656037);
+    const Uint64 prime = PEGASUS_UINT64_LITERAL(1099511628211);
+
+    for (Uint32 i = 0; i < nameSpaceNameLen; i++)
+    {
+        key = (key ^ Uint8(tolower(Uint8(nameSpaceName[i])))) * prime;
+    }
+
+    // Separate the name space from the class name
+    key = (key ^ ':') * prime;
+
+    for (Uint32 i = 0; i < classNameLen; i++)
+    {
+        key = (key ^ Uint8(tolower(Uint8(className[i])))) * prime;
+    }
+
+    // Names often differ in the last characters only, which FNV-1a does
+    // not spread into the upper bits selecting the shard. Mix all bits.
+    key ^= key >> 33;
+    key *= PEGASUS_UINT64_LITERAL(0xff51afd7ed558ccd);
+    key ^= key >> 33;
+    key *= PEGASUS_UINT64_LITERAL(0xc4ceb9fe1a85ec53);
+    key ^= key >> 33;
+
+    return key;
 }
 
 inline Boolean SCMOClassCache::_sameSCMOClass(
@@ -155,73 +362,117 @@ inline Boolean SCMOClassCache::_sameSCMOClass(
     return false;
 }
 
-SCMOClass SCMOClassCache::_addClassToCache(
-        const char* nsName,
-        Uint32 nsNameLen,
-        const char* className,
-        Uint32 classNameLen,
-        Uint64 theKey)
+Uint32 SCMOClassCache::_findEntry(
+    const SCMBClassCacheTable* table,
+    const char* nsName,
+    Uint32 nsNameLen,
+    const char* className,
+    Uint32 classNameLen,
+    Uint64 theKey)
 {
-    WriteLock modifyLock(_modifyCacheLock);
+    if (!table)
+    {
+        return PEG_NOT_FOUND;
+    }
 
-    if ( _dying )
+    Uint32 next = table->buckets[Uint32(theKey) & table->bucketMask];
+
+    while (next != 0)
     {
-        // The cache is going to be destroyed.
-        return SCMOClass();
+        Uint32 index = next - 1;
+        const SCMBClassCacheEntry& entry = table->entries[index];
+
+        // To get sure we found the right class, compare name space
+        // and class name.
+        if (entry.key == theKey &&
+            _sameSCMOClass(nsName,nsNameLen,className,classNameLen,
+                           entry.data))
+        {
+            return index;
+        }
+        next = entry.next;
     }
 
-    Uint32 startIndex =_lastSuccessIndex % PEGASUS_SCMO_CLASS_CACHE_SIZE;
-    Uint32 nextIndex = startIndex;
-    // The number of used entries is form 0 to PEGASUS_SCMO_CLASS_CACHE_SIZE
-    Uint32 usedEntries = _fillingLevel % (PEGASUS_SCMO_CLASS_CACHE_SIZE + 1);
+    return PEG_NOT_FOUND;
+}
+
+SCMOClass* SCMOClassCache::_removeEntry(
+    SCMBClassCacheTable* table,
+    Uint32 index)
+{
+    SCMBClassCacheEntry& entry = table->entries[index];
+
+    // Unlink the entry from its bucket chain
+    Uint32* link = &table->buckets[Uint32(entry.key) & table->bucketMask];
 
-    // This constallation would cause an infitloop below.
-    // A miss read of global variables has happen
-    if (nextIndex > usedEntries)
+    while (*link != index + 1)
     {
-        // start from the beginning
-        startIndex = 0;
-        nextIndex = 0;
+        PEGASUS_ASSERT(*link != 0);
+        link = &table->entries[*link - 1].next;
     }
+    *link = entry.next;
+
+    SCMOClass* data = entry.data;
+    entry.data = 0;
+    entry.key = 0;
+    entry.next = 0;
 
-    // Check the cache if the class was already added while waiting for the
-    // modifyLock.
-    //
-    // Note: The lock for each cache entry must not be obtained,
-    //       because it is used to signal a modify operation, that some
-    //       body is reading it. Due to we are the modify task, we know
-    //       that we are reading the cache entries!
-    //
-    for (Uint32 i = 0; i < usedEntries; i++)
+    return data;
+}
+
+void SCMOClassCache::_compactTable(
+    SCMBClassCacheShard& shard,
+    SCMBClassCacheTable* table,
+    Uint32 index)
+{
+    Uint32 last = table->used - 1;
+
+    if (index != last)
     {
-        // Does the key match for the entry and the requested class ?
-        if (0 != _theCache[nextIndex].key &&
-            theKey == _theCache[nextIndex].key)
+        // Move the last used entry into the freed one and relink it.
+        SCMBClassCacheEntry& from = table->entries[last];
+        SCMBClassCacheEntry& to = table->entries[index];
+
+        Uint32* link = &table->buckets[Uint32(from.key) & table->bucketMask];
+
+        while (*link != last + 1)
         {
-            // To get sure we found the right class, compare name space
-            // and class name.
-            if (_sameSCMOClass(nsName,nsNameLen,className,classNameLen,
-                               _theCache[nextIndex].data))
-            {
-                // The entry was added while waiting for the modify lock.
-                // The modify lock is destroyed automaticaly !
-#ifdef PEGASUS_DEBUG
-                _cacheReadHit++;
-#endif
-                _lastSuccessIndex = nextIndex;
-                return SCMOClass(*_theCache[nextIndex].data);
-            }
+            PEGASUS_ASSERT(*link != 0);
+            link = &table->entries[*link - 1].next;
         }
+        *link = index + 1;
+
+        to.key = from.key;
+        to.data = from.data;
+        to.next = from.next;
+        to.referenced.set(from.referenced.get());
 
-        // go to the next used entries.
-        nextIndex = (nextIndex + 1) % usedEntries;
+        from.key = 0;
+        from.data = 0;
+        from.next = 0;
     }
 
+    table->used--;
+
+    if (shard.hand >= table->used)
+    {
+        shard.hand = 0;
+    }
+}
+
+SCMOClass SCMOClassCache::_addClassToCache(
+        const char* nsName,
+        Uint32 nsNameLen,
+        const char* className,
+        Uint32 classNameLen,
+        Uint64 theKey,
+        Uint32 generation)
+{
     PEGASUS_ASSERT(_resolveCallBack);
 
-#ifdef PEGASUS_DEBUG
-    _cacheReadMiss++;
-#endif
+    // The class is resolved without holding a lock, so a slow repository
+    // does not block the lookups of other classes. If several threads
+    // miss the same class at the same time, the first one adds it.
 
     SCMOClass tmp = _resolveCallBack(
          CIMNamespaceNameCast(String(nsName,nsNameLen)),
@@ -230,49 +481,93 @@ SCMOClass SCMOClassCache::_addClassToCache(
     if (tmp.isEmpty())
     {
          // The requested class was not found !
-         // The modify lock is destroyed automaticaly !
          return SCMOClass();
     }
 
-    SCMOClass* scmoClass = new SCMOClass(tmp);
+    SCMBClassCacheShard& shard = _getShard(theKey);
+    SCMBClassCacheTable* reclaimed = 0;
 
-    _lastWrittenIndex = (_lastWrittenIndex + 1)%PEGASUS_SCMO_CLASS_CACHE_SIZE;
-
-    // Ensure that nobody is reading the enty, so I can write.
-    if (_lockEntry(_lastWrittenIndex))
     {
-        _theCache[_lastWrittenIndex].key = theKey;
+        AutoMutex modifyLock(shard.lock);
 
-        // If the entry was reused, release old object form the cache.
-        if (0 != _theCache[_lastWrittenIndex].data )
+        if ( _dying )
         {
-#ifdef PEGASUS_DEBUG
-            _cacheRemoveLRU++;
-#endif
-            delete _theCache[_lastWrittenIndex].data;
+            // The cache is going to be destroyed.
+            return SCMOClass();
         }
 
-        _theCache[_lastWrittenIndex].data = scmoClass;
+        shard.misses++;
 
-        if (_fillingLevel  < PEGASUS_SCMO_CLASS_CACHE_SIZE)
+        if (!shard.table)
         {
-            _fillingLevel ++;
+            // Caching is disabled.
+            return tmp;
         }
 
-        _lastSuccessIndex = _lastWrittenIndex;
+        if (shard.generation != generation)
+        {
+            // Classes were removed while resolving this one. It may be the
+            // definition before a modification, so it is not cached.
+            return tmp;
+        }
 
-        _unlockEntry(_lastWrittenIndex);
-    }
-    else
-    {
-        // The cache is going to be destroyed.
-        // The lock can not be obtained.
-        delete scmoClass;
-        return SCMOClass();
+        // Check the cache if the class was already added while resolving
+        // it.
+        SCMBClassCacheTable* oldTable = shard.table;
+        SCMOClass* evicted = 0;
+        Uint32 index = _findEntry(
+            oldTable,nsName,nsNameLen,className,classNameLen,theKey);
+
+        if (index != PEG_NOT_FOUND)
+        {
+            oldTable->entries[index].referenced.set(1);
+            return SCMOClass(*oldTable->entries[index].data);
+        }
+
+        SCMBClassCacheTable* table = _copyTable(oldTable);
+
+        if (table->used < table->capacity)
+        {
+            index = table->used++;
+        }
+        else
+        {
+            // The shard is full. Advance the clock hand to the first entry
+            // which was not referenced since the hand passed it last time,
+            // giving each referenced entry a second chance.
+            while (table->entries[shard.hand].referenced.get() != 0)
+            {
+                table->entries[shard.hand].referenced.set(0);
+                shard.hand = (shard.hand + 1) % table->capacity;
+            }
+
+            index = shard.hand;
+            shard.hand = (shard.hand + 1) % table->capacity;
+
+            evicted = _removeEntry(table, index);
+            shard.evictions++;
+        }
+
+        SCMBClassCacheEntry& entry = table->entries[index];
+        Uint32& bucket = table->buckets[Uint32(theKey) & table->bucketMask];
+
+        entry.key = theKey;
+        entry.data = new SCMOClass(tmp);
+        entry.referenced.set(0);
+        entry.next = bucket;
+        bucket = index + 1;
+
+        shard.table = table;
+
+        // The old snapshot is freed once no lookup can read it anymore,
+        // the miss does not wait for that.
+        reclaimed = _retireTable(shard, oldTable, evicted);
     }
 
-    // The modify lock is destroyed automaticaly !
-    return SCMOClass(*scmoClass);
+    _tryAdvanceEpoch();
+    _deleteRetired(reclaimed);
+
+    return tmp;
 }
 
 SCMOClass SCMOClassCache::getSCMOClass(
@@ -281,70 +576,67 @@ SCMOClass SCMOClassCache::getSCMOClass(
         const char* className,
         Uint32 classNameLen)
 {
-    Uint64 theKey;
+    if (nsName && className && nsNameLen && classNameLen)
+    {
+        Uint64 theKey =
+            _generateKey(className,classNameLen,nsName,nsNameLen);
 
-    // Due to the _lastSuccessIndex may contain an invalid value,
-    // use the modulo to ensure it the index is in a valid range.
-    Uint32 startIndex =_lastSuccessIndex % PEGASUS_SCMO_CLASS_CACHE_SIZE;
-    Uint32 nextIndex = startIndex;
-    // The number of used entries form 0 to PEGASUS_SCMO_CLASS_CACHE_SIZE
-    Uint32 usedEntries = _fillingLevel % (PEGASUS_SCMO_CLASS_CACHE_SIZE + 1);
+        SCMBClassCacheShard& shard = _getShard(theKey);
+        SCMBClassCacheReaders& readers = _getReaders();
+        SCMOClass theClass;
 
-    // This constallation would cause an infitloop below.
-    // A miss read of global variables has happen
-    if (nextIndex > usedEntries)
-    {
-        // start from the beginning
-        startIndex = 0;
-        nextIndex = 0;
-    }
+        // A class removed after this point is not cached by this lookup.
+        Uint32 generation = shard.generation;
 
-    if (nsName && className && nsNameLen && classNameLen)
-    {
-      theKey = _generateKey(className,classNameLen,nsName,nsNameLen);
+        // Count the lookup before reading the snapshot, so the snapshot is
+        // not freed while it is read.
+        AtomicInt& active = readers.active[_epoch.get() & 1];
+        active.inc();
 
-      // The counter i is never used as index.
-      // It is used to ensure to look through all used entries.
-      for (Uint32 i = 0; i < usedEntries; i++)
-      {
-          if(_lockEntry(nextIndex))
-          {
-              // does the key match for the entry and the requested class ?
-              if ( 0 != _theCache[nextIndex].key &&
-                  theKey == _theCache[nextIndex].key)
-              {
-                  // To get sure we found the right class, compare name space
-                  // and class name.
-                  if (_sameSCMOClass(nsName,nsNameLen,className,classNameLen,
-                                     _theCache[nextIndex].data))
-                  {
-                      // Yes, we got it !
-                      SCMOClass theClass(*_theCache[nextIndex].data);
-                      _lastSuccessIndex = nextIndex;
-#ifdef PEGASUS_DEBUG
-                       _cacheReadHit++;
-#endif
-                      _unlockEntry(nextIndex);
-                      return theClass;
-                  }
-              }
-              // It was the wrong entry, go to the next.
-              _unlockEntry(nextIndex);
-          }
-          else
-          {
-              // The cache is going to be destroyed.
-              // The lock can not be obtained. Give up.
-              return SCMOClass();
-          }
-          // It was the wrong entry, go to the next used entry..
-          nextIndex = (nextIndex + 1) % usedEntries;
+        if ( _dying )
+        {
+            // The cache is going to be destroyed.
+            active.dec();
+            return SCMOClass();
+        }
+
+        SCMBClassCacheTable* table = shard.table;
+        Uint32 index = _findEntry(
+            table,nsName,nsNameLen,className,classNameLen,theKey);
 
-      }
+        if (index != PEG_NOT_FOUND)
+        {
+            // Yes, we got it !
+            // The flag is only written if it is clear, so the lookups of a
+            // class in use do not write to its entry.
+            SCMBClassCacheEntry& entry = table->entries[index];
+            if (entry.referenced.get() == 0)
+            {
+                entry.referenced.set(1);
+            }
+            theClass = *entry.data;
+        }
+
+        active.dec();
+
+        if (!theClass.isEmpty())
+        {
+            readers.hits.inc();
 
-      // If we end up here, the class is not in the cache !
-      // We have to get it from the repositroy and add it into the cache.
-      return _addClassToCache(nsName,nsNameLen,className,classNameLen,theKey);
+            if (readers.hits.get() >= PEGASUS_SCMO_CLASS_CACHE_HIT_FOLD)
+            {
+                // Add the hits to the statistics before the counter wraps
+                AutoMutex graceLock(_graceLock);
+                _foldHits(readers);
+            }
+
+            return theClass;
+        }
+
+        // If we end up here, the class is not in the cache !
+        // We have to get it from the repositroy and add it into the cache.
+        return _addClassToCache(
+            nsName,nsNameLen,className,classNameLen,theKey,generation);
     }
 
     return SCMOClass();
@@ -360,104 +652,186 @@ void SCMOClassCache::removeSCMOClass(
         return ;
     }
 
-   CString nsName = cimNameSpace.getString().getCString();
-   Uint32 nsNameLen = strlen(nsName);
-   CString clsName = cimClassName.getString().getCString();
-   Uint32 clsNameLen = strlen(clsName);
-
-   // The number of used entries form 0 to PEGASUS_SCMO_CLASS_CACHE_SIZE
-   Uint32 usedEntries = _fillingLevel % (PEGASUS_SCMO_CLASS_CACHE_SIZE + 1);
-
-   Uint64  theKey = _generateKey(clsName,clsNameLen,nsName,nsNameLen);
-
-   // A straight forward loop through all used entries,
-   // ignoring the last success.
-   for (Uint32 i = 0; i < usedEntries; i++)
-   {
-       if(_lockEntry(i))
-       {
-           // does the key match for the entry and the requested class ?
-           if ( 0 != _theCache[i].key && theKey == _theCache[i].key)
-           {
-               // To get sure we found the right class, compare name space
-               // and class name.
-               if (_sameSCMOClass(nsName,nsNameLen,clsName,clsNameLen,
-                                  _theCache[i].data))
-               {
-                   // Yes, we got it !
-                   _theCache[i].key = 0;
-                   delete _theCache[i].data;
-                   _theCache[i].data = 0;
-                   _unlockEntry(i);
-                   return;
-               }
-           }
-           // It was the wrong entry, go to the next.
-           _unlockEntry(i);
-       }
-       else
-       {
-           // We do not get the lock, if the cache is going to be destroyed.
-           return;
-       }
-   }
+    CString nsName = cimNameSpace.getString().getCString();
+    Uint32 nsNameLen = strlen(nsName);
+    CString clsName = cimClassName.getString().getCString();
+    Uint32 clsNameLen = strlen(clsName);
+
+    Uint64  theKey = _generateKey(clsName,clsNameLen,nsName,nsNameLen);
+
+    SCMBClassCacheShard& shard = _getShard(theKey);
+    SCMBClassCacheTable* reclaimed = 0;
+
+    {
+        AutoMutex modifyLock(shard.lock);
+
+        if ( _dying )
+        {
+            // The cache is going to be destroyed.
+            return ;
+        }
+
+        // Even if the class is not cached, a thread may be resolving it.
+        shard.generation++;
+
+        Uint32 index = _findEntry(
+            shard.table,nsName,nsNameLen,clsName,clsNameLen,theKey);
+
+        if (index == PEG_NOT_FOUND)
+        {
+            return;
+        }
+
+        SCMBClassCacheTable* oldTable = shard.table;
+        SCMBClassCacheTable* table = _copyTable(oldTable);
+        SCMOClass* removed = _removeEntry(table, index);
+        _compactTable(shard, table, index);
+        shard.table = table;
+
+        reclaimed = _retireTable(shard, oldTable, removed);
+    }
+
+    _tryAdvanceEpoch();
+    _deleteRetired(reclaimed);
 }
 
 void SCMOClassCache::clear()
 {
-    WriteLock modifyLock(_modifyCacheLock);
+    SCMBClassCacheTable* oldTables[PEGASUS_SCMO_CLASS_CACHE_SHARDS];
 
-    if ( _dying )
+    for (Uint32 i = 0; i < PEGASUS_SCMO_CLASS_CACHE_SHARDS; i++)
     {
-        // The cache is going to be destroyed.
-        return ;
+        SCMBClassCacheShard& shard = _shards[i];
+        AutoMutex modifyLock(shard.lock);
+
+        oldTables[i] = 0;
+
+        if ( _dying )
+        {
+            // The cache is going to be destroyed.
+            continue;
+        }
+
+        oldTables[i] = shard.table;
+        shard.table = _newTable(shard.capacity);
+        shard.hand = 0;
+        shard.generation++;
     }
 
-    // The number of used entries form 0 to PEGASUS_SCMO_CLASS_CACHE_SIZE
-    Uint32 usedEntries = _fillingLevel % (PEGASUS_SCMO_CLASS_CACHE_SIZE + 1);
+    _synchronize();
+
+    for (Uint32 i = 0; i < PEGASUS_SCMO_CLASS_CACHE_SHARDS; i++)
+    {
+        _deleteTable(oldTables[i], true);
+    }
+}
+
+void SCMOClassCache::setCapacity(Uint32 capacity)
+{
+    Uint32 shardCapacity =
+        (capacity + PEGASUS_SCMO_CLASS_CACHE_SHARDS - 1) /
+            PEGASUS_SCMO_CLASS_CACHE_SHARDS;
+
+    SCMBClassCacheTable* oldTables[PEGASUS_SCMO_CLASS_CACHE_SHARDS];
+
+    for (Uint32 i = 0; i < PEGASUS_SCMO_CLASS_CACHE_SHARDS; i++)
+    {
+        SCMBClassCacheShard& shard = _shards[i];
+        AutoMutex modifyLock(shard.lock);
+
+        oldTables[i] = 0;
+
+        if ( _dying )
+        {
+            // The cache is going to be destroyed.
+            continue;
+        }
+
+        oldTables[i] = shard.table;
+        shard.table = _newTable(shardCapacity);
+        shard.capacity = shardCapacity;
+        shard.hand = 0;
+        shard.generation++;
+        shard.misses = 0;
+        shard.evictions = 0;
+    }
 
-    // A straight forwar loop through all used entries,
-    // ignoring the last success.
-    for (Uint32 i = 0; i < usedEntries; i++)
     {
-        if(_lockEntry(i))
+        AutoMutex graceLock(_graceLock);
+        _hits = 0;
+
+        for (Uint32 i = 0; i < PEGASUS_SCMO_CLASS_CACHE_READER_STRIPES; i++)
         {
-            _theCache[i].key = 0;
-            delete _theCache[i].data;
-            _theCache[i].data = 0;
-            _unlockEntry(i);
+            _readers[i].hits.set(0);
         }
-        else
+    }
+
+    _synchronize();
+
+    for (Uint32 i = 0; i < PEGASUS_SCMO_CLASS_CACHE_SHARDS; i++)
+    {
+        _deleteTable(oldTables[i], true);
+    }
+}
+
+void SCMOClassCache::getStatistics(
+    Uint32& size,
+    Uint32& capacity,
+    Uint64& hits,
+    Uint64& misses,
+    Uint64& evictions)
+{
+    size = 0;
+    capacity = 0;
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+
+    for (Uint32 i = 0; i < PEGASUS_SCMO_CLASS_CACHE_SHARDS; i++)
+    {
+        SCMBClassCacheShard& shard = _shards[i];
+        AutoMutex modifyLock(shard.lock);
+
+        if (shard.table)
         {
-            // We do not get the lock, if the cache is going to be destroyed.
-            return;
+            size += shard.table->used;
         }
+        capacity += shard.capacity;
+        misses += shard.misses;
+        evictions += shard.evictions;
     }
-    // Reset all controll data
-    _fillingLevel = 0;
-    _lastSuccessIndex = 0;
-    _lastWrittenIndex = PEGASUS_SCMO_CLASS_CACHE_SIZE-1;
 
+    AutoMutex graceLock(_graceLock);
+    hits = _hits;
 
+    for (Uint32 i = 0; i < PEGASUS_SCMO_CLASS_CACHE_READER_STRIPES; i++)
+    {
+        hits += _readers[i].hits.get();
+    }
 }
+
 #ifdef PEGASUS_DEBUG
 void SCMOClassCache::DisplayCacheStatistics()
 {
+    Uint32 size;
+    Uint32 capacity;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 evictions;
+
+    getStatistics(size, capacity, hits, misses, evictions);
+
     PEGASUS_STD(cout) << "SCMOClass Cache Statistics:" <<
         PEGASUS_STD(endl);
     PEGASUS_STD(cout) << "  Size (current/max): " <<
-        _fillingLevel << "/" << PEGASUS_SCMO_CLASS_CACHE_SIZE <<
-        PEGASUS_STD(endl);
+        size << "/" << capacity << PEGASUS_STD(endl);
     PEGASUS_STD(cout) << "  Requests satisfied from cache: " <<
-        _cacheReadHit << PEGASUS_STD(endl);
+        hits << PEGASUS_STD(endl);
     PEGASUS_STD(cout) << "  Requests *not* satisfied from cache: " <<
-        _cacheReadMiss << " (implies write to cache)" << PEGASUS_STD(endl);
+        misses << " (implies write to cache)" << PEGASUS_STD(endl);
     PEGASUS_STD(cout) <<
         "  Cache entries \"aged out\" due to cache size constraints: " <<
-        _cacheRemoveLRU << PEGASUS_STD(endl);
-    PEGASUS_STD(cout) << "  Number of lock contentions: " <<
-        _contentionCount.get() << PEGASUS_STD(endl);
-
+        evictions << PEGASUS_STD(endl);
 }
 #endif
 
@@ -479,7 +853,7 @@ SCMOClass SCMOClassCache::getSCMOClass(
               CIMNamespaceNameCast(String(nsName,nsNameLen)),
               CIMNameCast(String(className,classNameLen)));
 
-          if (tmp->isEpmpty())
+          if (tmp.isEmpty())
           {
                // The requested class was not found !
                // The modify lock is destroyed automaticaly !
@@ -504,6 +878,24 @@ void SCMOClassCache::clear()
 {
 }
 
+void SCMOClassCache::setCapacity(Uint32 capacity)
+{
+}
+
+void SCMOClassCache::getStatistics(
+    Uint32& size,
+    Uint32& capacity,
+    Uint64& hits,
+    Uint64& misses,
+    Uint64& evictions)
+{
+    size = 0;
+    capacity = 0;
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+}
+
 #  ifdef PEGASUS_DEBUG
 void SCMOClassCache::DisplayCacheStatistics(){}
 #  endif
@@ -33,8 +33,10 @@
 
 #include <Pegasus/Common/Linkage.h>
 #include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/Constants.h>
+#include <Pegasus/Common/AtomicInt.h>
 #include <Pegasus/Common/CIMClass.h>
-#include <Pegasus/Common/ReadWriteSem.h>
+#include <Pegasus/Common/Mutex.h>
 #include <Pegasus/Common/SCMOClass.h>
 
 PEGASUS_NAMESPACE_BEGIN
@@ -45,31 +47,126 @@ typedef SCMOClass (*SCMOClassCacheCallbackPtr)(
 
 //==============================================================================
 //
-// The class cache caches up PEGASUS_SCMO_CLASS_CACHE_SIZE SCMOClass
-// definitions in memory.  To override the default, define
-// PEGASUS_SCMO_CLASS_CACHE_SIZE in your build environment.
+// The class cache caches up to PEGASUS_SCMO_CLASS_CACHE_SIZE SCMOClass
+// definitions in memory until the capacity is set at runtime by setCapacity().
+// The cimserver and the provider agents set it from the scmoClassCacheSize
+// config property.
+// To override the default, define PEGASUS_SCMO_CLASS_CACHE_SIZE in your build
+// environment.
 // The functionality to deliver SCMOClass is needed anyway but the cache can be
 // degrated to a pass through functionality.
 // To suppress caching set PEGASUS_SCMO_CLASS_CACHE_SIZE to 0 in your build
 // environment.
+//
+// The cache is divided into PEGASUS_SCMO_CLASS_CACHE_SHARDS shards, selected
+// by a hash of the name space and class name. Each shard is a hash table
+// which is published as a snapshot that is not modified anymore, in the
+// manner of read-copy-update. A lookup takes no lock: it counts itself in a
+// reader counter, reads the current snapshot of the shard and copies the
+// SCMOClass. The reader counters are striped by thread, so the lookups of
+// different threads do not write to the same cache line. A modification
+// copies the snapshot under the mutex of the shard and publishes the copy.
+// The old snapshot and the classes removed from it are freed after a grace
+// period, once every lookup that may still read them has finished. Classes
+// are added once and removed rarely, so copying is cheap compared to the
+// lookups it keeps lock-free. When a shard is full, the entry to replace is
+// chosen with the CLOCK algorithm: a hit sets the reference flag of the
+// entry and the clock hand passes over (and clears) referenced entries once
+// before it evicts one.
+//
+// Adding or removing a class does not wait for a grace period. The replaced
+// snapshot is retired to a list of its shard, stamped with the epoch of the
+// cache. Each modification tries to advance the epoch, which succeeds if no
+// lookup counts itself under the parity of the previous epoch, and frees
+// the retired snapshots of its shard which are
+// PEGASUS_SCMO_CLASS_CACHE_GRACE_EPOCHS epochs old. The remaining ones are
+// freed when the cache is destroyed.
+//
+// A class is resolved without a lock held. Each removal of classes from a
+// shard increments the generation of the shard, and a class resolved while
+// the generation changed is returned but not cached, since it may predate
+// the removal.
+//
 //==============================================================================
 
 #if !defined(PEGASUS_SCMO_CLASS_CACHE_SIZE)
-# define PEGASUS_SCMO_CLASS_CACHE_SIZE 32
+# define PEGASUS_SCMO_CLASS_CACHE_SIZE PEGASUS_DEFAULT_SCMO_CLASS_CACHE_SIZE
 #endif
 
 #if (PEGASUS_SCMO_CLASS_CACHE_SIZE != 0)
 # define PEGASUS_USE_SCMO_CLASS_CACHE
 #endif
 
+// The number of shards must be a power of 2
+#define PEGASUS_SCMO_CLASS_CACHE_SHARDS 16
+
+// The number of stripes of reader counters, a power of 2
+#define PEGASUS_SCMO_CLASS_CACHE_READER_STRIPES 32
+
+// The number of epochs after which a retired snapshot is freed. The first
+// epoch may have been advanced over a check made before the snapshot was
+// retired, the other two wait for the lookups of either parity.
+#define PEGASUS_SCMO_CLASS_CACHE_GRACE_EPOCHS 3
+
 struct SCMBClassCacheEntry
 {
-    // Spin-lock to serialize the access to the entry
-    AtomicInt lock;
-    // The key to identify the entry
+    // The hash of name space and class name which identifies the entry
     Uint64    key;
     // Pointer to the cached SCMOClass
     SCMOClass* data;
+    // Reference flag of the CLOCK algorithm, set by each hit
+    AtomicInt referenced;
+    // Index + 1 of the next entry in the same hash bucket, 0 ends the chain
+    Uint32    next;
+};
+
+struct SCMBClassCacheTable
+{
+    // The cache entries, capacity elements. Entries 0 to used-1 are in use.
+    SCMBClassCacheEntry* entries;
+    // The maximum number of entries.
+    Uint32 capacity;
+    // The hash buckets: index + 1 of the first entry of the bucket chain.
+    Uint32* buckets;
+    // The number of buckets - 1. The number of buckets is a power of 2.
+    Uint32 bucketMask;
+    // The number of used entries.
+    Uint32 used;
+    // Once the snapshot is retired: the next retired snapshot of the shard,
+    // the SCMOClass removed with it or 0, and the epoch it was retired at.
+    SCMBClassCacheTable* nextRetired;
+    SCMOClass* retiredClass;
+    Uint32 retiredEpoch;
+};
+
+struct SCMBClassCacheShard
+{
+    // Serializes the modifications of the shard.
+    Mutex lock;
+    // The current snapshot, read without a lock. 0 if caching is disabled.
+    SCMBClassCacheTable* volatile table;
+    // The snapshots replaced by the modifications, not freed yet.
+    SCMBClassCacheTable* retired;
+    // The maximum number of entries of this shard.
+    Uint32 capacity;
+    // The position of the clock hand.
+    Uint32 hand;
+    // Incremented whenever classes are removed from the shard.
+    Uint32 generation;
+    // Statistical data, the hits are counted by the reader stripes.
+    Uint64 misses;
+    Uint64 evictions;
+};
+
+struct SCMBClassCacheReaders
+{
+    // The number of lookups in progress which started while the epoch of
+    // the cache was even or odd.
+    AtomicInt active[2];
+    // Hits not yet added to the hit statistics.
+    AtomicInt hits;
+    // Keeps the counters of the stripes on different cache lines.
+    char unused[64];
 };
 
 class PEGASUS_COMMON_LINKAGE SCMOClassCache
@@ -110,6 +207,32 @@ public:
      **/
     void clear();
 
+    /**
+     * Sets the maximum number of SCMOClass definitions held by the cache.
+     * The capacity is rounded up to a multiple of
+     * PEGASUS_SCMO_CLASS_CACHE_SHARDS. A capacity of 0 disables caching.
+     * The cache is cleared and its statistics are reset.
+     * @param capacity The maximum number of cached SCMOClass definitions.
+     */
+    void setCapacity(Uint32 capacity);
+
+    /**
+     * Returns the statistics of the cache.
+     * @param size Returns the number of cached SCMOClass definitions.
+     * @param capacity Returns the maximum number of cached definitions.
+     * @param hits Returns the number of requests satisfied from the cache.
+     * @param misses Returns the number of requests *not* satisfied from
+     *        the cache.
+     * @param evictions Returns the number of entries replaced due to the
+     *        cache size constraints.
+     */
+    void getStatistics(
+        Uint32& size,
+        Uint32& capacity,
+        Uint64& hits,
+        Uint64& misses,
+        Uint64& evictions);
+
     /**
      * Returns the pointer to an instance of SCMOClassCache.
      */
@@ -140,56 +263,25 @@ private:
 
 #ifdef PEGASUS_USE_SCMO_CLASS_CACHE
 
-    // The cache array
-    SCMBClassCacheEntry _theCache[PEGASUS_SCMO_CLASS_CACHE_SIZE];
+    // The shards of the cache
+    SCMBClassCacheShard _shards[PEGASUS_SCMO_CLASS_CACHE_SHARDS];
 
-    // Lock to prevent parallel modifications of the cache.
-    ReadWriteSem _modifyCacheLock;
+    // The reader counters of the lookups
+    SCMBClassCacheReaders _readers[PEGASUS_SCMO_CLASS_CACHE_READER_STRIPES];
 
-    // Last successful read index.
-    Uint32 _lastSuccessIndex;
+    // The parity of the epoch selects the counters new lookups increment.
+    AtomicInt _epoch;
 
-    // Last successful written cache index.
-    Uint32 _lastWrittenIndex;
+    // Serializes the advances of the epoch and guards _hits.
+    Mutex _graceLock;
 
-    // Counter of used cache entries.
-    Uint32 _fillingLevel;
+    // The hits added from the reader stripes.
+    Uint64 _hits;
 
     // Indicator for destruction of the cache.
     Boolean _dying;
 
-#  ifdef PEGASUS_DEBUG
-    // Statistical data
-    Uint32 _cacheReadHit;
-    Uint32 _cacheReadMiss;
-    Uint32 _cacheRemoveLRU;
-    AtomicInt _contentionCount;
-#  endif
-
-    SCMOClassCache()
-        : _resolveCallBack(NULL),
-          _lastSuccessIndex(0),
-          _lastWrittenIndex(PEGASUS_SCMO_CLASS_CACHE_SIZE-1),
-          _fillingLevel(0),
-          _dying(false)
-    {
-        // intialize the the cache
-        for (Uint32 i = 0 ; i < PEGASUS_SCMO_CLASS_CACHE_SIZE; i++)
-        {
-            _theCache[i].data = 0;
-            _theCache[i].key = 0;
-            // set the lock counter to 1 to allow one next user to enter.
-            _theCache[i].lock.set(1);
-        }
-#  ifdef PEGASUS_DEBUG
-        // Statistical data
-        _cacheReadHit = 0;
-        _cacheReadMiss = 0;
-        _cacheRemoveLRU = 0;
-        _contentionCount.set(0);
-#  endif
-
-    };
+    SCMOClassCache();
 
     // clean-up cache data
     ~SCMOClassCache();
@@ -207,28 +299,115 @@ private:
         Uint32 classNameLen,
         SCMOClass* theClass);
 
-    SCMOClass _addClassToCache(
-            const char* nsName,
-            Uint32 nsNameLen,
-            const char* className,
-            Uint32 classNameLen,
-            Uint64 theKey);
+    SCMBClassCacheShard& _getShard(Uint64 theKey)
+    {
+        return _shards[(theKey >> 32) & (PEGASUS_SCMO_CLASS_CACHE_SHARDS-1)];
+    }
 
+    /**
+     * Returns the reader counters of the calling thread.
+     **/
+    SCMBClassCacheReaders& _getReaders();
+
+    /**
+     * Advances the epoch unless a lookup still counts itself under the
+     * parity of the previous epoch. The caller holds _graceLock.
+     * @return true if the epoch was advanced.
+     **/
+    Boolean _advanceEpoch();
+
+    /**
+     * Advances the epoch if no other thread is advancing it. Does not wait.
+     **/
+    void _tryAdvanceEpoch();
 
     /**
-     * Get a lock on a cache entry.
-     * @return true if the lock was optained
-     *         false if the lock was NOT optained, give up !!!
+     * Waits until all lookups which may read a snapshot that is no longer
+     * published have finished. The caller holds no shard lock.
      **/
-    Boolean _lockEntry(Uint32 index);
+    void _synchronize();
 
-    void _unlockEntry(Uint32 index)
+    /**
+     * Retires the replaced snapshot of the shard, along with the SCMOClass
+     * removed from it, and unlinks the retired snapshots which no lookup
+     * can read anymore. The caller holds the lock of the shard.
+     * @return The unlinked snapshots, to be freed by _deleteRetired().
+     **/
+    SCMBClassCacheTable* _retireTable(
+        SCMBClassCacheShard& shard,
+        SCMBClassCacheTable* table,
+        SCMOClass* removed);
+
+    /**
+     * Frees a list of retired snapshots and their removed SCMOClasses.
+     **/
+    static void _deleteRetired(SCMBClassCacheTable* retired);
+
+    /**
+     * Allocates an empty snapshot, or returns 0 if capacity is 0.
+     **/
+    static SCMBClassCacheTable* _newTable(Uint32 capacity);
+
+    /**
+     * Returns a copy of the snapshot which shares its SCMOClasses.
+     **/
+    static SCMBClassCacheTable* _copyTable(const SCMBClassCacheTable* table);
+
+    /**
+     * Frees the snapshot, and its SCMOClasses if deleteClasses is true.
+     **/
+    static void _deleteTable(SCMBClassCacheTable* table, Boolean deleteClasses);
+
+    /**
+     * Looks for the class in the snapshot.
+     * @return The index of the entry or PEG_NOT_FOUND.
+     **/
+    Uint32 _findEntry(
+        const SCMBClassCacheTable* table,
+        const char* nsName,
+        Uint32 nsNameLen,
+        const char* className,
+        Uint32 classNameLen,
+        Uint64 theKey);
+
+    /**
+     * Removes the entry from its hash bucket chain of a snapshot which is
+     * not yet published.
+     * @return The SCMOClass of the entry, to be freed after a grace period.
+     **/
+    static SCMOClass* _removeEntry(SCMBClassCacheTable* table, Uint32 index);
+
+    /**
+     * Frees the entry by moving the last used entry of the snapshot, which
+     * is not yet published, in its place.
+     **/
+    static void _compactTable(
+        SCMBClassCacheShard& shard,
+        SCMBClassCacheTable* table,
+        Uint32 index);
+
+    /**
+     * Adds the hits counted by the reader stripe to the hit statistics.
+     * Hits the stripe counts meanwhile may be lost. The caller holds
+     * _graceLock.
+     **/
+    void _foldHits(SCMBClassCacheReaders& readers)
     {
-        // set the lock counter to 1 to allow one next user to enter
-        // the critical section.
-        _theCache[index].lock.set(1);
+        _hits += readers.hits.get();
+        readers.hits.set(0);
+    }
 
-    };
+    /**
+     * Resolves the class and adds it to the cache unless the generation of
+     * its shard differs from the given one.
+     **/
+    SCMOClass _addClassToCache(
+            const char* nsName,
+            Uint32 nsNameLen,
+            const char* className,
+            Uint32 classNameLen,
+            Uint64 theKey,
+            Uint32 generation);
 #endif
 };
 
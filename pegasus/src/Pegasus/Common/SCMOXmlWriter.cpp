@@ -48,6 +48,61 @@ void SCMOXmlWriter::appendValueSCMOInstanceElement(
     out << STRLIT("</VALUE.NAMEDINSTANCE>\n");
 }
 
+// The estimated size of the markup and the name of a property or key
+// binding, and of the markup of an instance element
+static const Uint32 _PROPERTY_XML_SIZE = 80;
+static const Uint32 _KEYBINDING_XML_SIZE = 64;
+static const Uint32 _INSTANCE_XML_SIZE = 128;
+
+Uint64 SCMOXmlWriter::estimateInstanceElementsSize(
+    const Array<SCMOInstance>& scmoInstances)
+{
+    Uint64 size = 0;
+    const SCMBClass_Main* lastClass = 0;
+
+    for (Uint32 i = 0, n = scmoInstances.size(); i < n; i++)
+    {
+        const SCMOInstance& scmoInstance = scmoInstances[i];
+
+        // The used instance memory holds the values and the key bindings,
+        // the string values are written as they are. It includes the
+        // property nodes, which are about the size of the other values
+        // written.
+        const SCMBMgmt_Header& header = scmoInstance.inst.hdr->header;
+        size += header.totalSize - header.freeBytes;
+
+        Uint32 len;
+        scmoInstance.getClassName_l(len);
+        size += _INSTANCE_XML_SIZE + 2 * len;
+        size += scmoInstance.getKeyBindingCount() * _KEYBINDING_XML_SIZE;
+
+        Uint32 properties = scmoInstance.getPropertyCount();
+        size += properties * _PROPERTY_XML_SIZE;
+
+        if (scmoInstance.inst.hdr->flags.includeClassOrigin)
+        {
+            size += properties * _PROPERTY_XML_SIZE / 2;
+        }
+
+        // The qualifiers are written from the class, whose memory holds
+        // them along with the property definitions. It is counted once for
+        // each run of instances of the same class only, as it is far larger
+        // than the qualifiers written with a single instance.
+        const SCMBClass_Main* theClass =
+            scmoInstance.inst.hdr->theClass.ptr->cls.hdr;
+
+        if (scmoInstance.inst.hdr->flags.includeQualifiers &&
+            theClass != lastClass)
+        {
+            const SCMBMgmt_Header& classHeader = theClass->header;
+            size += classHeader.totalSize - classHeader.freeBytes;
+            lastClass = theClass;
+        }
+    }
+
+    return size;
+}
+
 void SCMOXmlWriter::appendInstanceNameElement(
     Buffer& out,
     const SCMOInstance& scmoInstance)
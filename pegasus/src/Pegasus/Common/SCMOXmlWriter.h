@@ -54,6 +54,15 @@ public:
         Buffer& out,
         const SCMOInstance& scmoInstance);
 
+    /**
+        Returns an estimate of the size of the VALUE.NAMEDINSTANCE or
+        VALUE.OBJECTWITHPATH elements of the instances. It is used to
+        reserve the output buffer for a set of instances at once, rather
+        than to grow it while they are written.
+     */
+    static Uint64 estimateInstanceElementsSize(
+        const Array<SCMOInstance>& scmoInstances);
+
     static void appendInstanceElement(
         Buffer& out,
         const SCMOInstance& scmoInstance);
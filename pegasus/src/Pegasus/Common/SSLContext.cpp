@@ -46,6 +46,7 @@
 #include <Pegasus/Common/Tracer.h>
 #include <Pegasus/Common/FileSystem.h>
 #include <Pegasus/Common/MessageLoader.h>
+#include <Pegasus/Common/Constants.h>
 
 #include "SSLContext.h"
 #include "SSLContextRep.h"
@@ -82,6 +83,11 @@ const int SSLCallbackInfo::SSL_CALLBACK_INDEX = 0;
 //
 #ifdef PEGASUS_HAS_SSL
 
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+# define SSL_SESSION_up_ref(session) \
+    CRYPTO_add(&(session)->references, 1, CRYPTO_LOCK_SSL_SESSION)
+#endif
+
 AutoArrayPtr<Mutex> SSLEnvironmentInitializer::_sslLocks;
 int SSLEnvironmentInitializer::_instanceCount = 0;
 Mutex SSLEnvironmentInitializer::_instanceCountMutex;
@@ -509,6 +515,11 @@ SSLContextRep::SSLContextRep(
     //
     _verifyPeer = (trustStore != String::EMPTY || verifyCert != NULL);
 
+    _sessionCacheSize = 0;
+    _sessionTimeout = 0;
+    _sessionTickets = false;
+    _clientSessions.reset(new SSLClientSessionCache());
+
     _randomInit(randomFile);
 
     _sslContext = _makeSSLContext();
@@ -527,9 +538,24 @@ SSLContextRep::SSLContextRep(const SSLContextRep& sslContextRep)
     _verifyPeer = sslContextRep._verifyPeer;
     _certificateVerifyFunction = sslContextRep._certificateVerifyFunction;
     _randomFile = sslContextRep._randomFile;
+    _sessionCacheSize = 0;
+    _sessionTimeout = 0;
+    _sessionTickets = false;
+
+    // The copies used by the clients for each connection share the sessions,
+    // so that repeated connections to a server are resumed
+    _clientSessions = sslContextRep._clientSessions;
 
     _sslContext = _makeSSLContext();
 
+    if (sslContextRep._sessionTimeout)
+    {
+        setSessionCacheParameters(
+            sslContextRep._sessionCacheSize,
+            sslContextRep._sessionTimeout,
+            sslContextRep._sessionTickets);
+    }
+
     PEG_METHOD_EXIT();
 }
 
@@ -546,6 +572,61 @@ SSLContextRep::~SSLContextRep()
     PEG_METHOD_EXIT();
 }
 
+//
+// Client session cache
+//
+
+SSLClientSessionCache::~SSLClientSessionCache()
+{
+    for (Uint32 i = 0; i < _sessions.size(); i++)
+    {
+        SSL_SESSION_free(_sessions[i]);
+    }
+}
+
+SSL_SESSION* SSLClientSessionCache::get(const String& peerName)
+{
+    AutoMutex autoMut(_mutex);
+
+    for (Uint32 i = 0; i < _peerNames.size(); i++)
+    {
+        if (_peerNames[i] == peerName)
+        {
+            SSL_SESSION_up_ref(_sessions[i]);
+            return _sessions[i];
+        }
+    }
+
+    return 0;
+}
+
+void SSLClientSessionCache::set(const String& peerName, SSL_SESSION* session)
+{
+    AutoMutex autoMut(_mutex);
+
+    for (Uint32 i = 0; i < _peerNames.size(); i++)
+    {
+        if (_peerNames[i] == peerName)
+        {
+            SSL_SESSION_free(_sessions[i]);
+            _peerNames.remove(i);
+            _sessions.remove(i);
+            break;
+        }
+    }
+
+    if (_sessions.size() == PEGASUS_MAX_SSL_CLIENT_SESSIONS)
+    {
+        SSL_SESSION_free(_sessions[0]);
+        _peerNames.remove(0);
+        _sessions.remove(0);
+    }
+
+    SSL_SESSION_up_ref(session);
+    _peerNames.append(peerName);
+    _sessions.append(session);
+}
+
 //
 // initialize OpenSSL's PRNG
 //
@@ -1097,6 +1178,110 @@ SSLCertificateVerifyFunction*
     return _certificateVerifyFunction;
 }
 
+void SSLContextRep::setSessionCacheParameters(
+    Uint32 cacheSize,
+    Uint32 timeoutSeconds,
+    Boolean enableTickets)
+{
+    PEG_METHOD_ENTER(TRC_SSL, "SSLContextRep::setSessionCacheParameters()");
+
+    PEG_TRACE((TRC_SSL, Tracer::LEVEL3,
+        "---> SSL: Session cache size %u, timeout %u seconds, tickets %s",
+        cacheSize,
+        timeoutSeconds,
+        enableTickets ? "enabled" : "disabled"));
+
+    _sessionCacheSize = cacheSize;
+    _sessionTimeout = timeoutSeconds;
+    _sessionTickets = enableTickets;
+
+    // A session is only resumed in the context it was established in.
+    // OpenSSL refuses to resume sessions of verified peers without an id.
+    static const unsigned char sessionIdContext[] = "Pegasus";
+    SSL_CTX_set_session_id_context(
+        _sslContext, sessionIdContext, sizeof(sessionIdContext) - 1);
+
+    SSL_CTX_set_timeout(_sslContext, (long)timeoutSeconds);
+
+    if (cacheSize)
+    {
+        SSL_CTX_sess_set_cache_size(_sslContext, (long)cacheSize);
+        SSL_CTX_set_session_cache_mode(_sslContext, SSL_SESS_CACHE_SERVER);
+
+#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+        // The connections are closed without close_notify alert (quiet
+        // shutdown), which OpenSSL otherwise treats as an error that
+        // removes the session from the cache
+        SSL_CTX_set_options(_sslContext, SSL_OP_IGNORE_UNEXPECTED_EOF);
+#endif
+    }
+    else
+    {
+        SSL_CTX_set_session_cache_mode(_sslContext, SSL_SESS_CACHE_OFF);
+    }
+
+#ifdef SSL_OP_NO_TICKET
+    if (enableTickets)
+    {
+        SSL_CTX_clear_options(_sslContext, SSL_OP_NO_TICKET);
+        _setTicketKeys();
+    }
+    else
+    {
+        SSL_CTX_set_options(_sslContext, SSL_OP_NO_TICKET);
+    }
+#endif
+
+    PEG_METHOD_EXIT();
+}
+
+void SSLContextRep::flushSessions()
+{
+    PEG_METHOD_ENTER(TRC_SSL, "SSLContextRep::flushSessions()");
+
+    // A time of 0 removes all sessions, expired or not
+    SSL_CTX_flush_sessions(_sslContext, 0);
+
+    if (_sessionTickets)
+    {
+        _setTicketKeys();
+    }
+
+    PEG_METHOD_EXIT();
+}
+
+//
+// Replaces the keys that encrypt the session tickets with random ones,
+// which invalidates the tickets issued so far.
+//
+void SSLContextRep::_setTicketKeys()
+{
+#ifdef SSL_CTRL_SET_TLSEXT_TICKET_KEYS
+    unsigned char keys[128];
+
+    // The key length differs between the OpenSSL versions
+    long length = SSL_CTX_get_tlsext_ticket_keys(_sslContext, NULL, 0);
+
+    if (length <= 0 || length > (long)sizeof(keys) ||
+        RAND_bytes(keys, (int)length) != 1 ||
+        !SSL_CTX_set_tlsext_ticket_keys(_sslContext, keys, length))
+    {
+        PEG_TRACE_CSTRING(TRC_SSL, Tracer::LEVEL1,
+            "---> SSL: Could not replace the session ticket keys, "
+                "disabling session tickets.");
+        SSL_CTX_set_options(_sslContext, SSL_OP_NO_TICKET);
+        _sessionTickets = false;
+    }
+
+    memset(keys, 0, sizeof(keys));
+#endif
+}
+
+SSLClientSessionCache* SSLContextRep::getClientSessionCache() const
+{
+    return _clientSessions.get();
+}
+
 void SSLContextRep::validateCertificate()
 {
     BIO* in = BIO_new_file(_certPath.getCString(), "r");
@@ -1188,6 +1373,15 @@ SSLCertificateVerifyFunction*
 
 void SSLContextRep::validateCertificate() { }
 
+void SSLContextRep::setSessionCacheParameters(
+    Uint32 cacheSize,
+    Uint32 timeoutSeconds,
+    Boolean enableTickets)
+{
+}
+
+void SSLContextRep::flushSessions() { }
+
 #endif // end of PEGASUS_HAS_SSL
 
 ///////////////////////////////////////////////////////////////////////////////
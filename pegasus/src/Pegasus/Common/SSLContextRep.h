@@ -196,6 +196,54 @@ private:
 
 #endif
 
+#ifdef PEGASUS_HAS_SSL
+/**
+    Converts an ASN1 time of a certificate to a CIMDateTime.
+*/
+CIMDateTime getDateTime(const ASN1_UTCTIME* utcTime);
+#endif
+
+#ifdef PEGASUS_HAS_SSL
+/**
+    Sessions of the client connections of an SSLContext and its copies, one
+    per server (host:port), kept for the resumption of the next connection
+    to the same server.  The oldest server is dropped when
+    PEGASUS_MAX_SSL_CLIENT_SESSIONS servers are cached.
+*/
+class SSLClientSessionCache
+{
+public:
+
+    SSLClientSessionCache() { }
+
+    ~SSLClientSessionCache();
+
+    /**
+        Gets the session of the specified server.
+        @return the session, which must be freed by the caller, or NULL.
+    */
+    SSL_SESSION* get(const String& peerName);
+
+    /**
+        Keeps a reference to the session of the specified server, replacing
+        the previous one.
+    */
+    void set(const String& peerName, SSL_SESSION* session);
+
+private:
+
+    SSLClientSessionCache(const SSLClientSessionCache&);
+    SSLClientSessionCache& operator=(const SSLClientSessionCache&);
+
+    /**
+        The servers and their sessions, most recently stored last.
+    */
+    Array<String> _peerNames;
+    Array<SSL_SESSION*> _sessions;
+    Mutex _mutex;
+};
+#endif
+
 class SSLCallbackInfoRep
 {
 public:
@@ -266,6 +314,34 @@ public:
     */
     void validateCertificate();
 
+    /**
+        Configures the resumption of the TLS sessions of the connections
+        accepted with this context.
+        @param cacheSize  number of sessions kept in the session cache,
+        0 disables the session cache.
+        @param timeoutSeconds  lifetime of a cached session or ticket.
+        @param enableTickets  specifies whether session tickets are issued.
+    */
+    void setSessionCacheParameters(
+        Uint32 cacheSize,
+        Uint32 timeoutSeconds,
+        Boolean enableTickets);
+
+    /**
+        Discards the cached sessions and replaces the session ticket keys,
+        so that no session established before the call is resumed.  Must
+        be called when the trust store or the CRL store changes.
+    */
+    void flushSessions();
+
+#ifdef PEGASUS_HAS_SSL
+    /**
+        Gets the sessions of the client connections, shared with the
+        copies of this context.
+    */
+    SSLClientSessionCache* getClientSessionCache() const;
+#endif
+
 private:
 
 #ifdef PEGASUS_HAS_SSL
@@ -277,6 +353,7 @@ private:
 #endif
 
     SSL_CTX * _makeSSLContext();
+    void _setTicketKeys();
     void _randomInit(const String& randomFile);
     Boolean _verifyPrivateKey(SSL_CTX *ctx, const String& keyPath);
 
@@ -292,6 +369,14 @@ private:
     SSLCertificateVerifyFunction* _certificateVerifyFunction;
 
     SharedPtr<X509_STORE, FreeX509STOREPtr> _crlStore;
+
+    Uint32 _sessionCacheSize;
+    Uint32 _sessionTimeout;
+    Boolean _sessionTickets;
+
+#ifdef PEGASUS_HAS_SSL
+    SharedPtr<SSLClientSessionCache> _clientSessions;
+#endif
 };
 
 PEGASUS_NAMESPACE_END
@@ -40,11 +40,23 @@
 #include <Pegasus/Common/Threads.h>
 #include <Pegasus/Common/Mutex.h>
 
+#ifndef PEGASUS_OS_TYPE_WINDOWS
+# include <sys/uio.h>
+# include <limits.h>
+#endif
+
 PEGASUS_NAMESPACE_BEGIN
 
 #ifdef PEGASUS_OS_TYPE_WINDOWS
 static Uint32 _socketInterfaceRefCount = 0;
 static Mutex _socketInterfaceRefCountLock;
+#else
+// The number of segments passed to one writev() call
+# if defined(IOV_MAX) && IOV_MAX < 64
+static const Uint32 _MAX_WRITE_SEGMENTS = IOV_MAX;
+# else
+static const Uint32 _MAX_WRITE_SEGMENTS = 64;
+# endif
 #endif
 
 Boolean Socket::timedConnect(
@@ -231,6 +243,140 @@ Sint32 Socket::timedWrite(
     }
 }
 
+Sint32 Socket::timedWritev(
+    SocketHandle socket,
+    const SocketWriteSegment* segments,
+    Uint32 count,
+    Uint32 socketWriteTimeout,
+    Uint32 maxWriteSize)
+{
+    PEGASUS_ASSERT(maxWriteSize > 0);
+
+#ifdef PEGASUS_OS_TYPE_WINDOWS
+    Sint32 totalBytesWritten = 0;
+
+    for (Uint32 i = 0; i < count; i++)
+    {
+        for (Uint32 offset = 0; offset < segments[i].size; )
+        {
+            Uint32 size = segments[i].size - offset;
+            if (size > maxWriteSize)
+            {
+                size = maxWriteSize;
+            }
+
+            Sint32 bytesWritten = timedWrite(
+                socket,
+                (const char*)segments[i].data + offset,
+                size,
+                socketWriteTimeout);
+
+            if (bytesWritten == PEGASUS_SOCKET_ERROR)
+            {
+                return bytesWritten;
+            }
+            totalBytesWritten += bytesWritten;
+            offset += size;
+        }
+    }
+
+    return totalBytesWritten;
+#else
+    struct iovec iov[_MAX_WRITE_SEGMENTS];
+    Sint32 totalBytesWritten = 0;
+    Boolean socketTimedOut = false;
+    int selreturn = 0;
+
+    // index and offset of the first byte not yet written
+    Uint32 index = 0;
+    Uint32 offset = 0;
+
+    while (1)
+    {
+        Uint32 iovCount = 0;
+        Uint32 iovSize = 0;
+
+        for (Uint32 i = index;
+             i < count && iovCount < _MAX_WRITE_SEGMENTS &&
+                 iovSize < maxWriteSize;
+             i++)
+        {
+            Uint32 skip = (i == index) ? offset : 0;
+
+            if (segments[i].size > skip)
+            {
+                Uint32 size = segments[i].size - skip;
+                if (size > maxWriteSize - iovSize)
+                {
+                    size = maxWriteSize - iovSize;
+                }
+
+                iov[iovCount].iov_base = (char*)segments[i].data + skip;
+                iov[iovCount].iov_len = size;
+                iovCount++;
+                iovSize += size;
+            }
+        }
+
+        // All data written ? return amount of data written
+        if (iovCount == 0)
+        {
+            return totalBytesWritten;
+        }
+
+        Sint32 bytesWritten;
+        PEGASUS_RETRY_SYSTEM_CALL(
+            ::writev(socket, iov, iovCount), bytesWritten);
+
+        // Advance past the written data and resume writing the rest
+        if (bytesWritten > 0)
+        {
+            totalBytesWritten += bytesWritten;
+            socketTimedOut = false;
+
+            Uint32 written = (Uint32)bytesWritten;
+
+            while (written > 0)
+            {
+                Uint32 remaining = segments[index].size - offset;
+
+                if (written < remaining)
+                {
+                    offset += written;
+                    written = 0;
+                }
+                else
+                {
+                    written -= remaining;
+                    index++;
+                    offset = 0;
+                }
+            }
+            continue;
+        }
+        // Something went wrong
+        if (bytesWritten == PEGASUS_SOCKET_ERROR)
+        {
+            // if we already waited for the socket to get ready, bail out
+            if (socketTimedOut) return bytesWritten;
+
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                fd_set fdwrite;
+                 // max. timeout seconds waiting for the socket to get ready
+                struct timeval tv = { socketWriteTimeout, 0 };
+                FD_ZERO(&fdwrite);
+                FD_SET(socket, &fdwrite);
+                selreturn = select(FD_SETSIZE, NULL, &fdwrite, NULL, &tv);
+                if (selreturn == 0) socketTimedOut = true; // ran out of time
+                continue;
+            }
+            return bytesWritten;
+        }
+    }
+#endif
+}
+
 void Socket::close(SocketHandle& socket)
 {
     if (socket != PEGASUS_INVALID_SOCKET)
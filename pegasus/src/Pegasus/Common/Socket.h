@@ -43,6 +43,15 @@
 
 PEGASUS_NAMESPACE_BEGIN
 
+/**
+    Describes one contiguous piece of data of a gathered socket write.
+*/
+struct SocketWriteSegment
+{
+    const char* data;
+    Uint32 size;
+};
+
 class Socket
 {
 public:
@@ -75,6 +84,21 @@ public:
                              Uint32 size,
                              Uint32 socketWriteTimeout);
 
+    /**
+        Writes the specified segments in order, as if they were one
+        contiguous buffer, using as few system calls as possible (writev).
+        Like timedWrite(), partial writes are resumed and a blocked socket
+        is waited on for up to socketWriteTimeout seconds.
+        @param maxWriteSize The maximum number of bytes passed to one
+            system call.  Some platforms fail socket writes larger than 64K.
+        @return The total number of bytes written, or PEGASUS_SOCKET_ERROR.
+    */
+    static Sint32 timedWritev(SocketHandle socket,
+                              const SocketWriteSegment* segments,
+                              Uint32 count,
+                              Uint32 socketWriteTimeout,
+                              Uint32 maxWriteSize);
+
     /**
         Closes a specified socket.  If successful, the socket handle is set to
         PEGASUS_INVALID_SOCKET.
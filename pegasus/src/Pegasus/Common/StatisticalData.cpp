@@ -31,9 +31,612 @@
 
 #include "StatisticalData.h"
 #include "Tracer.h"
+#include "Thread.h"
+#include "AtomicInt.h"
+#include "ArrayInternal.h"
 
 PEGASUS_NAMESPACE_BEGIN
 
+////////////////////////////////////////////////////////////////////////////////
+//
+// StatisticalHistogram
+//
+////////////////////////////////////////////////////////////////////////////////
+
+StatisticalHistogram::StatisticalHistogram()
+{
+    clear();
+}
+
+void StatisticalHistogram::merge(const StatisticalHistogram& x)
+{
+    for (Uint32 i = 0; i < NUMBER_OF_BUCKETS; i++)
+    {
+        _buckets[i] += x._buckets[i];
+    }
+}
+
+void StatisticalHistogram::clear()
+{
+    memset(_buckets, 0, sizeof(_buckets));
+}
+
+Uint64 StatisticalHistogram::getCount() const
+{
+    Uint64 count = 0;
+
+    for (Uint32 i = 0; i < NUMBER_OF_BUCKETS; i++)
+    {
+        count += _buckets[i];
+    }
+
+    return count;
+}
+
+Uint64 StatisticalHistogram::getPercentile(Uint32 permille) const
+{
+    // The buckets are summed rather than counted on add() so the rank is
+    // consistent with the buckets while the owning thread keeps recording
+    Uint64 count = getCount();
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    Uint64 rank = (count * permille + 999) / 1000;
+
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    Uint64 sum = 0;
+
+    for (Uint32 i = 0; i < NUMBER_OF_BUCKETS; i++)
+    {
+        sum += _buckets[i];
+
+        if (sum >= rank)
+        {
+            return getBucketValue(i);
+        }
+    }
+
+    return getBucketValue(NUMBER_OF_BUCKETS - 1);
+}
+
+Uint32 StatisticalHistogram::getBucket(Uint64 value)
+{
+    if (value < 8)
+    {
+        return Uint32(value);
+    }
+
+    // Position of the most significant bit, at least 3
+    Uint32 msb = 0;
+    Uint64 x = value;
+
+    if (x >> 32)
+    {
+        x >>= 32;
+        msb += 32;
+    }
+    if (x >> 16)
+    {
+        x >>= 16;
+        msb += 16;
+    }
+    if (x >> 8)
+    {
+        x >>= 8;
+        msb += 8;
+    }
+    if (x >> 4)
+    {
+        x >>= 4;
+        msb += 4;
+    }
+    if (x >> 2)
+    {
+        x >>= 2;
+        msb += 2;
+    }
+    if (x >> 1)
+    {
+        msb += 1;
+    }
+
+    // The two bits below the most significant bit select the sub-bucket
+    return 8 + (msb - 3) * 4 + Uint32((value >> (msb - 2)) & 3);
+}
+
+Uint64 StatisticalHistogram::getBucketValue(Uint32 bucket)
+{
+    if (bucket < 8)
+    {
+        return bucket;
+    }
+
+    Uint32 shift = (bucket - 8) / 4 + 1;
+    Uint64 low = Uint64(4 + (bucket - 8) % 4) << shift;
+
+    return low + ((Uint64(1) << shift) >> 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Per thread histograms
+//
+// Each Pegasus thread records into histograms and sums of its own, which are
+// found through its thread specific data.  Only the owning thread writes the
+// counts of its histograms and its sums, so it records a value without a
+// lock.  The mutex of the thread data is taken when the thread adds a
+// histogram, clears its histograms or folds its counts, and while the
+// histograms and sums are read.  The data of exited threads and of threads
+// without a Thread object are kept in _sharedData, which is guarded by
+// _histogramMutex like the list of the thread data.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Counts of a histogram written by one thread and read by others.  The counts
+// are AtomicInts, so a reader never sees a torn count; as only the owner
+// writes them, it adds to a count with a plain load and store.  Before a
+// count can wrap the owner folds the counts into the 64-bit histogram,
+// holding the mutex of its data.
+class StatisticalThreadHistogram
+{
+public:
+
+    StatisticalThreadHistogram()
+    {
+        clear();
+    }
+
+    // Returns true when the counts must be folded
+    Boolean add(Uint64 value)
+    {
+        Uint32 bucket = StatisticalHistogram::getBucket(value);
+        Uint32 count = _counts[bucket].get() + 1;
+        _counts[bucket].set(count);
+        return count >= _FOLD_COUNT;
+    }
+
+    void fold()
+    {
+        for (Uint32 i = 0; i < StatisticalHistogram::NUMBER_OF_BUCKETS; i++)
+        {
+            _folded.addCount(i, _counts[i].get());
+            _counts[i].set(0);
+        }
+    }
+
+    void merge(const StatisticalHistogram& x)
+    {
+        _folded.merge(x);
+    }
+
+    // Adds the counts to the histogram
+    void get(StatisticalHistogram& x) const
+    {
+        x.merge(_folded);
+
+        for (Uint32 i = 0; i < StatisticalHistogram::NUMBER_OF_BUCKETS; i++)
+        {
+            x.addCount(i, _counts[i].get());
+        }
+    }
+
+    void clear()
+    {
+        for (Uint32 i = 0; i < StatisticalHistogram::NUMBER_OF_BUCKETS; i++)
+        {
+            _counts[i].set(0);
+        }
+
+        _folded.clear();
+    }
+
+private:
+
+    enum { _FOLD_COUNT = 0x80000000 };
+
+    AtomicInt _counts[StatisticalHistogram::NUMBER_OF_BUCKETS];
+    StatisticalHistogram _folded;
+};
+
+// Sum of the values recorded by one thread, kept like the counts of a
+// StatisticalThreadHistogram: the owner adds to a 32-bit AtomicInt and folds
+// it into the 64-bit sum, holding the mutex of its data, before it can wrap.
+class StatisticalThreadSum
+{
+public:
+
+    StatisticalThreadSum()
+    {
+        clear();
+    }
+
+    // Returns false when the value does not fit in the 32-bit sum; it is
+    // then added by fold()
+    Boolean add(Sint64 value)
+    {
+        if (value < 0 || value >= _FOLD_SUM)
+        {
+            return false;
+        }
+
+        Uint32 sum = _sum.get() + Uint32(value);
+
+        if (sum >= _FOLD_SUM)
+        {
+            return false;
+        }
+
+        _sum.set(sum);
+        return true;
+    }
+
+    void fold(Sint64 value)
+    {
+        _folded += Sint64(_sum.get()) + value;
+        _sum.set(0);
+    }
+
+    Sint64 get() const
+    {
+        return _folded + Sint64(_sum.get());
+    }
+
+    void clear()
+    {
+        _sum.set(0);
+        _folded = 0;
+    }
+
+private:
+
+    enum { _FOLD_SUM = 0x80000000 };
+
+    AtomicInt _sum;
+    Sint64 _folded;
+};
+
+// The shares of a thread in the sums of StatisticalData
+struct StatisticalThreadSumSet
+{
+    StatisticalThreadSum numCalls;
+    StatisticalThreadSum cimomTime;
+    StatisticalThreadSum providerTime;
+    StatisticalThreadSum responseSize;
+    StatisticalThreadSum requestSize;
+
+    void clear()
+    {
+        numCalls.clear();
+        cimomTime.clear();
+        providerTime.clear();
+        responseSize.clear();
+        requestSize.clear();
+    }
+};
+
+struct StatisticalThreadHistogramSet
+{
+    StatisticalThreadHistogram serverTime;
+    StatisticalThreadHistogram providerTime;
+    StatisticalThreadHistogram responseSize;
+    StatisticalThreadSumSet sums;
+};
+
+struct StatisticalThreadData
+{
+    StatisticalThreadData() : generation(0)
+    {
+        memset(types, 0, sizeof(types));
+    }
+
+    ~StatisticalThreadData()
+    {
+        for (Uint32 i = 0; i < StatisticalData::NUMBER_OF_TYPES; i++)
+        {
+            delete types[i];
+        }
+
+        for (Uint32 i = 0; i < modules.size(); i++)
+        {
+            delete modules[i];
+        }
+    }
+
+    // The histograms are discarded when the generation of the thread data
+    // is not the current one
+    Uint32 generation;
+    Mutex mutex;
+    StatisticalThreadHistogramSet* types[StatisticalData::NUMBER_OF_TYPES];
+    Array<String> moduleNames;
+    Array<StatisticalThreadHistogram*> modules;
+};
+
+static Mutex _histogramMutex;
+static Uint32 _histogramGeneration = 0;
+static Array<StatisticalThreadData*> _threadData;
+static StatisticalThreadData _sharedData;
+
+static void _clearHistograms(StatisticalThreadData* data)
+{
+    for (Uint32 i = 0; i < StatisticalData::NUMBER_OF_TYPES; i++)
+    {
+        if (data->types[i])
+        {
+            data->types[i]->serverTime.clear();
+            data->types[i]->providerTime.clear();
+            data->types[i]->responseSize.clear();
+            data->types[i]->sums.clear();
+        }
+    }
+
+    for (Uint32 i = 0; i < data->modules.size(); i++)
+    {
+        data->modules[i]->clear();
+    }
+}
+
+static void _mergeHistograms(
+    const StatisticalThreadData* data,
+    StatisticalHistogramSet* types,
+    Array<String>& moduleNames,
+    Array<StatisticalHistogram>& modules)
+{
+    for (Uint32 i = 0; i < StatisticalData::NUMBER_OF_TYPES; i++)
+    {
+        if (data->types[i])
+        {
+            data->types[i]->serverTime.get(types[i].serverTime);
+            data->types[i]->providerTime.get(types[i].providerTime);
+            data->types[i]->responseSize.get(types[i].responseSize);
+        }
+    }
+
+    for (Uint32 i = 0; i < data->moduleNames.size(); i++)
+    {
+        Uint32 j = 0;
+
+        while (j < moduleNames.size() && moduleNames[j] != data->moduleNames[i])
+        {
+            j++;
+        }
+
+        if (j == moduleNames.size())
+        {
+            moduleNames.append(data->moduleNames[i]);
+            modules.append(StatisticalHistogram());
+        }
+
+        data->modules[i]->get(modules[j]);
+    }
+}
+
+static void _addSums(const StatisticalThreadData* data, StatisticalData* sd)
+{
+    for (Uint32 i = 0; i < StatisticalData::NUMBER_OF_TYPES; i++)
+    {
+        if (data->types[i])
+        {
+            const StatisticalThreadSumSet& sums = data->types[i]->sums;
+            sd->numCalls[i] += sums.numCalls.get();
+            sd->cimomTime[i] += sums.cimomTime.get();
+            sd->providerTime[i] += sums.providerTime.get();
+            sd->responseSize[i] += sums.responseSize.get();
+            sd->requestSize[i] += sums.requestSize.get();
+        }
+    }
+}
+
+// Returns the histograms of the request type, allocating them on first use.
+// Only the thread owning the data (or, for _sharedData, the holder of
+// _histogramMutex) allocates histograms, the mutex of the data keeps the
+// readers from seeing them while they are added.
+static StatisticalThreadHistogramSet* _getTypeHistograms(
+    StatisticalThreadData* data,
+    Uint16 type)
+{
+    if (!data->types[type])
+    {
+        StatisticalThreadHistogramSet* set = new StatisticalThreadHistogramSet;
+        AutoMutex autoMut(data->mutex);
+        data->types[type] = set;
+    }
+
+    return data->types[type];
+}
+
+static StatisticalThreadHistogram* _getModuleHistogram(
+    StatisticalThreadData* data,
+    const String& moduleName)
+{
+    for (Uint32 i = 0; i < data->moduleNames.size(); i++)
+    {
+        if (data->moduleNames[i] == moduleName)
+        {
+            return data->modules[i];
+        }
+    }
+
+    StatisticalThreadHistogram* histogram = new StatisticalThreadHistogram;
+    AutoMutex autoMut(data->mutex);
+    data->moduleNames.append(moduleName);
+    data->modules.append(histogram);
+
+    return histogram;
+}
+
+// Adds the counts of an exited thread to a histogram of _sharedData
+static void _mergeHistogram(
+    StatisticalThreadHistogram* histogram,
+    const StatisticalThreadHistogram& x)
+{
+    StatisticalHistogram counts;
+    x.get(counts);
+    AutoMutex autoMut(_sharedData.mutex);
+    histogram->merge(counts);
+}
+
+// Adds the sums of an exited thread to the sums of _sharedData
+static void _mergeSums(
+    StatisticalThreadSumSet* sums,
+    const StatisticalThreadSumSet& x)
+{
+    AutoMutex autoMut(_sharedData.mutex);
+    sums->numCalls.fold(x.numCalls.get());
+    sums->cimomTime.fold(x.cimomTime.get());
+    sums->providerTime.fold(x.providerTime.get());
+    sums->responseSize.fold(x.responseSize.get());
+    sums->requestSize.fold(x.requestSize.get());
+}
+
+// Called when the Thread object is destroyed, keeps the recorded values in
+// the shared histograms.
+static void _deleteThreadData(void* ptr)
+{
+    StatisticalThreadData* data = reinterpret_cast<StatisticalThreadData*>(ptr);
+
+    {
+        AutoMutex autoMut(_histogramMutex);
+
+        for (Uint32 i = 0; i < _threadData.size(); i++)
+        {
+            if (_threadData[i] == data)
+            {
+                _threadData.remove(i);
+                break;
+            }
+        }
+
+        if (data->generation == _histogramGeneration)
+        {
+            for (Uint16 i = 0; i < StatisticalData::NUMBER_OF_TYPES; i++)
+            {
+                if (data->types[i])
+                {
+                    StatisticalThreadHistogramSet* set =
+                        _getTypeHistograms(&_sharedData, i);
+                    _mergeHistogram(&set->serverTime,
+                        data->types[i]->serverTime);
+                    _mergeHistogram(&set->providerTime,
+                        data->types[i]->providerTime);
+                    _mergeHistogram(&set->responseSize,
+                        data->types[i]->responseSize);
+                    _mergeSums(&set->sums, data->types[i]->sums);
+                }
+            }
+
+            for (Uint32 i = 0; i < data->moduleNames.size(); i++)
+            {
+                _mergeHistogram(
+                    _getModuleHistogram(&_sharedData, data->moduleNames[i]),
+                    *data->modules[i]);
+            }
+        }
+    }
+
+    delete data;
+}
+
+// Returns the histograms of the current thread, or 0 if the thread has no
+// Thread object.
+static StatisticalThreadData* _getThreadData()
+{
+    Thread* thread = Thread::getCurrent();
+
+    if (!thread)
+    {
+        return 0;
+    }
+
+    StatisticalThreadData* data = reinterpret_cast<StatisticalThreadData*>(
+        thread->reference_tsd(TSD_STATISTICAL_HISTOGRAMS));
+    thread->dereference_tsd();
+
+    if (!data)
+    {
+        data = new StatisticalThreadData;
+        {
+            AutoMutex autoMut(_histogramMutex);
+            data->generation = _histogramGeneration;
+            _threadData.append(data);
+        }
+        thread->put_tsd(
+            TSD_STATISTICAL_HISTOGRAMS,
+            _deleteThreadData,
+            sizeof(StatisticalThreadData),
+            data);
+    }
+    else if (data->generation != _histogramGeneration)
+    {
+        // The statistics were reset since the thread last recorded a value
+        AutoMutex autoMut(_histogramMutex);
+        AutoMutex dataMut(data->mutex);
+        _clearHistograms(data);
+        data->generation = _histogramGeneration;
+    }
+
+    return data;
+}
+
+static void _addToHistogram(
+    StatisticalThreadData* data,
+    StatisticalThreadHistogram& histogram,
+    Sint64 value)
+{
+    if (value >= 0 && histogram.add(Uint64(value)))
+    {
+        AutoMutex autoMut(data->mutex);
+        histogram.fold();
+    }
+}
+
+static void _addToSum(
+    StatisticalThreadData* data,
+    StatisticalThreadSum& sum,
+    Sint64 value)
+{
+    if (!sum.add(value))
+    {
+        AutoMutex autoMut(data->mutex);
+        sum.fold(value);
+    }
+}
+
+static void _addValue(
+    StatisticalThreadData* data,
+    Uint16 type,
+    Uint32 t,
+    Sint64 value)
+{
+    StatisticalThreadHistogramSet* set = _getTypeHistograms(data, type);
+
+    switch (t)
+    {
+        case StatisticalData::PEGASUS_STATDATA_SERVER:
+            _addToSum(data, set->sums.numCalls, 1);
+            _addToSum(data, set->sums.cimomTime, value);
+            _addToHistogram(data, set->serverTime, value);
+            break;
+        case StatisticalData::PEGASUS_STATDATA_PROVIDER:
+            _addToSum(data, set->sums.providerTime, value);
+            _addToHistogram(data, set->providerTime, value);
+            break;
+        case StatisticalData::PEGASUS_STATDATA_BYTES_SENT:
+            _addToSum(data, set->sums.responseSize, value);
+            _addToHistogram(data, set->responseSize, value);
+            break;
+        case StatisticalData::PEGASUS_STATDATA_BYTES_READ:
+            _addToSum(data, set->sums.requestSize, value);
+            break;
+    }
+}
+
 
 // The table on the right represents the mapping from the enumerated types
 // in the CIM_CIMOMStatisticalDate class ValueMap versus the internal
@@ -114,57 +717,129 @@ void StatisticalData::addToValue(Sint64 value, Uint16 type, Uint32 t)
 
     if (copyGSD)
     {
-        AutoMutex autoMut(_mutex);
-        switch (t)
-        {
-            case PEGASUS_STATDATA_SERVER:
-                numCalls[type] += 1;
-                cimomTime[type] += value;
-                PEG_TRACE((TRC_STATISTICAL_DATA, Tracer::LEVEL4,
-                    "StatData: SERVER: %s(%d): count = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d; value = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d; total = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d",
-                    (const char *)requestName[type].getCString(), type,
-                    numCalls[type], value, cimomTime[type]));
-                break;
-            case PEGASUS_STATDATA_PROVIDER:
-                providerTime[type] += value;
-                PEG_TRACE((TRC_STATISTICAL_DATA, Tracer::LEVEL4,
-                    "StatData: PROVIDER: %s(%d): count = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d; value = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d; total = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d",
-                    (const char *)requestName[type].getCString(), type,
-                    numCalls[type], value, providerTime[type]));
-                break;
-        case PEGASUS_STATDATA_BYTES_SENT:
-                responseSize[type] += value;
-                PEG_TRACE((TRC_STATISTICAL_DATA, Tracer::LEVEL4,
-                    "StatData: BYTES_SENT: %s(%d): count = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d; value = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d; total = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d",
-                    (const char *)requestName[type].getCString(), type,
-                    numCalls[type], value, responseSize[type]));
-                break;
-        case PEGASUS_STATDATA_BYTES_READ:
-                requestSize[type] += value;
-                PEG_TRACE((TRC_STATISTICAL_DATA, Tracer::LEVEL4,
-                    "StatData: BYTES_READ: %s(%d): count = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d; value = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d; total = %"
-                        PEGASUS_64BIT_CONVERSION_WIDTH "d",
-                    (const char *)requestName[type].getCString(), type,
-                    numCalls[type], value, requestSize[type]));
-                break;
+        StatisticalThreadData* data = _getThreadData();
+
+        if (data)
+        {
+            _addValue(data, type, t, value);
+        }
+        else
+        {
+            AutoMutex autoMut(_histogramMutex);
+            _addValue(&_sharedData, type, t, value);
+        }
+
+        static const char* valueNames[] =
+            { "SERVER", "PROVIDER", "BYTES_SENT", "BYTES_READ" };
+
+        if (t <= PEGASUS_STATDATA_BYTES_READ)
+        {
+            PEG_TRACE((TRC_STATISTICAL_DATA, Tracer::LEVEL4,
+                "StatData: %s: %s(%d): value = %"
+                    PEGASUS_64BIT_CONVERSION_WIDTH "d",
+                valueNames[t], (const char *)requestName[type].getCString(),
+                type, value));
         }
     }
 }
 
 void StatisticalData::setCopyGSD(Boolean flag)
 {
+    if (flag && !copyGSD)
+    {
+        // Gathering restarts with empty histograms, the threads discard
+        // their histograms when they next record a value
+        AutoMutex autoMut(_histogramMutex);
+        _histogramGeneration++;
+        _clearHistograms(&_sharedData);
+    }
+
     copyGSD = flag;
 }
 
+void StatisticalData::addToModuleValue(const String& moduleName, Sint64 value)
+{
+    if (!copyGSD || value < 0)
+    {
+        return;
+    }
+
+    StatisticalThreadData* data = _getThreadData();
+
+    if (data)
+    {
+        _addToHistogram(
+            data, *_getModuleHistogram(data, moduleName), value);
+    }
+    else
+    {
+        AutoMutex autoMut(_histogramMutex);
+        _addToHistogram(
+            &_sharedData, *_getModuleHistogram(&_sharedData, moduleName),
+            value);
+    }
+}
+
+void StatisticalData::getHistograms(
+    StatisticalHistogramSet* types,
+    Array<String>& moduleNames,
+    Array<StatisticalHistogram>& modules)
+{
+    for (Uint32 i = 0; i < NUMBER_OF_TYPES; i++)
+    {
+        types[i] = StatisticalHistogramSet();
+    }
+
+    moduleNames.clear();
+    modules.clear();
+
+    AutoMutex autoMut(_histogramMutex);
+
+    {
+        AutoMutex dataMut(_sharedData.mutex);
+        _mergeHistograms(&_sharedData, types, moduleNames, modules);
+    }
+
+    for (Uint32 i = 0; i < _threadData.size(); i++)
+    {
+        AutoMutex dataMut(_threadData[i]->mutex);
+
+        if (_threadData[i]->generation == _histogramGeneration)
+        {
+            _mergeHistograms(_threadData[i], types, moduleNames, modules);
+        }
+    }
+}
+
+void StatisticalData::updateTotals()
+{
+    AutoMutex autoMut(_mutex);
+
+    for (Uint32 i = 0; i < NUMBER_OF_TYPES; i++)
+    {
+        numCalls[i] = 0;
+        cimomTime[i] = 0;
+        providerTime[i] = 0;
+        responseSize[i] = 0;
+        requestSize[i] = 0;
+    }
+
+    AutoMutex histogramMut(_histogramMutex);
+
+    {
+        AutoMutex dataMut(_sharedData.mutex);
+        _addSums(&_sharedData, this);
+    }
+
+    for (Uint32 i = 0; i < _threadData.size(); i++)
+    {
+        AutoMutex dataMut(_threadData[i]->mutex);
+
+        if (_threadData[i]->generation == _histogramGeneration)
+        {
+            _addSums(_threadData[i], this);
+        }
+    }
+}
+
 PEGASUS_NAMESPACE_END
@@ -122,6 +122,58 @@ private:
     Uint64 _startTimeMicroseconds;
 };
 
+/**
+    Log-bucketed histogram of the values of a statistic.  Values below 8 have
+    a bucket of their own, larger values are counted in 4 buckets per power
+    of two, so a percentile is reported within 12.5% of the recorded values.
+    A histogram is not synchronized; its users serialize the access to it.
+*/
+class PEGASUS_COMMON_LINKAGE StatisticalHistogram
+{
+public:
+    enum { NUMBER_OF_BUCKETS = 252 };
+
+    StatisticalHistogram();
+
+    void add(Uint64 value)
+    {
+        _buckets[getBucket(value)]++;
+    }
+
+    /** Adds count values to the given bucket. */
+    void addCount(Uint32 bucket, Uint64 count)
+    {
+        _buckets[bucket] += count;
+    }
+
+    void merge(const StatisticalHistogram& x);
+
+    void clear();
+
+    Uint64 getCount() const;
+
+    /**
+        Returns the value which the given fraction of the recorded values,
+        in units of 1/1000, does not exceed; e.g. 990 returns the p99 value.
+    */
+    Uint64 getPercentile(Uint32 permille) const;
+
+    static Uint32 getBucket(Uint64 value);
+
+    /** Returns the middle of the range of values counted by the bucket. */
+    static Uint64 getBucketValue(Uint32 bucket);
+
+private:
+    Uint64 _buckets[NUMBER_OF_BUCKETS];
+};
+
+struct StatisticalHistogramSet
+{
+    StatisticalHistogram serverTime;
+    StatisticalHistogram providerTime;
+    StatisticalHistogram responseSize;
+};
+
 class PEGASUS_COMMON_LINKAGE StatisticalData
 {
 public:
@@ -182,6 +234,31 @@ public:
     static String requestName[];
     void setCopyGSD(Boolean flag);
 
+    /**
+        Adds the provider time of a request processed by the provider module
+        to the histogram of the module.
+    */
+    void addToModuleValue(const String& moduleName, Sint64 value);
+
+    /**
+        Sets numCalls, cimomTime, providerTime, responseSize and requestSize
+        to the sums of the values recorded by all threads.  Like the
+        histograms, the sums are kept per thread and only added up here.
+    */
+    void updateTotals();
+
+    /**
+        Returns the histograms of the server time, provider time and response
+        size per request type (types[NUMBER_OF_TYPES]) and the provider time
+        histograms per provider module, merged over all threads.  Each
+        thread records into histograms of its own without locking; these
+        are read here while the threads keep recording.
+    */
+    void getHistograms(
+        StatisticalHistogramSet* types,
+        Array<String>& moduleNames,
+        Array<StatisticalHistogram>& modules);
+
 protected:
     Mutex _mutex;
 };
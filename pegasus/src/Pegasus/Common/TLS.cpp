@@ -41,6 +41,7 @@
 #include "TLS.h"
 
 #ifdef PEGASUS_HAS_SSL
+# include <cstring>
 # define OPENSSL_NO_KRB5 1
 # include <openssl/err.h>
 # include <openssl/ssl.h>
@@ -306,10 +307,92 @@ Sint32 SSLSocket::timedWrite( const void* ptr,
     return totalBytesWritten;
 }
 
+Sint32 SSLSocket::timedWritev(
+    const SocketWriteSegment* segments,
+    Uint32 count,
+    Uint32 socketWriteTimeout,
+    Uint32 maxWriteSize)
+{
+    PEG_METHOD_ENTER(TRC_SSL, "SSLSocket::timedWritev()");
+
+    char batch[SSL3_RT_MAX_PLAIN_LENGTH];
+    Uint32 batchLimit =
+        maxWriteSize < sizeof(batch) ? maxWriteSize : sizeof(batch);
+    Uint32 batchSize = 0;
+    Sint32 totalBytesWritten = 0;
+
+    for (Uint32 i = 0; i <= count; i++)
+    {
+        // Flush the collected segments at the end, or when the next segment
+        // does not fit into the batch
+        if (batchSize &&
+            (i == count || batchSize + segments[i].size > batchLimit))
+        {
+            Sint32 bytesWritten =
+                timedWrite(batch, batchSize, socketWriteTimeout);
+
+            if (bytesWritten <= 0)
+            {
+                PEG_METHOD_EXIT();
+                return bytesWritten;
+            }
+            totalBytesWritten += bytesWritten;
+            batchSize = 0;
+        }
+
+        if (i == count)
+        {
+            break;
+        }
+
+        if (segments[i].size < batchLimit)
+        {
+            memcpy(batch + batchSize, segments[i].data, segments[i].size);
+            batchSize += segments[i].size;
+        }
+        else
+        {
+            // Large segments are written without copying
+            for (Uint32 offset = 0; offset < segments[i].size; )
+            {
+                Uint32 size = segments[i].size - offset;
+                if (size > maxWriteSize)
+                {
+                    size = maxWriteSize;
+                }
+
+                Sint32 bytesWritten = timedWrite(
+                    (const char*)segments[i].data + offset,
+                    size,
+                    socketWriteTimeout);
+
+                if (bytesWritten <= 0)
+                {
+                    PEG_METHOD_EXIT();
+                    return bytesWritten;
+                }
+                totalBytesWritten += bytesWritten;
+                offset += size;
+            }
+        }
+    }
+
+    PEG_METHOD_EXIT();
+    return totalBytesWritten;
+}
+
 void SSLSocket::close()
 {
     PEG_METHOD_ENTER(TRC_SSL, "SSLSocket::close()");
 
+    // TLS 1.3 servers send the session tickets after the handshake, so the
+    // session is kept again once the connection was used
+    if (_peerName.size() &&
+        SSL_is_init_finished(static_cast<SSL*>(_SSLConnection)))
+    {
+        _saveClientSession();
+    }
+
     SSL_shutdown(static_cast<SSL*>(_SSLConnection));
     Socket::close(_socket);
 
@@ -415,6 +498,16 @@ Sint32 SSLSocket::accept()
     }
     PEG_TRACE_CSTRING(TRC_SSL, Tracer::LEVEL3, "---> SSL: Accepted");
 
+    if (SSL_session_reused(sslConnection))
+    {
+        PEG_TRACE_CSTRING(TRC_SSL, Tracer::LEVEL4, "---> SSL: Session resumed");
+
+        if (_SSLContext->isPeerVerificationEnabled())
+        {
+            _setSessionPeerCertificate();
+        }
+    }
+
     //
     // If peer certificate verification is enabled or request received on
     // export connection, get the peer certificate and verify the trust
@@ -469,7 +562,9 @@ Sint32 SSLSocket::accept()
     return 1;
 }
 
-Sint32 SSLSocket::connect(Uint32 timeoutMilliseconds)
+Sint32 SSLSocket::connect(
+    Uint32 timeoutMilliseconds,
+    const String& peerName)
 {
     PEG_METHOD_ENTER(TRC_SSL, "SSLSocket::connect()");
 
@@ -479,6 +574,22 @@ Sint32 SSLSocket::connect(Uint32 timeoutMilliseconds)
     SSL* sslConnection = static_cast<SSL*>(_SSLConnection);
     SSL_set_connect_state(sslConnection);
 
+    //
+    // Offer the session of the last connection to this peer; the server
+    // falls back to a full handshake if it no longer knows the session
+    //
+    if (peerName.size())
+    {
+        SSL_SESSION* session =
+            _SSLContext->_rep->getClientSessionCache()->get(peerName);
+
+        if (session)
+        {
+            SSL_set_session(sslConnection, session);
+            SSL_SESSION_free(session);
+        }
+    }
+
     while (1)
     {
         int ssl_rc = SSL_connect(sslConnection);
@@ -625,10 +736,96 @@ Sint32 SSLSocket::connect(Uint32 timeoutMilliseconds)
             "---> SSL: Server certification disabled");
     }
 
+    // Only the sessions of successful connections are offered again
+    _peerName = peerName;
+
+    if (_peerName.size())
+    {
+        PEG_TRACE((TRC_SSL, Tracer::LEVEL4,
+            "---> SSL: Session with %s %s",
+            (const char*)_peerName.getCString(),
+            SSL_session_reused(sslConnection) ? "resumed" : "established"));
+
+        _saveClientSession();
+    }
+
     PEG_METHOD_EXIT();
     return 1;
 }
 
+//
+// Keeps the session of this client connection in the SSL context, for
+// resumption by the next connection to the same peer.
+//
+void SSLSocket::_saveClientSession()
+{
+    SSL_SESSION* session =
+        SSL_get1_session(static_cast<SSL*>(_SSLConnection));
+
+    if (session)
+    {
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+        if (SSL_SESSION_is_resumable(session))
+#endif
+        {
+            _SSLContext->_rep->getClientSessionCache()->set(
+                _peerName, session);
+        }
+        SSL_SESSION_free(session);
+    }
+}
+
+//
+// The certificate chain is not verified again when a session is resumed, so
+// the verification callback does not create the SSLCertificateInfo of the
+// client.  It is created from the certificate and the verification result
+// kept in the session instead, for the certificate based authentication.
+//
+void SSLSocket::_setSessionPeerCertificate()
+{
+    PEG_METHOD_ENTER(TRC_SSL, "SSLSocket::_setSessionPeerCertificate()");
+
+    SSL* sslConnection = static_cast<SSL*>(_SSLConnection);
+    X509* peerCert = SSL_get_peer_certificate(sslConnection);
+
+    if (peerCert == NULL || !_SSLCallbackInfo.get() ||
+        _SSLCallbackInfo->_rep->peerCertificate.size() != 0)
+    {
+        if (peerCert)
+        {
+            X509_free(peerCert);
+        }
+        PEG_METHOD_EXIT();
+        return;
+    }
+
+    char buf[256];
+
+    X509_NAME_oneline(X509_get_subject_name(peerCert), buf, sizeof(buf));
+    String subjectName = String(buf);
+
+    X509_NAME_oneline(X509_get_issuer_name(peerCert), buf, sizeof(buf));
+    String issuerName = String(buf);
+
+    long verifyResult = SSL_get_verify_result(sslConnection);
+
+    _SSLCallbackInfo->_rep->peerCertificate.append(new SSLCertificateInfo(
+        subjectName,
+        issuerName,
+        X509_get_version(peerCert),
+        ASN1_INTEGER_get(X509_get_serialNumber(peerCert)),
+        getDateTime(X509_get_notBefore(peerCert)),
+        getDateTime(X509_get_notAfter(peerCert)),
+        0,
+        verifyResult,
+        String(X509_verify_cert_error_string(verifyResult)),
+        verifyResult == X509_V_OK));
+
+    X509_free(peerCert);
+
+    PEG_METHOD_EXIT();
+}
+
 Boolean SSLSocket::isPeerVerificationEnabled()
 {
     return _SSLContext->isPeerVerificationEnabled();
@@ -730,6 +927,19 @@ Sint32 MP_Socket::write(const void * ptr, Uint32 size)
         return Socket::timedWrite(_socket,ptr,size,_socketWriteTimeout);
 }
 
+Sint32 MP_Socket::writev(
+    const SocketWriteSegment* segments,
+    Uint32 count,
+    Uint32 maxWriteSize)
+{
+    if (_isSecure)
+        return _sslsock->timedWritev(
+            segments, count, _socketWriteTimeout, maxWriteSize);
+    else
+        return Socket::timedWritev(
+            _socket, segments, count, _socketWriteTimeout, maxWriteSize);
+}
+
 void MP_Socket::close()
 {
     if (_isSecure)
@@ -755,10 +965,12 @@ Sint32 MP_Socket::accept()
     return 1;
 }
 
-Sint32 MP_Socket::connect(Uint32 timeoutMilliseconds)
+Sint32 MP_Socket::connect(
+    Uint32 timeoutMilliseconds,
+    const String& peerName)
 {
     if (_isSecure)
-        if (_sslsock->connect(timeoutMilliseconds) < 0) return -1;
+        if (_sslsock->connect(timeoutMilliseconds, peerName) < 0) return -1;
     return 0;
 }
 
@@ -845,6 +1057,15 @@ Sint32 MP_Socket::write(const void * ptr, Uint32 size)
     return Socket::timedWrite(_socket,ptr,size,_socketWriteTimeout);
 }
 
+Sint32 MP_Socket::writev(
+    const SocketWriteSegment* segments,
+    Uint32 count,
+    Uint32 maxWriteSize)
+{
+    return Socket::timedWritev(
+        _socket, segments, count, _socketWriteTimeout, maxWriteSize);
+}
+
 void MP_Socket::close()
 {
     Socket::close(_socket);
@@ -891,7 +1112,12 @@ Sint32 MP_Socket::accept()
 #endif
 }
 
-Sint32 MP_Socket::connect(Uint32 timeoutMilliseconds) { return 0; }
+Sint32 MP_Socket::connect(
+    Uint32 timeoutMilliseconds,
+    const String& peerName)
+{
+    return 0;
+}
 
 Boolean MP_Socket::isPeerVerificationEnabled() { return false; }
 
@@ -64,6 +64,19 @@ public:
                       Uint32 size,
                       Uint32 socketWriteTimeout);
 
+    /**
+        Writes the specified segments in order.  Small segments are
+        collected in a buffer of up to one TLS record, so that they are sent
+        with a single SSL_write() rather than one record each.  No
+        SSL_write() gets more than maxWriteSize bytes.
+        @return The total number of bytes written, or the SSL_write() error
+        indication.
+     */
+    Sint32 timedWritev(const SocketWriteSegment* segments,
+                       Uint32 count,
+                       Uint32 socketWriteTimeout,
+                       Uint32 maxWriteSize);
+
     void close();
 
     void disableBlocking();
@@ -82,7 +95,16 @@ public:
      */
     Sint32 accept();
 
-    Sint32 connect(Uint32 timeoutMilliseconds);
+    /**
+        Connects to the server, performing the SSL handshake.  The session
+        of the last connection to the same peer is offered for resumption.
+
+        @param timeoutMilliseconds  handshake timeout.
+        @param peerName  host:port of the server, identifies the cached
+        session.  No session is cached if empty.
+        @return Returns -1 on failure and 1 on success.
+     */
+    Sint32 connect(Uint32 timeoutMilliseconds, const String& peerName);
 
     Boolean isPeerVerificationEnabled();
 
@@ -99,6 +121,10 @@ public:
 
 private:
 
+    void _saveClientSession();
+
+    void _setSessionPeerCertificate();
+
     /**
         This member is of type SSL*, but we don't want to expose a dependency
         on the SSL include files in a header file.
@@ -117,6 +143,7 @@ private:
 
     AutoPtr<SSLCallbackInfo> _SSLCallbackInfo;
     String _ipAddress;
+    String _peerName;
     Boolean _certificateVerified;
 };
 #else
@@ -154,6 +181,15 @@ public:
 
     Sint32 write(const void* ptr, Uint32 size);
 
+    /**
+        Writes the specified segments in order (see Socket::timedWritev).
+        @param maxWriteSize The maximum number of bytes passed to one write.
+     */
+    Sint32 writev(
+        const SocketWriteSegment* segments,
+        Uint32 count,
+        Uint32 maxWriteSize);
+
     void close();
 
     void disableBlocking();
@@ -166,7 +202,7 @@ public:
      */
     Sint32 accept();
 
-    Sint32 connect(Uint32 timeoutMilliseconds);
+    Sint32 connect(Uint32 timeoutMilliseconds, const String& peerName);
 
     Boolean isPeerVerificationEnabled();
 
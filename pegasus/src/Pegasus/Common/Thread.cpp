@@ -52,6 +52,7 @@ struct StartWrapperArg
 {
     void *(PEGASUS_THREAD_CDECL * start) (void *);
     void *arg;
+    Boolean detached;
 };
 
 extern "C" void *_start_wrapper(void *arg_)
@@ -60,12 +61,23 @@ extern "C" void *_start_wrapper(void *arg_)
     StartWrapperArg arg;
     arg.start = ((StartWrapperArg *) arg_)->start;
     arg.arg = ((StartWrapperArg *) arg_)->arg;
+    arg.detached = ((StartWrapperArg *) arg_)->detached;
     delete (StartWrapperArg *) arg_;
 
     // establish cancelability of the thread
     pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, NULL);
     pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, NULL);
 
+    // Make the thread specific data of the Thread object available to the
+    // code running in this thread (e.g. the PooledAllocator free lists).
+    // Nobody joins a detached thread, so its Thread object may be destroyed
+    // while it runs (e.g. one on the stack of the creating function) and
+    // is not made current.
+    if (!arg.detached)
+    {
+        Thread::setCurrent(reinterpret_cast<Thread *>(arg.arg));
+    }
+
     void *return_value = (*arg.start) (arg.arg);
 
     return return_value;
@@ -114,6 +126,7 @@ ThreadStatus Thread::run()
     StartWrapperArg *arg = new StartWrapperArg;
     arg->start = _start;
     arg->arg = this;
+    arg->detached = _is_detached;
 
     Threads::Type type = _is_detached ? Threads::DETACHED : Threads::JOINABLE;
     int rc = Threads::create(_handle.thid, type, _start_wrapper, arg);
@@ -160,6 +173,11 @@ Thread::~Thread()
     try
     {
         join();
+
+        // A dummy Thread object may be deleted by the thread it represents
+        if (Thread::getCurrent() == this)
+            Thread::setCurrent(0);
+
         empty_tsd();
     }
     catch (...)
@@ -278,6 +296,11 @@ Thread::~Thread()
     try
     {
         join();
+
+        // A dummy Thread object may be deleted by the thread it represents
+        if (Thread::getCurrent() == this)
+            Thread::setCurrent(0);
+
         empty_tsd();
     }
     catch (...)
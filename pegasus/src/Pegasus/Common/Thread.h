@@ -88,6 +88,10 @@ enum TSD_Key
     TSD_WORK_PARM,
     TSD_BLOCKING_SEM,
     TSD_CIMOM_HANDLE_CONTENT_LANGUAGES,
+    TSD_ALLOCATION_POOL,
+    TSD_STATISTICAL_HISTOGRAMS,
+    TSD_THREAD_POOL_DEQUE,
+    TSD_SHARED_RESPONSE_THREAD,
     TSD_RESERVED_1,
     TSD_RESERVED_2,
     TSD_RESERVED_3,
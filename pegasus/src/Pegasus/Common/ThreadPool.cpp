@@ -34,30 +34,125 @@
 #include <exception>
 #include <Pegasus/Common/Tracer.h>
 #include "Time.h"
+#include "TimeValue.h"
 
 PEGASUS_USING_STD;
 
 PEGASUS_NAMESPACE_BEGIN
 
+///////////////////////////////////////////////////////////////////////////////
+//
+// ThreadPoolTask
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+    A unit of work that is queued because no thread was available for it.
+*/
+class ThreadPoolTask : public Linkable
+{
+public:
+
+    ThreadPoolTask(
+        void* parm_,
+        ThreadReturnType (PEGASUS_THREAD_CDECL* work_) (void*),
+        Semaphore* blocking_)
+        : parm(parm_),
+          work(work_),
+          blocking(blocking_),
+          queueTime(TimeValue::getCurrentTime().toMicroseconds())
+    {
+    }
+
+    void* parm;
+    ThreadReturnType (PEGASUS_THREAD_CDECL* work) (void*);
+    Semaphore* blocking;
+    Uint64 queueTime;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// ThreadPoolDeque
+//
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+    The work that a thread of the pool queued.  The thread itself takes
+    work from the front, other threads steal from the back.  Lives in the
+    thread specific storage of the thread and is deleted with it.
+*/
+class ThreadPoolDeque : public Linkable
+{
+public:
+
+    ThreadPoolDeque(ThreadPool* pool_) : pool(pool_), queueWaitUsec(0)
+    {
+    }
+
+    ThreadPoolTask* removeFront()
+    {
+        AutoMutex autoMut(mutex);
+        return _account(tasks.remove_front());
+    }
+
+    ThreadPoolTask* removeBack()
+    {
+        AutoMutex autoMut(mutex);
+        return _account(tasks.remove_back());
+    }
+
+    ThreadPool* pool;
+    List<ThreadPoolTask, NullLock> tasks;
+    // The time the work taken from this deque waited for a thread
+    Uint64 queueWaitUsec;
+    Mutex mutex;
+
+private:
+
+    ThreadPoolTask* _account(ThreadPoolTask* task)
+    {
+        if (task != 0)
+        {
+            queueWaitUsec +=
+                TimeValue::getCurrentTime().toMicroseconds() - task->queueTime;
+        }
+        return task;
+    }
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 //
 // ThreadPool
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+Uint32 ThreadPool::_saturatedPools = 0;
+Mutex ThreadPool::_admissionMutex;
+Condition ThreadPool::_admissionCondition;
+
 ThreadPool::ThreadPool(
     Sint16 initialSize,
     const char* key,
     Sint16 minThreads,
     Sint16 maxThreads,
     struct timeval
-    &deallocateWait)
+    &deallocateWait,
+    Uint32 maxQueuedTasks)
     : _maxThreads(maxThreads),
       _minThreads(minThreads),
       _currentThreads(0),
+      _waitingThreads(0),
       _idleThreads(),
       _runningThreads(),
-      _dying(0)
+      _dying(0),
+      _maxQueuedTasks(maxQueuedTasks),
+      _queuedTaskCount(0),
+      _stolenTasks(0),
+      _saturated(false),
+      _peakQueuedTasks(0),
+      _totalQueuedTasks(0),
+      _totalQueueWaitUsec(0),
+      _rejectedTasks(0)
 {
     _deallocateWait.tv_sec = deallocateWait.tv_sec;
     _deallocateWait.tv_usec = deallocateWait.tv_usec;
@@ -95,6 +190,18 @@ ThreadPool::~ThreadPool()
         _dying++;
         PEG_TRACE((TRC_THREAD, Tracer::LEVEL3,
             "Cleaning up %d idle threads.", _currentThreads.get()));
+        PEG_TRACE((TRC_THREAD, Tracer::LEVEL3,
+            "ThreadPool %s queued %" PEGASUS_64BIT_CONVERSION_WIDTH "u "
+                "work requests (peak %u), waiting %"
+                PEGASUS_64BIT_CONVERSION_WIDTH "u microseconds in total, "
+                "rejected %" PEGASUS_64BIT_CONVERSION_WIDTH "u, and had %"
+                PEGASUS_64BIT_CONVERSION_WIDTH "u stolen.",
+            _key,
+            _totalQueuedTasks,
+            _peakQueuedTasks,
+            _totalQueueWaitUsec,
+            _rejectedTasks,
+            _stolenTasks));
 
         while (_currentThreads.get() > 0)
         {
@@ -109,6 +216,21 @@ ThreadPool::~ThreadPool()
                 Threads::yield();
             }
         }
+
+        // The threads do all queued work before they go idle, so the
+        // queue is empty once all threads have been cleaned up, and the
+        // deques were deleted with the threads.
+        PEGASUS_ASSERT(_queuedTaskCount.get() == 0);
+        PEGASUS_ASSERT(_queuedTasks.size() == 0);
+        PEGASUS_ASSERT(_deques.size() == 0);
+        if (_saturated)
+        {
+            AutoMutex autoMut(_admissionMutex);
+            if (--_saturatedPools == 0)
+            {
+                _admissionCondition.signal();
+            }
+        }
     }
     catch (...)
     {
@@ -133,6 +255,7 @@ ThreadReturnType PEGASUS_THREAD_CDECL ThreadPool::_loop(void* parm)
 
         Semaphore *sleep_sem = 0;
         struct timeval *lastActivityTime = 0;
+        ThreadPoolDeque *deque = 0;
 
         try
         {
@@ -145,12 +268,17 @@ ThreadReturnType PEGASUS_THREAD_CDECL ThreadPool::_loop(void* parm)
                 reference_tsd(TSD_LAST_ACTIVITY_TIME);
             myself->dereference_tsd();
             PEGASUS_ASSERT(lastActivityTime != 0);
+
+            deque = (ThreadPoolDeque *)
+                myself->reference_tsd(TSD_THREAD_POOL_DEQUE);
+            myself->dereference_tsd();
+            PEGASUS_ASSERT(deque != 0);
         }
         catch (...)
         {
             PEG_TRACE_CSTRING(TRC_DISCARDED_DATA, Tracer::LEVEL1,
-                "ThreadPool::_loop: Failure getting sleep_sem or "
-                    "lastActivityTime.");
+                "ThreadPool::_loop: Failure getting sleep_sem, "
+                    "lastActivityTime, or deque.");
             PEGASUS_ASSERT(false);
             pool->_idleThreads.remove(myself);
             pool->_currentThreads--;
@@ -215,42 +343,30 @@ ThreadReturnType PEGASUS_THREAD_CDECL ThreadPool::_loop(void* parm)
 
             Time::gettimeofday(lastActivityTime);
 
-            try
-            {
-                PEG_TRACE_CSTRING(TRC_THREAD, Tracer::LEVEL4,
-                                 "Work starting.");
-                work(workParm);
-                PEG_TRACE_CSTRING(TRC_THREAD, Tracer::LEVEL4,
-                                 "Work finished.");
-            }
-            catch (Exception& e)
-            {
-                PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
-                    "Exception from work in ThreadPool::_loop: %s",
-                    (const char*)e.getMessage().getCString()));
-            }
-            catch (const exception& e)
-            {
-                PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
-                    "Exception from work in ThreadPool::_loop: %s",e.what()));
-            }
-            catch (...)
-            {
-                PEG_TRACE_CSTRING(TRC_DISCARDED_DATA, Tracer::LEVEL1,
-                    "Unknown exception from work in ThreadPool::_loop.");
-            }
+            _doWork(work, workParm);
 
-            // put myself back onto the available list
+            // Do the queued work, then put myself back onto the available
+            // list
             try
             {
-                Time::gettimeofday(lastActivityTime);
                 if (blocking_sem != 0)
                 {
                     blocking_sem->signal();
                 }
 
-                pool->_runningThreads.remove(myself);
-                pool->_idleThreads.insert_front(myself);
+                ThreadPoolTask* task;
+                while ((task = pool->_nextQueuedTask(myself, deque)) != 0)
+                {
+                    _doWork(task->work, task->parm);
+
+                    if (task->blocking != 0)
+                    {
+                        task->blocking->signal();
+                    }
+                    delete task;
+                }
+
+                Time::gettimeofday(lastActivityTime);
             }
             catch (...)
             {
@@ -279,6 +395,131 @@ ThreadReturnType PEGASUS_THREAD_CDECL ThreadPool::_loop(void* parm)
     return (ThreadReturnType) 0;
 }
 
+void ThreadPool::_doWork(
+    ThreadReturnType(PEGASUS_THREAD_CDECL* work) (void*),
+    void* parm)
+{
+    try
+    {
+        PEG_TRACE_CSTRING(TRC_THREAD, Tracer::LEVEL4,
+                         "Work starting.");
+        work(parm);
+        PEG_TRACE_CSTRING(TRC_THREAD, Tracer::LEVEL4,
+                         "Work finished.");
+    }
+    catch (Exception& e)
+    {
+        PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+            "Exception from work in ThreadPool::_loop: %s",
+            (const char*)e.getMessage().getCString()));
+    }
+    catch (const exception& e)
+    {
+        PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+            "Exception from work in ThreadPool::_loop: %s",e.what()));
+    }
+    catch (...)
+    {
+        PEG_TRACE_CSTRING(TRC_DISCARDED_DATA, Tracer::LEVEL1,
+            "Unknown exception from work in ThreadPool::_loop.");
+    }
+}
+
+ThreadPoolDeque* ThreadPool::_getCurrentDeque()
+{
+    Thread* th = Thread::getCurrent();
+
+    if (th == 0)
+    {
+        return 0;
+    }
+
+    ThreadPoolDeque* deque =
+        (ThreadPoolDeque*) th->reference_tsd(TSD_THREAD_POOL_DEQUE);
+    th->dereference_tsd();
+
+    // Threads of other pools have deques too
+    if ((deque == 0) || (deque->pool != this))
+    {
+        return 0;
+    }
+
+    return deque;
+}
+
+ThreadPoolTask* ThreadPool::_nextQueuedTask(
+    Thread* th,
+    ThreadPoolDeque* deque)
+{
+    // The thread's own work needs no lock but that of its deque
+    ThreadPoolTask* task = deque->removeFront();
+
+    if (task != 0)
+    {
+        _queuedTaskCount--;
+
+        if (_saturated)
+        {
+            AutoMutex autoMut(_queuedTasksMutex);
+            _updateSaturation();
+        }
+
+        return task;
+    }
+
+    AutoMutex autoMut(_queuedTasksMutex);
+
+    task = _queuedTasks.remove_front();
+
+    if (task != 0)
+    {
+        _totalQueueWaitUsec +=
+            TimeValue::getCurrentTime().toMicroseconds() - task->queueTime;
+    }
+    else if ((task = _stealTask(deque)) == 0)
+    {
+        _runningThreads.remove(th);
+        _idleThreads.insert_front(th);
+        return 0;
+    }
+
+    _queuedTaskCount--;
+    _updateSaturation();
+
+    return task;
+}
+
+// The caller holds the _queuedTasksMutex.
+ThreadPoolTask* ThreadPool::_stealTask(ThreadPoolDeque* thief)
+{
+    AutoMutex autoMut(_dequesMutex);
+
+    for (ThreadPoolDeque* deque = _deques.front();
+         deque != 0;
+         deque = _deques.next_of(deque))
+    {
+        if (deque == thief)
+        {
+            continue;
+        }
+
+        ThreadPoolTask* task = deque->removeBack();
+
+        if (task != 0)
+        {
+            _stolenTasks++;
+
+            PEG_TRACE((TRC_THREAD, Tracer::LEVEL4,
+                "ThreadPool %s: work stolen, %" PEGASUS_64BIT_CONVERSION_WIDTH
+                    "u in total",
+                _key, _stolenTasks));
+            return task;
+        }
+    }
+
+    return 0;
+}
+
 ThreadStatus ThreadPool::allocate_and_awaken(
     void* parm,
     ThreadReturnType (PEGASUS_THREAD_CDECL* work) (void*),
@@ -306,8 +547,11 @@ ThreadStatus ThreadPool::allocate_and_awaken(
 
         if (th == 0)
         {
+            // Threads blocked in beginWait() do not count toward the
+            // maximum.
             if ((_maxThreads == 0) ||
-                (_currentThreads.get() < Uint32(_maxThreads)))
+                (_currentThreads.get() <
+                     Uint32(_maxThreads) + _waitingThreads.get()))
             {
                 th = _initializeThread();
             }
@@ -315,11 +559,61 @@ ThreadStatus ThreadPool::allocate_and_awaken(
 
         if (th == 0)
         {
-            PEG_TRACE((TRC_THREAD, Tracer::LEVEL1,
-                "ThreadPool::allocate_and_awaken: Insufficient resources: "
-                    " pool = %s, running threads = %d, idle threads = %d",
-                _key, _runningThreads.size(), _idleThreads.size()));
-            return PEGASUS_THREAD_INSUFFICIENT_RESOURCES;
+            AutoMutex autoMut(_queuedTasksMutex);
+
+            // A thread that finished its work since we looked may have
+            // gone idle.  Any thread that goes idle later will find the
+            // work in the queue.
+            th = _idleThreads.remove_front();
+
+            if (th == 0)
+            {
+                if (_queuedTaskCount.get() < _maxQueuedTasks)
+                {
+                    ThreadPoolTask* task =
+                        new ThreadPoolTask(parm, work, blocking);
+                    ThreadPoolDeque* deque = _getCurrentDeque();
+
+                    // Counted first, as the thread may take the work from
+                    // its deque as soon as it is there
+                    _queuedTaskCount++;
+
+                    if (deque != 0)
+                    {
+                        AutoMutex dequeMut(deque->mutex);
+                        deque->tasks.insert_front(task);
+                    }
+                    else
+                    {
+                        _queuedTasks.insert_back(task);
+                    }
+
+                    _totalQueuedTasks++;
+                    if (_queuedTaskCount.get() > _peakQueuedTasks)
+                    {
+                        _peakQueuedTasks = _queuedTaskCount.get();
+                    }
+                    _updateSaturation();
+
+                    PEG_TRACE((TRC_THREAD, Tracer::LEVEL4,
+                        "ThreadPool::allocate_and_awaken: Work queued: "
+                            "pool = %s, queued work requests = %u",
+                        _key, _queuedTaskCount.get()));
+                    PEG_METHOD_EXIT();
+                    return PEGASUS_THREAD_OK;
+                }
+
+                _rejectedTasks++;
+
+                PEG_TRACE((TRC_THREAD, Tracer::LEVEL1,
+                    "ThreadPool::allocate_and_awaken: Insufficient resources: "
+                        " pool = %s, running threads = %d, idle threads = %d, "
+                        "queued work requests = %u",
+                    _key, _runningThreads.size(), _idleThreads.size(),
+                    _queuedTaskCount.get()));
+                PEG_METHOD_EXIT();
+                return PEGASUS_THREAD_INSUFFICIENT_RESOURCES;
+            }
         }
 
         // initialize the thread data with the work function and parameters
@@ -363,6 +657,138 @@ ThreadStatus ThreadPool::allocate_and_awaken(
     return PEGASUS_THREAD_OK;
 }
 
+void ThreadPool::setMaxQueuedTasks(Uint32 maxQueuedTasks)
+{
+    AutoMutex autoMut(_queuedTasksMutex);
+    _maxQueuedTasks = maxQueuedTasks;
+    _updateSaturation();
+}
+
+Uint32 ThreadPool::queuedCount()
+{
+    return _queuedTaskCount.get();
+}
+
+void ThreadPool::getQueueStatistics(
+    Uint32& queuedTasks,
+    Uint32& peakQueuedTasks,
+    Uint64& totalQueuedTasks,
+    Uint64& totalQueueWaitUsec,
+    Uint64& rejectedTasks,
+    Uint64& stolenTasks)
+{
+    AutoMutex autoMut(_queuedTasksMutex);
+    queuedTasks = _queuedTaskCount.get();
+    peakQueuedTasks = _peakQueuedTasks;
+    totalQueuedTasks = _totalQueuedTasks;
+    totalQueueWaitUsec = _totalQueueWaitUsec;
+    rejectedTasks = _rejectedTasks;
+    stolenTasks = _stolenTasks;
+
+    AutoMutex dequesMut(_dequesMutex);
+    for (ThreadPoolDeque* deque = _deques.front();
+         deque != 0;
+         deque = _deques.next_of(deque))
+    {
+        AutoMutex dequeMut(deque->mutex);
+        totalQueueWaitUsec += deque->queueWaitUsec;
+    }
+}
+
+Boolean ThreadPool::waitForAdmission(Uint32 milliseconds)
+{
+    AutoMutex autoMut(_admissionMutex);
+
+    Uint64 deadline =
+        TimeValue::getCurrentTime().toMilliseconds() + milliseconds;
+
+    while (_saturatedPools != 0)
+    {
+        Uint64 now = TimeValue::getCurrentTime().toMilliseconds();
+
+        if (now >= deadline)
+        {
+            return false;
+        }
+
+        _admissionCondition.time_wait(_admissionMutex, Uint32(deadline - now));
+
+        if (_saturatedPools == 0)
+        {
+            // The condition wakes one waiter; pass the wakeup on to the
+            // next one.
+            _admissionCondition.signal();
+        }
+    }
+
+    return true;
+}
+
+Boolean ThreadPool::beginWait()
+{
+    Thread* th = Thread::getCurrent();
+
+    if ((th == 0) || !_runningThreads.contains(th))
+    {
+        return false;
+    }
+
+    _waitingThreads++;
+
+    // Work that was queued because the pool was at its limit may now get
+    // a thread, which does it before going idle.
+    if (!_dying.get() && (queuedCount() != 0))
+    {
+        PEG_TRACE((TRC_THREAD, Tracer::LEVEL4,
+            "ThreadPool %s: thread waits with %u work requests queued",
+            _key, queuedCount()));
+        allocate_and_awaken(0, _noWork);
+    }
+
+    return true;
+}
+
+void ThreadPool::endWait()
+{
+    _waitingThreads--;
+}
+
+// The caller holds the _queuedTasksMutex.
+void ThreadPool::_updateSaturation()
+{
+    Uint32 queuedTasks = _queuedTaskCount.get();
+
+    if (!_saturated && (_maxQueuedTasks != 0) &&
+        (queuedTasks >= (_maxQueuedTasks * 3 + 3) / 4))
+    {
+        _saturated = true;
+        {
+            AutoMutex autoMut(_admissionMutex);
+            _saturatedPools++;
+        }
+
+        PEG_TRACE((TRC_THREAD, Tracer::LEVEL2,
+            "ThreadPool %s is saturated: queued work requests = %u",
+            _key, queuedTasks));
+    }
+    else if (_saturated &&
+        ((_maxQueuedTasks == 0) || (queuedTasks <= _maxQueuedTasks / 2)))
+    {
+        _saturated = false;
+        {
+            AutoMutex autoMut(_admissionMutex);
+            if (--_saturatedPools == 0)
+            {
+                _admissionCondition.signal();
+            }
+        }
+
+        PEG_TRACE((TRC_THREAD, Tracer::LEVEL2,
+            "ThreadPool %s is no longer saturated: queued work requests = %u",
+            _key, queuedTasks));
+    }
+}
+
 // caller is responsible for only calling this routine during slack periods
 // but should call it at least once per _deallocateWait interval.
 
@@ -471,6 +897,26 @@ void ThreadPool::_deleteSemaphore(void *p)
     delete(Semaphore *) p;
 }
 
+void ThreadPool::_deleteDeque(void *p)
+{
+    ThreadPoolDeque* deque = (ThreadPoolDeque*) p;
+    ThreadPool* pool = deque->pool;
+
+    // An idle thread has done all work in its deque
+    PEGASUS_ASSERT(deque->tasks.size() == 0);
+
+    AutoMutex autoMut(pool->_queuedTasksMutex);
+    AutoMutex dequesMut(pool->_dequesMutex);
+    pool->_totalQueueWaitUsec += deque->queueWaitUsec;
+    pool->_deques.remove(deque);
+    delete deque;
+}
+
+ThreadReturnType PEGASUS_THREAD_CDECL ThreadPool::_noWork(void*)
+{
+    return (ThreadReturnType) 0;
+}
+
 Thread *ThreadPool::_initializeThread()
 {
     PEG_METHOD_ENTER(TRC_THREAD, "ThreadPool::_initializeThread");
@@ -495,6 +941,19 @@ Thread *ThreadPool::_initializeThread()
         (void*) lastActivityTime);
     // thread will enter _loop() and sleep on sleep_sem until we signal it
 
+    // the deque is registered before the thread runs, so it can steal
+    // right away, and removed when the thread is deleted
+    ThreadPoolDeque* deque = new ThreadPoolDeque(this);
+    {
+        AutoMutex autoMut(_dequesMutex);
+        _deques.insert_back(deque);
+    }
+    th->put_tsd(
+        TSD_THREAD_POOL_DEQUE,
+        &_deleteDeque,
+        sizeof(ThreadPoolDeque),
+        (void*) deque);
+
     if (th->run() != PEGASUS_THREAD_OK)
     {
         PEG_TRACE((TRC_THREAD, Tracer::LEVEL1,
@@ -35,9 +35,13 @@
 #include <Pegasus/Common/Config.h>
 #include <Pegasus/Common/Linkage.h>
 #include <Pegasus/Common/Thread.h>
+#include <Pegasus/Common/Condition.h>
 
 PEGASUS_NAMESPACE_BEGIN
 
+class ThreadPoolTask;
+class ThreadPoolDeque;
+
 class PEGASUS_COMMON_LINKAGE ThreadPool
 {
 public:
@@ -55,13 +59,17 @@ public:
             contained in this thread pool at any given time.
         @param deallocateWait The minimum time that a thread should be idle
             before it is removed from the pool and cleaned up.
+        @param maxQueuedTasks The maximum number of work requests that are
+            queued when no thread is available for them (see
+            allocate_and_awaken).  0 disables the queue.
      */
     ThreadPool(
         Sint16 initialSize,
         const char* key,
         Sint16 minThreads,
         Sint16 maxThreads,
-        struct timeval& deallocateWait);
+        struct timeval& deallocateWait,
+        Uint32 maxQueuedTasks = 0);
 
     /**
         Destructs the ThreadPool object.
@@ -69,17 +77,27 @@ public:
      ~ThreadPool();
 
     /**
-        Allocate and start a thread to do a unit of work.
+        Allocate and start a thread to do a unit of work.  If no idle
+        thread is available and no thread may be created, the work is
+        queued, unless maxQueuedTasks work requests are queued already.
+        Work from a thread of this pool is queued at the front of that
+        thread's own deque; the thread does it when it finishes its
+        current work, unless another thread of the pool that ran out of
+        work steals it from the back of the deque first.  Work from any
+        other thread is queued in the shared queue of the pool and done
+        by the next thread that finishes its work.
         @param parm A generic parameter to pass to the thread
         @param work A pointer to the function that is to be executed by
                     the thread
         @param blocking A pointer to an optional semaphore which, if
                         specified, is signaled after the thread finishes
                         executing the work function
-        @return PEGASUS_THREAD_OK if the thread is started successfully,
+        @return PEGASUS_THREAD_OK if the thread is started successfully
+                or the work is queued,
                 PEGASUS_THREAD_INSUFFICIENT_RESOURCES  if the
                 resources necessary to start the thread are not currently
-                available.  PEGASUS_THREAD_SETUP_FAILURE if the thread
+                available and the queue is full.
+                PEGASUS_THREAD_SETUP_FAILURE if the thread
                 could not be setup properly. PEGASUS_THREAD_UNAVAILABLE
                 if this service is shutting down and no more threads can
                 be allocated.
@@ -129,6 +147,66 @@ public:
         return (Uint32) _idleThreads.size();
     }
 
+    void setMaxQueuedTasks(Uint32 maxQueuedTasks);
+
+    inline Uint32 getMaxQueuedTasks() const
+    {
+        return _maxQueuedTasks;
+    }
+
+    Uint32 queuedCount();
+
+    /**
+        Returns the statistics of the work queue.
+        @param queuedTasks The number of work requests queued now.
+        @param peakQueuedTasks The largest number of work requests that
+            were queued at the same time.
+        @param totalQueuedTasks The number of work requests that have been
+            queued.
+        @param totalQueueWaitUsec The total time in microseconds that these
+            work requests waited for a thread.
+        @param rejectedTasks The number of work requests that were refused
+            because the queue was full.
+        @param stolenTasks The number of work requests that a thread took
+            from the deque of another thread.
+     */
+    void getQueueStatistics(
+        Uint32& queuedTasks,
+        Uint32& peakQueuedTasks,
+        Uint64& totalQueuedTasks,
+        Uint64& totalQueueWaitUsec,
+        Uint64& rejectedTasks,
+        Uint64& stolenTasks);
+
+    /**
+        A thread pool is saturated while its queue holds three quarters of
+        maxQueuedTasks or more, until the queue has drained to half of it.
+        Callers that accept new work from outside (the connection monitors
+        of the CIM Server) use this method to apply back-pressure, reading
+        no new requests while any thread pool is saturated.
+        @param milliseconds The maximum time to wait.
+        @return true if no thread pool is saturated, false if the time
+            elapsed while one still was.
+     */
+    static Boolean waitForAdmission(Uint32 milliseconds);
+
+    /**
+        Tells the thread pool that the calling thread is about to block
+        until other work of the pool is done, as a thread that sends a
+        request to a service and waits for its response does.  Until
+        endWait() is called, the thread does not count toward maxThreads,
+        so the work it waits for gets a thread even when the pool is at
+        its limit.  Does nothing if the calling thread is not a thread of
+        this pool.
+        @return true if the caller must call endWait() after the wait.
+     */
+    Boolean beginWait();
+
+    /**
+        Ends a wait that beginWait() started.
+     */
+    void endWait();
+
 private:
 
     ThreadPool();               // Unimplemented
@@ -143,18 +221,70 @@ private:
 
     static void _deleteSemaphore(void* p);
 
+    static void _deleteDeque(void* p);
+
+    static ThreadReturnType PEGASUS_THREAD_CDECL _noWork(void*);
+
+    static void _doWork(
+        ThreadReturnType(PEGASUS_THREAD_CDECL* work) (void*),
+        void* parm);
+
     void _cleanupThread(Thread* thread);
     Thread* _initializeThread();
     void _addToIdleThreadsQueue(Thread* th);
+    void _updateSaturation();
+
+    ThreadPoolDeque* _getCurrentDeque();
+
+    /**
+        Takes the next work request from the front of the thread's own
+        deque, from the shared queue, or from the back of the deque of
+        another thread, in this order.  If there is none, moves the thread
+        to the _idleThreads queue.  The last two steps and the move are
+        done under the _queuedTasksMutex, which work is queued under as
+        well, so a work request is never left queued while a thread is
+        idle.
+        @return The work request, or 0 if the thread is now idle.
+     */
+    ThreadPoolTask* _nextQueuedTask(Thread* th, ThreadPoolDeque* deque);
+
+    /**
+        Takes the oldest work request from the deque of another thread.
+        The caller holds the _queuedTasksMutex.
+     */
+    ThreadPoolTask* _stealTask(ThreadPoolDeque* thief);
 
     Sint16 _maxThreads;
     Sint16 _minThreads;
     AtomicInt _currentThreads;
+    // Number of running threads that are blocked in beginWait()/endWait()
+    AtomicInt _waitingThreads;
     struct timeval _deallocateWait;
     char _key[17];
     List<Thread, Mutex> _idleThreads;
     List<Thread, Mutex> _runningThreads;
     AtomicInt _dying;
+
+    Uint32 _maxQueuedTasks;
+    // Number of work requests in the shared queue and in the deques
+    AtomicInt _queuedTaskCount;
+    List<ThreadPoolTask, NullLock> _queuedTasks;
+    Mutex _queuedTasksMutex;
+    // The deques of the threads, guarded by the _dequesMutex
+    List<ThreadPoolDeque, NullLock> _deques;
+    Mutex _dequesMutex;
+    Uint64 _stolenTasks;
+    Boolean _saturated;
+    Uint32 _peakQueuedTasks;
+    Uint64 _totalQueuedTasks;
+    Uint64 _totalQueueWaitUsec;
+    Uint64 _rejectedTasks;
+
+    // Number of saturated thread pools, guarded by the _admissionMutex.
+    // The _admissionCondition is signaled when it drops to zero.
+    static Uint32 _saturatedPools;
+    static Mutex _admissionMutex;
+    static Condition _admissionCondition;
 };
 
 PEGASUS_NAMESPACE_END
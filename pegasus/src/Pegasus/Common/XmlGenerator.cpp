@@ -40,6 +40,7 @@
 #include "StringConversion.h"
 #include "LanguageParser.h"
 #include "AutoPtr.h"
+#include "CharScan.h"
 
 PEGASUS_NAMESPACE_BEGIN
 
@@ -204,16 +205,6 @@ static const int _isSpecialChar7[] =
     0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,
 };
 
-// If _isSpecialChar7[ch] is true, then ch is a special character, which must
-// have a special encoding in XML. But only use 7-biat ASCII characters to
-// index this array.
-static const int _isNormalChar7[] =
-{
-    0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,1,1,0,1,1,
-    1,0,0,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,1,0,1,1,1,1,1,1,1,1,1,1,1,
-    1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,
-    1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,1,0,
-};
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -315,6 +306,17 @@ void XmlGenerator::_appendChar(Buffer& out, const Char16& c)
     out.append(str, UTF_8_COUNT_TRAIL_BYTES(str[0]) + 1);
 }
 
+// Appends a run of characters below 0x7F, which need no encoding
+static inline void _appendRun(Buffer& out, const Uint16* p, Uint32 n)
+{
+    out.reserveCapacity(out.size() + n);
+
+    for (const Uint16* end = p + n; p != end; p++)
+    {
+        out.append_unchecked(char(*p));
+    }
+}
+
 void XmlGenerator::_appendSpecialChar7(Buffer& out, char c)
 {
     if (_isSpecialChar7[int(c)])
@@ -533,13 +535,13 @@ void XmlGenerator::appendSpecial(Buffer& out, char x)
 
 void XmlGenerator::appendSpecial(Buffer& out, const char* str)
 {
-    while (*str)
-        _appendSpecialChar7(out, *str++);
+    appendSpecial(out, str, Uint32(strlen(str)));
 }
 
 void XmlGenerator::appendSpecial(Buffer& out, const String& str)
 {
     const Uint16* p = (const Uint16*)str.getChar16Data();
+    const Uint16* end = p + str.size();
     // prevCharIsSpace is true when the last character written to the Buffer
     // is a space character (not a character reference).
     Boolean prevCharIsSpace = false;
@@ -552,9 +554,34 @@ void XmlGenerator::appendSpecial(Buffer& out, const String& str)
         p++;
     }
 
-    Uint16 c;
-    while ((c = *p++) != 0)
+    while (p != end)
     {
+        // Copy the run of characters which need no encoding at once, unless
+        // it starts with a space following a space
+        if (!prevCharIsSpace || *p != ' ')
+        {
+            const Uint16* run = p;
+            p = CharScan::findXmlEscape(p, end);
+
+            if (p != run)
+            {
+                _appendRun(out, run, Uint32(p - run));
+                prevCharIsSpace = (p[-1] == ' ');
+
+                if (p == end)
+                {
+                    break;
+                }
+            }
+        }
+
+        Uint16 c = *p++;
+
+        if (c == 0)
+        {
+            break;
+        }
+
         if (c < 128)
         {
             if (_isSpecialChar7[c])
@@ -605,199 +632,28 @@ void XmlGenerator::appendSpecial(Buffer& out, const String& str)
     }
 }
 
-// str has to be UTF-8 encoded
-// that means the characters used cannot be larger than 7bit ASCII in value
-// range
+// str has to be UTF-8 encoded, the bytes of multibyte characters are copied
+// unchanged
 void XmlGenerator::appendSpecial(Buffer& out, const char* str, Uint32 size)
 {
-    // employ loop unrolling and a less checking optimized Buffer access
-
-    // Buffer cannot grow more than 6*size characters (ie. 4*size+2*size)
-    Uint32 newMaxSize = (size << 2) + (size << 1);
-    if (out.size() + newMaxSize >= out.capacity())
-    {
-        out.reserveCapacity(out.capacity() + newMaxSize);
-    }
+    const char* end = str + size;
 
-    // Before using a loop unrolled algorithm to pick out the special chars
-    // we are going to assume there is no special char as this is the case most
-    // of the time anyway
-    Uint32 sizeStart=size;
-    const Uint8* p= (const Uint8*) str;
-
-    while (size >= 4 &&
-             (_isNormalChar7[p[0]] &
-              _isNormalChar7[p[1]] &
-              _isNormalChar7[p[2]] &
-              _isNormalChar7[p[3]]))
-    {
-        size -= 4;
-        p += 4;
-    }
-    out.append_unchecked(str,sizeStart-size);
-    str=(const char*)p;
+    // Most strings contain no special characters and are copied unchanged
+    out.reserveCapacity(out.size() + size);
 
-    while (size>=8)
+    for (;;)
     {
-        register int c;
-        c = str[0];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        c = str[1];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        c = str[2];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        c = str[3];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        c = str[4];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        c = str[5];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        c = str[6];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        c = str[7];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        str+=8;
-        size-=8;
-    }
+        const char* run = str;
+        str = CharScan::findXmlEscape(str, end);
+        out.append(run, Uint32(str - run));
 
-    while (size>=4)
-    {
-        register int c;
-        c = str[0];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        c = str[1];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        c = str[2];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
+        if (str == end)
         {
-            out.append_unchecked(c);
+            break;
         }
-        c = str[3];
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        str+=4;
-        size-=4;
-    }
 
-    while (size--)
-    {
-        register int c;
-        c=*str;
-        if (_isSpecialChar7[c])
-        {
-            out.append_unchecked(
-                _specialChars[c].str,
-                _specialChars[c].size);
-        }
-        else
-        {
-            out.append_unchecked(c);
-        }
-        str++;
+        Uint8 c = Uint8(*str++);
+        out.append(_specialChars[c].str, _specialChars[c].size);
     }
 }
 
@@ -96,6 +96,7 @@
 #include "Logger.h"
 #include "ExceptionRep.h"
 #include "CharSet.h"
+#include "CharScan.h"
 
 PEGASUS_NAMESPACE_BEGIN
 
@@ -320,13 +321,7 @@ XmlParser::XmlParser(char* text, XmlNamespace* ns, Boolean hideEmptyTags)
 
 inline void _skipWhitespace(Uint32& line, char*& p)
 {
-    while (*p && _isspace(*p))
-    {
-        if (*p == '\n')
-            line++;
-
-        p++;
-    }
+    p = (char*)CharScan::skipXmlWhiteSpace(p, line);
 }
 
 #if defined(PEGASUS_PLATFORM_WIN64_IA64_MSVC) || \
@@ -432,54 +427,45 @@ static inline void _normalizeElementValue(
     char*& p,
     Uint32 &textLen)
 {
-    // Process one character at a time:
+    // Whitespace within the value is not compressed, so the characters up
+    // to the next '<' or '&' are transferred at once.  Until a reference is
+    // replaced, q == p and the characters stay in place.
 
     char* q = p;
     char *start = p;
+    char* run = q;
 
     while (*p && (*p != '<'))
     {
-        if (_isspace(*p))
-        {
-            // Trim whitespace from the end of the value, but do not compress
-            // whitespace within the value.
-
-            const char* start = p;
-
-            if (*p++ == '\n')
-            {
-                line++;
-            }
-
-            _skipWhitespace(line, p);
-
-            if (*p && (*p != '<'))
-            {
-                // Transfer internal whitespace to q without compressing it.
-                const char* i = start;
-                while (i < p)
-                {
-                    *q++ = *i++;
-                }
-            }
-            else
-            {
-                // Do not transfer trailing whitespace to q.
-                break;
-            }
-        }
-        else if (*p == '&')
+        if (*p == '&')
         {
             // Process an entity reference or a character reference.
 
             *q++ = _getRef(line, ++p);
+            run = q;
         }
         else
         {
-            *q++ = *p++;
+            char* end = (char*)CharScan::findXmlDelimiter(p, '<', '&', line);
+
+            if (q != p)
+            {
+                memmove(q, p, end - p);
+            }
+
+            q += end - p;
+            p = end;
         }
     }
 
+    // Trim whitespace from the end of the value.  Whitespace produced by a
+    // reference is part of the value.
+
+    while (q != run && _isspace(q[-1]))
+    {
+        q--;
+    }
+
     // If q got behind p, it is safe and necessary to null-terminate q
 
     if (q != p)
@@ -506,7 +492,22 @@ static inline void _normalizeAttributeValue(
 
     while (*p && (*p != end_char))
     {
-        if (_isspace(*p))
+        // Transfer the run of characters up to the next white space,
+        // end_char or '&' at once
+
+        char* run = (char*)CharScan::findXmlBreak(p, end_char, '&');
+
+        if (run != p)
+        {
+            if (q != p)
+            {
+                memmove(q, p, run - p);
+            }
+
+            q += run - p;
+            p = run;
+        }
+        else if (_isspace(*p))
         {
             // Compress sequences of whitespace characters to a single space
             // character. Update line number when newlines encountered.
@@ -3368,6 +3368,48 @@ Boolean XmlReader::getNamedInstanceElement(
     return true;
 }
 
+//------------------------------------------------------------------------------
+// getValueInstanceWithPathElement()
+//
+//     <!ELEMENT VALUE.INSTANCEWITHPATH (INSTANCEPATH,INSTANCE)>
+//
+//------------------------------------------------------------------------------
+
+Boolean XmlReader::getValueInstanceWithPathElement(
+    XmlParser& parser,
+    CIMInstance& instanceWithPath)
+{
+    XmlEntry entry;
+
+    if (!testStartTag(parser, entry, "VALUE.INSTANCEWITHPATH"))
+        return false;
+
+    CIMObjectPath instancePath;
+
+    if (!getInstancePathElement(parser, instancePath))
+    {
+        MessageLoaderParms mlParms(
+            "Common.XmlReader.EXPECTED_ELEMENT",
+            "Expected $0 element",
+            "INSTANCEPATH");
+        throw XmlValidationError(parser.getLine(), mlParms);
+    }
+
+    if (!getInstanceElement(parser, instanceWithPath))
+    {
+        MessageLoaderParms mlParms(
+            "Common.XmlReader.EXPECTED_INSTANCE_ELEMENT",
+            "expected INSTANCE element");
+        throw XmlValidationError(parser.getLine(), mlParms);
+    }
+
+    expectEndTag(parser, "VALUE.INSTANCEWITHPATH");
+
+    instanceWithPath.setPath(instancePath);
+
+    return true;
+}
+
 //------------------------------------------------------------------------------
 //
 // getObject()
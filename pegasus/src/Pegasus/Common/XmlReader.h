@@ -354,6 +354,10 @@ public:
         XmlParser& parser,
         CIMInstance& namedInstance);
 
+    static Boolean getValueInstanceWithPathElement(
+        XmlParser& parser,
+        CIMInstance& instanceWithPath);
+
     static void getObject(XmlParser& parser, CIMClass& x);
 
     static void getObject(XmlParser& parser, CIMInstance& x);
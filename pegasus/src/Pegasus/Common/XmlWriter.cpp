@@ -826,6 +826,26 @@ void XmlWriter::appendValueNamedInstanceElement(
     out << STRLIT("</VALUE.NAMEDINSTANCE>\n");
 }
 
+//------------------------------------------------------------------------------
+//
+// appendValueInstanceWithPathElement()
+//
+//     <!ELEMENT VALUE.INSTANCEWITHPATH (INSTANCEPATH,INSTANCE)>
+//
+//------------------------------------------------------------------------------
+
+void XmlWriter::appendValueInstanceWithPathElement(
+    Buffer& out,
+    const CIMInstance& instanceWithPath)
+{
+    out << STRLIT("<VALUE.INSTANCEWITHPATH>\n");
+
+    appendInstancePathElement(out, instanceWithPath.getPath());
+    appendInstanceElement(out, instanceWithPath);
+
+    out << STRLIT("</VALUE.INSTANCEWITHPATH>\n");
+}
+
 //------------------------------------------------------------------------------
 //
 // appendClassElement()
@@ -1686,7 +1706,8 @@ void XmlWriter::appendMethodCallHeader(
     const ContentLanguageList& contentLanguages,
     Uint32 contentLength,
     bool binaryRequest,
-    bool binaryResponse)
+    bool binaryResponse,
+    bool compactBinary)
 {
     char nn[] = { '0' + (rand() % 10), '0' + (rand() % 10), '\0' };
 
@@ -1706,7 +1727,12 @@ void XmlWriter::appendMethodCallHeader(
     }
     out << STRLIT("HOST: ") << host << STRLIT("\r\n");
 
-    if (binaryRequest)
+    if (binaryRequest && compactBinary)
+    {
+        // The payload uses the compact encoding of the binary protocol.
+        out << STRLIT("Content-Type: application/x-openpegasus-compact\r\n");
+    }
+    else if (binaryRequest)
     {
         // Tell the server that the payload is encoded in the OpenPegasus
         // binary protocol.
@@ -1717,7 +1743,13 @@ void XmlWriter::appendMethodCallHeader(
         out << STRLIT("Content-Type: application/xml; charset=\"utf-8\"\r\n");
     }
 
-    if (binaryResponse)
+    if (binaryResponse && compactBinary)
+    {
+        // A server that does not offer the compact encoding to remote
+        // clients responds with XML.
+        out << STRLIT("Accept: application/x-openpegasus-compact\r\n");
+    }
+    else if (binaryResponse)
     {
         // Tell the server that this client accepts the OpenPegasus binary
         // protocol.
@@ -1753,6 +1785,14 @@ void XmlWriter::appendMethodCallHeader(
         out << STRLIT("TE: chunked, trailers\r\n");
     }
 
+#ifdef PEGASUS_ENABLE_HTTP_COMPRESSION
+    if (!binaryResponse)
+    {
+        // Ask the server to compress the XML response.
+        out << STRLIT("Accept-Encoding: gzip, deflate\r\n");
+    }
+#endif
+
     if (httpMethod == HTTP_METHOD_M_POST)
     {
         out << STRLIT("Man: http://www.dmtf.org/cim/mapping/http/v1.0; ns=");
@@ -1787,7 +1827,8 @@ void XmlWriter::appendMethodResponseHeader(
      const ContentLanguageList& contentLanguages,
      Uint32 contentLength,
      Uint64 serverResponseTime,
-     bool binaryResponse)
+     bool binaryResponse,
+     bool compactBinary)
 {
     // Optimize the typical case for binary messages, circumventing the
     // more expensive logic below.
@@ -1802,11 +1843,20 @@ void XmlWriter::appendMethodResponseHeader(
             "content-length: 0000000000\r\n"
             "CIMOperation: MethodResponse\r\n"
             "\r\n";
+        static const char COMPACT_HEADERS[] =
+            "HTTP/1.1 200 OK\r\n"
+            "Content-Type: application/x-openpegasus-compact\r\n"
+            "content-length: 0000000000\r\n"
+            "CIMOperation: MethodResponse\r\n"
+            "\r\n";
 
         // The HTTP processor fills in the content-length value later.
         // It searches for a field matching "content-length" (so the first
         // character must be lower case).
-        out.append(HEADERS, sizeof(HEADERS) - 1);
+        if (compactBinary)
+            out.append(COMPACT_HEADERS, sizeof(COMPACT_HEADERS) - 1);
+        else
+            out.append(HEADERS, sizeof(HEADERS) - 1);
         return;
     }
 
@@ -1820,7 +1870,12 @@ void XmlWriter::appendMethodResponseHeader(
      }
 #endif
 
-     if (binaryResponse)
+     if (binaryResponse && compactBinary)
+     {
+         out << STRLIT(
+             "Content-Type: application/x-openpegasus-compact\r\n");
+     }
+     else if (binaryResponse)
      {
         // According to MIME RFC, the "x-" prefix should be used for all
         // non-registered values.
@@ -2555,7 +2610,8 @@ Buffer XmlWriter::formatSimpleMethodReqMessage(
     const String& authenticationHeader,
     const AcceptLanguageList& httpAcceptLanguages,
     const ContentLanguageList& httpContentLanguages,
-    bool binaryResponse)
+    bool binaryResponse,
+    bool compactBinary)
 {
     Buffer out;
     Buffer tmp;
@@ -2586,7 +2642,8 @@ Buffer XmlWriter::formatSimpleMethodReqMessage(
         httpContentLanguages,
         out.size(),
         false,
-        binaryResponse);
+        binaryResponse,
+        compactBinary);
     tmp << out;
 
     return tmp;
@@ -2681,7 +2738,8 @@ Buffer XmlWriter::formatSimpleIMethodReqMessage(
     const AcceptLanguageList& httpAcceptLanguages,
     const ContentLanguageList& httpContentLanguages,
     const Buffer& body,
-    bool binaryResponse)
+    bool binaryResponse,
+    bool compactBinary)
 {
     Buffer out;
     Buffer tmp;
@@ -2706,7 +2764,8 @@ Buffer XmlWriter::formatSimpleIMethodReqMessage(
         httpContentLanguages,
         out.size(),
         false,
-        binaryResponse);
+        binaryResponse,
+        compactBinary);
     tmp << out;
 
     return tmp;
@@ -2727,9 +2786,46 @@ Buffer XmlWriter::formatSimpleIMethodRspMessage(
     Uint64 serverResponseTime,
     Boolean isFirst,
     Boolean isLast)
+{
+    return formatSimpleIMethodRspMessage(
+        iMethodName,
+        messageId,
+        httpMethod,
+        httpContentLanguages,
+        body,
+        Buffer(),
+        serverResponseTime,
+        isFirst,
+        isLast);
+}
+
+//------------------------------------------------------------------------------
+//
+// XmlWriter::formatSimpleIMethodRspMessage()
+//
+//     Variant for the operations which return output parameters (e.g., the
+//     pull operations).  The PARAMVALUE elements in rtnParams are written
+//     after the IRETURNVALUE element.
+//
+//------------------------------------------------------------------------------
+
+Buffer XmlWriter::formatSimpleIMethodRspMessage(
+    const CIMName& iMethodName,
+    const String& messageId,
+    HttpMethod httpMethod,
+    const ContentLanguageList& httpContentLanguages,
+    const Buffer& body,
+    const Buffer& rtnParams,
+    Uint64 serverResponseTime,
+    Boolean isFirst,
+    Boolean isLast)
 {
     Buffer out;
 
+    // The body is most of the message, the headers and the enclosing
+    // elements take less than 1 KB
+    out.reserveCapacity(body.size() + rtnParams.size() + 1024);
+
     if (isFirst == true)
     {
         // NOTE: temporarily put zero for content length. the http code
@@ -2746,7 +2842,9 @@ Buffer XmlWriter::formatSimpleIMethodRspMessage(
         // 2. there is no data on the first chunk but isLast is false implying
         //    there is more non-empty data to come. If all subsequent chunks
         //    are empty, then this generates and empty response.
-        if (body.size() != 0 || isLast == false)
+        // 3. there are output parameters, which require the (possibly
+        //    empty) return value to precede them.
+        if (body.size() != 0 || isLast == false || rtnParams.size() != 0)
             _appendIReturnValueElementBegin(out);
     }
 
@@ -2757,8 +2855,9 @@ Buffer XmlWriter::formatSimpleIMethodRspMessage(
 
     if (isLast == true)
     {
-        if (body.size() != 0 || isFirst == false)
+        if (body.size() != 0 || isFirst == false || rtnParams.size() != 0)
             _appendIReturnValueElementEnd(out);
+        out << rtnParams;
         _appendIMethodResponseElementEnd(out);
         _appendSimpleRspElementEnd(out);
         _appendMessageElementEnd(out);
@@ -2823,7 +2922,9 @@ void XmlWriter::appendEMethodRequestHeader(
     const String& authenticationHeader,
     const AcceptLanguageList& acceptLanguages,
     const ContentLanguageList& contentLanguages,
-    Uint32 contentLength)
+    Uint32 contentLength,
+    bool binaryRequest,
+    bool binaryResponse)
 {
     char nn[] = { '0' + (rand() % 10), '0' + (rand() % 10), '\0' };
 
@@ -2835,8 +2936,26 @@ void XmlWriter::appendEMethodRequestHeader(
     {
       out << STRLIT("POST ") << requestUri << STRLIT(" HTTP/1.1\r\n");
     }
-    out << STRLIT("HOST: ") << host << STRLIT("\r\n"
-                  "Content-Type: application/xml; charset=\"utf-8\"\r\n");
+    out << STRLIT("HOST: ") << host << STRLIT("\r\n");
+
+    if (binaryRequest)
+    {
+        // A batch of indications in the compact encoding of the binary
+        // protocol (see BinaryCodec::encodeExportIndicationRequest()).
+        out << STRLIT("Content-Type: application/x-openpegasus-compact\r\n");
+    }
+    else
+    {
+        out << STRLIT("Content-Type: application/xml; charset=\"utf-8\"\r\n");
+    }
+
+    if (binaryResponse)
+    {
+        // An OpenPegasus listener responds in the binary protocol and
+        // thereby tells the client that it accepts binary requests.
+        out << STRLIT("Accept: application/x-openpegasus-compact\r\n");
+    }
+
     OUTPUT_CONTENTLENGTH(out, contentLength);
 
     if (acceptLanguages.size() > 0)
@@ -2895,12 +3014,22 @@ void XmlWriter::appendEMethodResponseHeader(
     Buffer& out,
     HttpMethod httpMethod,
     const ContentLanguageList& contentLanguages,
-    Uint32 contentLength)
+    Uint32 contentLength,
+    bool binaryResponse)
 {
     char nn[] = { '0' + (rand() % 10), '0' + (rand() % 10), '\0' };
 
-    out << STRLIT("HTTP/1.1 " HTTP_STATUS_OK "\r\n"
-                  "Content-Type: application/xml; charset=\"utf-8\"\r\n");
+    out << STRLIT("HTTP/1.1 " HTTP_STATUS_OK "\r\n");
+
+    if (binaryResponse)
+    {
+        out << STRLIT("Content-Type: application/x-openpegasus-compact\r\n");
+    }
+    else
+    {
+        out << STRLIT("Content-Type: application/xml; charset=\"utf-8\"\r\n");
+    }
+
     OUTPUT_CONTENTLENGTH(out, contentLength);
 
     if (contentLanguages.size() > 0)
@@ -3065,7 +3194,8 @@ Buffer XmlWriter::formatSimpleEMethodReqMessage(
     const String& authenticationHeader,
     const AcceptLanguageList& httpAcceptLanguages,
     const ContentLanguageList& httpContentLanguages,
-    const Buffer& body)
+    const Buffer& body,
+    bool binaryResponse)
 {
     Buffer out;
     Buffer tmp;
@@ -3087,7 +3217,9 @@ Buffer XmlWriter::formatSimpleEMethodReqMessage(
         authenticationHeader,
         httpAcceptLanguages,
         httpContentLanguages,
-        out.size());
+        out.size(),
+        false,
+        binaryResponse);
     tmp << out;
 
     return tmp;
@@ -126,6 +126,10 @@ public:
         Buffer& out,
         const CIMInstance& namedInstance);
 
+    static void appendValueInstanceWithPathElement(
+        Buffer& out,
+        const CIMInstance& instanceWithPath);
+
     static void appendClassElement(
         Buffer& out,
         const CIMConstClass& cimclass);
@@ -213,7 +217,8 @@ public:
         const ContentLanguageList& contentLanguages,
         Uint32 contentLength,
         bool binaryRequest = false,
-        bool binaryResponse = false);
+        bool binaryResponse = false,
+        bool compactBinary = false);
 
     static void appendMethodResponseHeader(
         Buffer& out,
@@ -221,7 +226,8 @@ public:
         const ContentLanguageList& contentLanguages,
         Uint32 contentLength,
         Uint64 serverResponseTime = 0,
-        bool binaryResponse = false);
+        bool binaryResponse = false,
+        bool compactBinary = false);
 
     static void appendHttpErrorResponseHeader(
         Buffer& out,
@@ -321,7 +327,8 @@ public:
         const String& authenticationHeader,
         const AcceptLanguageList& httpAcceptLanguages,
         const ContentLanguageList& httpContentLanguages,
-        bool binaryResponse);
+        bool binaryResponse,
+        bool compactBinary = false);
 
     static Buffer formatSimpleMethodRspMessage(
         const CIMName& methodName,
@@ -349,7 +356,8 @@ public:
         const AcceptLanguageList& httpAcceptLanguages,
         const ContentLanguageList& httpContentLanguages,
         const Buffer& body,
-        bool binaryResponse);
+        bool binaryResponse,
+        bool compactBinary = false);
 
     static Buffer formatSimpleIMethodRspMessage(
         const CIMName& iMethodName,
@@ -361,6 +369,17 @@ public:
         Boolean isFirst = true,
         Boolean isLast = true);
 
+    static Buffer formatSimpleIMethodRspMessage(
+        const CIMName& iMethodName,
+        const String& messageId,
+        HttpMethod httpMethod,
+        const ContentLanguageList& httpContentLanguages,
+        const Buffer& body,
+        const Buffer& rtnParams,
+        Uint64 serverResponseTime,
+        Boolean isFirst,
+        Boolean isLast);
+
 
     static Buffer formatSimpleIMethodErrorRspMessage(
         const CIMName& iMethodName,
@@ -382,13 +401,16 @@ public:
         const String& authenticationHeader,
         const AcceptLanguageList& acceptLanguages,
         const ContentLanguageList& contentLanguages,
-        Uint32 contentLength);
+        Uint32 contentLength,
+        bool binaryRequest = false,
+        bool binaryResponse = false);
 
     static void appendEMethodResponseHeader(
         Buffer& out,
         HttpMethod httpMethod,
         const ContentLanguageList& contentLanguages,
-        Uint32 contentLength);
+        Uint32 contentLength,
+        bool binaryResponse = false);
 
     static Buffer formatSimpleEMethodReqMessage(
         const char* requestUri,
@@ -399,7 +421,8 @@ public:
         const String& authenticationHeader,
         const AcceptLanguageList& httpAcceptLanguages,
         const ContentLanguageList& httpContentLanguages,
-        const Buffer& body);
+        const Buffer& body,
+        bool binaryResponse = false);
 
     static Buffer formatSimpleEMethodRspMessage(
         const CIMName& eMethodName,
@@ -0,0 +1,285 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/BinaryCodec.h>
+#include <Pegasus/Common/CIMMessage.h>
+#include <Pegasus/Common/XmlWriter.h>
+#include <Pegasus/Common/XmlReader.h>
+#include <Pegasus/Common/XmlParser.h>
+#include <Pegasus/General/Stopwatch.h>
+#include <cstring>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+static Boolean verbose;
+
+// Number of instances per response and number of timed rounds. The fastest
+// round is reported, which filters out the noise of other processes.
+static const Uint32 INSTANCES = 200;
+static const Uint32 ROUNDS = 8;
+static const Uint32 PASSES = 20;
+
+//
+// Builds instances shaped like CIM_ComputerSystem instances: a keyed path,
+// a few strings, integers of several sizes, an array and a datetime.
+//
+static Array<CIMInstance> _makeInstances()
+{
+    Array<CIMInstance> instances;
+
+    for (Uint32 i = 0; i < INSTANCES; i++)
+    {
+        char name[32];
+        sprintf(name, "host%u.example.com", i);
+
+        CIMInstance ci("PG_ComputerSystem");
+        ci.addProperty(CIMProperty("CreationClassName",
+            String("PG_ComputerSystem")));
+        ci.addProperty(CIMProperty("Name", String(name)));
+        ci.addProperty(CIMProperty("Caption", String("Computer System")));
+        ci.addProperty(CIMProperty("Description",
+            String("This is the computer system of the CIM Server")));
+        ci.addProperty(CIMProperty("EnabledState", Uint16(2)));
+        ci.addProperty(CIMProperty("RequestedState", Uint16(12)));
+        ci.addProperty(CIMProperty("PrimaryOwnerName", String("Operator")));
+        ci.addProperty(CIMProperty("NumberOfProcessors", Uint32(i % 64)));
+        ci.addProperty(CIMProperty("TotalMemory",
+            Uint64(i) * PEGASUS_UINT64_LITERAL(1073741824)));
+        ci.addProperty(CIMProperty("Offset", Sint32(-300)));
+
+        Array<Uint16> dedicated;
+        dedicated.append(0);
+        dedicated.append(2);
+        ci.addProperty(CIMProperty("Dedicated", dedicated));
+
+        ci.addProperty(CIMProperty("InstallDate",
+            CIMDateTime("20090602104500.123456+330")));
+
+        Array<CIMKeyBinding> keys;
+        keys.append(CIMKeyBinding("CreationClassName", "PG_ComputerSystem",
+            CIMKeyBinding::STRING));
+        keys.append(CIMKeyBinding("Name", name, CIMKeyBinding::STRING));
+        ci.setPath(CIMObjectPath(String(), CIMNamespaceName(),
+            "PG_ComputerSystem", keys));
+
+        instances.append(ci);
+    }
+
+    return instances;
+}
+
+static Buffer _encodeXml(const Array<CIMInstance>& instances)
+{
+    Buffer out;
+    out << STRLIT("<IRETURNVALUE>\n");
+
+    for (Uint32 i = 0; i < instances.size(); i++)
+    {
+        XmlWriter::appendValueNamedInstanceElement(out, instances[i]);
+    }
+
+    out << STRLIT("</IRETURNVALUE>\n");
+    return out;
+}
+
+static Uint32 _decodeXml(const Buffer& xml)
+{
+    // The parser modifies the text, so it parses a copy.
+    Buffer text(xml);
+    XmlParser parser((char*)text.getData());
+    XmlEntry entry;
+    CIMInstance instance;
+    Uint32 n = 0;
+
+    XmlReader::expectStartTag(parser, entry, "IRETURNVALUE");
+
+    while (XmlReader::getNamedInstanceElement(parser, instance))
+    {
+        n++;
+    }
+
+    XmlReader::expectEndTag(parser, "IRETURNVALUE");
+    return n;
+}
+
+static Buffer _encodeBinary(const Array<CIMInstance>& instances, bool compact)
+{
+    CIMEnumerateInstancesResponseMessage msg(
+        "1", CIMException(), QueueIdStack());
+    msg.getResponseData().setInstances(instances);
+    msg.compactBinaryResponse = compact;
+
+    Buffer body;
+    CIMName name;
+    PEGASUS_TEST_ASSERT(BinaryCodec::encodeResponseBody(body, &msg, name));
+    PEGASUS_TEST_ASSERT(name == "EnumerateInstances");
+
+    // Format the HTTP response as the server does and keep its content.
+    Buffer rsp = compact ?
+        BinaryCodec::formatSimpleIMethodCompactRspMessage(name, msg.messageId,
+            HTTP_METHOD__POST, ContentLanguageList(), body, 0, true, true) :
+        BinaryCodec::formatSimpleIMethodRspMessage(name, msg.messageId,
+            HTTP_METHOD__POST, ContentLanguageList(), body, 0, true, true);
+
+    const char* data = rsp.getData();
+    const char* content = strstr(data, "\r\n\r\n");
+    PEGASUS_TEST_ASSERT(content != 0);
+    content += 4;
+
+    return Buffer(content, rsp.size() - Uint32(content - data));
+}
+
+static Uint32 _decodeBinary(const Buffer& in, bool compact)
+{
+    AutoPtr<CIMResponseMessage> msg(BinaryCodec::decodeResponse(in, compact));
+    PEGASUS_TEST_ASSERT(msg->compactBinaryResponse == compact);
+
+    // Instances are decoded when they are first asked for.
+    return ((CIMEnumerateInstancesResponseMessage*)msg.get())->
+        getResponseData().getInstances().size();
+}
+
+static double _time(const char* label, const Buffer& data, Uint32 format)
+{
+    double seconds = 0;
+
+    for (Uint32 round = 0; round < ROUNDS; round++)
+    {
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        for (Uint32 i = 0; i < PASSES; i++)
+        {
+            Uint32 n = format == 0 ?
+                _decodeXml(data) : _decodeBinary(data, format == 2);
+            PEGASUS_TEST_ASSERT(n == INSTANCES);
+        }
+
+        stopwatch.stop();
+
+        if (round == 0 || stopwatch.getElapsed() < seconds)
+        {
+            seconds = stopwatch.getElapsed();
+        }
+    }
+
+    double rate = double(INSTANCES) * PASSES / seconds / 1000;
+
+    if (verbose)
+    {
+        printf("%-16s %8u bytes %8.1f instances/ms\n",
+            label, data.size(), rate);
+    }
+
+    return rate;
+}
+
+//
+// Compares the encodings of an EnumerateInstances response: CIM-XML, the
+// aligned binary encoding of local connections and the compact binary
+// encoding of remote connections.
+//
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    try
+    {
+        Array<CIMInstance> instances = _makeInstances();
+
+        Buffer xml = _encodeXml(instances);
+        Buffer aligned = _encodeBinary(instances, false);
+        Buffer compact = _encodeBinary(instances, true);
+
+        // The compact response decodes to the same instances.
+        {
+            AutoPtr<CIMResponseMessage> msg(
+                BinaryCodec::decodeResponse(compact, true));
+            Array<CIMInstance>& result =
+                ((CIMEnumerateInstancesResponseMessage*)msg.get())->
+                    getResponseData().getInstances();
+            PEGASUS_TEST_ASSERT(result.size() == INSTANCES);
+
+            for (Uint32 i = 0; i < INSTANCES; i++)
+            {
+                PEGASUS_TEST_ASSERT(result[i].identical(instances[i]));
+            }
+        }
+
+        // A response is not decoded in the encoding it was not sent with.
+        {
+            Boolean caught = false;
+
+            try
+            {
+                AutoPtr<CIMResponseMessage> msg(
+                    BinaryCodec::decodeResponse(compact, false));
+            }
+            catch (CIMException&)
+            {
+                caught = true;
+            }
+
+            PEGASUS_TEST_ASSERT(caught);
+            caught = false;
+
+            try
+            {
+                AutoPtr<CIMResponseMessage> msg(
+                    BinaryCodec::decodeResponse(aligned, true));
+            }
+            catch (CIMException&)
+            {
+                caught = true;
+            }
+
+            PEGASUS_TEST_ASSERT(caught);
+        }
+
+        // The compact encoding is smaller than both other encodings.
+        PEGASUS_TEST_ASSERT(compact.size() < aligned.size());
+        PEGASUS_TEST_ASSERT(compact.size() < xml.size());
+
+        _time("xml", xml, 0);
+        _time("binary", aligned, 1);
+        _time("compact-binary", compact, 2);
+    }
+    catch (Exception& e)
+    {
+        cerr << "Error: " << e.getMessage() << endl;
+        return 1;
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
@@ -250,6 +250,189 @@ void test10()
     PEGASUS_TEST_ASSERT(dateTime1.toString() == dateTime2.toString());
 }
 
+// Compact encoding: scalars at their boundaries round-trip.
+void test11()
+{
+    CIMBuffer cb;
+    cb.setCompact(true);
+
+    const Sint64 s64Max = PEGASUS_SINT64_LITERAL(0x7FFFFFFFFFFFFFFF);
+    const Uint64 u64[] =
+    {
+        0, 1, 127, 128, 16383, 16384, 0xFFFFFFFF,
+        PEGASUS_UINT64_LITERAL(0xFFFFFFFFFFFFFFFF)
+    };
+    const Sint64 s64[] =
+    {
+        0, -1, 1, -64, 64, -2147483647 - 1, s64Max, -s64Max - 1
+    };
+    const Uint32 n = sizeof(u64) / sizeof(u64[0]);
+
+    for (Uint32 i = 0; i < n; i++)
+    {
+        cb.putUint8(Uint8(u64[i]));
+        cb.putSint8(Sint8(s64[i]));
+        cb.putUint16(Uint16(u64[i]));
+        cb.putSint16(Sint16(s64[i]));
+        cb.putUint32(Uint32(u64[i]));
+        cb.putSint32(Sint32(s64[i]));
+        cb.putUint64(u64[i]);
+        cb.putSint64(s64[i]);
+        cb.putChar16(Char16(Uint16(u64[i])));
+    }
+
+    cb.putBoolean(true);
+    cb.putReal32(Real32(-1.5));
+    cb.putReal64(Real64(3.25e-300));
+
+    // Small values take one byte each.
+    CIMBuffer small;
+    small.setCompact(true);
+    small.putUint32(100);
+    small.putSint32(-3);
+    small.putUint64(127);
+    PEGASUS_TEST_ASSERT(small.size() == 3);
+
+    cb.rewind();
+
+    for (Uint32 i = 0; i < n; i++)
+    {
+        Uint8 u8; Sint8 s8; Uint16 u16; Sint16 s16;
+        Uint32 u32; Sint32 s32; Uint64 u; Sint64 s; Char16 c;
+
+        PEGASUS_TEST_ASSERT(cb.getUint8(u8) && u8 == Uint8(u64[i]));
+        PEGASUS_TEST_ASSERT(cb.getSint8(s8) && s8 == Sint8(s64[i]));
+        PEGASUS_TEST_ASSERT(cb.getUint16(u16) && u16 == Uint16(u64[i]));
+        PEGASUS_TEST_ASSERT(cb.getSint16(s16) && s16 == Sint16(s64[i]));
+        PEGASUS_TEST_ASSERT(cb.getUint32(u32) && u32 == Uint32(u64[i]));
+        PEGASUS_TEST_ASSERT(cb.getSint32(s32) && s32 == Sint32(s64[i]));
+        PEGASUS_TEST_ASSERT(cb.getUint64(u) && u == u64[i]);
+        PEGASUS_TEST_ASSERT(cb.getSint64(s) && s == s64[i]);
+        PEGASUS_TEST_ASSERT(cb.getChar16(c) && c == Char16(Uint16(u64[i])));
+    }
+
+    Boolean b;
+    Real32 r32;
+    Real64 r64;
+    PEGASUS_TEST_ASSERT(cb.getBoolean(b) && b == true);
+    PEGASUS_TEST_ASSERT(cb.getReal32(r32) && r32 == Real32(-1.5));
+    PEGASUS_TEST_ASSERT(cb.getReal64(r64) && r64 == Real64(3.25e-300));
+}
+
+// Compact encoding: strings are UTF-8, names go through the name table.
+void test12()
+{
+    CIMBuffer cb;
+    cb.setCompact(true);
+
+    Char16 utf16[] = { 'A', 0x00E9, 0x20AC, 0xD801, 0xDC37, 0 };
+    String text(utf16);
+
+    cb.putString(text);
+    cb.putString(String());
+    cb.putName(CIMName("CIM_ComputerSystem"));
+    cb.putNamespaceName(CIMNamespaceName("root/cimv2"));
+    Uint32 before = cb.size();
+    cb.putName(CIMName("CIM_ComputerSystem"));
+    cb.putNamespaceName(CIMNamespaceName("root/cimv2"));
+
+    // Repeated names are one-byte references.
+    PEGASUS_TEST_ASSERT(cb.size() - before == 2);
+
+    // A type marker starts a new segment with empty tables.
+    cb.putTypeMarker(1);
+    cb.putName(CIMName("CIM_ComputerSystem"));
+    PEGASUS_TEST_ASSERT(cb.size() - before > 3);
+
+    Array<String> strings;
+    strings.append(text);
+    strings.append("plain");
+    cb.putStringA(strings);
+
+    Array<Uint16> u16;
+    u16.append(0);
+    u16.append(300);
+    u16.append(65535);
+    cb.putUint16A(u16);
+
+    Array<Sint64> s64;
+    s64.append(-1);
+    s64.append(PEGASUS_SINT64_LITERAL(1) << 40);
+    cb.putSint64A(s64);
+
+    cb.rewind();
+
+    String x;
+    CIMName name;
+    CIMNamespaceName ns;
+    Uint32 marker;
+    PEGASUS_TEST_ASSERT(cb.getString(x) && x == text);
+    PEGASUS_TEST_ASSERT(cb.getString(x) && x.size() == 0);
+    PEGASUS_TEST_ASSERT(cb.getName(name) && name == "CIM_ComputerSystem");
+    PEGASUS_TEST_ASSERT(cb.getNamespaceName(ns) && ns == "root/cimv2");
+    PEGASUS_TEST_ASSERT(cb.getName(name) && name == "CIM_ComputerSystem");
+    PEGASUS_TEST_ASSERT(cb.getNamespaceName(ns) && ns == "root/cimv2");
+    PEGASUS_TEST_ASSERT(cb.getTypeMarker(marker) && marker == 1);
+    PEGASUS_TEST_ASSERT(cb.getName(name) && name == "CIM_ComputerSystem");
+
+    Array<String> strings2;
+    Array<Uint16> u16b;
+    Array<Sint64> s64b;
+    PEGASUS_TEST_ASSERT(cb.getStringA(strings2) && strings2 == strings);
+    PEGASUS_TEST_ASSERT(cb.getUint16A(u16b) && u16b == u16);
+    PEGASUS_TEST_ASSERT(cb.getSint64A(s64b) && s64b == s64);
+}
+
+// Compact encoding: instances round-trip, are smaller than the aligned
+// encoding, and truncated or corrupt data is rejected.
+void test13()
+{
+    CIMInstance ci1("MyClass");
+    ci1.addProperty(CIMProperty("Number", Uint32(12345)));
+    ci1.addProperty(CIMProperty("Flag", Boolean(true)));
+    ci1.addProperty(CIMProperty("Message", String("Hello")));
+    ci1.addProperty(CIMProperty("Temperature", Sint16(-40)));
+    ci1.addProperty(CIMProperty("Ratio", Real64(0.5)));
+    ci1.setPath(CIMObjectPath("MyClass.Number=12345"));
+
+    CIMBuffer aligned;
+    aligned.putInstance(ci1);
+    aligned.putInstance(ci1);
+
+    CIMBuffer compact;
+    compact.setCompact(true);
+    compact.putInstance(ci1);
+    compact.putInstance(ci1);
+
+    PEGASUS_TEST_ASSERT(compact.size() < aligned.size() / 2);
+
+    compact.rewind();
+    CIMInstance ci2;
+    CIMInstance ci3;
+    PEGASUS_TEST_ASSERT(compact.getInstance(ci2));
+    PEGASUS_TEST_ASSERT(compact.getInstance(ci3));
+    PEGASUS_TEST_ASSERT(ci1.identical(ci2));
+    PEGASUS_TEST_ASSERT(ci1.identical(ci3));
+
+    // Every truncation of the data fails cleanly.
+    for (Uint32 n = 0; n < compact.size() / 2; n++)
+    {
+        CIMBuffer truncated((char*)compact.getData(), n);
+        truncated.setCompact(true);
+        CIMInstance ci;
+        PEGASUS_TEST_ASSERT(!truncated.getInstance(ci));
+        truncated.release();
+    }
+
+    // A name reference past the end of the table is rejected.
+    CIMBuffer bad;
+    bad.setCompact(true);
+    bad.putUint32(5);
+    bad.rewind();
+    CIMName name;
+    PEGASUS_TEST_ASSERT(!bad.getName(name));
+}
+
 int main(int argc, char** argv)
 {
     test1();
@@ -262,6 +445,9 @@ int main(int argc, char** argv)
     test8();
     test9();
     test10();
+    test11();
+    test12();
+    test13();
 
     cout << argv[0] << " +++++ passed all tests" << endl;
     return 0;
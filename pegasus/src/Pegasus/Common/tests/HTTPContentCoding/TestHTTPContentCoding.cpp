@@ -0,0 +1,256 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/Exception.h>
+#include <Pegasus/Common/HTTPContentCoding.h>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+#define VCOUT if (verbose) cout
+
+static Boolean verbose;
+
+static void _append(Buffer& content, const char* text)
+{
+    content.append(text, (Uint32)strlen(text));
+}
+
+static void _makeContent(Buffer& content, Uint32 instances)
+{
+    _append(content,
+        "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n<IRETURNVALUE>\n");
+
+    for (Uint32 i = 0; i < instances; i++)
+    {
+        char line[256];
+        sprintf(line,
+            "<VALUE.NAMEDINSTANCE><INSTANCE CLASSNAME=\"Test_Class\">"
+            "<PROPERTY NAME=\"Id\" TYPE=\"uint32\"><VALUE>%u</VALUE>"
+            "</PROPERTY></INSTANCE></VALUE.NAMEDINSTANCE>\n", i);
+        _append(content, line);
+    }
+
+    _append(content, "</IRETURNVALUE>\n");
+}
+
+static void testAcceptEncoding()
+{
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::parseAcceptEncoding("gzip") ==
+        HTTPContentCoding::GZIP);
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::parseAcceptEncoding(
+        "deflate, gzip") == HTTPContentCoding::GZIP);
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::parseAcceptEncoding(
+        " GZIP ; q=0.5 ") == HTTPContentCoding::GZIP);
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::parseAcceptEncoding(
+        "gzip;q=0, deflate") == HTTPContentCoding::DEFLATE);
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::parseAcceptEncoding(
+        "gzip;q=0.0, deflate;q=0") == HTTPContentCoding::IDENTITY);
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::parseAcceptEncoding("*") ==
+        HTTPContentCoding::GZIP);
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::parseAcceptEncoding(
+        "*, gzip;q=0") == HTTPContentCoding::DEFLATE);
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::parseAcceptEncoding(
+        "identity, compress") == HTTPContentCoding::IDENTITY);
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::parseAcceptEncoding(
+        "gzipx, ,") == HTTPContentCoding::IDENTITY);
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::parseAcceptEncoding("") ==
+        HTTPContentCoding::IDENTITY);
+
+    HTTPContentCoding::Coding coding;
+    PEGASUS_TEST_ASSERT(
+        HTTPContentCoding::parseContentEncoding(" gzip", coding) &&
+        coding == HTTPContentCoding::GZIP);
+    PEGASUS_TEST_ASSERT(
+        HTTPContentCoding::parseContentEncoding("Deflate ", coding) &&
+        coding == HTTPContentCoding::DEFLATE);
+    PEGASUS_TEST_ASSERT(
+        HTTPContentCoding::parseContentEncoding("identity", coding) &&
+        coding == HTTPContentCoding::IDENTITY);
+    PEGASUS_TEST_ASSERT(
+        !HTTPContentCoding::parseContentEncoding("compress", coding));
+}
+
+static void testRoundTrip(HTTPContentCoding::Coding coding)
+{
+    Buffer content;
+    _makeContent(content, 1000);
+
+    Buffer compressed;
+    HTTPContentCoding(coding).compress(
+        content.getData(), content.size(), true, compressed);
+
+    VCOUT << HTTPContentCoding::getName(coding) << ": " << content.size() <<
+        " bytes compressed to " << compressed.size() << endl;
+
+    PEGASUS_TEST_ASSERT(compressed.size() < content.size() / 4);
+
+    if (coding == HTTPContentCoding::GZIP)
+    {
+        // gzip magic number
+        PEGASUS_TEST_ASSERT((unsigned char)compressed[0] == 0x1f);
+        PEGASUS_TEST_ASSERT((unsigned char)compressed[1] == 0x8b);
+    }
+
+    Buffer decompressed;
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::decompress(
+        coding, compressed.getData(), compressed.size(), decompressed));
+    PEGASUS_TEST_ASSERT(decompressed.size() == content.size());
+    PEGASUS_TEST_ASSERT(memcmp(decompressed.getData(), content.getData(),
+        content.size()) == 0);
+
+    // A truncated stream must be rejected.
+    decompressed.clear();
+    PEGASUS_TEST_ASSERT(!HTTPContentCoding::decompress(
+        coding, compressed.getData(), compressed.size() / 2, decompressed));
+
+    // So must data that was not compressed at all.
+    decompressed.clear();
+    PEGASUS_TEST_ASSERT(!HTTPContentCoding::decompress(
+        coding, content.getData(), content.size(), decompressed));
+}
+
+static void testStreaming()
+{
+    // Compress the pieces of a chunked response as one stream. Every flushed
+    // piece must decode to everything compressed so far.
+    HTTPContentCoding coder(HTTPContentCoding::GZIP);
+    Buffer content;
+    Buffer compressed;
+
+    for (Uint32 i = 0; i < 10; i++)
+    {
+        Buffer piece;
+        _makeContent(piece, 10 * (i + 1));
+        content.append(piece.getData(), piece.size());
+
+        Uint32 before = compressed.size();
+        coder.compress(piece.getData(), piece.size(), false, compressed);
+        PEGASUS_TEST_ASSERT(compressed.size() > before);
+    }
+
+    // An empty flush adds nothing.
+    Uint32 before = compressed.size();
+    coder.compress(0, 0, false, compressed);
+    PEGASUS_TEST_ASSERT(compressed.size() == before);
+
+    // The last piece may be empty; finishing still writes the gzip trailer.
+    coder.compress(0, 0, true, compressed);
+    PEGASUS_TEST_ASSERT(compressed.size() > before);
+
+    Buffer decompressed;
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::decompress(HTTPContentCoding::GZIP,
+        compressed.getData(), compressed.size(), decompressed));
+    PEGASUS_TEST_ASSERT(decompressed.size() == content.size());
+    PEGASUS_TEST_ASSERT(memcmp(decompressed.getData(), content.getData(),
+        content.size()) == 0);
+}
+
+static void testDecompressionLimit(HTTPContentCoding::Coding coding)
+{
+    // A megabyte of zeros compresses by a factor of more than a hundred even
+    // at the fastest level, the kind of body used to exhaust the memory of
+    // the receiver.
+    Buffer content;
+    content.grow(1024 * 1024, '\0');
+
+    Buffer compressed;
+    HTTPContentCoding(coding).compress(
+        content.getData(), content.size(), true, compressed);
+
+    VCOUT << HTTPContentCoding::getName(coding) << ": " << content.size() <<
+        " zero bytes compressed to " << compressed.size() << endl;
+
+    PEGASUS_TEST_ASSERT(compressed.size() < content.size() / 100);
+
+    // Exactly the decompressed size is accepted.
+    Buffer decompressed;
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::decompress(coding,
+        compressed.getData(), compressed.size(), decompressed,
+        content.size()));
+    PEGASUS_TEST_ASSERT(decompressed.size() == content.size());
+
+    // One byte less is rejected.
+    decompressed.clear();
+    PEGASUS_TEST_ASSERT(!HTTPContentCoding::decompress(coding,
+        compressed.getData(), compressed.size(), decompressed,
+        content.size() - 1));
+
+    // Decompression stops at the limit rather than inflating everything.
+    decompressed.clear();
+    PEGASUS_TEST_ASSERT(!HTTPContentCoding::decompress(coding,
+        compressed.getData(), compressed.size(), decompressed, 65536));
+    PEGASUS_TEST_ASSERT(decompressed.size() <= 65536);
+
+    // The limit applies to the data appended, not to what the buffer held.
+    decompressed.clear();
+    decompressed.append("x", 1);
+    PEGASUS_TEST_ASSERT(HTTPContentCoding::decompress(coding,
+        compressed.getData(), compressed.size(), decompressed,
+        content.size()));
+    PEGASUS_TEST_ASSERT(decompressed.size() == content.size() + 1);
+
+    // The identity coding is limited as well.
+    decompressed.clear();
+    PEGASUS_TEST_ASSERT(!HTTPContentCoding::decompress(
+        HTTPContentCoding::IDENTITY, content.getData(), content.size(),
+        decompressed, content.size() - 1));
+    PEGASUS_TEST_ASSERT(decompressed.size() == 0);
+}
+
+int main (int argc, char *argv[])
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    try
+    {
+        testAcceptEncoding();
+        testRoundTrip(HTTPContentCoding::GZIP);
+        testRoundTrip(HTTPContentCoding::DEFLATE);
+        testStreaming();
+        testDecompressionLimit(HTTPContentCoding::GZIP);
+        testDecompressionLimit(HTTPContentCoding::DEFLATE);
+    }
+    catch (Exception& e)
+    {
+        cout << endl << "Exception: " ;
+        cout << e.getMessage() << endl << endl ;
+        exit(-1);
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
@@ -0,0 +1,323 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/MessageQueueService.h>
+#include <Pegasus/Common/CimomMessage.h>
+#include <Pegasus/Common/AsyncOpNode.h>
+#include <Pegasus/Common/Thread.h>
+#include <Pegasus/Common/PooledAllocator.h>
+#include <Pegasus/General/Stopwatch.h>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+static Boolean verbose;
+
+// Number of threads sending requests to the server concurrently and the
+// number of requests each of them sends in one test
+static const Uint32 SENDERS = 4;
+static const Uint32 MESSAGES = 10000;
+
+// Number of requests each sender keeps in flight at most, like clients
+// that wait for their responses
+static const Uint32 WINDOW = 64;
+
+class ThroughputRequest : public AsyncRequest
+{
+public:
+    ThroughputRequest(
+        AsyncOpNode* op,
+        Uint32 destination,
+        Uint32 sender_,
+        Uint32 sequence_)
+        : AsyncRequest(CIM_DELETE_CLASS_REQUEST_MESSAGE, 0, op, destination),
+          sender(sender_),
+          sequence(sequence_)
+    {
+    }
+
+    Uint32 sender;
+    Uint32 sequence;
+};
+
+//
+// The server counts the requests it handles and checks that the requests
+// of each sender are routed to it in the order in which they were sent.
+//
+class ThroughputServer : public MessageQueueService
+{
+public:
+    ThroughputServer()
+        : MessageQueueService("throughput server")
+    {
+        for (Uint32 i = 0; i < SENDERS; i++)
+        {
+            lastSequence[i] = 0;
+        }
+    }
+
+    virtual void handleEnqueue()
+    {
+        PEGASUS_TEST_ASSERT(0);
+    }
+
+    virtual void handleEnqueue(Message*)
+    {
+        PEGASUS_TEST_ASSERT(0);
+    }
+
+    AtomicInt handled;
+    AtomicInt outOfOrder;
+
+protected:
+    // All the operations for one service are accepted by the same routing
+    // thread, so lastSequence needs no lock.
+    virtual Boolean accept_async(AsyncOpNode* op)
+    {
+        Message* msg = op->getRequest();
+
+        if (msg->getType() == CIM_DELETE_CLASS_REQUEST_MESSAGE)
+        {
+            ThroughputRequest* req = static_cast<ThroughputRequest*>(msg);
+
+            if (req->sequence != lastSequence[req->sender] + 1)
+            {
+                outOfOrder++;
+            }
+            lastSequence[req->sender] = req->sequence;
+        }
+
+        return MessageQueueService::accept_async(op);
+    }
+
+    virtual void _handle_async_request(AsyncRequest* req)
+    {
+        if (req->getType() == CIM_DELETE_CLASS_REQUEST_MESSAGE)
+        {
+            handled++;
+            _make_response(req, async_results::OK);
+        }
+        else
+        {
+            MessageQueueService::_handle_async_request(req);
+        }
+    }
+
+private:
+    Uint32 lastSequence[SENDERS];
+};
+
+class ThroughputClient : public MessageQueueService
+{
+public:
+    ThroughputClient(const char* name)
+        : MessageQueueService(name)
+    {
+    }
+
+    virtual void handleEnqueue()
+    {
+        PEGASUS_TEST_ASSERT(0);
+    }
+
+    virtual void handleEnqueue(Message*)
+    {
+        PEGASUS_TEST_ASSERT(0);
+    }
+
+    static void callback(AsyncOpNode* op, MessageQueue* q, void* parm)
+    {
+        AsyncReply* reply = static_cast<AsyncReply*>(op->getResponse());
+        PEGASUS_TEST_ASSERT(reply != 0);
+        PEGASUS_TEST_ASSERT(reply->result == async_results::OK);
+
+        delete op;
+        completed++;
+    }
+
+    static AtomicInt completed;
+};
+
+AtomicInt ThroughputClient::completed;
+
+// Number of requests sent and done (handled or completed) in one test
+static AtomicInt _sent;
+static AtomicInt* _done;
+
+struct Sender
+{
+    ThroughputClient* client;
+    Uint32 serverId;
+    Uint32 index;
+    Uint32 sequence;
+    Boolean forget;
+};
+
+static ThreadReturnType PEGASUS_THREAD_CDECL _sendProc(void* parm)
+{
+    Thread* myself = reinterpret_cast<Thread*>(parm);
+    Sender* sender = reinterpret_cast<Sender*>(myself->get_parm());
+
+    for (Uint32 i = 0; i < MESSAGES; i++)
+    {
+        while (Uint32(_sent.get() - _done->get()) >= SENDERS * WINDOW)
+        {
+            Threads::yield();
+        }
+        _sent++;
+
+        if (sender->forget)
+        {
+            ThroughputRequest* req = new ThroughputRequest(
+                0, sender->serverId, sender->index, ++sender->sequence);
+            PEGASUS_TEST_ASSERT(MessageQueueService::SendForget(req));
+        }
+        else
+        {
+            AsyncOpNode* op = MessageQueueService::get_op();
+            new ThroughputRequest(
+                op, sender->serverId, sender->index, ++sender->sequence);
+            PEGASUS_TEST_ASSERT(sender->client->SendAsync(
+                op,
+                sender->serverId,
+                ThroughputClient::callback,
+                sender->client,
+                0));
+        }
+    }
+
+    return ThreadReturnType(0);
+}
+
+//
+// Sends MESSAGES requests from each sender and waits until all of them are
+// done, returning the number of messages processed per second.
+//
+static double _measureThroughput(
+    ThroughputServer& server,
+    Sender* senders,
+    Boolean forget)
+{
+    Uint32 total = SENDERS * MESSAGES;
+    AtomicInt& done = forget ? server.handled : ThroughputClient::completed;
+    done.set(0);
+    _sent.set(0);
+    _done = &done;
+
+    Stopwatch stopwatch;
+    stopwatch.start();
+
+    Thread* threads[SENDERS];
+    for (Uint32 i = 0; i < SENDERS; i++)
+    {
+        senders[i].forget = forget;
+        threads[i] = new Thread(_sendProc, &senders[i], false);
+        PEGASUS_TEST_ASSERT(threads[i]->run() == PEGASUS_THREAD_OK);
+    }
+
+    for (Uint32 i = 0; i < SENDERS; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    while (done.get() < total)
+    {
+        Threads::yield();
+    }
+
+    stopwatch.stop();
+
+    PEGASUS_TEST_ASSERT(done.get() == total);
+    PEGASUS_TEST_ASSERT(server.outOfOrder.get() == 0);
+
+    return total / stopwatch.getElapsed();
+}
+
+int main(int, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    try
+    {
+        ThroughputServer* server = new ThroughputServer();
+        ThroughputClient* clients[SENDERS];
+        Sender senders[SENDERS];
+
+        for (Uint32 i = 0; i < SENDERS; i++)
+        {
+            char name[32];
+            sprintf(name, "throughput client %u", i);
+            clients[i] = new ThroughputClient(name);
+
+            senders[i].client = clients[i];
+            senders[i].serverId = server->getQueueId();
+            senders[i].index = i;
+            senders[i].sequence = 0;
+        }
+
+        double forgetRate = _measureThroughput(*server, senders, true);
+        double asyncRate = _measureThroughput(*server, senders, false);
+
+        if (verbose)
+        {
+            cout << "Message throughput with " << SENDERS << " senders and "
+                 << PEGASUS_CIMOM_ROUTING_THREADS << " routing threads:"
+                 << endl;
+            cout << "    SendForget: " << forgetRate << " messages/sec"
+                 << endl;
+            cout << "    SendAsync:  " << asyncRate << " messages/sec"
+                 << endl;
+
+            Uint64 hits;
+            Uint64 misses;
+            PooledAllocator::getStatistics(hits, misses);
+            cout << "Pooled allocations: " << hits << " hits, " << misses
+                 << " misses" << endl;
+        }
+
+        for (Uint32 i = 0; i < SENDERS; i++)
+        {
+            delete clients[i];
+        }
+        delete server;
+    }
+    catch (Exception& e)
+    {
+        cerr << "Error: " << e.getMessage() << endl;
+        exit(1);
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
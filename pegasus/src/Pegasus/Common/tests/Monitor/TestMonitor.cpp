@@ -0,0 +1,348 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+//
+// Tests the Monitor and its pollers, and measures how the latency of a
+// single socket event changes as the number of idle sockets registered
+// with the Monitor grows.  The latency table is printed when
+// PEGASUS_TEST_VERBOSE is set.
+//
+
+#include <Pegasus/Common/Network.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/Monitor.h>
+#include <Pegasus/Common/MonitorPoller.h>
+#include <Pegasus/Common/MonitorPool.h>
+#include <Pegasus/Common/MessageQueue.h>
+#include <Pegasus/General/Stopwatch.h>
+#include <sys/resource.h>
+
+PEGASUS_USING_STD;
+PEGASUS_USING_PEGASUS;
+
+static Boolean verbose;
+
+static const Uint32 ITERATIONS = 200;
+
+/**
+    Receives the SocketMessages posted by the Monitor and consumes the data
+    on the socket so the Monitor does not report it again.
+*/
+class SocketCounter : public MessageQueue
+{
+public:
+
+    SocketCounter() : MessageQueue("SocketCounter"), count(0)
+    {
+    }
+
+    virtual void handleEnqueue()
+    {
+        Message* message;
+
+        while ((message = dequeue()) != 0)
+        {
+            PEGASUS_TEST_ASSERT(message->getType() == SOCKET_MESSAGE);
+            char buffer[32];
+            Socket::read(
+                static_cast<SocketMessage*>(message)->socket, buffer, 32);
+            count++;
+            delete message;
+        }
+    }
+
+    // Incremented by the MonitorPool threads in testMonitorPool()
+    AtomicInt count;
+};
+
+struct TestPipe
+{
+    SocketHandle readHandle;
+    SocketHandle writeHandle;
+    int index;
+};
+
+static TestPipe _createPipe(
+    Monitor& monitor,
+    SocketCounter& counter)
+{
+    int fds[2];
+    PEGASUS_TEST_ASSERT(pipe(fds) == 0);
+    Socket::disableBlocking(fds[0]);
+
+    TestPipe testPipe;
+    testPipe.readHandle = fds[0];
+    testPipe.writeHandle = fds[1];
+    testPipe.index = monitor.solicitSocketMessages(
+        fds[0],
+        SocketMessage::READ,
+        counter.getQueueId(),
+        MonitorEntry::TYPE_ACCEPTOR);
+    PEGASUS_TEST_ASSERT(testPipe.index > 0);
+
+    return testPipe;
+}
+
+static void _destroyPipe(Monitor& monitor, TestPipe& testPipe)
+{
+    monitor.unsolicitSocketMessages(testPipe.readHandle);
+    Socket::close(testPipe.readHandle);
+    Socket::close(testPipe.writeHandle);
+}
+
+//
+// Verifies that events are delivered for IDLE entries only and that
+// unsolicited sockets are no longer reported.
+//
+static void testEvents(Monitor& monitor)
+{
+    SocketCounter counter;
+
+    TestPipe p1 = _createPipe(monitor, counter);
+    TestPipe p2 = _createPipe(monitor, counter);
+
+    // No activity
+    monitor.run(10);
+    PEGASUS_TEST_ASSERT(counter.count.get() == 0);
+
+    // One event on each socket
+    Socket::write(p1.writeHandle, "x", 1);
+    monitor.run(1000);
+    PEGASUS_TEST_ASSERT(counter.count.get() == 1);
+
+    Socket::write(p2.writeHandle, "x", 1);
+    monitor.run(1000);
+    PEGASUS_TEST_ASSERT(counter.count.get() == 2);
+
+    // A BUSY entry is not reported until it becomes IDLE again
+    monitor.setState(p1.index, MonitorEntry::STATUS_BUSY);
+    Socket::write(p1.writeHandle, "x", 1);
+    monitor.run(10);
+    PEGASUS_TEST_ASSERT(counter.count.get() == 2);
+
+    monitor.setState(p1.index, MonitorEntry::STATUS_IDLE);
+    monitor.run(1000);
+    PEGASUS_TEST_ASSERT(counter.count.get() == 3);
+
+    // The tickler wakes up the monitor without producing a message
+    monitor.tickle();
+    monitor.run(1000);
+    PEGASUS_TEST_ASSERT(counter.count.get() == 3);
+
+    // An unsolicited socket is no longer reported
+    monitor.unsolicitSocketMessages(p2.readHandle);
+    Socket::write(p2.writeHandle, "x", 1);
+    monitor.run(10);
+    PEGASUS_TEST_ASSERT(counter.count.get() == 3);
+
+    Socket::close(p2.readHandle);
+    Socket::close(p2.writeHandle);
+    _destroyPipe(monitor, p1);
+}
+
+//
+// Measures the average time to deliver one event with the given number of
+// idle sockets registered with the monitor.
+//
+static double _measureLatency(
+    Monitor& monitor,
+    SocketCounter& counter,
+    TestPipe& active)
+{
+    Uint32 start = counter.count.get();
+    Stopwatch stopwatch;
+
+    stopwatch.start();
+    for (Uint32 i = 0; i < ITERATIONS; i++)
+    {
+        Socket::write(active.writeHandle, "x", 1);
+        monitor.run(1000);
+    }
+    stopwatch.stop();
+
+    PEGASUS_TEST_ASSERT(counter.count.get() == start + ITERATIONS);
+
+    return double(stopwatch.getElapsedUsec()) / ITERATIONS;
+}
+
+static void testConnectionScaling(Monitor& monitor, Uint32 maxIdle)
+{
+    static const Uint32 idleCounts[] =
+        { 0, 10, 100, 250, 500, 1000, 2000, 4000, 8000 };
+
+    SocketCounter counter;
+    Array<TestPipe> idle;
+    TestPipe active = _createPipe(monitor, counter);
+
+    if (verbose)
+    {
+        cout << "Monitor latency with " << monitor.getPollerName()
+             << " poller:" << endl;
+    }
+
+    for (Uint32 i = 0; i < sizeof(idleCounts) / sizeof(idleCounts[0]); i++)
+    {
+        if (idleCounts[i] > maxIdle)
+        {
+            break;
+        }
+
+        while (idle.size() < idleCounts[i])
+        {
+            idle.append(_createPipe(monitor, counter));
+        }
+
+        double latency = _measureLatency(monitor, counter, active);
+
+        if (verbose)
+        {
+            cout << "    " << idleCounts[i] << " idle connections: "
+                 << latency << " usec per event" << endl;
+        }
+    }
+
+    for (Uint32 i = 0; i < idle.size(); i++)
+    {
+        _destroyPipe(monitor, idle[i]);
+    }
+    _destroyPipe(monitor, active);
+
+    PEGASUS_TEST_ASSERT(counter.count.get() > 0);
+}
+
+//
+// Verifies the connection assignment policies of the MonitorPool and that
+// its threads deliver socket events.
+//
+static void testMonitorPool()
+{
+    {
+        MonitorPool pool(3, MonitorPool::ROUND_ROBIN);
+        PEGASUS_TEST_ASSERT(pool.size() == 3);
+
+        for (Uint32 i = 0; i < 6; i++)
+        {
+            PEGASUS_TEST_ASSERT(
+                pool.selectMonitor() == pool.getMonitor(i % 3));
+        }
+    }
+
+    {
+        MonitorPool pool(3, MonitorPool::LEAST_LOADED);
+        SocketCounter counter;
+        int fds[2];
+        PEGASUS_TEST_ASSERT(pipe(fds) == 0);
+
+        // Connection entries are only counted, the pool is not started
+        PEGASUS_TEST_ASSERT(pool.getMonitor(0)->solicitSocketMessages(
+            fds[0], SocketMessage::READ, counter.getQueueId(),
+            MonitorEntry::TYPE_CONNECTION) > 0);
+        PEGASUS_TEST_ASSERT(pool.getMonitor(1)->solicitSocketMessages(
+            fds[1], SocketMessage::READ, counter.getQueueId(),
+            MonitorEntry::TYPE_CONNECTION) > 0);
+        PEGASUS_TEST_ASSERT(pool.getMonitor(0)->getConnectionCount() == 1);
+
+        PEGASUS_TEST_ASSERT(pool.selectMonitor() == pool.getMonitor(2));
+
+        pool.getMonitor(0)->unsolicitSocketMessages(fds[0]);
+        pool.getMonitor(1)->unsolicitSocketMessages(fds[1]);
+        PEGASUS_TEST_ASSERT(pool.getMonitor(0)->getConnectionCount() == 0);
+        PEGASUS_TEST_ASSERT(pool.selectMonitor() == pool.getMonitor(0));
+
+        Socket::close(fds[0]);
+        Socket::close(fds[1]);
+    }
+
+    {
+        MonitorPool pool(2, MonitorPool::ROUND_ROBIN);
+        SocketCounter counter;
+        TestPipe p1 = _createPipe(*pool.getMonitor(0), counter);
+        TestPipe p2 = _createPipe(*pool.getMonitor(1), counter);
+
+        pool.start();
+
+        Socket::write(p1.writeHandle, "x", 1);
+        Socket::write(p2.writeHandle, "x", 1);
+
+        for (Uint32 i = 0; i < 500 && counter.count.get() < 2; i++)
+        {
+            Threads::sleep(10);
+        }
+        PEGASUS_TEST_ASSERT(counter.count.get() == 2);
+
+        pool.stop();
+
+        _destroyPipe(*pool.getMonitor(0), p1);
+        _destroyPipe(*pool.getMonitor(1), p2);
+    }
+}
+
+int main(int, char** argv)
+{
+    verbose = (getenv("PEGASUS_TEST_VERBOSE")) ? true : false;
+
+    // Each idle connection uses two descriptors
+    struct rlimit limit;
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+    Uint32 maxIdle = Uint32((limit.rlim_cur - 64) / 2);
+
+    try
+    {
+        {
+            Monitor monitor(new SelectMonitorPoller());
+            testEvents(monitor);
+
+            // select() cannot watch descriptors beyond FD_SETSIZE
+            testConnectionScaling(
+                monitor, maxIdle < (FD_SETSIZE - 64) / 2 ?
+                    maxIdle : (FD_SETSIZE - 64) / 2);
+        }
+
+        {
+            Monitor monitor;
+            testEvents(monitor);
+            testConnectionScaling(monitor, maxIdle);
+        }
+
+        testMonitorPool();
+    }
+    catch (Exception& e)
+    {
+        cerr << argv[0] << " Exception: " << e.getMessage() << endl;
+        return 1;
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
@@ -0,0 +1,443 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/SCMOClassCache.h>
+#include <Pegasus/Common/Thread.h>
+#include <Pegasus/Common/AtomicInt.h>
+#include <Pegasus/Common/TimeValue.h>
+#include <cstdio>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+#define VCOUT if (verbose) cout
+
+static Boolean verbose;
+
+// The number of classes resolved through the call back
+static AtomicInt resolveCount;
+
+static const char NAMESPACE[] = "root/cimv2";
+
+SCMOClass _scmoClassCache_GetClass(
+    const CIMNamespaceName& nameSpace,
+    const CIMName& className)
+{
+    resolveCount++;
+
+    String name = className.getString();
+
+    if (name.subString(0, 7) == "Missing")
+    {
+        // The class does not exist
+        return SCMOClass("", "");
+    }
+
+    if (name.subString(0, 8) == "Modified")
+    {
+        // The class is modified while it is resolved
+        SCMOClassCache::getInstance()->removeSCMOClass(nameSpace, className);
+    }
+
+    CIMClass cimClass(className);
+    cimClass.addProperty(CIMProperty(CIMName("Name"), String()));
+
+    return SCMOClass(
+        cimClass,
+        (const char*)nameSpace.getString().getCString());
+}
+
+static SCMOClass _getClass(const char* className)
+{
+    return SCMOClassCache::getInstance()->getSCMOClass(
+        NAMESPACE,
+        strlen(NAMESPACE),
+        className,
+        strlen(className));
+}
+
+static void _getStatistics(
+    Uint32& size,
+    Uint64& hits,
+    Uint64& misses,
+    Uint64& evictions)
+{
+    Uint32 capacity;
+    SCMOClassCache::getInstance()->getStatistics(
+        size, capacity, hits, misses, evictions);
+}
+
+static void testHitAndMiss()
+{
+    SCMOClassCache* cache = SCMOClassCache::getInstance();
+    cache->setCapacity(32);
+    resolveCount.set(0);
+
+    Uint32 size;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 evictions;
+
+    SCMOClass first = _getClass("TST_Class");
+    PEGASUS_TEST_ASSERT(!first.isEmpty());
+    PEGASUS_TEST_ASSERT(resolveCount.get() == 1);
+
+    // The class is taken from the cache, also if the case differs.
+    SCMOClass second = _getClass("TST_Class");
+    SCMOClass third = _getClass("tst_class");
+    PEGASUS_TEST_ASSERT(!second.isEmpty());
+    PEGASUS_TEST_ASSERT(!third.isEmpty());
+    PEGASUS_TEST_ASSERT(resolveCount.get() == 1);
+
+    _getStatistics(size, hits, misses, evictions);
+    PEGASUS_TEST_ASSERT(size == 1);
+    PEGASUS_TEST_ASSERT(hits == 2);
+    PEGASUS_TEST_ASSERT(misses == 1);
+    PEGASUS_TEST_ASSERT(evictions == 0);
+
+    // The same class name in another name space is a different class.
+    SCMOClass other = cache->getSCMOClass(
+        "root/other", strlen("root/other"), "TST_Class", strlen("TST_Class"));
+    PEGASUS_TEST_ASSERT(!other.isEmpty());
+    PEGASUS_TEST_ASSERT(resolveCount.get() == 2);
+
+    // A class which does not exist is not cached.
+    PEGASUS_TEST_ASSERT(_getClass("MissingClass").isEmpty());
+    PEGASUS_TEST_ASSERT(_getClass("MissingClass").isEmpty());
+    PEGASUS_TEST_ASSERT(resolveCount.get() == 4);
+
+    _getStatistics(size, hits, misses, evictions);
+    PEGASUS_TEST_ASSERT(size == 2);
+
+    // A removed class is resolved again.
+    cache->removeSCMOClass(CIMNamespaceName(NAMESPACE), CIMName("TST_Class"));
+    _getStatistics(size, hits, misses, evictions);
+    PEGASUS_TEST_ASSERT(size == 1);
+
+    PEGASUS_TEST_ASSERT(!_getClass("TST_Class").isEmpty());
+    PEGASUS_TEST_ASSERT(resolveCount.get() == 5);
+
+    cache->clear();
+    _getStatistics(size, hits, misses, evictions);
+    PEGASUS_TEST_ASSERT(size == 0);
+
+    PEGASUS_TEST_ASSERT(!_getClass("TST_Class").isEmpty());
+    PEGASUS_TEST_ASSERT(resolveCount.get() == 6);
+
+    VCOUT << "testHitAndMiss passed." << endl;
+}
+
+static void testRemoveWhileResolving()
+{
+    SCMOClassCache* cache = SCMOClassCache::getInstance();
+    cache->setCapacity(32);
+    resolveCount.set(0);
+
+    // A class removed while it was resolved may be outdated, so it is
+    // returned but not cached.
+    PEGASUS_TEST_ASSERT(!_getClass("ModifiedClass").isEmpty());
+    PEGASUS_TEST_ASSERT(!_getClass("ModifiedClass").isEmpty());
+    PEGASUS_TEST_ASSERT(resolveCount.get() == 2);
+
+    Uint32 size;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 evictions;
+    _getStatistics(size, hits, misses, evictions);
+    PEGASUS_TEST_ASSERT(size == 0);
+
+    // Other classes are cached again by the next lookup.
+    PEGASUS_TEST_ASSERT(!_getClass("TST_Class").isEmpty());
+    PEGASUS_TEST_ASSERT(!_getClass("TST_Class").isEmpty());
+    PEGASUS_TEST_ASSERT(resolveCount.get() == 3);
+
+    VCOUT << "testRemoveWhileResolving passed." << endl;
+}
+
+static void testEviction()
+{
+    SCMOClassCache* cache = SCMOClassCache::getInstance();
+    cache->setCapacity(32);
+    resolveCount.set(0);
+
+    Uint32 size;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 evictions;
+
+    PEGASUS_TEST_ASSERT(!_getClass("TST_Hot").isEmpty());
+
+    // Many more classes than the cache can hold. The class used between
+    // each of them is never evicted.
+    char className[32];
+    for (Uint32 i = 0; i < 500; i++)
+    {
+        sprintf(className, "TST_Cold%u", i);
+        PEGASUS_TEST_ASSERT(!_getClass(className).isEmpty());
+        PEGASUS_TEST_ASSERT(!_getClass("TST_Hot").isEmpty());
+    }
+
+    PEGASUS_TEST_ASSERT(resolveCount.get() == 501);
+
+    _getStatistics(size, hits, misses, evictions);
+    PEGASUS_TEST_ASSERT(size <= 32);
+    PEGASUS_TEST_ASSERT(hits == 500);
+    PEGASUS_TEST_ASSERT(misses == 501);
+    PEGASUS_TEST_ASSERT(evictions == misses - size);
+
+    // Removing classes keeps the remaining ones accessible.
+    for (Uint32 i = 0; i < 500; i += 2)
+    {
+        sprintf(className, "TST_Cold%u", i);
+        cache->removeSCMOClass(
+            CIMNamespaceName(NAMESPACE), CIMName(className));
+    }
+
+    resolveCount.set(0);
+    PEGASUS_TEST_ASSERT(!_getClass("TST_Hot").isEmpty());
+    PEGASUS_TEST_ASSERT(resolveCount.get() == 0);
+
+    VCOUT << "testEviction passed." << endl;
+}
+
+static void testNoCaching()
+{
+    SCMOClassCache* cache = SCMOClassCache::getInstance();
+    cache->setCapacity(0);
+    resolveCount.set(0);
+
+    Uint32 size;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 evictions;
+
+    PEGASUS_TEST_ASSERT(!_getClass("TST_Class").isEmpty());
+    PEGASUS_TEST_ASSERT(!_getClass("TST_Class").isEmpty());
+    PEGASUS_TEST_ASSERT(resolveCount.get() == 2);
+
+    _getStatistics(size, hits, misses, evictions);
+    PEGASUS_TEST_ASSERT(size == 0);
+
+    VCOUT << "testNoCaching passed." << endl;
+}
+
+static ThreadReturnType PEGASUS_THREAD_CDECL _lookupThread(void* parm)
+{
+    Thread* myself = reinterpret_cast<Thread*>(parm);
+    Uint32 seed = *reinterpret_cast<Uint32*>(myself->get_parm());
+
+    char className[32];
+    for (Uint32 i = 0; i < 5000; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        sprintf(className, "TST_Class%u", (seed >> 16) % 100);
+
+        SCMOClass theClass = _getClass(className);
+        PEGASUS_TEST_ASSERT(!theClass.isEmpty());
+
+        Array<String> keyNames;
+        theClass.getKeyNamesAsString(keyNames);
+
+        if (i % 500 == 0)
+        {
+            SCMOClassCache::getInstance()->removeSCMOClass(
+                CIMNamespaceName(NAMESPACE), CIMName(className));
+        }
+    }
+
+    return ThreadReturnType(0);
+}
+
+static void testConcurrency()
+{
+    SCMOClassCache* cache = SCMOClassCache::getInstance();
+
+    // Fewer entries than classes, so the threads also evict classes.
+    cache->setCapacity(64);
+
+    const Uint32 numThreads = 8;
+    Uint32 seeds[numThreads];
+    Thread* threads[numThreads];
+
+    for (Uint32 i = 0; i < numThreads; i++)
+    {
+        seeds[i] = i + 1;
+        threads[i] = new Thread(_lookupThread, &seeds[i], false);
+        threads[i]->run();
+    }
+
+    for (Uint32 i = 0; i < numThreads; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    Uint32 size;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 evictions;
+    _getStatistics(size, hits, misses, evictions);
+    PEGASUS_TEST_ASSERT(size <= 64);
+
+    VCOUT << "testConcurrency passed: " << hits << " hits, " << misses <<
+        " misses, " << evictions << " evictions." << endl;
+}
+
+static AtomicInt stopLookups;
+
+static ThreadReturnType PEGASUS_THREAD_CDECL _verifyThread(void* parm)
+{
+    Thread* myself = reinterpret_cast<Thread*>(parm);
+    Uint32* count = reinterpret_cast<Uint32*>(myself->get_parm());
+
+    char className[32];
+    while (stopLookups.get() == 0)
+    {
+        sprintf(className, "TST_Class%u", *count % 8);
+
+        // The class must stay intact while the cache frees the snapshots
+        // the lookup may have read.
+        SCMOClass theClass = _getClass(className);
+        PEGASUS_TEST_ASSERT(!theClass.isEmpty());
+
+        CIMClass cimClass;
+        theClass.getCIMClass(cimClass);
+        PEGASUS_TEST_ASSERT(cimClass.getClassName() == CIMName(className));
+
+        (*count)++;
+    }
+
+    return ThreadReturnType(0);
+}
+
+static void testLookupWhileModified()
+{
+    SCMOClassCache* cache = SCMOClassCache::getInstance();
+    cache->setCapacity(64);
+
+    const Uint32 numThreads = 4;
+    Uint32 counts[numThreads];
+    Thread* threads[numThreads];
+
+    stopLookups.set(0);
+
+    for (Uint32 i = 0; i < numThreads; i++)
+    {
+        counts[i] = i;
+        threads[i] = new Thread(_verifyThread, &counts[i], false);
+        threads[i]->run();
+    }
+
+    // Replace the snapshots the lookups read in every way.
+    char className[32];
+    for (Uint32 i = 0; i < 300; i++)
+    {
+        sprintf(className, "TST_Class%u", i % 8);
+        cache->removeSCMOClass(CIMNamespaceName(NAMESPACE), CIMName(className));
+
+        if (i % 50 == 0)
+        {
+            cache->clear();
+        }
+
+        if (i % 100 == 0)
+        {
+            cache->setCapacity(16 + i / 10);
+        }
+
+        Threads::yield();
+    }
+
+    stopLookups.set(1);
+
+    Uint32 lookups = 0;
+    for (Uint32 i = 0; i < numThreads; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+        lookups += counts[i] - i;
+    }
+
+    VCOUT << "testLookupWhileModified passed: " << lookups <<
+        " lookups." << endl;
+}
+
+static void testLookupTime()
+{
+    SCMOClassCache* cache = SCMOClassCache::getInstance();
+    cache->setCapacity(64);
+
+    PEGASUS_TEST_ASSERT(!_getClass("TST_Timed").isEmpty());
+
+    const Uint32 numLookups = 100000;
+    Uint64 start = TimeValue::getCurrentTime().toMicroseconds();
+
+    for (Uint32 i = 0; i < numLookups; i++)
+    {
+        _getClass("TST_Timed");
+    }
+
+    Uint64 elapsed = TimeValue::getCurrentTime().toMicroseconds() - start;
+
+    VCOUT << "testLookupTime: " << elapsed * 1000 / numLookups <<
+        " ns per cached lookup." << endl;
+}
+
+int main (int argc, char *argv[])
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    try
+    {
+        SCMOClassCache::getInstance()->setCallBack(_scmoClassCache_GetClass);
+
+        testHitAndMiss();
+        testRemoveWhileResolving();
+        testEviction();
+        testNoCaching();
+        testConcurrency();
+        testLookupWhileModified();
+        testLookupTime();
+
+        SCMOClassCache::destroy();
+    }
+    catch (Exception& e)
+    {
+        cout << endl << "Exception: " ;
+        cout << e.getMessage() << endl << endl ;
+        exit(-1);
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
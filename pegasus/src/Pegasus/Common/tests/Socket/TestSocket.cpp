@@ -0,0 +1,166 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/Socket.h>
+#include <Pegasus/Common/Thread.h>
+#include <Pegasus/Common/Buffer.h>
+#include <iostream>
+#include <cstring>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+static Boolean verbose;
+
+struct WriteContext
+{
+    SocketHandle socket;
+    const SocketWriteSegment* segments;
+    Uint32 count;
+    Uint32 maxWriteSize;
+    Sint32 bytesWritten;
+};
+
+static ThreadReturnType PEGASUS_THREAD_CDECL _writeThread(void* parm)
+{
+    Thread* thread = reinterpret_cast<Thread*>(parm);
+    WriteContext* context =
+        reinterpret_cast<WriteContext*>(thread->get_parm());
+
+    context->bytesWritten = Socket::timedWritev(
+        context->socket,
+        context->segments,
+        context->count,
+        10,
+        context->maxWriteSize);
+
+    return ThreadReturnType(0);
+}
+
+// Writes the segments on a non-blocking socket while the peer reads them,
+// so that the socket buffer fills up and the writes are partial
+static void _testWritev(
+    const SocketWriteSegment* segments,
+    Uint32 count,
+    Uint32 maxWriteSize = 65536)
+{
+    Buffer expected;
+    for (Uint32 i = 0; i < count; i++)
+    {
+        expected.append(segments[i].data, segments[i].size);
+    }
+
+    int sockets[2];
+    PEGASUS_TEST_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0);
+    Socket::disableBlocking(sockets[0]);
+
+    WriteContext context = { sockets[0], segments, count, maxWriteSize, 0 };
+    Thread writer(_writeThread, &context, false);
+    PEGASUS_TEST_ASSERT(writer.run() == PEGASUS_THREAD_OK);
+
+    Buffer received;
+    char buffer[4096];
+
+    while (received.size() < expected.size())
+    {
+        Sint32 n = Socket::read(sockets[1], buffer, sizeof(buffer));
+        PEGASUS_TEST_ASSERT(n > 0);
+        received.append(buffer, n);
+    }
+
+    writer.join();
+
+    PEGASUS_TEST_ASSERT(context.bytesWritten == (Sint32)expected.size());
+    PEGASUS_TEST_ASSERT(received == expected);
+
+    SocketHandle socket = sockets[0];
+    Socket::close(socket);
+    socket = sockets[1];
+    Socket::close(socket);
+
+    if (verbose)
+    {
+        cout << "Wrote " << count << " segments, " << expected.size() <<
+            " bytes" << endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    Buffer large;
+    for (Uint32 i = 0; i < 1024 * 1024; i++)
+    {
+        large.append(char('a' + i % 26));
+    }
+
+    // A few segments, one of them larger than the socket buffer
+    {
+        SocketWriteSegment segments[] =
+        {
+            { "HTTP/1.1 200 OK\r\n", 17 },
+            { "", 0 },
+            { large.getData(), large.size() },
+            { "\r\n", 2 }
+        };
+        _testWritev(segments, sizeof(segments) / sizeof(segments[0]));
+    }
+
+    // More segments than are passed to one writev() call
+    {
+        SocketWriteSegment segments[500];
+        for (Uint32 i = 0; i < 500; i++)
+        {
+            segments[i].data = large.getData() + i * 1000;
+            segments[i].size = i % 7 ? i * 3 : 0;
+        }
+        _testWritev(segments, 500);
+    }
+
+    // Writes limited to fewer bytes than the segments hold
+    {
+        SocketWriteSegment segments[] =
+        {
+            { "0123456789", 10 },
+            { large.getData(), 100000 },
+            { "abc", 3 },
+            { "defghij", 7 }
+        };
+        _testWritev(segments, sizeof(segments) / sizeof(segments[0]), 8);
+        _testWritev(segments, sizeof(segments) / sizeof(segments[0]), 8192);
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
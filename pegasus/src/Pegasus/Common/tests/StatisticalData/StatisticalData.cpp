@@ -38,12 +38,275 @@
 #include <iostream>
 #include <Pegasus/Common/PegasusAssert.h>
 #include <Pegasus/Common/StatisticalData.h>
+#include <Pegasus/Common/Thread.h>
+#include <Pegasus/Common/ArrayInternal.h>
+#include <Pegasus/Common/TimeValue.h>
 
 PEGASUS_USING_STD;
 PEGASUS_USING_PEGASUS;
 
+static Boolean verbose;
+
+static void _testHistogram()
+{
+    // Every value is counted in a bucket whose value is within 12.5%
+    for (Uint64 value = 0; value < 100000; value += 1 + value / 100)
+    {
+        Uint32 bucket = StatisticalHistogram::getBucket(value);
+        PEGASUS_TEST_ASSERT(bucket < StatisticalHistogram::NUMBER_OF_BUCKETS);
+
+        Uint64 bucketValue = StatisticalHistogram::getBucketValue(bucket);
+        Uint64 diff = bucketValue > value ?
+            bucketValue - value : value - bucketValue;
+        PEGASUS_TEST_ASSERT(diff * 8 <= value);
+    }
+
+    PEGASUS_TEST_ASSERT(StatisticalHistogram::getBucket(7) == 7);
+    PEGASUS_TEST_ASSERT(StatisticalHistogram::getBucket(
+        PEGASUS_UINT64_LITERAL(0xFFFFFFFFFFFFFFFF)) ==
+            StatisticalHistogram::NUMBER_OF_BUCKETS - 1);
+
+    // The buckets are ordered by value
+    for (Uint32 i = 1; i < StatisticalHistogram::NUMBER_OF_BUCKETS; i++)
+    {
+        PEGASUS_TEST_ASSERT(StatisticalHistogram::getBucketValue(i - 1) <
+            StatisticalHistogram::getBucketValue(i));
+        PEGASUS_TEST_ASSERT(StatisticalHistogram::getBucket(
+            StatisticalHistogram::getBucketValue(i)) == i);
+    }
+
+    StatisticalHistogram histogram;
+    PEGASUS_TEST_ASSERT(histogram.getCount() == 0);
+    PEGASUS_TEST_ASSERT(histogram.getPercentile(500) == 0);
+
+    // 1..1000: p50 is about 500, p99 about 990 and p999 about 999
+    for (Uint64 value = 1; value <= 1000; value++)
+    {
+        histogram.add(value);
+    }
+
+    PEGASUS_TEST_ASSERT(histogram.getCount() == 1000);
+    PEGASUS_TEST_ASSERT(histogram.getPercentile(500) >= 440);
+    PEGASUS_TEST_ASSERT(histogram.getPercentile(500) <= 563);
+    PEGASUS_TEST_ASSERT(histogram.getPercentile(990) >= 866);
+    PEGASUS_TEST_ASSERT(histogram.getPercentile(990) <= 1114);
+    PEGASUS_TEST_ASSERT(histogram.getPercentile(999) >=
+        histogram.getPercentile(990));
+
+    // A single slow value only shows in the p999
+    StatisticalHistogram merged;
+    merged.merge(histogram);
+    merged.add(1000000);
+    PEGASUS_TEST_ASSERT(merged.getCount() == 1001);
+    PEGASUS_TEST_ASSERT(merged.getPercentile(990) <= 1114);
+    PEGASUS_TEST_ASSERT(merged.getPercentile(1000) >= 875000);
+
+    merged.clear();
+    PEGASUS_TEST_ASSERT(merged.getCount() == 0);
+}
+
+static const Uint32 _THREAD_VALUES = 1000;
+
+static ThreadReturnType PEGASUS_THREAD_CDECL _recordValues(void* parm)
+{
+    StatisticalData* sd = StatisticalData::current();
+
+    for (Uint32 i = 1; i <= _THREAD_VALUES; i++)
+    {
+        sd->addToValue(i, StatisticalData::GET_INSTANCE,
+            StatisticalData::PEGASUS_STATDATA_SERVER);
+        sd->addToValue(2 * i, StatisticalData::GET_INSTANCE,
+            StatisticalData::PEGASUS_STATDATA_PROVIDER);
+        sd->addToValue(100, StatisticalData::GET_INSTANCE,
+            StatisticalData::PEGASUS_STATDATA_BYTES_SENT);
+        sd->addToModuleValue("TestModule", i);
+    }
+
+    return ThreadReturnType(0);
+}
+
+static void _testThreadHistograms()
+{
+    StatisticalData* sd = StatisticalData::current();
+    StatisticalHistogramSet types[StatisticalData::NUMBER_OF_TYPES];
+    Array<String> moduleNames;
+    Array<StatisticalHistogram> modules;
+
+    // Re-enabling the gathering starts with empty histograms
+    sd->setCopyGSD(false);
+    sd->setCopyGSD(true);
+    sd->getHistograms(types, moduleNames, modules);
+    PEGASUS_TEST_ASSERT(
+        types[StatisticalData::GET_INSTANCE].serverTime.getCount() == 0);
+    PEGASUS_TEST_ASSERT(moduleNames.size() == 0);
+
+    // Values of the main thread, which has no Thread object
+    sd->addToModuleValue("OtherModule", 10);
+    sd->addToValue(Sint64(1) << 40, StatisticalData::GET_INSTANCE,
+        StatisticalData::PEGASUS_STATDATA_BYTES_READ);
+
+    const Uint32 NUM_THREADS = 4;
+    Thread* threads[NUM_THREADS];
+
+    for (Uint32 i = 0; i < NUM_THREADS; i++)
+    {
+        threads[i] = new Thread(_recordValues, 0, false);
+        PEGASUS_TEST_ASSERT(threads[i]->run() == PEGASUS_THREAD_OK);
+    }
+
+    for (Uint32 i = 0; i < NUM_THREADS; i++)
+    {
+        threads[i]->join();
+    }
+
+    // The histograms of the running (joined) threads are included
+    sd->getHistograms(types, moduleNames, modules);
+
+    const StatisticalHistogramSet& set = types[StatisticalData::GET_INSTANCE];
+    PEGASUS_TEST_ASSERT(
+        set.serverTime.getCount() == NUM_THREADS * _THREAD_VALUES);
+    PEGASUS_TEST_ASSERT(
+        set.providerTime.getCount() == NUM_THREADS * _THREAD_VALUES);
+    PEGASUS_TEST_ASSERT(
+        set.responseSize.getCount() == NUM_THREADS * _THREAD_VALUES);
+    PEGASUS_TEST_ASSERT(set.serverTime.getPercentile(500) <= 563);
+    PEGASUS_TEST_ASSERT(set.providerTime.getPercentile(500) >= 880);
+    PEGASUS_TEST_ASSERT(set.responseSize.getPercentile(999) ==
+        StatisticalHistogram::getBucketValue(
+            StatisticalHistogram::getBucket(100)));
+    PEGASUS_TEST_ASSERT(
+        types[StatisticalData::GET_CLASS].serverTime.getCount() == 0);
+
+    PEGASUS_TEST_ASSERT(moduleNames.size() == 2);
+    PEGASUS_TEST_ASSERT(moduleNames[0] == "OtherModule");
+    PEGASUS_TEST_ASSERT(modules[0].getCount() == 1);
+    PEGASUS_TEST_ASSERT(moduleNames[1] == "TestModule");
+    PEGASUS_TEST_ASSERT(modules[1].getCount() == NUM_THREADS * _THREAD_VALUES);
+
+    // So are their sums
+    const Sint64 timeSum = _THREAD_VALUES * (_THREAD_VALUES + 1) / 2;
+    sd->updateTotals();
+    PEGASUS_TEST_ASSERT(sd->numCalls[StatisticalData::GET_INSTANCE] ==
+        NUM_THREADS * _THREAD_VALUES);
+    PEGASUS_TEST_ASSERT(sd->cimomTime[StatisticalData::GET_INSTANCE] ==
+        NUM_THREADS * timeSum);
+    PEGASUS_TEST_ASSERT(sd->providerTime[StatisticalData::GET_INSTANCE] ==
+        NUM_THREADS * 2 * timeSum);
+    PEGASUS_TEST_ASSERT(sd->responseSize[StatisticalData::GET_INSTANCE] ==
+        NUM_THREADS * _THREAD_VALUES * 100);
+    PEGASUS_TEST_ASSERT(sd->requestSize[StatisticalData::GET_INSTANCE] ==
+        Sint64(1) << 40);
+    PEGASUS_TEST_ASSERT(sd->numCalls[StatisticalData::GET_CLASS] == 0);
+
+    // The values of the exited threads are kept
+    for (Uint32 i = 0; i < NUM_THREADS; i++)
+    {
+        delete threads[i];
+    }
+
+    sd->getHistograms(types, moduleNames, modules);
+    PEGASUS_TEST_ASSERT(types[StatisticalData::GET_INSTANCE].
+        serverTime.getCount() == NUM_THREADS * _THREAD_VALUES);
+    PEGASUS_TEST_ASSERT(moduleNames.size() == 2);
+    PEGASUS_TEST_ASSERT(modules[1].getCount() == NUM_THREADS * _THREAD_VALUES);
+    sd->updateTotals();
+    PEGASUS_TEST_ASSERT(sd->numCalls[StatisticalData::GET_INSTANCE] ==
+        NUM_THREADS * _THREAD_VALUES);
+    PEGASUS_TEST_ASSERT(sd->cimomTime[StatisticalData::GET_INSTANCE] ==
+        NUM_THREADS * timeSum);
+
+    // No values are recorded while the gathering is disabled
+    sd->setCopyGSD(false);
+    sd->addToModuleValue("OtherModule", 10);
+    sd->getHistograms(types, moduleNames, modules);
+    PEGASUS_TEST_ASSERT(modules[0].getCount() == 1);
+    sd->setCopyGSD(true);
+}
+
+static const Uint32 _TIMED_VALUES = 200000;
+
+static ThreadReturnType PEGASUS_THREAD_CDECL _recordTimedValues(void* parm)
+{
+    StatisticalData* sd = StatisticalData::current();
+    Uint64 start = TimeValue::getCurrentTime().toMicroseconds();
+
+    for (Uint32 i = 1; i <= _TIMED_VALUES; i++)
+    {
+        sd->addToValue(i % 5000, StatisticalData::GET_CLASS,
+            StatisticalData::PEGASUS_STATDATA_SERVER);
+    }
+
+    Thread* thread = reinterpret_cast<Thread*>(parm);
+    *reinterpret_cast<Uint64*>(thread->get_parm()) =
+        TimeValue::getCurrentTime().toMicroseconds() - start;
+
+    return ThreadReturnType(0);
+}
+
+// Reads the histograms while threads record values into them
+static void _testConcurrentReads()
+{
+    StatisticalData* sd = StatisticalData::current();
+    StatisticalHistogramSet types[StatisticalData::NUMBER_OF_TYPES];
+    Array<String> moduleNames;
+    Array<StatisticalHistogram> modules;
+
+    sd->setCopyGSD(false);
+    sd->setCopyGSD(true);
+
+    const Uint32 NUM_THREADS = 4;
+    Thread* threads[NUM_THREADS];
+    Uint64 elapsedUsec[NUM_THREADS];
+
+    for (Uint32 i = 0; i < NUM_THREADS; i++)
+    {
+        threads[i] = new Thread(_recordTimedValues, &elapsedUsec[i], false);
+        PEGASUS_TEST_ASSERT(threads[i]->run() == PEGASUS_THREAD_OK);
+    }
+
+    // The counts read never decrease nor exceed the values recorded
+    Uint64 count = 0;
+    Uint32 reads = 0;
+
+    while (count < NUM_THREADS * _TIMED_VALUES)
+    {
+        sd->getHistograms(types, moduleNames, modules);
+        Uint64 newCount =
+            types[StatisticalData::GET_CLASS].serverTime.getCount();
+        PEGASUS_TEST_ASSERT(newCount >= count);
+        PEGASUS_TEST_ASSERT(newCount <= NUM_THREADS * _TIMED_VALUES);
+        count = newCount;
+        reads++;
+    }
+
+    for (Uint32 i = 0; i < NUM_THREADS; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    sd->updateTotals();
+    PEGASUS_TEST_ASSERT(sd->numCalls[StatisticalData::GET_CLASS] ==
+        NUM_THREADS * _TIMED_VALUES);
+
+    // The threads above share the processors with each other and with the
+    // reader, so the cost of recording is timed in a thread of its own
+    Thread thread(_recordTimedValues, &elapsedUsec[0], false);
+    PEGASUS_TEST_ASSERT(thread.run() == PEGASUS_THREAD_OK);
+    thread.join();
+
+    if (verbose)
+    {
+        cout << "Recorded " << NUM_THREADS * _TIMED_VALUES << " values in " <<
+            NUM_THREADS << " threads with " << reads << " reads" << endl;
+        cout << "Recorded " << _TIMED_VALUES << " values in one thread, " <<
+            (elapsedUsec[0] * 1000) / _TIMED_VALUES << " ns per value" << endl;
+    }
+}
+
 int main(int argc, char** argv)
 {
+verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
 
 
 StatisticalData* sd = StatisticalData::current();
@@ -79,6 +342,13 @@ sd->setCopyGSD(1);
 
 PEGASUS_TEST_ASSERT(sd->copyGSD == 1);
 
+//**********************************************
+// check the histograms
+
+_testHistogram();
+_testThreadHistograms();
+_testConcurrentReads();
+
 //****************************************************
 // make sure the cur the sd objects are still the same
 
@@ -32,6 +32,8 @@
 #include <Pegasus/Common/Thread.h>
 #include <Pegasus/Common/ReadWriteSem.h>
 #include <Pegasus/Common/Condition.h>
+#include <Pegasus/Common/Semaphore.h>
+#include <Pegasus/Common/PooledAllocator.h>
 #include <sys/types.h>
 #if defined(PEGASUS_OS_TYPE_WINDOWS)
 #else
@@ -143,6 +145,53 @@ ThreadReturnType PEGASUS_THREAD_CDECL test1_thread( void* parm )
     return ThreadReturnType(32);
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Test the current Thread of a joinable and of a detached thread
+ThreadReturnType PEGASUS_THREAD_CDECL testCurrentJoinableThread(void* parm);
+ThreadReturnType PEGASUS_THREAD_CDECL testCurrentDetachedThread(void* parm);
+
+static Semaphore detachedThreadStart(0);
+static Semaphore detachedThreadDone(0);
+static Boolean detachedThreadHasCurrent;
+
+void testCurrentThread()
+{
+    if (verbose)
+    {
+        cout << "testCurrentThread" << endl;
+    }
+
+    Thread joinable(testCurrentJoinableThread, 0, false);
+    PEGASUS_TEST_ASSERT(joinable.run() == PEGASUS_THREAD_OK);
+    joinable.join();
+    PEGASUS_TEST_ASSERT(joinable.get_exit() == (ThreadReturnType)1);
+
+    // The Thread object of a detached thread may be gone before the thread
+    // uses the pooled allocator
+    {
+        Thread detached(testCurrentDetachedThread, 0, true);
+        PEGASUS_TEST_ASSERT(detached.run() == PEGASUS_THREAD_OK);
+    }
+    detachedThreadStart.signal();
+    detachedThreadDone.wait();
+    PEGASUS_TEST_ASSERT(!detachedThreadHasCurrent);
+}
+
+ThreadReturnType PEGASUS_THREAD_CDECL testCurrentJoinableThread(void* parm)
+{
+    Thread* myself = reinterpret_cast<Thread*>(parm);
+    return ThreadReturnType(Thread::getCurrent() == myself ? 1 : 0);
+}
+
+ThreadReturnType PEGASUS_THREAD_CDECL testCurrentDetachedThread(void* parm)
+{
+    detachedThreadStart.wait();
+    detachedThreadHasCurrent = Thread::getCurrent() != 0;
+    PooledAllocator::deallocate(PooledAllocator::allocate(64), 64);
+    detachedThreadDone.signal();
+    return ThreadReturnType(0);
+}
+
 ///////////////////////////////////////////////////////////////////
 //
 // Test multiple threads including TSD
@@ -529,6 +578,8 @@ int main(int argc, char **argv)
 
     testOneThread();
 
+    testCurrentThread();
+
     testMultipleThreads();
 
     // Check for a thread deadlock handling Bug
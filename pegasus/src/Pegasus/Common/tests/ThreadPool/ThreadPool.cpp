@@ -363,6 +363,310 @@ void testBlockingThread()
     }
 }
 
+void testQueuedWork()
+{
+    if (verbose)
+    {
+        cout << "testQueuedWork" << endl;
+    }
+
+    try
+    {
+        AtomicInt cancelled(0);
+        AtomicInt counter(0);
+        Semaphore blocking(0);
+
+        struct timeval deallocateWait = { 0, 1 };
+        ThreadPool* threadPool =
+            new ThreadPool(0, "test queue", 0, 2, deallocateWait, 4);
+
+        // Occupy both threads
+        ThreadStatus rc;
+        rc = threadPool->allocate_and_awaken(
+            &cancelled, funcSleepUntilCancelled);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+        rc = threadPool->allocate_and_awaken(
+            &cancelled, funcSleepUntilCancelled);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+        PEGASUS_TEST_ASSERT(ThreadPool::waitForAdmission(0));
+
+        // The next work requests are queued
+        for (Uint32 i = 0; i < 3; i++)
+        {
+            rc = threadPool->allocate_and_awaken(
+                &counter, funcIncrementCounter);
+            PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+        }
+        rc = threadPool->allocate_and_awaken(
+            &counter, funcIncrementCounter, &blocking);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+        PEGASUS_TEST_ASSERT(threadPool->queuedCount() == 4);
+        PEGASUS_TEST_ASSERT(threadPool->runningCount() == 2);
+
+        // The queue is saturated and refuses more work once full
+        PEGASUS_TEST_ASSERT(!ThreadPool::waitForAdmission(20));
+        rc = threadPool->allocate_and_awaken(
+            &counter, funcIncrementCounter);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_INSUFFICIENT_RESOURCES);
+
+        // The queued work is done when the threads finish their work
+        Threads::sleep(10);
+        cancelled = 1;
+        blocking.wait();
+        PEGASUS_TEST_ASSERT(counter.get() == 4);
+        PEGASUS_TEST_ASSERT(threadPool->queuedCount() == 0);
+        PEGASUS_TEST_ASSERT(ThreadPool::waitForAdmission(0));
+
+        Uint32 queuedTasks;
+        Uint32 peakQueuedTasks;
+        Uint64 totalQueuedTasks;
+        Uint64 totalQueueWaitUsec;
+        Uint64 rejectedTasks;
+        Uint64 stolenTasks;
+        threadPool->getQueueStatistics(
+            queuedTasks,
+            peakQueuedTasks,
+            totalQueuedTasks,
+            totalQueueWaitUsec,
+            rejectedTasks,
+            stolenTasks);
+        PEGASUS_TEST_ASSERT(queuedTasks == 0);
+        PEGASUS_TEST_ASSERT(peakQueuedTasks == 4);
+        PEGASUS_TEST_ASSERT(totalQueuedTasks == 4);
+        PEGASUS_TEST_ASSERT(totalQueueWaitUsec >= 4 * 10000);
+        PEGASUS_TEST_ASSERT(rejectedTasks == 1);
+        // Work from outside the pool is queued in the shared queue
+        PEGASUS_TEST_ASSERT(stolenTasks == 0);
+
+        // Without a queue, work is refused when no thread is available
+        while (threadPool->idleCount() < 2)
+        {
+            Threads::sleep(10);
+        }
+        threadPool->setMaxQueuedTasks(0);
+        cancelled = 0;
+        rc = threadPool->allocate_and_awaken(
+            &cancelled, funcSleepUntilCancelled);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+        rc = threadPool->allocate_and_awaken(
+            &cancelled, funcSleepUntilCancelled);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+        rc = threadPool->allocate_and_awaken(
+            &counter, funcIncrementCounter);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_INSUFFICIENT_RESOURCES);
+        cancelled = 1;
+
+        delete threadPool;
+    }
+    catch (const Exception& e)
+    {
+        cout << "Exception in testQueuedWork: " << e.getMessage() << endl;
+        PEGASUS_TEST_ASSERT(false);
+    }
+}
+
+struct NestedWork
+{
+    ThreadPool* threadPool;
+    AtomicInt counter;
+    Boolean waited;
+};
+
+ThreadReturnType PEGASUS_THREAD_CDECL funcWaitForNestedWork(void* parm)
+{
+    NestedWork* nested = static_cast<NestedWork*>(parm);
+    Semaphore done(0);
+
+    // The only thread of the pool waits for work of the same pool
+    ThreadStatus rc = nested->threadPool->allocate_and_awaken(
+        &nested->counter, funcIncrementCounter, &done);
+    PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+
+    nested->waited = nested->threadPool->beginWait();
+    done.wait();
+    if (nested->waited)
+    {
+        nested->threadPool->endWait();
+    }
+
+    return 0;
+}
+
+void testNestedWork()
+{
+    if (verbose)
+    {
+        cout << "testNestedWork" << endl;
+    }
+
+    try
+    {
+        struct timeval deallocateWait = { 0, 1 };
+        ThreadPool* threadPool =
+            new ThreadPool(0, "test nested", 0, 1, deallocateWait, 4);
+
+        // A thread that is not in the pool does not wait in it
+        PEGASUS_TEST_ASSERT(!threadPool->beginWait());
+
+        NestedWork nested;
+        nested.threadPool = threadPool;
+        nested.waited = false;
+        Semaphore blocking(0);
+
+        ThreadStatus rc = threadPool->allocate_and_awaken(
+            &nested, funcWaitForNestedWork, &blocking);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+
+        blocking.wait();
+        PEGASUS_TEST_ASSERT(nested.waited);
+        PEGASUS_TEST_ASSERT(nested.counter.get() == 1);
+        PEGASUS_TEST_ASSERT(threadPool->queuedCount() == 0);
+
+        // A saturated pool admits new work as soon as its queue drains
+        AtomicInt cancelled(0);
+        AtomicInt counter(0);
+        // The thread that was started beyond the maximum for the nested
+        // work is cleaned up like any idle thread
+        while (threadPool->runningCount() != 0)
+        {
+            Threads::sleep(10);
+        }
+        Threads::sleep(1);
+        PEGASUS_TEST_ASSERT(threadPool->cleanupIdleThreads() == 2);
+        rc = threadPool->allocate_and_awaken(
+            &cancelled, funcSleepUntilCancelled);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+        for (Uint32 i = 0; i < 3; i++)
+        {
+            rc = threadPool->allocate_and_awaken(
+                &counter, funcIncrementCounter);
+            PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+        }
+        PEGASUS_TEST_ASSERT(!ThreadPool::waitForAdmission(0));
+        cancelled = 1;
+        PEGASUS_TEST_ASSERT(ThreadPool::waitForAdmission(10000));
+
+        delete threadPool;
+        PEGASUS_TEST_ASSERT(counter.get() == 3);
+    }
+    catch (const Exception& e)
+    {
+        cout << "Exception in testNestedWork: " << e.getMessage() << endl;
+        PEGASUS_TEST_ASSERT(false);
+    }
+}
+
+struct StealWork
+{
+    ThreadPool* threadPool;
+    AtomicInt counter;
+    Semaphore queued;
+    Semaphore release;
+    Boolean wait;
+
+    StealWork() : queued(0), release(0) { }
+};
+
+ThreadReturnType PEGASUS_THREAD_CDECL funcQueueWork(void* parm)
+{
+    StealWork* steal = static_cast<StealWork*>(parm);
+
+    // The pool is at its limit, so the work goes to the deque of this
+    // thread
+    for (Uint32 i = 0; i < 3; i++)
+    {
+        ThreadStatus rc = steal->threadPool->allocate_and_awaken(
+            &steal->counter, funcIncrementCounter);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+    }
+    PEGASUS_TEST_ASSERT(steal->threadPool->queuedCount() == 3);
+
+    steal->queued.signal();
+    if (steal->wait)
+    {
+        steal->release.wait();
+    }
+
+    return 0;
+}
+
+Uint64 getStolenTasks(ThreadPool* threadPool)
+{
+    Uint32 queuedTasks;
+    Uint32 peakQueuedTasks;
+    Uint64 totalQueuedTasks;
+    Uint64 totalQueueWaitUsec;
+    Uint64 rejectedTasks;
+    Uint64 stolenTasks;
+    threadPool->getQueueStatistics(
+        queuedTasks,
+        peakQueuedTasks,
+        totalQueuedTasks,
+        totalQueueWaitUsec,
+        rejectedTasks,
+        stolenTasks);
+    return stolenTasks;
+}
+
+void testStolenWork()
+{
+    if (verbose)
+    {
+        cout << "testStolenWork" << endl;
+    }
+
+    try
+    {
+        struct timeval deallocateWait = { 0, 1 };
+        ThreadPool* threadPool =
+            new ThreadPool(0, "test stealing", 0, 2, deallocateWait, 8);
+
+        AtomicInt cancelled(0);
+        ThreadStatus rc = threadPool->allocate_and_awaken(
+            &cancelled, funcSleepUntilCancelled);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+
+        // A thread does the work it queued itself when nobody else can
+        StealWork steal;
+        steal.threadPool = threadPool;
+        steal.wait = false;
+        rc = threadPool->allocate_and_awaken(&steal, funcQueueWork);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+        steal.queued.wait();
+        while (steal.counter.get() != 3)
+        {
+            Threads::sleep(10);
+        }
+        PEGASUS_TEST_ASSERT(getStolenTasks(threadPool) == 0);
+
+        // The work of a thread that is still busy is stolen by the thread
+        // that runs out of work
+        while (threadPool->idleCount() != 1)
+        {
+            Threads::sleep(10);
+        }
+        steal.wait = true;
+        rc = threadPool->allocate_and_awaken(&steal, funcQueueWork);
+        PEGASUS_TEST_ASSERT(rc == PEGASUS_THREAD_OK);
+        steal.queued.wait();
+        cancelled = 1;
+        while (steal.counter.get() != 6)
+        {
+            Threads::sleep(10);
+        }
+        PEGASUS_TEST_ASSERT(getStolenTasks(threadPool) == 3);
+        PEGASUS_TEST_ASSERT(threadPool->queuedCount() == 0);
+        steal.release.signal();
+
+        delete threadPool;
+    }
+    catch (const Exception& e)
+    {
+        cout << "Exception in testStolenWork: " << e.getMessage() << endl;
+        PEGASUS_TEST_ASSERT(false);
+    }
+}
+
 int main(int argc, char **argv)
 {
     verbose = (getenv("PEGASUS_TEST_VERBOSE")) ? true : false;
@@ -382,6 +686,9 @@ int main(int argc, char **argv)
     testWorkException();
     testHighWorkload();
     testBlockingThread();
+    testQueuedWork();
+    testNestedWork();
+    testStolenWork();
 
 #if defined(PEGASUS_DEBUG)
     if (verbose)
@@ -0,0 +1,198 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/CIMResponseData.h>
+#include <Pegasus/Common/SCMOClass.h>
+#include <Pegasus/Common/SCMOInstance.h>
+#include <Pegasus/Common/SCMOXmlWriter.h>
+#include <Pegasus/Common/XmlParser.h>
+#include <Pegasus/Common/XmlReader.h>
+#include <Pegasus/Common/FileSystem.h>
+#include <Pegasus/General/Stopwatch.h>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+static Boolean verbose;
+
+// Number of instances encoded per round and number of rounds. The fastest
+// round is reported, which filters out the noise of other processes.
+static const Uint32 INSTANCES = 10000;
+static const Uint32 ROUNDS = 8;
+
+template<class OBJECT>
+static void _loadObject(const char* fileName, OBJECT& object)
+{
+    Buffer text;
+    FileSystem::loadFileToMemory(text, fileName);
+    text.append('\0');
+
+    XmlParser parser((char*)text.getData());
+    XmlReader::getObject(parser, object);
+}
+
+//
+// Encodes the instances in the response data as an enumeration response
+// body and returns the size of the fastest round.
+//
+static Uint32 _encode(
+    const char* name,
+    CIMResponseData& data,
+    Uint32 estimate)
+{
+    Uint32 size = 0;
+    double seconds = 0;
+
+    for (Uint32 round = 0; round < ROUNDS; round++)
+    {
+        Buffer out;
+
+        Stopwatch stopwatch;
+        stopwatch.start();
+        data.encodeXmlResponse(out);
+        stopwatch.stop();
+
+        PEGASUS_TEST_ASSERT(round == 0 || out.size() == size);
+        size = out.size();
+
+        if (round == 0 || stopwatch.getElapsed() < seconds)
+        {
+            seconds = stopwatch.getElapsed();
+        }
+    }
+
+    if (verbose)
+    {
+        printf("%-6s %9u bytes %8.1f MB/s %8.0f instances/ms",
+            name,
+            size,
+            double(size) / seconds / (1024 * 1024),
+            double(INSTANCES) / seconds / 1000);
+
+        if (estimate)
+        {
+            printf(" estimate %.2f", double(estimate) / size);
+        }
+
+        printf("\n");
+    }
+
+    return size;
+}
+
+//
+// Encodes an instance of the class INSTANCES times, from the CIMInstance
+// (XmlWriter) and from the SCMOInstance (SCMOXmlWriter) representation.
+//
+static void _testInstance(const char* classFile, const char* instanceFile)
+{
+    CIMClass cimClass;
+    _loadObject(classFile, cimClass);
+    CIMInstance cimInstance;
+    _loadObject(instanceFile, cimInstance);
+    cimInstance.setPath(cimInstance.buildPath(cimClass));
+
+    Array<CIMInstance> instances;
+    Array<SCMOInstance> scmoInstances;
+    SCMOClass scmoClass(cimClass);
+    SCMOInstance scmoInstance(scmoClass, cimInstance);
+
+    for (Uint32 i = 0; i < INSTANCES; i++)
+    {
+        instances.append(cimInstance.clone());
+        scmoInstances.append(scmoInstance.clone());
+    }
+
+    Uint32 estimate =
+        Uint32(SCMOXmlWriter::estimateInstanceElementsSize(scmoInstances));
+
+    // The class memory holding the qualifiers is estimated once for all
+    // instances of the class, as it is for a single one.
+    {
+        Array<SCMOInstance> qualified;
+        Array<SCMOInstance> plain;
+
+        for (Uint32 i = 0; i < INSTANCES; i++)
+        {
+            qualified.append(scmoInstance.clone());
+            qualified[i].includeQualifiers();
+            plain.append(scmoInstance.clone());
+            plain[i].excludeQualifiers();
+        }
+
+        Uint64 classSize =
+            SCMOXmlWriter::estimateInstanceElementsSize(
+                Array<SCMOInstance>(qualified.getData(), 1)) -
+            SCMOXmlWriter::estimateInstanceElementsSize(
+                Array<SCMOInstance>(plain.getData(), 1));
+        PEGASUS_TEST_ASSERT(classSize > 0);
+        PEGASUS_TEST_ASSERT(
+            SCMOXmlWriter::estimateInstanceElementsSize(qualified) ==
+            SCMOXmlWriter::estimateInstanceElementsSize(plain) + classSize);
+    }
+
+    CIMResponseData cimData(CIMResponseData::RESP_INSTANCES);
+    cimData.setInstances(instances);
+    Uint32 cimSize = _encode("CIM", cimData, 0);
+
+    CIMResponseData scmoData(CIMResponseData::RESP_INSTANCES);
+    scmoData.setSCMO(scmoInstances);
+    Uint32 scmoSize = _encode("SCMO", scmoData, estimate);
+
+    PEGASUS_TEST_ASSERT(cimSize > INSTANCES && scmoSize > INSTANCES);
+}
+
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    if (argc != 3)
+    {
+        cerr << "Usage: " << argv[0] << " class-filename instance-filename"
+             << endl;
+        return 1;
+    }
+
+    try
+    {
+        _testInstance(argv[1], argv[2]);
+    }
+    catch (Exception& e)
+    {
+        cerr << "Error: " << e.getMessage() << endl;
+        return 1;
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/XmlParser.h>
+#include <Pegasus/Common/FileSystem.h>
+#include <Pegasus/General/Stopwatch.h>
+#include <cstring>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+static Boolean verbose;
+
+// Number of bytes parsed per round and number of rounds per payload. The
+// fastest round is reported, which filters out the noise of other processes.
+static const Uint32 BYTES_PER_ROUND = 4 * 1024 * 1024;
+static const Uint32 ROUNDS = 8;
+
+// Parses the text in place and returns the number of entries
+static Uint32 _parse(char* text)
+{
+    XmlParser parser(text);
+    XmlEntry entry;
+    Uint32 entries = 0;
+
+    while (parser.next(entry))
+    {
+        entries++;
+    }
+
+    return entries;
+}
+
+//
+// Parses a recorded payload repeatedly. The parser modifies the text, so
+// each pass parses a fresh copy. The copy is a small part of the time.
+//
+static void _testPayload(const char* fileName)
+{
+    Buffer payload;
+    FileSystem::loadFileToMemory(payload, fileName);
+    payload.append('\0');
+
+    Uint32 size = payload.size();
+    Buffer text(payload);
+    Uint32 entries = _parse((char*)text.getData());
+    PEGASUS_TEST_ASSERT(entries > 0);
+
+    Uint32 passes = BYTES_PER_ROUND / size + 1;
+    double seconds = 0;
+
+    for (Uint32 round = 0; round < ROUNDS; round++)
+    {
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        for (Uint32 i = 0; i < passes; i++)
+        {
+            memcpy((char*)text.getData(), payload.getData(), size);
+            PEGASUS_TEST_ASSERT(_parse((char*)text.getData()) == entries);
+        }
+
+        stopwatch.stop();
+
+        if (round == 0 || stopwatch.getElapsed() < seconds)
+        {
+            seconds = stopwatch.getElapsed();
+        }
+    }
+
+    if (verbose)
+    {
+        const char* name = strrchr(fileName, '/');
+        name = name ? name + 1 : fileName;
+
+        printf("%-45s %7u bytes %6u entries %8.1f MB/s %8.0f entries/ms\n",
+            name,
+            size - 1,
+            entries,
+            double(size) * passes / seconds / (1024 * 1024),
+            double(entries) * passes / seconds / 1000);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0] << " xml-filename ..." << endl;
+        return 1;
+    }
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            _testPayload(argv[i]);
+        }
+    }
+    catch (Exception& e)
+    {
+        cerr << "Error: " << e.getMessage() << endl;
+        return 1;
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
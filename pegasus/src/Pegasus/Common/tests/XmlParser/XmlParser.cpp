@@ -33,6 +33,7 @@
 #include <Pegasus/Common/XmlParser.h>
 #include <Pegasus/Common/Array.h>
 #include <Pegasus/Common/FileSystem.h>
+#include <Pegasus/Common/CharScan.h>
 #include <cstdio>
 
 PEGASUS_USING_PEGASUS;
@@ -348,6 +349,174 @@ static void testWhitespaceHandling()
     PEGASUS_TEST_ASSERT(strcmp(entry.text, "value  +") == 0);
 }
 
+// Compares the kernels selected for the processor with the scalar
+// implementation for strings at every alignment.
+static void testCharScan()
+{
+    const char chars[] = "ab<&\"= \t\r\n\x01\xc3\xa9";
+    char buffer[160];
+    Uint32 seed = 1;
+
+    for (Uint32 length = 0; length < 100; length++)
+    {
+        for (Uint32 offset = 0; offset < 32; offset++)
+        {
+            char* p = buffer + offset;
+
+            // Mostly ordinary characters with a few breaks
+            for (Uint32 i = 0; i < length; i++)
+            {
+                seed = seed * 1103515245 + 12345;
+                Uint32 r = (seed >> 16) % 64;
+                p[i] = r < sizeof(chars) - 1 ? chars[r] : 'x';
+            }
+            p[length] = '\0';
+
+            PEGASUS_TEST_ASSERT(CharScan::findXmlBreak(p, '<', '&') ==
+                CharScan::findXmlBreakScalar(p, '<', '&'));
+            PEGASUS_TEST_ASSERT(CharScan::findXmlBreak(p, '"', '&') ==
+                CharScan::findXmlBreakScalar(p, '"', '&'));
+
+            Uint32 line = 0;
+            Uint32 scalarLine = 0;
+            PEGASUS_TEST_ASSERT(
+                CharScan::findXmlDelimiter(p, '<', '&', line) ==
+                CharScan::findXmlDelimiterScalar(p, '<', '&', scalarLine));
+            PEGASUS_TEST_ASSERT(line == scalarLine);
+
+            // Runs of white space only
+            for (Uint32 i = 0; i < length; i++)
+            {
+                p[i] = chars[6 + (p[i] & 3)];
+            }
+            p[length ? (seed >> 8) % length : 0] = 'x';
+
+            line = 0;
+            scalarLine = 0;
+            PEGASUS_TEST_ASSERT(CharScan::skipXmlWhiteSpace(p, line) ==
+                CharScan::skipXmlWhiteSpaceScalar(p, scalarLine));
+            PEGASUS_TEST_ASSERT(line == scalarLine);
+        }
+    }
+}
+
+// Compares the escape kernels with the scalar implementation for UTF-8 and
+// UTF-16 strings at every alignment.
+static void testCharScanEscape()
+{
+    const Uint16 chars[] =
+        { 'a', ' ', '<', '>', '&', '\'', '"', '\n', 0x7F, 0xE9, 0x100, 0xD800 };
+    char buffer[160];
+    Uint16 buffer16[160];
+    Uint32 seed = 1;
+
+    for (Uint32 length = 0; length < 100; length++)
+    {
+        for (Uint32 offset = 0; offset < 32; offset++)
+        {
+            char* p = buffer + offset;
+            Uint16* p16 = buffer16 + offset;
+
+            // Mostly ordinary characters with a few to escape
+            for (Uint32 i = 0; i < length; i++)
+            {
+                seed = seed * 1103515245 + 12345;
+                Uint32 r = (seed >> 16) % 96;
+                p16[i] = r < sizeof(chars) / sizeof(chars[0]) ? chars[r] : 'x';
+                p[i] = char(p16[i]);
+            }
+
+            // The character following the string must not be scanned
+            p[length] = '<';
+            p16[length] = ' ';
+
+            for (Uint32 start = 0; start <= length; start += 7)
+            {
+                PEGASUS_TEST_ASSERT(
+                    CharScan::findXmlEscape(p + start, p + length) ==
+                    CharScan::findXmlEscapeScalar(p + start, p + length));
+                PEGASUS_TEST_ASSERT(
+                    CharScan::findXmlEscape(p16 + start, p16 + length) ==
+                    CharScan::findXmlEscapeScalar(p16 + start, p16 + length));
+            }
+        }
+    }
+}
+
+// Parses values longer than the SIMD blocks with references and white
+// space at every position.
+static void testLongValues()
+{
+    for (Uint32 length = 1; length < 80; length++)
+    {
+        for (Uint32 pos = 0; pos < length; pos++)
+        {
+            String value;
+            String expectedContent;
+            String expectedAttr;
+
+            for (Uint32 i = 0; i < length; i++)
+            {
+                if (i == pos && i != 0 && i != length - 1)
+                {
+                    value.append(" \n ");
+                    expectedContent.append(" \n ");
+                    expectedAttr.append(" ");
+                }
+                else if (i == (pos * 7) % length)
+                {
+                    value.append("&lt;&#x41;");
+                    expectedContent.append("<A");
+                    expectedAttr.append("<A");
+                }
+                else
+                {
+                    Char16 c = 'a' + Char16(i % 26);
+                    value.append(c);
+                    expectedContent.append(c);
+                    expectedAttr.append(c);
+                }
+            }
+
+            String xml = "<tag attr=\"\n" + value + " \">\n  " +
+                value + "\n</tag>";
+            CString text = xml.getCString();
+            Buffer buffer((const char*)text, strlen(text) + 1);
+            XmlParser parser((char*)buffer.getData());
+            XmlEntry entry;
+
+            PEGASUS_TEST_ASSERT(parser.next(entry));
+            const char* attrValue;
+            PEGASUS_TEST_ASSERT(entry.getAttributeValue("attr", attrValue));
+            PEGASUS_TEST_ASSERT(expectedAttr == attrValue);
+
+            PEGASUS_TEST_ASSERT(parser.next(entry));
+            PEGASUS_TEST_ASSERT(entry.type == XmlEntry::CONTENT);
+            PEGASUS_TEST_ASSERT(expectedContent == entry.text);
+            PEGASUS_TEST_ASSERT(
+                entry.textLen == strlen(expectedContent.getCString()));
+
+            PEGASUS_TEST_ASSERT(parser.next(entry));
+            PEGASUS_TEST_ASSERT(entry.type == XmlEntry::END_TAG);
+
+            Uint32 lines = (pos != 0 && pos != length - 1) ? 2 : 0;
+            PEGASUS_TEST_ASSERT(parser.getLine() == 4 + lines);
+        }
+    }
+
+    // Trailing white space produced by a reference is not trimmed
+    char text[] = "<tag>a b&#32;&#10; \n</tag>";
+    XmlParser parser(text);
+    XmlEntry entry;
+
+    PEGASUS_TEST_ASSERT(parser.next(entry));
+    PEGASUS_TEST_ASSERT(parser.next(entry));
+    PEGASUS_TEST_ASSERT(entry.type == XmlEntry::CONTENT);
+    PEGASUS_TEST_ASSERT(strcmp(entry.text, "a b \n") == 0);
+    PEGASUS_TEST_ASSERT(entry.textLen == 5);
+    PEGASUS_TEST_ASSERT(parser.getLine() == 2);
+}
+
 int main(int argc, char** argv)
 {
 
@@ -374,6 +543,9 @@ int main(int argc, char** argv)
     }
 
     testWhitespaceHandling();
+    testCharScan();
+    testCharScanEscape();
+    testLongValues();
 
     testNamespaceSupport(true);
     testNamespaceSupport(false);
@@ -28,6 +28,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include <cstdio>
+#include <cstring>
 #include <Pegasus/Common/PegasusAssert.h>
 #include <Pegasus/Common/XmlWriter.h>
 #include <Pegasus/Common/System.h>
@@ -173,6 +174,118 @@ void testClassOriginC()
     return;
 }
 
+// Appends the encoding of an ASCII character by appendSpecial()
+static void _appendSpecialRef(Buffer& out, Uint16 c)
+{
+    char reference[8];
+
+    switch (c)
+    {
+        case '<': out.append("&lt;", 4); break;
+        case '>': out.append("&gt;", 4); break;
+        case '&': out.append("&amp;", 5); break;
+        case '"': out.append("&quot;", 6); break;
+        case '\'': out.append("&apos;", 6); break;
+        default:
+            if (c < 0x20 || c == 0x7F)
+            {
+                sprintf(reference, "&#%u;", c);
+                out.append(reference, Uint32(strlen(reference)));
+            }
+            else
+            {
+                out.append(char(c));
+            }
+    }
+}
+
+// Encodes a string of characters below 0x800 one character at a time, a
+// space at the start, at the end or after a written space is encoded as a
+// character reference.
+static void _appendSpecialRef(Buffer& out, const String& str)
+{
+    Boolean prevCharIsSpace = false;
+
+    for (Uint32 i = 0, n = str.size(); i < n; i++)
+    {
+        Uint16 c = str[i];
+
+        if (c == ' ' && (i == 0 || i == n - 1 || prevCharIsSpace))
+        {
+            out.append("&#32;", 5);
+            prevCharIsSpace = false;
+        }
+        else if (c < 0x80)
+        {
+            _appendSpecialRef(out, c);
+            prevCharIsSpace = (c == ' ');
+        }
+        else
+        {
+            out.append(char(0xC0 | (c >> 6)), char(0x80 | (c & 0x3F)));
+            prevCharIsSpace = false;
+        }
+    }
+}
+
+/* function shall check that appendSpecial() encodes strings, which it
+   copies in runs, the same as one character at a time */
+void testAppendSpecial()
+{
+    const Uint16 chars[] =
+        { ' ', ' ', '<', '>', '&', '\'', '"', '\n', 0x01, 0x7F, 0xE9, 0x7FF };
+    Char16 text[100];
+    Uint32 seed = 1;
+
+    for (Uint32 length = 0; length < 100; length++)
+    {
+        for (Uint32 round = 0; round < 20; round++)
+        {
+            for (Uint32 i = 0; i < length; i++)
+            {
+                seed = seed * 1103515245 + 12345;
+                Uint32 r = (seed >> 16) % (round < 10 ? 24 : 96);
+                text[i] = r < sizeof(chars) / sizeof(chars[0]) ? chars[r] : 'x';
+            }
+
+            String str(text, length);
+            Buffer expected;
+            _appendSpecialRef(expected, str);
+            Buffer encoded;
+            XmlWriter::appendSpecial(encoded, str);
+            PEGASUS_TEST_ASSERT(encoded == expected);
+
+            // The same ASCII characters as a UTF-8 string, without the
+            // encoding of spaces
+            CString cstr = str.getCString();
+            const char* utf8 = cstr;
+            expected.clear();
+            for (const char* p = utf8; *p; p++)
+            {
+                if (Uint8(*p) < 0x80)
+                {
+                    _appendSpecialRef(expected, Uint8(*p));
+                }
+                else
+                {
+                    expected.append(*p);
+                }
+            }
+            encoded.clear();
+            XmlWriter::appendSpecial(encoded, utf8, Uint32(strlen(utf8)));
+            PEGASUS_TEST_ASSERT(encoded == expected);
+        }
+    }
+
+    // Surrogate pairs are encoded as one 4 byte UTF-8 character
+    const Char16 pair[] = { 'a', 0xD801, 0xDC37, 'b' };
+    Buffer encoded;
+    XmlWriter::appendSpecial(encoded, String(pair, 4));
+    PEGASUS_TEST_ASSERT(encoded.size() == 6);
+    PEGASUS_TEST_ASSERT(
+        memcmp(encoded.getData(), "a\xF0\x90\x90\xB7" "b", 6) == 0);
+}
+
 int main(int argc, char** argv)
 {
     verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
@@ -191,6 +304,8 @@ int main(int argc, char** argv)
     // c) a basic type property
     testClassOriginC();
 
+    testAppendSpecial();
+
     cout << argv[0] << " +++++ passed all tests" << endl;
     return 0;
 }
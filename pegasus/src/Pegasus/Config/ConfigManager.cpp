@@ -136,6 +136,12 @@ static struct OwnerEntry _properties[] =
          (ConfigPropertyOwner*)&ConfigManager::securityOwner},
     {"sslTrustStoreUserName",
          (ConfigPropertyOwner*)&ConfigManager::securityOwner},
+    {"sslSessionCacheSize",
+         (ConfigPropertyOwner*)&ConfigManager::securityOwner},
+    {"sslSessionTimeout",
+         (ConfigPropertyOwner*)&ConfigManager::securityOwner},
+    {"enableSSLSessionTickets",
+         (ConfigPropertyOwner*)&ConfigManager::securityOwner},
 #ifdef PEGASUS_KERBEROS_AUTHENTICATION
     {"kerberosServiceName",
          (ConfigPropertyOwner*)&ConfigManager::securityOwner},
@@ -183,6 +189,36 @@ static struct OwnerEntry _properties[] =
     {"socketWriteTimeout",
          (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
     {"idleConnectionTimeout",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"connectionMonitors",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"connectionMonitorAssignment",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"cimxmlIndicationDeliveryThreads",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"cimxmlIndicationBatchSize",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"cimxmlIndicationRetryAttempts",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"cimxmlIndicationRetryInterval",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+#ifdef PEGASUS_PAM_AUTHENTICATION
+    {"basicAuthenticationCacheSize",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"basicAuthenticationCacheTimeout",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+#endif
+    {"scmoClassCacheSize",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"repositoryClassCacheSize",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"serviceThreadPoolMinThreads",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"serviceThreadPoolMaxThreads",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"serviceThreadPoolQueueSize",
+         (ConfigPropertyOwner*)&ConfigManager::defaultOwner},
+    {"enableRemoteBinaryProtocol",
          (ConfigPropertyOwner*)&ConfigManager::defaultOwner}
 };
 
@@ -39,9 +39,11 @@
 #include "DefaultPropertyOwner.h"
 #include "ConfigManager.h"
 #include <Pegasus/Common/AuditLogger.h>
+#include <Pegasus/Common/Constants.h>
 #include <Pegasus/Common/StringConversion.h>
 #include <Pegasus/Common/HTTPAcceptor.h>
 #include <Pegasus/Common/HTTPConnection.h>
+#include <Pegasus/Common/MonitorPool.h>
 #include <Pegasus/Common/CIMMessage.h>
 #include <Pegasus/Common/CIMNameCast.h>
 
@@ -365,19 +367,108 @@ Boolean DefaultPropertyOwner::isValid(
             (v != 0);
     }
     if (String::equal(name, "maxProviderProcesses") ||
-        String::equal(name, "idleConnectionTimeout"))
+        String::equal(name, "idleConnectionTimeout") ||
+        String::equal(name, "cimxmlIndicationRetryAttempts") ||
+        String::equal(name, "cimxmlIndicationRetryInterval"))
     {
         Uint64 v;
         return
             StringConversion::decimalStringToUint64(value.getCString(), v) &&
             StringConversion::checkUintBounds(v, CIMTYPE_UINT32);
     }
+    else if (String::equal(name, "connectionMonitors"))
+    {
+        Uint64 v;
+        return
+            StringConversion::decimalStringToUint64(value.getCString(), v) &&
+            (v >= 1) && (v <= PEGASUS_MAX_CONNECTION_MONITORS);
+    }
+    else if (String::equal(name, "cimxmlIndicationDeliveryThreads"))
+    {
+        Uint64 v;
+        return
+            StringConversion::decimalStringToUint64(value.getCString(), v) &&
+            (v <= PEGASUS_MAX_CIMXML_INDICATION_DELIVERY_THREADS);
+    }
+    else if (String::equal(name, "scmoClassCacheSize"))
+    {
+        Uint64 v;
+        return
+            StringConversion::decimalStringToUint64(value.getCString(), v) &&
+            (v <= PEGASUS_MAX_SCMO_CLASS_CACHE_SIZE);
+    }
+    else if (String::equal(name, "repositoryClassCacheSize"))
+    {
+        Uint64 v;
+        return
+            StringConversion::decimalStringToUint64(value.getCString(), v) &&
+            (v <= PEGASUS_MAX_REPOSITORY_CLASS_CACHE_SIZE);
+    }
+    else if (String::equal(name, "serviceThreadPoolMinThreads") ||
+        String::equal(name, "serviceThreadPoolMaxThreads"))
+    {
+        Boolean isMin = String::equal(name, "serviceThreadPoolMinThreads");
+        Uint64 v;
+        Uint64 other;
+        if (!StringConversion::decimalStringToUint64(value.getCString(), v) ||
+            (v > PEGASUS_MAX_SERVICE_THREAD_POOL_THREADS) ||
+            !StringConversion::decimalStringToUint64(
+                getPlannedValue(isMin ?
+                    "serviceThreadPoolMaxThreads" :
+                    "serviceThreadPoolMinThreads").getCString(),
+                other))
+        {
+            return false;
+        }
+
+        // The minimum must not exceed the maximum; 0 means no maximum
+        return isMin ?
+            ((other == 0) || (v <= other)) :
+            ((v == 0) || (other <= v));
+    }
+    else if (String::equal(name, "serviceThreadPoolQueueSize"))
+    {
+        Uint64 v;
+        return
+            StringConversion::decimalStringToUint64(value.getCString(), v) &&
+            (v <= PEGASUS_MAX_SERVICE_THREAD_POOL_QUEUE_SIZE);
+    }
+#ifdef PEGASUS_PAM_AUTHENTICATION
+    else if (String::equal(name, "basicAuthenticationCacheSize"))
+    {
+        Uint64 v;
+        return
+            StringConversion::decimalStringToUint64(value.getCString(), v) &&
+            (v <= PEGASUS_MAX_BASIC_AUTHENTICATION_CACHE_SIZE);
+    }
+    else if (String::equal(name, "basicAuthenticationCacheTimeout"))
+    {
+        Uint64 v;
+        return
+            StringConversion::decimalStringToUint64(value.getCString(), v) &&
+            StringConversion::checkUintBounds(v, CIMTYPE_UINT32);
+    }
+#endif
+    else if (String::equal(name, "cimxmlIndicationBatchSize"))
+    {
+        Uint64 v;
+        return
+            StringConversion::decimalStringToUint64(value.getCString(), v) &&
+            StringConversion::checkUintBounds(v, CIMTYPE_UINT32) &&
+            (v != 0);
+    }
+    else if (String::equal(name, "connectionMonitorAssignment"))
+    {
+        MonitorPool::AssignmentPolicy policy;
+        return MonitorPool::parseAssignmentPolicy(value, policy);
+    }
     else if (String::equal(name, "enableHttpConnection") ||
         String::equal(name, "enableHttpsConnection") ||
         String::equal(name, "daemon") ||
         String::equal(name, "enableAssociationTraversal") ||
         String::equal(name, "enableIndicationService") ||
-        String::equal(name, "forceProviderProcesses")
+        String::equal(name, "forceProviderProcesses") ||
+        String::equal(name, "enableRemoteBinaryProtocol")
 #ifdef PEGASUS_ENABLE_SLP
         || String::equal(name, "slp")
 #endif
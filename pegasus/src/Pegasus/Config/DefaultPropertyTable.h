@@ -35,6 +35,31 @@
     {"socketWriteTimeout", PEGASUS_DEFAULT_SOCKETWRITE_TIMEOUT_SECONDS_STRING,
         IS_DYNAMIC, IS_VISIBLE},
     {"idleConnectionTimeout", "0", IS_DYNAMIC, IS_VISIBLE},
+    {"connectionMonitors", "1", IS_STATIC, IS_VISIBLE},
+    {"connectionMonitorAssignment", "roundRobin", IS_STATIC, IS_VISIBLE},
+    {"cimxmlIndicationDeliveryThreads", "1", IS_STATIC, IS_VISIBLE},
+    {"cimxmlIndicationBatchSize", "16", IS_STATIC, IS_VISIBLE},
+    {"cimxmlIndicationRetryAttempts", "3", IS_STATIC, IS_VISIBLE},
+    {"cimxmlIndicationRetryInterval", "1", IS_STATIC, IS_VISIBLE},
+    {"scmoClassCacheSize", PEGASUS_DEFAULT_SCMO_CLASS_CACHE_SIZE_STRING,
+        IS_STATIC, IS_VISIBLE},
+    {"repositoryClassCacheSize",
+        PEGASUS_DEFAULT_REPOSITORY_CLASS_CACHE_SIZE_STRING,
+        IS_STATIC, IS_VISIBLE},
+    {"serviceThreadPoolMinThreads", "0", IS_STATIC, IS_VISIBLE},
+    {"serviceThreadPoolMaxThreads",
+        PEGASUS_DEFAULT_SERVICE_THREAD_POOL_MAX_THREADS_STRING,
+        IS_STATIC, IS_VISIBLE},
+    {"serviceThreadPoolQueueSize",
+        PEGASUS_DEFAULT_SERVICE_THREAD_POOL_QUEUE_SIZE_STRING,
+        IS_STATIC, IS_VISIBLE},
+    {"enableRemoteBinaryProtocol", "false", IS_STATIC, IS_VISIBLE},
+#ifdef PEGASUS_PAM_AUTHENTICATION
+    {"basicAuthenticationCacheSize",
+        PEGASUS_DEFAULT_BASIC_AUTHENTICATION_CACHE_SIZE_STRING,
+        IS_DYNAMIC, IS_VISIBLE},
+    {"basicAuthenticationCacheTimeout", "0", IS_DYNAMIC, IS_VISIBLE},
+#endif
 #if defined(PEGASUS_PLATFORM_LINUX_GENERIC_GNU)
 # include "DefaultPropertyTableLinux.h"
 #elif defined(PEGASUS_OS_SOLARIS)
@@ -40,6 +40,8 @@
 #include "SecurityPropertyOwner.h"
 #include <Pegasus/Common/FileSystem.h>
 #include <Pegasus/Common/System.h>
+#include <Pegasus/Common/StringConversion.h>
+#include <Pegasus/Common/Constants.h>
 
 
 PEGASUS_USING_STD;
@@ -83,6 +85,10 @@ static struct ConfigPropertyRow properties[] =
 # endif
     {"sslClientVerificationMode", "optional", IS_STATIC, IS_VISIBLE},
     {"sslTrustStoreUserName", "QYCMCIMOM", IS_STATIC, IS_VISIBLE},
+    {"sslSessionCacheSize", "0", IS_STATIC, IS_VISIBLE},
+    {"sslSessionTimeout", PEGASUS_DEFAULT_SSL_SESSION_TIMEOUT_SECONDS_STRING,
+        IS_STATIC, IS_VISIBLE},
+    {"enableSSLSessionTickets", "false", IS_STATIC, IS_VISIBLE},
     {"enableNamespaceAuthorization", "false", IS_STATIC, IS_VISIBLE},
 # ifdef PEGASUS_KERBEROS_AUTHENTICATION
     {"kerberosServiceName", "cimom", IS_STATIC, IS_VISIBLE},
@@ -107,6 +113,10 @@ static struct ConfigPropertyRow properties[] =
 #endif
     {"sslClientVerificationMode", "disabled", IS_STATIC, IS_VISIBLE},
     {"sslTrustStoreUserName", "", IS_STATIC, IS_VISIBLE},
+    {"sslSessionCacheSize", "0", IS_STATIC, IS_VISIBLE},
+    {"sslSessionTimeout", PEGASUS_DEFAULT_SSL_SESSION_TIMEOUT_SECONDS_STRING,
+        IS_STATIC, IS_VISIBLE},
+    {"enableSSLSessionTickets", "false", IS_STATIC, IS_VISIBLE},
     {"enableNamespaceAuthorization", "false", IS_STATIC, IS_VISIBLE},
 #ifdef PEGASUS_KERBEROS_AUTHENTICATION
     {"kerberosServiceName", "cimom", IS_STATIC, IS_VISIBLE},
@@ -151,6 +161,9 @@ SecurityPropertyOwner::SecurityPropertyOwner()
 #endif
     _sslClientVerificationMode.reset(new ConfigProperty());
     _sslTrustStoreUserName.reset(new ConfigProperty());
+    _sslSessionCacheSize.reset(new ConfigProperty());
+    _sslSessionTimeout.reset(new ConfigProperty());
+    _enableSSLSessionTickets.reset(new ConfigProperty());
     _enableRemotePrivilegedUserAccess.reset(new ConfigProperty());
     _enableSubscriptionsForNonprivilegedUsers.reset(new ConfigProperty());
 #ifdef PEGASUS_ENABLE_USERGROUP_AUTHORIZATION
@@ -297,6 +310,39 @@ void SecurityPropertyOwner::initialize()
             _sslTrustStoreUserName->externallyVisible =
                 properties[i].externallyVisible;
         }
+        else if (String::equal(
+            properties[i].propertyName, "sslSessionCacheSize"))
+        {
+            _sslSessionCacheSize->propertyName = properties[i].propertyName;
+            _sslSessionCacheSize->defaultValue = properties[i].defaultValue;
+            _sslSessionCacheSize->currentValue = properties[i].defaultValue;
+            _sslSessionCacheSize->plannedValue = properties[i].defaultValue;
+            _sslSessionCacheSize->dynamic = properties[i].dynamic;
+            _sslSessionCacheSize->externallyVisible =
+                properties[i].externallyVisible;
+        }
+        else if (String::equal(
+            properties[i].propertyName, "sslSessionTimeout"))
+        {
+            _sslSessionTimeout->propertyName = properties[i].propertyName;
+            _sslSessionTimeout->defaultValue = properties[i].defaultValue;
+            _sslSessionTimeout->currentValue = properties[i].defaultValue;
+            _sslSessionTimeout->plannedValue = properties[i].defaultValue;
+            _sslSessionTimeout->dynamic = properties[i].dynamic;
+            _sslSessionTimeout->externallyVisible =
+                properties[i].externallyVisible;
+        }
+        else if (String::equal(
+            properties[i].propertyName, "enableSSLSessionTickets"))
+        {
+            _enableSSLSessionTickets->propertyName = properties[i].propertyName;
+            _enableSSLSessionTickets->defaultValue = properties[i].defaultValue;
+            _enableSSLSessionTickets->currentValue = properties[i].defaultValue;
+            _enableSSLSessionTickets->plannedValue = properties[i].defaultValue;
+            _enableSSLSessionTickets->dynamic = properties[i].dynamic;
+            _enableSSLSessionTickets->externallyVisible =
+                properties[i].externallyVisible;
+        }
         else if (String::equal(
             properties[i].propertyName, "enableRemotePrivilegedUserAccess"))
         {
@@ -419,6 +465,18 @@ struct ConfigProperty* SecurityPropertyOwner::_lookupConfigProperty(
     {
         return _sslTrustStoreUserName.get();
     }
+    else if (String::equal(_sslSessionCacheSize->propertyName, name))
+    {
+        return _sslSessionCacheSize.get();
+    }
+    else if (String::equal(_sslSessionTimeout->propertyName, name))
+    {
+        return _sslSessionTimeout.get();
+    }
+    else if (String::equal(_enableSSLSessionTickets->propertyName, name))
+    {
+        return _enableSSLSessionTickets.get();
+    }
     else if (String::equal(
                  _enableRemotePrivilegedUserAccess->propertyName, name))
     {
@@ -587,7 +645,8 @@ Boolean SecurityPropertyOwner::isValid(
         String::equal(
             _enableRemotePrivilegedUserAccess->propertyName, name) ||
         String::equal(
-            _enableSubscriptionsForNonprivilegedUsers->propertyName, name)
+            _enableSubscriptionsForNonprivilegedUsers->propertyName, name) ||
+        String::equal(_enableSSLSessionTickets->propertyName, name)
 #ifdef PEGASUS_OS_ZOS
         || String::equal(_enableCFZAPPLID->propertyName, name)
 #endif
@@ -784,6 +843,20 @@ Boolean SecurityPropertyOwner::isValid(
             return true;
         }
     }
+    else if (String::equal(_sslSessionCacheSize->propertyName, name))
+    {
+        Uint64 v;
+        retVal =
+            StringConversion::decimalStringToUint64(value.getCString(), v) &&
+            (v <= PEGASUS_MAX_SSL_SESSION_CACHE_SIZE);
+    }
+    else if (String::equal(_sslSessionTimeout->propertyName, name))
+    {
+        Uint64 v;
+        retVal =
+            StringConversion::decimalStringToUint64(value.getCString(), v) &&
+            (v != 0) && (v <= PEGASUS_MAX_SSL_SESSION_TIMEOUT_SECONDS);
+    }
 #ifdef PEGASUS_ENABLE_USERGROUP_AUTHORIZATION
     else if (String::equal(_authorizedUserGroups->propertyName, name))
     {
@@ -200,6 +200,9 @@ private:
     AutoPtr<struct ConfigProperty> _crlStore;
     AutoPtr<struct ConfigProperty> _sslClientVerificationMode;
     AutoPtr<struct ConfigProperty> _sslTrustStoreUserName;
+    AutoPtr<struct ConfigProperty> _sslSessionCacheSize;
+    AutoPtr<struct ConfigProperty> _sslSessionTimeout;
+    AutoPtr<struct ConfigProperty> _enableSSLSessionTickets;
     AutoPtr<struct ConfigProperty> _enableSubscriptionsForNonprivilegedUsers;
 
 #ifdef PEGASUS_ENABLE_USERGROUP_AUTHORIZATION
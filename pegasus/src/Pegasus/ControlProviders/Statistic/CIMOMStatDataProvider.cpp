@@ -31,13 +31,37 @@
 
 #include "CIMOMStatDataProvider.h"
 #include <Pegasus/Common/PegasusVersion.h>
+#include <Pegasus/Common/SCMOClassCache.h>
+#include <Pegasus/Common/MessageQueueService.h>
+#include <Pegasus/Common/ThreadPool.h>
+#include <Pegasus/Common/HTTPConnection.h>
+#include <Pegasus/Common/PooledAllocator.h>
+#include <Pegasus/Common/ArrayInternal.h>
+#include <Pegasus/IndicationService/QueryExpressionCache.h>
 
 PEGASUS_USING_STD;
 PEGASUS_NAMESPACE_BEGIN
 
-CIMOMStatDataProvider::CIMOMStatDataProvider()
+// The percentiles reported for the histograms, in units of 1/1000
+static const struct
 {
-    for (Uint32 i=0; i<StatisticalData::length; i++)
+    Uint32 permille;
+    const char* name;
+} _PERCENTILES[] =
+{
+    { 500, "p50" },
+    { 900, "p90" },
+    { 990, "p99" },
+    { 999, "p999" }
+};
+
+static const Uint32 _NUM_PERCENTILES =
+    sizeof(_PERCENTILES) / sizeof(_PERCENTILES[0]);
+
+CIMOMStatDataProvider::CIMOMStatDataProvider(CIMRepository* repository)
+    : _repository(repository)
+{
+    for (Uint32 i=0; i<NUMBER_OF_INSTANCES; i++)
     {
         char buffer[32];
         sprintf(buffer, "%u", i);
@@ -70,7 +94,8 @@ void CIMOMStatDataProvider::getInstance(
     handler.processing();
 
     // instance index corresponds to reference index
-    for (Uint32 i = 0; i < StatisticalData::NUMBER_OF_TYPES; i++)
+    Uint32 i = 0;
+    for (; i < NUMBER_OF_INSTANCES; i++)
     {
         if (localReference == _references[i])
         {
@@ -80,6 +105,20 @@ void CIMOMStatDataProvider::getInstance(
         }
     }
 
+    if (i == NUMBER_OF_INSTANCES)
+    {
+        Array<CIMInstance> instances = getHistogramInstances();
+
+        for (Uint32 j = 0; j < instances.size(); j++)
+        {
+            if (localReference == instances[j].getPath())
+            {
+                handler.deliver(instances[j]);
+                break;
+            }
+        }
+    }
+
     // complete processing the request
     handler.complete();
 }
@@ -96,13 +135,15 @@ void CIMOMStatDataProvider::enumerateInstances(
     handler.processing();
 
     // instance index corresponds to reference index
-    for (Uint32 i = 0; i < StatisticalData::NUMBER_OF_TYPES; i++)
+    for (Uint32 i = 0; i < NUMBER_OF_INSTANCES; i++)
     {
         // deliver instance
         handler.deliver(getInstance(i, classReference));
 
     }
 
+    handler.deliver(getHistogramInstances());
+
     // complete processing the request
     handler.complete();
 }
@@ -115,12 +156,19 @@ void CIMOMStatDataProvider::enumerateInstanceNames(
     // begin processing the request
     handler.processing();
 
-    for (Uint32 i = 0; i < StatisticalData::NUMBER_OF_TYPES; i++)
+    for (Uint32 i = 0; i < NUMBER_OF_INSTANCES; i++)
     {
         // deliver reference
         handler.deliver(_references[i]);
     }
 
+    Array<CIMInstance> instances = getHistogramInstances();
+
+    for (Uint32 i = 0; i < instances.size(); i++)
+    {
+        handler.deliver(instances[i].getPath());
+    }
+
     // complete processing the request
     handler.complete();
 }
@@ -157,11 +205,41 @@ CIMInstance CIMOMStatDataProvider::getInstance(
     Uint16 type,
     CIMObjectPath cimRef)
 {
+    if (type >= QUERY_EXPRESSION_CACHE_HITS)
+    {
+        return getQueryExpressionCacheInstance(type);
+    }
+
+    if (type >= ALLOCATION_POOL_HITS)
+    {
+        return getAllocationPoolInstance(type);
+    }
+
+    if (type >= HTTP_RESPONSE_BYTES_SENT)
+    {
+        return getHTTPResponseInstance(type);
+    }
+
+    if (type >= SERVICE_THREAD_POOL_QUEUED_TASKS)
+    {
+        return getThreadPoolInstance(type);
+    }
+
+    if (type >= REPOSITORY_CLASS_CACHE_HITS)
+    {
+        return getRepositoryClassCacheInstance(type);
+    }
+
+    if (type >= StatisticalData::NUMBER_OF_TYPES)
+    {
+        return getSCMOClassCacheInstance(type);
+    }
 
     StatisticalData* sd = StatisticalData::current();
     char buffer[32];
     sprintf(buffer, "%hu", type);
 
+    sd->updateTotals();
     checkObjectManager();
 
     CIMDateTime cimom_time = CIMDateTime((sd->cimomTime[type]), true);
@@ -195,6 +273,363 @@ CIMInstance CIMOMStatDataProvider::getInstance(
     return requestedInstance;
 }
 
+CIMInstance CIMOMStatDataProvider::getSCMOClassCacheInstance(Uint16 type)
+{
+    Uint32 size;
+    Uint32 capacity;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 evictions;
+
+    SCMOClassCache::getInstance()->getStatistics(
+        size, capacity, hits, misses, evictions);
+
+    String otherOperationType;
+    Uint64 count;
+
+    switch (type)
+    {
+        case SCMO_CLASS_CACHE_HITS:
+            otherOperationType = "SCMOClassCacheHit";
+            count = hits;
+            break;
+
+        case SCMO_CLASS_CACHE_MISSES:
+            otherOperationType = "SCMOClassCacheMiss";
+            count = misses;
+            break;
+
+        default:
+            otherOperationType = "SCMOClassCacheEviction";
+            count = evictions;
+            break;
+    }
+
+    char buffer[64];
+    sprintf(buffer, "%u/%u", size, capacity);
+
+    return buildOtherInstance(
+        type,
+        otherOperationType,
+        count,
+        "CIMOM SCMOClass cache statistics",
+        ", cached classes (current/max): " + String(buffer));
+}
+
+CIMInstance CIMOMStatDataProvider::getRepositoryClassCacheInstance(
+    Uint16 type)
+{
+    Uint32 size = 0;
+    Uint32 capacity = 0;
+    Uint64 hits = 0;
+    Uint64 misses = 0;
+    Uint64 evictions = 0;
+
+    if (_repository)
+    {
+        _repository->getClassCacheStatistics(
+            size, capacity, hits, misses, evictions);
+    }
+
+    String otherOperationType;
+    Uint64 count;
+
+    switch (type)
+    {
+        case REPOSITORY_CLASS_CACHE_HITS:
+            otherOperationType = "RepositoryClassCacheHit";
+            count = hits;
+            break;
+
+        case REPOSITORY_CLASS_CACHE_MISSES:
+            otherOperationType = "RepositoryClassCacheMiss";
+            count = misses;
+            break;
+
+        default:
+            otherOperationType = "RepositoryClassCacheEviction";
+            count = evictions;
+            break;
+    }
+
+    char buffer[64];
+    sprintf(buffer, "%u/%u", size, capacity);
+
+    return buildOtherInstance(
+        type,
+        otherOperationType,
+        count,
+        "CIMOM repository class cache statistics",
+        ", cached classes (current/max): " + String(buffer));
+}
+
+CIMInstance CIMOMStatDataProvider::getThreadPoolInstance(Uint16 type)
+{
+    Uint32 queuedTasks = 0;
+    Uint32 peakQueuedTasks = 0;
+    Uint64 totalQueuedTasks = 0;
+    Uint64 totalQueueWaitUsec = 0;
+    Uint64 rejectedTasks = 0;
+    Uint64 stolenTasks = 0;
+
+    ThreadPool* threadPool = MessageQueueService::get_thread_pool();
+    if (threadPool)
+    {
+        threadPool->getQueueStatistics(
+            queuedTasks,
+            peakQueuedTasks,
+            totalQueuedTasks,
+            totalQueueWaitUsec,
+            rejectedTasks,
+            stolenTasks);
+    }
+
+    // Stolen work requests were taken by a thread from the deque of
+    // another thread
+    char buffer[96];
+    sprintf(buffer,
+        "%u/%u, stolen work requests: %" PEGASUS_64BIT_CONVERSION_WIDTH "u",
+        queuedTasks, peakQueuedTasks, stolenTasks);
+    String caption = "CIMOM service thread pool statistics";
+    String details = ", queued work requests (current/peak): " +
+        String(buffer);
+
+    if (type == SERVICE_THREAD_POOL_QUEUED_TASKS)
+    {
+        // The CimomElapsedTime is the time the queued work waited for a
+        // thread
+        CIMInstance requestedInstance = buildOtherInstance(
+            type, "ServiceThreadPoolQueuedTask", totalQueuedTasks,
+            caption, details);
+        requestedInstance.addProperty(CIMProperty("CimomElapsedTime",
+            CIMValue(CIMDateTime(totalQueueWaitUsec, true))));
+        return requestedInstance;
+    }
+
+    return buildOtherInstance(
+        type, "ServiceThreadPoolRejectedTask", rejectedTasks,
+        caption, details);
+}
+
+CIMInstance CIMOMStatDataProvider::getHTTPResponseInstance(Uint16 type)
+{
+    Uint64 responses;
+    Uint64 bytesSent;
+    Uint64 bytesCopied;
+
+    HTTPConnection::getResponseStatistics(responses, bytesSent, bytesCopied);
+
+    char buffer[64];
+    sprintf(buffer, "%" PEGASUS_64BIT_CONVERSION_WIDTH "u",
+        responses ? bytesCopied / responses : 0);
+
+    // BytesCopied are the bytes the connections copied while assembling
+    // the responses
+    Boolean sent = (type == HTTP_RESPONSE_BYTES_SENT);
+    CIMInstance requestedInstance = buildOtherInstance(
+        type,
+        sent ? "HTTPResponseBytesSent" : "HTTPResponseBytesCopied",
+        responses,
+        "HTTP response statistics",
+        ", bytes copied per response: " + String(buffer));
+    requestedInstance.addProperty(CIMProperty("ResponseSize",
+        CIMValue(sent ? bytesSent : bytesCopied)));
+
+    return requestedInstance;
+}
+
+CIMInstance CIMOMStatDataProvider::getAllocationPoolInstance(Uint16 type)
+{
+    Uint64 hits;
+    Uint64 misses;
+
+    PooledAllocator::getStatistics(hits, misses);
+
+    char buffer[64];
+    sprintf(buffer, "%" PEGASUS_64BIT_CONVERSION_WIDTH "u%%",
+        (hits + misses) ? hits * 100 / (hits + misses) : 0);
+
+    // Hits are the AsyncOpNode and Message allocations served from a free
+    // list, misses the ones served from the heap
+    Boolean hit = (type == ALLOCATION_POOL_HITS);
+    return buildOtherInstance(
+        type,
+        hit ? "AllocationPoolHit" : "AllocationPoolMiss",
+        hit ? hits : misses,
+        "CIMOM allocation pool statistics",
+        ", hit rate: " + String(buffer));
+}
+
+CIMInstance CIMOMStatDataProvider::getQueryExpressionCacheInstance(
+    Uint16 type)
+{
+    Uint64 hits;
+    Uint64 misses;
+
+    QueryExpressionCache::getStatistics(hits, misses);
+
+    char buffer[64];
+    sprintf(buffer, "%" PEGASUS_64BIT_CONVERSION_WIDTH "u%%",
+        (hits + misses) ? hits * 100 / (hits + misses) : 0);
+
+    // Lookups of the compiled filter queries and of their required
+    // properties by the IndicationService
+    Boolean hit = (type == QUERY_EXPRESSION_CACHE_HITS);
+    return buildOtherInstance(
+        type,
+        hit ? "QueryExpressionCacheHit" : "QueryExpressionCacheMiss",
+        hit ? hits : misses,
+        "CIMOM query expression cache statistics",
+        ", hit rate: " + String(buffer));
+}
+
+Array<CIMInstance> CIMOMStatDataProvider::getHistogramInstances()
+{
+    Array<CIMInstance> instances;
+    StatisticalData* sd = StatisticalData::current();
+
+    if (!sd->copyGSD)
+    {
+        return instances;
+    }
+
+    StatisticalHistogramSet types[StatisticalData::NUMBER_OF_TYPES];
+    Array<String> moduleNames;
+    Array<StatisticalHistogram> modules;
+
+    sd->getHistograms(types, moduleNames, modules);
+
+    for (Uint32 i = 0; i < StatisticalData::NUMBER_OF_TYPES; i++)
+    {
+        if (types[i].serverTime.getCount() == 0)
+        {
+            continue;
+        }
+
+        for (Uint32 j = 0; j < _NUM_PERCENTILES; j++)
+        {
+            instances.append(getHistogramInstance(
+                StatisticalData::requestName[i],
+                j,
+                &types[i].serverTime,
+                types[i].providerTime,
+                &types[i].responseSize));
+        }
+    }
+
+    // The server time and response size of a request are not attributable
+    // to a provider module, a request may be processed by several modules
+    for (Uint32 i = 0; i < moduleNames.size(); i++)
+    {
+        for (Uint32 j = 0; j < _NUM_PERCENTILES; j++)
+        {
+            instances.append(getHistogramInstance(
+                "ProviderModule " + moduleNames[i], j, 0, modules[i], 0));
+        }
+    }
+
+    return instances;
+}
+
+CIMInstance CIMOMStatDataProvider::getHistogramInstance(
+    const String& name,
+    Uint32 percentile,
+    const StatisticalHistogram* serverTime,
+    const StatisticalHistogram& providerTime,
+    const StatisticalHistogram* responseSize)
+{
+    Uint32 permille = _PERCENTILES[percentile].permille;
+    String otherOperationType = name + " " + _PERCENTILES[percentile].name;
+
+    // The InstanceID is the OtherOperationType without blanks
+    String instanceID = "CIM_CIMOMStatisticalData_" + otherOperationType;
+    for (Uint32 i = 0; i < instanceID.size(); i++)
+    {
+        if (instanceID[i] == ' ')
+        {
+            instanceID[i] = '_';
+        }
+    }
+
+    Array<CIMKeyBinding> keys;
+    keys.append(CIMKeyBinding("InstanceID", instanceID, CIMKeyBinding::STRING));
+
+    CIMInstance requestedInstance = buildOtherInstance(
+        instanceID,
+        CIMObjectPath(
+            String::EMPTY,
+            CIMNamespaceName(),
+            CIMName("CIM_CIMOMStatisticalData"),
+            keys),
+        otherOperationType,
+        providerTime.getCount(),
+        "CIMOM performance statistics percentile",
+        ": " + otherOperationType);
+
+    if (serverTime)
+    {
+        requestedInstance.addProperty(CIMProperty("CimomElapsedTime",
+            CIMValue(CIMDateTime(serverTime->getPercentile(permille), true))));
+    }
+
+    requestedInstance.addProperty(CIMProperty("ProviderElapsedTime",
+        CIMValue(CIMDateTime(providerTime.getPercentile(permille), true))));
+
+    if (responseSize)
+    {
+        requestedInstance.addProperty(CIMProperty("ResponseSize",
+            CIMValue(responseSize->getPercentile(permille))));
+    }
+
+    return requestedInstance;
+}
+
+CIMInstance CIMOMStatDataProvider::buildOtherInstance(
+    Uint16 type,
+    const String& otherOperationType,
+    Uint64 numberOfOperations,
+    const String& caption,
+    const String& details)
+{
+    char buffer[32];
+    sprintf(buffer, "%hu", type);
+
+    return buildOtherInstance(
+        "CIM_CIMOMStatisticalData" + String(buffer),
+        _references[type],
+        otherOperationType,
+        numberOfOperations,
+        caption,
+        details);
+}
+
+CIMInstance CIMOMStatDataProvider::buildOtherInstance(
+    const String& instanceID,
+    const CIMObjectPath& path,
+    const String& otherOperationType,
+    Uint64 numberOfOperations,
+    const String& caption,
+    const String& details)
+{
+    CIMInstance requestedInstance("CIM_CIMOMStatisticalData");
+    requestedInstance.addProperty(CIMProperty("InstanceID",
+        CIMValue(instanceID)));
+    requestedInstance.addProperty(CIMProperty("OperationType",
+        CIMValue(Uint16(1))));
+    requestedInstance.addProperty(CIMProperty("OtherOperationType",
+        CIMValue(otherOperationType)));
+    requestedInstance.addProperty(CIMProperty("NumberOfOperations",
+        CIMValue(numberOfOperations)));
+    requestedInstance.addProperty( CIMProperty("Description",
+        CIMValue(caption + details)));
+    requestedInstance.addProperty(CIMProperty("Caption",
+        CIMValue(caption)));
+
+    requestedInstance.setPath(path);
+
+    return requestedInstance;
+}
+
 /*CIMDateTime CIMOMStatDataProvider::toDateTime(Sint64 date)
 {
     // Break millisecond value into days, hours, minutes, seconds and
@@ -38,6 +38,7 @@
 #include <Pegasus/Common/CIMDateTime.h>
 #include <Pegasus/Provider/CIMInstanceProvider.h>
 #include <Pegasus/Common/StatisticalData.h>
+#include <Pegasus/Repository/CIMRepository.h>
 #include <math.h>
 #include <iostream>
 
@@ -48,7 +49,7 @@ class PEGASUS_STATISTICPROVIDER_LINKAGE CIMOMStatDataProvider :
     public CIMInstanceProvider
 {
 public:
-    CIMOMStatDataProvider();
+    CIMOMStatDataProvider(CIMRepository* repository = 0);
     virtual ~CIMOMStatDataProvider();
 
     // CIMProvider interface
@@ -102,12 +103,72 @@ public:
         const CIMObjectPath & ref,
         ResponseHandler & handler);
 
+    // The SCMOClass cache, repository class cache, service thread pool,
+    // HTTP response, allocation pool and query expression cache statistics
+    // are reported as instances of OperationType "Other" which follow the
+    // per operation instances.
+    enum
+    {
+        SCMO_CLASS_CACHE_HITS = StatisticalData::NUMBER_OF_TYPES,
+        SCMO_CLASS_CACHE_MISSES,
+        SCMO_CLASS_CACHE_EVICTIONS,
+        REPOSITORY_CLASS_CACHE_HITS,
+        REPOSITORY_CLASS_CACHE_MISSES,
+        REPOSITORY_CLASS_CACHE_EVICTIONS,
+        SERVICE_THREAD_POOL_QUEUED_TASKS,
+        SERVICE_THREAD_POOL_REJECTED_TASKS,
+        HTTP_RESPONSE_BYTES_SENT,
+        HTTP_RESPONSE_BYTES_COPIED,
+        ALLOCATION_POOL_HITS,
+        ALLOCATION_POOL_MISSES,
+        QUERY_EXPRESSION_CACHE_HITS,
+        QUERY_EXPRESSION_CACHE_MISSES,
+        NUMBER_OF_INSTANCES
+    };
+
     CIMInstance getInstance(Uint16 type, CIMObjectPath cimRef);
     Uint16 getOpType(Uint16 type);
 
 protected:
-    CIMObjectPath _references[StatisticalData::NUMBER_OF_TYPES];
+    CIMObjectPath _references[NUMBER_OF_INSTANCES];
     void checkObjectManager();
+    CIMInstance getSCMOClassCacheInstance(Uint16 type);
+    CIMInstance getRepositoryClassCacheInstance(Uint16 type);
+    CIMInstance getThreadPoolInstance(Uint16 type);
+    CIMInstance getHTTPResponseInstance(Uint16 type);
+    CIMInstance getAllocationPoolInstance(Uint16 type);
+    CIMInstance getQueryExpressionCacheInstance(Uint16 type);
+
+    // Builds an instance with OperationType "Other" (1).  The Description
+    // is the Caption followed by the details.  The first form identifies
+    // the instance by its type, the second by its InstanceID and path.
+    CIMInstance buildOtherInstance(
+        Uint16 type,
+        const String& otherOperationType,
+        Uint64 numberOfOperations,
+        const String& caption,
+        const String& details);
+    CIMInstance buildOtherInstance(
+        const String& instanceID,
+        const CIMObjectPath& path,
+        const String& otherOperationType,
+        Uint64 numberOfOperations,
+        const String& caption,
+        const String& details);
+
+    // The server time, provider time and response size percentiles of the
+    // request types and the provider time percentiles of the provider
+    // modules are reported as additional "Other" instances, one for each
+    // percentile of a request type or module with recorded requests.
+    Array<CIMInstance> getHistogramInstances();
+    CIMInstance getHistogramInstance(
+        const String& name,
+        Uint32 percentile,
+        const StatisticalHistogram* serverTime,
+        const StatisticalHistogram& providerTime,
+        const StatisticalHistogram* responseSize);
+
+    CIMRepository* _repository;
 };
 
 PEGASUS_NAMESPACE_END
@@ -107,6 +107,8 @@ public:
 
     Uint32 getIdleTimeout();
 
+    void setRemoteBinaryProtocol(Boolean flag);
+
 private:
 
     // core components
@@ -234,6 +236,11 @@ void DynamicListenerRep::setIdleTimeout(Uint32 idleTimeout)
 //do nothing for now
 }
 
+void DynamicListenerRep::setRemoteBinaryProtocol(Boolean flag)
+{
+    _listenerService->setRemoteBinaryProtocol(flag);
+}
+
 
 /////////////////////////////////////////////////////////////////////////////
 // DynamicListener
@@ -378,6 +385,11 @@ void DynamicListener::setIdleTimeout(Uint32 idleTimeout)
     static_cast<DynamicListenerRep*>(_rep)->setIdleTimeout(idleTimeout);
 }
 
+void DynamicListener::setRemoteBinaryProtocol(Boolean flag)
+{
+    static_cast<DynamicListenerRep*>(_rep)->setRemoteBinaryProtocol(flag);
+}
+
 
 PEGASUS_NAMESPACE_END
 
@@ -106,6 +106,13 @@ public:
 
     Uint32 getIdleTimeout();
 
+    /**
+        Sets whether export clients may send batches of indications in the
+        compact encoding of the OpenPegasus binary protocol.  They are not
+        accepted unless this is set before start().
+    */
+    void setRemoteBinaryProtocol(Boolean flag);
+
 private:
     void* _rep;
 
@@ -81,6 +81,10 @@ static struct OptionRow optionsTable[] =
  "shutdownTimeout",
  "the length of time to wait for consumer threads to complete, in ms"},
 
+{"enableRemoteBinaryProtocol", "false", false, Option::BOOLEAN, 0, 0,
+ "enableRemoteBinaryProtocol",
+ "specifies whether binary batches of indications are accepted"},
+
 {"traceFilePath", "cimlistener.trc", false, Option::STRING, 0, 0,
  "traceFilePath", "path to the listener's trace file"},
 
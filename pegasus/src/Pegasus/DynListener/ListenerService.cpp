@@ -46,6 +46,7 @@ _dispatcher(0),
 _portNumber(0),
 _useSSL(false),
 _sslContext(0),
+_remoteBinaryProtocol(false),
 _initialized(0),
 _running(0),
 _dieNow(0),
@@ -133,6 +134,7 @@ Boolean ListenerService::initializeListener(Uint32 portNumber,
 
     _requestDecoder = new CIMExportRequestDecoder(_dispatcher,
                                          _responseEncoder->getQueueId());
+    _requestDecoder->setRemoteBinaryProtocol(_remoteBinaryProtocol);
 
     _shutdownSem = new Semaphore(0);
 
@@ -461,5 +463,10 @@ Uint32 ListenerService::getPortNumber() const
     return _portNumber;
 }
 
+void ListenerService::setRemoteBinaryProtocol(Boolean flag)
+{
+    _remoteBinaryProtocol = flag;
+}
+
 
 PEGASUS_NAMESPACE_END
@@ -74,6 +74,12 @@ public:
 
     Uint32 getPortNumber() const;
 
+    /**
+        Sets whether binary batches of indications are accepted.  It must
+        be called before initializeListener().
+    */
+    void setRemoteBinaryProtocol(Boolean flag);
+
     static ThreadReturnType PEGASUS_THREAD_CDECL _listener_routine(void *param);
 
     static ThreadReturnType PEGASUS_THREAD_CDECL _polling_routine(void *param);
@@ -87,6 +93,7 @@ private:
     Uint32 _portNumber;
     Boolean _useSSL;
     SSLContext* _sslContext;
+    Boolean _remoteBinaryProtocol;
 
     //ATTN: do we need to mutex the status?  The consumer mgr takes
     // care of synchronization ... but,
@@ -647,6 +647,7 @@ int CIMListenerProcess::cimserver_run(
     Boolean enableConsumerUnload;
     Uint32 consumerIdleTimeout;
     Uint32 shutdownTimeout;
+    Boolean enableRemoteBinaryProtocol;
     String traceFile;
     Uint32 traceLevel;
     String traceComponents;
@@ -666,6 +667,8 @@ int CIMListenerProcess::cimserver_run(
     configManager->lookupIntegerValue("consumerIdleTimeout",
                                       consumerIdleTimeout);
     configManager->lookupIntegerValue("shutdownTimeout", shutdownTimeout);
+    enableRemoteBinaryProtocol =
+        configManager->isTrue("enableRemoteBinaryProtocol");
     configManager->lookupValue("traceFilePath", traceFile);
     configManager->lookupIntegerValue("traceLevel", traceLevel);
     configManager->lookupValue("traceComponents", traceComponents);
@@ -806,6 +809,8 @@ MessageLoader::_useProcessLocale = false;
                                            consumerIdleTimeout,
                                            shutdownTimeout);
 
+        _cimListener->setRemoteBinaryProtocol(enableRemoteBinaryProtocol);
+
         _cimListener->start();
 
         Logger::put_l(Logger::STANDARD_LOG,
@@ -831,6 +836,8 @@ MessageLoader::_useProcessLocale = false;
         printf("\tenableConsumerUnload %d\n", enableConsumerUnload);
         printf("\tconsumerIdleTimeout %u\n", consumerIdleTimeout);
         printf("\tshutdownTimeout %u\n", shutdownTimeout);
+        printf("\tenableRemoteBinaryProtocol %d\n",
+                enableRemoteBinaryProtocol);
         printf("\ttraceFilePath %s\n", (const char*)traceFile.getCString());
         printf("\ttraceLevel %u\n", traceLevel);
         printf("\ttraceComponents %s\n",
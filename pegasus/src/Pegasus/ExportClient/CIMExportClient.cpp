@@ -62,6 +62,7 @@ CIMExportClient::CIMExportClient(
    _timeoutMilliseconds(timeoutMilliseconds),
    _connected(false),
    _doReconnect(false),
+   _binaryExport(false),
    _responseDecoder(0),
    _requestEncoder(0)
 {
@@ -203,6 +204,7 @@ void CIMExportClient::connect(
     // Set authentication information
     //
     _authenticator.clear();
+    _binaryExport = false;
 
     _connectSSLContext.reset(0);
     _connectHost = hostName;
@@ -240,6 +242,7 @@ void CIMExportClient::connect(
     // Set authentication information
     //
     _authenticator.clear();
+    _binaryExport = false;
 
     _connectSSLContext.reset(new SSLContext(sslContext));
     _connectHost = hostName;
@@ -264,6 +267,7 @@ void CIMExportClient::disconnect()
     _disconnect();
     _authenticator.clear();
     _connectSSLContext.reset();
+    _binaryExport = false;
     PEG_METHOD_EXIT();
 }
 
@@ -298,17 +302,36 @@ void CIMExportClient::exportIndication(
         Message* message = _doRequest(request,
             CIM_EXPORT_INDICATION_RESPONSE_MESSAGE);
 
+        CIMExportIndicationResponseMessage* response =
+            (CIMExportIndicationResponseMessage*)message;
+
+        AutoPtr<CIMExportIndicationResponseMessage> ap(response);
+
+        //
+        // A listener that accepts batches of indications responds in the
+        // binary protocol, with the result of the indication.
+        //
+        CIMExportIndicationBatchResponseMessage* batchResponse =
+            dynamic_cast<CIMExportIndicationBatchResponseMessage*>(response);
+
+        if (batchResponse)
+        {
+            _checkBatchResponse(batchResponse, 1);
+            _binaryExport = true;
+
+            const CIMException& result = batchResponse->results[0];
+            if (result.getCode() != CIM_ERR_SUCCESS)
+            {
+                throw CIMException(result.getCode(), result.getMessage());
+            }
+        }
+
         PEG_TRACE ((TRC_INDICATION_GENERATION, Tracer::LEVEL4,
             "%s Indication for destination %s:%d%s exported successfully",
             (const char*)(instanceName.getClassName().getString().
             getCString()),
             (const char*)(_connectHost.getCString()), _connectPortNumber,
             (const char*)(url.getCString())));
-
-        CIMExportIndicationResponseMessage* response =
-            (CIMExportIndicationResponseMessage*)message;
-
-        AutoPtr<CIMExportIndicationResponseMessage> ap(response);
     }
     catch (const Exception& e)
     {
@@ -326,6 +349,110 @@ void CIMExportClient::exportIndication(
     PEG_METHOD_EXIT();
 }
 
+void CIMExportClient::exportIndications(
+    const String& url,
+    const Array<CIMInstance>& indications,
+    const Array<ContentLanguageList>& contentLanguages,
+    Array<CIMException>& results)
+{
+    PEG_METHOD_ENTER (TRC_EXPORT_CLIENT,
+        "CIMExportClient::exportIndications()");
+
+    PEGASUS_ASSERT(indications.size() == contentLanguages.size());
+
+    results.clear();
+
+    //
+    // Send the indications one at a time until the listener has answered
+    // in the binary protocol.
+    //
+    Uint32 i = 0;
+
+    for (; i < indications.size() && !_binaryExport; i++)
+    {
+        try
+        {
+            exportIndication(url, indications[i], contentLanguages[i]);
+            results.append(CIMException());
+        }
+        catch (const CIMException& e)
+        {
+            results.append(e);
+        }
+    }
+
+    if (i == indications.size())
+    {
+        PEG_METHOD_EXIT();
+        return;
+    }
+
+    //
+    // Send the rest in a single request
+    //
+    Uint32 count = indications.size() - i;
+
+    try
+    {
+        CIMRequestMessage* request = new CIMExportIndicationBatchRequestMessage(
+            String::EMPTY,
+            url,
+            Array<CIMInstance>(indications.getData() + i, count),
+            Array<ContentLanguageList>(contentLanguages.getData() + i, count));
+
+        PEG_TRACE ((TRC_INDICATION_GENERATION, Tracer::LEVEL4,
+            "Exporting %u indications for destination %s:%d%s",
+            count,
+            (const char*)(_connectHost.getCString()), _connectPortNumber,
+            (const char*)(url.getCString())));
+
+        AutoPtr<Message> response(_doRequest(request,
+            CIM_EXPORT_INDICATION_RESPONSE_MESSAGE));
+
+        CIMExportIndicationBatchResponseMessage* batchResponse =
+            dynamic_cast<CIMExportIndicationBatchResponseMessage*>(
+                response.get());
+
+        _checkBatchResponse(batchResponse, count);
+
+        results.appendArray(batchResponse->results);
+    }
+    catch (const Exception& e)
+    {
+        PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+            "Failed to export %u indications: %s",
+            count,
+            (const char*)e.getMessage().getCString()));
+        PEG_METHOD_EXIT();
+        throw;
+    }
+    catch (...)
+    {
+        PEG_TRACE ((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+            "Failed to export %u indications",
+            count));
+        PEG_METHOD_EXIT();
+        throw;
+    }
+    PEG_METHOD_EXIT();
+}
+
+void CIMExportClient::_checkBatchResponse(
+    CIMExportIndicationBatchResponseMessage* response,
+    Uint32 count)
+{
+    if (!response || response->results.size() != count)
+    {
+        MessageLoaderParms mlParms(
+            "ExportClient.CIMExportClient.MISMATCHED_BATCH_RESPONSE",
+            "Mismatched response to a request with $0 indications.",
+            count);
+        String mlString(MessageLoader::getMessage(mlParms));
+
+        throw CIMClientResponseException(mlString);
+    }
+}
+
 Message* CIMExportClient::_doRequest(
     CIMRequestMessage* pRequest,
     MessageType expectedResponseMessageType)
@@ -53,6 +53,7 @@ PEGASUS_NAMESPACE_BEGIN
 class Monitor;
 class CIMExportResponseDecoder;
 class CIMExportRequestEncoder;
+class CIMExportIndicationBatchResponseMessage;
 
 /**
     This class provides the interface that a client uses to communicate
@@ -162,6 +163,38 @@ public:
         const CIMInstance& instance,
         const ContentLanguageList& contentLanguages = ContentLanguageList());
 
+    /**
+        Send several indications to the destination defined by url.  Once
+        the listener has answered an export request in the OpenPegasus
+        binary protocol (see isBinaryExport()), the indications are sent in
+        a single request in its compact encoding; until then they are sent
+        one at a time, as by exportIndication().
+
+        @param url String defining the destination of the indications.
+        @param indications the indication instances to be sent.
+        @param contentLanguages the language of each indication.
+        @param results receives the result of each indication; the
+        indication was delivered if the code is CIM_ERR_SUCCESS.
+        @exception Exception if a request fails other than with a
+        CIMException from the listener.  The indications not yet sent have
+        no result then.
+    */
+    void exportIndications(
+        const String& url,
+        const Array<CIMInstance>& indications,
+        const Array<ContentLanguageList>& contentLanguages,
+        Array<CIMException>& results);
+
+    /**
+        Returns true if the listener has answered an export request in the
+        binary protocol since the last connect(), i.e. if it accepts
+        batches of indications.
+    */
+    Boolean isBinaryExport() const
+    {
+        return _binaryExport;
+    }
+
 private:
 
     void _connect();
@@ -171,6 +204,14 @@ private:
         CIMRequestMessage* request,
         MessageType expectedResponseMessageType);
 
+    /**
+        Throws a CIMClientResponseException unless response is a binary
+        response with count results.
+    */
+    static void _checkBatchResponse(
+        CIMExportIndicationBatchResponseMessage* response,
+        Uint32 count);
+
     Monitor* _monitor;
     HTTPConnector* _httpConnector;
     HTTPConnection* _httpConnection;
@@ -190,6 +231,9 @@ private:
     */
     Boolean _doReconnect;
 
+    /** See isBinaryExport() */
+    Boolean _binaryExport;
+
     CIMExportResponseDecoder* _responseDecoder;
     CIMExportRequestEncoder* _requestEncoder;
     ClientAuthenticator _authenticator;
@@ -36,6 +36,7 @@
 #include <Pegasus/Common/HTTPMessage.h>
 #include <Pegasus/Common/AcceptLanguageList.h>
 #include <Pegasus/Common/ContentLanguageList.h>
+#include <Pegasus/Common/BinaryCodec.h>
 #include "CIMExportRequestEncoder.h"
 
 PEGASUS_USING_STD;
@@ -77,8 +78,16 @@ void CIMExportRequestEncoder::handleEnqueue()
     switch (message->getType())
     {
         case CIM_EXPORT_INDICATION_REQUEST_MESSAGE:
-            _encodeExportIndicationRequest(
-                (CIMExportIndicationRequestMessage*)message);
+            if (((CIMExportIndicationRequestMessage*)message)->binaryRequest)
+            {
+                _encodeExportIndicationBatchRequest(
+                    (CIMExportIndicationBatchRequestMessage*)message);
+            }
+            else
+            {
+                _encodeExportIndicationRequest(
+                    (CIMExportIndicationRequestMessage*)message);
+            }
             break;
         default:
             PEGASUS_ASSERT(0);
@@ -107,6 +116,8 @@ void CIMExportRequestEncoder::_encodeExportIndicationRequest(
 
     // Note:  Accept-Language will not be set in the request
     // We will accept the default language of the export server.
+    // The request accepts a response in the binary protocol, by which an
+    // OpenPegasus listener tells that it accepts batches of indications.
     Buffer buffer = XmlWriter::formatSimpleEMethodReqMessage(
         message->destinationPath.getCString(),
         _hostName,
@@ -117,7 +128,8 @@ void CIMExportRequestEncoder::_encodeExportIndicationRequest(
         AcceptLanguageList(),
         ((ContentLanguageListContainer)message->operationContext.get(
             ContentLanguageListContainer::NAME)).getLanguages(),
-        params);
+        params,
+        true);
 
     HTTPMessage* httpMessage = new HTTPMessage(buffer);
     PEG_TRACE_CSTRING(TRC_XML_IO, Tracer::LEVEL4,
@@ -127,4 +139,42 @@ void CIMExportRequestEncoder::_encodeExportIndicationRequest(
     PEG_METHOD_EXIT();
 }
 
+void CIMExportRequestEncoder::_encodeExportIndicationBatchRequest(
+    CIMExportIndicationBatchRequestMessage* message)
+{
+    PEG_METHOD_ENTER(TRC_EXPORT_CLIENT,
+        "CIMExportRequestEncoder::_encodeExportIndicationBatchRequest()");
+
+    // The content languages of the indications are part of the body.
+    Buffer body;
+    BinaryCodec::encodeExportIndicationRequest(
+        body,
+        message->messageId,
+        message->indications,
+        message->contentLanguages);
+
+    Buffer buffer;
+    XmlWriter::appendEMethodRequestHeader(
+        buffer,
+        message->destinationPath.getCString(),
+        _hostName,
+        CIMName("ExportIndication"),
+        message->getHttpMethod(),
+        _authenticator->buildRequestAuthHeader(),
+        AcceptLanguageList(),
+        ContentLanguageList(),
+        body.size(),
+        true,
+        true);
+    buffer.append(body.getData(), body.size());
+
+    PEG_TRACE((TRC_EXPORT_CLIENT, Tracer::LEVEL4,
+        "Sending binary export request %s with %u indications",
+        (const char*)message->messageId.getCString(),
+        message->indications.size()));
+
+    _outputQueue->enqueue(new HTTPMessage(buffer));
+    PEG_METHOD_EXIT();
+}
+
 PEGASUS_NAMESPACE_END
@@ -36,11 +36,37 @@
 #include <Pegasus/Common/MessageQueue.h>
 #include <Pegasus/Common/CIMMessage.h>
 #include <Pegasus/Common/AutoPtr.h>
+#include <Pegasus/Common/ContentLanguageList.h>
 #include <Pegasus/Client/ClientAuthenticator.h>
 #include <Pegasus/ExportClient/Linkage.h>
 
 PEGASUS_NAMESPACE_BEGIN
 
+/** A batch of indications, which the CIMExportRequestEncoder sends in a
+    single request in the compact encoding of the binary protocol. The
+    indicationInstance member is not used.
+*/
+class CIMExportIndicationBatchRequestMessage
+    : public CIMExportIndicationRequestMessage
+{
+public:
+    CIMExportIndicationBatchRequestMessage(
+        const String& messageId_,
+        const String& destinationPath_,
+        const Array<CIMInstance>& indications_,
+        const Array<ContentLanguageList>& contentLanguages_)
+    : CIMExportIndicationRequestMessage(
+        messageId_, destinationPath_, CIMInstance(), QueueIdStack()),
+        indications(indications_),
+        contentLanguages(contentLanguages_)
+    {
+        binaryRequest = true;
+    }
+
+    Array<CIMInstance> indications;
+    Array<ContentLanguageList> contentLanguages;
+};
+
 /** This class receives CIM Operation Request messages on its input queue
     and encodes them into HTTP messages which it places on its output queue.
 */
@@ -70,6 +96,9 @@ class PEGASUS_EXPORT_CLIENT_LINKAGE CIMExportRequestEncoder
       void _encodeExportIndicationRequest(
             CIMExportIndicationRequestMessage* message);
 
+      void _encodeExportIndicationBatchRequest(
+            CIMExportIndicationBatchRequestMessage* message);
+
       MessageQueue* _outputQueue;
       CString _hostName;
       AutoPtr<ClientAuthenticator> _authenticator; //PEP101
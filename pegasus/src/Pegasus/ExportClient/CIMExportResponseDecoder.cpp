@@ -207,11 +207,22 @@ void CIMExportResponseDecoder::_handleHTTPMessage(HTTPMessage* httpMessage)
     }
 
     //
-    //  Decode the export response message
+    //  Decode the export response message.  A listener that accepts
+    //  batches of indications in the binary protocol responds in it.
     //
     Message* responseMessage;
-    HTTPExportResponseDecoder::decodeExportResponse(content, cimReconnect,
-        responseMessage);
+    String contentType;
+    if (HTTPMessage::lookupHeader(headers, "Content-Type", contentType, true) &&
+        String::equalNoCase(contentType, "application/x-openpegasus-compact"))
+    {
+        HTTPExportResponseDecoder::decodeBinaryExportResponse(content,
+            contentLength, cimReconnect, responseMessage);
+    }
+    else
+    {
+        HTTPExportResponseDecoder::decodeExportResponse(content, cimReconnect,
+            responseMessage);
+    }
     _outputQueue->enqueue(responseMessage);
 
     PEG_METHOD_EXIT();
@@ -36,6 +36,7 @@
 #include <Pegasus/Common/CIMMessage.h>
 #include <Pegasus/Common/MessageLoader.h>
 #include <Pegasus/Common/Tracer.h>
+#include <Pegasus/Common/BinaryCodec.h>
 #include <Pegasus/Client/CIMClientException.h>
 #include "HTTPExportResponseDecoder.h"
 
@@ -440,6 +441,42 @@ void HTTPExportResponseDecoder::decodeExportResponse(
     PEG_METHOD_EXIT();
 }
 
+void HTTPExportResponseDecoder::decodeBinaryExportResponse(
+    const char* content,
+    Uint32 contentLength,
+    Boolean cimReconnect,
+    Message*& responseMessage)
+{
+    PEG_METHOD_ENTER (TRC_EXPORT_CLIENT,
+        "HTTPExportResponseDecoder::decodeBinaryExportResponse()");
+
+    AutoPtr<Message> response;
+    String messageId;
+    Array<CIMException> results;
+
+    if (BinaryCodec::decodeExportIndicationResponse(
+            Buffer(content, contentLength), messageId, results))
+    {
+        response.reset(
+            new CIMExportIndicationBatchResponseMessage(messageId, results));
+    }
+    else
+    {
+        MessageLoaderParms mlParms(
+            "ExportClient.CIMExportResponseDecoder.CORRUPT_BINARY_RESPONSE",
+            "Corrupt binary response message");
+        String mlString(MessageLoader::getMessage(mlParms));
+
+        response.reset(new ClientExceptionMessage(
+            new CIMClientResponseException(mlString)));
+    }
+
+    response->setCloseConnect(cimReconnect);
+    responseMessage = response.release();
+
+    PEG_METHOD_EXIT();
+}
+
 CIMExportIndicationResponseMessage*
 HTTPExportResponseDecoder::_decodeExportIndicationResponse(
     XmlParser& parser,
@@ -67,6 +67,27 @@ public:
     Exception* clientException;
 };
 
+/**
+    The response to a request in the binary protocol, with the result of
+    each indication of the request.  An indication was delivered if its
+    result has the code CIM_ERR_SUCCESS.
+*/
+class CIMExportIndicationBatchResponseMessage
+    : public CIMExportIndicationResponseMessage
+{
+public:
+    CIMExportIndicationBatchResponseMessage(
+        const String& messageId_,
+        const Array<CIMException>& results_)
+    : CIMExportIndicationResponseMessage(
+        messageId_, CIMException(), QueueIdStack()),
+        results(results_)
+    {
+    }
+
+    Array<CIMException> results;
+};
+
 /**
     The HTTPExportResponseDecoder class provides interfaces to parse and
     validate HTTP headers, and decode an export response message.
@@ -152,6 +173,25 @@ public:
         Boolean cimReconnect,
         Message*& responseMessage);
 
+    /**
+        Decodes an Export Response in the compact encoding of the binary
+        protocol.
+
+        @param  content           INPUT   char* containing message content
+        @param  contentLength     INPUT   Uint32 length of message content
+        @param  cimReconnect      INPUT   Boolean indicating whether close and
+                                            reconnect are necessary
+        @param  responseMessage   OUTPUT  Message* response containing either
+                                            a CIMExportIndicationBatchResponse-
+                                            Message, or exception when error
+                                            is detected
+     */
+    static void decodeBinaryExportResponse(
+        const char* content,
+        Uint32 contentLength,
+        Boolean cimReconnect,
+        Message*& responseMessage);
+
 private:
 
     /**
@@ -43,6 +43,8 @@
 #include <Pegasus/Common/CommonUTF.h>
 #include <Pegasus/Common/MessageLoader.h>
 #include <Pegasus/Common/LanguageParser.h>
+#include <Pegasus/Common/BinaryCodec.h>
+#include "CIMExportResponseEncoder.h"
 
 PEGASUS_USING_STD;
 
@@ -54,7 +56,10 @@ CIMExportRequestDecoder::CIMExportRequestDecoder(
     : Base(PEGASUS_QUEUENAME_EXPORTREQDECODER),
       _outputQueue(outputQueue),
       _returnQueueId(returnQueueId),
-      _serverTerminating(false)
+      _responseEncoder(dynamic_cast<CIMExportResponseEncoder*>(
+          MessageQueue::lookup(returnQueueId))),
+      _serverTerminating(false),
+      _remoteBinaryProtocol(false)
 {
 }
 
@@ -429,12 +434,20 @@ void CIMExportRequestDecoder::handleHTTPMessage(HTTPMessage* httpMessage)
         headers, "Content-Type", cimContentType, true);
     String type;
     String charset;
+    Boolean binaryRequest = false;
+
+    // Batches of indications in the compact encoding of the binary protocol
+    // are accepted if they are enabled and the responses go to a
+    // CIMExportResponseEncoder, which collects the results of the
+    // indications in a batch.
 
     if (!contentTypeHeaderFound ||
         !HTTPMessage::parseContentTypeHeader(cimContentType, type, charset) ||
-        (!String::equalNoCase(type, "application/xml") &&
-         !String::equalNoCase(type, "text/xml")) ||
-        !String::equalNoCase(charset, "utf-8"))
+        (((!String::equalNoCase(type, "application/xml") &&
+           !String::equalNoCase(type, "text/xml")) ||
+          !String::equalNoCase(charset, "utf-8"))
+         && !(binaryRequest = _acceptsBinaryProtocol() && String::equalNoCase(
+             type, "application/x-openpegasus-compact"))))
     {
         sendHttpError(
             queueId,
@@ -444,7 +457,7 @@ void CIMExportRequestDecoder::handleHTTPMessage(HTTPMessage* httpMessage)
             closeConnect);
         return;
     }
-    else
+    else if (!binaryRequest)
     {
         // Validating content falls within UTF8 (required to be complaint
         // with section C12 of Unicode 4.0 spec, chapter 3.)
@@ -467,6 +480,32 @@ void CIMExportRequestDecoder::handleHTTPMessage(HTTPMessage* httpMessage)
 
     // If it is a method call, then dispatch it to be handled:
 
+    if (binaryRequest)
+    {
+        handleBinaryMethodRequest(
+            queueId,
+            httpMethod,
+            content,
+            contentLength,
+            requestUri,
+            cimExportMethod,
+            userName,
+            httpMessage->ipAddress,
+            acceptLanguages,
+            closeConnect);
+        return;
+    }
+
+    // Check for "Accept: application/x-openpegasus-compact" HTTP header to
+    // see if the client can send batches in the binary protocol. Such a
+    // client gets a binary response, which tells it that this listener
+    // accepts them.
+
+    String accept;
+    Boolean binaryResponse = _acceptsBinaryProtocol() &&
+        HTTPMessage::lookupHeader(headers, "Accept", accept, true) &&
+        String::equalNoCase(accept, "application/x-openpegasus-compact");
+
     handleMethodRequest(
         queueId,
         httpMethod,
@@ -478,7 +517,8 @@ void CIMExportRequestDecoder::handleHTTPMessage(HTTPMessage* httpMessage)
         httpMessage->ipAddress,
         acceptLanguages,
         contentLanguages,
-        closeConnect);
+        closeConnect,
+        binaryResponse);
 }
 
 void CIMExportRequestDecoder::handleMethodRequest(
@@ -492,7 +532,8 @@ void CIMExportRequestDecoder::handleMethodRequest(
     const String& ipAddress,
     const AcceptLanguageList& httpAcceptLanguages,
     const ContentLanguageList& httpContentLanguages,
-    Boolean closeConnect)
+    Boolean closeConnect,
+    Boolean binaryResponse)
 {
     // Set the Accept-Language into the thread for this service.
     // This will allow all code in this thread to get
@@ -689,7 +730,10 @@ void CIMExportRequestDecoder::handleMethodRequest(
                     cimExportMethodName, "ExportIndication") == 0)
             {
                request.reset(decodeExportIndicationRequest(
-                   queueId, parser, messageId, requestUri));
+                   queueId,
+                   parser,
+                   messageId,
+                   requestUri));
             }
             else
             {
@@ -819,9 +863,142 @@ void CIMExportRequestDecoder::handleMethodRequest(
 
     request->setCloseConnect(closeConnect);
 
+    // The response encoder finds the batch by the message ID of the
+    // request, which must not be pending on the connection already.
+    if (binaryResponse &&
+        !_responseEncoder->addIndicationBatch(
+            queueId,
+            httpMethod,
+            messageId,
+            Array<String>(&messageId, 1),
+            closeConnect))
+    {
+        sendEMethodError(
+            queueId,
+            httpMethod,
+            messageId,
+            "ExportIndication",
+            PEGASUS_CIM_EXCEPTION(CIM_ERR_FAILED,
+                "A request with this message ID is already pending."),
+            closeConnect);
+        return;
+    }
+
     _outputQueue->enqueue(request.release());
 }
 
+void CIMExportRequestDecoder::handleBinaryMethodRequest(
+    Uint32 queueId,
+    HttpMethod httpMethod,
+    char* content,
+    Uint32 contentLength,
+    const String& requestUri,
+    const char* cimExportMethodInHeader,
+    const String& userName,
+    const String& ipAddress,
+    const AcceptLanguageList& httpAcceptLanguages,
+    Boolean closeConnect)
+{
+    PEGASUS_ASSERT(_responseEncoder);
+
+    Thread::setLanguages(httpAcceptLanguages);
+
+    //
+    // If CIM Listener is shutting down, return error response
+    //
+    if (_serverTerminating)
+    {
+        sendHttpError(
+            queueId,
+            HTTP_STATUS_SERVICEUNAVAILABLE,
+            String::EMPTY,
+            "CIM Listener is shutting down.",
+            closeConnect);
+        return;
+    }
+
+    // ExportIndication is the only export method of the binary protocol
+
+    if (System::strcasecmp(cimExportMethodInHeader, "ExportIndication") != 0)
+    {
+        sendHttpError(
+            queueId,
+            HTTP_STATUS_BADREQUEST,
+            "header-mismatch",
+            String::EMPTY,
+            closeConnect);
+        return;
+    }
+
+    String messageId;
+    Array<CIMInstance> indications;
+    Array<ContentLanguageList> contentLanguages;
+
+    if (!BinaryCodec::decodeExportIndicationRequest(
+            Buffer(content, contentLength),
+            messageId,
+            indications,
+            contentLanguages) ||
+        indications.size() == 0)
+    {
+        sendHttpError(
+            queueId,
+            HTTP_STATUS_BADREQUEST,
+            "request-not-valid",
+            "Corrupt binary request message",
+            closeConnect);
+        return;
+    }
+
+    PEG_TRACE((TRC_INDICATION_RECEIPT, Tracer::LEVEL4,
+        "Received binary export request %s with %u indications",
+        (const char*)messageId.getCString(),
+        indications.size()));
+
+    // Each indication is passed on as a request of its own, with a message
+    // ID by which the response encoder finds the batch it belongs to.  The
+    // batch is registered before the first request is passed on, since the
+    // response may be sent before enqueue() returns.
+
+    String destStr = _getDestinationPath(requestUri);
+    Array<String> indicationMessageIds;
+
+    for (Uint32 i = 0; i < indications.size(); i++)
+    {
+        indicationMessageIds.append(XmlWriter::getNextMessageId());
+    }
+
+    Boolean added = _responseEncoder->addIndicationBatch(
+        queueId,
+        httpMethod,
+        messageId,
+        indicationMessageIds,
+        closeConnect);
+    PEGASUS_ASSERT(added);
+
+    for (Uint32 i = 0; i < indications.size(); i++)
+    {
+        CIMExportIndicationRequestMessage* request =
+            new CIMExportIndicationRequestMessage(
+                indicationMessageIds[i],
+                destStr,
+                indications[i],
+                QueueIdStack(queueId, _returnQueueId));
+
+        request->operationContext.insert(IdentityContainer(userName));
+        request->operationContext.set(
+            ContentLanguageListContainer(contentLanguages[i]));
+        request->operationContext.set(
+            AcceptLanguageListContainer(AcceptLanguageList()));
+
+        request->ipAddress = ipAddress;
+
+        request->setCloseConnect(closeConnect);
+
+        _outputQueue->enqueue(request);
+    }
+}
+
 CIMExportIndicationRequestMessage*
 CIMExportRequestDecoder::decodeExportIndicationRequest(
     Uint32 queueId,
@@ -831,8 +1008,7 @@ CIMExportRequestDecoder::decodeExportIndicationRequest(
 {
     CIMInstance instanceName;
 
-    String destStr = requestUri.subString(
-        requestUri.find("/CIMListener") + 12, PEG_NOT_FOUND);
+    String destStr = _getDestinationPath(requestUri);
 
     for (const char* name; XmlReader::getEParamValueTag(parser, name);)
     {
@@ -867,4 +1043,15 @@ void CIMExportRequestDecoder::setServerTerminating(Boolean flag)
     _serverTerminating = flag;
 }
 
+void CIMExportRequestDecoder::setRemoteBinaryProtocol(Boolean flag)
+{
+    _remoteBinaryProtocol = flag;
+}
+
+String CIMExportRequestDecoder::_getDestinationPath(const String& requestUri)
+{
+    return requestUri.subString(
+        requestUri.find("/CIMListener") + 12, PEG_NOT_FOUND);
+}
+
 PEGASUS_NAMESPACE_END
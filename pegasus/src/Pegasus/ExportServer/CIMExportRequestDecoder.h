@@ -43,6 +43,7 @@
 PEGASUS_NAMESPACE_BEGIN
 
 class XmlParser;
+class CIMExportResponseEncoder;
 
 /** This class decodes CIM operation requests and passes them down-stream.
  */
@@ -96,6 +97,25 @@ public:
         const String& ipAddress,
         const AcceptLanguageList& httpAcceptLanguages,
         const ContentLanguageList& httpContentLanguages,
+        Boolean closeConnect,
+        Boolean binaryResponse = false);
+
+    /**
+        Handles a batch of indications in the compact encoding of the
+        binary protocol (see BinaryCodec::encodeExportIndicationRequest()).
+        Each indication is passed on in a request of its own; the response
+        encoder answers the batch once all of them have been processed.
+    */
+    void handleBinaryMethodRequest(
+        Uint32 queueId,
+        HttpMethod httpMethod,
+        char* content,
+        Uint32 contentLength,
+        const String& requestUri,
+        const char* cimExportMethodInHeader,
+        const String& userName,
+        const String& ipAddress,
+        const AcceptLanguageList& httpAcceptLanguages,
         Boolean closeConnect);
 
     CIMExportIndicationRequestMessage* decodeExportIndicationRequest(
@@ -110,15 +130,36 @@ public:
     */
     void setServerTerminating(Boolean flag);
 
+    /**
+        Sets whether export clients may send batches of indications in the
+        compact encoding of the binary protocol.  They are not accepted
+        unless this is set.
+    */
+    void setRemoteBinaryProtocol(Boolean flag);
+
 private:
 
+    static String _getDestinationPath(const String& requestUri);
+
+    Boolean _acceptsBinaryProtocol() const
+    {
+        return _remoteBinaryProtocol && _responseEncoder;
+    }
+
     MessageQueue* _outputQueue;
 
     // Queue where responses should be enqueued.
     Uint32 _returnQueueId;
 
+    // The return queue, if it is a CIMExportResponseEncoder; 0 otherwise.
+    // Binary requests are only accepted if it is.
+    CIMExportResponseEncoder* _responseEncoder;
+
     // Flag to indicate whether or not the CIMServer is shutting down.
     Boolean _serverTerminating;
+
+    // Whether batches in the binary protocol are accepted.
+    Boolean _remoteBinaryProtocol;
 };
 
 PEGASUS_NAMESPACE_END
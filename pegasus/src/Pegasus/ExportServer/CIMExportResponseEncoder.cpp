@@ -40,19 +40,65 @@
 #include <Pegasus/Common/Logger.h>
 #include <Pegasus/Common/Tracer.h>
 #include <Pegasus/Common/ContentLanguageList.h>
+#include <Pegasus/Common/ArrayInternal.h>
+#include <Pegasus/Common/AutoPtr.h>
+#include <Pegasus/Common/BinaryCodec.h>
+#include <Pegasus/Common/StringConversion.h>
+#include <Pegasus/Common/TimeValue.h>
 #include "CIMExportResponseEncoder.h"
 
 PEGASUS_USING_STD;
 
 PEGASUS_NAMESPACE_BEGIN
 
+/**
+    Time after which a batch still waiting for the responses of its
+    indications is dropped, e.g. because a response got lost.
+*/
+#define PEGASUS_EXPORT_INDICATION_BATCH_TIMEOUT_SECONDS 600
+
+/**
+    Minimum interval between two checks for batches whose connection was
+    closed or which timed out.
+*/
+#define PEGASUS_EXPORT_INDICATION_BATCH_CHECK_SECONDS 10
+
+struct CIMExportResponseEncoder::IndicationBatch
+{
+    Uint32 queueId;
+    HttpMethod httpMethod;
+    String messageId;
+    Boolean closeConnect;
+    Array<CIMException> results;
+    /** Number of indications without a response yet */
+    Uint32 pending;
+    /** Time the batch was registered */
+    Uint64 startMsec;
+};
+
 CIMExportResponseEncoder::CIMExportResponseEncoder()
-    : Base(PEGASUS_QUEUENAME_EXPORTRESPENCODER)
+    : Base(PEGASUS_QUEUENAME_EXPORTRESPENCODER),
+      _indicationBatchCheckMsec(0)
 {
 }
 
 CIMExportResponseEncoder::~CIMExportResponseEncoder()
 {
+    // Delete the batches still waiting for responses
+    Array<IndicationBatch*> batches;
+
+    for (IndicationBatchTable::Iterator i = _indicationBatches.start(); i; i++)
+    {
+        if (!Contains(batches, i.value().batch))
+        {
+            batches.append(i.value().batch);
+        }
+    }
+
+    for (Uint32 i = 0; i < batches.size(); i++)
+    {
+        delete batches[i];
+    }
 }
 
 void CIMExportResponseEncoder::sendResponse(
@@ -150,6 +196,11 @@ void CIMExportResponseEncoder::encodeExportIndicationResponse(
             "response>getCloseConnect() returned %d",
         response->getCloseConnect()));
 
+    if (_addIndicationBatchResult(response))
+    {
+        return;
+    }
+
     if (response->cimException.getCode() != CIM_ERR_SUCCESS)
     {
         sendEMethodError(response, "ExportIndication",closeConnect);
@@ -171,4 +222,171 @@ void CIMExportResponseEncoder::encodeExportIndicationResponse(
     sendResponse(response->queueIds.top(), message,closeConnect);
 }
 
+String CIMExportResponseEncoder::_getIndicationBatchKey(
+    Uint32 queueId,
+    const String& messageId)
+{
+    // The message IDs of CIM-XML requests are chosen by the clients, so
+    // they are only unique per connection.
+    char buffer[22];
+    Uint32 size;
+    const char* queueIdString = Uint32ToString(buffer, queueId, size);
+
+    String key(queueIdString, size);
+    key.append(Char16(':'));
+    key.append(messageId);
+    return key;
+}
+
+Boolean CIMExportResponseEncoder::addIndicationBatch(
+    Uint32 queueId,
+    HttpMethod httpMethod,
+    const String& messageId,
+    const Array<String>& indicationMessageIds,
+    Boolean closeConnect)
+{
+    PEGASUS_ASSERT(indicationMessageIds.size() != 0);
+
+    Uint64 nowMsec = TimeValue::getCurrentTime().toMilliseconds();
+
+    AutoPtr<IndicationBatch> batch(new IndicationBatch);
+    batch->queueId = queueId;
+    batch->httpMethod = httpMethod;
+    batch->messageId = messageId;
+    batch->closeConnect = closeConnect;
+    batch->results.grow(indicationMessageIds.size(), CIMException());
+    batch->pending = indicationMessageIds.size();
+    batch->startMsec = nowMsec;
+
+    AutoMutex autoMut(_indicationBatchMutex);
+
+    _removeStaleIndicationBatches(nowMsec);
+
+    for (Uint32 i = 0; i < indicationMessageIds.size(); i++)
+    {
+        IndicationBatchEntry entry;
+        entry.batch = batch.get();
+        entry.index = i;
+
+        if (!_indicationBatches.insert(
+                _getIndicationBatchKey(queueId, indicationMessageIds[i]),
+                entry))
+        {
+            PEG_TRACE((TRC_HTTP, Tracer::LEVEL2,
+                "Export request %s is already pending on the connection",
+                (const char*)indicationMessageIds[i].getCString()));
+
+            while (i--)
+            {
+                _indicationBatches.remove(
+                    _getIndicationBatchKey(queueId, indicationMessageIds[i]));
+            }
+            return false;
+        }
+    }
+
+    batch.release();
+    return true;
+}
+
+void CIMExportResponseEncoder::_removeStaleIndicationBatches(Uint64 nowMsec)
+{
+    if (nowMsec < _indicationBatchCheckMsec +
+            PEGASUS_EXPORT_INDICATION_BATCH_CHECK_SECONDS * 1000)
+    {
+        return;
+    }
+
+    _indicationBatchCheckMsec = nowMsec;
+
+    // A batch is stale if its connection was closed, so that the response
+    // cannot be sent anymore, or if a response did not arrive in time.
+    Array<String> keys;
+    Array<IndicationBatch*> batches;
+
+    for (IndicationBatchTable::Iterator i = _indicationBatches.start(); i; i++)
+    {
+        IndicationBatch* batch = i.value().batch;
+
+        if (MessageQueue::lookup(batch->queueId) == 0 ||
+            nowMsec > batch->startMsec +
+                PEGASUS_EXPORT_INDICATION_BATCH_TIMEOUT_SECONDS * 1000)
+        {
+            keys.append(i.key());
+
+            if (!Contains(batches, batch))
+            {
+                batches.append(batch);
+            }
+        }
+    }
+
+    for (Uint32 i = 0; i < keys.size(); i++)
+    {
+        _indicationBatches.remove(keys[i]);
+    }
+
+    for (Uint32 i = 0; i < batches.size(); i++)
+    {
+        PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL2,
+            "Dropped export request %s waiting for %u of %u indications",
+            (const char*)batches[i]->messageId.getCString(),
+            batches[i]->pending,
+            batches[i]->results.size()));
+        delete batches[i];
+    }
+}
+
+Boolean CIMExportResponseEncoder::_addIndicationBatchResult(
+    CIMExportIndicationResponseMessage* response)
+{
+    AutoPtr<IndicationBatch> batch;
+
+    {
+        AutoMutex autoMut(_indicationBatchMutex);
+
+        String key = _getIndicationBatchKey(
+            response->queueIds.top(), response->messageId);
+
+        IndicationBatchEntry entry;
+        if (!_indicationBatches.lookup(key, entry))
+        {
+            return false;
+        }
+
+        _indicationBatches.remove(key);
+        entry.batch->results[entry.index] = response->cimException;
+
+        if (--entry.batch->pending != 0)
+        {
+            return true;
+        }
+
+        batch.reset(entry.batch);
+    }
+
+    Buffer body;
+    BinaryCodec::encodeExportIndicationResponse(
+        body, batch->messageId, batch->results);
+
+    // Note: Content-Language will not be set in the response, as for the
+    // CIM-XML responses.
+    Buffer message;
+    XmlWriter::appendEMethodResponseHeader(
+        message,
+        batch->httpMethod,
+        ContentLanguageList(),
+        body.size(),
+        true);
+    message.append(body.getData(), body.size());
+
+    PEG_TRACE((TRC_HTTP, Tracer::LEVEL4,
+        "Sending binary export response for %u indications",
+        batch->results.size()));
+
+    sendResponse(batch->queueId, message, batch->closeConnect);
+
+    return true;
+}
+
 PEGASUS_NAMESPACE_END
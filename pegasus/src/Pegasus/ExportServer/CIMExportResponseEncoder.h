@@ -35,6 +35,8 @@
 #include <Pegasus/Common/Config.h>
 #include <Pegasus/Common/MessageQueue.h>
 #include <Pegasus/Common/CIMMessage.h>
+#include <Pegasus/Common/HashTable.h>
+#include <Pegasus/Common/Mutex.h>
 #include <Pegasus/ExportServer/Linkage.h>
 
 PEGASUS_NAMESPACE_BEGIN
@@ -75,6 +77,58 @@ public:
 
     void encodeExportIndicationResponse(
         CIMExportIndicationResponseMessage* response);
+
+    /**
+        Registers an export request whose indications were passed on as
+        separate requests with the message IDs in indicationMessageIds.
+        Their responses are collected and answered with a single binary
+        response (see BinaryCodec::encodeExportIndicationResponse()) once
+        all of them have arrived.  A batch whose connection was closed, or
+        which waits too long for a response, is dropped.
+
+        @return false if one of the message IDs is already pending on the
+            connection; the batch is not registered then.
+    */
+    Boolean addIndicationBatch(
+        Uint32 queueId,
+        HttpMethod httpMethod,
+        const String& messageId,
+        const Array<String>& indicationMessageIds,
+        Boolean closeConnect);
+
+private:
+
+    struct IndicationBatch;
+
+    struct IndicationBatchEntry
+    {
+        IndicationBatch* batch;
+        Uint32 index;
+    };
+
+    typedef HashTable<String, IndicationBatchEntry,
+        EqualFunc<String>, HashFunc<String> > IndicationBatchTable;
+
+    static String _getIndicationBatchKey(
+        Uint32 queueId,
+        const String& messageId);
+
+    Boolean _addIndicationBatchResult(
+        CIMExportIndicationResponseMessage* response);
+
+    void _removeStaleIndicationBatches(Uint64 nowMsec);
+
+    /** Protects _indicationBatches and _indicationBatchCheckMsec */
+    Mutex _indicationBatchMutex;
+
+    /**
+        The pending batches, by the queue IDs of their connections and the
+        message IDs of their indications
+    */
+    IndicationBatchTable _indicationBatches;
+
+    /** Time of the last check for stale batches */
+    Uint64 _indicationBatchCheckMsec;
 };
 
 PEGASUS_NAMESPACE_END
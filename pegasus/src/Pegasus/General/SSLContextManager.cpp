@@ -130,6 +130,24 @@ void SSLContextManager::createSSLContext(
 //
 // use the following methods only if SSL is available
 //
+void SSLContextManager::setSessionCacheParameters(
+    Uint32 cacheSize,
+    Uint32 timeoutSeconds,
+    Boolean enableTickets)
+{
+    PEG_METHOD_ENTER(TRC_SSL,
+        "SSLContextManager::setSessionCacheParameters()");
+
+    if (_sslContext)
+    {
+        WriteLock contextLock(_sslContextObjectLock);
+        _sslContext->_rep->setSessionCacheParameters(
+            cacheSize, timeoutSeconds, enableTickets);
+    }
+
+    PEG_METHOD_EXIT();
+}
+
 #ifdef PEGASUS_HAS_SSL
 
 /**
@@ -274,6 +292,9 @@ void SSLContextManager::reloadTrustStore()
     WriteLock contextLock(_sslContextObjectLock);
     SSL_CTX_set_cert_store(sslContext, newStore);
 
+    // Sessions of clients that are no longer trusted must not be resumed
+    _sslContext->_rep->flushSessions();
+
     PEG_METHOD_EXIT();
 }
 
@@ -321,6 +342,7 @@ void SSLContextManager::reloadCRLStore()
         if (_sslContext)
         {
             _sslContext->_rep->setCRLStore(_getNewX509Store(crlPath));
+            _sslContext->_rep->flushSessions();
         }
     }
 
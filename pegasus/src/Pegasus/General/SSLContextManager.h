@@ -63,6 +63,18 @@ public:
         Boolean callback,
         const String& randFile);
 
+    /**
+        Configure the resumption of the TLS sessions of the connections
+        accepted with the SSL context.
+        @param cacheSize  number of sessions cached, 0 disables the cache.
+        @param timeoutSeconds  lifetime of a cached session or ticket.
+        @param enableTickets  specifies whether session tickets are issued.
+     */
+    void setSessionCacheParameters(
+        Uint32 cacheSize,
+        Uint32 timeoutSeconds,
+        Boolean enableTickets);
+
     /**
         Reload the trust store used by either the CIM Server or
         Indication Server based on the context type.
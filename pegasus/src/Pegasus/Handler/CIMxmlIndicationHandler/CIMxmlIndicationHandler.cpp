@@ -29,36 +29,45 @@
 //
 //%/////////////////////////////////////////////////////////////////////////////
 
-#include <Pegasus/ExportClient/CIMExportClient.h>
 #include <Pegasus/Handler/CIMHandler.h>
 #include <Pegasus/Repository/CIMRepository.h>
 #include <Pegasus/Config/ConfigManager.h>
 #include <Pegasus/Common/Config.h>
 #include <Pegasus/Common/PegasusVersion.h>
 #include <Pegasus/Common/Constants.h>
-#include <Pegasus/Common/SSLContext.h>
+#include <Pegasus/Common/HashTable.h>
+#include <Pegasus/Common/StringConversion.h>
 #include <Pegasus/Common/System.h>
 #include <Pegasus/Common/Tracer.h>
 #include <Pegasus/Common/HostLocator.h>
 
+#include "IndicationDeliveryQueue.h"
+
 PEGASUS_NAMESPACE_BEGIN
 
 PEGASUS_USING_STD;
 
-
-static Boolean verifyListenerCertificate(SSLCertificateInfo& certInfo)
-{
-    // ATTN: Add code to handle listener certificate verification.
-    //
-    return true;
-}
-
+/**
+    Maximum number of indications queued for a destination.  Indications
+    for a destination whose queue is full are discarded.
+*/
+#define PEGASUS_CIMXML_INDICATION_MAX_QUEUE_SIZE 10000
+
+/**
+    The delivery queue of a destination, with its delivery threads, is
+    removed when no indication has been queued for it for this many seconds.
+    Idle queues are looked for at most once per
+    PEGASUS_CIMXML_INDICATION_IDLE_CHECK_SECONDS.
+*/
+#define PEGASUS_CIMXML_INDICATION_QUEUE_IDLE_SECONDS 300
+#define PEGASUS_CIMXML_INDICATION_IDLE_CHECK_SECONDS 60
 
 class PEGASUS_HANDLER_LINKAGE CIMxmlIndicationHandler: public CIMHandler
 {
 public:
 
     CIMxmlIndicationHandler()
+        : _lastIdleCheck(0)
     {
         PEG_METHOD_ENTER(TRC_IND_HANDLER,
             "CIMxmlIndicationHandler::CIMxmlIndicationHandler");
@@ -69,17 +78,50 @@ public:
     {
         PEG_METHOD_ENTER(TRC_IND_HANDLER,
             "CIMxmlIndicationHandler::~CIMxmlIndicationHandler");
+        terminate();
         PEG_METHOD_EXIT();
     }
 
     void initialize(CIMRepository* repository)
     {
+        PEG_METHOD_ENTER(TRC_IND_HANDLER,
+            "CIMxmlIndicationHandler::initialize");
+
+        _options.deliveryThreads =
+            _getUint32ConfigValue("cimxmlIndicationDeliveryThreads");
+        _options.batchSize =
+            _getUint32ConfigValue("cimxmlIndicationBatchSize");
+        _options.retryAttempts =
+            _getUint32ConfigValue("cimxmlIndicationRetryAttempts");
+        _options.retryInterval =
+            _getUint32ConfigValue("cimxmlIndicationRetryInterval");
+        _options.maxQueueSize = PEGASUS_CIMXML_INDICATION_MAX_QUEUE_SIZE;
+
+        if (_options.batchSize == 0)
+        {
+            _options.batchSize = 1;
+        }
 
+        PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL3,
+            "CIM-XML indication delivery: %u threads per destination, "
+                "batch size %u, %u retries, retry interval %u seconds",
+            _options.deliveryThreads,
+            _options.batchSize,
+            _options.retryAttempts,
+            _options.retryInterval));
+
+        PEG_METHOD_EXIT();
     }
 
     void terminate()
     {
+        AutoMutex autoMut(_queuesMutex);
 
+        for (QueueTable::Iterator i = _queues.start(); i; i++)
+        {
+            delete i.value();
+        }
+        _queues.clear();
     }
 
     void handleIndication(
@@ -148,218 +190,276 @@ public:
            getValue().toString().getCString()),
            (const char*)(indicationInstance.getClassName().getString().
            getCString()), (const char*)(dest.getCString())));
-        try
-        {
-            static String PROPERTY_NAME__SSLCERT_FILEPATH =
-                "sslCertificateFilePath";
-            static String PROPERTY_NAME__SSLKEY_FILEPATH  = "sslKeyFilePath";
 
+        ExportDestination destination;
+        _parseDestination(dest, destination);
+
+        if (_options.deliveryThreads == 0)
+        {
             //
-            // Get the sslCertificateFilePath property from the Config Manager.
+            // Synchronous delivery over a new connection
             //
-            ConfigManager* configManager = ConfigManager::getInstance();
+            try
+            {
+                IndicationExportConnection connection(destination);
+                Uint32 retries;
+                IndicationDeliveryQueue::deliver(connection, _options,
+                    indicationInstance, contentLanguages, 0, retries);
+            }
+            catch(Exception& e)
+            {
+                //ATTN: Catch specific exceptions and log the error message
+                // as Indication delivery failed.
+                String msg = e.getMessage();
 
-            String certPath;
-            certPath = ConfigManager::getHomedPath(
-                configManager->getCurrentValue(
-                    PROPERTY_NAME__SSLCERT_FILEPATH));
+                PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+                    "CIMxmlIndicationHandler::handleIndication failed to "
+                    "deliver indication due to Exception: %s",
+                    (const char*)e.getMessage().getCString()));
 
-            //
-            // Get the sslKeyFilePath property from the Config Manager.
-            //
-            String keyPath;
-            keyPath = ConfigManager::getHomedPath(
-                configManager->getCurrentValue(
-                    PROPERTY_NAME__SSLKEY_FILEPATH));
+                PEG_METHOD_EXIT();
+                throw PEGASUS_CIM_EXCEPTION(CIM_ERR_FAILED, msg);
+            }
 
-            String trustPath;
-            String randFile;
+            PEG_METHOD_EXIT();
+            return;
+        }
 
-#ifdef PEGASUS_SSL_RANDOMFILE
-            randFile =
-                ConfigManager::getHomedPath(PEGASUS_SSLSERVER_RANDOMFILE);
-#endif
+        //
+        // Queue the indication for asynchronous delivery.  Delivery
+        // failures are traced by the delivery queue.
+        //
+        if (!_getDeliveryQueue(destination)->enqueue(
+                indicationInstance, contentLanguages))
+        {
+            PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+                "CIMxmlIndicationHandler::handleIndication discarded "
+                "indication, the delivery queue for destination %s is full",
+                (const char*)dest.getCString()));
 
-            Monitor monitor;
-            HTTPConnector httpConnector(&monitor);
+            MessageLoaderParms param(
+                "Handler.CIMxmlIndicationHandler.CIMxmlIndicationHandler."
+                    "DELIVERY_QUEUE_FULL",
+                "The indication delivery queue for destination \"$0\" is "
+                    "full.",
+                dest);
 
-            CIMExportClient exportclient(&monitor, &httpConnector);
-            Uint32 colon = dest.find (":");
-            Uint32 portNumber = 0;
-            Boolean useHttps = false;
-            String destStr = dest;
-            String hostStr;
+            PEG_METHOD_EXIT();
+            throw PEGASUS_CIM_EXCEPTION(CIM_ERR_FAILED,
+                MessageLoader::getMessage(param));
+        }
 
-            //
-            // If the URL has https (https://hostname:port/... or
-            // https://hostname/...) then use SSL for Indication delivery.
-            // If it has http (http://hostname:port/...
-            // or http://hostname/...) then do not use SSL.
-            //
-            if (colon != PEG_NOT_FOUND)
-            {
-                String httpStr = dest.subString(0, colon);
-                if (String::equalNoCase(httpStr, "https"))
-                {
-                    useHttps = true;
-                }
-                else if (String::equalNoCase(httpStr, "http"))
-                {
-                    useHttps = false;
-                }
-                else
-                {
-                    String msg = _getMalformedExceptionMsg(dest);
-
-                    PEG_TRACE((TRC_DISCARDED_DATA,Tracer::LEVEL1,"%s%s",
-                        (const char*)msg.getCString(),
-                        (const char*)dest.getCString()));
-
-                    PEG_METHOD_EXIT();
-                    throw PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED,
-                        msg);
-                }
-            }
-            else
-            {
-                String msg = _getMalformedExceptionMsg(dest);
+        PEG_METHOD_EXIT();
+    }
 
-                    PEG_TRACE((TRC_DISCARDED_DATA,Tracer::LEVEL1,"%s%s",
-                        (const char*)msg.getCString(),
-                        (const char*)dest.getCString()));
+private:
 
-                PEG_METHOD_EXIT();
-                throw PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED, msg);
-            }
+    typedef HashTable<String, IndicationDeliveryQueue*,
+        EqualFunc<String>, HashFunc<String> > QueueTable;
 
-            String doubleSlash = dest.subString(colon + 1, 2);
+    /**
+        Parses the Destination property value
+        ("http" ["s"] ":" "//" hostname [":" portnumber] ["/" pathSegment]).
 
-            if (String::equalNoCase(doubleSlash, "//"))
+        @exception CIMException if the destination is not valid or is an
+            https destination and SSL is not available
+    */
+    void _parseDestination(
+        const String& dest,
+        ExportDestination& destination)
+    {
+        Uint32 colon = dest.find (":");
+        Uint32 portNumber = 0;
+        Boolean useHttps = false;
+        String destStr = dest;
+
+        //
+        // If the URL has https (https://hostname:port/... or
+        // https://hostname/...) then use SSL for Indication delivery.
+        // If it has http (http://hostname:port/...
+        // or http://hostname/...) then do not use SSL.
+        //
+        if (colon != PEG_NOT_FOUND)
+        {
+            String httpStr = dest.subString(0, colon);
+            if (String::equalNoCase(httpStr, "https"))
+            {
+                useHttps = true;
+            }
+            else if (String::equalNoCase(httpStr, "http"))
             {
-                destStr = dest.subString(colon + 3, PEG_NOT_FOUND);
+                useHttps = false;
             }
             else
             {
-                String msg = _getMalformedExceptionMsg(dest);
+                _throwMalformedDestination(dest);
+            }
+        }
+        else
+        {
+            _throwMalformedDestination(dest);
+        }
 
-                PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,"%s%s",
-                    (const char*)msg.getCString(),
-                    (const char*)dest.getCString()));
+        String doubleSlash = dest.subString(colon + 1, 2);
 
-                PEG_METHOD_EXIT();
-                throw PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED, msg);
-            }
+        if (String::equalNoCase(doubleSlash, "//"))
+        {
+            destStr = dest.subString(colon + 3, PEG_NOT_FOUND);
+        }
+        else
+        {
+            _throwMalformedDestination(dest);
+        }
 
-            HostLocator addr(destStr.subString(0, destStr.find("/")));
-            char hostName[PEGASUS_MAXHOSTNAMELEN];
-            if (addr.isValid())
+        HostLocator addr(destStr.subString(0, destStr.find("/")));
+        if (addr.isValid())
+        {
+            if (addr.isPortSpecified())
+            {
+                portNumber = addr.getPort();
+            }
+            else if (useHttps)
             {
-                strcpy(hostName, addr.getHost().getCString());
-                if (addr.isPortSpecified())
-                {
-                    portNumber = addr.getPort();
-                }
-                else if (useHttps)
-                {
-                     portNumber = System::lookupPort(WBEM_HTTPS_SERVICE_NAME,
-                        WBEM_DEFAULT_HTTPS_PORT);
-                }
-                else
-                {
-                    portNumber = System::lookupPort(WBEM_HTTP_SERVICE_NAME,
-                        WBEM_DEFAULT_HTTP_PORT);
-                }
+                 portNumber = System::lookupPort(WBEM_HTTPS_SERVICE_NAME,
+                    WBEM_DEFAULT_HTTPS_PORT);
             }
             else
             {
-                String msg = _getMalformedExceptionMsg(dest);
+                portNumber = System::lookupPort(WBEM_HTTP_SERVICE_NAME,
+                    WBEM_DEFAULT_HTTP_PORT);
+            }
+        }
+        else
+        {
+            _throwMalformedDestination(dest);
+        }
 
-                PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,"%s%s",
-                    (const char*)msg.getCString(),
-                    (const char*)dest.getCString()));
+#if !defined(PEGASUS_OS_ZOS) && !defined(PEGASUS_HAS_SSL)
+        if (useHttps)
+        {
+            PEG_TRACE((
+                TRC_DISCARDED_DATA, Tracer::LEVEL1,
+                "CIMxmlIndicationHandler::handleIndication failed to "
+                "deliver indication: "
+                "https not supported "
+                "in Destination %s",
+                (const char*) dest.getCString()));
 
-                PEG_METHOD_EXIT();
-                throw PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED, msg);
-            }
+            MessageLoaderParms param(
+                "Handler.CIMxmlIndicationHandler.CIMxmlIndicationHandler."
+                    "CANNOT_DO_HTTPS_CONNECTION",
+                "SSL is not available. "
+                    "Cannot support an HTTPS connection.");
 
-#ifndef PEGASUS_OS_ZOS
+            throw PEGASUS_CIM_EXCEPTION(
+                CIM_ERR_FAILED,
+                MessageLoader::getMessage(param));
+        }
+#endif
 
-            if (useHttps)
-            {
-#ifdef PEGASUS_HAS_SSL
-                PEG_TRACE_CSTRING(TRC_IND_HANDLER, Tracer::LEVEL4,
-                    "Build SSL Context...");
-
-                SSLContext sslcontext(trustPath,
-                    certPath, keyPath, verifyListenerCertificate, randFile);
-                exportclient.connect (hostName, portNumber, sslcontext);
-#else
-                PEG_TRACE((
-                    TRC_DISCARDED_DATA, Tracer::LEVEL1,
-                    "CIMxmlIndicationHandler::handleIndication failed to "
-                    "deliver indication: "
-                    "https not supported "
-                    "in Destination %s",
-                    (const char*) dest.getCString()));
+        destination.destination = dest;
+        destination.host = addr.getHost();
+        destination.portNumber = portNumber;
+        destination.useHttps = useHttps;
 
-                MessageLoaderParms param(
-                    "Handler.CIMxmlIndicationHandler.CIMxmlIndicationHandler."
-                        "CANNOT_DO_HTTPS_CONNECTION",
-                    "SSL is not available. "
-                        "Cannot support an HTTPS connection.");
+        // check destStr, if no path is specified, use "/" for the URI
+        Uint32 slash = destStr.find ("/");
+        if (slash != PEG_NOT_FOUND)
+        {
+            destination.uri = destStr.subString(slash);
+        }
+        else
+        {
+            destination.uri = "/";
+        }
+    }
 
-                PEG_METHOD_EXIT();
-                throw PEGASUS_CIM_EXCEPTION(
-                    CIM_ERR_FAILED,
-                    MessageLoader::getMessage(param));
-#endif
-            }
-            else
-            {
-                exportclient.connect (hostName, portNumber);
-            }
-#else
-            // On zOS the ATTLS facility is using the port number(s) defined
-            // of the outbound policy to decide if the indication is
-            // delivered through a SSL secured socket. This is totally
-            // transparent to the CIM Server.
-            exportclient.connect (hostName, portNumber);
+    /**
+        Returns the delivery queue of the specified destination, creating
+        it if necessary.  Queues that have been idle for
+        PEGASUS_CIMXML_INDICATION_QUEUE_IDLE_SECONDS are removed.
+    */
+    IndicationDeliveryQueue* _getDeliveryQueue(
+        const ExportDestination& destination)
+    {
+        AutoMutex autoMut(_queuesMutex);
 
-#endif
-            // check destStr, if no path is specified, use "/" for the URI
-            Uint32 slash = destStr.find ("/");
-            if (slash != PEG_NOT_FOUND)
-            {
-                exportclient.exportIndication(
-                    destStr.subString(slash), indicationInstance,
-                    contentLanguages);
-            }
-            else
-            {
-                exportclient.exportIndication(
-                    "/", indicationInstance, contentLanguages);
-            }
+        Uint32 seconds;
+        Uint32 milliseconds;
+        System::getCurrentTime(seconds, milliseconds);
 
+        if (seconds - _lastIdleCheck >=
+                PEGASUS_CIMXML_INDICATION_IDLE_CHECK_SECONDS)
+        {
+            _lastIdleCheck = seconds;
+            _removeIdleQueues(destination.destination);
         }
-        catch(Exception& e)
+
+        IndicationDeliveryQueue* queue;
+        if (!_queues.lookup(destination.destination, queue))
         {
-            //ATTN: Catch specific exceptions and log the error message
-            // as Indication delivery failed.
-            String msg = e.getMessage();
+            queue = new IndicationDeliveryQueue(destination, _options);
+            _queues.insert(destination.destination, queue);
 
-            PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
-                "CIMxmlIndicationHandler::handleIndication failed to deliver "
-                "indication due to Exception: %s",
-                (const char*)e.getMessage().getCString()));
+            PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL3,
+                "Created indication delivery queue for destination %s",
+                (const char*)destination.destination.getCString()));
+        }
 
-            PEG_METHOD_EXIT();
-            throw PEGASUS_CIM_EXCEPTION(CIM_ERR_FAILED, msg);
+        return queue;
+    }
+
+    /**
+        Removes the delivery queues which have been idle for
+        PEGASUS_CIMXML_INDICATION_QUEUE_IDLE_SECONDS, except the one of the
+        specified destination.  _queuesMutex must be locked by the caller.
+    */
+    void _removeIdleQueues(const String& keepDestination)
+    {
+        Array<String> idleDestinations;
+
+        for (QueueTable::Iterator i = _queues.start(); i; i++)
+        {
+            if (i.key() != keepDestination &&
+                i.value()->isIdle(PEGASUS_CIMXML_INDICATION_QUEUE_IDLE_SECONDS))
+            {
+                idleDestinations.append(i.key());
+            }
         }
 
-        PEG_METHOD_EXIT();
+        for (Uint32 i = 0; i < idleDestinations.size(); i++)
+        {
+            IndicationDeliveryQueue* queue;
+            _queues.lookup(idleDestinations[i], queue);
+            _queues.remove(idleDestinations[i]);
+            delete queue;
+
+            PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL3,
+                "Removed idle indication delivery queue for destination %s",
+                (const char*)idleDestinations[i].getCString()));
+        }
+    }
+
+    static Uint32 _getUint32ConfigValue(const char* propertyName)
+    {
+        String value =
+            ConfigManager::getInstance()->getCurrentValue(propertyName);
+        Uint64 v = 0;
+        StringConversion::decimalStringToUint64(value.getCString(), v);
+        return Uint32(v);
+    }
+
+    void _throwMalformedDestination(const String& dest)
+    {
+        String msg = _getMalformedExceptionMsg(dest);
+
+        PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,"%s%s",
+            (const char*)msg.getCString(),
+            (const char*)dest.getCString()));
+
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_FAILED, msg);
     }
 
-private:
     String _getMalformedExceptionMsg(
         String destinationValue)
     {
@@ -372,6 +472,12 @@ private:
         return (String(MessageLoader::getMessage(param)));
     }
 
+    IndicationDeliveryOptions _options;
+
+    /** Delivery queues keyed by Destination property value */
+    QueueTable _queues;
+    Mutex _queuesMutex;
+    Uint32 _lastIdleCheck;
 };
 
 PEGASUS_NAMESPACE_END
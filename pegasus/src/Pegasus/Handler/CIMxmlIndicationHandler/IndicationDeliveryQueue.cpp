@@ -0,0 +1,840 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/Constants.h>
+#include <Pegasus/Common/InternalException.h>
+#include <Pegasus/Common/SSLContext.h>
+#include <Pegasus/Common/TimeValue.h>
+#include <Pegasus/Common/Tracer.h>
+#include <Pegasus/Config/ConfigManager.h>
+#include <Pegasus/Client/CIMClientException.h>
+
+#include "IndicationDeliveryQueue.h"
+
+PEGASUS_USING_STD;
+
+PEGASUS_NAMESPACE_BEGIN
+
+/**
+    A delivery thread closes its connection after this many seconds without
+    an indication to deliver.
+*/
+#define PEGASUS_CIMXML_INDICATION_CONNECTION_IDLE_SECONDS 30
+
+/**
+    Upper bound for the interval between two delivery attempts.
+*/
+#define PEGASUS_CIMXML_INDICATION_MAX_RETRY_INTERVAL_SECONDS 300
+
+/**
+    The statistics of a destination are traced each time this many
+    indications have been delivered to it.
+*/
+#define PEGASUS_CIMXML_INDICATION_STATISTICS_INTERVAL 1000
+
+static Boolean verifyListenerCertificate(SSLCertificateInfo& certInfo)
+{
+    // ATTN: Add code to handle listener certificate verification.
+    //
+    return true;
+}
+
+static Uint64 _getCurrentTimeUsec()
+{
+    return TimeValue::getCurrentTime().toMicroseconds();
+}
+
+/**
+    Returns true if the exception is a connection or transport error, after
+    which the connection is not usable and the request may be retried.  The
+    other exceptions are answers of the listener, such as a rejected
+    indication, which a retry would not change.
+*/
+static Boolean _isTransportError(const Exception& e)
+{
+    return dynamic_cast<const CannotConnectException*>(&e) ||
+        dynamic_cast<const CannotCreateSocketException*>(&e) ||
+        dynamic_cast<const ConnectionTimeoutException*>(&e) ||
+        dynamic_cast<const NotConnectedException*>(&e) ||
+        dynamic_cast<const SocketWriteError*>(&e) ||
+        dynamic_cast<const SSLException*>(&e) ||
+        dynamic_cast<const CIMClientMalformedHTTPException*>(&e);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// IndicationExportConnection
+//
+////////////////////////////////////////////////////////////////////////////////
+
+IndicationExportConnection::IndicationExportConnection(
+    const ExportDestination& destination)
+    : _destination(destination),
+      _httpConnector(&_monitor),
+      _exportClient(&_monitor, &_httpConnector),
+      _connected(false)
+{
+}
+
+IndicationExportConnection::~IndicationExportConnection()
+{
+    disconnect();
+}
+
+void IndicationExportConnection::_connect()
+{
+    PEG_METHOD_ENTER(TRC_IND_HANDLER, "IndicationExportConnection::_connect");
+
+    PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL4,
+        "Connecting to CIM-XML listener destination %s",
+        (const char*)_destination.destination.getCString()));
+
+#if !defined(PEGASUS_OS_ZOS) && defined(PEGASUS_HAS_SSL)
+    if (_destination.useHttps)
+    {
+        static String PROPERTY_NAME__SSLCERT_FILEPATH =
+            "sslCertificateFilePath";
+        static String PROPERTY_NAME__SSLKEY_FILEPATH  = "sslKeyFilePath";
+
+        ConfigManager* configManager = ConfigManager::getInstance();
+
+        String certPath = ConfigManager::getHomedPath(
+            configManager->getCurrentValue(PROPERTY_NAME__SSLCERT_FILEPATH));
+        String keyPath = ConfigManager::getHomedPath(
+            configManager->getCurrentValue(PROPERTY_NAME__SSLKEY_FILEPATH));
+        String trustPath;
+        String randFile;
+
+# ifdef PEGASUS_SSL_RANDOMFILE
+        randFile = ConfigManager::getHomedPath(PEGASUS_SSLSERVER_RANDOMFILE);
+# endif
+
+        PEG_TRACE_CSTRING(TRC_IND_HANDLER, Tracer::LEVEL4,
+            "Build SSL Context...");
+
+        SSLContext sslcontext(trustPath,
+            certPath, keyPath, verifyListenerCertificate, randFile);
+        _exportClient.connect(
+            _destination.host, _destination.portNumber, sslcontext);
+    }
+    else
+#endif
+    {
+        // On zOS the ATTLS facility is using the port number(s) defined
+        // of the outbound policy to decide if the indication is
+        // delivered through a SSL secured socket. This is totally
+        // transparent to the CIM Server.  Without SSL support, https
+        // destinations are rejected before they get here.
+        _exportClient.connect(_destination.host, _destination.portNumber);
+    }
+
+    _connected = true;
+
+    PEG_METHOD_EXIT();
+}
+
+void IndicationExportConnection::disconnect()
+{
+    if (_connected)
+    {
+        _exportClient.disconnect();
+        _connected = false;
+    }
+}
+
+void IndicationExportConnection::exportIndication(
+    const CIMInstance& indication,
+    const ContentLanguageList& contentLanguages)
+{
+    try
+    {
+        if (!_connected)
+        {
+            _connect();
+        }
+
+        _exportClient.exportIndication(
+            _destination.uri, indication, contentLanguages);
+    }
+    catch (Exception& e)
+    {
+        if (_isTransportError(e))
+        {
+            disconnect();
+        }
+        throw;
+    }
+    catch (...)
+    {
+        disconnect();
+        throw;
+    }
+}
+
+void IndicationExportConnection::exportIndications(
+    const Array<CIMInstance>& indications,
+    const Array<ContentLanguageList>& contentLanguages,
+    Array<CIMException>& results)
+{
+    try
+    {
+        if (!_connected)
+        {
+            _connect();
+        }
+
+        _exportClient.exportIndications(
+            _destination.uri, indications, contentLanguages, results);
+    }
+    catch (Exception& e)
+    {
+        if (_isTransportError(e))
+        {
+            disconnect();
+        }
+        throw;
+    }
+    catch (...)
+    {
+        disconnect();
+        throw;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// IndicationDeliveryQueue
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct IndicationDeliveryQueue::QueuedIndication : public Linkable
+{
+    QueuedIndication(
+        const CIMInstance& indication_,
+        const ContentLanguageList& contentLanguages_,
+        Uint64 queueTimeUsec_)
+        : indication(indication_),
+          contentLanguages(contentLanguages_),
+          queueTimeUsec(queueTimeUsec_)
+    {
+    }
+
+    CIMInstance indication;
+    ContentLanguageList contentLanguages;
+    Uint64 queueTimeUsec;
+};
+
+IndicationDeliveryQueue::IndicationDeliveryQueue(
+    const ExportDestination& destination,
+    const IndicationDeliveryOptions& options)
+    : _destination(destination),
+      _options(options),
+      _idleThreads(0),
+      _inProgress(0),
+      _lastQueueTime(_getCurrentTimeUsec()),
+      _available(0),
+      _stop(0)
+{
+}
+
+IndicationDeliveryQueue::~IndicationDeliveryQueue()
+{
+    stop();
+}
+
+Boolean IndicationDeliveryQueue::enqueue(
+    const CIMInstance& indication,
+    const ContentLanguageList& contentLanguages)
+{
+    AutoMutex autoMut(_mutex);
+
+    if (_stop.get())
+    {
+        return false;
+    }
+
+    if (_queue.size() >= _options.maxQueueSize)
+    {
+        _statistics.discarded++;
+        return false;
+    }
+
+    _lastQueueTime = _getCurrentTimeUsec();
+    _queue.insert_back(
+        new QueuedIndication(indication, contentLanguages, _lastQueueTime));
+
+    //
+    // Start another delivery thread if all threads are busy.  If no thread
+    // could be started at all, the indication cannot be delivered.
+    //
+    if (_idleThreads == 0 && _threads.size() < _options.deliveryThreads &&
+        !_startThread() && _threads.size() == 0)
+    {
+        delete _queue.remove_back();
+        _statistics.discarded++;
+        return false;
+    }
+
+    _statistics.queued++;
+    _statistics.queueDepth = _queue.size();
+    if (_statistics.queueDepth > _statistics.maxQueueDepth)
+    {
+        _statistics.maxQueueDepth = _statistics.queueDepth;
+    }
+
+    _available.signal();
+
+    return true;
+}
+
+Boolean IndicationDeliveryQueue::_startThread()
+{
+    AutoPtr<Thread> thread(new Thread(_deliveryThread, this, false));
+
+    if (thread->run() != PEGASUS_THREAD_OK)
+    {
+        PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL1,
+            "Failed to start an indication delivery thread for destination "
+                "%s",
+            (const char*)_destination.destination.getCString()));
+        return false;
+    }
+
+    _threads.append(thread.release());
+    _idleThreads++;
+
+    PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL4,
+        "Started indication delivery thread %u for destination %s",
+        _threads.size(),
+        (const char*)_destination.destination.getCString()));
+
+    return true;
+}
+
+void IndicationDeliveryQueue::stop()
+{
+    PEG_METHOD_ENTER(TRC_IND_HANDLER, "IndicationDeliveryQueue::stop");
+
+    Array<Thread*> threads;
+    {
+        AutoMutex autoMut(_mutex);
+
+        if (_stop.get())
+        {
+            PEG_METHOD_EXIT();
+            return;
+        }
+
+        _stop = 1;
+        threads = _threads;
+        _threads.clear();
+    }
+
+    // Each thread passes the signal on to the next one when it stops
+    _available.signal();
+
+    for (Uint32 i = 0; i < threads.size(); i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    {
+        AutoMutex autoMut(_mutex);
+
+        if (_queue.size())
+        {
+            PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+                "Discarding %u queued indications for destination %s",
+                _queue.size(),
+                (const char*)_destination.destination.getCString()));
+
+            _statistics.discarded += _queue.size();
+            _queue.clear();
+            _statistics.queueDepth = 0;
+        }
+    }
+
+    traceStatistics();
+
+    PEG_METHOD_EXIT();
+}
+
+Boolean IndicationDeliveryQueue::isIdle(Uint32 seconds)
+{
+    AutoMutex autoMut(_mutex);
+
+    return (_queue.size() == 0) && (_inProgress == 0) &&
+        (_getCurrentTimeUsec() - _lastQueueTime >=
+            Uint64(seconds) * Uint64(1000000));
+}
+
+void IndicationDeliveryQueue::getStatistics(
+    IndicationDeliveryStatistics& statistics)
+{
+    AutoMutex autoMut(_mutex);
+    statistics = _statistics;
+}
+
+void IndicationDeliveryQueue::traceStatistics()
+{
+    IndicationDeliveryStatistics statistics;
+    getStatistics(statistics);
+
+    Uint64 averageLatencyUsec = 0;
+    if (statistics.delivered + statistics.failed)
+    {
+        averageLatencyUsec = statistics.totalLatencyUsec /
+            (statistics.delivered + statistics.failed);
+    }
+
+    PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL3,
+        "Indication delivery statistics for destination %s: "
+            "queued %" PEGASUS_64BIT_CONVERSION_WIDTH "u, "
+            "delivered %" PEGASUS_64BIT_CONVERSION_WIDTH "u, "
+            "failed %" PEGASUS_64BIT_CONVERSION_WIDTH "u, "
+            "discarded %" PEGASUS_64BIT_CONVERSION_WIDTH "u, "
+            "retries %" PEGASUS_64BIT_CONVERSION_WIDTH "u, "
+            "queue depth %u (max %u), "
+            "latency average %" PEGASUS_64BIT_CONVERSION_WIDTH "u usec "
+            "(max %" PEGASUS_64BIT_CONVERSION_WIDTH "u usec)",
+        (const char*)_destination.destination.getCString(),
+        statistics.queued,
+        statistics.delivered,
+        statistics.failed,
+        statistics.discarded,
+        statistics.retries,
+        statistics.queueDepth,
+        statistics.maxQueueDepth,
+        averageLatencyUsec,
+        statistics.maxLatencyUsec));
+}
+
+void IndicationDeliveryQueue::deliver(
+    IndicationExportConnection& connection,
+    const IndicationDeliveryOptions& options,
+    const CIMInstance& indication,
+    const ContentLanguageList& contentLanguages,
+    AtomicInt* stop,
+    Uint32& retries)
+{
+    retries = 0;
+    Uint32 retryInterval = options.retryInterval;
+    Boolean reusedConnection = connection.isConnected();
+
+    for (;;)
+    {
+        try
+        {
+            connection.exportIndication(indication, contentLanguages);
+            return;
+        }
+        catch (Exception& e)
+        {
+            // A rejected indication is reported at once
+            if (!_isTransportError(e))
+            {
+                throw;
+            }
+
+            if (reusedConnection)
+            {
+                //
+                // The listener may have closed the connection while it was
+                // idle.  Try once more on a new connection before counting
+                // this as a failed attempt.
+                //
+                PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL3,
+                    "Indication delivery to %s failed on a kept-alive "
+                        "connection, reconnecting: %s",
+                    (const char*)connection.getDestination().getCString(),
+                    (const char*)e.getMessage().getCString()));
+                reusedConnection = false;
+                continue;
+            }
+
+            if (retries >= options.retryAttempts || (stop && stop->get()))
+            {
+                throw;
+            }
+
+            PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL2,
+                "Indication delivery to %s failed, retry %u of %u in %u "
+                    "seconds: %s",
+                (const char*)connection.getDestination().getCString(),
+                retries + 1,
+                options.retryAttempts,
+                retryInterval,
+                (const char*)e.getMessage().getCString()));
+
+            // Wait for the retry interval, unless stopped meanwhile
+            for (Uint32 i = 0; i < retryInterval * 10; i++)
+            {
+                if (stop && stop->get())
+                {
+                    throw;
+                }
+                Threads::sleep(100);
+            }
+
+            retries++;
+            retryInterval *= 2;
+            if (retryInterval >
+                    PEGASUS_CIMXML_INDICATION_MAX_RETRY_INTERVAL_SECONDS)
+            {
+                retryInterval =
+                    PEGASUS_CIMXML_INDICATION_MAX_RETRY_INTERVAL_SECONDS;
+            }
+        }
+    }
+}
+
+ThreadReturnType PEGASUS_THREAD_CDECL IndicationDeliveryQueue::_deliveryThread(
+    void* parm)
+{
+    Thread* myself = reinterpret_cast<Thread*>(parm);
+    IndicationDeliveryQueue* queue =
+        reinterpret_cast<IndicationDeliveryQueue*>(myself->get_parm());
+
+    try
+    {
+        queue->_deliverIndications();
+    }
+    catch (Exception& e)
+    {
+        PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL1,
+            "Exception caught in IndicationDeliveryQueue::_deliveryThread: "
+                "%s",
+            (const char*)e.getMessage().getCString()));
+    }
+    catch (...)
+    {
+        PEG_TRACE_CSTRING(TRC_IND_HANDLER, Tracer::LEVEL1,
+            "Unknown exception caught in "
+                "IndicationDeliveryQueue::_deliveryThread");
+    }
+
+    return 0;
+}
+
+void IndicationDeliveryQueue::_deliverIndications()
+{
+    PEG_METHOD_ENTER(TRC_IND_HANDLER,
+        "IndicationDeliveryQueue::_deliverIndications");
+
+    IndicationExportConnection connection(_destination);
+    Array<QueuedIndication*> batch;
+
+    for (;;)
+    {
+        if (!_available.time_wait(
+                PEGASUS_CIMXML_INDICATION_CONNECTION_IDLE_SECONDS * 1000))
+        {
+            if (connection.isConnected())
+            {
+                PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL4,
+                    "Closing idle connection to destination %s",
+                    (const char*)_destination.destination.getCString()));
+                connection.disconnect();
+            }
+            continue;
+        }
+
+        if (_stop.get())
+        {
+            _available.signal();
+            break;
+        }
+
+        {
+            AutoMutex autoMut(_mutex);
+
+            QueuedIndication* queued;
+            while (batch.size() < _options.batchSize &&
+                (queued = _queue.remove_front()) != 0)
+            {
+                batch.append(queued);
+            }
+
+            if (batch.size() == 0)
+            {
+                continue;
+            }
+
+            _statistics.queueDepth = _queue.size();
+            _idleThreads--;
+            _inProgress += batch.size();
+        }
+
+        Boolean traceStatisticsNow = false;
+
+        for (Uint32 i = 0; i < batch.size(); i++)
+        {
+            if (_stop.get())
+            {
+                // Discard the rest of the batch, as stop() does for the
+                // indications still queued
+                AutoMutex autoMut(_mutex);
+                _statistics.discarded += batch.size() - i;
+                _inProgress -= batch.size() - i;
+                for (; i < batch.size(); i++)
+                {
+                    delete batch[i];
+                }
+                break;
+            }
+
+            //
+            // Once the listener is known to accept batches, the rest of the
+            // batch is sent in a single request.
+            //
+            if (batch.size() - i > 1 && connection.isBinaryExport())
+            {
+                _deliverBatch(connection, batch, i, traceStatisticsNow);
+                break;
+            }
+
+            Boolean delivered = false;
+            Uint32 retries = 0;
+
+            try
+            {
+                deliver(connection, _options, batch[i]->indication,
+                    batch[i]->contentLanguages, &_stop, retries);
+                delivered = true;
+            }
+            catch (Exception& e)
+            {
+                PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+                    "CIMxmlIndicationHandler failed to deliver indication to "
+                        "%s after %u retries: %s",
+                    (const char*)_destination.destination.getCString(),
+                    retries,
+                    (const char*)e.getMessage().getCString()));
+            }
+            catch (...)
+            {
+                PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+                    "CIMxmlIndicationHandler failed to deliver indication to "
+                        "%s: unknown exception",
+                    (const char*)_destination.destination.getCString()));
+            }
+
+            _completeDelivery(batch[i], delivered, retries, traceStatisticsNow);
+        }
+
+        batch.clear();
+
+        {
+            AutoMutex autoMut(_mutex);
+            _idleThreads++;
+        }
+
+        if (traceStatisticsNow)
+        {
+            traceStatistics();
+        }
+    }
+
+    PEG_METHOD_EXIT();
+}
+
+void IndicationDeliveryQueue::_deliverBatch(
+    IndicationExportConnection& connection,
+    Array<QueuedIndication*>& batch,
+    Uint32 first,
+    Boolean& traceStatisticsNow)
+{
+    Uint32 retries = 0;
+    Uint32 retryInterval = _options.retryInterval;
+    Boolean reusedConnection = connection.isConnected();
+
+    // batch[next, size) holds the indications without a result yet
+    Uint32 next = first;
+
+    while (next < batch.size())
+    {
+        Array<CIMInstance> indications;
+        Array<ContentLanguageList> contentLanguages;
+        Array<CIMException> results;
+
+        for (Uint32 i = next; i < batch.size(); i++)
+        {
+            indications.append(batch[i]->indication);
+            contentLanguages.append(batch[i]->contentLanguages);
+        }
+
+        Boolean failed = false;
+        Boolean transportError = false;
+        String failure;
+
+        try
+        {
+            connection.exportIndications(
+                indications, contentLanguages, results);
+        }
+        catch (Exception& e)
+        {
+            failed = true;
+            transportError = _isTransportError(e);
+            failure = e.getMessage();
+        }
+
+        PEGASUS_DEBUG_ASSERT(failed || results.size() == indications.size());
+
+        // The results are those of the indications sent before a failure.
+        // An indication the listener rejects fails at once, as in deliver().
+        for (Uint32 i = 0; i < results.size(); i++, next++)
+        {
+            Boolean delivered = results[i].getCode() == CIM_ERR_SUCCESS;
+
+            if (!delivered)
+            {
+                PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+                    "CIMxmlIndicationHandler: indication rejected by %s: %s",
+                    (const char*)_destination.destination.getCString(),
+                    (const char*)results[i].getMessage().getCString()));
+            }
+
+            _completeDelivery(batch[next], delivered, 0, traceStatisticsNow);
+        }
+
+        if (!failed)
+        {
+            break;
+        }
+
+        //
+        // The listener may have received the rest of the batch before the
+        // request failed.  It is retried as a unit, as deliver() does for a
+        // single indication; sending it one at a time after a failed batch
+        // would deliver it twice.
+        //
+        if (transportError && reusedConnection)
+        {
+            PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL3,
+                "Delivery of %u indications to %s failed on a kept-alive "
+                    "connection, reconnecting: %s",
+                batch.size() - next,
+                (const char*)_destination.destination.getCString(),
+                (const char*)failure.getCString()));
+            reusedConnection = false;
+            continue;
+        }
+
+        if (transportError && retries < _options.retryAttempts &&
+            !_stop.get())
+        {
+            PEG_TRACE((TRC_IND_HANDLER, Tracer::LEVEL2,
+                "Delivery of %u indications to %s failed, retry %u of %u in "
+                    "%u seconds: %s",
+                batch.size() - next,
+                (const char*)_destination.destination.getCString(),
+                retries + 1,
+                _options.retryAttempts,
+                retryInterval,
+                (const char*)failure.getCString()));
+
+            // Wait for the retry interval, unless stopped meanwhile
+            for (Uint32 i = 0; i < retryInterval * 10 && !_stop.get(); i++)
+            {
+                Threads::sleep(100);
+            }
+
+            if (!_stop.get())
+            {
+                retries++;
+                retryInterval *= 2;
+                if (retryInterval >
+                        PEGASUS_CIMXML_INDICATION_MAX_RETRY_INTERVAL_SECONDS)
+                {
+                    retryInterval =
+                        PEGASUS_CIMXML_INDICATION_MAX_RETRY_INTERVAL_SECONDS;
+                }
+                continue;
+            }
+        }
+
+        PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+            "CIMxmlIndicationHandler failed to deliver %u indications to "
+                "%s after %u retries: %s",
+            batch.size() - next,
+            (const char*)_destination.destination.getCString(),
+            retries,
+            (const char*)failure.getCString()));
+
+        for (; next < batch.size(); next++)
+        {
+            _completeDelivery(batch[next], false, 0, traceStatisticsNow);
+        }
+    }
+
+    // A retried request counts once, however many indications it carries
+    if (retries)
+    {
+        AutoMutex autoMut(_mutex);
+        _statistics.retries += retries;
+    }
+}
+
+void IndicationDeliveryQueue::_completeDelivery(
+    QueuedIndication* queued,
+    Boolean delivered,
+    Uint32 retries,
+    Boolean& traceStatisticsNow)
+{
+    Uint64 latencyUsec = _getCurrentTimeUsec() - queued->queueTimeUsec;
+    delete queued;
+
+    AutoMutex autoMut(_mutex);
+
+    if (delivered)
+    {
+        _statistics.delivered++;
+        traceStatisticsNow = traceStatisticsNow ||
+            (_statistics.delivered %
+                PEGASUS_CIMXML_INDICATION_STATISTICS_INTERVAL == 0);
+    }
+    else
+    {
+        _statistics.failed++;
+    }
+    _statistics.retries += retries;
+    _statistics.totalLatencyUsec += latencyUsec;
+    if (latencyUsec > _statistics.maxLatencyUsec)
+    {
+        _statistics.maxLatencyUsec = latencyUsec;
+    }
+    _inProgress--;
+}
+
+PEGASUS_NAMESPACE_END
@@ -0,0 +1,346 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#ifndef Pegasus_IndicationDeliveryQueue_h
+#define Pegasus_IndicationDeliveryQueue_h
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/String.h>
+#include <Pegasus/Common/CIMInstance.h>
+#include <Pegasus/Common/ContentLanguageList.h>
+#include <Pegasus/Common/Monitor.h>
+#include <Pegasus/Common/HTTPConnector.h>
+#include <Pegasus/Common/List.h>
+#include <Pegasus/Common/Mutex.h>
+#include <Pegasus/Common/Semaphore.h>
+#include <Pegasus/Common/AtomicInt.h>
+#include <Pegasus/Common/Thread.h>
+#include <Pegasus/ExportClient/CIMExportClient.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+/**
+    Describes a CIM-XML listener destination, as parsed from the Destination
+    property of a CIM_ListenerDestinationCIMXML instance.
+*/
+struct ExportDestination
+{
+    ExportDestination() : portNumber(0), useHttps(false)
+    {
+    }
+
+    /** The Destination property value */
+    String destination;
+    String host;
+    Uint32 portNumber;
+    Boolean useHttps;
+    /** The request URI, "/" if the destination specifies no path */
+    String uri;
+};
+
+/**
+    Delivery settings, read from the cimxmlIndication* configuration
+    properties.
+*/
+struct IndicationDeliveryOptions
+{
+    IndicationDeliveryOptions()
+        : deliveryThreads(1),
+          batchSize(1),
+          retryAttempts(0),
+          retryInterval(0),
+          maxQueueSize(0)
+    {
+    }
+
+    /** Number of delivery threads (and connections) per destination;
+        0 selects synchronous delivery over a new connection. */
+    Uint32 deliveryThreads;
+
+    /** Maximum number of indications a delivery thread takes from the
+        queue at a time. */
+    Uint32 batchSize;
+
+    /** Number of times the delivery of an indication is retried. */
+    Uint32 retryAttempts;
+
+    /** Seconds before the first retry; doubled for every further retry. */
+    Uint32 retryInterval;
+
+    /** Maximum number of indications queued for a destination. */
+    Uint32 maxQueueSize;
+};
+
+/**
+    Queue and delivery statistics of a destination.  Latencies are measured
+    from the time an indication is queued until its delivery completes.
+*/
+struct IndicationDeliveryStatistics
+{
+    IndicationDeliveryStatistics()
+        : queued(0),
+          delivered(0),
+          failed(0),
+          discarded(0),
+          retries(0),
+          queueDepth(0),
+          maxQueueDepth(0),
+          totalLatencyUsec(0),
+          maxLatencyUsec(0)
+    {
+    }
+
+    Uint64 queued;
+    Uint64 delivered;
+    /** Indications not delivered after all retries */
+    Uint64 failed;
+    /** Indications rejected because the queue was full */
+    Uint64 discarded;
+    /** Delivery requests retried; a retried batch counts once */
+    Uint64 retries;
+    Uint32 queueDepth;
+    Uint32 maxQueueDepth;
+    Uint64 totalLatencyUsec;
+    Uint64 maxLatencyUsec;
+};
+
+/**
+    An export connection to a destination.  The connection is established
+    on first use and kept open (HTTP keep-alive) across indications, so
+    that the TCP connect and SSL handshake are not repeated for every
+    indication.
+*/
+class IndicationExportConnection
+{
+public:
+
+    IndicationExportConnection(const ExportDestination& destination);
+
+    ~IndicationExportConnection();
+
+    /**
+        Sends an indication, connecting first if necessary.
+
+        @exception Exception if the connection or the export request fails.
+            The connection is closed if the failure is a connection or
+            transport error, but not if the listener rejected the
+            indication.
+    */
+    void exportIndication(
+        const CIMInstance& indication,
+        const ContentLanguageList& contentLanguages);
+
+    /**
+        Sends several indications, in a single request if the listener
+        accepts batches (see CIMExportClient::exportIndications()).
+
+        @param results output, the result of each indication.
+        @exception Exception if the connection or a request fails.  The
+            connection is closed as by exportIndication().
+    */
+    void exportIndications(
+        const Array<CIMInstance>& indications,
+        const Array<ContentLanguageList>& contentLanguages,
+        Array<CIMException>& results);
+
+    Boolean isConnected() const
+    {
+        return _connected;
+    }
+
+    /**
+        Returns true if the listener on this connection accepts batches of
+        indications in the binary protocol.  A listener that does answers
+        the first indication sent on a connection in that protocol.
+    */
+    Boolean isBinaryExport() const
+    {
+        return _connected && _exportClient.isBinaryExport();
+    }
+
+    const String& getDestination() const
+    {
+        return _destination.destination;
+    }
+
+    void disconnect();
+
+private:
+
+    IndicationExportConnection(const IndicationExportConnection&);
+    IndicationExportConnection& operator=(const IndicationExportConnection&);
+
+    void _connect();
+
+    ExportDestination _destination;
+    Monitor _monitor;
+    HTTPConnector _httpConnector;
+    CIMExportClient _exportClient;
+    Boolean _connected;
+};
+
+/**
+    The IndicationDeliveryQueue queues the indications for one destination
+    and delivers them asynchronously on up to
+    IndicationDeliveryOptions::deliveryThreads threads, each with its own
+    persistent IndicationExportConnection.  Threads are started as
+    indications are queued and no thread is idle.  With a single delivery
+    thread indications are delivered in the order they were queued.
+
+    A delivery thread takes up to batchSize indications from the queue at
+    a time.  If the listener accepts batches of indications in the binary
+    protocol, they are sent in a single request.  If that request fails, the
+    indications without a result are retried as a unit, like a single
+    indication, since the listener may already have received them.
+
+    A delivery that fails with a connection or transport error is retried
+    up to retryAttempts times, the first time after retryInterval seconds
+    and then with the interval doubled for each further attempt.  A failure
+    on a connection that was reused is retried at once on a new connection,
+    since the listener may have closed the idle connection.  An indication
+    the listener rejects fails at once and the connection is kept.
+*/
+class IndicationDeliveryQueue
+{
+public:
+
+    IndicationDeliveryQueue(
+        const ExportDestination& destination,
+        const IndicationDeliveryOptions& options);
+
+    /**
+        Stops the delivery threads.  Indications still queued are discarded.
+    */
+    ~IndicationDeliveryQueue();
+
+    /**
+        Queues an indication for delivery.
+
+        @return false if the queue is full or the queue has been stopped;
+            the indication is not queued in that case.
+    */
+    Boolean enqueue(
+        const CIMInstance& indication,
+        const ContentLanguageList& contentLanguages);
+
+    /**
+        Stops the delivery threads, waiting for the deliveries in progress
+        to complete.  Indications still queued are discarded.
+    */
+    void stop();
+
+    /**
+        Returns true if no indication is queued or being delivered and
+        none has been queued for the specified number of seconds.
+    */
+    Boolean isIdle(Uint32 seconds);
+
+    void getStatistics(IndicationDeliveryStatistics& statistics);
+
+    /**
+        Writes the statistics to the trace at LEVEL3.
+    */
+    void traceStatistics();
+
+    /**
+        Delivers an indication on the specified connection, retrying as
+        specified by the options.  Only connection and transport errors are
+        retried; an indication the listener rejects fails at once.  The
+        stop flag, if not 0, is checked between attempts.
+
+        @param retries output, the number of retries made
+        @exception Exception the exception of the last attempt, if all
+            attempts failed.
+    */
+    static void deliver(
+        IndicationExportConnection& connection,
+        const IndicationDeliveryOptions& options,
+        const CIMInstance& indication,
+        const ContentLanguageList& contentLanguages,
+        AtomicInt* stop,
+        Uint32& retries);
+
+private:
+
+    IndicationDeliveryQueue(const IndicationDeliveryQueue&);
+    IndicationDeliveryQueue& operator=(const IndicationDeliveryQueue&);
+
+    struct QueuedIndication;
+
+    static ThreadReturnType PEGASUS_THREAD_CDECL _deliveryThread(void* parm);
+
+    void _deliverIndications();
+
+    /**
+        Sends the indications from batch[first] on in a single request,
+        retrying it as a unit like deliver() does a single indication, and
+        completes each of them.  The batch itself is left unchanged.
+    */
+    void _deliverBatch(
+        IndicationExportConnection& connection,
+        Array<QueuedIndication*>& batch,
+        Uint32 first,
+        Boolean& traceStatisticsNow);
+
+    /**
+        Updates the statistics for a delivered or failed indication and
+        deletes it.
+    */
+    void _completeDelivery(
+        QueuedIndication* queued,
+        Boolean delivered,
+        Uint32 retries,
+        Boolean& traceStatisticsNow);
+
+    Boolean _startThread();
+
+    ExportDestination _destination;
+    IndicationDeliveryOptions _options;
+
+    /** Protects all members below */
+    Mutex _mutex;
+    List<QueuedIndication, NullLock> _queue;
+    Array<Thread*> _threads;
+    /** Number of delivery threads waiting for indications */
+    Uint32 _idleThreads;
+    /** Number of indications being delivered */
+    Uint32 _inProgress;
+    Uint64 _lastQueueTime;
+    IndicationDeliveryStatistics _statistics;
+
+    /** Signalled once for every queued indication and on stop */
+    Semaphore _available;
+    AtomicInt _stop;
+};
+
+PEGASUS_NAMESPACE_END
+
+#endif /* Pegasus_IndicationDeliveryQueue_h */
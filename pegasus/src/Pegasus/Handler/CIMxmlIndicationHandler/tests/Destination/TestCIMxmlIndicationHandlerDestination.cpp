@@ -37,6 +37,8 @@
 #include <Pegasus/HandlerService/HandlerTable.h>
 #include <Pegasus/Repository/CIMRepository.h>
 #include <Pegasus/Config/ConfigManager.h>
+#include <Pegasus/Consumer/CIMIndicationConsumer.h>
+#include <Pegasus/Listener/CIMListener.h>
 
 PEGASUS_USING_PEGASUS;
 PEGASUS_USING_STD;
@@ -55,6 +57,59 @@ static CIMInstance CreateHandlerInstance()
     return (handlerInstance);
 }
 
+class TestConsumer : public CIMIndicationConsumer
+{
+public:
+
+    void consumeIndication(
+        const OperationContext& context,
+        const String& url,
+        const CIMInstance& indicationInstance)
+    {
+        Uint32 id = 0;
+        indicationInstance.getProperty(
+            indicationInstance.findProperty("Id")).getValue().get(id);
+
+        AutoMutex autoMut(_mutex);
+        _ids.append(id);
+    }
+
+    Uint32 getCount()
+    {
+        AutoMutex autoMut(_mutex);
+        return _ids.size();
+    }
+
+    Array<Uint32> getIds()
+    {
+        AutoMutex autoMut(_mutex);
+        return _ids;
+    }
+
+private:
+    Mutex _mutex;
+    Array<Uint32> _ids;
+};
+
+static void SendIndication(
+    CIMHandler* handler,
+    CIMInstance& indicationHandlerInstance,
+    Uint32 id)
+{
+    OperationContext context;
+    CIMInstance indicationInstance(CIMName("CIM_ProcessIndication"));
+    indicationInstance.addProperty(CIMProperty(CIMName("Id"), id));
+    CIMInstance indicationSubscriptionInstance;
+    ContentLanguageList contentLanguages;
+
+    handler->handleIndication(context,
+        PEGASUS_NAMESPACENAME_INTEROP.getString(),
+        indicationInstance,
+        indicationHandlerInstance,
+        indicationSubscriptionInstance,
+        contentLanguages);
+}
+
 static void TestDestination(
     CIMHandler* handler,
     CIMInstance indicationHandlerInstance,
@@ -156,11 +211,65 @@ static void TestDestinationExceptionHandling(CIMHandler* handler)
         CIMName("destination"), String("http://localhost:1234EEEE")));
     TestDestination(handler, indicationHandlerInstance, CIM_ERR_FAILED);
 
-    // Test "connection failure" exception
+    // A connection failure is not reported to the caller, since the
+    // indication is delivered asynchronously.  The delivery queue is stopped
+    // (and the indication discarded) when the handler is terminated.
     indicationHandlerInstance = CreateHandlerInstance();
     indicationHandlerInstance.addProperty(CIMProperty(
-        CIMName("destination"), String("http://localhost")));
-    TestDestination(handler, indicationHandlerInstance, CIM_ERR_FAILED);
+        CIMName("destination"), String("http://localhost:1")));
+    SendIndication(handler, indicationHandlerInstance, 0);
+}
+
+//
+// Delivers indications to a CIMListener, which accepts them in batches if
+// binaryProtocol is set.
+//
+static void TestDelivery(CIMHandler* handler, Boolean binaryProtocol)
+{
+    const Uint32 port = binaryProtocol ? 2018 : 2017;
+    const Uint32 count = 200;
+
+    TestConsumer consumer;
+    CIMListener listener(port);
+    listener.setRemoteBinaryProtocol(binaryProtocol);
+    listener.addConsumer(&consumer);
+    listener.start();
+
+    CIMInstance indicationHandlerInstance = CreateHandlerInstance();
+    char destination[64];
+    sprintf(destination, "http://localhost:%u/CIMListener/test", port);
+    indicationHandlerInstance.addProperty(CIMProperty(
+        CIMName("destination"), String(destination)));
+
+    for (Uint32 i = 0; i < count; i++)
+    {
+        SendIndication(handler, indicationHandlerInstance, i);
+    }
+
+    // Wait up to 30 seconds for the deliveries
+    for (Uint32 i = 0; i < 300 && consumer.getCount() < count; i++)
+    {
+        Threads::sleep(100);
+    }
+
+    // The listener dispatches indications to its consumers on multiple
+    // threads, so only check that each indication arrived exactly once
+    Array<Uint32> ids = consumer.getIds();
+    PEGASUS_TEST_ASSERT(ids.size() == count);
+
+    Array<Boolean> received;
+    for (Uint32 i = 0; i < count; i++)
+    {
+        received.append(false);
+    }
+    for (Uint32 i = 0; i < count; i++)
+    {
+        PEGASUS_TEST_ASSERT(ids[i] < count && !received[ids[i]]);
+        received[ids[i]] = true;
+    }
+
+    listener.removeConsumer(&consumer);
+    listener.stop();
 }
 
 
@@ -200,7 +309,7 @@ bool enableTrace=false;
         traceFile.append("/TestCIMxmlIndicationHandler.trc");
 
         Tracer::setTraceFile(traceFile.getCString());
-        Tracer::setTraceComponents("DiscardedData,IndHandler");
+        Tracer::setTraceComponents("DiscardedData,IndicationHandler");
         Tracer::setTraceLevel(Tracer::LEVEL4);
     }
 
@@ -212,6 +321,8 @@ bool enableTrace=false;
         PEGASUS_TEST_ASSERT(handler != 0);
 
         TestDestinationExceptionHandling(handler);
+        TestDelivery(handler, false);
+        TestDelivery(handler, true);
     }
     catch(Exception& e)
     {
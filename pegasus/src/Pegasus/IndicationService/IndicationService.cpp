@@ -2630,12 +2630,57 @@ void IndicationService::_handleDeleteInstanceRequest(const Message* message)
                     request->nameSpace, request->instanceName);
         }
 
+        //
+        //  If a filter, get the instance from the repository so that its
+        //  compiled query can be removed from the query expression cache
+        //
+        CIMInstance filterInstance;
+        if (request->instanceName.getClassName().equal(
+                PEGASUS_CLASSNAME_INDFILTER))
+        {
+            filterInstance = _subscriptionRepository->getInstance(
+                request->nameSpace, request->instanceName);
+        }
+
         //
         //  Delete instance from repository
         //
         _subscriptionRepository->deleteInstance(
             request->nameSpace, request->instanceName);
 
+        if (!filterInstance.isUninitialized())
+        {
+            String query;
+            String queryLanguage;
+            String sourceNameSpace = request->nameSpace.getString();
+
+            Uint32 pos = filterInstance.findProperty(
+                PEGASUS_PROPERTYNAME_QUERY);
+            if (pos != PEG_NOT_FOUND)
+            {
+                filterInstance.getProperty(pos).getValue().get(query);
+            }
+            pos = filterInstance.findProperty(
+                PEGASUS_PROPERTYNAME_QUERYLANGUAGE);
+            if (pos != PEG_NOT_FOUND)
+            {
+                filterInstance.getProperty(pos).getValue().get(queryLanguage);
+            }
+            pos = filterInstance.findProperty(_PROPERTY_SOURCENAMESPACE);
+            if (pos != PEG_NOT_FOUND)
+            {
+                String value;
+                filterInstance.getProperty(pos).getValue().get(value);
+                if (value.size())
+                {
+                    sourceNameSpace = value;
+                }
+            }
+
+            _queryExpressionCache.remove(
+                queryLanguage, query, CIMNamespaceName(sourceNameSpace));
+        }
+
         PEG_TRACE((
             TRC_INDICATION_SERVICE,
             Tracer::LEVEL3,
@@ -2819,7 +2864,7 @@ void IndicationService::_handleProcessIndicationRequest(Message* message)
         {
             try
             {
-                QueryExpression queryExpr;
+                SharedQueryExpressionPtr queryExpr;
                 String filterQuery;
                 String queryLanguage;
                 String filterName;
@@ -2845,7 +2890,7 @@ void IndicationService::_handleProcessIndicationRequest(Message* message)
                 //    indication
                 //
                 if (_subscriptionMatch (subscriptions[i], indication,
-                    supportedPropertyList, queryExpr, sourceNameSpace))
+                    supportedPropertyList, *queryExpr, sourceNameSpace))
                 {
                     PEG_TRACE ((TRC_INDICATION_GENERATION, Tracer::LEVEL4,
                         "%s Indication %s satisfies filter %s:%s query "
@@ -2871,7 +2916,7 @@ void IndicationService::_handleProcessIndicationRequest(Message* message)
                     CIMInstance formattedIndication = indication.clone();
 
                     if (_formatIndication(formattedIndication,
-                                          queryExpr,
+                                          *queryExpr,
                                           providerSupportedProperties,
                                           indicationClassProperties))
                     {
@@ -4195,11 +4240,12 @@ Boolean IndicationService::_canCreate (
                         query, sourceNameSpace, queryLanguage, filterName);
 
                     //  Build the query expression from the filter query
-                    QueryExpression queryExpression = _getQueryExpression(query,
-                        queryLanguage, sourceNameSpace);
+                    SharedQueryExpressionPtr queryExpression =
+                        _getQueryExpression(
+                            query, queryLanguage, sourceNameSpace);
 
                     // the select clause projection
-                    propertyList = queryExpression.getPropertyList();
+                    propertyList = queryExpression->getPropertyList();
 
                     IndicationFormatter::validateTextFormatParameters(
                     propertyList, indicationClass, textFormatParams);
@@ -4312,7 +4358,7 @@ Boolean IndicationService::_canCreate (
             String filterQuery = instance.getProperty (instance.findProperty
                 (PEGASUS_PROPERTYNAME_QUERY)).getValue ().toString ();
 
-            QueryExpression queryExpression;
+            SharedQueryExpressionPtr queryExpression;
             try
             {
                 queryExpression = _getQueryExpression(
@@ -4327,7 +4373,7 @@ Boolean IndicationService::_canCreate (
             }
 
             CIMName indicationClassName = _getIndicationClassName
-                (queryExpression, sourceNameSpace);
+                (*queryExpression, sourceNameSpace);
 
             //
             // Make sure that the FROM class exists in the repository.
@@ -4342,7 +4388,7 @@ Boolean IndicationService::_canCreate (
             //
             try
             {
-              queryExpression.validate();
+              queryExpression->validate();
             }
             catch (QueryMissingPropertyException& qmp)
             {
@@ -5521,14 +5567,14 @@ Array<CIMInstance> IndicationService::_getMatchingSubscriptions (
                     (subscriptions[i], filterQuery, sourceNameSpace,
                      queryLanguage, filterName);
 
-                QueryExpression queryExpr = _getQueryExpression(
+                SharedQueryExpressionPtr queryExpr = _getQueryExpression(
                     filterQuery, queryLanguage, sourceNameSpace);
 
                 // Get the class paths in the FROM list
                 // Since neither WQL nor CQL support joins, so we can
                 // assume one class path.
                 indicationClassName =
-                    queryExpr.getClassPathList()[0].getClassName();
+                    queryExpr->getClassPathList()[0].getClassName();
 
                 if (!_subscriptionRepository->validateIndicationClassName(
                     indicationClassName, sourceNameSpace))
@@ -5552,7 +5598,7 @@ Array<CIMInstance> IndicationService::_getMatchingSubscriptions (
                 //
                 //  Also note that for CQL, this does not return
                 //  required embedded object properties.
-                propertyList = _getPropertyList (queryExpr,
+                propertyList = _getPropertyList (*queryExpr,
                                              sourceNameSpace,
                                              supportedClass);
 
@@ -5712,14 +5758,14 @@ void IndicationService::_getModifiedSubscriptions (
         //
         _subscriptionRepository->getFilterProperties (newList[n], filterQuery,
             sourceNameSpace, queryLanguage, filterName);
-        QueryExpression queryExpression = _getQueryExpression(
+        SharedQueryExpressionPtr queryExpression = _getQueryExpression(
             filterQuery, queryLanguage, sourceNameSpace);
 
         //
         //  Get indication class name from filter query (FROM clause)
         //
-        indicationClassName = _getIndicationClassName (queryExpression,
-            sourceNameSpace);
+        indicationClassName = _getIndicationClassName (
+            *queryExpression, sourceNameSpace);
 
         //
         //  Get required property list from filter query (WHERE clause)
@@ -5729,7 +5775,7 @@ void IndicationService::_getModifiedSubscriptions (
         //  class scoping operators that scope properties to
         //  specific subclasses of the FROM.
         //
-        requiredProperties = _getPropertyList (queryExpression,
+        requiredProperties = _getPropertyList (*queryExpression,
             sourceNameSpace, supportedClass);
 
         //
@@ -5772,14 +5818,14 @@ void IndicationService::_getModifiedSubscriptions (
         //
         _subscriptionRepository->getFilterProperties (bothList[b], filterQuery,
             sourceNameSpace, queryLanguage, filterName);
-        QueryExpression queryExpression = _getQueryExpression(
+        SharedQueryExpressionPtr queryExpression = _getQueryExpression(
             filterQuery, queryLanguage, sourceNameSpace);
 
         //
         //  Get indication class name from filter query (FROM clause)
         //
-        indicationClassName = _getIndicationClassName (queryExpression,
-            sourceNameSpace);
+        indicationClassName = _getIndicationClassName (
+            *queryExpression, sourceNameSpace);
 
         //
         //  Get required property list from filter query (WHERE clause)
@@ -5789,7 +5835,7 @@ void IndicationService::_getModifiedSubscriptions (
         //  class scoping operators that scope properties to
         //  specific subclasses of the FROM.
         //
-        requiredProperties = _getPropertyList (queryExpression,
+        requiredProperties = _getPropertyList (*queryExpression,
             sourceNameSpace, supportedClass);
 
         //
@@ -5867,7 +5913,7 @@ Boolean IndicationService::_inPropertyList (
     return true;
 }
 
-QueryExpression IndicationService::_getQueryExpression(
+SharedQueryExpressionPtr IndicationService::_getQueryExpression(
     const String& filterQuery,
     const String& queryLanguage,
     const CIMNamespaceName& ns) const
@@ -5875,10 +5921,52 @@ QueryExpression IndicationService::_getQueryExpression(
     PEG_METHOD_ENTER(TRC_INDICATION_SERVICE,
         "IndicationService::_getQueryExpression");
 
+    //
+    //  Get the class change count before compiling the query, so that a
+    //  query compiled against class definitions that change meanwhile is
+    //  not cached
+    //
+    Uint32 classChangeCount = _cimRepository->getClassChangeCount();
+
+    SharedQueryExpressionPtr cachedQueryExpression;
+    if (_queryExpressionCache.lookupQueryExpression(
+            queryLanguage, filterQuery, ns, classChangeCount,
+            cachedQueryExpression))
+    {
+        PEG_METHOD_EXIT();
+        return cachedQueryExpression;
+    }
+
     try
     {
         RepositoryQueryContext ctx(ns, _cimRepository);
-        QueryExpression queryExpression(queryLanguage, filterQuery, ctx);
+        SharedQueryExpressionPtr queryExpression(
+            new SharedQueryExpression(queryLanguage, filterQuery, ctx));
+
+        //
+        //  Validate the query before caching it, which also applies its
+        //  class context, so that the threads sharing it only read it.
+        //  A query that fails validation is not cached; the caller gets a
+        //  new, unvalidated expression, and creating a filter reports the
+        //  validation error as before.
+        //
+        try
+        {
+            queryExpression->validate();
+        }
+        catch (Exception& e)
+        {
+            PEG_TRACE((TRC_INDICATION_SERVICE, Tracer::LEVEL4,
+                "Query not cached, validation failed: %s",
+                (const char*)e.getMessage().getCString()));
+            queryExpression.reset(
+                new SharedQueryExpression(queryLanguage, filterQuery, ctx));
+            PEG_METHOD_EXIT();
+            return queryExpression;
+        }
+
+        _queryExpressionCache.insertQueryExpression(
+            queryLanguage, filterQuery, ns, classChangeCount, queryExpression);
         PEG_METHOD_EXIT();
         return queryExpression;
     }
@@ -5906,7 +5994,7 @@ QueryExpression IndicationService::_getQueryExpression(
 }
 
 CIMName IndicationService::_getIndicationClassName (
-    const QueryExpression& queryExpression,
+    const SharedQueryExpression& queryExpression,
     const CIMNamespaceName& nameSpaceName) const
 {
     PEG_METHOD_ENTER (TRC_INDICATION_SERVICE,
@@ -5950,7 +6038,7 @@ CIMName IndicationService::_getIndicationClassName (
 }
 
 Array<ProviderClassList> IndicationService::_getIndicationProviders (
-    const QueryExpression& queryExpression,
+    const SharedQueryExpression& queryExpression,
     const CIMNamespaceName& nameSpace,
     const CIMName& indicationClassName,
     const Array<CIMName>& indicationSubclasses) const
@@ -6054,14 +6142,25 @@ Array<ProviderClassList> IndicationService::_getIndicationProviders (
 }
 
 CIMPropertyList IndicationService::_getPropertyList(
-    const QueryExpression& queryExpression,
+    const SharedQueryExpression& queryExpression,
     const CIMNamespaceName& nameSpaceName,
     const CIMName& indicationClassName) const
 {
     PEG_METHOD_ENTER(TRC_INDICATION_SERVICE,
         "IndicationService::_getPropertyList");
 
+    Uint32 classChangeCount = _cimRepository->getClassChangeCount();
+    String queryLanguage = queryExpression.getQueryLanguage();
+    String query = queryExpression.getQuery();
+
     CIMPropertyList propertyList;
+    if (_queryExpressionCache.lookupPropertyList(queryLanguage, query,
+            nameSpaceName, indicationClassName, classChangeCount,
+            propertyList))
+    {
+        PEG_METHOD_EXIT();
+        return propertyList;
+    }
 
     //  Get all the properties referenced in the condition (WHERE clause)
     //  Note: for CQL, this only returns the properties directly on the
@@ -6089,6 +6188,9 @@ CIMPropertyList IndicationService::_getPropertyList(
         //
         //  Return null property list for all properties
         //
+        _queryExpressionCache.insertPropertyList(queryLanguage, query,
+            nameSpaceName, indicationClassName, classChangeCount,
+            propertyList);
         PEG_METHOD_EXIT();
         return propertyList;
     }
@@ -6101,9 +6203,13 @@ CIMPropertyList IndicationService::_getPropertyList(
         propertyArray = propertyList.getPropertyNameArray();
 
         Array<CIMName> indicationClassProperties;
-        PEG_METHOD_EXIT();
-        return _checkPropertyList(propertyArray, nameSpaceName,
+        propertyList = _checkPropertyList(propertyArray, nameSpaceName,
             indicationClassName, indicationClassProperties);
+        _queryExpressionCache.insertPropertyList(queryLanguage, query,
+            nameSpaceName, indicationClassName, classChangeCount,
+            propertyList);
+        PEG_METHOD_EXIT();
+        return propertyList;
     }
 }
 
@@ -6555,14 +6661,14 @@ void IndicationService::_getCreateParams(
     //
     //  Build the query expression from the filter query
     //
-    QueryExpression queryExpression = _getQueryExpression(query,
+    SharedQueryExpressionPtr queryExpression = _getQueryExpression(query,
                                                          queryLanguage,
                                                          sourceNameSpace);
 
     //
     //  Get indication class name from filter query (FROM clause)
     //
-    indicationClassName = _getIndicationClassName(queryExpression,
+    indicationClassName = _getIndicationClassName(*queryExpression,
                                                    sourceNameSpace);
 
     //
@@ -6576,7 +6682,7 @@ void IndicationService::_getCreateParams(
     //  Get indication provider class lists
     //
     indicationProviders = _getIndicationProviders(
-         queryExpression,
+         *queryExpression,
          sourceNameSpace,
          indicationClassName,
          indicationSubclasses);
@@ -6611,7 +6717,7 @@ void IndicationService::_getCreateParams(
     //
     _subscriptionRepository->getFilterProperties(subscriptionInstance, query,
         sourceNameSpace, queryLanguage, filterName);
-    QueryExpression queryExpression = _getQueryExpression(
+    SharedQueryExpressionPtr queryExpression = _getQueryExpression(
         query,
         queryLanguage,
         sourceNameSpace);
@@ -6620,12 +6726,12 @@ void IndicationService::_getCreateParams(
     //  Get indication class name from filter query (FROM clause)
     //
     CIMName indicationClassName =
-        _getIndicationClassName(queryExpression, sourceNameSpace);
+        _getIndicationClassName(*queryExpression, sourceNameSpace);
 
     //
     //  Get required property list from filter query (WHERE clause)
     //
-    propertyList = _getPropertyList(queryExpression,
+    propertyList = _getPropertyList(*queryExpression,
         sourceNameSpace, indicationClassName);
 
     //
@@ -6661,14 +6767,14 @@ Array<ProviderClassList> IndicationService::_getDeleteParams(
     //
     _subscriptionRepository->getFilterProperties(subscriptionInstance,
         filterQuery, sourceNameSpace, queryLanguage, filterName);
-    QueryExpression queryExpression =
+    SharedQueryExpressionPtr queryExpression =
         _getQueryExpression(filterQuery, queryLanguage, sourceNameSpace);
 
     //
     //  Get indication class name from filter query (FROM clause)
     //
     indicationClassName =
-        _getIndicationClassName(queryExpression, sourceNameSpace);
+        _getIndicationClassName(*queryExpression, sourceNameSpace);
 
     //
     //  Get list of subclass names for indication class
@@ -8156,13 +8262,13 @@ CIMClass IndicationService::_getIndicationClass(
         sourceNameSpace, queryLanguage, filterName);
 
     //  Build the query expression from the filter query
-    QueryExpression queryExpression = _getQueryExpression(query,
+    SharedQueryExpressionPtr queryExpression = _getQueryExpression(query,
                               queryLanguage,
                               sourceNameSpace);
 
     //  Get indication class name from filter query
     indicationClassName = _getIndicationClassName(
-    queryExpression, sourceNameSpace);
+    *queryExpression, sourceNameSpace);
 
     //
     //  Get the indication class object from the repository
@@ -8230,7 +8336,7 @@ Boolean IndicationService::_subscriptionMatch(
     const CIMInstance& subscription,
     const CIMInstance& indication,
     const CIMPropertyList& supportedPropertyList,
-    QueryExpression& queryExpr,
+    SharedQueryExpression& queryExpr,
     const CIMNamespaceName sourceNameSpace)
 {
     PEG_METHOD_ENTER(TRC_INDICATION_SERVICE,
@@ -8387,7 +8493,7 @@ Boolean IndicationService::_subscriptionMatch(
 
 Boolean IndicationService::_formatIndication(
     CIMInstance& formattedIndication,
-    QueryExpression& queryExpr,
+    SharedQueryExpression& queryExpr,
     const Array<CIMName>& providerSupportedProperties,
     const Array<CIMName>& indicationClassProperties)
 {
@@ -44,6 +44,7 @@ ProviderRegistrationManager.h>
 
 #include <Pegasus/IndicationService/ProviderClassList.h>
 #include <Pegasus/IndicationService/IndicationOperationAggregate.h>
+#include <Pegasus/IndicationService/QueryExpressionCache.h>
 
 #ifdef PEGASUS_ENABLE_INDICATION_COUNT
 # include <Pegasus/IndicationService/ProviderIndicationCountTable.h>
@@ -657,15 +658,15 @@ private:
     /**
         Builds a QueryExpression from the filter query string,
         the query language name, and the namespace in which the query
-        is to be run.
+        is to be run, or returns the one in the query expression cache.
 
         @param   filterQuery           the filter query string
         @param   queryLanguage         the query language name
         @param   ns                    query namespace
 
-        @return  QueryExpression representing the filter query
+        @return  the shared QueryExpression representing the filter query
      */
-    QueryExpression _getQueryExpression(
+    SharedQueryExpressionPtr _getQueryExpression(
         const String& filterQuery,
         const String& queryLanguage,
         const CIMNamespaceName& ns) const;
@@ -681,7 +682,7 @@ private:
         @return  String containing the indication class name
      */
     CIMName _getIndicationClassName(
-        const QueryExpression& queryExpression,
+        const SharedQueryExpression& queryExpression,
         const CIMNamespaceName& nameSpaceName) const;
 
     /**
@@ -696,7 +697,7 @@ private:
         @return  list of ProviderClassList structs
      */
     Array<ProviderClassList> _getIndicationProviders(
-        const QueryExpression& queryExpression,
+        const SharedQueryExpression& queryExpression,
         const CIMNamespaceName& nameSpace,
         const CIMName& indicationClassName,
         const Array<CIMName>& indicationSubclasses) const;
@@ -714,7 +715,7 @@ private:
                  expression
      */
     CIMPropertyList _getPropertyList(
-        const QueryExpression& queryExpression,
+        const SharedQueryExpression& queryExpression,
         const CIMNamespaceName& nameSpaceName,
         const CIMName& indicationClassName) const;
 
@@ -1341,7 +1342,7 @@ private:
         const CIMInstance& subscription,
         const CIMInstance& indication,
         const CIMPropertyList& supportedPropertyList,
-        QueryExpression& queryExpr,
+        SharedQueryExpression& queryExpr,
         const CIMNamespaceName sourceNameSpace);
 
     /**
@@ -1366,7 +1367,7 @@ private:
     */
     Boolean _formatIndication(
         CIMInstance& formattedIndication,
-        QueryExpression& queryExpr,
+        SharedQueryExpression& queryExpr,
         const Array<CIMName>& providerSupportedProperties,
         const Array<CIMName>& indicationClassProperties);
 
@@ -1416,6 +1417,11 @@ private:
 
     AutoPtr<SubscriptionTable> _subscriptionTable;
 
+    /**
+        Compiled filter query expressions and their required property lists
+     */
+    mutable QueryExpressionCache _queryExpressionCache;
+
 #ifdef PEGASUS_ENABLE_INDICATION_COUNT
     ProviderIndicationCountTable _providerIndicationCountTable;
 #endif
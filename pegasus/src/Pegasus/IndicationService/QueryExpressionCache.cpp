@@ -0,0 +1,292 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+
+#include <Pegasus/Common/Tracer.h>
+
+#include "QueryExpressionCache.h"
+
+PEGASUS_USING_STD;
+
+PEGASUS_NAMESPACE_BEGIN
+
+/**
+    Maximum number of queries held in the cache.  Entries are removed when
+    their filter is deleted, so this limit is only reached if there are more
+    active filters than this or if many queries fail validation after being
+    compiled.  The least recently used entry is removed when the limit is
+    reached.
+*/
+#define PEGASUS_QUERY_EXPRESSION_CACHE_SIZE 1000
+
+// Lookup statistics of all caches, reported by the statistics provider
+static Mutex _statisticsMutex;
+static Uint64 _hits = 0;
+static Uint64 _misses = 0;
+
+static void _countLookup(Boolean hit)
+{
+    AutoMutex autoMut(_statisticsMutex);
+
+    if (hit)
+    {
+        _hits++;
+    }
+    else
+    {
+        _misses++;
+    }
+}
+
+struct QueryExpressionCache::Entry
+{
+    Entry(const SharedQueryExpressionPtr& queryExpression_, Uint64 lastUse_)
+        : queryExpression(queryExpression_),
+          lastUse(lastUse_)
+    {
+    }
+
+    SharedQueryExpressionPtr queryExpression;
+    Uint64 lastUse;
+
+    // Required property lists keyed by indication class name
+    HashTable<String, CIMPropertyList, EqualNoCaseFunc, HashLowerCaseFunc>
+        propertyLists;
+};
+
+QueryExpressionCache::QueryExpressionCache()
+    : _classChangeCount(0),
+      _useCount(0)
+{
+}
+
+QueryExpressionCache::~QueryExpressionCache()
+{
+    _clear();
+}
+
+String QueryExpressionCache::_makeKey(
+    const String& queryLanguage,
+    const String& query,
+    const CIMNamespaceName& nameSpace)
+{
+    // Neither the namespace name nor the query language contain a newline,
+    // so the key is unique.
+    String key = nameSpace.getString();
+    key.append('\n');
+    key.append(queryLanguage);
+    key.append('\n');
+    key.append(query);
+    return key;
+}
+
+void QueryExpressionCache::_checkClassChangeCount(Uint32 classChangeCount)
+{
+    if (classChangeCount != _classChangeCount)
+    {
+        if (_entries.size())
+        {
+            PEG_TRACE_CSTRING(TRC_INDICATION_SERVICE, Tracer::LEVEL4,
+                "Class definitions changed, clearing the query expression "
+                    "cache");
+        }
+
+        _clear();
+        _classChangeCount = classChangeCount;
+    }
+}
+
+void QueryExpressionCache::_clear()
+{
+    for (EntryTable::Iterator i = _entries.start(); i; i++)
+    {
+        delete i.value();
+    }
+
+    _entries.clear();
+}
+
+void QueryExpressionCache::_removeLeastRecentlyUsed()
+{
+    String oldestKey;
+    Entry* oldestEntry = 0;
+
+    for (EntryTable::Iterator i = _entries.start(); i; i++)
+    {
+        if (!oldestEntry || i.value()->lastUse < oldestEntry->lastUse)
+        {
+            oldestKey = i.key();
+            oldestEntry = i.value();
+        }
+    }
+
+    if (oldestEntry)
+    {
+        _entries.remove(oldestKey);
+        delete oldestEntry;
+    }
+}
+
+Boolean QueryExpressionCache::lookupQueryExpression(
+    const String& queryLanguage,
+    const String& query,
+    const CIMNamespaceName& nameSpace,
+    Uint32 classChangeCount,
+    SharedQueryExpressionPtr& queryExpression)
+{
+    AutoMutex autoMut(_mutex);
+
+    _checkClassChangeCount(classChangeCount);
+
+    Entry* entry;
+
+    if (_entries.lookup(_makeKey(queryLanguage, query, nameSpace), entry))
+    {
+        _countLookup(true);
+        entry->lastUse = ++_useCount;
+        queryExpression = entry->queryExpression;
+        return true;
+    }
+
+    _countLookup(false);
+
+    PEG_TRACE((TRC_INDICATION_SERVICE, Tracer::LEVEL4,
+        "Query expression cache miss: %s",
+        (const char*)query.getCString()));
+
+    return false;
+}
+
+void QueryExpressionCache::insertQueryExpression(
+    const String& queryLanguage,
+    const String& query,
+    const CIMNamespaceName& nameSpace,
+    Uint32 classChangeCount,
+    const SharedQueryExpressionPtr& queryExpression)
+{
+    AutoMutex autoMut(_mutex);
+
+    String key = _makeKey(queryLanguage, query, nameSpace);
+
+    if (classChangeCount != _classChangeCount || _entries.contains(key))
+    {
+        return;
+    }
+
+    if (_entries.size() >= PEGASUS_QUERY_EXPRESSION_CACHE_SIZE)
+    {
+        _removeLeastRecentlyUsed();
+    }
+
+    Entry* entry = new Entry(queryExpression, ++_useCount);
+
+    if (!_entries.insert(key, entry))
+    {
+        delete entry;
+    }
+}
+
+Boolean QueryExpressionCache::lookupPropertyList(
+    const String& queryLanguage,
+    const String& query,
+    const CIMNamespaceName& nameSpace,
+    const CIMName& indicationClassName,
+    Uint32 classChangeCount,
+    CIMPropertyList& propertyList)
+{
+    AutoMutex autoMut(_mutex);
+
+    _checkClassChangeCount(classChangeCount);
+
+    Entry* entry;
+
+    if (_entries.lookup(_makeKey(queryLanguage, query, nameSpace), entry) &&
+        entry->propertyLists.lookup(
+            indicationClassName.getString(), propertyList))
+    {
+        _countLookup(true);
+        entry->lastUse = ++_useCount;
+        return true;
+    }
+
+    _countLookup(false);
+    return false;
+}
+
+void QueryExpressionCache::insertPropertyList(
+    const String& queryLanguage,
+    const String& query,
+    const CIMNamespaceName& nameSpace,
+    const CIMName& indicationClassName,
+    Uint32 classChangeCount,
+    const CIMPropertyList& propertyList)
+{
+    AutoMutex autoMut(_mutex);
+
+    Entry* entry;
+
+    if (classChangeCount == _classChangeCount &&
+        _entries.lookup(_makeKey(queryLanguage, query, nameSpace), entry))
+    {
+        entry->propertyLists.insert(
+            indicationClassName.getString(), propertyList);
+    }
+}
+
+void QueryExpressionCache::remove(
+    const String& queryLanguage,
+    const String& query,
+    const CIMNamespaceName& nameSpace)
+{
+    AutoMutex autoMut(_mutex);
+
+    String key = _makeKey(queryLanguage, query, nameSpace);
+    Entry* entry;
+
+    if (_entries.lookup(key, entry))
+    {
+        _entries.remove(key);
+        delete entry;
+    }
+}
+
+void QueryExpressionCache::clear()
+{
+    AutoMutex autoMut(_mutex);
+    _clear();
+}
+
+void QueryExpressionCache::getStatistics(Uint64& hits, Uint64& misses)
+{
+    AutoMutex autoMut(_statisticsMutex);
+    hits = _hits;
+    misses = _misses;
+}
+
+PEGASUS_NAMESPACE_END
@@ -0,0 +1,267 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+
+#ifndef Pegasus_QueryExpressionCache_h
+#define Pegasus_QueryExpressionCache_h
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Server/Linkage.h>
+#include <Pegasus/Common/String.h>
+#include <Pegasus/Common/CIMName.h>
+#include <Pegasus/Common/CIMPropertyList.h>
+#include <Pegasus/Common/HashTable.h>
+#include <Pegasus/Common/Mutex.h>
+#include <Pegasus/Common/SharedPtr.h>
+#include <Pegasus/Query/QueryExpression/QueryExpression.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+/**
+    A compiled filter query shared by the QueryExpressionCache and the
+    threads using it.  A CQL statement resolves its class context and the
+    values it compares in the statement itself, so even the methods of
+    QueryExpression that describe the query may modify it; all access to
+    the QueryExpression is therefore serialized.  An expression is
+    validated before it is added to the cache, so that its class context
+    is applied only once.
+*/
+class SharedQueryExpression
+{
+public:
+
+    SharedQueryExpression(
+        const String& queryLanguage,
+        const String& query,
+        QueryContext& ctx)
+        : _queryLanguage(queryLanguage),
+          _query(query),
+          _queryExpression(queryLanguage, query, ctx)
+    {
+    }
+
+    const String& getQueryLanguage() const
+    {
+        return _queryLanguage;
+    }
+
+    const String& getQuery() const
+    {
+        return _query;
+    }
+
+    Array<CIMObjectPath> getClassPathList() const
+    {
+        AutoMutex autoMut(_mutex);
+        return _queryExpression.getClassPathList();
+    }
+
+    /**
+        Returns the select clause projection; see
+        QueryExpression::getPropertyList().
+    */
+    CIMPropertyList getPropertyList() const
+    {
+        AutoMutex autoMut(_mutex);
+        return _queryExpression.getPropertyList();
+    }
+
+    CIMPropertyList getWherePropertyList(const CIMObjectPath& classPath) const
+    {
+        AutoMutex autoMut(_mutex);
+        return _queryExpression.getWherePropertyList(classPath);
+    }
+
+    Boolean evaluate(const CIMInstance& instance)
+    {
+        AutoMutex autoMut(_mutex);
+        return _queryExpression.evaluate(instance);
+    }
+
+    void applyProjection(CIMInstance instance, Boolean allowMissing)
+    {
+        AutoMutex autoMut(_mutex);
+        _queryExpression.applyProjection(instance, allowMissing);
+    }
+
+    void validate()
+    {
+        AutoMutex autoMut(_mutex);
+        _queryExpression.validate();
+    }
+
+private:
+
+    SharedQueryExpression(const SharedQueryExpression&);
+    SharedQueryExpression& operator=(const SharedQueryExpression&);
+
+    String _queryLanguage;
+    String _query;
+    QueryExpression _queryExpression;
+    mutable Mutex _mutex;
+};
+
+typedef SharedPtr<SharedQueryExpression> SharedQueryExpressionPtr;
+
+/**
+    The QueryExpressionCache holds the compiled QueryExpression of each
+    filter query used by the IndicationService, so that the query does not
+    have to be parsed again for every indication.  For each query it also
+    holds the list of properties required by the query (WHERE clause) for
+    each indication class the query has been checked against.
+
+    Entries are keyed by query language, source namespace and query text.
+    A lookup returns the cached expression itself rather than a copy.
+    Since compiling a query and computing its required properties depend on
+    class definitions, the cache is emptied whenever the class change count
+    passed to the lookup methods differs from the one of the previous lookup
+    (see CIMRepository::getClassChangeCount()).  Entries of a filter are
+    removed when the filter is deleted.  When the cache is full, the least
+    recently used entry is removed to make room for a new one.
+*/
+class PEGASUS_SERVER_LINKAGE QueryExpressionCache
+{
+public:
+
+    QueryExpressionCache();
+
+    ~QueryExpressionCache();
+
+    /**
+        Looks up the compiled query expression for the specified query.
+
+        @param queryLanguage the query language of the query
+        @param query the query text
+        @param nameSpace the source namespace of the query
+        @param classChangeCount the current class change count
+        @param queryExpression output cached query expression
+
+        @return true if the query expression was found in the cache
+    */
+    Boolean lookupQueryExpression(
+        const String& queryLanguage,
+        const String& query,
+        const CIMNamespaceName& nameSpace,
+        Uint32 classChangeCount,
+        SharedQueryExpressionPtr& queryExpression);
+
+    /**
+        Adds the compiled query expression for the specified query.  The
+        expression must have been validated, so that the threads sharing it
+        do not apply its class context.  The classChangeCount is the count
+        obtained before the query was compiled; if class definitions have
+        changed since, nothing is added.
+    */
+    void insertQueryExpression(
+        const String& queryLanguage,
+        const String& query,
+        const CIMNamespaceName& nameSpace,
+        Uint32 classChangeCount,
+        const SharedQueryExpressionPtr& queryExpression);
+
+    /**
+        Looks up the list of properties the specified query requires of
+        instances of the specified indication class.
+
+        @return true if the property list was found in the cache
+    */
+    Boolean lookupPropertyList(
+        const String& queryLanguage,
+        const String& query,
+        const CIMNamespaceName& nameSpace,
+        const CIMName& indicationClassName,
+        Uint32 classChangeCount,
+        CIMPropertyList& propertyList);
+
+    /**
+        Adds the list of properties the specified query requires of
+        instances of the specified indication class.  The query expression
+        must have been added first; otherwise this method has no effect.
+        The classChangeCount is handled as in insertQueryExpression().
+    */
+    void insertPropertyList(
+        const String& queryLanguage,
+        const String& query,
+        const CIMNamespaceName& nameSpace,
+        const CIMName& indicationClassName,
+        Uint32 classChangeCount,
+        const CIMPropertyList& propertyList);
+
+    /**
+        Removes the entry of the specified query, if any.
+    */
+    void remove(
+        const String& queryLanguage,
+        const String& query,
+        const CIMNamespaceName& nameSpace);
+
+    /**
+        Removes all entries.
+    */
+    void clear();
+
+    /**
+        Returns the number of lookups satisfied and not satisfied from the
+        query expression caches of the process.
+    */
+    static void getStatistics(Uint64& hits, Uint64& misses);
+
+private:
+
+    QueryExpressionCache(const QueryExpressionCache&);
+    QueryExpressionCache& operator=(const QueryExpressionCache&);
+
+    struct Entry;
+
+    typedef HashTable<String, Entry*, EqualFunc<String>, HashFunc<String> >
+        EntryTable;
+
+    static String _makeKey(
+        const String& queryLanguage,
+        const String& query,
+        const CIMNamespaceName& nameSpace);
+
+    void _checkClassChangeCount(Uint32 classChangeCount);
+
+    void _clear();
+
+    void _removeLeastRecentlyUsed();
+
+    EntryTable _entries;
+    Uint32 _classChangeCount;
+
+    // Incremented by each lookup; the value is recorded in the entry found
+    // so the least recently used entry can be evicted.
+    Uint64 _useCount;
+    Mutex _mutex;
+};
+
+PEGASUS_NAMESPACE_END
+
+#endif /* Pegasus_QueryExpressionCache_h */
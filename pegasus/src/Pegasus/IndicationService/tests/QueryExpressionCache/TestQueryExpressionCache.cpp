@@ -0,0 +1,318 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/ArrayInternal.h>
+#include <Pegasus/IndicationService/QueryExpressionCache.h>
+#include <Pegasus/Query/QueryCommon/QueryContext.h>
+#include <cstdio>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+#define VCOUT if (verbose) cout
+
+static Boolean verbose;
+
+static const char NAMESPACE[] = "root/cimv2";
+static const char QUERY[] =
+    "SELECT IndicationIdentifier FROM TST_Indication "
+        "WHERE PerceivedSeverity = 1";
+
+// A context for WQL queries on TST_Indication, which has no subclasses
+class TestQueryContext : public QueryContext
+{
+public:
+
+    TestQueryContext() : QueryContext(CIMNamespaceName(NAMESPACE))
+    {
+    }
+
+    virtual QueryContext* clone() const
+    {
+        return new TestQueryContext(*this);
+    }
+
+    virtual CIMClass getClass(const CIMName& inClassName) const
+    {
+        CIMClass cimClass(inClassName);
+        cimClass.addProperty(
+            CIMProperty(CIMName("IndicationIdentifier"), String()));
+        cimClass.addProperty(
+            CIMProperty(CIMName("PerceivedSeverity"), Uint16(0)));
+        return cimClass;
+    }
+
+    virtual Array<CIMName> enumerateClassNames(
+        const CIMName& inClassName) const
+    {
+        return Array<CIMName>();
+    }
+
+    virtual Boolean isSubClass(
+        const CIMName& baseClass,
+        const CIMName& derivedClass) const
+    {
+        return false;
+    }
+
+    virtual ClassRelation getClassRelation(
+        const CIMName& anchorClass,
+        const CIMName& relatedClass) const
+    {
+        return anchorClass == relatedClass ? SAMECLASS : NOTRELATED;
+    }
+};
+
+static SharedQueryExpressionPtr _compile(const String& query)
+{
+    TestQueryContext ctx;
+    SharedQueryExpressionPtr queryExpression(
+        new SharedQueryExpression("WQL", query, ctx));
+    queryExpression->validate();
+    return queryExpression;
+}
+
+static void _getStatistics(Uint64& hits, Uint64& misses)
+{
+    QueryExpressionCache::getStatistics(hits, misses);
+    VCOUT << "hits " << hits << ", misses " << misses << endl;
+}
+
+static String _query(Uint32 i)
+{
+    char buffer[64];
+    sprintf(buffer, "SELECT * FROM TST_Indication%u", i);
+    return buffer;
+}
+
+void testSharedQueryExpression()
+{
+    SharedQueryExpressionPtr queryExpression = _compile(QUERY);
+
+    PEGASUS_TEST_ASSERT(queryExpression->getQueryLanguage() == "WQL");
+    PEGASUS_TEST_ASSERT(queryExpression->getQuery() == QUERY);
+
+    Array<CIMObjectPath> classPaths = queryExpression->getClassPathList();
+    PEGASUS_TEST_ASSERT(classPaths.size() == 1);
+    PEGASUS_TEST_ASSERT(
+        classPaths[0].getClassName() == CIMName("TST_Indication"));
+
+    // For WQL the projection includes the WHERE clause properties
+    CIMPropertyList propertyList = queryExpression->getPropertyList();
+    Array<CIMName> names = propertyList.getPropertyNameArray();
+    PEGASUS_TEST_ASSERT(names.size() == 2);
+    PEGASUS_TEST_ASSERT(Contains(names, CIMName("PerceivedSeverity")));
+    PEGASUS_TEST_ASSERT(Contains(names, CIMName("IndicationIdentifier")));
+
+    // The WHERE clause properties do not accumulate over calls
+    CIMObjectPath classPath(String::EMPTY, CIMNamespaceName(NAMESPACE),
+        CIMName("TST_Indication"));
+    for (Uint32 i = 0; i < 3; i++)
+    {
+        propertyList = queryExpression->getWherePropertyList(classPath);
+        PEGASUS_TEST_ASSERT(propertyList.size() == 1);
+        PEGASUS_TEST_ASSERT(
+            propertyList[0] == CIMName("PerceivedSeverity"));
+    }
+}
+
+void testHitAndMiss()
+{
+    QueryExpressionCache cache;
+    CIMNamespaceName nameSpace(NAMESPACE);
+    SharedQueryExpressionPtr queryExpression = _compile(QUERY);
+    SharedQueryExpressionPtr found;
+    CIMPropertyList propertyList;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 hits0;
+    Uint64 misses0;
+
+    _getStatistics(hits0, misses0);
+
+    PEGASUS_TEST_ASSERT(
+        !cache.lookupQueryExpression("WQL", QUERY, nameSpace, 1, found));
+    cache.insertQueryExpression("WQL", QUERY, nameSpace, 1, queryExpression);
+    PEGASUS_TEST_ASSERT(
+        cache.lookupQueryExpression("WQL", QUERY, nameSpace, 1, found));
+    PEGASUS_TEST_ASSERT(found.get() == queryExpression.get());
+
+    // The key includes the query language and the namespace
+    PEGASUS_TEST_ASSERT(!cache.lookupQueryExpression(
+        "DMTF:CQL", QUERY, nameSpace, 1, found));
+    PEGASUS_TEST_ASSERT(!cache.lookupQueryExpression(
+        "WQL", QUERY, CIMNamespaceName("root/PG_InterOp"), 1, found));
+
+    _getStatistics(hits, misses);
+    PEGASUS_TEST_ASSERT(hits == hits0 + 1);
+    PEGASUS_TEST_ASSERT(misses == misses0 + 3);
+
+    CIMName className("TST_Indication");
+    PEGASUS_TEST_ASSERT(!cache.lookupPropertyList(
+        "WQL", QUERY, nameSpace, className, 1, propertyList));
+    Array<CIMName> names;
+    names.append(CIMName("PerceivedSeverity"));
+    cache.insertPropertyList(
+        "WQL", QUERY, nameSpace, className, 1, CIMPropertyList(names));
+    PEGASUS_TEST_ASSERT(cache.lookupPropertyList(
+        "WQL", QUERY, nameSpace, className, 1, propertyList));
+    PEGASUS_TEST_ASSERT(propertyList.size() == 1);
+
+    // A property list is only cached with its query expression
+    cache.insertPropertyList(
+        "WQL", "SELECT * FROM TST_Indication", nameSpace, className, 1,
+        CIMPropertyList());
+    PEGASUS_TEST_ASSERT(!cache.lookupPropertyList(
+        "WQL", "SELECT * FROM TST_Indication", nameSpace, className, 1,
+        propertyList));
+
+    _getStatistics(hits, misses);
+    PEGASUS_TEST_ASSERT(hits == hits0 + 2);
+    PEGASUS_TEST_ASSERT(misses == misses0 + 5);
+}
+
+void testClassChange()
+{
+    QueryExpressionCache cache;
+    CIMNamespaceName nameSpace(NAMESPACE);
+    SharedQueryExpressionPtr queryExpression = _compile(QUERY);
+    SharedQueryExpressionPtr found;
+
+    PEGASUS_TEST_ASSERT(
+        !cache.lookupQueryExpression("WQL", QUERY, nameSpace, 1, found));
+    cache.insertQueryExpression("WQL", QUERY, nameSpace, 1, queryExpression);
+    PEGASUS_TEST_ASSERT(
+        cache.lookupQueryExpression("WQL", QUERY, nameSpace, 1, found));
+
+    // A class change empties the cache
+    PEGASUS_TEST_ASSERT(
+        !cache.lookupQueryExpression("WQL", QUERY, nameSpace, 2, found));
+    PEGASUS_TEST_ASSERT(
+        !cache.lookupQueryExpression("WQL", QUERY, nameSpace, 2, found));
+
+    // An expression compiled before the class change is not added
+    cache.insertQueryExpression("WQL", QUERY, nameSpace, 1, queryExpression);
+    PEGASUS_TEST_ASSERT(
+        !cache.lookupQueryExpression("WQL", QUERY, nameSpace, 2, found));
+
+    cache.insertQueryExpression("WQL", QUERY, nameSpace, 2, queryExpression);
+    PEGASUS_TEST_ASSERT(
+        cache.lookupQueryExpression("WQL", QUERY, nameSpace, 2, found));
+}
+
+void testRemove()
+{
+    QueryExpressionCache cache;
+    CIMNamespaceName nameSpace(NAMESPACE);
+    SharedQueryExpressionPtr queryExpression = _compile(QUERY);
+    SharedQueryExpressionPtr found;
+
+    cache.insertQueryExpression("WQL", QUERY, nameSpace, 0, queryExpression);
+    cache.insertQueryExpression(
+        "WQL", _query(0), nameSpace, 0, queryExpression);
+
+    // The entry of a deleted filter is removed, others are kept
+    cache.remove("WQL", QUERY, nameSpace);
+    PEGASUS_TEST_ASSERT(
+        !cache.lookupQueryExpression("WQL", QUERY, nameSpace, 0, found));
+    PEGASUS_TEST_ASSERT(
+        cache.lookupQueryExpression("WQL", _query(0), nameSpace, 0, found));
+
+    // The removed expression is still usable by its holders
+    PEGASUS_TEST_ASSERT(queryExpression->getClassPathList().size() == 1);
+
+    cache.clear();
+    PEGASUS_TEST_ASSERT(
+        !cache.lookupQueryExpression("WQL", _query(0), nameSpace, 0, found));
+}
+
+void testEviction()
+{
+    QueryExpressionCache cache;
+    CIMNamespaceName nameSpace(NAMESPACE);
+    SharedQueryExpressionPtr queryExpression = _compile(QUERY);
+    SharedQueryExpressionPtr found;
+
+    // Fill the cache (1000 entries); the keys only need to differ
+    const Uint32 size = 1000;
+    for (Uint32 i = 0; i < size; i++)
+    {
+        cache.insertQueryExpression(
+            "WQL", _query(i), nameSpace, 0, queryExpression);
+    }
+
+    for (Uint32 i = 0; i < size; i++)
+    {
+        PEGASUS_TEST_ASSERT(cache.lookupQueryExpression(
+            "WQL", _query(i), nameSpace, 0, found));
+    }
+
+    // Use entry 0 again, so that entry 1 is the least recently used one
+    PEGASUS_TEST_ASSERT(cache.lookupQueryExpression(
+        "WQL", _query(0), nameSpace, 0, found));
+
+    cache.insertQueryExpression(
+        "WQL", _query(size), nameSpace, 0, queryExpression);
+
+    PEGASUS_TEST_ASSERT(cache.lookupQueryExpression(
+        "WQL", _query(size), nameSpace, 0, found));
+    PEGASUS_TEST_ASSERT(cache.lookupQueryExpression(
+        "WQL", _query(0), nameSpace, 0, found));
+    PEGASUS_TEST_ASSERT(!cache.lookupQueryExpression(
+        "WQL", _query(1), nameSpace, 0, found));
+    PEGASUS_TEST_ASSERT(cache.lookupQueryExpression(
+        "WQL", _query(2), nameSpace, 0, found));
+}
+
+int main (int argc, char *argv[])
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    try
+    {
+        testSharedQueryExpression();
+        testHitAndMiss();
+        testClassChange();
+        testRemove();
+        testEviction();
+    }
+    catch (Exception& e)
+    {
+        cout << endl << "Exception: " ;
+        cout << e.getMessage() << endl << endl ;
+        exit(-1);
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
@@ -108,6 +108,14 @@ public:
     */
     Uint32 getPortNumber() const;
 
+    /** Sets whether binary batches of indications are accepted.  It must
+        be called before init().
+    */
+    void setRemoteBinaryProtocol(Boolean flag)
+    {
+        _remoteBinaryProtocol = flag;
+    }
+
     static ThreadReturnType PEGASUS_THREAD_CDECL
     _listener_routine(void *param);
 
@@ -123,6 +131,7 @@ private:
     CIMListenerIndicationDispatcher *_dispatcher;
     CIMExportResponseEncoder *_responseEncoder;
     CIMExportRequestDecoder *_requestDecoder;
+    Boolean _remoteBinaryProtocol;
 };
 
 CIMListenerService::CIMListenerService(
@@ -137,7 +146,8 @@ CIMListenerService::CIMListenerService(
     _dieNow(false),
     _dispatcher(NULL),
     _responseEncoder(NULL),
-    _requestDecoder(NULL)
+    _requestDecoder(NULL),
+    _remoteBinaryProtocol(false)
 {
 }
 
@@ -150,7 +160,8 @@ CIMListenerService::CIMListenerService(CIMListenerService & svc) :
     _dieNow(svc._dieNow),
     _dispatcher(NULL),
     _responseEncoder(NULL),
-    _requestDecoder(NULL)
+    _requestDecoder(NULL),
+    _remoteBinaryProtocol(svc._remoteBinaryProtocol)
 {
 }
 
@@ -179,6 +190,7 @@ void CIMListenerService::init()
     {
         _requestDecoder = new CIMExportRequestDecoder(
             _dispatcher, _responseEncoder->getQueueId());
+        _requestDecoder->setRemoteBinaryProtocol(_remoteBinaryProtocol);
     }
 #ifdef PEGASUS_ENABLE_IPV6
     if (System::isIPv6StackActive())
@@ -423,6 +435,8 @@ public:
     SSLContext *getSSLContext() const;
     void setSSLContext(SSLContext * sslContext);
 
+    void setRemoteBinaryProtocol(Boolean flag);
+
     void start();
     void stop();
 
@@ -436,6 +450,7 @@ private:
 
     Uint32 _portNumber;
     SSLContext *_sslContext;
+    Boolean _remoteBinaryProtocol;
 
     CIMListenerIndicationDispatcher *_dispatcher;
     ThreadPool *_thread_pool;
@@ -449,6 +464,7 @@ CIMListenerRep::CIMListenerRep(
     :
     _portNumber(portNumber),
     _sslContext(sslContext),
+    _remoteBinaryProtocol(false),
     _dispatcher(new CIMListenerIndicationDispatcher()),
     _thread_pool(NULL),
     _svc(NULL),
@@ -491,6 +507,11 @@ void CIMListenerRep::setSSLContext(SSLContext * sslContext)
     _sslContext = sslContext;
 }
 
+void CIMListenerRep::setRemoteBinaryProtocol(Boolean flag)
+{
+    _remoteBinaryProtocol = flag;
+}
+
 void CIMListenerRep::start()
 {
     // spawn a thread to do this
@@ -500,6 +521,7 @@ void CIMListenerRep::start()
             svc(new CIMListenerService(_portNumber, _sslContext));
 
         svc->setIndicationDispatcher(_dispatcher);
+        svc->setRemoteBinaryProtocol(_remoteBinaryProtocol);
         svc->init();
 
         struct timeval deallocateWait = { 15, 0 };
@@ -645,6 +667,11 @@ void CIMListener::setSSLContext(SSLContext * sslContext)
     static_cast < CIMListenerRep * >(_rep)->setSSLContext(sslContext);
 }
 
+void CIMListener::setRemoteBinaryProtocol(Boolean flag)
+{
+    static_cast < CIMListenerRep * >(_rep)->setRemoteBinaryProtocol(flag);
+}
+
 void CIMListener::start()
 {
     static_cast < CIMListenerRep * >(_rep)->start();
@@ -88,6 +88,15 @@ public:
      */
     void setSSLContext(SSLContext* sslContext);
 
+    /**
+     * Sets whether export clients may send batches of indications in the
+     * compact encoding of the OpenPegasus binary protocol. They are not
+     * accepted unless this is set. It takes effect with the next start().
+     *
+     * @param flag true to accept binary batches of indications.
+     */
+    void setRemoteBinaryProtocol(Boolean flag);
+
     /**
      * Starts for listening.
      */
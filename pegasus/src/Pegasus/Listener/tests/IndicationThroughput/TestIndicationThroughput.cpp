@@ -0,0 +1,278 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/AtomicInt.h>
+#include <Pegasus/Common/Monitor.h>
+#include <Pegasus/Common/HTTPConnector.h>
+#include <Pegasus/Common/OperationContextInternal.h>
+#include <Pegasus/Common/Thread.h>
+#include <Pegasus/General/Stopwatch.h>
+#include <Pegasus/Consumer/CIMIndicationConsumer.h>
+#include <Pegasus/ExportClient/CIMExportClient.h>
+#include <Pegasus/Listener/CIMListener.h>
+#include <cstdio>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+static Boolean verbose;
+
+static const Uint32 PORT = 2009;
+static const Uint32 INDICATIONS = 2000;
+static const Uint32 BATCH_SIZE = 50;
+
+// Seconds to wait for the consumer to receive all indications of a run
+static const Uint32 TIMEOUT = 60;
+
+static const char URL[] = "/CIMListener/throughput";
+
+//
+// Counts the indications received and checks their contents.
+//
+class CountingConsumer : public CIMIndicationConsumer
+{
+public:
+
+    CountingConsumer() : _received(0), _errors(0)
+    {
+    }
+
+    void consumeIndication(
+        const OperationContext& context,
+        const String& url,
+        const CIMInstance& indication)
+    {
+        ContentLanguageList languages =
+            ((ContentLanguageListContainer)context.get(
+                ContentLanguageListContainer::NAME)).getLanguages();
+
+        Uint32 pos = indication.findProperty("Description");
+
+        if (url != "/throughput" ||
+            languages.size() != 1 ||
+            languages.getLanguageTag(0).toString() != "en-US" ||
+            pos == PEG_NOT_FOUND ||
+            indication.getProperty(pos).getValue().toString() !=
+                "Disk drive temperature above threshold")
+        {
+            _errors++;
+        }
+
+        _received++;
+    }
+
+    // Waits until the specified number of indications has been received.
+    Boolean waitFor(Uint32 count)
+    {
+        for (Uint32 i = 0; i < TIMEOUT * 100; i++)
+        {
+            if (_received.get() >= count)
+            {
+                return true;
+            }
+            Threads::sleep(10);
+        }
+        return false;
+    }
+
+    Uint32 getErrors()
+    {
+        return _errors.get();
+    }
+
+private:
+
+    AtomicInt _received;
+    AtomicInt _errors;
+};
+
+//
+// Builds alert indications as a provider would generate them.
+//
+static Array<CIMInstance> _makeIndications()
+{
+    Array<CIMInstance> indications;
+
+    for (Uint32 i = 0; i < INDICATIONS; i++)
+    {
+        char id[32];
+        sprintf(id, "%u", i);
+
+        CIMInstance indication("CIM_AlertIndication");
+        indication.addProperty(
+            CIMProperty(CIMName("IndicationIdentifier"), String(id)));
+        indication.addProperty(CIMProperty(CIMName("IndicationTime"),
+            CIMDateTime("20261017120000.000000+000")));
+        indication.addProperty(CIMProperty(CIMName("Description"),
+            String("Disk drive temperature above threshold")));
+        indication.addProperty(CIMProperty(CIMName("AlertingManagedElement"),
+            String("root/cimv2:CIM_DiskDrive."
+                "CreationClassName=\"CIM_DiskDrive\",DeviceID=\"disk0\"")));
+        indication.addProperty(
+            CIMProperty(CIMName("AlertingElementFormat"), Uint16(2)));
+        indication.addProperty(CIMProperty(CIMName("AlertType"), Uint16(5)));
+        indication.addProperty(
+            CIMProperty(CIMName("PerceivedSeverity"), Uint16(4)));
+        indication.addProperty(CIMProperty(CIMName("ProbableCause"),
+            Uint16(51)));
+        indication.addProperty(CIMProperty(CIMName("SystemCreationClassName"),
+            String("CIM_ComputerSystem")));
+        indication.addProperty(CIMProperty(CIMName("SystemName"),
+            String("server01.example.com")));
+        indication.addProperty(
+            CIMProperty(CIMName("SequenceNumber"), Sint64(i)));
+
+        indications.append(indication);
+    }
+
+    return indications;
+}
+
+static void _report(const char* label, Uint64 usec)
+{
+    if (verbose)
+    {
+        printf("%-24s %8.0f indications/s\n",
+            label, double(INDICATIONS) * 1000000 / double(usec));
+    }
+}
+
+//
+// Sends the same indications from a CIMExportClient to a CIMListener, one
+// CIM-XML request per indication and in batches in the binary protocol,
+// and reports the throughput of each, measured until the consumer has
+// received all indications.
+//
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    try
+    {
+        Array<CIMInstance> indications = _makeIndications();
+        ContentLanguageList en;
+        en.append(LanguageTag("en-US"));
+        Array<ContentLanguageList> languages;
+        languages.grow(BATCH_SIZE, en);
+
+        Monitor monitor;
+        HTTPConnector connector(&monitor);
+        CIMExportClient client(&monitor, &connector);
+
+        // A listener without the binary protocol enabled answers in
+        // CIM-XML, so the client keeps sending CIM-XML.
+        {
+            CIMListener listener(PORT + 1);
+            CountingConsumer consumer;
+            listener.addConsumer(&consumer);
+            listener.start();
+
+            client.connect("localhost", PORT + 1);
+            client.exportIndication(URL, indications[0], en);
+            PEGASUS_TEST_ASSERT(consumer.waitFor(1));
+            PEGASUS_TEST_ASSERT(!client.isBinaryExport());
+            client.disconnect();
+
+            listener.stop();
+            listener.removeConsumer(&consumer);
+        }
+
+        CIMListener listener(PORT);
+        listener.setRemoteBinaryProtocol(true);
+        CountingConsumer consumer;
+        listener.addConsumer(&consumer);
+        listener.start();
+
+        client.connect("localhost", PORT);
+
+        PEGASUS_TEST_ASSERT(!client.isBinaryExport());
+
+        // CIM-XML, one request per indication.  The listener answers the
+        // first one in the binary protocol.
+
+        Stopwatch xml;
+        xml.start();
+
+        for (Uint32 i = 0; i < INDICATIONS; i++)
+        {
+            client.exportIndication(URL, indications[i], en);
+        }
+
+        PEGASUS_TEST_ASSERT(consumer.waitFor(INDICATIONS));
+        xml.stop();
+
+        PEGASUS_TEST_ASSERT(client.isBinaryExport());
+
+        // Binary protocol, BATCH_SIZE indications per request
+
+        Stopwatch binary;
+        binary.start();
+
+        for (Uint32 i = 0; i < INDICATIONS; i += BATCH_SIZE)
+        {
+            Array<CIMException> results;
+            client.exportIndications(URL,
+                Array<CIMInstance>(indications.getData() + i, BATCH_SIZE),
+                languages,
+                results);
+
+            PEGASUS_TEST_ASSERT(results.size() == BATCH_SIZE);
+            for (Uint32 j = 0; j < BATCH_SIZE; j++)
+            {
+                PEGASUS_TEST_ASSERT(results[j].getCode() == CIM_ERR_SUCCESS);
+            }
+        }
+
+        PEGASUS_TEST_ASSERT(consumer.waitFor(2 * INDICATIONS));
+        binary.stop();
+
+        PEGASUS_TEST_ASSERT(consumer.getErrors() == 0);
+
+        // A new connection starts with CIM-XML again
+        client.disconnect();
+        PEGASUS_TEST_ASSERT(!client.isBinaryExport());
+
+        listener.stop();
+        listener.removeConsumer(&consumer);
+
+        _report("xml", xml.getElapsedUsec());
+        _report("binary-batched", binary.getElapsedUsec());
+    }
+    catch (Exception& e)
+    {
+        cerr << "Error: " << e.getMessage() << endl;
+        return 1;
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
@@ -956,6 +956,11 @@ CIMResponseMessage* ProviderAgentContainer::_processMessage(
         //
         // Wait for the response
         //
+        // The response is read by the _responseProcessor, which may still
+        // wait for a thread of the pool
+        ThreadPool* threadPool = MessageQueueService::get_thread_pool();
+        Boolean waiting = threadPool->beginWait();
+
         try
         {
             // Must not hold _agentMutex while waiting for the response
@@ -963,6 +968,11 @@ CIMResponseMessage* ProviderAgentContainer::_processMessage(
         }
         catch (...)
         {
+            if (waiting)
+            {
+                threadPool->endWait();
+            }
+
             // Remove the OutstandingRequestTable entry for this request
             {
                 AutoMutex tableLock(_outstandingRequestTableMutex);
@@ -974,6 +984,11 @@ CIMResponseMessage* ProviderAgentContainer::_processMessage(
             throw;
         }
 
+        if (waiting)
+        {
+            threadPool->endWait();
+        }
+
         // A response value of _REQUEST_NOT_PROCESSED indicates that the
         // provider agent process was terminating when the request was sent.
         // The request was not processed by the provider agent, so it can be
@@ -1248,8 +1263,32 @@ ProviderAgentContainer::_responseProcessor(void* arg)
     ProviderAgentContainer* pa =
         reinterpret_cast<ProviderAgentContainer*>(arg);
 
+    // This thread waits for the agent for as long as the agent runs, so
+    // it does not count toward the limit of the thread pool
+    ThreadPool* threadPool = MessageQueueService::get_thread_pool();
+    Boolean waiting = threadPool->beginWait();
+
+    // The response chunks read by this thread belong to all the requests
+    // to the agent, so their receivers must not hold the thread back
+    Thread* myself = Thread::getCurrent();
+    if (myself)
+    {
+        myself->put_tsd(
+            TSD_SHARED_RESPONSE_THREAD, 0, sizeof(Boolean), (void*) 1);
+    }
+
     pa->_processResponses();
 
+    if (myself)
+    {
+        myself->delete_tsd(TSD_SHARED_RESPONSE_THREAD);
+    }
+
+    if (waiting)
+    {
+        threadPool->endWait();
+    }
+
     return ThreadReturnType(0);
 }
 
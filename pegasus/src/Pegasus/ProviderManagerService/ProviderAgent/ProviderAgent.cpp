@@ -35,6 +35,7 @@
 #include <Pegasus/Common/CIMMessageSerializer.h>
 #include <Pegasus/Common/CIMMessageDeserializer.h>
 #include <Pegasus/Common/Tracer.h>
+#include <Pegasus/Common/StringConversion.h>
 #include <Pegasus/Config/ConfigManager.h>
 #include <Pegasus/Common/OperationContext.h>
 #include <Pegasus/ProviderManager2/Default/DefaultProviderManager.h>
@@ -429,6 +430,14 @@ Boolean ProviderAgent::_readAndProcessRequest()
 #endif
         System::bindVerbose = ipaRequest->bindVerbose;
 
+        // Size the SCMOClass cache as configured for the cimserver
+        Uint64 scmoClassCacheSize = PEGASUS_DEFAULT_SCMO_CLASS_CACHE_SIZE;
+        StringConversion::decimalStringToUint64(
+            configManager->getCurrentValue("scmoClassCacheSize").getCString(),
+            scmoClassCacheSize);
+        SCMOClassCache::getInstance()->setCapacity(
+            (Uint32)scmoClassCacheSize);
+
         //
         //  Set _subscriptionInitComplete from value in
         //  InitializeProviderAgent request
@@ -352,6 +352,14 @@ void ProviderManagerService::handleCimRequest(
                 // Forward the request to the appropriate ProviderManagerRouter
                 //
                 response.reset(_processMessage(request));
+
+#ifndef PEGASUS_DISABLE_PERFINST
+                if (StatisticalData::current()->copyGSD &&
+                    dynamic_cast<CIMOperationRequestMessage*>(request))
+                {
+                    _addModuleStatistics(providerModule, response.get());
+                }
+#endif
             }
         }
         else if (request->getType() == CIM_ENABLE_MODULE_REQUEST_MESSAGE)
@@ -545,6 +553,25 @@ void ProviderManagerService::responseChunkCallback(
     PEG_METHOD_EXIT();
 }
 
+#ifndef PEGASUS_DISABLE_PERFINST
+void ProviderManagerService::_addModuleStatistics(
+    const CIMInstance& providerModule,
+    Message* response)
+{
+    CIMResponseMessage* cimResponse =
+        dynamic_cast<CIMResponseMessage*>(response);
+    Uint32 pos = providerModule.findProperty(PEGASUS_PROPERTYNAME_NAME);
+
+    if (cimResponse && (pos != PEG_NOT_FOUND))
+    {
+        String moduleName;
+        providerModule.getProperty(pos).getValue().get(moduleName);
+        StatisticalData::current()->addToModuleValue(
+            moduleName, cimResponse->getProviderTime());
+    }
+}
+#endif
+
 Message* ProviderManagerService::_processMessage(CIMRequestMessage* request)
 {
     Message* response = 0;
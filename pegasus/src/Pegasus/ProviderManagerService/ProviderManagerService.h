@@ -86,6 +86,14 @@ private:
 
     Message* _processMessage(CIMRequestMessage* request);
 
+#ifndef PEGASUS_DISABLE_PERFINST
+    // Records the provider time of the response in the histogram of the
+    // provider module
+    void _addModuleStatistics(
+        const CIMInstance& providerModule,
+        Message* response);
+#endif
+
     static ThreadReturnType PEGASUS_THREAD_CDECL
         _unloadIdleProvidersHandler(void* arg) throw();
 
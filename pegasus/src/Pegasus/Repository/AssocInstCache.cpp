@@ -0,0 +1,333 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+
+#include <Pegasus/Common/Config.h>
+#include "AssocInstCache.h"
+
+PEGASUS_USING_STD;
+
+PEGASUS_NAMESPACE_BEGIN
+
+typedef HashTable<String, Boolean, EqualFunc<String>, HashFunc<String> >
+    NameSetType;
+
+static inline Boolean _MatchNoCase(const String& x, const String& pattern)
+{
+    return pattern.size() == 0 || String::equalNoCase(x, pattern);
+}
+
+//
+// Appends the name to the result unless it is already in the set of names
+// returned so far.  The set is built from the result on first use, so that
+// names which were in the result before the call are not duplicated either.
+//
+
+static void _AppendUnique(
+    Array<String>& names,
+    NameSetType& nameSet,
+    const String& name)
+{
+    if (nameSet.size() == 0)
+    {
+        for (Uint32 i = 0; i < names.size(); i++)
+            nameSet.insert(names[i], true);
+    }
+
+    if (nameSet.insert(name, true))
+        names.append(name);
+}
+
+//
+// The hash tables do not grow by themselves, so they are rebuilt with more
+// chains when the number of entries exceeds twice the number of chains.
+//
+
+template<class TABLE>
+static void _GrowTable(TABLE& table, Uint32& numChains)
+{
+    if (table.size() <= 2 * numChains)
+        return;
+
+    numChains *= 4;
+    TABLE newTable(numChains);
+
+    for (typename TABLE::Iterator i = table.start(); i; i++)
+        newTable.insert(i.key(), i.value());
+
+    table = newTable;
+}
+
+AssocInstCacheManager::AssocInstCacheManager()
+{
+}
+
+AssocInstCacheManager::~AssocInstCacheManager()
+{
+    for (Uint32 i = _assocInstCacheList.size(); i > 0; i--)
+    {
+        delete _assocInstCacheList[i-1];
+        _assocInstCacheList.remove(i-1);
+    }
+}
+
+/**
+    Retrieves a singleton instance of the instance association cache for the
+    given namespace.
+*/
+AssocInstCache* AssocInstCacheManager::getAssocInstCache(
+    const String& nameSpace)
+{
+    for (Uint32 i = 0; i < _assocInstCacheList.size(); i++)
+    {
+        if (nameSpace == _assocInstCacheList[i]->getNameSpace())
+        {
+            return _assocInstCacheList[i];
+        }
+    }
+
+    // If we got here, no cache exists for the given namespace so far,
+    // so we will create a new one.
+    AssocInstCache* newCache = new AssocInstCache(nameSpace);
+    _assocInstCacheList.append(newCache);
+
+    return newCache;
+}
+
+void AssocInstCacheManager::removeAssocInstCache(const String& nameSpace)
+{
+    for (Uint32 i = 0; i < _assocInstCacheList.size(); i++)
+    {
+        if (nameSpace == _assocInstCacheList[i]->getNameSpace())
+        {
+            delete _assocInstCacheList[i];
+            _assocInstCacheList.remove(i);
+            return;
+        }
+    }
+}
+
+Boolean AssocInstCache::getAssociatorNames(
+    const CIMObjectPath& objectName,
+    const Array<CIMName>& assocClassList,
+    const Array<CIMName>& resultClassList,
+    const String& role,
+    const String& resultRole,
+    Array<String>& associatorNames)
+{
+    Array<InstanceAssociation>* records;
+
+    if (!_fromObjectTable.lookupReference(objectName, records))
+        return false;
+
+    NameSetType nameSet;
+    Boolean found = false;
+
+    for (Uint32 i = 0, n = records->size(); i < n; i++)
+    {
+        const InstanceAssociation& record = (*records)[i];
+
+        // Process associations with the right roles
+        if (!_MatchNoCase(record.fromPropertyName.getString(), role) ||
+            !_MatchNoCase(record.toPropertyName.getString(), resultRole))
+        {
+            continue;
+        }
+
+        // Skip classes that do not appear in the association class list
+        if ((assocClassList.size() != 0) &&
+            (!Contains(assocClassList, record.assocClassName)))
+        {
+            continue;
+        }
+
+        // Skip classes that do not appear in the result class list
+        if ((resultClassList.size() != 0) &&
+            (!Contains(resultClassList, record.toClassName)))
+        {
+            continue;
+        }
+
+        // This object qualifies; add it to the list (skipping duplicates)
+        _AppendUnique(associatorNames, nameSet, record.toInstanceName);
+        found = true;
+    }
+
+    return found;
+}
+
+Boolean AssocInstCache::getReferenceNames(
+    const CIMObjectPath& objectName,
+    const Array<CIMName>& resultClassList,
+    const String& role,
+    Array<String>& referenceNames)
+{
+    Array<InstanceAssociation>* records;
+
+    if (!_fromObjectTable.lookupReference(objectName, records))
+        return false;
+
+    NameSetType nameSet;
+    Boolean found = false;
+
+    for (Uint32 i = 0, n = records->size(); i < n; i++)
+    {
+        const InstanceAssociation& record = (*records)[i];
+
+        // Process associations with the right role
+        if (!_MatchNoCase(record.fromPropertyName.getString(), role))
+            continue;
+
+        // Skip classes that do not appear in the result class list
+        if ((resultClassList.size() != 0) &&
+            (!Contains(resultClassList, record.assocClassName)))
+        {
+            continue;
+        }
+
+        // This instance qualifies; add it to the list (skipping duplicates)
+        _AppendUnique(referenceNames, nameSet, record.assocInstanceName);
+        found = true;
+    }
+
+    return found;
+}
+
+/** Add a new record to the association cache.
+    The record is appended to the records of its from object and the from
+    object is remembered for its association instance.
+*/
+void AssocInstCache::addRecord(const InstanceAssociation& record)
+{
+    CIMObjectPath fromObjectName(record.fromInstanceName);
+    CIMObjectPath assocInstanceName(record.assocInstanceName);
+
+    Array<InstanceAssociation>* records;
+
+    if (_fromObjectTable.lookupReference(fromObjectName, records))
+    {
+        records->append(record);
+    }
+    else
+    {
+        Array<InstanceAssociation> newRecords;
+        newRecords.append(record);
+        _fromObjectTable.insert(fromObjectName, newRecords);
+        _GrowTable(_fromObjectTable, _fromObjectTableChains);
+    }
+
+    Array<CIMObjectPath>* fromObjectNames;
+
+    if (_assocInstanceTable.lookupReference(
+            assocInstanceName, fromObjectNames))
+    {
+        if (!Contains(*fromObjectNames, fromObjectName))
+            fromObjectNames->append(fromObjectName);
+    }
+    else
+    {
+        Array<CIMObjectPath> newFromObjectNames;
+        newFromObjectNames.append(fromObjectName);
+        _assocInstanceTable.insert(assocInstanceName, newFromObjectNames);
+        _GrowTable(_assocInstanceTable, _assocInstanceTableChains);
+    }
+}
+
+/** Remove all records of the given association instance from the cache.
+*/
+Boolean AssocInstCache::removeAssociation(
+    const CIMObjectPath& assocInstanceName)
+{
+    Array<CIMObjectPath> fromObjectNames;
+
+    if (!_assocInstanceTable.lookup(assocInstanceName, fromObjectNames))
+        return false;
+
+    _assocInstanceTable.remove(assocInstanceName);
+
+    for (Uint32 i = 0; i < fromObjectNames.size(); i++)
+    {
+        Array<InstanceAssociation>* records;
+
+        if (!_fromObjectTable.lookupReference(fromObjectNames[i], records))
+            continue;
+
+        for (Uint32 j = records->size(); j > 0; j--)
+        {
+            if (assocInstanceName == (*records)[j-1].assocInstanceName)
+                records->remove(j-1);
+        }
+
+        if (records->size() == 0)
+            _fromObjectTable.remove(fromObjectNames[i]);
+    }
+
+    return true;
+}
+
+Boolean AssocInstCache::containsAssociation(
+    const CIMObjectPath& assocInstanceName)
+{
+    return _assocInstanceTable.contains(assocInstanceName);
+}
+
+/** Check if the cache is loaded with objects already.
+*/
+Boolean AssocInstCache::isActive()
+{
+    return _isInitialized;
+}
+
+void AssocInstCache::setActive(Boolean flag)
+{
+    _isInitialized = flag;
+}
+
+void AssocInstCache::clear()
+{
+    _fromObjectTable.clear();
+    _assocInstanceTable.clear();
+    _isInitialized = false;
+}
+
+AssocInstCache::~AssocInstCache()
+{
+}
+
+AssocInstCache::AssocInstCache(const String& nameSpace)
+    : _nameSpace(nameSpace),
+      _isInitialized(false),
+      _fromObjectTable(1000),
+      _fromObjectTableChains(1000),
+      _assocInstanceTable(1000),
+      _assocInstanceTableChains(1000)
+{
+}
+
+PEGASUS_NAMESPACE_END
@@ -0,0 +1,154 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+
+#ifndef Pegasus_AssocInstCache_h
+#define Pegasus_AssocInstCache_h
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/String.h>
+#include <Pegasus/Common/CIMName.h>
+#include <Pegasus/Common/CIMObjectPath.h>
+#include <Pegasus/Common/ArrayInternal.h>
+#include <Pegasus/Common/HashTable.h>
+#include <Pegasus/Repository/PersistentStoreData.h>
+#include <Pegasus/Repository/Linkage.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+class AssocInstCache;
+
+/** Maintains instance association caches for all namespaces.
+*/
+class PEGASUS_REPOSITORY_LINKAGE AssocInstCacheManager
+{
+public:
+
+    AssocInstCacheManager();
+    ~AssocInstCacheManager();
+
+    /** Retrieves the instance association cache for the given namespace.
+    */
+    AssocInstCache* getAssocInstCache(const String& nameSpace);
+
+    /** Deletes the instance association cache for the given namespace,
+        if there is one.
+    */
+    void removeAssocInstCache(const String& nameSpace);
+
+private:
+
+    Array<AssocInstCache*> _assocInstCacheList;
+};
+
+/** Maintains a cache for all instance associations in a namespace.  The
+    associations are indexed by the name of the object they lead from, so
+    that the associators and references of an object are found without
+    looking at the associations of any other object.
+*/
+class PEGASUS_REPOSITORY_LINKAGE AssocInstCache
+{
+public:
+
+    AssocInstCache(const String& nameSpace);
+    ~AssocInstCache();
+
+    const String& getNameSpace()
+    {
+        return _nameSpace;
+    }
+
+    /** Finds the associators of the given object. See
+        AssocInstTable::getAssociatorNames() for a full description.
+    */
+    Boolean getAssociatorNames(
+        const CIMObjectPath& objectName,
+        const Array<CIMName>& assocClassList,
+        const Array<CIMName>& resultClassList,
+        const String& role,
+        const String& resultRole,
+        Array<String>& associatorNames);
+
+    /** Finds the references of the given object. See
+        AssocInstTable::getReferenceNames() for a full description.
+    */
+    Boolean getReferenceNames(
+        const CIMObjectPath& objectName,
+        const Array<CIMName>& resultClassList,
+        const String& role,
+        Array<String>& referenceNames);
+
+    /** Add a new association record to the cache.
+    */
+    void addRecord(const InstanceAssociation& record);
+
+    /** Remove all records of the given association instance from the cache.
+        @returns true if such an association was found.
+    */
+    Boolean removeAssociation(const CIMObjectPath& assocInstanceName);
+
+    /** Check if the cache holds records of the given association instance.
+    */
+    Boolean containsAssociation(const CIMObjectPath& assocInstanceName);
+
+    /** Check if the cache is loaded with objects already.
+    */
+    Boolean isActive();
+    void setActive(Boolean flag);
+
+    /** Remove all records from the cache and mark it inactive.
+    */
+    void clear();
+
+private:
+
+    String _nameSpace;
+    Boolean _isInitialized;
+
+    typedef HashTable<CIMObjectPath, Array<InstanceAssociation>,
+        EqualFunc<CIMObjectPath>, HashFunc<CIMObjectPath> >
+        FromObjectTableType;
+
+    typedef HashTable<CIMObjectPath, Array<CIMObjectPath>,
+        EqualFunc<CIMObjectPath>, HashFunc<CIMObjectPath> >
+        AssocInstanceTableType;
+
+    // Association records keyed by the name of the object they lead from.
+    FromObjectTableType _fromObjectTable;
+    Uint32 _fromObjectTableChains;
+
+    // Names of the objects each association instance leads from, used to
+    // find the records to remove when the association is deleted.
+    AssocInstanceTableType _assocInstanceTable;
+    Uint32 _assocInstanceTableChains;
+};
+
+PEGASUS_NAMESPACE_END
+
+#endif /* Pegasus_AssocInstCache_h */
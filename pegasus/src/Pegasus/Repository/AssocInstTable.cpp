@@ -34,6 +34,7 @@
 #include <Pegasus/Common/InternalException.h>
 #include <Pegasus/Common/FileSystem.h>
 #include <Pegasus/Common/Exception.h>
+#include <Pegasus/Common/CIMNameCast.h>
 #include "AssocInstTable.h"
 
 PEGASUS_USING_STD;
@@ -50,26 +51,6 @@ PEGASUS_NAMESPACE_BEGIN
 #define TO_PROPERTY_NAME_INDEX 7
 #define NUM_FIELDS 8
 
-static inline Boolean _MatchNoCase(const String& x, const String& pattern)
-{
-    return pattern.size() == 0 || String::equalNoCase(x, pattern);
-}
-
-static inline Boolean _ContainsClass(
-    const Array<CIMName>& classNames,
-    const String& match)
-{
-    Uint32 n = classNames.size();
-
-    for (Uint32 i = 0; i < n; i++)
-    {
-        if (_MatchNoCase(classNames[i].getString(), match))
-            return true;
-    }
-
-    return false;
-}
-
 static String _Escape(const String& str)
 {
     String result;
@@ -189,8 +170,22 @@ static void _PutRecord(ofstream& os, Array<String>& fields)
     os << endl;
 }
 
+static InstanceAssociation _MakeRecord(const Array<String>& fields)
+{
+    return InstanceAssociation(
+        fields[ASSOC_INSTANCE_NAME_INDEX],
+        CIMNameCast(fields[ASSOC_CLASS_NAME_INDEX]),
+        fields[FROM_OBJECT_NAME_INDEX],
+        CIMNameCast(fields[FROM_CLASS_NAME_INDEX]),
+        CIMNameCast(fields[FROM_PROPERTY_NAME_INDEX]),
+        fields[TO_OBJECT_NAME_INDEX],
+        CIMNameCast(fields[TO_CLASS_NAME_INDEX]),
+        CIMNameCast(fields[TO_PROPERTY_NAME_INDEX]));
+}
+
 void AssocInstTable::append(
     PEGASUS_STD(ofstream)& os,
+    const String& path,
     const String& assocInstanceName,
     const CIMName& assocClassName,
     const String& fromInstanceName,
@@ -212,6 +207,14 @@ void AssocInstTable::append(
     fields.append(toPropertyName.getString());
 
     _PutRecord(os, fields);
+
+    // Update cache
+    AutoMutex autoMut(_cacheMutex);
+    AssocInstCache* cache = _assocInstCacheManager.getAssocInstCache(path);
+    if (cache->isActive())
+    {
+        cache->addRecord(_MakeRecord(fields));
+    }
 }
 
 void AssocInstTable::append(
@@ -246,12 +249,32 @@ void AssocInstTable::append(
     fields.append(toPropertyName.getString());
 
     _PutRecord(os, fields);
+
+    // Update cache
+    AutoMutex autoMut(_cacheMutex);
+    AssocInstCache* cache = _assocInstCacheManager.getAssocInstCache(path);
+    if (cache->isActive())
+    {
+        cache->addRecord(_MakeRecord(fields));
+    }
 }
 
 Boolean AssocInstTable::deleteAssociation(
     const String& path,
     const CIMObjectPath& assocInstanceName)
 {
+    // The text format has no way to mark a record deleted, so removing an
+    // association rewrites the file.  Avoid that when the cache shows the
+    // association is not in the table.
+    {
+        AutoMutex autoMut(_cacheMutex);
+        AssocInstCache* cache = _assocInstCacheManager.getAssocInstCache(path);
+        if (cache->isActive() && !cache->containsAssociation(assocInstanceName))
+        {
+            return false;
+        }
+    }
+
     // Open input file:
 
     ifstream is;
@@ -283,6 +306,9 @@ Boolean AssocInstTable::deleteAssociation(
         if (assocInstanceName != fields[ASSOC_INSTANCE_NAME_INDEX])
         {
             _PutRecord(os, fields);
+        }
+        else
+        {
             found = true;
         }
     }
@@ -309,23 +335,35 @@ Boolean AssocInstTable::deleteAssociation(
         FileSystem::removeFile(path);
     }
 
+    // Update cache
+    AutoMutex autoMut(_cacheMutex);
+    AssocInstCache* cache = _assocInstCacheManager.getAssocInstCache(path);
+    if (cache->isActive())
+    {
+        cache->removeAssociation(assocInstanceName);
+    }
+
     return found;
 }
 
-Boolean AssocInstTable::getAssociatorNames(
-    const String& path,
-    const CIMObjectPath& instanceName,
-    const Array<CIMName>& assocClassList,
-    const Array<CIMName>& resultClassList,
-    const String& role,
-    const String& resultRole,
-    Array<String>& associatorNames)
+void AssocInstTable::invalidateCache(const String& path)
+{
+    AutoMutex autoMut(_cacheMutex);
+    _assocInstCacheManager.removeAssocInstCache(path);
+}
+
+AssocInstCache* AssocInstTable::_getCache(const String& path)
 {
+    AssocInstCache* cache = _assocInstCacheManager.getAssocInstCache(path);
+
+    if (cache->isActive())
+        return cache;
+
     // Open input file:
     ifstream is;
     if (!FileSystem::exists(path))
     {
-        return false;
+        return 0;
     }
 
     if (!Open(is, path))
@@ -334,91 +372,62 @@ Boolean AssocInstTable::getAssociatorNames(
     }
 
     Array<String> fields;
-    Boolean found = false;
 
     // For each line in the associations table:
     while (_GetRecord(is, fields))
     {
-        // Process associations from the right end object and with right roles
-        if (instanceName == fields[FROM_OBJECT_NAME_INDEX] &&
-            _MatchNoCase(fields[FROM_PROPERTY_NAME_INDEX], role) &&
-            _MatchNoCase(fields[TO_PROPERTY_NAME_INDEX], resultRole))
-        {
-            // Skip classes that do not appear in the association class list
-            if ((assocClassList.size() != 0) &&
-                (!_ContainsClass(assocClassList,
-                                 fields[ASSOC_CLASS_NAME_INDEX])))
-            {
-                continue;
-            }
-
-            // Skip classes that do not appear in the result class list
-            if ((resultClassList.size() != 0) &&
-                (!_ContainsClass(resultClassList,
-                                 fields[TO_CLASS_NAME_INDEX])))
-            {
-                continue;
-            }
-
-            // This class qualifies; add it to the list (skipping duplicates)
-            if (!Contains(associatorNames, fields[TO_OBJECT_NAME_INDEX]))
-            {
-                associatorNames.append(fields[TO_OBJECT_NAME_INDEX]);
-            }
-            found = true;
-        }
+        cache->addRecord(_MakeRecord(fields));
     }
 
-    return found;
+    cache->setActive(true);
+
+    return cache;
 }
 
-Boolean AssocInstTable::getReferenceNames(
+Boolean AssocInstTable::getAssociatorNames(
     const String& path,
     const CIMObjectPath& instanceName,
+    const Array<CIMName>& assocClassList,
     const Array<CIMName>& resultClassList,
     const String& role,
-    Array<String>& referenceNames)
+    const String& resultRole,
+    Array<String>& associatorNames)
 {
-    // Open input file:
-    ifstream is;
-    if (!FileSystem::exists(path))
-    {
+    AutoMutex autoMut(_cacheMutex);
+
+    AssocInstCache* cache = _getCache(path);
+
+    if (!cache)
         return false;
-    }
 
-    if (!Open(is, path))
-    {
-        throw CannotOpenFile(path);
-    }
+    return cache->getAssociatorNames(
+        instanceName,
+        assocClassList,
+        resultClassList,
+        role,
+        resultRole,
+        associatorNames);
+}
 
-    Array<String> fields;
-    Boolean found = false;
+Boolean AssocInstTable::getReferenceNames(
+    const String& path,
+    const CIMObjectPath& instanceName,
+    const Array<CIMName>& resultClassList,
+    const String& role,
+    Array<String>& referenceNames)
+{
+    AutoMutex autoMut(_cacheMutex);
 
-    // For each line in the associations table:
-    while (_GetRecord(is, fields))
-    {
-        // Process associations from the right end class and with right role
-        if (instanceName == fields[FROM_OBJECT_NAME_INDEX] &&
-            _MatchNoCase(fields[FROM_PROPERTY_NAME_INDEX], role))
-        {
-            // Skip classes that do not appear in the result class list
-            if ((resultClassList.size() != 0) &&
-                (!_ContainsClass(resultClassList,
-                                 fields[ASSOC_CLASS_NAME_INDEX])))
-            {
-                continue;
-            }
+    AssocInstCache* cache = _getCache(path);
 
-            // This instance qualifies; add it to the list (skipping duplicates)
-            if (!Contains(referenceNames, fields[ASSOC_INSTANCE_NAME_INDEX]))
-            {
-                referenceNames.append(fields[ASSOC_INSTANCE_NAME_INDEX]);
-            }
-            found = true;
-        }
-    }
+    if (!cache)
+        return false;
 
-    return found;
+    return cache->getReferenceNames(
+        instanceName,
+        resultClassList,
+        role,
+        referenceNames);
 }
 
 PEGASUS_NAMESPACE_END
@@ -38,22 +38,36 @@
 #include <Pegasus/Common/CIMObjectPath.h>
 #include <Pegasus/Common/String.h>
 #include <Pegasus/Common/ArrayInternal.h>
+#include <Pegasus/Common/Mutex.h>
+#include <Pegasus/Repository/AssocInstCache.h>
 #include <Pegasus/Repository/Linkage.h>
 
 PEGASUS_NAMESPACE_BEGIN
 
-/** Maintains all associations for a given namesspace.
+/** Handles persistent storage and lookup of instance association data.
+    The association table of a namespace is read into an AssocInstCache the
+    first time it is queried; later queries are answered from the cache,
+    which is kept up to date as associations are added and deleted.
 */
 class PEGASUS_REPOSITORY_LINKAGE AssocInstTable
 {
 public:
 
+    AssocInstTable()
+    {
+    }
+
+    ~AssocInstTable()
+    {
+    }
+
     /** Appends a row into the association table. There is no checking
         for duplicate entries (the caller ensures this). The case of
         the arguments doesn't matter. They are ignored during comparison.
     */
-    static void append(
+    void append(
         PEGASUS_STD(ofstream)& os,
+        const String& path,
         const String& assocInstanceName,
         const CIMName& assocClassName,
         const String& fromInstanceName,
@@ -67,7 +81,7 @@ public:
         for duplicate entries (the caller ensures this). The case of the
         arguments doesn't matter. Case is ignored during comparison.
     */
-    static void append(
+    void append(
         const String& path,
         const String& assocInstanceName,
         const CIMName& assocClassName,
@@ -82,14 +96,14 @@ public:
         with an assocInstanceName equal to the assocInstanceName parameter.
         @returns true if such an association was found.
     */
-    static Boolean deleteAssociation(
+    Boolean deleteAssociation(
         const String& path,
         const CIMObjectPath& assocInstanceName);
 
     /** Finds all associators of the given object. See
         CIMOperations::associators() for a full description.
     */
-    static Boolean getAssociatorNames(
+    Boolean getAssociatorNames(
         const String& path,
         const CIMObjectPath& objectName,
         const Array<CIMName>& assocClassList,
@@ -102,16 +116,31 @@ public:
         given object is involved. See CIMOperations::associators() for a
         full description.
     */
-    static Boolean getReferenceNames(
+    Boolean getReferenceNames(
         const String& path,
         const CIMObjectPath& objectName,
         const Array<CIMName>& resultClassList,
         const String& role,
         Array<String>& referenceNames);
 
+    /** Discards the cache of the given association table, e.g. because
+        its namespace has been deleted.
+    */
+    void invalidateCache(const String& path);
+
 private:
 
-    AssocInstTable() { /* private */ }
+    /** Returns the cache for the given association table, loading it from
+        the file first if necessary.  Returns 0 if the file does not exist.
+        Must be called with _cacheMutex held.
+    */
+    AssocInstCache* _getCache(const String& path);
+
+    AssocInstCacheManager _assocInstCacheManager;
+
+    // Queries are made concurrently under the repository's read lock, so the
+    // caches are loaded and accessed under this mutex.
+    Mutex _cacheMutex;
 };
 
 PEGASUS_NAMESPACE_END
@@ -42,7 +42,10 @@
 #include <Pegasus/Common/PegasusVersion.h>
 #include <Pegasus/Common/MessageLoader.h>
 #include <Pegasus/Common/ReadWriteSem.h>
+#include <Pegasus/Common/AtomicInt.h>
 #include <Pegasus/Common/SCMOClassCache.h>
+#include <Pegasus/Common/StringConversion.h>
+#include <Pegasus/Common/Constants.h>
 
 #include <Pegasus/Repository/XmlStreamer.h>
 #include <Pegasus/Repository/BinaryStreamer.h>
@@ -64,15 +67,23 @@
 
 //==============================================================================
 //
-// The class cache caches up PEGASUS_CLASS_CACHE_SIZE fully resolved class
-// definitions in memory.  To override the default, define
-// PEGASUS_CLASS_CACHE_SIZE in your build environment.  To suppress the cache
-// (and not compile it in at all), set PEGASUS_CLASS_CACHE_SIZE to 0.
+// The class cache caches up to PEGASUS_CLASS_CACHE_SIZE class definitions
+// in memory.  Besides the fully resolved class, the variants returned for
+// getClass requests without a property list (local only, without qualifiers
+// or without class origin) are cached under their own keys, each counting
+// as one entry.  Up to PEGASUS_MAX_REPOSITORY_CLASS_VARIANTS variants are
+// cached per class; since a variant is a stripped copy of the complete
+// class, this bounds the memory of the variants by a multiple of the memory
+// of the complete classes.  The CIM Server sets the size from the
+// repositoryClassCacheSize config property.  To override the default,
+// define PEGASUS_CLASS_CACHE_SIZE in your build environment.  To suppress
+// the cache (and not compile it in at all), set PEGASUS_CLASS_CACHE_SIZE
+// to 0.
 //
 //==============================================================================
 
 #if !defined(PEGASUS_CLASS_CACHE_SIZE)
-# define PEGASUS_CLASS_CACHE_SIZE 8
+# define PEGASUS_CLASS_CACHE_SIZE PEGASUS_DEFAULT_REPOSITORY_CLASS_CACHE_SIZE
 #endif
 
 #if (PEGASUS_CLASS_CACHE_SIZE != 0)
@@ -137,9 +148,16 @@ public:
 
 #ifdef PEGASUS_USE_CLASS_CACHE
     ObjectCache<CIMClass> _classCache;
+
+    // Serializes the check of the number of cached variants of a class with
+    // the caching of another variant.
+    Mutex _classVariantMutex;
 #endif /* PEGASUS_USE_CLASS_CACHE */
 
     ObjectCache<CIMQualifierDecl> _qualifierCache;
+
+    // Incremented on every change to the class definitions.
+    AtomicInt _classChangeCount;
 };
 
 static String _getCacheKey(
@@ -152,6 +170,80 @@ static String _getCacheKey(
     return key;
 }
 
+#ifdef PEGASUS_USE_CLASS_CACHE
+
+// Flags which select a cached variant of a class.  The complete class
+// (not local only, with qualifiers and class origin) uses the plain
+// _getCacheKey() key.
+enum
+{
+    CLASS_VARIANT_LOCAL_ONLY = 1,
+    CLASS_VARIANT_NO_QUALIFIERS = 2,
+    CLASS_VARIANT_NO_CLASS_ORIGIN = 4,
+    NUM_CLASS_VARIANTS = 8
+};
+
+static String _getClassVariantCacheKey(
+    const CIMNamespaceName& nameSpace,
+    const CIMName& className,
+    Uint32 variant)
+{
+    String key = _getCacheKey(nameSpace, className);
+
+    if (variant)
+    {
+        key.append('#');
+        key.append(Char16('0' + variant));
+    }
+
+    return key;
+}
+
+// Caches a variant of a class unless the class already has the maximum
+// number of variants cached.  These are replaced by new ones only once they
+// are evicted as least recently used.
+static void _putClassVariant(
+    ObjectCache<CIMClass>& classCache,
+    Mutex& variantMutex,
+    const CIMNamespaceName& nameSpace,
+    const CIMName& className,
+    Uint32 variant,
+    const String& variantCacheKey,
+    CIMClass& cimClass,
+    Boolean clone)
+{
+    AutoMutex autoMut(variantMutex);
+    Uint32 numVariants = 0;
+
+    for (Uint32 i = 1; i < NUM_CLASS_VARIANTS; i++)
+    {
+        if (i != variant && classCache.contains(
+                _getClassVariantCacheKey(nameSpace, className, i)))
+        {
+            numVariants++;
+        }
+    }
+
+    if (numVariants < PEGASUS_MAX_REPOSITORY_CLASS_VARIANTS)
+    {
+        classCache.put(variantCacheKey, cimClass, clone);
+    }
+}
+
+static void _evictClassVariants(
+    ObjectCache<CIMClass>& classCache,
+    const CIMNamespaceName& nameSpace,
+    const CIMName& className)
+{
+    for (Uint32 variant = 0; variant < NUM_CLASS_VARIANTS; variant++)
+    {
+        classCache.evict(
+            _getClassVariantCacheKey(nameSpace, className, variant));
+    }
+}
+
+#endif /* PEGASUS_USE_CLASS_CACHE */
+
 
 //
 //  The following _xx functions are local to the repository implementation
@@ -699,6 +791,15 @@ CIMRepository::CIMRepository(
     _rep->_lockFile = ConfigManager::getInstance()->getHomedPath(
         PEGASUS_REPOSITORY_LOCK_FILE).getCString();
 
+#ifdef PEGASUS_USE_CLASS_CACHE
+    Uint64 classCacheSize = PEGASUS_CLASS_CACHE_SIZE;
+    StringConversion::decimalStringToUint64(
+        ConfigManager::getInstance()->getCurrentValue(
+            "repositoryClassCacheSize").getCString(),
+        classCacheSize);
+    _rep->_classCache.setMaxEntries((size_t)classCacheSize);
+#endif /* PEGASUS_USE_CLASS_CACHE */
+
     _rep->_persistentStore.reset(PersistentStore::createPersistentStore(
         repositoryRoot,
         _rep->_streamer.get(),
@@ -838,6 +939,36 @@ CIMClass CIMRepository::_getClass(
     Boolean classIncludesPropagatedElements = true;
 
 #ifdef PEGASUS_USE_CLASS_CACHE
+    // Requests without a property list are answered from the cached variant
+    // for their combination of flags, if there is one.  A variant is never
+    // modified once it is cached, so it is shared with the caller when no
+    // clone is requested.
+
+    Uint32 variant = 0;
+    String variantCacheKey;
+
+    if (propertyList.isNull())
+    {
+        if (localOnly)
+            variant |= CLASS_VARIANT_LOCAL_ONLY;
+        if (!includeQualifiers)
+            variant |= CLASS_VARIANT_NO_QUALIFIERS;
+        if (!includeClassOrigin)
+            variant |= CLASS_VARIANT_NO_CLASS_ORIGIN;
+
+        if (variant)
+        {
+            variantCacheKey =
+                _getClassVariantCacheKey(nameSpace, className, variant);
+
+            if (_rep->_classCache.get(variantCacheKey, cimClass, clone))
+            {
+                PEG_METHOD_EXIT();
+                return cimClass;
+            }
+        }
+    }
+
     // Check the cache first.  Note that the cache contains complete class
     // definitions including propagated elements.
 
@@ -942,6 +1073,16 @@ CIMClass CIMRepository::_getClass(
             cimClass.getMethod(i).setClassOrigin(CIMName());
     }
 
+#ifdef PEGASUS_USE_CLASS_CACHE
+    if (variant)
+    {
+        // cimClass was cloned above, so it is not shared with the complete
+        // class in the cache.
+        _putClassVariant(_rep->_classCache, _rep->_classVariantMutex,
+            nameSpace, className, variant, variantCacheKey, cimClass, clone);
+    }
+#endif
+
     PEG_METHOD_EXIT();
     return cimClass;
 }
@@ -1066,6 +1207,7 @@ void CIMRepository::deleteClass(
 
     WriteLock lock(_rep->_lock);
     AutoFileLock fileLock(_rep->_lockFile);
+    _rep->_classChangeCount++;
 
     //
     // Get the class and check to see if it is an association class.
@@ -1099,7 +1241,7 @@ void CIMRepository::deleteClass(
 
 #ifdef PEGASUS_USE_CLASS_CACHE
 
-    _rep->_classCache.evict(_getCacheKey(nameSpace, className));
+    _evictClassVariants(_rep->_classCache, nameSpace, className);
 
 #endif /* PEGASUS_USE_CLASS_CACHE */
 
@@ -1155,6 +1297,7 @@ void CIMRepository::createClass(
 
     WriteLock lock(_rep->_lock);
     AutoFileLock fileLock(_rep->_lockFile);
+    _rep->_classChangeCount++;
     _createClass(nameSpace, newClass);
 
     PEG_METHOD_EXIT();
@@ -1291,6 +1434,7 @@ void CIMRepository::modifyClass(
 
     WriteLock lock(_rep->_lock);
     AutoFileLock fileLock(_rep->_lockFile);
+    _rep->_classChangeCount++;
     _modifyClass(nameSpace, modifiedClass);
 
     PEG_METHOD_EXIT();
@@ -1751,6 +1895,52 @@ Array<CIMInstance> CIMRepository::enumerateInstancesForClass(
     return namedInstances;
 }
 
+void CIMRepository::enumerateInstancesForClass(
+    const CIMNamespaceName& nameSpace,
+    const CIMName& className,
+    Uint32 batchSize,
+    InstanceBatchCallback callback,
+    void* userData)
+{
+    PEG_METHOD_ENTER(TRC_REPOSITORY,
+        "CIMRepository::enumerateInstancesForClass");
+
+    PEGASUS_ASSERT(batchSize > 0);
+
+    AutoPtr<InstanceEnumeration> enumeration;
+
+    {
+        ReadLock lock(_rep->_lock);
+
+        _rep->_nameSpaceManager.validateClass(nameSpace, className);
+
+        // The enumeration sees the instances as they are now.  The
+        // instance files are only appended to or replaced while the write
+        // lock is held, so the lock is not needed to read them.
+        enumeration.reset(_rep->_persistentStore->openInstanceEnumeration(
+            nameSpace, className));
+    }
+
+    Array<CIMInstance> instances;
+
+    while (enumeration->next(batchSize, instances))
+    {
+        for (Uint32 i = 0; i < instances.size(); i++)
+        {
+            _filterInstance(instances[i], CIMPropertyList(), false, false);
+        }
+
+        if (!callback(instances, userData))
+        {
+            break;
+        }
+
+        instances.clear();
+    }
+
+    PEG_METHOD_EXIT();
+}
+
 Array<CIMObjectPath> CIMRepository::enumerateInstanceNamesForSubtree(
     const CIMNamespaceName& nameSpace,
     const CIMName& className)
@@ -2533,6 +2723,7 @@ void CIMRepository::deleteNameSpace(const CIMNamespaceName& nameSpace)
 
     WriteLock lock(_rep->_lock);
     AutoFileLock fileLock(_rep->_lockFile);
+    _rep->_classChangeCount++;
 
     // Check for dependent namespaces
 
@@ -2611,6 +2802,11 @@ Boolean CIMRepository::nameSpaceExists(const CIMNamespaceName& nameSpaceName)
     return _rep->_nameSpaceManager.nameSpaceExists(nameSpaceName);
 }
 
+Uint32 CIMRepository::getClassChangeCount()
+{
+    return _rep->_classChangeCount.get();
+}
+
 Boolean CIMRepository::isRemoteNameSpace(
     const CIMNamespaceName& nameSpaceName,
     String& remoteInfo)
@@ -2655,6 +2851,24 @@ void CIMRepository::getSuperClassNames(
         nameSpaceName, className, subClassNames);
 }
 
+void CIMRepository::getClassCacheStatistics(
+    Uint32& size,
+    Uint32& capacity,
+    Uint64& hits,
+    Uint64& misses,
+    Uint64& evictions)
+{
+#ifdef PEGASUS_USE_CLASS_CACHE
+    _rep->_classCache.getStatistics(size, capacity, hits, misses, evictions);
+#else
+    size = 0;
+    capacity = 0;
+    hits = 0;
+    misses = 0;
+    evictions = 0;
+#endif
+}
+
 Boolean CIMRepository::isDefaultInstanceProvider()
 {
     return _rep->_isDefaultInstanceProvider;
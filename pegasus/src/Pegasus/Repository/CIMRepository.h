@@ -174,6 +174,30 @@ public:
         Boolean includeClassOrigin = false,
         const CIMPropertyList& propertyList = CIMPropertyList());
 
+    /**
+        Receives one batch of the instances enumerated by the streaming form
+        of enumerateInstancesForClass().  Returns false to end the
+        enumeration.
+    */
+    typedef Boolean (*InstanceBatchCallback)(
+        const Array<CIMInstance>& instances,
+        void* userData);
+
+    /**
+        Enumerates the instances of just the specified class, without
+        qualifiers, class origin or property filtering, and passes them to
+        the callback in batches of at most batchSize instances.  The
+        instances are decoded a batch at a time, so the instances of a
+        large class are never all held in memory at once.  The repository
+        lock is not held while the callback runs.
+    */
+    void enumerateInstancesForClass(
+        const CIMNamespaceName& nameSpace,
+        const CIMName& className,
+        Uint32 batchSize,
+        InstanceBatchCallback callback,
+        void* userData);
+
 
     /**
         Enumerates the names of the instances of the specified class and its
@@ -340,6 +364,24 @@ public:
         const CIMNamespaceName& nameSpaceName,
         String& remoteInfo);
 
+    /** Returns a counter which changes whenever a class is created, modified
+        or deleted, or a namespace is deleted.  Components which keep data
+        derived from class definitions compare it with the value they saw
+        when the data was derived to find out whether it may be stale.
+    */
+    Uint32 getClassChangeCount();
+
+    /** Returns the number of class definitions in the class cache, its
+        maximum size and the numbers of cache hits, misses and entries
+        replaced since the repository was created.
+    */
+    void getClassCacheStatistics(
+        Uint32& size,
+        Uint32& capacity,
+        Uint64& hits,
+        Uint64& misses,
+        Uint64& evictions);
+
 #ifdef PEGASUS_DEBUG
     void DisplayCacheStatistics();
 #endif
@@ -1771,6 +1771,12 @@ void CIMRepository::getSuperClassNames(
     _getSuperClassNames(nameSpace, className, superClassNames);
 }
 
+Uint32 CIMRepository::getClassChangeCount()
+{
+    // Class definitions cannot be changed in the memory-resident repository.
+    return 0;
+}
+
 Boolean CIMRepository::isRemoteNameSpace(
     const CIMNamespaceName& nameSpace,
     String& remoteInfo)
@@ -43,9 +43,9 @@
 #include <Pegasus/Common/FileSystem.h>
 #include <Pegasus/Common/Dir.h>
 #include <Pegasus/Common/CommonUTF.h>
+#include <Pegasus/Common/AutoPtr.h>
 #include "InstanceIndexFile.h"
 #include "InstanceDataFile.h"
-#include "AssocInstTable.h"
 #include "FileBasedStore.h"
 
 #ifdef PEGASUS_ENABLE_COMPRESSED_REPOSITORY
@@ -892,77 +892,111 @@ Boolean FileBasedStore::_loadInstance(
     return true;
 }
 
-Boolean FileBasedStore::_loadAllInstances(
-    const CIMNamespaceName& nameSpace,
-    const CIMName& className,
-    Array<CIMInstance>& namedInstances)
-{
-    PEG_METHOD_ENTER(TRC_REPOSITORY, "FileBasedStore::_loadAllInstances");
-
-    Array<CIMObjectPath> instanceNames;
-    Buffer data;
-    Array<Uint32> indices;
-    Array<Uint32> sizes;
-
-    //
-    // Form the names of the instance index and data files
-    //
-
-    String indexFilePath = _getInstanceIndexFilePath(nameSpace, className);
-    String dataFilePath = _getInstanceDataFilePath(nameSpace, className);
-
-    //
-    // Enumerate the index file:
-    //
+////////////////////////////////////////////////////////////////////////////////
+//
+// FileInstanceEnumeration
+//
+//     Decodes the instances of a class from its mapped instance data file,
+//     one record at a time, in the order of the index file entries.
+//
+////////////////////////////////////////////////////////////////////////////////
 
-    Array<Uint32> freeFlags;
+class FileInstanceEnumeration : public InstanceEnumeration
+{
+public:
 
-    if (!InstanceIndexFile::enumerateEntries(
-            indexFilePath, freeFlags, indices, sizes, instanceNames, true))
+    FileInstanceEnumeration(ObjectStreamer* streamer) :
+        _streamer(streamer), _pos(0)
     {
-        PEG_METHOD_EXIT();
-        return false;
     }
 
-    //
-    // Form the array of instances result:
-    //
-
-    if (instanceNames.size() > 0)
+    Boolean open(const String& indexFilePath, const String& dataFilePath)
     {
-        //
-        // Load all instances from the data file:
-        //
+        Array<Uint32> freeFlags;
 
-        if (!InstanceDataFile::loadAllInstances(dataFilePath, data))
+        if (!InstanceIndexFile::enumerateEntries(indexFilePath,
+                freeFlags, _indices, _sizes, _instanceNames, false))
         {
-            PEG_METHOD_EXIT();
             return false;
         }
 
-        //
-        // for each instance loaded, call XML parser to parse the XML
-        // data and create a CIMInstance object.
-        //
+        if (_instanceNames.size() == 0)
+        {
+            return true;
+        }
 
-        CIMInstance tmpInstance;
+        return InstanceDataFile::mapAllInstances(dataFilePath, _dataFile);
+    }
 
-        const char* buffer = data.getData();
+    virtual Boolean next(Uint32 maxInstances, Array<CIMInstance>& instances)
+    {
+        if (_pos == _instanceNames.size())
+        {
+            return false;
+        }
 
-        for (Uint32 i = 0; i < instanceNames.size(); i++)
+        for (Uint32 n = 0; n < maxInstances && _pos < _instanceNames.size();
+             n++, _pos++)
         {
-            if (!freeFlags[i])
+            Uint32 index = _indices[_pos];
+            Uint32 size = _sizes[_pos];
+
+            if (index > _dataFile.getSize() ||
+                size > _dataFile.getSize() - index)
             {
-                Uint32 pos= (Uint32)((&(buffer[indices[i]]))-buffer);
-                _streamer->decode(data, pos, tmpInstance);
+                throw PEGASUS_CIM_EXCEPTION_L(CIM_ERR_FAILED,
+                    MessageLoaderParms(
+                        "Repository.CIMRepository.FAILED_TO_LOAD_INSTANCES",
+                        "Failed to load instances in class $0",
+                        _instanceNames[_pos].getClassName().getString()));
+            }
 
-                tmpInstance.setPath(instanceNames[i]);
+            // The streamers decode from a Buffer (and the XML parser modifies
+            // its input), so each record is copied out of the mapping.
 
-                namedInstances.append(tmpInstance);
-            }
+            _record.clear();
+            _record.append(_dataFile.getData() + index, size);
+
+            CIMInstance instance;
+            _streamer->decode(_record, 0, instance);
+            instance.setPath(_instanceNames[_pos]);
+            instances.append(instance);
         }
+
+        return true;
+    }
+
+private:
+
+    ObjectStreamer* _streamer;
+    Array<Uint32> _indices;
+    Array<Uint32> _sizes;
+    Array<CIMObjectPath> _instanceNames;
+    MappedFile _dataFile;
+    Buffer _record;
+    Uint32 _pos;
+};
+
+Boolean FileBasedStore::_loadAllInstances(
+    const CIMNamespaceName& nameSpace,
+    const CIMName& className,
+    Array<CIMInstance>& namedInstances)
+{
+    PEG_METHOD_ENTER(TRC_REPOSITORY, "FileBasedStore::_loadAllInstances");
+
+    FileInstanceEnumeration enumeration(_streamer);
+
+    if (!enumeration.open(
+            _getInstanceIndexFilePath(nameSpace, className),
+            _getInstanceDataFilePath(nameSpace, className)))
+    {
+        PEG_METHOD_EXIT();
+        return false;
     }
 
+    while (enumeration.next(PEG_NOT_FOUND, namedInstances))
+        ;
+
     PEG_METHOD_EXIT();
     return true;
 }
@@ -1218,6 +1252,9 @@ void FileBasedStore::deleteNameSpace(const CIMNamespaceName& nameSpace)
         throw CannotRemoveDirectory(nameSpacePath);
     }
 
+    InstanceIndexFile::invalidateCache(nameSpacePath);
+    _assocInstTable.invalidateCache(_getAssocInstPath(nameSpace));
+
     _nameSpacePathTable.remove(nameSpace.getString());
 
     PEG_METHOD_EXIT();
@@ -1541,6 +1578,7 @@ void FileBasedStore::deleteClass(
 
         FileSystem::removeFileNoCase(indexFilePath);
         FileSystem::removeFileNoCase(dataFilePath);
+        InstanceIndexFile::invalidateCache(indexFilePath);
     }
 
     // Remove class file
@@ -1631,6 +1669,32 @@ Array<CIMInstance> FileBasedStore::enumerateInstancesForClass(
     return cimInstances;
 }
 
+InstanceEnumeration* FileBasedStore::openInstanceEnumeration(
+    const CIMNamespaceName& nameSpace,
+    const CIMName& className)
+{
+    PEG_METHOD_ENTER(TRC_REPOSITORY,
+        "FileBasedStore::openInstanceEnumeration");
+
+    AutoPtr<FileInstanceEnumeration> enumeration(
+        new FileInstanceEnumeration(_streamer));
+
+    if (!enumeration->open(
+            _getInstanceIndexFilePath(nameSpace, className),
+            _getInstanceDataFilePath(nameSpace, className)))
+    {
+        PEG_METHOD_EXIT();
+        throw PEGASUS_CIM_EXCEPTION_L(CIM_ERR_FAILED,
+            MessageLoaderParms(
+                "Repository.CIMRepository.FAILED_TO_LOAD_INSTANCES",
+                "Failed to load instances in class $0",
+                className.getString()));
+    }
+
+    PEG_METHOD_EXIT();
+    return enumeration.release();
+}
+
 CIMInstance FileBasedStore::getInstance(
     const CIMNamespaceName& nameSpace,
     const CIMObjectPath& instanceName)
@@ -2049,8 +2113,9 @@ void FileBasedStore::_addInstanceAssociationEntries(
 
     for (Uint32 i = 0; i < instanceAssocEntries.size(); i++)
     {
-        AssocInstTable::append(
+        _assocInstTable.append(
             os,
+            assocFileName,
             instanceAssocEntries[i].assocInstanceName,
             instanceAssocEntries[i].assocClassName,
             instanceAssocEntries[i].fromInstanceName,
@@ -2072,7 +2137,7 @@ void FileBasedStore::_removeInstanceAssociationEntries(
         "FileBasedStore::_removeInstanceAssociationEntries");
 
     String assocFileName = _getAssocInstPath(nameSpace);
-    AssocInstTable::deleteAssociation(assocFileName, assocInstanceName);
+    _assocInstTable.deleteAssociation(assocFileName, assocInstanceName);
 
     PEG_METHOD_EXIT();
 }
@@ -2092,7 +2157,7 @@ void FileBasedStore::getInstanceAssociatorNames(
     String assocFileName = _getAssocInstPath(nameSpace);
 
     // ATTN: Return value is ignored.
-    AssocInstTable::getAssociatorNames(
+    _assocInstTable.getAssociatorNames(
         assocFileName,
         instanceName,
         assocClassList,
@@ -2117,7 +2182,7 @@ void FileBasedStore::getInstanceReferenceNames(
     String assocFileName = _getAssocInstPath(nameSpace);
 
     // ATTN: Return value is ignored.
-    AssocInstTable::getReferenceNames(
+    _assocInstTable.getReferenceNames(
         assocFileName,
         instanceName,
         resultClassList,
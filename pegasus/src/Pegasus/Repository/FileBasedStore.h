@@ -37,6 +37,7 @@
 #include <Pegasus/Repository/PersistentStore.h>
 #include <Pegasus/Repository/PersistentStoreData.h>
 #include <Pegasus/Repository/AssocClassTable.h>
+#include <Pegasus/Repository/AssocInstTable.h>
 #include <Pegasus/Repository/Linkage.h>
 
 PEGASUS_NAMESPACE_BEGIN
@@ -135,6 +136,9 @@ public:
     Array<CIMInstance> enumerateInstancesForClass(
         const CIMNamespaceName& nameSpace,
         const CIMName& className);
+    InstanceEnumeration* openInstanceEnumeration(
+        const CIMNamespaceName& nameSpace,
+        const CIMName& className);
     CIMInstance getInstance(
         const CIMNamespaceName& nameSpace,
         const CIMObjectPath& instanceName);
@@ -321,6 +325,7 @@ private:
         storage and lookup.
     */
     AssocClassTable _assocClassTable;
+    AssocInstTable _assocInstTable;
 };
 
 PEGASUS_NAMESPACE_END
@@ -172,6 +172,38 @@ Boolean InstanceDataFile::loadAllInstances(
     return true;
 }
 
+Boolean InstanceDataFile::mapAllInstances(
+    const String& path,
+    MappedFile& file)
+{
+    PEG_METHOD_ENTER(TRC_REPOSITORY, "InstanceDataFile::mapAllInstances()");
+
+    String realPath;
+
+    if (!FileSystem::existsNoCase(path, realPath))
+    {
+        PEG_METHOD_EXIT();
+        return false;
+    }
+
+    //
+    // A rollback file is left behind by a transaction that did not complete.
+    // The next transaction truncates the data file, which would invalidate
+    // the end of a mapping, so read the file instead.
+    //
+
+    Boolean map = !FileSystem::existsNoCase(path + ".rollback");
+
+    if (!file.open(realPath, map))
+    {
+        PEG_METHOD_EXIT();
+        return false;
+    }
+
+    PEG_METHOD_EXIT();
+    return true;
+}
+
 Boolean InstanceDataFile::appendInstance(
     const String& path,
     const Buffer& data,
@@ -38,6 +38,7 @@
 #include <Pegasus/Common/InternalException.h>
 #include <Pegasus/Common/CIMObjectPath.h>
 #include <Pegasus/Repository/Linkage.h>
+#include <Pegasus/Repository/MappedFile.h>
 #include <Pegasus/Common/Buffer.h>
 
 PEGASUS_NAMESPACE_BEGIN
@@ -115,6 +116,19 @@ public:
         const String& path,
         Buffer& data);
 
+    /** Makes all the instances of the data file accessible in memory
+        without reading them.  The file is mapped where the platform
+        supports it, unless an interrupted transaction may still truncate
+        it.
+
+        @param path the file path of the instance file
+        @param file the object which provides the contents of the file
+        @return true on success.
+    */
+    static Boolean mapAllInstances(
+        const String& path,
+        MappedFile& file);
+
     /** Appends a new instance to the end of the file.
 
         @param out the buffer containing the CIM/XML encoding of the
@@ -37,7 +37,11 @@
 #include <cstdlib>
 #include <Pegasus/Common/FileSystem.h>
 #include <Pegasus/Common/Tracer.h>
+#include <Pegasus/Common/HashTable.h>
+#include <Pegasus/Common/AutoPtr.h>
+#include <Pegasus/Common/Mutex.h>
 #include "InstanceIndexFile.h"
+#include "MappedFile.h"
 
 PEGASUS_USING_STD;
 
@@ -173,12 +177,11 @@ Boolean _GetIntField(
 }
 
 //
-// Gets the next record in the index file.
+// Splits a line of the index file into its fields.
 //
 
-static Boolean _GetNextRecord(
-    fstream& fs,
-    Buffer& line,
+static Boolean _ParseRecord(
+    const Buffer& line,
     Uint32& freeFlag,
     Uint32& hashCode,
     Uint32& index,
@@ -188,13 +191,6 @@ static Boolean _GetNextRecord(
 {
     errorOccurred = false;
 
-    //
-    // Get next line:
-    //
-
-    if (!GetLine(fs, line))
-        return false;
-
     //
     // Get the free flag field:
     //
@@ -240,6 +236,310 @@ static Boolean _GetNextRecord(
     return true;
 }
 
+//
+// Gets the next record in the index file.
+//
+
+static Boolean _GetNextRecord(
+    fstream& fs,
+    Buffer& line,
+    Uint32& freeFlag,
+    Uint32& hashCode,
+    Uint32& index,
+    Uint32& size,
+    const char*& instanceName,
+    Boolean& errorOccurred)
+{
+    errorOccurred = false;
+
+    if (!GetLine(fs, line))
+        return false;
+
+    return _ParseRecord(
+        line, freeFlag, hashCode, index, size, instanceName, errorOccurred);
+}
+
+//
+// Gets the next record from the contents of an index file in memory and
+// advances pos past it.  Only the current line is copied (into line).
+//
+
+static Boolean _GetNextRecord(
+    const char*& pos,
+    const char* end,
+    Buffer& line,
+    Uint32& freeFlag,
+    Uint32& hashCode,
+    Uint32& index,
+    Uint32& size,
+    const char*& instanceName,
+    Boolean& errorOccurred)
+{
+    errorOccurred = false;
+
+    if (pos >= end)
+        return false;
+
+    const char* eol = (const char*)memchr(pos, '\n', end - pos);
+    const char* lineEnd = eol ? eol : end;
+
+    line.clear();
+    line.append(pos, (Uint32)(lineEnd - pos));
+    pos = eol ? eol + 1 : end;
+
+    return _ParseRecord(
+        line, freeFlag, hashCode, index, size, instanceName, errorOccurred);
+}
+
+//
+// Returns the current position of the stream as an index file entry offset.
+//
+
+static inline Uint32 _getEntryOffset(fstream& fs)
+{
+#ifndef PEGASUS_OS_ZOS
+    return (Uint32)fs.tellp();
+#else
+    return getOffset(fs.tellp());
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// Index cache:
+//
+//     Maps the path of each index file read so far to an in-memory table of
+//     its non-free entries, keyed by instance name.  All access is serialized
+//     by _indexCacheMutex.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+struct IndexCacheEntry
+{
+    Uint32 index;
+    Uint32 size;
+    Uint32 entryOffset;
+};
+
+typedef HashTable<CIMObjectPath, IndexCacheEntry,
+    EqualFunc<CIMObjectPath>, HashFunc<CIMObjectPath> > IndexCacheEntryTable;
+
+class IndexCacheFile
+{
+public:
+
+    IndexCacheFile(Uint32 numEntries) : fileSize(0)
+    {
+        _create(numEntries);
+    }
+
+    Boolean lookup(const CIMObjectPath& instanceName, IndexCacheEntry*& entry)
+    {
+        return _entries->lookupReference(instanceName, entry);
+    }
+
+    Boolean contains(const CIMObjectPath& instanceName)
+    {
+        return _entries->contains(instanceName);
+    }
+
+    Boolean insert(
+        const CIMObjectPath& instanceName,
+        const IndexCacheEntry& entry)
+    {
+        // Grow the table so the chains stay short as instances are added.
+        if (_entries->size() >= 2 * _numChains)
+        {
+            AutoPtr<IndexCacheEntryTable> oldEntries(_entries.release());
+            _create(oldEntries->size());
+
+            for (IndexCacheEntryTable::Iterator i = oldEntries->start(); i; i++)
+                _entries->insert(i.key(), i.value());
+        }
+
+        return _entries->insert(instanceName, entry);
+    }
+
+    void remove(const CIMObjectPath& instanceName)
+    {
+        _entries->remove(instanceName);
+    }
+
+    Uint32 size() const
+    {
+        return _entries->size();
+    }
+
+    // Size of the index file that the cached entries correspond to.
+    Uint32 fileSize;
+
+private:
+
+    void _create(Uint32 numEntries)
+    {
+        _numChains = IndexCacheEntryTable::DEFAULT_NUM_CHAINS;
+
+        while (_numChains < numEntries)
+            _numChains *= 2;
+
+        _entries.reset(new IndexCacheEntryTable(_numChains));
+    }
+
+    AutoPtr<IndexCacheEntryTable> _entries;
+    Uint32 _numChains;
+};
+
+typedef HashTable<String, IndexCacheFile*, EqualNoCaseFunc, HashLowerCaseFunc>
+    IndexCacheTable;
+
+class IndexCache
+{
+public:
+
+    ~IndexCache()
+    {
+        for (IndexCacheTable::Iterator i = files.start(); i; i++)
+            delete i.value();
+    }
+
+    void remove(const String& path)
+    {
+        IndexCacheFile* file = 0;
+
+        if (files.lookup(path, file))
+        {
+            files.remove(path);
+            delete file;
+        }
+    }
+
+    IndexCacheTable files;
+};
+
+static Mutex _indexCacheMutex;
+static IndexCache _indexCache;
+
+//
+// Returns the cached entries of the given index file, reading the file if
+// it is not cached yet or if its size differs from the cached size (which
+// means it was modified behind the cache's back).  Returns 0 if the file
+// cannot be read; the caller then falls back to scanning the file.  Must be
+// called with _indexCacheMutex held.
+//
+
+static IndexCacheFile* _getIndexCacheFile(const String& path)
+{
+    Uint32 fileSize;
+
+    if (!FileSystem::getFileSize(path, fileSize))
+    {
+        _indexCache.remove(path);
+        return 0;
+    }
+
+    IndexCacheFile* file = 0;
+
+    if (_indexCache.files.lookup(path, file))
+    {
+        if (file->fileSize == fileSize)
+            return file;
+
+        _indexCache.remove(path);
+    }
+
+    PEG_METHOD_ENTER(TRC_REPOSITORY, "_getIndexCacheFile()");
+
+    String realPath;
+    MappedFile indexFile;
+
+    if (!FileSystem::existsNoCase(path, realPath) || !indexFile.open(realPath))
+    {
+        PEG_METHOD_EXIT();
+        return 0;
+    }
+
+    // Skip the free count (eight hex digits and a newline).
+    const char* start = indexFile.getData();
+    const char* end = start + indexFile.getSize();
+    const char* pos = indexFile.getSize() < 9 ? end : start + 9;
+
+    Array<CIMObjectPath> instanceNames;
+    Array<IndexCacheEntry> entries;
+    Buffer line;
+    Uint32 freeFlag;
+    Uint32 hashCode;
+    const char* instanceName;
+    IndexCacheEntry entry;
+    Boolean errorOccurred;
+
+    entry.entryOffset = (Uint32)(pos - start);
+
+    while (_GetNextRecord(pos, end, line, freeFlag, hashCode, entry.index,
+        entry.size, instanceName, errorOccurred))
+    {
+        if (freeFlag == 0)
+        {
+            instanceNames.append(_convertKeyToInstanceName(instanceName));
+            entries.append(entry);
+        }
+
+        entry.entryOffset = (Uint32)(pos - start);
+    }
+
+    if (errorOccurred)
+    {
+        PEG_METHOD_EXIT();
+        return 0;
+    }
+
+    file = new IndexCacheFile(instanceNames.size());
+    file->fileSize = fileSize;
+
+    // If the same name appears twice, the first entry wins, as it does when
+    // the file is scanned.
+    for (Uint32 i = 0; i < instanceNames.size(); i++)
+        file->insert(instanceNames[i], entries[i]);
+
+    _indexCache.files.insert(path, file);
+
+    PEG_TRACE((TRC_REPOSITORY, Tracer::LEVEL4,
+        "Cached %u entries of instance index file %s",
+        file->size(),
+        (const char*)path.getCString()));
+
+    PEG_METHOD_EXIT();
+    return file;
+}
+
+//
+// Marks the cached entry for the given instance name as free in the index
+// file and removes it from the cache.
+//
+
+static Boolean _markCachedEntryFree(
+    fstream& fs,
+    IndexCacheFile* file,
+    const CIMObjectPath& instanceName)
+{
+    IndexCacheEntry* entry;
+
+    if (!file->lookup(instanceName, entry))
+        return false;
+
+    fs.seekg(entry->entryOffset);
+
+    if (!fs)
+        return false;
+
+    fs.write("1", 1);
+
+    if (!fs)
+        return false;
+
+    file->remove(instanceName);
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // InstanceIndexFile:
@@ -254,6 +554,26 @@ Boolean InstanceIndexFile::lookupEntry(
 {
     PEG_METHOD_ENTER(TRC_REPOSITORY, "InstanceIndexFile::lookupEntry()");
 
+    AutoMutex autoMut(_indexCacheMutex);
+
+    IndexCacheFile* file = _getIndexCacheFile(path);
+
+    if (file)
+    {
+        IndexCacheEntry* entry;
+
+        if (!file->lookup(instanceName, entry))
+        {
+            PEG_METHOD_EXIT();
+            return false;
+        }
+
+        indexOut = entry->index;
+        sizeOut = entry->size;
+        PEG_METHOD_EXIT();
+        return true;
+    }
+
     fstream fs;
 
     if (!_openFile(path, fs))
@@ -281,6 +601,8 @@ Boolean InstanceIndexFile::createEntry(
 {
     PEG_METHOD_ENTER(TRC_REPOSITORY, "InstanceIndexFile::createEntry()");
 
+    AutoMutex autoMut(_indexCacheMutex);
+
     //
     // Open the file:
     //
@@ -297,27 +619,51 @@ Boolean InstanceIndexFile::createEntry(
     // Return false if entry already exists:
     //
 
-    Uint32 tmpIndex;
-    Uint32 tmpSize;
-    Uint32 tmpEntryOffset;
+    IndexCacheFile* file = _getIndexCacheFile(path);
 
-    if (InstanceIndexFile::_lookupEntry(
-        fs, instanceName, tmpIndex, tmpSize, tmpEntryOffset))
+    if (file)
     {
-        PEG_METHOD_EXIT();
-        return false;
+        if (file->contains(instanceName))
+        {
+            PEG_METHOD_EXIT();
+            return false;
+        }
+    }
+    else
+    {
+        Uint32 tmpIndex;
+        Uint32 tmpSize;
+        Uint32 tmpEntryOffset;
+
+        if (InstanceIndexFile::_lookupEntry(
+            fs, instanceName, tmpIndex, tmpSize, tmpEntryOffset))
+        {
+            PEG_METHOD_EXIT();
+            return false;
+        }
     }
 
     //
     // Append the new entry to the end of the file:
     //
 
-    if (!_appendEntry(fs, instanceName, indexIn, sizeIn))
+    IndexCacheEntry entry;
+    entry.index = indexIn;
+    entry.size = sizeIn;
+
+    if (!_appendEntry(fs, instanceName, indexIn, sizeIn, entry.entryOffset))
     {
+        _indexCache.remove(path);
         PEG_METHOD_EXIT();
         return false;
     }
 
+    if (file)
+    {
+        file->insert(instanceName, entry);
+        file->fileSize = _getEntryOffset(fs);
+    }
+
     //
     // Close the file:
     //
@@ -337,6 +683,8 @@ Boolean InstanceIndexFile::deleteEntry(
 
     freeCount = 0;
 
+    AutoMutex autoMut(_indexCacheMutex);
+
     //
     // Open the file:
     //
@@ -353,7 +701,10 @@ Boolean InstanceIndexFile::deleteEntry(
     // Mark the entry as free:
     //
 
-    if (!_markEntryFree(fs, instanceName))
+    IndexCacheFile* file = _getIndexCacheFile(path);
+
+    if (file ? !_markCachedEntryFree(fs, file, instanceName) :
+        !_markEntryFree(fs, instanceName))
     {
         PEG_METHOD_EXIT();
         return false;
@@ -367,6 +718,7 @@ Boolean InstanceIndexFile::deleteEntry(
 
     if (!_incrementFreeCount(fs, freeCount))
     {
+        _indexCache.remove(path);
         PEG_METHOD_EXIT();
         return false;
     }
@@ -390,6 +742,8 @@ Boolean InstanceIndexFile::modifyEntry(
 {
     PEG_METHOD_ENTER(TRC_REPOSITORY, "InstanceIndexFile::modifyEntry()");
 
+    AutoMutex autoMut(_indexCacheMutex);
+
     //
     // Open the file:
     //
@@ -406,7 +760,10 @@ Boolean InstanceIndexFile::modifyEntry(
     // Mark the entry as free:
     //
 
-    if (!_markEntryFree(fs, instanceName))
+    IndexCacheFile* file = _getIndexCacheFile(path);
+
+    if (file ? !_markCachedEntryFree(fs, file, instanceName) :
+        !_markEntryFree(fs, instanceName))
     {
         PEG_METHOD_EXIT();
         return false;
@@ -416,12 +773,23 @@ Boolean InstanceIndexFile::modifyEntry(
     // Append new entry:
     //
 
-    if (!_appendEntry(fs, instanceName, indexIn, sizeIn))
+    IndexCacheEntry entry;
+    entry.index = indexIn;
+    entry.size = sizeIn;
+
+    if (!_appendEntry(fs, instanceName, indexIn, sizeIn, entry.entryOffset))
     {
+        _indexCache.remove(path);
         PEG_METHOD_EXIT();
         return false;
     }
 
+    if (file)
+    {
+        file->insert(instanceName, entry);
+        file->fileSize = _getEntryOffset(fs);
+    }
+
     //
     // Increment the free count:
     //
@@ -430,6 +798,7 @@ Boolean InstanceIndexFile::modifyEntry(
 
     if (!_incrementFreeCount(fs, freeCount))
     {
+        _indexCache.remove(path);
         PEG_METHOD_EXIT();
         return false;
     }
@@ -466,22 +835,39 @@ Boolean InstanceIndexFile::enumerateEntries(
     instanceNames.reserveCapacity(COUNT);
 
     //
-    // Open input file:
+    // Map the input file.  It is only read, so it is neither locked nor
+    // created here.
     //
 
-    fstream fs;
+    String realPath;
+    MappedFile file;
 
-    if (!_openFile(path, fs))
+    if (!FileSystem::existsNoCase(path, realPath))
     {
         // file does not exist, just return with no instanceNames
         PEG_METHOD_EXIT();
         return true;
     }
 
+    if (!file.open(realPath))
+    {
+        PEG_METHOD_EXIT();
+        return false;
+    }
+
     //
-    // Iterate over all instances to build output arrays:
+    // Iterate over all instances to build output arrays.  The records
+    // follow the free count (eight hex digits and a newline).
     //
 
+    const char* pos = file.getData();
+    const char* end = pos + file.getSize();
+
+    if (file.getSize() < 9)
+        pos = end;
+    else
+        pos += 9;
+
     Buffer line;
     Uint32 freeFlag;
     Uint32 hashCode;
@@ -490,8 +876,8 @@ Boolean InstanceIndexFile::enumerateEntries(
     Uint32 size;
     Boolean errorOccurred;
 
-    while (_GetNextRecord(
-        fs, line, freeFlag, hashCode, index, size, instanceName, errorOccurred))
+    while (_GetNextRecord(pos, end, line,
+        freeFlag, hashCode, index, size, instanceName, errorOccurred))
     {
         if (!freeFlag || includeFreeEntries)
         {
@@ -627,7 +1013,8 @@ Boolean InstanceIndexFile::_appendEntry(
     PEGASUS_STD(fstream)& fs,
     const CIMObjectPath& instanceName,
     Uint32 indexIn,
-    Uint32 sizeIn)
+    Uint32 sizeIn,
+    Uint32& entryOffset)
 {
     PEG_METHOD_ENTER(TRC_REPOSITORY, "InstanceIndexFile::_appendEntry()");
 
@@ -643,6 +1030,8 @@ Boolean InstanceIndexFile::_appendEntry(
         return false;
     }
 
+    entryOffset = _getEntryOffset(fs);
+
     //
     // Write the entry:
     //
@@ -773,6 +1162,14 @@ Boolean InstanceIndexFile::compact(
 {
     PEG_METHOD_ENTER(TRC_REPOSITORY, "InstanceIndexFile::compact()");
 
+    //
+    // The entry offsets change, so the cached entries are read again on the
+    // next access:
+    //
+
+    AutoMutex autoMut(_indexCacheMutex);
+    _indexCache.remove(path);
+
     //
     // Open input file:
     //
@@ -822,6 +1219,7 @@ Boolean InstanceIndexFile::compact(
     Uint32 size;
     Boolean errorOccurred;
     Uint32 adjust = 0;
+    Uint32 entryOffset;
 
     while (_GetNextRecord(
         fs, line, freeFlag, hashCode, index, size, instanceName, errorOccurred))
@@ -839,7 +1237,7 @@ Boolean InstanceIndexFile::compact(
         else
         {
             if (!_appendEntry(tmpFs, _convertKeyToInstanceName(instanceName),
-                index - adjust, size))
+                index - adjust, size, entryOffset))
             {
                 errorOccurred = true;
                 break;
@@ -884,8 +1282,17 @@ Boolean InstanceIndexFile::hasNonFreeEntries(const String& path)
     if (!FileSystem::existsNoCase(path))
         return false;
 
+    {
+        AutoMutex autoMut(_indexCacheMutex);
+
+        IndexCacheFile* file = _getIndexCacheFile(path);
+
+        if (file)
+            return file->size() != 0;
+    }
+
     //
-    // We must iterate all the entries looking for a non-free one:
+    // Otherwise we must iterate all the entries looking for a non-free one:
     //
 
     Array<Uint32> freeFlags;
@@ -991,6 +1398,11 @@ Boolean InstanceIndexFile::rollbackTransaction(const String& path)
     // To roll back, simply rename the rollback file over the index file.
     //
 
+    {
+        AutoMutex autoMut(_indexCacheMutex);
+        _indexCache.remove(path);
+    }
+
     PEG_METHOD_EXIT();
     return FileSystem::renameFileNoCase(path + ".rollback", path);
 }
@@ -1010,4 +1422,30 @@ Boolean InstanceIndexFile::commitTransaction(const String& path)
     return FileSystem::removeFileNoCase(rollbackPath);
 }
 
+void InstanceIndexFile::invalidateCache(const String& path)
+{
+    PEG_METHOD_ENTER(TRC_REPOSITORY, "InstanceIndexFile::invalidateCache()");
+
+    AutoMutex autoMut(_indexCacheMutex);
+
+    String dirPath = path;
+    dirPath.append('/');
+
+    Array<String> paths;
+
+    for (IndexCacheTable::Iterator i = _indexCache.files.start(); i; i++)
+    {
+        if (String::equalNoCase(i.key(), path) ||
+            String::equalNoCase(i.key().subString(0, dirPath.size()), dirPath))
+        {
+            paths.append(i.key());
+        }
+    }
+
+    for (Uint32 i = 0; i < paths.size(); i++)
+        _indexCache.remove(paths[i]);
+
+    PEG_METHOD_EXIT();
+}
+
 PEGASUS_NAMESPACE_END
@@ -141,6 +141,14 @@ PEGASUS_NAMESPACE_BEGIN
     Modification. To modify an instance, the new modified instance is appended
     to the instance file. Next the old entry with the same key is marked as
     deleted.  Finally, a new entry is inserted into the index file.
+
+    Caching. The non-free entries of an index file are read into an in-memory
+    hash table the first time the file is accessed, so that lookupEntry(),
+    deleteEntry() and modifyEntry() do not need to scan the file. The cached
+    entries are updated by every modification made through this class. The
+    cache for a file is discarded when the file is compacted or rolled back,
+    when its size no longer matches the cached size, or when
+    invalidateCache() is called for it.
 */
 class PEGASUS_REPOSITORY_LINKAGE InstanceIndexFile
 {
@@ -253,6 +261,13 @@ public:
     static Boolean compact(
         const String& path);
 
+    /** Discard the cached entries of the given index file. If the path
+        names a directory, the cached entries of all index files beneath
+        that directory are discarded. This must be called when index files
+        are removed by means other than this class.
+    */
+    static void invalidateCache(const String& path);
+
 private:
 
     /** Open the index file and position the file pointer on the first
@@ -272,7 +287,8 @@ private:
         PEGASUS_STD(fstream)& fs,
         const CIMObjectPath& instanceName,
         Uint32 indexIn,
-        Uint32 sizeIn);
+        Uint32 sizeIn,
+        Uint32& entryOffset);
 
     /** Increment the index file's free count; called by _markEntryFree().
         The resulting value is left in the freeCount parameter.
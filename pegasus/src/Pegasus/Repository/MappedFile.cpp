@@ -0,0 +1,166 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <cerrno>
+#include <fstream>
+#include <Pegasus/Common/FileSystem.h>
+#include <Pegasus/Common/Tracer.h>
+
+#if defined(PEGASUS_OS_TYPE_UNIX)
+# include <sys/types.h>
+# include <sys/stat.h>
+# include <sys/mman.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+PEGASUS_USING_STD;
+
+PEGASUS_NAMESPACE_BEGIN
+
+MappedFile::MappedFile() : _data(0), _size(0), _mapped(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+Boolean MappedFile::open(const String& path, Boolean map)
+{
+    PEG_METHOD_ENTER(TRC_REPOSITORY, "MappedFile::open()");
+
+    close();
+
+#if defined(PEGASUS_OS_TYPE_UNIX)
+    if (map)
+    {
+        int fd = ::open(path.getCString(), O_RDONLY);
+
+        if (fd == -1)
+        {
+            PEG_METHOD_EXIT();
+            return false;
+        }
+
+        struct stat st;
+
+        if (fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            PEG_METHOD_EXIT();
+            return false;
+        }
+
+        // An empty file cannot be mapped, and it has nothing to map.
+        if (st.st_size == 0)
+        {
+            ::close(fd);
+            PEG_METHOD_EXIT();
+            return true;
+        }
+
+        void* addr = mmap(0, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+        // The mapping holds its own reference to the file.
+        ::close(fd);
+
+        if (addr != MAP_FAILED)
+        {
+# if defined(MADV_SEQUENTIAL)
+            madvise(addr, (size_t)st.st_size, MADV_SEQUENTIAL);
+# endif
+            _data = (const char*)addr;
+            _size = (Uint32)st.st_size;
+            _mapped = true;
+
+            PEG_METHOD_EXIT();
+            return true;
+        }
+
+        PEG_TRACE((TRC_REPOSITORY, Tracer::LEVEL2,
+            "Failed to map file %s: errno = %d, reading it instead",
+            (const char*)path.getCString(),
+            errno));
+    }
+#endif
+
+    Boolean result = _read(path);
+
+    PEG_METHOD_EXIT();
+    return result;
+}
+
+void MappedFile::close()
+{
+#if defined(PEGASUS_OS_TYPE_UNIX)
+    if (_mapped)
+        munmap((void*)_data, _size);
+#endif
+
+    _buffer.clear();
+    _data = 0;
+    _size = 0;
+    _mapped = false;
+}
+
+Boolean MappedFile::_read(const String& path)
+{
+    Uint32 fileSize;
+
+    if (!FileSystem::getFileSize(path, fileSize))
+        return false;
+
+    fstream fs;
+    fs.open(path.getCString(), ios::in PEGASUS_OR_IOS_BINARY);
+
+    if (!fs)
+        return false;
+
+    _buffer.grow(fileSize, '\0');
+    fs.read((char*)_buffer.getData(), fileSize);
+
+    if (!fs)
+    {
+        _buffer.clear();
+        return false;
+    }
+
+    _data = _buffer.getData();
+    _size = fileSize;
+    return true;
+}
+
+PEGASUS_NAMESPACE_END
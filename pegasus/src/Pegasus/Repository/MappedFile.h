@@ -0,0 +1,109 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#ifndef Pegasus_MappedFile_h
+#define Pegasus_MappedFile_h
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/String.h>
+#include <Pegasus/Common/Buffer.h>
+#include <Pegasus/Repository/Linkage.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+/** This class provides read-only access to the contents of a file.
+
+    On Unix platforms the file is mapped into memory, so its pages are read
+    on demand and may be dropped again by the operating system once they
+    have been used.  On other platforms the contents are read into a buffer.
+
+    A mapping stays valid when the file is replaced by a rename or removed,
+    and the repository only ever appends to or replaces its instance files
+    while it holds the write lock.  Data that is appended after the file was
+    opened is not visible through the mapping.
+*/
+class PEGASUS_REPOSITORY_LINKAGE MappedFile
+{
+public:
+
+    MappedFile();
+
+    ~MappedFile();
+
+    /** Opens the file with the given path, which must have the exact case
+        of the file name.
+
+        @param path the file path
+        @param map if false, the contents are read into a buffer even where
+            mapping is supported
+        @return true on success.
+    */
+    Boolean open(const String& path, Boolean map = true);
+
+    /** Releases the contents of the file.
+    */
+    void close();
+
+    /** Returns the contents of the file.  The data must not be modified.
+    */
+    const char* getData() const
+    {
+        return _data;
+    }
+
+    Uint32 getSize() const
+    {
+        return _size;
+    }
+
+    /** Returns true if the contents of the file are mapped into memory.
+    */
+    Boolean isMapped() const
+    {
+        return _mapped;
+    }
+
+private:
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    Boolean _read(const String& path);
+
+    const char* _data;
+    Uint32 _size;
+    Boolean _mapped;
+    Buffer _buffer;
+};
+
+PEGASUS_NAMESPACE_END
+
+#endif /* Pegasus_MappedFile_h */
@@ -62,9 +62,24 @@ public:
 
     bool evict(const String& path);
 
+    // Returns whether the object is cached, without counting a hit or a
+    // miss or making it the most recently used entry.
+    bool contains(const String& path);
+
     // Removes all the entries from the cache.
     void clear();
 
+    // Changes the maximum number of entries, evicting the least recently
+    // used entries that no longer fit.  A size of 0 disables the cache.
+    void setMaxEntries(size_t maxEntries);
+
+    void getStatistics(
+        Uint32& numEntries,
+        Uint32& maxEntries,
+        Uint64& hits,
+        Uint64& misses,
+        Uint64& evictions);
+
 #ifdef PEGASUS_DEBUG
     void DisplayCacheStatistics()
     {
@@ -93,6 +108,10 @@ private:
         return String::equalNoCase(s1, s2);
     }
 
+    // Removes the entry at the front of the LRU queue.  The caller must
+    // hold _mutex.
+    void _evictFront();
+
     struct Entry
     {
         Uint32 code;
@@ -102,8 +121,13 @@ private:
         Entry* queueNext;
         Entry* queuePrev;
 
-        Entry(Uint32 code_, const String& path_, OBJECT& object_) :
-            code(code_), path(path_), object(object_.clone()) { }
+        Entry(
+            Uint32 code_,
+            const String& path_,
+            OBJECT& object_,
+            bool clone) :
+            code(code_), path(path_),
+            object(clone ? object_.clone() : object_) { }
     };
 
     enum { NUM_CHAINS = 128 };
@@ -115,21 +139,15 @@ private:
     size_t _maxEntries;
     Mutex _mutex;
 
-#ifdef PEGASUS_DEBUG
-    Uint32 _cacheReadHit;
-    Uint32 _cacheReadMiss;
-    Uint32 _cacheRemoveLRU;
-#endif
-
-
+    Uint64 _cacheReadHit;
+    Uint64 _cacheReadMiss;
+    Uint64 _cacheRemoveLRU;
 };
 
 template<class OBJECT>
 ObjectCache<OBJECT>::ObjectCache(size_t maxEntries)
-    : _front(0), _back(0), _numEntries(0), _maxEntries(maxEntries)
-#ifdef PEGASUS_DEBUG
-    , _cacheReadHit(0), _cacheReadMiss(0), _cacheRemoveLRU(0)
-#endif
+    : _front(0), _back(0), _numEntries(0), _maxEntries(maxEntries),
+      _cacheReadHit(0), _cacheReadMiss(0), _cacheRemoveLRU(0)
 {
     memset(_chains, 0, sizeof(_chains));
 }
@@ -165,7 +183,7 @@ void ObjectCache<OBJECT>::put(
 
     //// Add to hash table:
 
-    Entry* newEntry = new Entry(code, path, object);
+    Entry* newEntry = new Entry(code, path, object, clone);
     newEntry->hashNext = _chains[index];
     _chains[index] = newEntry;
 
@@ -191,42 +209,46 @@ void ObjectCache<OBJECT>::put(
     //// Evict LRU entry if necessary (from front).
 
     if (_numEntries > _maxEntries)
-    {
-        Entry* entry = _front;
+        _evictFront();
+}
 
-        //// Remove from hash table first.
+template<class OBJECT>
+void ObjectCache<OBJECT>::_evictFront()
+{
+    Entry* entry = _front;
 
-        Uint32 frontIndex = entry->code % NUM_CHAINS;
-        Entry* hashPrev = 0;
+    //// Remove from hash table first.
 
-        for (Entry* p = _chains[frontIndex]; p; p = p->hashNext)
-        {
-            if (p->code == entry->code && _equal(p->path, entry->path))
-            {
-                if (hashPrev)
-                    hashPrev->hashNext = p->hashNext;
-                else
-                    _chains[frontIndex] = p->hashNext;
+    Uint32 frontIndex = entry->code % NUM_CHAINS;
+    Entry* hashPrev = 0;
 
-                break;
-            }
+    for (Entry* p = _chains[frontIndex]; p; p = p->hashNext)
+    {
+        if (p->code == entry->code && _equal(p->path, entry->path))
+        {
+            if (hashPrev)
+                hashPrev->hashNext = p->hashNext;
+            else
+                _chains[frontIndex] = p->hashNext;
 
-            hashPrev = p;
+            break;
         }
 
-        //// Now remove from queue:
+        hashPrev = p;
+    }
+
+    //// Now remove from queue:
 
-        _front = entry->queueNext;
+    _front = entry->queueNext;
 
-        if (_front)
-            _front->queuePrev = 0;
+    if (_front)
+        _front->queuePrev = 0;
+    else
+        _back = 0;
 
-        delete entry;
-        _numEntries--;
-#ifdef PEGASUS_DEBUG
+    delete entry;
+    _numEntries--;
     _cacheRemoveLRU++;
-#endif
-    }
 }
 
 template<class OBJECT>
@@ -274,18 +296,33 @@ bool ObjectCache<OBJECT>::get(const String& path, OBJECT& object, bool clone)
             else
                 object = p->object;
 
-#ifdef PEGASUS_DEBUG
             _cacheReadHit++;
-#endif
             return true;
         }
     }
 
     /// Not found!
 
-#ifdef PEGASUS_DEBUG
     _cacheReadMiss++;
-#endif
+    return false;
+}
+
+template<class OBJECT>
+bool ObjectCache<OBJECT>::contains(const String& path)
+{
+    if (_maxEntries == 0)
+        return false;
+
+    AutoMutex lock(_mutex);
+
+    Uint32 code = _hash(path);
+
+    for (Entry* p = _chains[code % NUM_CHAINS]; p; p = p->hashNext)
+    {
+        if (code == p->code && _equal(p->path, path))
+            return true;
+    }
+
     return false;
 }
 
@@ -362,6 +399,34 @@ void ObjectCache<OBJECT>::clear()
     memset(_chains, 0, sizeof(_chains));
 }
 
+template<class OBJECT>
+void ObjectCache<OBJECT>::setMaxEntries(size_t maxEntries)
+{
+    AutoMutex lock(_mutex);
+
+    _maxEntries = maxEntries;
+
+    while (_numEntries > _maxEntries)
+        _evictFront();
+}
+
+template<class OBJECT>
+void ObjectCache<OBJECT>::getStatistics(
+    Uint32& numEntries,
+    Uint32& maxEntries,
+    Uint64& hits,
+    Uint64& misses,
+    Uint64& evictions)
+{
+    AutoMutex lock(_mutex);
+
+    numEntries = Uint32(_numEntries);
+    maxEntries = Uint32(_maxEntries);
+    hits = _cacheReadHit;
+    misses = _cacheReadMiss;
+    evictions = _cacheRemoveLRU;
+}
+
 PEGASUS_NAMESPACE_END
 
 #endif /* PegasusRepository_ObjectCache_h */
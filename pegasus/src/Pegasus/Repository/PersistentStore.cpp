@@ -42,6 +42,40 @@
 
 PEGASUS_NAMESPACE_BEGIN
 
+class ArrayInstanceEnumeration : public InstanceEnumeration
+{
+public:
+
+    ArrayInstanceEnumeration(const Array<CIMInstance>& instances)
+        : _instances(instances), _pos(0)
+    {
+    }
+
+    virtual Boolean next(Uint32 maxInstances, Array<CIMInstance>& instances)
+    {
+        Uint32 n = _instances.size() - _pos;
+
+        if (n == 0)
+        {
+            return false;
+        }
+
+        if (n > maxInstances)
+        {
+            n = maxInstances;
+        }
+
+        instances.append(_instances.getData() + _pos, n);
+        _pos += n;
+        return true;
+    }
+
+private:
+
+    Array<CIMInstance> _instances;
+    Uint32 _pos;
+};
+
 PersistentStore* PersistentStore::createPersistentStore(
         const String& repositoryPath,
         ObjectStreamer* streamer,
@@ -64,4 +98,12 @@ PersistentStore* PersistentStore::createPersistentStore(
 #endif
 }
 
+InstanceEnumeration* PersistentStore::openInstanceEnumeration(
+    const CIMNamespaceName& nameSpace,
+    const CIMName& className)
+{
+    return new ArrayInstanceEnumeration(
+        enumerateInstancesForClass(nameSpace, className));
+}
+
 PEGASUS_NAMESPACE_END
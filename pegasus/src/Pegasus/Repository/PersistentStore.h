@@ -45,6 +45,26 @@
 
 PEGASUS_NAMESPACE_BEGIN
 
+/**
+    Reads the instances of a class from a PersistentStore a batch at a time,
+    so that they need not all be held in memory at once.  The enumeration
+    returns the instances that existed when it was opened.  It does not
+    require the repository lock once it is open.
+*/
+class InstanceEnumeration
+{
+public:
+    virtual ~InstanceEnumeration() { }
+
+    /**
+        Appends the next instances of the class, at most maxInstances of
+        them, to the given array.  Returns false if no instances remain.
+    */
+    virtual Boolean next(
+        Uint32 maxInstances,
+        Array<CIMInstance>& instances) = 0;
+};
+
 class PersistentStore
 {
 public:
@@ -132,6 +152,15 @@ public:
     virtual Array<CIMInstance> enumerateInstancesForClass(
         const CIMNamespaceName& nameSpace,
         const CIMName& className) = 0;
+    /**
+        Opens an enumeration of the instances of a class.  The caller
+        deletes the returned object.  The default implementation reads all
+        the instances with enumerateInstancesForClass() and returns them in
+        batches.
+    */
+    virtual InstanceEnumeration* openInstanceEnumeration(
+        const CIMNamespaceName& nameSpace,
+        const CIMName& className);
     virtual CIMInstance getInstance(
         const CIMNamespaceName& nameSpace,
         const CIMObjectPath& instanceName) = 0;
@@ -0,0 +1,205 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Repository/AssocInstCache.h>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+static InstanceAssociation _makeRecord(
+    const char* assocInstanceName,
+    const char* assocClassName,
+    const char* fromInstanceName,
+    const char* fromPropertyName,
+    const char* toInstanceName,
+    const char* toPropertyName)
+{
+    return InstanceAssociation(
+        assocInstanceName,
+        CIMName(assocClassName),
+        fromInstanceName,
+        CIMObjectPath(fromInstanceName).getClassName(),
+        CIMName(fromPropertyName),
+        toInstanceName,
+        CIMObjectPath(toInstanceName).getClassName(),
+        CIMName(toPropertyName));
+}
+
+int main(int argc, char** argv)
+{
+    AssocInstCacheManager cacheManager;
+    Array<CIMName> noClasses;
+    Array<String> names;
+
+    AssocInstCache* a1 = cacheManager.getAssocInstCache("a");
+    PEGASUS_TEST_ASSERT(a1->getNameSpace() == "a");
+    PEGASUS_TEST_ASSERT(cacheManager.getAssocInstCache("a") == a1);
+    PEGASUS_TEST_ASSERT(!a1->isActive());
+    a1->setActive(true);
+    PEGASUS_TEST_ASSERT(a1->isActive());
+
+    PEGASUS_TEST_ASSERT(!a1->removeAssociation(CIMObjectPath("A.k=1")));
+    PEGASUS_TEST_ASSERT(!a1->getAssociatorNames(CIMObjectPath("X.k=1"),
+        noClasses, noClasses, String::EMPTY, String::EMPTY, names));
+
+    // Each association is recorded once for each direction
+
+    a1->addRecord(_makeRecord(
+        "A.l=\"X.k=1\",r=\"Y.k=1\"", "A", "X.k=1", "l", "Y.k=1", "r"));
+    a1->addRecord(_makeRecord(
+        "A.l=\"X.k=1\",r=\"Y.k=1\"", "A", "Y.k=1", "r", "X.k=1", "l"));
+    a1->addRecord(_makeRecord(
+        "A.l=\"X.k=1\",r=\"Y.k=2\"", "A", "X.k=1", "l", "Y.k=2", "r"));
+    a1->addRecord(_makeRecord(
+        "A.l=\"X.k=1\",r=\"Y.k=2\"", "A", "Y.k=2", "r", "X.k=1", "l"));
+    a1->addRecord(_makeRecord(
+        "B.l=\"X.k=1\",r=\"Z.k=1\"", "B", "X.k=1", "l", "Z.k=1", "r"));
+    a1->addRecord(_makeRecord(
+        "B.l=\"X.k=1\",r=\"Z.k=1\"", "B", "Z.k=1", "r", "X.k=1", "l"));
+    a1->addRecord(_makeRecord(
+        "C.l=\"X.k=1\",r=\"Y.k=1\"", "C", "X.k=1", "l", "Y.k=1", "r"));
+    a1->addRecord(_makeRecord(
+        "C.l=\"X.k=1\",r=\"Y.k=1\"", "C", "Y.k=1", "r", "X.k=1", "l"));
+
+    // Associators are not duplicated, and object names are normalized
+
+    PEGASUS_TEST_ASSERT(a1->getAssociatorNames(CIMObjectPath("x.K=1"),
+        noClasses, noClasses, String::EMPTY, String::EMPTY, names));
+    PEGASUS_TEST_ASSERT(names.size() == 3);
+    PEGASUS_TEST_ASSERT(names[0] == "Y.k=1");
+    PEGASUS_TEST_ASSERT(names[1] == "Y.k=2");
+    PEGASUS_TEST_ASSERT(names[2] == "Z.k=1");
+
+    // Names already in the result are not added again
+
+    PEGASUS_TEST_ASSERT(a1->getAssociatorNames(CIMObjectPath("X.k=1"),
+        noClasses, noClasses, String::EMPTY, String::EMPTY, names));
+    PEGASUS_TEST_ASSERT(names.size() == 3);
+    names.clear();
+
+    // Filters
+
+    Array<CIMName> classes;
+    classes.append(CIMName("b"));
+    PEGASUS_TEST_ASSERT(a1->getAssociatorNames(CIMObjectPath("X.k=1"),
+        classes, noClasses, String::EMPTY, String::EMPTY, names));
+    PEGASUS_TEST_ASSERT(names.size() == 1 && names[0] == "Z.k=1");
+    names.clear();
+
+    classes.clear();
+    classes.append(CIMName("Y"));
+    PEGASUS_TEST_ASSERT(a1->getAssociatorNames(CIMObjectPath("X.k=1"),
+        noClasses, classes, String::EMPTY, String::EMPTY, names));
+    PEGASUS_TEST_ASSERT(names.size() == 2);
+    names.clear();
+
+    PEGASUS_TEST_ASSERT(!a1->getAssociatorNames(CIMObjectPath("X.k=1"),
+        noClasses, noClasses, "r", String::EMPTY, names));
+    PEGASUS_TEST_ASSERT(a1->getAssociatorNames(CIMObjectPath("Y.k=1"),
+        noClasses, noClasses, "R", "L", names));
+    PEGASUS_TEST_ASSERT(names.size() == 1 && names[0] == "X.k=1");
+    names.clear();
+
+    PEGASUS_TEST_ASSERT(a1->getReferenceNames(CIMObjectPath("X.k=1"),
+        noClasses, "l", names));
+    PEGASUS_TEST_ASSERT(names.size() == 4);
+    names.clear();
+
+    classes.clear();
+    classes.append(CIMName("A"));
+    PEGASUS_TEST_ASSERT(a1->getReferenceNames(CIMObjectPath("Y.k=1"),
+        classes, String::EMPTY, names));
+    PEGASUS_TEST_ASSERT(names.size() == 1);
+    PEGASUS_TEST_ASSERT(names[0] == "A.l=\"X.k=1\",r=\"Y.k=1\"");
+    names.clear();
+
+    // Removing an association removes both directions
+
+    PEGASUS_TEST_ASSERT(a1->removeAssociation(
+        CIMObjectPath("A.r=\"Y.k=1\",l=\"X.k=1\"")));
+    PEGASUS_TEST_ASSERT(!a1->removeAssociation(
+        CIMObjectPath("A.l=\"X.k=1\",r=\"Y.k=1\"")));
+
+    PEGASUS_TEST_ASSERT(a1->getReferenceNames(CIMObjectPath("X.k=1"),
+        noClasses, String::EMPTY, names));
+    PEGASUS_TEST_ASSERT(names.size() == 3);
+    names.clear();
+
+    PEGASUS_TEST_ASSERT(a1->getAssociatorNames(CIMObjectPath("Y.k=1"),
+        noClasses, noClasses, String::EMPTY, String::EMPTY, names));
+    PEGASUS_TEST_ASSERT(names.size() == 1 && names[0] == "X.k=1");
+    names.clear();
+
+    PEGASUS_TEST_ASSERT(a1->removeAssociation(
+        CIMObjectPath("A.l=\"X.k=1\",r=\"Y.k=2\"")));
+    PEGASUS_TEST_ASSERT(!a1->getReferenceNames(CIMObjectPath("Y.k=2"),
+        noClasses, String::EMPTY, names));
+
+    // Many objects: the tables grow beyond their initial number of chains
+
+    for (Uint32 i = 0; i < 5000; i++)
+    {
+        char assocName[64];
+        char fromName[32];
+        sprintf(assocName, "D.l=\"H.k=1\",r=\"V.k=%u\"", i);
+        sprintf(fromName, "V.k=%u", i);
+        a1->addRecord(_makeRecord(
+            assocName, "D", "H.k=1", "l", fromName, "r"));
+        a1->addRecord(_makeRecord(
+            assocName, "D", fromName, "r", "H.k=1", "l"));
+    }
+
+    PEGASUS_TEST_ASSERT(a1->getAssociatorNames(CIMObjectPath("H.k=1"),
+        noClasses, noClasses, String::EMPTY, String::EMPTY, names));
+    PEGASUS_TEST_ASSERT(names.size() == 5000);
+    names.clear();
+
+    PEGASUS_TEST_ASSERT(a1->getAssociatorNames(CIMObjectPath("V.k=4321"),
+        noClasses, noClasses, String::EMPTY, String::EMPTY, names));
+    PEGASUS_TEST_ASSERT(names.size() == 1 && names[0] == "H.k=1");
+    names.clear();
+
+    // Caches of different namespaces are independent
+
+    AssocInstCache* a2 = cacheManager.getAssocInstCache("b");
+    PEGASUS_TEST_ASSERT(a2 != a1);
+    PEGASUS_TEST_ASSERT(!a2->getReferenceNames(CIMObjectPath("X.k=1"),
+        noClasses, String::EMPTY, names));
+
+    a1->clear();
+    PEGASUS_TEST_ASSERT(!a1->isActive());
+    PEGASUS_TEST_ASSERT(!a1->getReferenceNames(CIMObjectPath("X.k=1"),
+        noClasses, String::EMPTY, names));
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+
+    return 0;
+}
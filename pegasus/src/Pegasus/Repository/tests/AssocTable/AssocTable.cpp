@@ -29,6 +29,7 @@
 //
 //%/////////////////////////////////////////////////////////////////////////////
 
+#include <Pegasus/Common/FileSystem.h>
 #include <Pegasus/Repository/AssocClassTable.h>
 #include <Pegasus/Repository/AssocInstTable.h>
 
@@ -102,10 +103,12 @@ int main(int argc, char** argv)
         PEGASUS_TEST_ASSERT(referenceNames.size() == 0);
     }
 
+    AssocInstTable _assocInstTable;
+
     //
     // create instance association
     //
-    AssocInstTable::append(
+    _assocInstTable.append(
         assocTablePath,
         "A.left=\"x.key=\\\"one\\\"\",right=\"y.key=\\\"two\\\"\"",
         CIMName ("A"),
@@ -117,12 +120,134 @@ int main(int argc, char** argv)
         CIMName ("right"));
 
     //
-    // delete instance association
+    // check that the association was really created, both through a table
+    // which has loaded the file already and through one which has not
+    //
+    {
+        Array<CIMName> classList;
+        Array<String> associatorNames;
+        PEGASUS_TEST_ASSERT(_assocInstTable.getAssociatorNames(
+            assocTablePath,
+            CIMObjectPath("X.key=\"one\""),
+            classList,
+            classList,
+            String::EMPTY,
+            String::EMPTY,
+            associatorNames));
+        PEGASUS_TEST_ASSERT(associatorNames.size() == 1);
+        PEGASUS_TEST_ASSERT(associatorNames[0] == "Y.key=\"two\"");
+
+        _assocInstTable.append(
+            assocTablePath,
+            "A.left=\"x.key=\\\"one\\\"\",right=\"y.key=\\\"three\\\"\"",
+            CIMName ("A"),
+            "X.key=\"one\"",
+            CIMName ("X"),
+            CIMName ("left"),
+            "Y.key=\"three\"",
+            CIMName ("Y"),
+            CIMName ("right"));
+
+        AssocInstTable tmpAssocInstTable;
+        Array<String> referenceNames;
+        PEGASUS_TEST_ASSERT(tmpAssocInstTable.getReferenceNames(
+            assocTablePath,
+            CIMObjectPath("X.key=\"one\""),
+            classList,
+            "left",
+            referenceNames));
+        PEGASUS_TEST_ASSERT(referenceNames.size() == 2);
+
+        associatorNames.clear();
+        PEGASUS_TEST_ASSERT(_assocInstTable.getAssociatorNames(
+            assocTablePath,
+            CIMObjectPath("X.key=\"one\""),
+            classList,
+            classList,
+            String::EMPTY,
+            String::EMPTY,
+            associatorNames));
+        PEGASUS_TEST_ASSERT(associatorNames.size() == 2);
+    }
+
+    //
+    // delete instance associations
     //
-    AssocInstTable::deleteAssociation(
+    PEGASUS_TEST_ASSERT(_assocInstTable.deleteAssociation(
+        assocTablePath,
+        CIMObjectPath
+            ("A.left=\"x.key=\\\"one\\\"\",right=\"y.key=\\\"two\\\"\"")));
+
+    {
+        Array<CIMName> classList;
+        Array<String> referenceNames;
+        PEGASUS_TEST_ASSERT(_assocInstTable.getReferenceNames(
+            assocTablePath,
+            CIMObjectPath("X.key=\"one\""),
+            classList,
+            String::EMPTY,
+            referenceNames));
+        PEGASUS_TEST_ASSERT(referenceNames.size() == 1);
+    }
+
+    PEGASUS_TEST_ASSERT(_assocInstTable.deleteAssociation(
         assocTablePath,
         CIMObjectPath
-            ("A.left=\"x.key=\\\"one\\\"\",right=\"y.key=\\\"two\\\"\""));
+            ("A.left=\"x.key=\\\"one\\\"\",right=\"y.key=\\\"three\\\"\"")));
+
+    {
+        Array<CIMName> classList;
+        Array<String> referenceNames;
+        PEGASUS_TEST_ASSERT(!_assocInstTable.getReferenceNames(
+            assocTablePath,
+            CIMObjectPath("X.key=\"one\""),
+            classList,
+            String::EMPTY,
+            referenceNames));
+    }
+
+    //
+    // deleting an association which is not in the table fails, and a
+    // discarded cache is not used after the table file is removed
+    //
+    _assocInstTable.append(
+        assocTablePath,
+        "A.left=\"x.key=\\\"one\\\"\",right=\"y.key=\\\"four\\\"\"",
+        CIMName ("A"),
+        "X.key=\"one\"",
+        CIMName ("X"),
+        CIMName ("left"),
+        "Y.key=\"four\"",
+        CIMName ("Y"),
+        CIMName ("right"));
+
+    PEGASUS_TEST_ASSERT(!_assocInstTable.deleteAssociation(
+        assocTablePath,
+        CIMObjectPath
+            ("A.left=\"x.key=\\\"one\\\"\",right=\"y.key=\\\"two\\\"\"")));
+
+    {
+        Array<CIMName> classList;
+        Array<String> referenceNames;
+        PEGASUS_TEST_ASSERT(_assocInstTable.getReferenceNames(
+            assocTablePath,
+            CIMObjectPath("X.key=\"one\""),
+            classList,
+            String::EMPTY,
+            referenceNames));
+        PEGASUS_TEST_ASSERT(referenceNames.size() == 1);
+
+        FileSystem::removeFile(assocTablePath);
+        _assocInstTable.invalidateCache(assocTablePath);
+
+        referenceNames.clear();
+        PEGASUS_TEST_ASSERT(!_assocInstTable.getReferenceNames(
+            assocTablePath,
+            CIMObjectPath("X.key=\"one\""),
+            classList,
+            String::EMPTY,
+            referenceNames));
+    }
 
     cout << argv[0] << " +++++ passed all tests" << endl;
 
@@ -0,0 +1,406 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/CIMName.h>
+#include <Pegasus/Common/FileSystem.h>
+#include <Pegasus/Config/ConfigManager.h>
+#include <Pegasus/Repository/CIMRepository.h>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+static Boolean verbose;
+
+static const CIMNamespaceName NAMESPACE = CIMNamespaceName("zzz");
+
+struct CacheStatistics
+{
+    Uint32 size;
+    Uint32 capacity;
+    Uint64 hits;
+    Uint64 misses;
+    Uint64 evictions;
+};
+
+static CacheStatistics _getStatistics(CIMRepository& r)
+{
+    CacheStatistics s;
+    r.getClassCacheStatistics(
+        s.size, s.capacity, s.hits, s.misses, s.evictions);
+
+    if (verbose)
+    {
+        cout << "size=" << s.size << " capacity=" << s.capacity <<
+            " hits=" << s.hits << " misses=" << s.misses <<
+            " evictions=" << s.evictions << endl;
+    }
+
+    return s;
+}
+
+static String _getRepositoryRoot()
+{
+    String repositoryRoot;
+    const char* tmpDir = getenv("PEGASUS_TMP");
+    if (tmpDir == NULL)
+    {
+        repositoryRoot = ".";
+    }
+    else
+    {
+        repositoryRoot = tmpDir;
+    }
+
+    repositoryRoot.append("/repository");
+    return repositoryRoot;
+}
+
+static void _createClasses(CIMRepository& r)
+{
+    r.createNameSpace(NAMESPACE);
+
+    r.setQualifier(NAMESPACE, CIMQualifierDecl(CIMName("Description"),
+        String(), CIMScope::ANY, CIMFlavor::TRANSLATABLE));
+
+    CIMClass class1(CIMName("Class1"));
+    class1.addQualifier(
+        CIMQualifier(CIMName("Description"), String("Class1")));
+    class1.addProperty(CIMProperty(CIMName("p1"), Uint32(1))
+        .addQualifier(CIMQualifier(CIMName("Description"), String("p1"))));
+    r.createClass(NAMESPACE, class1);
+
+    CIMClass class2(CIMName("Class2"), CIMName("Class1"));
+    class2.addProperty(CIMProperty(CIMName("p2"), String("two"))
+        .addQualifier(CIMQualifier(CIMName("Description"), String("p2"))));
+    r.createClass(NAMESPACE, class2);
+}
+
+// Checks that classes and their variants are served from the cache and that
+// the returned classes are independent of the cached ones.
+void TestVariants(Uint32 mode)
+{
+    String repositoryRoot = _getRepositoryRoot();
+    FileSystem::removeDirectoryHier(repositoryRoot);
+
+    CIMRepository r(repositoryRoot, mode);
+    _createClasses(r);
+
+    CacheStatistics s0 = _getStatistics(r);
+    PEGASUS_TEST_ASSERT(
+        s0.capacity == PEGASUS_DEFAULT_REPOSITORY_CLASS_CACHE_SIZE);
+
+    // The complete class is loaded once and then found in the cache.
+
+    CIMClass full1 = r.getClass(NAMESPACE, CIMName("Class2"),
+        false, true, true);
+    CacheStatistics s1 = _getStatistics(r);
+    PEGASUS_TEST_ASSERT(s1.misses == s0.misses + 1);
+
+    CIMClass full2 = r.getClass(NAMESPACE, CIMName("Class2"),
+        false, true, true);
+    PEGASUS_TEST_ASSERT(full1.identical(full2));
+    PEGASUS_TEST_ASSERT(full1.getPropertyCount() == 2);
+
+    CacheStatistics s2 = _getStatistics(r);
+    PEGASUS_TEST_ASSERT(s2.hits == s1.hits + 1);
+    PEGASUS_TEST_ASSERT(s2.misses == s1.misses);
+
+    // getClass returns a copy, so changing it does not change the cache.
+
+    full1.removeProperty(full1.findProperty(CIMName("p2")));
+    full2 = r.getClass(NAMESPACE, CIMName("Class2"), false, true, true);
+    PEGASUS_TEST_ASSERT(full2.getPropertyCount() == 2);
+
+    // The variant without qualifiers and class origin is built from the
+    // complete class once, then returned from the cache.
+
+    CIMClass bare1 = r.getClass(NAMESPACE, CIMName("Class2"),
+        false, false, false);
+    CacheStatistics s3 = _getStatistics(r);
+    CIMClass bare2 = r.getClass(NAMESPACE, CIMName("Class2"),
+        false, false, false);
+    CacheStatistics s4 = _getStatistics(r);
+
+    PEGASUS_TEST_ASSERT(s4.hits == s3.hits + 1);
+    PEGASUS_TEST_ASSERT(s4.misses == s3.misses);
+    PEGASUS_TEST_ASSERT(s4.size == s3.size);
+    PEGASUS_TEST_ASSERT(bare1.identical(bare2));
+    PEGASUS_TEST_ASSERT(bare2.getPropertyCount() == 2);
+
+    for (Uint32 i = 0; i < bare2.getPropertyCount(); i++)
+    {
+        CIMProperty p = bare2.getProperty(i);
+        PEGASUS_TEST_ASSERT(p.getQualifierCount() == 0);
+        PEGASUS_TEST_ASSERT(p.getClassOrigin().isNull());
+    }
+
+    // The local only variant differs from the complete class.
+
+    CIMClass local = r.getClass(NAMESPACE, CIMName("Class2"),
+        true, true, false);
+    PEGASUS_TEST_ASSERT(local.getPropertyCount() == 1);
+    PEGASUS_TEST_ASSERT(local.findProperty(CIMName("p2")) != PEG_NOT_FOUND);
+    local = r.getClass(NAMESPACE, CIMName("Class2"), true, true, false);
+    PEGASUS_TEST_ASSERT(local.getPropertyCount() == 1);
+
+    // A property list bypasses the variants.
+
+    Array<CIMName> propertyNames;
+    propertyNames.append(CIMName("p1"));
+    CIMClass partial = r.getClass(NAMESPACE, CIMName("Class2"),
+        false, false, false, CIMPropertyList(propertyNames));
+    PEGASUS_TEST_ASSERT(partial.getPropertyCount() == 1);
+    bare2 = r.getClass(NAMESPACE, CIMName("Class2"), false, false, false);
+    PEGASUS_TEST_ASSERT(bare2.getPropertyCount() == 2);
+
+    // Modifying the class replaces all its cached variants.
+
+    CIMClass modified = r.getClass(NAMESPACE, CIMName("Class2"),
+        true, true, true);
+    modified.addProperty(CIMProperty(CIMName("p3"), Boolean(true)));
+    r.modifyClass(NAMESPACE, modified);
+
+    bare2 = r.getClass(NAMESPACE, CIMName("Class2"), false, false, false);
+    PEGASUS_TEST_ASSERT(bare2.getPropertyCount() == 3);
+    local = r.getClass(NAMESPACE, CIMName("Class2"), true, true, false);
+    PEGASUS_TEST_ASSERT(local.getPropertyCount() == 2);
+
+    // The shared complete class is the same object for every caller.
+
+    CIMConstClass shared1 = r.getFullConstClass(NAMESPACE, CIMName("Class2"));
+    CIMConstClass shared2 = r.getFullConstClass(NAMESPACE, CIMName("Class2"));
+    PEGASUS_TEST_ASSERT(shared1.getPropertyCount() == 3);
+    PEGASUS_TEST_ASSERT(shared1.identical(shared2));
+
+    // Deleting the class evicts all its variants.
+
+    r.deleteClass(NAMESPACE, CIMName("Class2"));
+
+    Boolean caught = false;
+    try
+    {
+        r.getClass(NAMESPACE, CIMName("Class2"), false, false, false);
+    }
+    catch (CIMException& e)
+    {
+        PEGASUS_TEST_ASSERT(e.getCode() == CIM_ERR_NOT_FOUND);
+        caught = true;
+    }
+    PEGASUS_TEST_ASSERT(caught);
+
+    caught = false;
+    try
+    {
+        r.getClass(NAMESPACE, CIMName("Class2"), true, true, false);
+    }
+    catch (CIMException& e)
+    {
+        PEGASUS_TEST_ASSERT(e.getCode() == CIM_ERR_NOT_FOUND);
+        caught = true;
+    }
+    PEGASUS_TEST_ASSERT(caught);
+
+    r.deleteClass(NAMESPACE, CIMName("Class1"));
+    FileSystem::removeDirectoryHier(repositoryRoot);
+}
+
+// Checks that no more than PEGASUS_MAX_REPOSITORY_CLASS_VARIANTS variants
+// of a class are cached.
+void TestVariantLimit(Uint32 mode)
+{
+    String repositoryRoot = _getRepositoryRoot();
+    FileSystem::removeDirectoryHier(repositoryRoot);
+
+    CIMRepository r(repositoryRoot, mode);
+    _createClasses(r);
+
+    // The complete class and one more entry for every variant up to the
+    // limit.
+
+    r.getClass(NAMESPACE, CIMName("Class2"), false, true, true);
+    CacheStatistics s0 = _getStatistics(r);
+
+    for (Uint32 variant = 1; variant <= PEGASUS_MAX_REPOSITORY_CLASS_VARIANTS;
+         variant++)
+    {
+        r.getClass(NAMESPACE, CIMName("Class2"),
+            (variant & 1) != 0, (variant & 2) == 0, (variant & 4) == 0);
+    }
+
+    CacheStatistics s1 = _getStatistics(r);
+    PEGASUS_TEST_ASSERT(
+        s1.size == s0.size + PEGASUS_MAX_REPOSITORY_CLASS_VARIANTS);
+
+    // Every further variant is built from the complete class each time.
+
+    for (Uint32 variant = PEGASUS_MAX_REPOSITORY_CLASS_VARIANTS + 1;
+         variant < 8; variant++)
+    {
+        for (Uint32 i = 0; i < 2; i++)
+        {
+            CacheStatistics before = _getStatistics(r);
+            CIMClass c = r.getClass(NAMESPACE, CIMName("Class2"),
+                (variant & 1) != 0, (variant & 2) == 0, (variant & 4) == 0);
+            CacheStatistics after = _getStatistics(r);
+
+            // A miss on the variant, a hit on the complete class.
+            PEGASUS_TEST_ASSERT(after.misses == before.misses + 1);
+            PEGASUS_TEST_ASSERT(after.hits == before.hits + 1);
+            PEGASUS_TEST_ASSERT(after.size == s1.size);
+            PEGASUS_TEST_ASSERT(c.getPropertyCount() ==
+                ((variant & 1) ? 1 : 2));
+        }
+    }
+
+    // The cached variants are still found.
+
+    CacheStatistics s2 = _getStatistics(r);
+    r.getClass(NAMESPACE, CIMName("Class2"), true, true, true);
+    CacheStatistics s3 = _getStatistics(r);
+    PEGASUS_TEST_ASSERT(s3.hits == s2.hits + 1);
+    PEGASUS_TEST_ASSERT(s3.misses == s2.misses);
+
+    r.deleteClass(NAMESPACE, CIMName("Class2"));
+    r.deleteClass(NAMESPACE, CIMName("Class1"));
+    FileSystem::removeDirectoryHier(repositoryRoot);
+}
+
+// Checks that the cache size is taken from the repositoryClassCacheSize
+// config property and that the least recently used entries are replaced.
+void TestCapacity(Uint32 mode)
+{
+    ConfigManager::getInstance()->initCurrentValue(
+        "repositoryClassCacheSize", "2");
+
+    String repositoryRoot = _getRepositoryRoot();
+    FileSystem::removeDirectoryHier(repositoryRoot);
+
+    {
+        CIMRepository r(repositoryRoot, mode);
+        _createClasses(r);
+
+        CacheStatistics s0 = _getStatistics(r);
+        PEGASUS_TEST_ASSERT(s0.capacity == 2);
+
+        r.getClass(NAMESPACE, CIMName("Class1"), false, true, true);
+        r.getClass(NAMESPACE, CIMName("Class2"), false, true, true);
+        r.getClass(NAMESPACE, CIMName("Class2"), true, true, true);
+
+        CacheStatistics s1 = _getStatistics(r);
+        PEGASUS_TEST_ASSERT(s1.size == 2);
+        PEGASUS_TEST_ASSERT(s1.evictions > s0.evictions);
+
+        // Class1 was replaced, Class2 is still cached.
+
+        r.getClass(NAMESPACE, CIMName("Class2"), true, true, true);
+        CacheStatistics s2 = _getStatistics(r);
+        PEGASUS_TEST_ASSERT(s2.hits == s1.hits + 1);
+
+        r.getClass(NAMESPACE, CIMName("Class1"), false, true, true);
+        CacheStatistics s3 = _getStatistics(r);
+        PEGASUS_TEST_ASSERT(s3.misses == s2.misses + 1);
+        PEGASUS_TEST_ASSERT(s3.size == 2);
+
+        r.deleteClass(NAMESPACE, CIMName("Class2"));
+        r.deleteClass(NAMESPACE, CIMName("Class1"));
+    }
+
+    // A size of 0 disables the cache.
+
+    ConfigManager::getInstance()->initCurrentValue(
+        "repositoryClassCacheSize", "0");
+    FileSystem::removeDirectoryHier(repositoryRoot);
+
+    {
+        CIMRepository r(repositoryRoot, mode);
+        _createClasses(r);
+
+        r.getClass(NAMESPACE, CIMName("Class2"), false, false, false);
+        r.getClass(NAMESPACE, CIMName("Class2"), false, false, false);
+
+        CacheStatistics s = _getStatistics(r);
+        PEGASUS_TEST_ASSERT(s.capacity == 0);
+        PEGASUS_TEST_ASSERT(s.size == 0);
+        PEGASUS_TEST_ASSERT(s.hits == 0);
+
+        r.deleteClass(NAMESPACE, CIMName("Class2"));
+        r.deleteClass(NAMESPACE, CIMName("Class1"));
+    }
+
+    ConfigManager::getInstance()->initCurrentValue(
+        "repositoryClassCacheSize",
+        PEGASUS_DEFAULT_REPOSITORY_CLASS_CACHE_SIZE_STRING);
+
+    FileSystem::removeDirectoryHier(repositoryRoot);
+}
+
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    if (argc != 2)
+    {
+        cout << "Usage: " << argv[0] << " XML | BIN" << endl;
+        return 1;
+    }
+
+    Uint32 mode;
+    if (!strcmp(argv[1], "XML"))
+    {
+        mode = CIMRepository::MODE_XML;
+    }
+    else if (!strcmp(argv[1], "BIN"))
+    {
+        mode = CIMRepository::MODE_BIN;
+    }
+    else
+    {
+        cout << argv[0] << ": invalid argument: " << argv[1] << endl;
+        return 1;
+    }
+
+    try
+    {
+        TestVariants(mode);
+        TestVariantLimit(mode);
+        TestCapacity(mode);
+    }
+    catch (Exception& e)
+    {
+        cout << e.getMessage() << endl;
+        exit(1);
+    }
+
+    cout << argv[0] << " " << argv[1] << " +++++ passed all tests" << endl;
+
+    return 0;
+}
@@ -32,11 +32,13 @@
 
 #include <Pegasus/Common/Config.h>
 #include <Pegasus/Common/ArrayInternal.h>
+#include <Pegasus/Common/FileSystem.h>
 #include <Pegasus/Repository/InstanceIndexFile.h>
 #include <Pegasus/Repository/InstanceDataFile.h>
 
 #include <iostream>
 #include <cstring>
+#include <cstdio>
 #include <Pegasus/Common/PegasusAssert.h>
 
 PEGASUS_USING_PEGASUS;
@@ -285,6 +287,113 @@ void _Test02()
     data.clear();
 }
 
+//
+// Verify that lookups stay consistent with the index file as it is modified,
+// compacted and rolled back.
+//
+
+void _Test03()
+{
+    String indexPath (tmpDir);
+    indexPath.append("/Y.idx");
+    Uint32 index;
+    Uint32 size;
+    Uint32 freeCount = 0;
+
+    const Uint32 COUNT = 200;
+    Array<CIMObjectPath> instNames;
+
+    for (Uint32 i = 0; i < COUNT; i++)
+    {
+        char buffer[64];
+        sprintf(buffer, "Y.key1=%u,key2=\"Hello World %u\"", i, i);
+        instNames.append(CIMObjectPath(buffer));
+        PEGASUS_TEST_ASSERT(InstanceIndexFile::createEntry(
+            indexPath, instNames[i], i * 100, 100));
+    }
+
+    // Duplicate entries are rejected
+    PEGASUS_TEST_ASSERT(!InstanceIndexFile::createEntry(
+        indexPath, instNames[7], 0, 100));
+
+    // Names are compared case-insensitively
+    PEGASUS_TEST_ASSERT(InstanceIndexFile::lookupEntry(indexPath,
+        CIMObjectPath("y.KEY1=7,Key2=\"Hello World 7\""), index, size));
+    PEGASUS_TEST_ASSERT(index == 700 && size == 100);
+
+    // Delete the even entries and modify every third one
+    for (Uint32 i = 0; i < COUNT; i += 2)
+    {
+        PEGASUS_TEST_ASSERT(InstanceIndexFile::deleteEntry(
+            indexPath, instNames[i], freeCount));
+    }
+
+    PEGASUS_TEST_ASSERT(!InstanceIndexFile::deleteEntry(
+        indexPath, instNames[0], freeCount));
+
+    for (Uint32 i = 3; i < COUNT; i += 6)
+    {
+        PEGASUS_TEST_ASSERT(InstanceIndexFile::modifyEntry(
+            indexPath, instNames[i], COUNT * 100 + i, 50, freeCount));
+    }
+
+    // Check the cached lookups against lookups which read the file
+    for (Uint32 pass = 0; pass < 2; pass++)
+    {
+        for (Uint32 i = 0; i < COUNT; i++)
+        {
+            Boolean found = InstanceIndexFile::lookupEntry(
+                indexPath, instNames[i], index, size);
+
+            if (i % 2 == 0)
+            {
+                PEGASUS_TEST_ASSERT(!found);
+            }
+            else if (i % 6 == 3)
+            {
+                PEGASUS_TEST_ASSERT(found);
+                PEGASUS_TEST_ASSERT(index == COUNT * 100 + i && size == 50);
+            }
+            else
+            {
+                PEGASUS_TEST_ASSERT(found);
+                PEGASUS_TEST_ASSERT(index == i * 100 && size == 100);
+            }
+        }
+
+        InstanceIndexFile::invalidateCache(indexPath);
+    }
+
+    // Compacting changes the entry offsets; modifying afterwards must mark
+    // the right entry as free
+    PEGASUS_TEST_ASSERT(InstanceIndexFile::compact(indexPath));
+    PEGASUS_TEST_ASSERT(InstanceIndexFile::modifyEntry(
+        indexPath, instNames[1], 1, 1, freeCount));
+    PEGASUS_TEST_ASSERT(freeCount == 1);
+    PEGASUS_TEST_ASSERT(InstanceIndexFile::lookupEntry(
+        indexPath, instNames[1], index, size));
+    PEGASUS_TEST_ASSERT(index == 1 && size == 1);
+
+    // Changes made in a rolled back transaction are not visible
+    PEGASUS_TEST_ASSERT(InstanceIndexFile::beginTransaction(indexPath));
+    PEGASUS_TEST_ASSERT(InstanceIndexFile::deleteEntry(
+        indexPath, instNames[5], freeCount));
+    PEGASUS_TEST_ASSERT(InstanceIndexFile::createEntry(
+        indexPath, instNames[4], 4, 4));
+    PEGASUS_TEST_ASSERT(InstanceIndexFile::rollbackTransaction(indexPath));
+
+    PEGASUS_TEST_ASSERT(InstanceIndexFile::lookupEntry(
+        indexPath, instNames[5], index, size));
+    PEGASUS_TEST_ASSERT(!InstanceIndexFile::lookupEntry(
+        indexPath, instNames[4], index, size));
+
+    // Removing the file behind the cache's back is detected
+    PEGASUS_TEST_ASSERT(FileSystem::removeFile(indexPath));
+    PEGASUS_TEST_ASSERT(!InstanceIndexFile::lookupEntry(
+        indexPath, instNames[5], index, size));
+    PEGASUS_TEST_ASSERT(!InstanceIndexFile::hasNonFreeEntries(indexPath));
+}
+
 int main(int argc, char** argv)
 {
     const char * envTmpDir = getenv ("PEGASUS_TMP");
@@ -297,6 +406,7 @@ int main(int argc, char** argv)
     {
     _Test01();
     _Test02();
+    _Test03();
         free(tmpDir);
     }
 
@@ -0,0 +1,289 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/CIMName.h>
+#include <Pegasus/Common/FileSystem.h>
+#include <Pegasus/Repository/CIMRepository.h>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+static Boolean verbose;
+
+static const CIMNamespaceName NAMESPACE = CIMNamespaceName("zzz");
+static const CIMName CLASSNAME = CIMName("EnumClass");
+static const Uint32 NUM_INSTANCES = 100;
+
+static String _getRepositoryRoot()
+{
+    String repositoryRoot;
+    const char* tmpDir = getenv("PEGASUS_TMP");
+    if (tmpDir == NULL)
+    {
+        repositoryRoot = ".";
+    }
+    else
+    {
+        repositoryRoot = tmpDir;
+    }
+
+    repositoryRoot.append("/repository");
+    return repositoryRoot;
+}
+
+static CIMObjectPath _getInstanceName(Uint32 id)
+{
+    Array<CIMKeyBinding> keys;
+    keys.append(CIMKeyBinding(CIMName("Id"), CIMValue(id)));
+    return CIMObjectPath(String(), CIMNamespaceName(), CLASSNAME, keys);
+}
+
+// Creates NUM_INSTANCES instances with large records, then deletes and
+// modifies some of them, so that the instance data file has free space
+// and the index file has free entries.
+static void _createInstances(CIMRepository& r)
+{
+    r.createNameSpace(NAMESPACE);
+
+    r.setQualifier(NAMESPACE, CIMQualifierDecl(CIMName("Key"),
+        false, CIMScope::PROPERTY, CIMFlavor::TOSUBCLASS));
+
+    CIMClass cimClass(CLASSNAME);
+    cimClass.addProperty(CIMProperty(CIMName("Id"), Uint32(0))
+        .addQualifier(CIMQualifier(CIMName("Key"), true)));
+    cimClass.addProperty(CIMProperty(CIMName("Name"), String()));
+    cimClass.addProperty(CIMProperty(CIMName("Value"), Uint32(1)));
+    r.createClass(NAMESPACE, cimClass);
+
+    r.createClass(NAMESPACE, CIMClass(CIMName("EmptyClass"), CLASSNAME));
+
+    String padding;
+    for (Uint32 i = 0; i < 1000; i++)
+    {
+        padding.append(Char16('x'));
+    }
+
+    for (Uint32 i = 0; i < NUM_INSTANCES; i++)
+    {
+        char name[32];
+        sprintf(name, "n%u", i);
+
+        CIMInstance instance(CLASSNAME);
+        instance.addProperty(CIMProperty(CIMName("Id"), i));
+        instance.addProperty(
+            CIMProperty(CIMName("Name"), String(name) + padding));
+        instance.addProperty(CIMProperty(CIMName("Value"), Uint32(1)));
+        r.createInstance(NAMESPACE, instance);
+    }
+
+    r.deleteInstance(NAMESPACE, _getInstanceName(5));
+    r.deleteInstance(NAMESPACE, _getInstanceName(50));
+
+    CIMInstance modified = r.getInstance(NAMESPACE, _getInstanceName(10));
+    modified.setPath(_getInstanceName(10));
+    modified.getProperty(modified.findProperty(CIMName("Value")))
+        .setValue(CIMValue(Uint32(42)));
+    Array<CIMName> propertyNames;
+    propertyNames.append(CIMName("Value"));
+    r.modifyInstance(
+        NAMESPACE, modified, false, CIMPropertyList(propertyNames));
+}
+
+struct Batches
+{
+    Uint32 batchSize;
+    Uint32 maxBatches;
+    Uint32 numBatches;
+    Array<CIMInstance> instances;
+};
+
+static Boolean _collect(const Array<CIMInstance>& instances, void* userData)
+{
+    Batches* batches = reinterpret_cast<Batches*>(userData);
+
+    PEGASUS_TEST_ASSERT(instances.size() > 0);
+    PEGASUS_TEST_ASSERT(instances.size() <= batches->batchSize);
+
+    for (Uint32 i = 0; i < instances.size(); i++)
+    {
+        PEGASUS_TEST_ASSERT(instances[i].getClassName() == CLASSNAME);
+        batches->instances.append(instances[i]);
+    }
+
+    batches->numBatches++;
+    return batches->numBatches < batches->maxBatches;
+}
+
+static Uint32 _getUint32(const CIMInstance& instance, const char* name)
+{
+    Uint32 value;
+    instance.getProperty(instance.findProperty(CIMName(name)))
+        .getValue().get(value);
+    return value;
+}
+
+// Checks that the streamed instances are those returned by the array form
+// of enumerateInstancesForClass().
+void TestBatches(Uint32 mode)
+{
+    String repositoryRoot = _getRepositoryRoot();
+    FileSystem::removeDirectoryHier(repositoryRoot);
+
+    CIMRepository r(repositoryRoot, mode);
+    _createInstances(r);
+
+    Array<CIMInstance> expected =
+        r.enumerateInstancesForClass(NAMESPACE, CLASSNAME);
+    PEGASUS_TEST_ASSERT(expected.size() == NUM_INSTANCES - 2);
+
+    Uint32 batchSizes[] = { 1, 7, NUM_INSTANCES, 1000 };
+
+    for (Uint32 i = 0; i < sizeof(batchSizes) / sizeof(batchSizes[0]); i++)
+    {
+        Batches batches;
+        batches.batchSize = batchSizes[i];
+        batches.maxBatches = PEG_NOT_FOUND;
+        batches.numBatches = 0;
+
+        r.enumerateInstancesForClass(
+            NAMESPACE, CLASSNAME, batches.batchSize, _collect, &batches);
+
+        PEGASUS_TEST_ASSERT(batches.numBatches ==
+            (expected.size() + batches.batchSize - 1) / batches.batchSize);
+        PEGASUS_TEST_ASSERT(batches.instances.size() == expected.size());
+
+        for (Uint32 j = 0; j < expected.size(); j++)
+        {
+            const CIMInstance& instance = batches.instances[j];
+            Uint32 id = _getUint32(instance, "Id");
+
+            PEGASUS_TEST_ASSERT(id == _getUint32(expected[j], "Id"));
+            PEGASUS_TEST_ASSERT(id != 5 && id != 50);
+            PEGASUS_TEST_ASSERT(
+                _getUint32(instance, "Value") == (id == 10 ? 42 : 1));
+            PEGASUS_TEST_ASSERT(instance.getPath().getKeyBindings() ==
+                expected[j].getPath().getKeyBindings());
+            PEGASUS_TEST_ASSERT(instance.identical(expected[j]));
+        }
+
+        if (verbose)
+        {
+            cout << "Batch size " << batches.batchSize << ": " <<
+                batches.numBatches << " batches" << endl;
+        }
+    }
+
+    FileSystem::removeDirectoryHier(repositoryRoot);
+}
+
+// Checks that the enumeration ends when the callback returns false, and the
+// enumeration of a class without instances or of an unknown class.
+void TestLimits(Uint32 mode)
+{
+    String repositoryRoot = _getRepositoryRoot();
+    FileSystem::removeDirectoryHier(repositoryRoot);
+
+    CIMRepository r(repositoryRoot, mode);
+    _createInstances(r);
+
+    Batches batches;
+    batches.batchSize = 10;
+    batches.maxBatches = 2;
+    batches.numBatches = 0;
+
+    r.enumerateInstancesForClass(
+        NAMESPACE, CLASSNAME, batches.batchSize, _collect, &batches);
+    PEGASUS_TEST_ASSERT(batches.numBatches == 2);
+    PEGASUS_TEST_ASSERT(batches.instances.size() == 20);
+
+    batches.maxBatches = PEG_NOT_FOUND;
+    batches.numBatches = 0;
+    batches.instances.clear();
+
+    r.enumerateInstancesForClass(
+        NAMESPACE, CIMName("EmptyClass"), 10, _collect, &batches);
+    PEGASUS_TEST_ASSERT(batches.numBatches == 0);
+
+    try
+    {
+        r.enumerateInstancesForClass(
+            NAMESPACE, CIMName("NoSuchClass"), 10, _collect, &batches);
+        PEGASUS_TEST_ASSERT(false);
+    }
+    catch (CIMException& e)
+    {
+        PEGASUS_TEST_ASSERT(e.getCode() == CIM_ERR_INVALID_CLASS);
+    }
+
+    FileSystem::removeDirectoryHier(repositoryRoot);
+}
+
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    if (argc != 2)
+    {
+        cout << "Usage: " << argv[0] << " XML | BIN" << endl;
+        return 1;
+    }
+
+    Uint32 mode;
+    if (!strcmp(argv[1], "XML"))
+    {
+        mode = CIMRepository::MODE_XML;
+    }
+    else if (!strcmp(argv[1], "BIN"))
+    {
+        mode = CIMRepository::MODE_BIN;
+    }
+    else
+    {
+        cout << argv[0] << ": invalid argument: " << argv[1] << endl;
+        return 1;
+    }
+
+    try
+    {
+        TestBatches(mode);
+        TestLimits(mode);
+    }
+    catch (Exception& e)
+    {
+        cout << e.getMessage() << endl;
+        exit(1);
+    }
+
+    cout << argv[0] << " " << argv[1] << " +++++ passed all tests" << endl;
+
+    return 0;
+}
@@ -0,0 +1,548 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstring>
+#include <Pegasus/Common/Buffer.h>
+#include <Pegasus/Common/TimeValue.h>
+#include <Pegasus/Common/System.h>
+#include <Pegasus/Common/Tracer.h>
+#include "BasicAuthenticationCache.h"
+
+#ifdef PEGASUS_HAS_SSL
+# include <openssl/sha.h>
+# include <openssl/hmac.h>
+# include <openssl/evp.h>
+#endif
+
+PEGASUS_USING_STD;
+
+PEGASUS_NAMESPACE_BEGIN
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// SHA-256 (FIPS 180-2) and HMAC-SHA-256 (RFC 2104), used to hash the cached
+// credentials.  Builds without OpenSSL use a local SHA-256.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef PEGASUS_HAS_SSL
+
+static const Uint32 _sha256K[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+struct Sha256
+{
+    Uint32 state[8];
+    Uint64 length;
+    Uint8 block[64];
+    Uint32 used;
+};
+
+static inline Uint32 _rotr(Uint32 x, Uint32 n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+static void _sha256Transform(Sha256& ctx, const Uint8* block)
+{
+    Uint32 w[64];
+
+    for (Uint32 i = 0; i < 16; i++)
+    {
+        w[i] = (Uint32(block[i * 4]) << 24) | (Uint32(block[i * 4 + 1]) << 16) |
+            (Uint32(block[i * 4 + 2]) << 8) | Uint32(block[i * 4 + 3]);
+    }
+
+    for (Uint32 i = 16; i < 64; i++)
+    {
+        Uint32 s0 = _rotr(w[i - 15], 7) ^ _rotr(w[i - 15], 18) ^
+            (w[i - 15] >> 3);
+        Uint32 s1 = _rotr(w[i - 2], 17) ^ _rotr(w[i - 2], 19) ^
+            (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    Uint32 a = ctx.state[0];
+    Uint32 b = ctx.state[1];
+    Uint32 c = ctx.state[2];
+    Uint32 d = ctx.state[3];
+    Uint32 e = ctx.state[4];
+    Uint32 f = ctx.state[5];
+    Uint32 g = ctx.state[6];
+    Uint32 h = ctx.state[7];
+
+    for (Uint32 i = 0; i < 64; i++)
+    {
+        Uint32 s1 = _rotr(e, 6) ^ _rotr(e, 11) ^ _rotr(e, 25);
+        Uint32 ch = (e & f) ^ (~e & g);
+        Uint32 t1 = h + s1 + ch + _sha256K[i] + w[i];
+        Uint32 s0 = _rotr(a, 2) ^ _rotr(a, 13) ^ _rotr(a, 22);
+        Uint32 maj = (a & b) ^ (a & c) ^ (b & c);
+        Uint32 t2 = s0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    ctx.state[0] += a;
+    ctx.state[1] += b;
+    ctx.state[2] += c;
+    ctx.state[3] += d;
+    ctx.state[4] += e;
+    ctx.state[5] += f;
+    ctx.state[6] += g;
+    ctx.state[7] += h;
+}
+
+static void _sha256Init(Sha256& ctx)
+{
+    static const Uint32 initialState[8] =
+    {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    memcpy(ctx.state, initialState, sizeof(initialState));
+    ctx.length = 0;
+    ctx.used = 0;
+}
+
+static void _sha256Update(Sha256& ctx, const void* data, Uint32 size)
+{
+    const Uint8* p = (const Uint8*)data;
+    ctx.length += size;
+
+    while (size)
+    {
+        Uint32 n = 64 - ctx.used;
+
+        if (n > size)
+            n = size;
+
+        memcpy(ctx.block + ctx.used, p, n);
+        ctx.used += n;
+        p += n;
+        size -= n;
+
+        if (ctx.used == 64)
+        {
+            _sha256Transform(ctx, ctx.block);
+            ctx.used = 0;
+        }
+    }
+}
+
+static void _sha256Final(Sha256& ctx, Uint8* digest)
+{
+    Uint64 bits = ctx.length * 8;
+    Uint8 pad = 0x80;
+    _sha256Update(ctx, &pad, 1);
+
+    pad = 0;
+    while (ctx.used != 56)
+        _sha256Update(ctx, &pad, 1);
+
+    Uint8 lengthBytes[8];
+    for (Uint32 i = 0; i < 8; i++)
+        lengthBytes[i] = Uint8(bits >> (56 - i * 8));
+    _sha256Update(ctx, lengthBytes, 8);
+
+    for (Uint32 i = 0; i < 8; i++)
+    {
+        digest[i * 4] = Uint8(ctx.state[i] >> 24);
+        digest[i * 4 + 1] = Uint8(ctx.state[i] >> 16);
+        digest[i * 4 + 2] = Uint8(ctx.state[i] >> 8);
+        digest[i * 4 + 3] = Uint8(ctx.state[i]);
+    }
+}
+
+#endif /* !PEGASUS_HAS_SSL */
+
+void BasicAuthenticationCache::sha256(
+    const void* data,
+    Uint32 size,
+    Uint8* digest)
+{
+#ifdef PEGASUS_HAS_SSL
+    SHA256((const unsigned char*)data, size, digest);
+#else
+    Sha256 ctx;
+    _sha256Init(ctx);
+    _sha256Update(ctx, data, size);
+    _sha256Final(ctx, digest);
+#endif
+}
+
+void BasicAuthenticationCache::hmacSha256(
+    const void* key,
+    Uint32 keySize,
+    const void* data,
+    Uint32 size,
+    Uint8* digest)
+{
+#ifdef PEGASUS_HAS_SSL
+    HMAC(EVP_sha256(), key, (int)keySize,
+        (const unsigned char*)data, size, digest, 0);
+#else
+    // Keys longer than the block size are hashed first
+    Uint8 block[64];
+    memset(block, 0, sizeof(block));
+
+    if (keySize > sizeof(block))
+    {
+        sha256(key, keySize, block);
+    }
+    else
+    {
+        memcpy(block, key, keySize);
+    }
+
+    Uint8 pad[64];
+    Uint8 inner[_DIGEST_SIZE];
+    Sha256 ctx;
+
+    for (Uint32 i = 0; i < sizeof(pad); i++)
+        pad[i] = block[i] ^ 0x36;
+
+    _sha256Init(ctx);
+    _sha256Update(ctx, pad, sizeof(pad));
+    _sha256Update(ctx, data, size);
+    _sha256Final(ctx, inner);
+
+    for (Uint32 i = 0; i < sizeof(pad); i++)
+        pad[i] = block[i] ^ 0x5c;
+
+    _sha256Init(ctx);
+    _sha256Update(ctx, pad, sizeof(pad));
+    _sha256Update(ctx, inner, sizeof(inner));
+    _sha256Final(ctx, digest);
+
+    memset(block, 0, sizeof(block));
+    memset(pad, 0, sizeof(pad));
+#endif
+}
+
+// Fills data with bytes from /dev/urandom.  Returns false if it is not
+// available.
+static Boolean _getRandomBytes(Uint8* data, Uint32 size)
+{
+    Uint32 n = 0;
+    FILE* fh = fopen("/dev/urandom", "rb");
+
+    if (fh)
+    {
+        n = (Uint32)fread(data, 1, size, fh);
+        fclose(fh);
+    }
+
+    return n == size;
+}
+
+static Uint64 _getCurrentMicroseconds()
+{
+    return TimeValue::getCurrentTime().toMicroseconds();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// BasicAuthenticationCache
+//
+////////////////////////////////////////////////////////////////////////////////
+
+BasicAuthenticationCache::BasicAuthenticationCache()
+    : _capacity(0), _timeoutSeconds(0), _saltCounter(0)
+{
+    memset(_hitLatency, 0, sizeof(_hitLatency));
+    memset(_missLatency, 0, sizeof(_missLatency));
+
+    // The secret keys the credential hashes, so that a hash cannot be
+    // checked against a password list without also knowing the secret.
+    // Fall back to hashing the time and the object address if
+    // /dev/urandom is not available.
+
+    if (!_getRandomBytes(_secret, sizeof(_secret)))
+    {
+        struct
+        {
+            Uint64 now;
+            void* self;
+        } seed;
+        memset(&seed, 0, sizeof(seed));
+        seed.now = _getCurrentMicroseconds();
+        seed.self = this;
+
+        sha256(&seed, sizeof(seed), _secret);
+    }
+}
+
+BasicAuthenticationCache::~BasicAuthenticationCache()
+{
+    memset(_secret, 0, sizeof(_secret));
+}
+
+void BasicAuthenticationCache::configure(
+    Uint32 capacity,
+    Uint32 timeoutSeconds)
+{
+    AutoMutex lock(_mutex);
+
+    if (capacity != _capacity || timeoutSeconds != _timeoutSeconds)
+    {
+        PEG_TRACE((TRC_AUTHENTICATION, Tracer::LEVEL3,
+            "BasicAuthenticationCache::configure: capacity %u, "
+                "timeout %u seconds",
+            capacity,
+            timeoutSeconds));
+
+        _entries.clear();
+        _capacity = capacity;
+        _timeoutSeconds = timeoutSeconds;
+    }
+}
+
+void BasicAuthenticationCache::_hash(
+    const Uint8* salt,
+    const String& userName,
+    const String& password,
+    Uint8* digest) const
+{
+    CString user = userName.getCString();
+    CString pass = password.getCString();
+    const char* u = user;
+    const char* p = pass;
+
+    // include the terminating null to separate the user name and password
+    Uint32 userSize = (Uint32)strlen(u) + 1;
+    Uint32 passwordSize = (Uint32)strlen(p);
+
+    Buffer message(_SALT_SIZE + userSize + passwordSize);
+    message.append((const char*)salt, _SALT_SIZE);
+    message.append(u, userSize);
+    message.append(p, passwordSize);
+
+    hmacSha256(_secret, sizeof(_secret),
+        message.getData(), message.size(), digest);
+
+    memset((char*)message.getData(), 0, message.size());
+}
+
+Boolean BasicAuthenticationCache::lookup(
+    const String& userName,
+    const String& password)
+{
+    AutoMutex lock(_mutex);
+
+    if (_capacity == 0 || _timeoutSeconds == 0)
+        return false;
+
+    Entry* entry;
+
+    if (!_entries.lookupReference(userName, entry))
+        return false;
+
+    if (_getCurrentMicroseconds() - entry->verifiedTime >=
+        Uint64(_timeoutSeconds) * 1000000)
+    {
+        _entries.remove(userName);
+        return false;
+    }
+
+    Uint8 digest[_DIGEST_SIZE];
+    _hash(entry->salt, userName, password, digest);
+
+    // compare all bytes so that the time taken does not depend on the
+    // position of the first difference
+    Uint8 diff = 0;
+
+    for (Uint32 i = 0; i < _DIGEST_SIZE; i++)
+        diff |= digest[i] ^ entry->digest[i];
+
+    return diff == 0;
+}
+
+void BasicAuthenticationCache::insert(
+    const String& userName,
+    const String& password)
+{
+    Entry entry;
+    _getSalt(entry.salt);
+    _hash(entry.salt, userName, password, entry.digest);
+
+    AutoMutex lock(_mutex);
+
+    if (_capacity == 0 || _timeoutSeconds == 0)
+        return;
+
+    Uint64 now = _getCurrentMicroseconds();
+    _entries.remove(userName);
+
+    if (_entries.size() >= _capacity)
+    {
+        // Evict the entry verified longest ago. The scan is linear, but it
+        // only happens when a new user is added to a full cache.
+        String oldestUserName;
+        Uint64 oldestTime = now + 1;
+
+        for (EntryTable::Iterator i = _entries.start(); i; i++)
+        {
+            if (i.value().verifiedTime < oldestTime)
+            {
+                oldestTime = i.value().verifiedTime;
+                oldestUserName = i.key();
+            }
+        }
+
+        _entries.remove(oldestUserName);
+    }
+
+    entry.verifiedTime = now;
+
+    _entries.insert(userName, entry);
+}
+
+void BasicAuthenticationCache::_getSalt(Uint8* salt)
+{
+    if (_getRandomBytes(salt, _SALT_SIZE))
+        return;
+
+    // Without /dev/urandom, hash a counter with the secret, so that no two
+    // entries share a salt and the salts cannot be predicted.
+    Uint64 counter;
+    {
+        AutoMutex lock(_mutex);
+        counter = ++_saltCounter;
+    }
+
+    Uint8 digest[_DIGEST_SIZE];
+    hmacSha256(_secret, sizeof(_secret), &counter, sizeof(counter), digest);
+    memcpy(salt, digest, _SALT_SIZE);
+}
+
+void BasicAuthenticationCache::remove(const String& userName)
+{
+    AutoMutex lock(_mutex);
+    _entries.remove(userName);
+}
+
+void BasicAuthenticationCache::clear()
+{
+    AutoMutex lock(_mutex);
+    _entries.clear();
+}
+
+Uint32 BasicAuthenticationCache::size()
+{
+    AutoMutex lock(_mutex);
+    return _entries.size();
+}
+
+void BasicAuthenticationCache::recordLatency(Boolean hit, Uint64 microseconds)
+{
+    // bucket n holds durations in [2^(n-1), 2^n - 1] microseconds
+    Uint32 bucket = 0;
+
+    while (microseconds && bucket < _LATENCY_BUCKETS - 1)
+    {
+        microseconds >>= 1;
+        bucket++;
+    }
+
+    AutoMutex lock(_mutex);
+
+    if (hit)
+        _hitLatency[bucket]++;
+    else
+        _missLatency[bucket]++;
+}
+
+void BasicAuthenticationCache::_getLatency(
+    const Uint64* histogram,
+    Latency& latency)
+{
+    latency.count = 0;
+
+    for (Uint32 i = 0; i < _LATENCY_BUCKETS; i++)
+        latency.count += histogram[i];
+
+    Uint64* percentiles[] = { &latency.p50, &latency.p90, &latency.p99 };
+    const Uint32 ranks[] = { 50, 90, 99 };
+
+    for (Uint32 p = 0; p < 3; p++)
+    {
+        // the number of samples at or below the percentile, rounded up
+        Uint64 rank = (latency.count * ranks[p] + 99) / 100;
+        Uint64 seen = 0;
+        Uint32 i = 0;
+
+        for (; i < _LATENCY_BUCKETS - 1; i++)
+        {
+            seen += histogram[i];
+
+            if (seen >= rank)
+                break;
+        }
+
+        *percentiles[p] = i ? (Uint64(1) << i) - 1 : 0;
+    }
+}
+
+void BasicAuthenticationCache::getLatency(Latency& hits, Latency& misses)
+{
+    AutoMutex lock(_mutex);
+    _getLatency(_hitLatency, hits);
+    _getLatency(_missLatency, misses);
+}
+
+PEGASUS_NAMESPACE_END
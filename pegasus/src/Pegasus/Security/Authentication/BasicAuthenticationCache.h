@@ -0,0 +1,191 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#ifndef Pegasus_BasicAuthenticationCache_h
+#define Pegasus_BasicAuthenticationCache_h
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/String.h>
+#include <Pegasus/Common/HashTable.h>
+#include <Pegasus/Common/Mutex.h>
+#include <Pegasus/Security/Authentication/Linkage.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+/**
+    BasicAuthenticationCache remembers Basic authentication credentials that
+    were successfully verified, so that a client which opens a new connection
+    for every request does not cause a full password verification each time.
+
+    At most one entry is kept per user.  An entry stores a random salt and an
+    HMAC-SHA-256, keyed with a random per-cache secret, of the salt, the user
+    name and the password; the password itself is never stored.  OpenSSL
+    provides the hash functions in PEGASUS_HAS_SSL builds.  Entries expire after the configured
+    timeout, and the oldest entry is evicted when the cache is full.
+
+    The cache also records how long authentications took, separately for
+    cache hits and misses, so that the benefit can be observed.
+*/
+class PEGASUS_SECURITY_LINKAGE BasicAuthenticationCache
+{
+public:
+
+    /**
+        Latency percentiles of the authentications recorded with
+        recordLatency(), in microseconds.  The values are upper bounds taken
+        from a histogram with power-of-two buckets.
+    */
+    struct Latency
+    {
+        Uint64 count;
+        Uint64 p50;
+        Uint64 p90;
+        Uint64 p99;
+    };
+
+    /**
+        Constructs a disabled cache; see configure().
+    */
+    BasicAuthenticationCache();
+
+    ~BasicAuthenticationCache();
+
+    /**
+        Sets the capacity and the entry timeout.  All entries are discarded
+        if either value changes.  A capacity or timeout of zero disables the
+        cache.
+        @param capacity The maximum number of cached users.
+        @param timeoutSeconds The time for which a verified password is
+            accepted without verifying it again.
+    */
+    void configure(Uint32 capacity, Uint32 timeoutSeconds);
+
+    /**
+        Returns true if userName was verified with the given password within
+        the timeout.
+    */
+    Boolean lookup(const String& userName, const String& password);
+
+    /**
+        Records that the password of userName was successfully verified.
+    */
+    void insert(const String& userName, const String& password);
+
+    /**
+        Discards the entry for userName, e.g. after a failed verification.
+    */
+    void remove(const String& userName);
+
+    /**
+        Discards all entries.
+    */
+    void clear();
+
+    /**
+        Returns the number of cached entries.
+    */
+    Uint32 size();
+
+    /**
+        Records the duration of an authentication.
+        @param hit true if the credentials were found in the cache.
+        @param microseconds The duration of the authentication.
+    */
+    void recordLatency(Boolean hit, Uint64 microseconds);
+
+    /**
+        Returns the latency percentiles of cache hits and misses.
+    */
+    void getLatency(Latency& hits, Latency& misses);
+
+    /**
+        Computes the SHA-256 digest (FIPS 180-2) of data.
+        @param digest Receives the 32 byte digest.
+    */
+    static void sha256(const void* data, Uint32 size, Uint8* digest);
+
+    /**
+        Computes the HMAC-SHA-256 (RFC 2104) of data with the given key.
+        @param digest Receives the 32 byte digest.
+    */
+    static void hmacSha256(
+        const void* key,
+        Uint32 keySize,
+        const void* data,
+        Uint32 size,
+        Uint8* digest);
+
+private:
+
+    BasicAuthenticationCache(const BasicAuthenticationCache&);
+    BasicAuthenticationCache& operator=(const BasicAuthenticationCache&);
+
+    enum
+    {
+        _SALT_SIZE = 16,
+        _DIGEST_SIZE = 32,
+        _LATENCY_BUCKETS = 32
+    };
+
+    struct Entry
+    {
+        Uint8 salt[_SALT_SIZE];
+        Uint8 digest[_DIGEST_SIZE];
+        Uint64 verifiedTime;
+    };
+
+    typedef HashTable<String, Entry, EqualFunc<String>, HashFunc<String> >
+        EntryTable;
+
+    void _hash(
+        const Uint8* salt,
+        const String& userName,
+        const String& password,
+        Uint8* digest) const;
+
+    void _getSalt(Uint8* salt);
+
+    static void _getLatency(const Uint64* histogram, Latency& latency);
+
+    Mutex _mutex;
+    EntryTable _entries;
+    Uint32 _capacity;
+    Uint32 _timeoutSeconds;
+    Uint8 _secret[_DIGEST_SIZE];
+    // Salt source when /dev/urandom is not available
+    Uint64 _saltCounter;
+    Uint64 _hitLatency[_LATENCY_BUCKETS];
+    Uint64 _missLatency[_LATENCY_BUCKETS];
+};
+
+PEGASUS_NAMESPACE_END
+
+#endif /* Pegasus_BasicAuthenticationCache_h */
@@ -34,7 +34,9 @@
 
 #include <Pegasus/Common/Config.h>
 #include <Pegasus/Common/Mutex.h>
+#include <Pegasus/Common/AtomicInt.h>
 #include "BasicAuthenticator.h"
+#include "BasicAuthenticationCache.h"
 
 #include <Pegasus/Security/Authentication/Linkage.h>
 
@@ -61,7 +63,32 @@ public:
 
 private:
 
+    /**
+        Verifies the password without consulting the cache.
+    */
+    Boolean _verifyPassword(
+        const String& userName,
+        const String& password);
+
+    /**
+        Applies the basicAuthenticationCacheSize and
+        basicAuthenticationCacheTimeout config properties to the cache.
+    */
+    void _configureCache();
+
+    /**
+        Records the duration of an authentication that started at
+        startTime and periodically traces the latency percentiles.
+    */
+    void _recordLatency(Boolean cacheHit, Uint64 startTime);
+
+    void _traceLatency();
+
     String _realm;
+
+    BasicAuthenticationCache _cache;
+
+    AtomicInt _authenticationCount;
 };
 
 PEGASUS_NAMESPACE_END
@@ -30,6 +30,8 @@
 //%/////////////////////////////////////////////////////////////////////////////
 
 #include <Pegasus/Common/Executor.h>
+#include <Pegasus/Common/StringConversion.h>
+#include <Pegasus/Common/TimeValue.h>
 #include <Pegasus/Config/ConfigManager.h>
 #include <Pegasus/Common/Tracer.h>
 #include "PAMBasicAuthenticator.h"
@@ -59,38 +61,72 @@ int (*xen_utils_xen_init)();
 int (*xen_utils_cleanup_session)(xen_utils_session *session);
 int (*xen_utils_get_session)(xen_utils_session **session, const char *user, const char *pw);
 }
+#endif
+
+PEGASUS_NAMESPACE_BEGIN
+
+#if USEXENAPIAUTH
+static void* _xenLibraryHandle = 0;
+static Mutex _xenLibraryMutex;
 
-bool xenapi_authenticate(const char *username, const char *password)
+/*
+ * Load and initialize the xen-cim support library. It is loaded once, when
+ * the authenticator is created, and stays loaded for the life of the
+ * process. If it is not available yet, loading is retried on the next
+ * authentication.
+ */
+static bool _loadXenLibrary()
 {
-    bool authenticated = false;
-    void *xenlibhandle = NULL;
+    AutoMutex lock(_xenLibraryMutex);
+
+    if (_xenLibraryHandle)
+        return true;
 
     /* to prevent a circular dependency on xen-cim RPMs, load the xen-cim library dynamically */
-    xenlibhandle = dlopen("libXen_Support.so", RTLD_LOCAL | RTLD_LAZY);
-    if(xenlibhandle == NULL)
+    void* handle = dlopen("libXen_Support.so", RTLD_LOCAL | RTLD_LAZY);
+    if (handle == NULL)
+    {
+        PEG_TRACE((TRC_AUTHENTICATION, Tracer::LEVEL1,
+            "Failed to load libXen_Support.so: %s", dlerror()));
         return false;
-    *((void **)&xen_utils_xen_init) = dlsym(xenlibhandle, "xen_utils_xen_init");
-    *((void **)&xen_utils_xen_close) = dlsym(xenlibhandle, "xen_utils_xen_close");
-    *((void **)&xen_utils_cleanup_session) = dlsym(xenlibhandle, "xen_utils_cleanup_session");
-    *((void **)&xen_utils_get_session) = dlsym(xenlibhandle, "xen_utils_get_session");
+    }
+
+    *((void **)&xen_utils_xen_init) = dlsym(handle, "xen_utils_xen_init");
+    *((void **)&xen_utils_xen_close) = dlsym(handle, "xen_utils_xen_close");
+    *((void **)&xen_utils_cleanup_session) = dlsym(handle, "xen_utils_cleanup_session");
+    *((void **)&xen_utils_get_session) = dlsym(handle, "xen_utils_get_session");
+
+    if (!xen_utils_xen_init || !xen_utils_xen_close ||
+        !xen_utils_cleanup_session || !xen_utils_get_session)
+    {
+        PEG_TRACE_CSTRING(TRC_AUTHENTICATION, Tracer::LEVEL1,
+            "libXen_Support.so does not export the xen_utils functions");
+        dlclose(handle);
+        return false;
+    }
 
     (*xen_utils_xen_init)();
+    _xenLibraryHandle = handle;
+    return true;
+}
+
+static bool xenapi_authenticate(const char *username, const char *password)
+{
+    bool authenticated = false;
+
+    if (!_loadXenLibrary())
+        return false;
+
     xen_utils_session *session = NULL;
     /* This request will fail if made to the any host other than the pool master */
     if((*xen_utils_get_session)(&session, username, password) && session) {
-        int i=0, j=0;
          authenticated = true;
          (*xen_utils_cleanup_session)(session);
     }
-    (*xen_utils_xen_close)();
-
-    dlclose(xenlibhandle);
     return authenticated;
 }
 #endif
 
-PEGASUS_NAMESPACE_BEGIN
-
 PAMBasicAuthenticator::PAMBasicAuthenticator()
 {
     PEG_METHOD_ENTER(TRC_AUTHENTICATION,
@@ -104,6 +140,10 @@ PAMBasicAuthenticator::PAMBasicAuthenticator()
     _realm.append(System::getHostName());
     _realm.append(Char16('"'));
 
+#if USEXENAPIAUTH
+    _loadXenLibrary();
+#endif
+
     PEG_METHOD_EXIT();
 }
 
@@ -112,6 +152,8 @@ PAMBasicAuthenticator::~PAMBasicAuthenticator()
     PEG_METHOD_ENTER(TRC_AUTHENTICATION,
         "PAMBasicAuthenticator::~PAMBasicAuthenticator()");
 
+    _traceLatency();
+
     PEG_METHOD_EXIT();
 }
 
@@ -122,24 +164,101 @@ Boolean PAMBasicAuthenticator::authenticate(
     PEG_METHOD_ENTER(TRC_AUTHENTICATION,
         "PAMBasicAuthenticator::authenticate()");
 
+    Uint64 startTime = TimeValue::getCurrentTime().toMicroseconds();
+
+    _configureCache();
+
+    if (_cache.lookup(userName, password))
+    {
+        PEG_TRACE((TRC_AUTHENTICATION, Tracer::LEVEL4,
+            "Credentials of user %s found in the authentication cache.",
+            (const char*)userName.getCString()));
+        _recordLatency(true, startTime);
+        PEG_METHOD_EXIT();
+        return true;
+    }
+
+    Boolean authenticated = _verifyPassword(userName, password);
+
+    if (authenticated)
+    {
+        _cache.insert(userName, password);
+    }
+    else
+    {
+        // the password may have been changed
+        _cache.remove(userName);
+    }
+
+    _recordLatency(false, startTime);
+
+    PEG_METHOD_EXIT();
+    return authenticated;
+}
+
+Boolean PAMBasicAuthenticator::_verifyPassword(
+    const String& userName,
+    const String& password)
+{
 #if USEXENAPIAUTH
     CString usercs = userName.getCString();
     CString passcs = password.getCString();
     const char* user = (const char *)usercs;
     const char* pass = (const char *)passcs;
     //we use xenapi to do the authentication (for AD authentication support and so on).
-    if(!xenapi_authenticate(user, pass))
-        return false;
+    return xenapi_authenticate(user, pass);
 #else
-    if (Executor::authenticatePassword(
-        userName.getCString(), password.getCString()) != 0)
+    return Executor::authenticatePassword(
+        userName.getCString(), password.getCString()) == 0;
+#endif
+}
+
+void PAMBasicAuthenticator::_configureCache()
+{
+    ConfigManager* configManager = ConfigManager::getInstance();
+    Uint64 capacity = 0;
+    Uint64 timeout = 0;
+
+    StringConversion::decimalStringToUint64(configManager->getCurrentValue(
+        "basicAuthenticationCacheSize").getCString(), capacity);
+    StringConversion::decimalStringToUint64(configManager->getCurrentValue(
+        "basicAuthenticationCacheTimeout").getCString(), timeout);
+
+    // a change of either property discards the cached credentials
+    _cache.configure((Uint32)capacity, (Uint32)timeout);
+}
+
+void PAMBasicAuthenticator::_recordLatency(Boolean cacheHit, Uint64 startTime)
+{
+    _cache.recordLatency(cacheHit,
+        TimeValue::getCurrentTime().toMicroseconds() - startTime);
+
+    _authenticationCount++;
+
+    if (_authenticationCount.get() % 1000 == 0)
     {
-        return false;
+        _traceLatency();
     }
-#endif
+}
 
-    PEG_METHOD_EXIT();
-    return true;
+void PAMBasicAuthenticator::_traceLatency()
+{
+    BasicAuthenticationCache::Latency hits;
+    BasicAuthenticationCache::Latency misses;
+    _cache.getLatency(hits, misses);
+
+    PEG_TRACE((TRC_AUTHENTICATION, Tracer::LEVEL3,
+        "Basic authentication latency (microseconds): "
+            "%" PEGASUS_64BIT_CONVERSION_WIDTH "u cache hits "
+            "p50 %" PEGASUS_64BIT_CONVERSION_WIDTH "u "
+            "p90 %" PEGASUS_64BIT_CONVERSION_WIDTH "u "
+            "p99 %" PEGASUS_64BIT_CONVERSION_WIDTH "u, "
+            "%" PEGASUS_64BIT_CONVERSION_WIDTH "u cache misses "
+            "p50 %" PEGASUS_64BIT_CONVERSION_WIDTH "u "
+            "p90 %" PEGASUS_64BIT_CONVERSION_WIDTH "u "
+            "p99 %" PEGASUS_64BIT_CONVERSION_WIDTH "u",
+        hits.count, hits.p50, hits.p90, hits.p99,
+        misses.count, misses.p50, misses.p90, misses.p99));
 }
 
 Boolean PAMBasicAuthenticator::validateUser(const String& userName)
@@ -0,0 +1,262 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/Threads.h>
+#include <Pegasus/Security/Authentication/BasicAuthenticationCache.h>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+static Boolean verbose;
+
+// Returns the digest in lower case hexadecimal.
+static String toHex(const Uint8* digest)
+{
+    char hex[65];
+
+    for (Uint32 i = 0; i < 32; i++)
+        sprintf(hex + i * 2, "%02x", digest[i]);
+
+    return String(hex);
+}
+
+static void testSha256()
+{
+    // FIPS 180-2, appendix B
+    static const struct
+    {
+        const char* message;
+        const char* digest;
+    } vectors[] =
+    {
+        {
+            "abc",
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"
+        },
+        {
+            "",
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"
+        },
+        {
+            "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"
+        }
+    };
+
+    Uint8 digest[32];
+
+    for (Uint32 i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+    {
+        BasicAuthenticationCache::sha256(
+            vectors[i].message, (Uint32)strlen(vectors[i].message), digest);
+        PEGASUS_TEST_ASSERT(toHex(digest) == vectors[i].digest);
+    }
+
+    // One million repetitions of "a", which spans many blocks
+    char* million = new char[1000000];
+    memset(million, 'a', 1000000);
+    BasicAuthenticationCache::sha256(million, 1000000, digest);
+    delete [] million;
+    PEGASUS_TEST_ASSERT(toHex(digest) ==
+        "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+static void testHmacSha256()
+{
+    // RFC 4231, test cases 2 and 6 (a key longer than the block size)
+    Uint8 digest[32];
+    const char* data = "what do ya want for nothing?";
+    BasicAuthenticationCache::hmacSha256(
+        "Jefe", 4, data, (Uint32)strlen(data), digest);
+    PEGASUS_TEST_ASSERT(toHex(digest) ==
+        "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+    Uint8 key[131];
+    memset(key, 0xaa, sizeof(key));
+    data = "Test Using Larger Than Block-Size Key - Hash Key First";
+    BasicAuthenticationCache::hmacSha256(
+        key, sizeof(key), data, (Uint32)strlen(data), digest);
+    PEGASUS_TEST_ASSERT(toHex(digest) ==
+        "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+}
+
+static void testDisabled()
+{
+    BasicAuthenticationCache cache;
+
+    // The cache is disabled until it is configured.
+    cache.insert("guest", "guest");
+    PEGASUS_TEST_ASSERT(cache.size() == 0);
+    PEGASUS_TEST_ASSERT(!cache.lookup("guest", "guest"));
+
+    // A timeout of zero disables it as well.
+    cache.configure(10, 0);
+    cache.insert("guest", "guest");
+    PEGASUS_TEST_ASSERT(cache.size() == 0);
+}
+
+static void testLookup()
+{
+    BasicAuthenticationCache cache;
+    cache.configure(10, 60);
+
+    PEGASUS_TEST_ASSERT(!cache.lookup("guest", "guest"));
+
+    cache.insert("guest", "guest");
+    PEGASUS_TEST_ASSERT(cache.size() == 1);
+    PEGASUS_TEST_ASSERT(cache.lookup("guest", "guest"));
+
+    // Only the verified password is accepted.
+    PEGASUS_TEST_ASSERT(!cache.lookup("guest", "Guest"));
+    PEGASUS_TEST_ASSERT(!cache.lookup("guest", "guest "));
+    PEGASUS_TEST_ASSERT(!cache.lookup("guest", ""));
+    PEGASUS_TEST_ASSERT(!cache.lookup("Guest", "guest"));
+
+    // The user name and password are hashed with a separator, so moving
+    // characters between them does not match.
+    cache.insert("ab", "c");
+    PEGASUS_TEST_ASSERT(!cache.lookup("a", "bc"));
+    PEGASUS_TEST_ASSERT(cache.lookup("ab", "c"));
+
+    // A new verification replaces the entry of the user.
+    cache.insert("guest", "changed");
+    PEGASUS_TEST_ASSERT(cache.size() == 2);
+    PEGASUS_TEST_ASSERT(!cache.lookup("guest", "guest"));
+    PEGASUS_TEST_ASSERT(cache.lookup("guest", "changed"));
+
+    cache.remove("guest");
+    PEGASUS_TEST_ASSERT(!cache.lookup("guest", "changed"));
+    PEGASUS_TEST_ASSERT(cache.size() == 1);
+
+    // Reconfiguring with the same values keeps the entries, a change
+    // discards them.
+    cache.configure(10, 60);
+    PEGASUS_TEST_ASSERT(cache.size() == 1);
+    cache.configure(10, 30);
+    PEGASUS_TEST_ASSERT(cache.size() == 0);
+    PEGASUS_TEST_ASSERT(!cache.lookup("ab", "c"));
+}
+
+static void testEviction()
+{
+    BasicAuthenticationCache cache;
+    cache.configure(3, 60);
+
+    cache.insert("user1", "pw1");
+    Threads::sleep(10);
+    cache.insert("user2", "pw2");
+    Threads::sleep(10);
+    cache.insert("user3", "pw3");
+    Threads::sleep(10);
+
+    // user1 was verified longest ago and is evicted.
+    cache.insert("user4", "pw4");
+    PEGASUS_TEST_ASSERT(cache.size() == 3);
+    PEGASUS_TEST_ASSERT(!cache.lookup("user1", "pw1"));
+    PEGASUS_TEST_ASSERT(cache.lookup("user2", "pw2"));
+    PEGASUS_TEST_ASSERT(cache.lookup("user3", "pw3"));
+    PEGASUS_TEST_ASSERT(cache.lookup("user4", "pw4"));
+}
+
+static void testExpiry()
+{
+    BasicAuthenticationCache cache;
+    cache.configure(10, 1);
+
+    cache.insert("guest", "guest");
+    PEGASUS_TEST_ASSERT(cache.lookup("guest", "guest"));
+
+    Threads::sleep(1100);
+
+    PEGASUS_TEST_ASSERT(!cache.lookup("guest", "guest"));
+    PEGASUS_TEST_ASSERT(cache.size() == 0);
+}
+
+static void testLatency()
+{
+    BasicAuthenticationCache cache;
+    BasicAuthenticationCache::Latency hits;
+    BasicAuthenticationCache::Latency misses;
+
+    cache.getLatency(hits, misses);
+    PEGASUS_TEST_ASSERT(hits.count == 0 && hits.p50 == 0 && hits.p99 == 0);
+    PEGASUS_TEST_ASSERT(misses.count == 0);
+
+    // 90 fast hits and 10 slow ones
+    for (Uint32 i = 0; i < 90; i++)
+        cache.recordLatency(true, 5);
+    for (Uint32 i = 0; i < 10; i++)
+        cache.recordLatency(true, 1000);
+
+    cache.recordLatency(false, 0);
+    cache.recordLatency(false, 200000);
+
+    cache.getLatency(hits, misses);
+
+    if (verbose)
+    {
+        cout << "hits " << hits.count << " p50 " << hits.p50 << " p90 " <<
+            hits.p90 << " p99 " << hits.p99 << endl;
+        cout << "misses " << misses.count << " p50 " << misses.p50 <<
+            " p90 " << misses.p90 << " p99 " << misses.p99 << endl;
+    }
+
+    // The percentiles are the upper bounds of power-of-two buckets.
+    PEGASUS_TEST_ASSERT(hits.count == 100);
+    PEGASUS_TEST_ASSERT(hits.p50 == 7);
+    PEGASUS_TEST_ASSERT(hits.p90 == 7);
+    PEGASUS_TEST_ASSERT(hits.p99 == 1023);
+    PEGASUS_TEST_ASSERT(misses.count == 2);
+    PEGASUS_TEST_ASSERT(misses.p50 == 0);
+    PEGASUS_TEST_ASSERT(misses.p99 == 262143);
+}
+
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    testSha256();
+    testHmacSha256();
+    testDisabled();
+    testLookup();
+    testEviction();
+    testExpiry();
+    testLatency();
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+
+    return 0;
+}
@@ -102,7 +102,10 @@ static const CIMName READ_OPERATIONS [] =
     CIMName("EnumerateClasses"),
     CIMName("EnumerateInstances"),
     CIMName("ExecQuery"),
-    CIMName("GetProperty")
+    CIMName("GetProperty"),
+    CIMName("OpenEnumerateInstances"),
+    CIMName("PullInstancesWithPath"),
+    CIMName("CloseEnumeration")
 };
 
 //
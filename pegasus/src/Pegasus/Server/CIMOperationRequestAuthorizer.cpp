@@ -246,6 +246,18 @@ void CIMOperationRequestAuthorizer::handleEnqueue(Message* request)
             cimMethodName = "ExecQuery";
             break;
 
+        case CIM_OPEN_ENUMERATE_INSTANCES_REQUEST_MESSAGE:
+            cimMethodName = "OpenEnumerateInstances";
+            break;
+
+        case CIM_PULL_INSTANCES_WITH_PATH_REQUEST_MESSAGE:
+            cimMethodName = "PullInstancesWithPath";
+            break;
+
+        case CIM_CLOSE_ENUMERATION_REQUEST_MESSAGE:
+            cimMethodName = "CloseEnumeration";
+            break;
+
         case CIM_ASSOCIATORS_REQUEST_MESSAGE:
             cimMethodName = "Associators";
             break;
@@ -56,7 +56,8 @@ CIMOperationRequestDecoder::CIMOperationRequestDecoder(
     : Base(PEGASUS_QUEUENAME_OPREQDECODER),
       _outputQueue(outputQueue),
       _returnQueueId(returnQueueId),
-      _serverTerminating(false)
+      _serverTerminating(false),
+      _remoteBinaryProtocol(false)
 {
 }
 
@@ -445,14 +446,15 @@ void CIMOperationRequestDecoder::handleHTTPMessage(HTTPMessage* httpMessage)
 
     if (!contentTypeHeaderFound ||
         !HTTPMessage::parseContentTypeHeader(cimContentType, type, charset) ||
-        ((!String::equalNoCase(type, "application/xml") &&
-         !String::equalNoCase(type, "text/xml")) ||
-        !String::equalNoCase(charset, "utf-8"))
+        (((!String::equalNoCase(type, "application/xml") &&
+           !String::equalNoCase(type, "text/xml")) ||
+          !String::equalNoCase(charset, "utf-8"))
 #if defined(PEGASUS_ENABLE_PROTOCOL_BINARY)
-        && !(binaryRequest = String::equalNoCase(type,
-            "application/x-openpegasus"))
+         && !(binaryRequest = String::equalNoCase(type,
+             "application/x-openpegasus"))
 #endif
-        )
+         && !(binaryRequest = (_remoteBinaryProtocol && String::equalNoCase(
+             type, "application/x-openpegasus-compact")))))
     {
         MessageLoaderParms parms(
             "Server.CIMOperationRequestDecoder.CIMCONTENTTYPE_SYNTAX_ERROR",
@@ -493,19 +495,31 @@ void CIMOperationRequestDecoder::handleHTTPMessage(HTTPMessage* httpMessage)
         }
     }
 
+    // The binary decoder accepts only the encoding of the content type, so
+    // that the compact one is not reachable with the other content type.
+    Boolean compactBinaryRequest = binaryRequest &&
+        String::equalNoCase(type, "application/x-openpegasus-compact");
+
     // Check for "Accept: application/x-openpegasus" HTTP header to see if
-    // client can accept binary responses.
+    // client can accept binary responses. Remote clients ask for the
+    // compact encoding with "application/x-openpegasus-compact"; they get
+    // XML unless the server offers it.
 
-    bool binaryResponse;
+    bool binaryResponse = false;
+    bool compactBinaryResponse = false;
 
-    if (HTTPMessage::lookupHeader(headers, "Accept", type, true) &&
-        String::equalNoCase(type, "application/x-openpegasus"))
-    {
-        binaryResponse = true;
-    }
-    else
+    if (HTTPMessage::lookupHeader(headers, "Accept", type, true))
     {
-        binaryResponse = false;
+        if (String::equalNoCase(type, "application/x-openpegasus"))
+        {
+            binaryResponse = true;
+        }
+        else if (_remoteBinaryProtocol &&
+            String::equalNoCase(type, "application/x-openpegasus-compact"))
+        {
+            binaryResponse = true;
+            compactBinaryResponse = true;
+        }
     }
 
     // If it is a method call, then dispatch it to be handled:
@@ -526,7 +540,9 @@ void CIMOperationRequestDecoder::handleHTTPMessage(HTTPMessage* httpMessage)
         httpMessage->contentLanguages,
         closeConnect,
         binaryRequest,
-        binaryResponse);
+        compactBinaryRequest,
+        binaryResponse,
+        compactBinaryResponse);
 
     PEG_METHOD_EXIT();
 }
@@ -547,7 +563,9 @@ void CIMOperationRequestDecoder::handleMethodCall(
     const ContentLanguageList& httpContentLanguages,
     Boolean closeConnect,
     Boolean binaryRequest,
-    Boolean binaryResponse)
+    Boolean compactBinaryRequest,
+    Boolean binaryResponse,
+    Boolean compactBinaryResponse)
 {
     PEG_METHOD_ENTER(TRC_DISPATCHER,
         "CIMOperationRequestDecoder::handleMethodCall()");
@@ -584,7 +602,8 @@ void CIMOperationRequestDecoder::handleMethodCall(
     {
         Buffer buf(content, contentLength);
 
-        request.reset(BinaryCodec::decodeRequest(buf, queueId, _returnQueueId));
+        request.reset(BinaryCodec::decodeRequest(
+            buf, queueId, _returnQueueId, compactBinaryRequest));
 
         if (!request.get())
         {
@@ -972,6 +991,18 @@ void CIMOperationRequestDecoder::handleMethodCall(
                 else if (System::strcasecmp(cimMethodName, "ExecQuery") == 0)
                     request.reset(decodeExecQueryRequest(
                         queueId, parser, messageId, nameSpace));
+                else if (System::strcasecmp(
+                             cimMethodName, "OpenEnumerateInstances") == 0)
+                    request.reset(decodeOpenEnumerateInstancesRequest(
+                        queueId, parser, messageId, nameSpace));
+                else if (System::strcasecmp(
+                             cimMethodName, "PullInstancesWithPath") == 0)
+                    request.reset(decodePullInstancesWithPathRequest(
+                        queueId, parser, messageId, nameSpace));
+                else if (System::strcasecmp(
+                             cimMethodName, "CloseEnumeration") == 0)
+                    request.reset(decodeCloseEnumerationRequest(
+                        queueId, parser, messageId, nameSpace));
                 else
                 {
                     throw PEGASUS_CIM_EXCEPTION_L(CIM_ERR_NOT_SUPPORTED,
@@ -1363,6 +1394,7 @@ void CIMOperationRequestDecoder::handleMethodCall(
     request->ipAddress = ipAddress;
     request->setHttpMethod (httpMethod);
     request->binaryResponse = binaryResponse;
+    request->compactBinaryResponse = compactBinaryResponse;
 
 //l10n start
 // l10n TODO - might want to move A-L and C-L to Message
@@ -3286,6 +3318,313 @@ CIMExecQueryRequestMessage* CIMOperationRequestDecoder::decodeExecQueryRequest(
     return request.release();
 }
 
+// Gets the Uint32 value of an IPARAMVALUE; returns false if it is NULL
+static Boolean _getUint32IParamValue(
+    XmlParser& parser,
+    Boolean emptyTag,
+    Uint32& value)
+{
+    CIMValue cimValue;
+
+    if (emptyTag ||
+        !XmlReader::getValueElement(parser, CIMTYPE_UINT32, cimValue) ||
+        cimValue.isNull())
+    {
+        return false;
+    }
+
+    cimValue.get(value);
+    return true;
+}
+
+CIMOpenEnumerateInstancesRequestMessage*
+    CIMOperationRequestDecoder::decodeOpenEnumerateInstancesRequest(
+        Uint32 queueId,
+        XmlParser& parser,
+        const String& messageId,
+        const CIMNamespaceName& nameSpace)
+{
+    STAT_GETSTARTTIME
+
+    CIMName className;
+    Boolean deepInheritance = true;
+    Boolean includeClassOrigin = false;
+    CIMPropertyList propertyList;
+    String filterQueryLanguage;
+    String filterQuery;
+    Uint32 operationTimeout = 0;
+    Boolean continueOnError = false;
+    Uint32 maxObjectCount = 0;
+    Boolean duplicateParameter = false;
+    Boolean gotClassName = false;
+    Boolean gotDeepInheritance = false;
+    Boolean gotIncludeClassOrigin = false;
+    Boolean gotPropertyList = false;
+    Boolean gotFilterQueryLanguage = false;
+    Boolean gotFilterQuery = false;
+    Boolean gotOperationTimeout = false;
+    Boolean gotContinueOnError = false;
+    Boolean gotMaxObjectCount = false;
+    Boolean emptyTag;
+
+    for (const char* name;
+         XmlReader::getIParamValueTag(parser, name, emptyTag); )
+    {
+        if (System::strcasecmp(name, "ClassName") == 0)
+        {
+            XmlReader::rejectNullIParamValue(parser, emptyTag, name);
+            XmlReader::getClassNameElement(parser, className, true);
+            duplicateParameter = gotClassName;
+            gotClassName = true;
+        }
+        else if (System::strcasecmp(name, "DeepInheritance") == 0)
+        {
+            XmlReader::rejectNullIParamValue(parser, emptyTag, name);
+            XmlReader::getBooleanValueElement(parser, deepInheritance, true);
+            duplicateParameter = gotDeepInheritance;
+            gotDeepInheritance = true;
+        }
+        else if (System::strcasecmp(name, "IncludeClassOrigin") == 0)
+        {
+            XmlReader::rejectNullIParamValue(parser, emptyTag, name);
+            XmlReader::getBooleanValueElement(parser, includeClassOrigin, true);
+            duplicateParameter = gotIncludeClassOrigin;
+            gotIncludeClassOrigin = true;
+        }
+        else if (System::strcasecmp(name, "PropertyList") == 0)
+        {
+            if (!emptyTag)
+            {
+                CIMValue pl;
+                if (XmlReader::getValueArrayElement(parser, CIMTYPE_STRING, pl))
+                {
+                    Array<String> propertyListArray;
+                    pl.get(propertyListArray);
+                    Array<CIMName> cimNameArray;
+                    for (Uint32 i = 0; i < propertyListArray.size(); i++)
+                    {
+                        cimNameArray.append(propertyListArray[i]);
+                    }
+                    propertyList.set(cimNameArray);
+                }
+            }
+            duplicateParameter = gotPropertyList;
+            gotPropertyList = true;
+        }
+        else if (System::strcasecmp(name, "FilterQueryLanguage") == 0)
+        {
+            if (!emptyTag)
+            {
+                XmlReader::getStringValueElement(
+                    parser, filterQueryLanguage, false);
+            }
+            duplicateParameter = gotFilterQueryLanguage;
+            gotFilterQueryLanguage = true;
+        }
+        else if (System::strcasecmp(name, "FilterQuery") == 0)
+        {
+            if (!emptyTag)
+            {
+                XmlReader::getStringValueElement(parser, filterQuery, false);
+            }
+            duplicateParameter = gotFilterQuery;
+            gotFilterQuery = true;
+        }
+        else if (System::strcasecmp(name, "OperationTimeout") == 0)
+        {
+            // A NULL value selects the server default timeout.  Zero
+            // (no timeout) is not supported.
+            if (_getUint32IParamValue(parser, emptyTag, operationTimeout) &&
+                operationTimeout == 0)
+            {
+                throw PEGASUS_CIM_EXCEPTION(
+                    CIM_ERR_INVALID_OPERATION_TIMEOUT, String::EMPTY);
+            }
+            duplicateParameter = gotOperationTimeout;
+            gotOperationTimeout = true;
+        }
+        else if (System::strcasecmp(name, "ContinueOnError") == 0)
+        {
+            XmlReader::rejectNullIParamValue(parser, emptyTag, name);
+            XmlReader::getBooleanValueElement(parser, continueOnError, true);
+            duplicateParameter = gotContinueOnError;
+            gotContinueOnError = true;
+        }
+        else if (System::strcasecmp(name, "MaxObjectCount") == 0)
+        {
+            XmlReader::rejectNullIParamValue(parser, emptyTag, name);
+            _getUint32IParamValue(parser, emptyTag, maxObjectCount);
+            duplicateParameter = gotMaxObjectCount;
+            gotMaxObjectCount = true;
+        }
+        else
+        {
+            throw PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED, String::EMPTY);
+        }
+
+        if (!emptyTag)
+        {
+            XmlReader::expectEndTag(parser, "IPARAMVALUE");
+        }
+
+        if (duplicateParameter)
+        {
+            throw PEGASUS_CIM_EXCEPTION(
+                CIM_ERR_INVALID_PARAMETER, String::EMPTY);
+        }
+    }
+
+    if (!gotClassName)
+    {
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_INVALID_PARAMETER, String::EMPTY);
+    }
+
+    AutoPtr<CIMOpenEnumerateInstancesRequestMessage> request(
+        new CIMOpenEnumerateInstancesRequestMessage(
+            messageId,
+            nameSpace,
+            className,
+            deepInheritance,
+            includeClassOrigin,
+            propertyList,
+            filterQueryLanguage,
+            filterQuery,
+            operationTimeout,
+            continueOnError,
+            maxObjectCount,
+            QueueIdStack(queueId, _returnQueueId)));
+
+    STAT_SERVERSTART
+
+    return request.release();
+}
+
+CIMPullInstancesWithPathRequestMessage*
+    CIMOperationRequestDecoder::decodePullInstancesWithPathRequest(
+        Uint32 queueId,
+        XmlParser& parser,
+        const String& messageId,
+        const CIMNamespaceName& nameSpace)
+{
+    STAT_GETSTARTTIME
+
+    String enumerationContext;
+    Uint32 maxObjectCount = 0;
+    Boolean duplicateParameter = false;
+    Boolean gotEnumerationContext = false;
+    Boolean gotMaxObjectCount = false;
+    Boolean emptyTag;
+
+    for (const char* name;
+         XmlReader::getIParamValueTag(parser, name, emptyTag); )
+    {
+        if (System::strcasecmp(name, "EnumerationContext") == 0)
+        {
+            XmlReader::rejectNullIParamValue(parser, emptyTag, name);
+            XmlReader::getStringValueElement(parser, enumerationContext, true);
+            duplicateParameter = gotEnumerationContext;
+            gotEnumerationContext = true;
+        }
+        else if (System::strcasecmp(name, "MaxObjectCount") == 0)
+        {
+            XmlReader::rejectNullIParamValue(parser, emptyTag, name);
+            _getUint32IParamValue(parser, emptyTag, maxObjectCount);
+            duplicateParameter = gotMaxObjectCount;
+            gotMaxObjectCount = true;
+        }
+        else
+        {
+            throw PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED, String::EMPTY);
+        }
+
+        if (!emptyTag)
+        {
+            XmlReader::expectEndTag(parser, "IPARAMVALUE");
+        }
+
+        if (duplicateParameter)
+        {
+            throw PEGASUS_CIM_EXCEPTION(
+                CIM_ERR_INVALID_PARAMETER, String::EMPTY);
+        }
+    }
+
+    if (!gotEnumerationContext || !gotMaxObjectCount)
+    {
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_INVALID_PARAMETER, String::EMPTY);
+    }
+
+    AutoPtr<CIMPullInstancesWithPathRequestMessage> request(
+        new CIMPullInstancesWithPathRequestMessage(
+            messageId,
+            nameSpace,
+            enumerationContext,
+            maxObjectCount,
+            QueueIdStack(queueId, _returnQueueId)));
+
+    STAT_SERVERSTART
+
+    return request.release();
+}
+
+CIMCloseEnumerationRequestMessage*
+    CIMOperationRequestDecoder::decodeCloseEnumerationRequest(
+        Uint32 queueId,
+        XmlParser& parser,
+        const String& messageId,
+        const CIMNamespaceName& nameSpace)
+{
+    STAT_GETSTARTTIME
+
+    String enumerationContext;
+    Boolean duplicateParameter = false;
+    Boolean gotEnumerationContext = false;
+    Boolean emptyTag;
+
+    for (const char* name;
+         XmlReader::getIParamValueTag(parser, name, emptyTag); )
+    {
+        if (System::strcasecmp(name, "EnumerationContext") == 0)
+        {
+            XmlReader::rejectNullIParamValue(parser, emptyTag, name);
+            XmlReader::getStringValueElement(parser, enumerationContext, true);
+            duplicateParameter = gotEnumerationContext;
+            gotEnumerationContext = true;
+        }
+        else
+        {
+            throw PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED, String::EMPTY);
+        }
+
+        if (!emptyTag)
+        {
+            XmlReader::expectEndTag(parser, "IPARAMVALUE");
+        }
+
+        if (duplicateParameter)
+        {
+            throw PEGASUS_CIM_EXCEPTION(
+                CIM_ERR_INVALID_PARAMETER, String::EMPTY);
+        }
+    }
+
+    if (!gotEnumerationContext)
+    {
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_INVALID_PARAMETER, String::EMPTY);
+    }
+
+    AutoPtr<CIMCloseEnumerationRequestMessage> request(
+        new CIMCloseEnumerationRequestMessage(
+            messageId,
+            nameSpace,
+            enumerationContext,
+            QueueIdStack(queueId, _returnQueueId)));
+
+    STAT_SERVERSTART
+
+    return request.release();
+}
+
 CIMInvokeMethodRequestMessage*
     CIMOperationRequestDecoder::decodeInvokeMethodRequest(
         Uint32 queueId,
@@ -3323,4 +3662,9 @@ void CIMOperationRequestDecoder::setServerTerminating(Boolean flag)
     _serverTerminating = flag;
 }
 
+void CIMOperationRequestDecoder::setRemoteBinaryProtocol(Boolean flag)
+{
+    _remoteBinaryProtocol = flag;
+}
+
 PEGASUS_NAMESPACE_END
@@ -107,7 +107,9 @@ public:
         const ContentLanguageList& httpContentLanguages,
         Boolean closeConnect,
         Boolean binaryRequest,
-        Boolean binaryResponse);
+        Boolean compactBinaryRequest,
+        Boolean binaryResponse,
+        Boolean compactBinaryResponse);
 
     CIMCreateClassRequestMessage* decodeCreateClassRequest(
         Uint32 queueId,
@@ -248,6 +250,25 @@ public:
         const String& messageId,
         const CIMNamespaceName& nameSpace);
 
+    CIMOpenEnumerateInstancesRequestMessage*
+        decodeOpenEnumerateInstancesRequest(
+            Uint32 queueId,
+            XmlParser& parser,
+            const String& messageId,
+            const CIMNamespaceName& nameSpace);
+
+    CIMPullInstancesWithPathRequestMessage* decodePullInstancesWithPathRequest(
+        Uint32 queueId,
+        XmlParser& parser,
+        const String& messageId,
+        const CIMNamespaceName& nameSpace);
+
+    CIMCloseEnumerationRequestMessage* decodeCloseEnumerationRequest(
+        Uint32 queueId,
+        XmlParser& parser,
+        const String& messageId,
+        const CIMNamespaceName& nameSpace);
+
     CIMInvokeMethodRequestMessage* decodeInvokeMethodRequest(
         Uint32 queueId,
         XmlParser& parser,
@@ -260,6 +281,11 @@ public:
     */
     void setServerTerminating(Boolean flag);
 
+    /** Sets whether remote clients may use the compact encoding of the
+        binary protocol (enableRemoteBinaryProtocol config property).
+    */
+    void setRemoteBinaryProtocol(Boolean flag);
+
 private:
 
     // Do not make _outputQueue an AutoPtr.
@@ -270,6 +296,9 @@ private:
 
     // Flag to indicate whether or not the CIMServer is shutting down.
     Boolean _serverTerminating;
+
+    // Accept requests and offer responses in the compact binary encoding.
+    Boolean _remoteBinaryProtocol;
 };
 
 PEGASUS_NAMESPACE_END
@@ -97,6 +97,7 @@ OperationAggregate::OperationAggregate(
     _totalReceivedNotSupported = 0;
     _magicNumber = 12345;
     _aggregationSN = 0;
+    _enumerationContext = 0;
 }
 
 OperationAggregate::~OperationAggregate()
@@ -713,6 +714,26 @@ Boolean CIMOperationRequestDispatcher::_enqueueResponse(
 
         isComplete = response->isComplete();
 
+        // The responses of an enumeration opened by a pull operation are
+        // cached in its context until the client pulls them
+
+        if (poA->_enumerationContext)
+        {
+            CIMResponseMessage* enumResponse = response;
+            response = 0;
+
+            CIMResponseMessage* pullResponse =
+                _enumerationContextTable.putCache(
+                    poA->_enumerationContext, enumResponse, isComplete);
+
+            if (pullResponse)
+            {
+                _enqueueEnumerationResponse(pullResponse);
+            }
+
+            return isComplete;
+        }
+
         // can the destination service queue handle async responses ?
         // (i.e multiple responses from one request). Certain known ones
         // cannot handle it. Most notably, the internal client.
@@ -767,7 +788,8 @@ Boolean CIMOperationRequestDispatcher::_enqueueResponse(
             func,
             failMsg));
 
-        if (response->cimException.getCode() != CIM_ERR_SUCCESS)
+        if (response &&
+            response->cimException.getCode() != CIM_ERR_SUCCESS)
             response->cimException =
                 CIMException(CIM_ERR_FAILED, String(failMsg));
     }
@@ -1915,7 +1937,9 @@ void CIMOperationRequestDispatcher::_forwardForAggregationCallback(
     // Before resequencing, the isComplete() flag represents the completion
     // status of one provider's response, not the entire response
 
-    if (response->isComplete())
+    Boolean providerComplete = response->isComplete();
+
+    if (providerComplete)
     {
         // these are per provider instantiations
         PEG_TRACE_CSTRING(TRC_DISPATCHER, Tracer::LEVEL4,
@@ -1947,11 +1971,265 @@ void CIMOperationRequestDispatcher::_forwardForAggregationCallback(
     {
         PEG_TRACE_CSTRING(TRC_DISPATCHER, Tracer::LEVEL4,
         "The response to a request is not complete.");
+
+        // The provider continues once the client has pulled the cached
+        // instances.  Its final response is still to come, so the aggregate
+        // remains valid while it waits.  A thread that reads the responses
+        // of a provider agent serves other requests too and does not wait.
+        if (!providerComplete && poA->_enumerationContext)
+        {
+            Boolean sharedThread = false;
+            Thread* thread = Thread::getCurrent();
+            if (thread)
+            {
+                sharedThread =
+                    thread->reference_tsd(TSD_SHARED_RESPONSE_THREAD) != 0;
+                thread->dereference_tsd();
+            }
+
+            if (!sharedThread)
+            {
+                service->_enumerationContextTable.waitCacheSpace(
+                    poA->_enumerationContext);
+            }
+        }
+    }
+
+    PEG_METHOD_EXIT();
+}
+
+
+/*  The repository classes of an EnumerateInstances request, handed to the
+    thread that enumerates them.
+*/
+struct RepositoryEnumeration
+{
+    CIMOperationRequestDispatcher* service;
+    AutoPtr<CIMEnumerateInstancesRequestMessage> request;
+    OperationAggregate* poA;
+    Array<CIMName> classNames;
+};
+
+/*  State of the enumeration of the instances of one repository class.
+    Each batch is held back until the next one arrives, so that the last
+    batch can be forwarded as the complete response for the class.
+*/
+struct RepositoryEnumerationState
+{
+    CIMOperationRequestDispatcher* service;
+    CIMEnumerateInstancesRequestMessage* request;
+    OperationAggregate* poA;
+    Array<CIMInstance> instances;
+    Uint32 numResponses;
+    // Set when the callback has ended the enumeration
+    Boolean stopped;
+};
+
+/*  Callback of CIMRepository::enumerateInstancesForClass(). Forwards the
+    previous batch of instances as an incomplete response of the class.
+    Returns false, ending the enumeration, once the enumeration context of
+    a pull operation has been closed or has failed.
+*/
+Boolean CIMOperationRequestDispatcher::_forwardRepositoryInstancesCallback(
+    const Array<CIMInstance>& instances,
+    void* userData)
+{
+    RepositoryEnumerationState* state =
+        reinterpret_cast<RepositoryEnumerationState*>(userData);
+
+    if (state->instances.size())
+    {
+        CIMResponseMessage* response = state->request->buildResponse();
+        static_cast<CIMEnumerateInstancesResponseMessage*>(response)->
+            getResponseData().setInstances(state->instances);
+        response->setComplete(false);
+        response->setIndex(state->numResponses++);
+
+        // The complete response of the class is still to come, so this
+        // cannot complete the aggregate.
+        OperationAggregate* poA = state->poA;
+        state->service->_enqueueResponse(poA, response);
+        state->instances.clear();
+
+        // Let the client pull the cached instances before reading more,
+        // and stop reading once the enumeration is closed or has failed.
+        if (state->poA->_enumerationContext &&
+            !state->service->_enumerationContextTable.waitCacheSpace(
+                state->poA->_enumerationContext))
+        {
+            state->stopped = true;
+            return false;
+        }
+    }
+
+    state->instances = instances;
+    return true;
+}
+
+/*  Enumerates the instances of the given repository classes and forwards
+    them for aggregation, one complete response per class.  If
+    streamInstances is true, the instances are read a batch at a time and
+    the batches are forwarded as they are read.  In that case this must not
+    be called by the thread that delivered the request.
+*/
+void CIMOperationRequestDispatcher::_enumerateRepositoryInstances(
+    CIMEnumerateInstancesRequestMessage* request,
+    OperationAggregate* poA,
+    const Array<CIMName>& classNames,
+    Boolean streamInstances)
+{
+    PEG_METHOD_ENTER(TRC_DISPATCHER,
+        "CIMOperationRequestDispatcher::_enumerateRepositoryInstances");
+
+    Uint32 aggregationSN = poA->_aggregationSN;
+    Boolean stopped = false;
+
+    for (Uint32 i = 0; i < classNames.size(); i++)
+    {
+        PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL4,
+            "Routing EnumerateInstances request for class %s to the "
+                "repository.  Repository class # %u of %u, "
+                "aggregation SN %u.",
+            CSTRING(classNames[i].getString()),
+            (unsigned int)(i + 1),
+            (unsigned int)classNames.size(),
+            (unsigned int)aggregationSN));
+
+        CIMResponseMessage* response = request->buildResponse();
+
+        CIMException cimException;
+        Array<CIMInstance> cimNamedInstances;
+
+        RepositoryEnumerationState state;
+        state.service = this;
+        state.request = request;
+        state.poA = poA;
+        state.numResponses = 0;
+        state.stopped = false;
+
+        try
+        {
+            if (stopped)
+            {
+                // The enumeration is closed or has failed; the remaining
+                // classes only complete their part of the aggregate.
+            }
+            else if (streamInstances)
+            {
+                _repository->enumerateInstancesForClass(
+                    request->nameSpace,
+                    classNames[i],
+                    PEGASUS_REPOSITORY_ENUMERATION_BATCH_SIZE,
+                    _forwardRepositoryInstancesCallback,
+                    &state);
+            }
+            else
+            {
+                // Enumerate instances only for this class
+                cimNamedInstances =
+                    _repository->enumerateInstancesForClass(
+                        request->nameSpace,
+                        classNames[i],
+                        request->includeQualifiers,
+                        request->includeClassOrigin,
+                        request->propertyList);
+            }
+        }
+        catch (const CIMException& exception)
+        {
+            cimException = exception;
+        }
+        catch (const Exception& exception)
+        {
+            cimException = PEGASUS_CIM_EXCEPTION(CIM_ERR_FAILED,
+                exception.getMessage());
+        }
+        catch (...)
+        {
+            cimException = PEGASUS_CIM_EXCEPTION(CIM_ERR_FAILED,
+                String::EMPTY);
+        }
+
+        if (state.stopped)
+        {
+            PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL4,
+                "Repository enumeration of class %s stopped, the "
+                    "enumeration context is closed or has failed.",
+                CSTRING(classNames[i].getString())));
+            stopped = true;
+        }
+
+        if (streamInstances)
+        {
+            static_cast<CIMEnumerateInstancesResponseMessage*>(response)->
+                getResponseData().setInstances(state.instances);
+
+            // The complete response accounts for the incomplete ones
+            // forwarded before it.
+            response->setIndex(state.numResponses);
+        }
+        else
+        {
+            static_cast<CIMEnumerateInstancesResponseMessage*>(response)->
+                getResponseData().setInstances(cimNamedInstances);
+        }
+        response->cimException = cimException;
+
+        // The aggregate may be deleted once the last complete response
+        // has been forwarded.
+        _forwardRequestForAggregation(
+            getQueueId(),
+            String(),
+            new CIMEnumerateInstancesRequestMessage(*request),
+            poA,
+            response);
     }
 
     PEG_METHOD_EXIT();
 }
 
+// Note: This method should not throw an exception.  It is used as a thread
+// entry point, and any exceptions thrown are ignored.
+ThreadReturnType PEGASUS_THREAD_CDECL
+CIMOperationRequestDispatcher::_enumerateRepositoryThread(void* arg)
+{
+    PEG_METHOD_ENTER(TRC_DISPATCHER,
+        "CIMOperationRequestDispatcher::_enumerateRepositoryThread");
+
+    AutoPtr<RepositoryEnumeration> enumeration(
+        reinterpret_cast<RepositoryEnumeration*>(arg));
+
+    try
+    {
+        OperationContext& context = enumeration->request->operationContext;
+
+        if (context.contains(AcceptLanguageListContainer::NAME))
+        {
+            Thread::setLanguages(((AcceptLanguageListContainer)context.get(
+                AcceptLanguageListContainer::NAME)).getLanguages());
+        }
+
+        enumeration->service->_enumerateRepositoryInstances(
+            enumeration->request.get(),
+            enumeration->poA,
+            enumeration->classNames,
+            true);
+    }
+    catch (const Exception& e)
+    {
+        PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+            "Unexpected exception in _enumerateRepositoryThread: %s",
+            (const char*)e.getMessage().getCString()));
+    }
+    catch (...)
+    {
+        PEG_TRACE_CSTRING(TRC_DISCARDED_DATA, Tracer::LEVEL1,
+            "Unexpected exception in _enumerateRepositoryThread.");
+    }
+
+    PEG_METHOD_EXIT();
+    return ThreadReturnType(0);
+}
 
 /*  Common Dispatcher callback.
 */
@@ -2253,6 +2531,24 @@ void CIMOperationRequestDispatcher::_enqueueResponse(
     PEG_METHOD_EXIT();
 }
 
+void CIMOperationRequestDispatcher::_enqueueEnumerationResponse(
+    CIMResponseMessage* response)
+{
+    MessageQueue* queue = MessageQueue::lookup(response->dest);
+
+    if (queue)
+    {
+        queue->enqueue(response);
+    }
+    else
+    {
+        PEG_TRACE((TRC_DISCARDED_DATA, Tracer::LEVEL1,
+            "Discarding response to a pull operation: queue %u not found",
+            response->dest));
+        delete response;
+    }
+}
+
 void CIMOperationRequestDispatcher::handleEnqueue(Message* request)
 {
     PEG_METHOD_ENTER(TRC_DISPATCHER,
@@ -2413,6 +2709,21 @@ void CIMOperationRequestDispatcher::handleEnqueue(Message* request)
                 (CIMInvokeMethodRequestMessage*)opRequest);
             break;
 
+        case CIM_OPEN_ENUMERATE_INSTANCES_REQUEST_MESSAGE:
+            handleOpenEnumerateInstancesRequest(
+                (CIMOpenEnumerateInstancesRequestMessage*)opRequest);
+            break;
+
+        case CIM_PULL_INSTANCES_WITH_PATH_REQUEST_MESSAGE:
+            handlePullInstancesWithPathRequest(
+                (CIMPullInstancesWithPathRequestMessage*)opRequest);
+            break;
+
+        case CIM_CLOSE_ENUMERATION_REQUEST_MESSAGE:
+            handleCloseEnumerationRequest(
+                (CIMCloseEnumerationRequestMessage*)opRequest);
+            break;
+
         default:
             PEGASUS_ASSERT(0);
         }
@@ -3075,6 +3386,18 @@ void CIMOperationRequestDispatcher::handleEnumerateInstancesRequest(
     PEG_METHOD_ENTER(TRC_DISPATCHER,
         "CIMOperationRequestDispatcher::handleEnumerateInstancesRequest");
 
+    _enumerateInstances(request, 0);
+
+    PEG_METHOD_EXIT();
+}
+
+void CIMOperationRequestDispatcher::_enumerateInstances(
+    CIMEnumerateInstancesRequestMessage* request,
+    PullEnumerationContext* enumerationContext)
+{
+    PEG_METHOD_ENTER(TRC_DISPATCHER,
+        "CIMOperationRequestDispatcher::_enumerateInstances");
+
     //
     // Validate the class name and set the request propertry list
     //
@@ -3089,13 +3412,8 @@ void CIMOperationRequestDispatcher::handleEnumerateInstancesRequest(
 
         if (checkClassException.getCode() != CIM_ERR_SUCCESS)
         {
-            CIMResponseMessage* response = request->buildResponse();
-            response->cimException = checkClassException;
-
-            _enqueueResponse(request, response);
-
             PEG_METHOD_EXIT();
-            return;
+            throw checkClassException;
         }
 
         PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL4,"PropertyList = %s",
@@ -3145,14 +3463,8 @@ void CIMOperationRequestDispatcher::handleEnumerateInstancesRequest(
             "CIM_ERROR_NOT_SUPPORTED for %s",
             (const char*)request->className.getString().getCString()));
 
-        CIMResponseMessage* response = request->buildResponse();
-        response->cimException =
-            PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED, String::EMPTY);
-
-        _enqueueResponse(request, response);
-
         PEG_METHOD_EXIT();
-        return;
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED, String::EMPTY);
     }
 
     //
@@ -3169,91 +3481,19 @@ void CIMOperationRequestDispatcher::handleEnumerateInstancesRequest(
         request->className);
 
     poA->_aggregationSN = cimOperationAggregationSN++;
+    poA->_enumerationContext = enumerationContext;
     Uint32 numClasses = providerInfos.size();
 
-    // gather up the repository responses and send it to out as one response
-    // with many instances
-    if (_repository->isDefaultInstanceProvider())
-    {
-        // Loop through providerInfos, forwarding requests to repository
-        for (Uint32 i = 0; i < numClasses; i++)
-        {
-            ProviderInfo& providerInfo = providerInfos[i];
+    // Each class served by the repository contributes its own response, so
+    // that a chunked response carries its instances to the client without
+    // waiting for the whole repository walk to complete.
+    Boolean enumerateRepository = _repository->isDefaultInstanceProvider();
+    Uint32 repositoryCount =
+        enumerateRepository ? numClasses - providerCount : 0;
 
-            // this class is registered to a provider - skip
-            if (providerInfo.hasProvider)
-                continue;
-
-            PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL4,
-                "Routing EnumerateInstances request for class %s to the "
-                    "repository.  Class # %u of %u, aggregation SN %u.",
-                CSTRING(providerInfo.className.getString()),
-                (unsigned int)(i + 1),
-                (unsigned int)numClasses,
-                (unsigned int)(poA->_aggregationSN)));
-
-            AutoPtr<CIMEnumerateInstancesResponseMessage> response(
-                dynamic_cast<CIMEnumerateInstancesResponseMessage*>(
-                    request->buildResponse()));
-
-            CIMException cimException;
-            Array<CIMInstance> cimNamedInstances;
-
-            try
-            {
-                // Enumerate instances only for this class
-                cimNamedInstances =
-                    _repository->enumerateInstancesForClass(
-                        request->nameSpace,
-                        providerInfo.className,
-                        request->includeQualifiers,
-                        request->includeClassOrigin,
-                        request->propertyList);
-            }
-            catch (const CIMException& exception)
-            {
-                cimException = exception;
-            }
-            catch (const Exception& exception)
-            {
-                cimException = PEGASUS_CIM_EXCEPTION(CIM_ERR_FAILED,
-                    exception.getMessage());
-            }
-            catch (...)
-            {
-                cimException = PEGASUS_CIM_EXCEPTION(CIM_ERR_FAILED,
-                    String::EMPTY);
-            }
-
-            response->getResponseData().setInstances(cimNamedInstances);
-            response->cimException = cimException;
-
-            poA->appendResponse(response.release());
-        } // for all classes and derived classes
-
-        Uint32 numberResponses = poA->numberResponses();
-        Uint32 totalIssued = providerCount + (numberResponses > 0 ? 1 : 0);
-        poA->setTotalIssued(totalIssued);
-
-        if (numberResponses > 0)
-        {
-            handleEnumerateInstancesResponseAggregation(poA);
-
-            CIMResponseMessage* response = poA->removeResponse(0);
-
-            _forwardRequestForAggregation(
-                getQueueId(),
-                String(),
-                new CIMEnumerateInstancesRequestMessage(*request),
-                poA,
-                response);
-        }
-    } // if isDefaultInstanceProvider
-    else
-    {
-        // Set the number of expected responses in the OperationAggregate
-        poA->setTotalIssued(providerCount);
-    }
+    // Set the number of expected responses in the OperationAggregate before
+    // any of them can arrive
+    poA->setTotalIssued(providerCount + repositoryCount);
 
     PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL4,
         "Beginning to forward requests to a subset of %u classes.",
@@ -3332,6 +3572,228 @@ void CIMOperationRequestDispatcher::handleEnumerateInstancesRequest(
         }
     } // for all classes and dervied classes
 
+
+    // The providers are now working on their share of the enumeration.
+    // Enumerate the repository classes meanwhile and forward the instances
+    // of each class as soon as they have been read. These responses are
+    // counted in the total issued above, so the aggregate remains valid
+    // until the last of them has been forwarded.
+    if (enumerateRepository)
+    {
+        Array<CIMName> classNames;
+
+        for (Uint32 i = 0; i < numClasses; i++)
+        {
+            // this class is registered to a provider - skip
+            if (!providerInfos[i].hasProvider)
+                classNames.append(providerInfos[i].className);
+        }
+
+        // Without qualifiers, class origins or a property list, the
+        // instances are decoded a batch at a time, and all but the last
+        // batch of a class are forwarded as they are read.  Like a
+        // provider, the repository then delivers its responses from a
+        // thread of its own: this thread holds the connection that the
+        // responses are written to.
+        Boolean streamInstances = classNames.size() &&
+            !request->includeQualifiers &&
+            !request->includeClassOrigin &&
+            request->propertyList.isNull();
+
+        if (streamInstances)
+        {
+            RepositoryEnumeration* enumeration = new RepositoryEnumeration;
+            enumeration->service = this;
+            enumeration->request.reset(
+                new CIMEnumerateInstancesRequestMessage(*request));
+            enumeration->poA = poA;
+            enumeration->classNames = classNames;
+
+            // Rather than waiting for a thread of a busy pool, the
+            // instances are read by this thread in one piece, as they are
+            // for the filtered requests.
+            ThreadStatus rtn = MessageQueueService::get_thread_pool()->
+                allocate_and_awaken(enumeration, _enumerateRepositoryThread);
+
+            if (rtn != PEGASUS_THREAD_OK)
+            {
+                PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL2,
+                    "Could not allocate thread for %s, enumerating the "
+                        "repository instances without streaming.",
+                    getQueueName()));
+                delete enumeration;
+                streamInstances = false;
+            }
+        }
+
+        if (!streamInstances)
+        {
+            _enumerateRepositoryInstances(request, poA, classNames, false);
+        }
+    } // if enumerateRepository
+
+    PEG_METHOD_EXIT();
+}
+
+/**$*******************************************************
+    handleOpenEnumerateInstancesRequest
+
+    validate the pull parameters
+    create an enumeration context
+    start an EnumerateInstances operation whose responses are cached in
+        the context
+    return up to MaxObjectCount instances once they are available
+**********************************************************/
+
+void CIMOperationRequestDispatcher::handleOpenEnumerateInstancesRequest(
+    CIMOpenEnumerateInstancesRequestMessage* request)
+{
+    PEG_METHOD_ENTER(TRC_DISPATCHER,
+        "CIMOperationRequestDispatcher::handleOpenEnumerateInstancesRequest");
+
+    if (request->filterQueryLanguage.size() || request->filterQuery.size())
+    {
+        PEG_METHOD_EXIT();
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_FILTERED_ENUMERATION_NOT_SUPPORTED,
+            String::EMPTY);
+    }
+
+    if (request->continueOnError)
+    {
+        PEG_METHOD_EXIT();
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_CONTINUATION_ON_ERROR_NOT_SUPPORTED,
+            String::EMPTY);
+    }
+
+    if (request->operationTimeout > PEGASUS_MAX_PULL_OPERATION_TIMEOUT_SECONDS)
+    {
+        PEG_METHOD_EXIT();
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_INVALID_OPERATION_TIMEOUT,
+            String::EMPTY);
+    }
+
+    if (request->maxObjectCount > PEGASUS_MAX_PULL_OBJECT_COUNT)
+    {
+        PEG_METHOD_EXIT();
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_INVALID_PARAMETER,
+            "MaxObjectCount");
+    }
+
+    Uint32 operationTimeout = request->operationTimeout;
+    if (operationTimeout == 0)
+    {
+        operationTimeout = PEGASUS_DEFAULT_PULL_OPERATION_TIMEOUT_SECONDS;
+    }
+
+    PullEnumerationContext* enumerationContext =
+        _enumerationContextTable.createContext(
+            request->nameSpace,
+            request->userName,
+            operationTimeout,
+            request->maxObjectCount);
+
+    // The instances are enumerated by an internal EnumerateInstances
+    // request.  Qualifiers are not returned by the pull operations.
+    CIMEnumerateInstancesRequestMessage enumRequest(
+        request->messageId,
+        request->nameSpace,
+        request->className,
+        request->deepInheritance,
+        false,
+        request->includeClassOrigin,
+        request->propertyList,
+        request->queueIds,
+        request->authType,
+        request->userName);
+    enumRequest.operationContext = request->operationContext;
+    enumRequest.setMask(request->getMask());
+    enumRequest.setHttpMethod(request->getHttpMethod());
+    enumRequest.setCloseConnect(request->getCloseConnect());
+
+    try
+    {
+        _enumerateInstances(&enumRequest, enumerationContext);
+    }
+    catch (...)
+    {
+        _enumerationContextTable.removeContext(enumerationContext);
+        PEG_METHOD_EXIT();
+        throw;
+    }
+
+    CIMResponseMessage* response = _enumerationContextTable.open(
+        enumerationContext,
+        new CIMOpenEnumerateInstancesRequestMessage(*request),
+        request->maxObjectCount);
+
+    if (response)
+    {
+        _enqueueResponse(request, response);
+    }
+
+    PEG_METHOD_EXIT();
+}
+
+/**$*******************************************************
+    handlePullInstancesWithPathRequest
+
+    return up to MaxObjectCount instances of an open enumeration context
+        once they are available
+**********************************************************/
+
+void CIMOperationRequestDispatcher::handlePullInstancesWithPathRequest(
+    CIMPullInstancesWithPathRequestMessage* request)
+{
+    PEG_METHOD_ENTER(TRC_DISPATCHER,
+        "CIMOperationRequestDispatcher::handlePullInstancesWithPathRequest");
+
+    if (request->maxObjectCount > PEGASUS_MAX_PULL_OBJECT_COUNT)
+    {
+        PEG_METHOD_EXIT();
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_INVALID_PARAMETER,
+            "MaxObjectCount");
+    }
+
+    CIMResponseMessage* response = _enumerationContextTable.pull(
+        request->enumerationContext,
+        request->nameSpace,
+        request->userName,
+        new CIMPullInstancesWithPathRequestMessage(*request),
+        request->maxObjectCount);
+
+    if (response)
+    {
+        _enqueueResponse(request, response);
+    }
+
+    PEG_METHOD_EXIT();
+}
+
+/**$*******************************************************
+    handleCloseEnumerationRequest
+
+    close an open enumeration context, abandoning a pending pull
+**********************************************************/
+
+void CIMOperationRequestDispatcher::handleCloseEnumerationRequest(
+    CIMCloseEnumerationRequestMessage* request)
+{
+    PEG_METHOD_ENTER(TRC_DISPATCHER,
+        "CIMOperationRequestDispatcher::handleCloseEnumerationRequest");
+
+    CIMResponseMessage* abandonedPullResponse =
+        _enumerationContextTable.close(
+            request->enumerationContext,
+            request->nameSpace,
+            request->userName);
+
+    if (abandonedPullResponse)
+    {
+        _enqueueEnumerationResponse(abandonedPullResponse);
+    }
+
+    _enqueueResponse(request, request->buildResponse());
+
     PEG_METHOD_EXIT();
 }
 
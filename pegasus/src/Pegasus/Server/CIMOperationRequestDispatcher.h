@@ -48,6 +48,7 @@
     <Pegasus/Server/ProviderRegistrationManager/ProviderRegistrationManager.h>
 #include <Pegasus/Server/Linkage.h>
 #include <Pegasus/Server/reg_table.h>
+#include <Pegasus/Server/EnumerationContextTable.h>
 
 PEGASUS_NAMESPACE_BEGIN
 
@@ -200,6 +201,9 @@ public:
     QueryExpressionRep* _query;
     String _queryLanguage;
 
+    // Set when the responses are cached for the pull operations
+    PullEnumerationContext* _enumerationContext;
+
 private:
     /** Hidden (unimplemented) copy constructor */
     OperationAggregate(const OperationAggregate& x);
@@ -307,6 +311,15 @@ public:
     void handleInvokeMethodRequest(
         CIMInvokeMethodRequestMessage* request);
 
+    void handleOpenEnumerateInstancesRequest(
+        CIMOpenEnumerateInstancesRequestMessage* request);
+
+    void handlePullInstancesWithPathRequest(
+        CIMPullInstancesWithPathRequestMessage* request);
+
+    void handleCloseEnumerationRequest(
+        CIMCloseEnumerationRequestMessage* request);
+
     static void _forwardForAggregationCallback(
         AsyncOpNode*,
         MessageQueue*,
@@ -317,6 +330,19 @@ public:
         MessageQueue*,
         void*);
 
+    static Boolean _forwardRepositoryInstancesCallback(
+        const Array<CIMInstance>& instances,
+        void* userData);
+
+    void _enumerateRepositoryInstances(
+        CIMEnumerateInstancesRequestMessage* request,
+        OperationAggregate* poA,
+        const Array<CIMName>& classNames,
+        Boolean streamInstances);
+
+    static ThreadReturnType PEGASUS_THREAD_CDECL _enumerateRepositoryThread(
+        void* arg);
+
     // Response Handler functions
 
     void handleOperationResponseAggregation(OperationAggregate* poA);
@@ -451,6 +477,13 @@ protected:
         CIMRequestMessage* request,
         CIMResponseMessage* response);
 
+    /**
+        Sends a response to an open or pull request which was answered
+        after the request itself was processed.  The response destination
+        is set by the EnumerationContextTable.
+    */
+    void _enqueueEnumerationResponse(CIMResponseMessage* response);
+
     CIMValue _convertValueType(const CIMValue& value, CIMType type);
 
     void _fixInvokeMethodParameterTypes(CIMInvokeMethodRequestMessage* request);
@@ -489,10 +522,23 @@ protected:
         const CIMName& className,
         Uint32 providerCount);
 
+    /**
+        Issues the provider and repository requests of an instance
+        enumeration.
+        @param enumerationContext The context caching the responses for the
+            pull operations, or 0 to aggregate them into one response.
+        @exception CIMException if the enumeration cannot be started.
+    */
+    void _enumerateInstances(
+        CIMEnumerateInstancesRequestMessage* request,
+        PullEnumerationContext* enumerationContext);
+
     CIMRepository* _repository;
 
     ProviderRegistrationManager* _providerRegistrationManager;
 
+    EnumerationContextTable _enumerationContextTable;
+
     Boolean _enableAssociationTraversal;
     Boolean _enableIndicationService;
     Uint32 _maximumEnumerateBreadth;
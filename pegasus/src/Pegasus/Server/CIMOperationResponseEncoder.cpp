@@ -106,11 +106,61 @@ CIMOperationResponseEncoder::~CIMOperationResponseEncoder()
 //
 //==============================================================================
 
+typedef Buffer (*FormatResponseFunc)(
+    const CIMName& iMethodName,
+    const String& messageId,
+    HttpMethod httpMethod,
+    const ContentLanguageList& httpContentLanguages,
+    const Buffer& body,
+    Uint64 serverResponseTime,
+    Boolean isFirst,
+    Boolean isLast);
+
+// Responses with output parameters (the pull operations) are always
+// formatted as XML, even when a binary response was requested.
+static Buffer _formatResponse(
+    FormatResponseFunc formatResponse,
+    const CIMName& iMethodName,
+    const String& messageId,
+    HttpMethod httpMethod,
+    const ContentLanguageList& httpContentLanguages,
+    const Buffer& body,
+    const Buffer* rtnParams,
+    Uint64 serverResponseTime,
+    Boolean isFirst,
+    Boolean isLast)
+{
+    if (rtnParams)
+    {
+        return XmlWriter::formatSimpleIMethodRspMessage(
+            iMethodName,
+            messageId,
+            httpMethod,
+            httpContentLanguages,
+            body,
+            *rtnParams,
+            serverResponseTime,
+            isFirst,
+            isLast);
+    }
+
+    return formatResponse(
+        iMethodName,
+        messageId,
+        httpMethod,
+        httpContentLanguages,
+        body,
+        serverResponseTime,
+        isFirst,
+        isLast);
+}
+
 void CIMOperationResponseEncoder::sendResponse(
     CIMResponseMessage* response,
     const String& name,
     Boolean isImplicit,
-    Buffer* bodygiven)
+    Buffer* bodygiven,
+    Buffer* rtnParams)
 {
     PEG_METHOD_ENTER(TRC_DISPATCHER,
         "CIMOperationResponseEncoder::sendResponse");
@@ -170,15 +220,7 @@ void CIMOperationResponseEncoder::sendResponse(
     Uint64 serverTime = 0;
 #endif
 
-    Buffer (*formatResponse)(
-        const CIMName& iMethodName,
-        const String& messageId,
-        HttpMethod httpMethod,
-        const ContentLanguageList& httpContentLanguages,
-        const Buffer& body,
-        Uint64 serverResponseTime,
-        Boolean isFirst,
-        Boolean isLast);
+    FormatResponseFunc formatResponse;
 
     Buffer (*formatError)(
         const CIMName& methodName,
@@ -195,7 +237,12 @@ void CIMOperationResponseEncoder::sendResponse(
     {
         formatError = XmlWriter::formatSimpleIMethodErrorRspMessage;
 
-        if (response->binaryResponse)
+        if (response->binaryResponse && response->compactBinaryResponse)
+        {
+            formatResponse =
+                BinaryCodec::formatSimpleIMethodCompactRspMessage;
+        }
+        else if (response->binaryResponse)
         {
             formatResponse = BinaryCodec::formatSimpleIMethodRspMessage;
         }
@@ -250,34 +297,40 @@ void CIMOperationResponseEncoder::sendResponse(
 
         if (isChunkRequest == true)
         {
-            message = formatResponse(
+            _formatResponse(
+                formatResponse,
                 cimName,
                 messageId,
                 httpMethod,
                 contentLanguage,
                 body,
+                rtnParams,
                 serverTime,
                 isFirst,
-                isLast);
+                isLast).swap(message);
         }
     }
     else
     {
-        message = formatResponse(
+        _formatResponse(
+            formatResponse,
             cimName,
             messageId,
             httpMethod,
             contentLanguage,
             body,
+            rtnParams,
             serverTime,
             isFirst,
-            isLast);
+            isLast).swap(message);
 
         STAT_BYTESSENT
     }
 
+    // the formatted message is handed over without copying it
     AutoPtr<HTTPMessage> httpMessage(
-        new HTTPMessage(message, 0, &cimException));
+        new HTTPMessage(Buffer(), 0, &cimException));
+    httpMessage->message.swap(message);
     httpMessage->setComplete(isLast);
     httpMessage->setIndex(messageIndex);
 
@@ -500,6 +553,21 @@ void CIMOperationResponseEncoder::handleEnqueue(Message* message)
                 (CIMInvokeMethodResponseMessage*)message);
             break;
 
+        case CIM_OPEN_ENUMERATE_INSTANCES_RESPONSE_MESSAGE:
+            encodeOpenEnumerateInstancesResponse(
+                (CIMOpenEnumerateInstancesResponseMessage*)message);
+            break;
+
+        case CIM_PULL_INSTANCES_WITH_PATH_RESPONSE_MESSAGE:
+            encodePullInstancesWithPathResponse(
+                (CIMPullInstancesWithPathResponseMessage*)message);
+            break;
+
+        case CIM_CLOSE_ENUMERATION_RESPONSE_MESSAGE:
+            encodeCloseEnumerationResponse(
+                (CIMCloseEnumerationResponseMessage*)message);
+            break;
+
         default:
             // Unexpected message type
             PEGASUS_ASSERT(0);
@@ -761,4 +829,48 @@ void CIMOperationResponseEncoder::encodeInvokeMethodResponse(
     sendResponse(response, response->methodName.getString(), false, &body);
 }
 
+void CIMOperationResponseEncoder::_encodeOpenOrPullResponse(
+    CIMOpenOrPullResponseDataMessage* response,
+    const String& name)
+{
+    Buffer body;
+    Buffer rtnParams;
+
+    if (response->cimException.getCode() == CIM_ERR_SUCCESS)
+    {
+        response->getResponseData().encodeXmlResponse(body, true);
+
+        XmlWriter::appendParamValueElement(
+            rtnParams,
+            CIMParamValue(
+                "EndOfSequence", CIMValue(response->endOfSequence), true));
+        XmlWriter::appendParamValueElement(
+            rtnParams,
+            CIMParamValue(
+                "EnumerationContext",
+                CIMValue(response->enumerationContext),
+                true));
+    }
+
+    sendResponse(response, name, true, &body, &rtnParams);
+}
+
+void CIMOperationResponseEncoder::encodeOpenEnumerateInstancesResponse(
+    CIMOpenEnumerateInstancesResponseMessage* response)
+{
+    _encodeOpenOrPullResponse(response, "OpenEnumerateInstances");
+}
+
+void CIMOperationResponseEncoder::encodePullInstancesWithPathResponse(
+    CIMPullInstancesWithPathResponseMessage* response)
+{
+    _encodeOpenOrPullResponse(response, "PullInstancesWithPath");
+}
+
+void CIMOperationResponseEncoder::encodeCloseEnumerationResponse(
+    CIMCloseEnumerationResponseMessage* response)
+{
+    sendResponse(response, "CloseEnumeration", true);
+}
+
 PEGASUS_NAMESPACE_END
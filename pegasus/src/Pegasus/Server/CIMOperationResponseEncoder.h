@@ -57,7 +57,8 @@ public:
         CIMResponseMessage* response,
         const String& name,
         Boolean isImplicit,
-        Buffer* bodygiven = 0);
+        Buffer* bodygiven = 0,
+        Buffer* rtnParams = 0);
 
     virtual void enqueue(Message*);
 
@@ -136,6 +137,21 @@ public:
 
     void encodeInvokeMethodResponse(
         CIMInvokeMethodResponseMessage* response);
+
+    void encodeOpenEnumerateInstancesResponse(
+        CIMOpenEnumerateInstancesResponseMessage* response);
+
+    void encodePullInstancesWithPathResponse(
+        CIMPullInstancesWithPathResponseMessage* response);
+
+    void encodeCloseEnumerationResponse(
+        CIMCloseEnumerationResponseMessage* response);
+
+private:
+
+    void _encodeOpenOrPullResponse(
+        CIMOpenOrPullResponseDataMessage* response,
+        const String& name);
 };
 
 PEGASUS_NAMESPACE_END
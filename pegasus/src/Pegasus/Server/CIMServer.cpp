@@ -50,6 +50,8 @@
 #include <Pegasus/Common/Cimom.h>
 #include <Pegasus/Common/PegasusVersion.h>
 #include <Pegasus/Common/Time.h>
+#include <Pegasus/Common/ThreadPool.h>
+#include <Pegasus/Common/StringConversion.h>
 #include <Pegasus/Common/MessageLoader.h>
 #include <Pegasus/Common/AuditLogger.h>
 
@@ -258,6 +260,32 @@ SCMOClass CIMServer::_scmoClassCache_GetClass(
 void CIMServer::_init()
 {
     _monitor.reset(new Monitor());
+    _monitor->setAdmissionControl(true);
+
+    // -- Create the connection monitors, if configured:
+
+    Uint64 connectionMonitors = 1;
+    StringConversion::decimalStringToUint64(
+        ConfigManager::getInstance()->getCurrentValue(
+            "connectionMonitors").getCString(),
+        connectionMonitors);
+
+    if (connectionMonitors > 1)
+    {
+        MonitorPool::AssignmentPolicy policy = MonitorPool::ROUND_ROBIN;
+        MonitorPool::parseAssignmentPolicy(
+            ConfigManager::getInstance()->getCurrentValue(
+                "connectionMonitorAssignment"),
+            policy);
+
+        _connectionMonitors.reset(
+            new MonitorPool((Uint32)connectionMonitors, policy));
+        for (Uint32 i = 0; i < _connectionMonitors->size(); i++)
+        {
+            _connectionMonitors->getMonitor(i)->setAdmissionControl(true);
+        }
+        _connectionMonitors->start();
+    }
 
 #if (defined(PEGASUS_OS_HPUX) || defined(PEGASUS_OS_LINUX)) \
     && defined(PEGASUS_USE_RELEASE_DIRS)
@@ -296,6 +324,13 @@ void CIMServer::_init()
 
     // -- Create a SCMOClass Cache and set call back for the repository
 
+    Uint64 scmoClassCacheSize = PEGASUS_DEFAULT_SCMO_CLASS_CACHE_SIZE;
+    StringConversion::decimalStringToUint64(
+        ConfigManager::getInstance()->getCurrentValue(
+            "scmoClassCacheSize").getCString(),
+        scmoClassCacheSize);
+
+    SCMOClassCache::getInstance()->setCapacity((Uint32)scmoClassCacheSize);
     SCMOClassCache::getInstance()->setCallBack(_scmoClassCache_GetClass);
 
     // -- Create a CIMServerState object:
@@ -311,6 +346,43 @@ void CIMServer::_init()
         _repository,
         DefaultProviderManager::createDefaultProviderManagerCallback);
 
+    // -- Size the thread pool of the services:
+
+    Uint64 serviceThreadPoolMinThreads = 0;
+    StringConversion::decimalStringToUint64(
+        ConfigManager::getInstance()->getCurrentValue(
+            "serviceThreadPoolMinThreads").getCString(),
+        serviceThreadPoolMinThreads);
+    Uint64 serviceThreadPoolMaxThreads = 0;
+    StringConversion::decimalStringToUint64(
+        ConfigManager::getInstance()->getCurrentValue(
+            "serviceThreadPoolMaxThreads").getCString(),
+        serviceThreadPoolMaxThreads);
+    Uint64 serviceThreadPoolQueueSize =
+        PEGASUS_DEFAULT_SERVICE_THREAD_POOL_QUEUE_SIZE;
+    StringConversion::decimalStringToUint64(
+        ConfigManager::getInstance()->getCurrentValue(
+            "serviceThreadPoolQueueSize").getCString(),
+        serviceThreadPoolQueueSize);
+
+    // The property owner checks the minimum against the planned maximum,
+    // but both may also be set on the command line
+    if ((serviceThreadPoolMaxThreads != 0) &&
+        (serviceThreadPoolMinThreads > serviceThreadPoolMaxThreads))
+    {
+        PEG_TRACE((TRC_SERVER, Tracer::LEVEL1,
+            "serviceThreadPoolMinThreads %u exceeds "
+                "serviceThreadPoolMaxThreads %u and is reduced to it.",
+            (Uint32)serviceThreadPoolMinThreads,
+            (Uint32)serviceThreadPoolMaxThreads));
+        serviceThreadPoolMinThreads = serviceThreadPoolMaxThreads;
+    }
+
+    ThreadPool* serviceThreadPool = MessageQueueService::get_thread_pool();
+    serviceThreadPool->setMinThreads((Sint16)serviceThreadPoolMinThreads);
+    serviceThreadPool->setMaxThreads((Sint16)serviceThreadPoolMaxThreads);
+    serviceThreadPool->setMaxQueuedTasks((Uint32)serviceThreadPoolQueueSize);
+
     // Create IndicationHandlerService:
 
     _handlerService = new IndicationHandlerService(_repository);
@@ -402,7 +474,7 @@ void CIMServer::_init()
     // Create the Statistical Data control provider
     ProviderMessageHandler* cimomstatdataProvider = new ProviderMessageHandler(
         "CIMServerControlProvider", "CIMOMStatDataProvider",
-        new CIMOMStatDataProvider(), 0, 0, false);
+        new CIMOMStatDataProvider(_repository), 0, 0, false);
     _controlProviders.append(cimomstatdataProvider);
     _controlService->register_module(
         PEGASUS_MODULENAME_CIMOMSTATDATAPROVIDER,
@@ -472,6 +544,13 @@ void CIMServer::_init()
         cimOperationProcessorQueue,
         _cimOperationResponseEncoder->getQueueId());
 
+    Boolean enableRemoteBinaryProtocol = ConfigManager::parseBooleanValue(
+        ConfigManager::getInstance()->getCurrentValue(
+            "enableRemoteBinaryProtocol"));
+
+    _cimOperationRequestDecoder->setRemoteBinaryProtocol(
+        enableRemoteBinaryProtocol);
+
     _cimExportRequestDispatcher = new CIMExportRequestDispatcher();
 
     _cimExportResponseEncoder = new CIMExportResponseEncoder;
@@ -480,6 +559,9 @@ void CIMServer::_init()
         _cimExportRequestDispatcher,
         _cimExportResponseEncoder->getQueueId());
 
+    _cimExportRequestDecoder->setRemoteBinaryProtocol(
+        enableRemoteBinaryProtocol);
+
     _httpAuthenticatorDelegator = new HTTPAuthenticatorDelegator(
         _cimOperationRequestDecoder->getQueueId(),
         _cimExportRequestDecoder->getQueueId(),
@@ -576,6 +658,13 @@ CIMServer::~CIMServer ()
     // Start deleting the objects.
     // The order is very important.
 
+    // Stop the connection monitor threads before the acceptors destroy the
+    // connections they service.
+    if (_connectionMonitors.get())
+    {
+        _connectionMonitors->stop();
+    }
+
     // The HTTPAcceptor depends on HTTPAuthenticationDelegator
     for (Uint32 i = 0, n = _acceptors.size (); i < n; i++)
     {
@@ -583,6 +672,10 @@ CIMServer::~CIMServer ()
         delete p;
     }
 
+    // The connection monitors may only be deleted once all connections have
+    // been unsolicited.
+    _connectionMonitors.reset();
+
     // IndicationService depends on ProviderManagerService,
     // IndicationHandlerService, and ProviderRegistrationManager, and thus
     // should be deleted before the ProviderManagerService,
@@ -679,6 +772,11 @@ void CIMServer::addAcceptor(
         useSSL ? _getSSLContext() : 0,
         useSSL ? _sslContextMgr->getSSLContextObjectLock() : 0 );
 
+    if (_connectionMonitors.get())
+    {
+        acceptor->setConnectionMonitors(_connectionMonitors.get());
+    }
+
     _acceptors.append(acceptor);
 }
 
@@ -722,10 +820,6 @@ void CIMServer::runForever()
             {
                 _providerManager->unloadIdleProviders();
                 MessageQueueService::get_thread_pool()->cleanupIdleThreads();
-#ifdef PEGASUS_ENABLE_PROTOCOL_WSMAN
-                _wsmProcessor->cleanupExpiredContexts();
-#endif
-
             }
             catch (...)
             {
@@ -893,6 +987,12 @@ SSLContext* CIMServer::_getSSLContext()
         "sslTrustStoreUserName";
     static const String PROPERTY_NAME__HTTP_ENABLED =
         "enableHttpConnection";
+    static const String PROPERTY_NAME__SSL_SESSION_CACHE_SIZE =
+        "sslSessionCacheSize";
+    static const String PROPERTY_NAME__SSL_SESSION_TIMEOUT =
+        "sslSessionTimeout";
+    static const String PROPERTY_NAME__SSL_SESSION_TICKETS =
+        "enableSSLSessionTickets";
 
     String verifyClient;
     String trustStore;
@@ -1092,6 +1192,26 @@ SSLContext* CIMServer::_getSSLContext()
         _sslContextMgr->createSSLContext(
             String::EMPTY, certPath, keyPath, crlStore, false, randFile);
     }
+
+    //
+    // Configure the resumption of the TLS sessions.
+    //
+    Uint64 sessionCacheSize = 0;
+    StringConversion::decimalStringToUint64(
+        configManager->getCurrentValue(
+            PROPERTY_NAME__SSL_SESSION_CACHE_SIZE).getCString(),
+        sessionCacheSize);
+    Uint64 sessionTimeout = 0;
+    StringConversion::decimalStringToUint64(
+        configManager->getCurrentValue(
+            PROPERTY_NAME__SSL_SESSION_TIMEOUT).getCString(),
+        sessionTimeout);
+    Boolean sessionTickets = ConfigManager::parseBooleanValue(
+        configManager->getCurrentValue(PROPERTY_NAME__SSL_SESSION_TICKETS));
+
+    _sslContextMgr->setSessionCacheParameters(
+        (Uint32)sessionCacheSize, (Uint32)sessionTimeout, sessionTickets);
+
     sslContext = _sslContextMgr->getSSLContext();
 
     try
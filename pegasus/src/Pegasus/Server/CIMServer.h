@@ -35,6 +35,7 @@
 #include <Pegasus/Common/Config.h>
 #include <Pegasus/Common/InternalException.h>
 #include <Pegasus/Common/Monitor.h>
+#include <Pegasus/Common/MonitorPool.h>
 #include <Pegasus/Common/SSLContext.h>
 #include <Pegasus/Repository/CIMRepository.h>
 #include <Pegasus/ProviderManager2/Default/ProviderMessageHandler.h>
@@ -158,6 +159,14 @@ private:
     Boolean _dieNow;
 
     AutoPtr<Monitor> _monitor;
+
+    /**
+        Services the client connections when the connectionMonitors config
+        property is greater than 1.  Otherwise connections are serviced by
+        _monitor along with the acceptors.
+    */
+    AutoPtr<MonitorPool> _connectionMonitors;
+
     CIMRepository* _repository;
 
     CIMOperationRequestDispatcher* _cimOperationRequestDispatcher;
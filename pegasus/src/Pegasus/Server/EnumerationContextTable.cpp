@@ -0,0 +1,658 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/Constants.h>
+#include <Pegasus/Common/System.h>
+#include <Pegasus/Common/TimeValue.h>
+#include <Pegasus/Common/Tracer.h>
+#include <Pegasus/Common/InternalException.h>
+#include <Pegasus/Common/MessageQueueService.h>
+
+#include "EnumerationContextTable.h"
+
+PEGASUS_USING_STD;
+
+PEGASUS_NAMESPACE_BEGIN
+
+/**
+    Interval (milliseconds) at which the idle contexts are checked for
+    expiration.
+*/
+#define PEGASUS_ENUMERATION_CONTEXT_REAPER_INTERVAL_MSEC 1000
+
+static Uint64 _getCurrentTimeUsec()
+{
+    return TimeValue::getCurrentTime().toMicroseconds();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// PullEnumerationContext
+//
+////////////////////////////////////////////////////////////////////////////////
+
+PullEnumerationContext::PullEnumerationContext(
+    const String& contextId,
+    const CIMNamespaceName& nameSpace,
+    const String& userName,
+    Uint32 operationTimeout,
+    Uint32 maxObjectCount)
+    : _contextId(contextId),
+      _nameSpace(nameSpace),
+      _userName(userName),
+      _operationTimeout(operationTimeout),
+      _expirationTime(0),
+      _cache(CIMResponseData::RESP_INSTANCES),
+      _cacheLimit(maxObjectCount > PEGASUS_MIN_ENUMERATION_CACHE_LIMIT ?
+          maxObjectCount : PEGASUS_MIN_ENUMERATION_CACHE_LIMIT),
+      _pendingRequest(0),
+      _pendingMaxObjectCount(0),
+      _providersComplete(false),
+      _closed(false),
+      _waiters(0)
+{
+}
+
+PullEnumerationContext::~PullEnumerationContext()
+{
+    delete _pendingRequest;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// EnumerationContextTable
+//
+////////////////////////////////////////////////////////////////////////////////
+
+EnumerationContextTable::EnumerationContextTable()
+    : _cachedInstances(0),
+      _contextCounter(0),
+      _hostName(System::getHostName()),
+      _waitingThreads(0),
+      _destroying(false),
+      _stopReaper(0)
+{
+}
+
+EnumerationContextTable::~EnumerationContextTable()
+{
+    if (_reaper.get())
+    {
+        _stopReaper.signal();
+        _reaper->join();
+    }
+
+    AutoMutex autoMut(_mutex);
+
+    Array<PullEnumerationContext*> contexts;
+    for (ContextTable::Iterator i = _contexts.start(); i; i++)
+    {
+        contexts.append(i.value());
+    }
+
+    // Contexts whose providers are still running are left to them
+    _destroying = true;
+    for (Uint32 i = 0; i < contexts.size(); i++)
+    {
+        _close(contexts[i]);
+    }
+
+    // The threads woken by the close still need the mutex to return
+    while (_waitingThreads)
+    {
+        _waitersDone.wait(_mutex);
+    }
+}
+
+PullEnumerationContext* EnumerationContextTable::createContext(
+    const CIMNamespaceName& nameSpace,
+    const String& userName,
+    Uint32 operationTimeout,
+    Uint32 maxObjectCount)
+{
+    PEG_METHOD_ENTER(TRC_DISPATCHER,
+        "EnumerationContextTable::createContext");
+
+    AutoMutex autoMut(_mutex);
+
+    Uint32 userCachedInstances = 0;
+    _userCachedInstances.lookup(userName, userCachedInstances);
+
+    if (_cachedInstances >= PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES ||
+        userCachedInstances >=
+            PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES_PER_USER)
+    {
+        PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL2,
+            "Enumeration refused: %u instances cached, %u of them for "
+                "user %s",
+            _cachedInstances,
+            userCachedInstances,
+            (const char*)userName.getCString()));
+        PEG_METHOD_EXIT();
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_SERVER_LIMITS_EXCEEDED,
+            String::EMPTY);
+    }
+
+    if (!_reaper.get())
+    {
+        AutoPtr<Thread> reaper(new Thread(_reaperThread, this, false));
+
+        if (reaper->run() != PEGASUS_THREAD_OK)
+        {
+            PEG_METHOD_EXIT();
+            throw PEGASUS_CIM_EXCEPTION(CIM_ERR_SERVER_LIMITS_EXCEEDED,
+                String::EMPTY);
+        }
+
+        _reaper.reset(reaper.release());
+    }
+
+    // The context identifier is unique within the lifetime of the server
+    // and is not predictable across server restarts
+    char buffer[64];
+    sprintf(buffer, "%u-%" PEGASUS_64BIT_CONVERSION_WIDTH "u",
+        ++_contextCounter, _getCurrentTimeUsec());
+
+    PullEnumerationContext* context = new PullEnumerationContext(
+        buffer, nameSpace, userName, operationTimeout, maxObjectCount);
+    _contexts.insert(context->_contextId, context);
+
+    PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL4,
+        "Created enumeration context %s, operation timeout %u seconds",
+        buffer,
+        operationTimeout));
+
+    PEG_METHOD_EXIT();
+    return context;
+}
+
+void EnumerationContextTable::removeContext(PullEnumerationContext* context)
+{
+    AutoMutex autoMut(_mutex);
+
+    _contexts.remove(context->_contextId);
+    delete context;
+}
+
+CIMResponseMessage* EnumerationContextTable::open(
+    PullEnumerationContext* context,
+    CIMOperationRequestMessage* request,
+    Uint32 maxObjectCount)
+{
+    AutoMutex autoMut(_mutex);
+
+    return _startOperation(context, request, maxObjectCount);
+}
+
+CIMResponseMessage* EnumerationContextTable::pull(
+    const String& contextId,
+    const CIMNamespaceName& nameSpace,
+    const String& userName,
+    CIMOperationRequestMessage* request,
+    Uint32 maxObjectCount)
+{
+    PEG_METHOD_ENTER(TRC_DISPATCHER, "EnumerationContextTable::pull");
+
+    AutoPtr<CIMOperationRequestMessage> requestDestroyer(request);
+    AutoMutex autoMut(_mutex);
+
+    PullEnumerationContext* context = _find(contextId, nameSpace, userName);
+
+    if (context->_pendingRequest)
+    {
+        PEG_METHOD_EXIT();
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_INVALID_ENUMERATION_CONTEXT,
+            String::EMPTY);
+    }
+
+    PEG_METHOD_EXIT();
+    return _startOperation(
+        context, requestDestroyer.release(), maxObjectCount);
+}
+
+CIMResponseMessage* EnumerationContextTable::close(
+    const String& contextId,
+    const CIMNamespaceName& nameSpace,
+    const String& userName)
+{
+    PEG_METHOD_ENTER(TRC_DISPATCHER, "EnumerationContextTable::close");
+
+    AutoMutex autoMut(_mutex);
+
+    PullEnumerationContext* context = _find(contextId, nameSpace, userName);
+    CIMResponseMessage* response = 0;
+
+    if (context->_pendingRequest)
+    {
+        AutoPtr<CIMOperationRequestMessage> request(context->_pendingRequest);
+        context->_pendingRequest = 0;
+
+        response = request->buildResponse();
+        response->cimException = PEGASUS_CIM_EXCEPTION(
+            CIM_ERR_PULL_HAS_BEEN_ABANDONED, String::EMPTY);
+        response->dest = request->queueIds.top();
+    }
+
+    _close(context);
+
+    PEG_METHOD_EXIT();
+    return response;
+}
+
+CIMResponseMessage* EnumerationContextTable::putCache(
+    PullEnumerationContext* context,
+    CIMResponseMessage* response,
+    Boolean isComplete)
+{
+    PEG_METHOD_ENTER(TRC_DISPATCHER, "EnumerationContextTable::putCache");
+
+    AutoPtr<CIMResponseMessage> responseDestroyer(response);
+    AutoMutex autoMut(_mutex);
+
+    if (!context->_closed)
+    {
+        if (response->cimException.getCode() != CIM_ERR_SUCCESS)
+        {
+            if (context->_error.getCode() == CIM_ERR_SUCCESS)
+            {
+                context->_error = response->cimException;
+            }
+        }
+        else if (context->_error.getCode() == CIM_ERR_SUCCESS)
+        {
+            // Instances following an error are not returned
+            CIMEnumerateInstancesResponseMessage* enumResponse =
+                dynamic_cast<CIMEnumerateInstancesResponseMessage*>(response);
+            PEGASUS_ASSERT(enumResponse);
+
+            CIMResponseData& from = enumResponse->getResponseData();
+            Uint32 cacheSize = context->_cache.size();
+            Uint32 count = from.size();
+
+            Uint32 userCachedInstances = 0;
+            _userCachedInstances.lookup(
+                context->_userName, userCachedInstances);
+
+            // The limits that refuse new enumerations also apply to the
+            // growth of the open ones
+            if (_cachedInstances + count >
+                    PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES ||
+                userCachedInstances + count >
+                    PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES_PER_USER)
+            {
+                PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL2,
+                    "Enumeration context %s failed: %u instances cached, "
+                        "%u more received; %u instances cached, %u of "
+                        "them for user %s",
+                    (const char*)context->_contextId.getCString(),
+                    cacheSize,
+                    count,
+                    _cachedInstances,
+                    userCachedInstances,
+                    (const char*)context->_userName.getCString()));
+                context->_error = PEGASUS_CIM_EXCEPTION(
+                    CIM_ERR_SERVER_LIMITS_EXCEEDED, String::EMPTY);
+                _signalCacheSpace(context);
+            }
+            else
+            {
+                context->_cache.moveInstances(from, count);
+                _addCachedInstances(context, count);
+            }
+        }
+    }
+
+    if (isComplete)
+    {
+        context->_providersComplete = true;
+    }
+
+    if (context->_closed)
+    {
+        if (isComplete)
+        {
+            PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL4,
+                "Deleting closed enumeration context %s",
+                (const char*)context->_contextId.getCString()));
+            delete context;
+        }
+
+        PEG_METHOD_EXIT();
+        return 0;
+    }
+
+    CIMResponseMessage* pullResponse = 0;
+
+    if (context->_pendingRequest &&
+        _canRespond(context, context->_pendingMaxObjectCount))
+    {
+        CIMOperationRequestMessage* request = context->_pendingRequest;
+        context->_pendingRequest = 0;
+        pullResponse =
+            _respond(context, request, context->_pendingMaxObjectCount);
+    }
+
+    PEG_METHOD_EXIT();
+    return pullResponse;
+}
+
+Boolean EnumerationContextTable::waitCacheSpace(
+    PullEnumerationContext* context)
+{
+    // The pull requests that make space are done by threads of the same
+    // pool as the waiting thread.
+    ThreadPool* threadPool = MessageQueueService::get_thread_pool();
+    Boolean waiting = threadPool && threadPool->beginWait();
+
+    AutoMutex autoMut(_mutex);
+
+    while (!_destroying && !context->_closed &&
+        context->_error.getCode() == CIM_ERR_SUCCESS &&
+        context->_cache.size() >= context->_cacheLimit)
+    {
+        context->_waiters++;
+        _waitingThreads++;
+        context->_cacheSpace.wait(_mutex);
+        context->_waiters--;
+        _waitingThreads--;
+    }
+
+    if (_destroying && _waitingThreads == 0)
+    {
+        _waitersDone.signal();
+    }
+
+    if (waiting)
+    {
+        threadPool->endWait();
+    }
+
+    return !_destroying && !context->_closed &&
+        context->_error.getCode() == CIM_ERR_SUCCESS;
+}
+
+PullEnumerationContext* EnumerationContextTable::_find(
+    const String& contextId,
+    const CIMNamespaceName& nameSpace,
+    const String& userName)
+{
+    PullEnumerationContext* context = 0;
+
+    if (!_contexts.lookup(contextId, context) ||
+        !context->_nameSpace.equal(nameSpace) ||
+        context->_userName != userName)
+    {
+        PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL2,
+            "Invalid enumeration context %s",
+            (const char*)contextId.getCString()));
+        throw PEGASUS_CIM_EXCEPTION(CIM_ERR_INVALID_ENUMERATION_CONTEXT,
+            String::EMPTY);
+    }
+
+    return context;
+}
+
+Boolean EnumerationContextTable::_canRespond(
+    PullEnumerationContext* context,
+    Uint32 maxObjectCount)
+{
+    return maxObjectCount == 0 ||
+        context->_cache.size() >= maxObjectCount ||
+        context->_providersComplete ||
+        context->_error.getCode() != CIM_ERR_SUCCESS;
+}
+
+CIMResponseMessage* EnumerationContextTable::_startOperation(
+    PullEnumerationContext* context,
+    CIMOperationRequestMessage* request,
+    Uint32 maxObjectCount)
+{
+    // The context does not expire while an operation is in progress
+    context->_expirationTime = 0;
+
+    // The limit does not shrink below the instances cached under it
+    if (maxObjectCount > context->_cacheLimit)
+    {
+        context->_cacheLimit = maxObjectCount;
+    }
+
+    if (_canRespond(context, maxObjectCount))
+    {
+        return _respond(context, request, maxObjectCount);
+    }
+
+    context->_pendingRequest = request;
+    context->_pendingMaxObjectCount = maxObjectCount;
+
+    // The providers may deliver up to the new limit
+    _signalCacheSpace(context);
+
+    return 0;
+}
+
+CIMResponseMessage* EnumerationContextTable::_respond(
+    PullEnumerationContext* context,
+    CIMOperationRequestMessage* request,
+    Uint32 maxObjectCount)
+{
+    AutoPtr<CIMOperationRequestMessage> requestDestroyer(request);
+    AutoPtr<CIMResponseMessage> response(request->buildResponse());
+    response->dest = request->queueIds.top();
+
+    if (context->_cache.size() == 0 &&
+        context->_error.getCode() != CIM_ERR_SUCCESS)
+    {
+        // Report the error once all instances preceding it were returned
+        response->cimException = context->_error;
+        _close(context);
+        return response.release();
+    }
+
+    CIMOpenOrPullResponseDataMessage* dataResponse =
+        dynamic_cast<CIMOpenOrPullResponseDataMessage*>(response.get());
+    PEGASUS_ASSERT(dataResponse);
+
+    CIMResponseData& to = dataResponse->getResponseData();
+    Uint32 cacheSize = context->_cache.size();
+    to.moveInstances(context->_cache, maxObjectCount);
+    _removeCachedInstances(context, cacheSize - context->_cache.size());
+
+    Array<CIMInstance>& instances = to.getInstances();
+    for (Uint32 i = 0, n = instances.size(); i < n; i++)
+    {
+        CIMObjectPath& path =
+            const_cast<CIMObjectPath&>(instances[i].getPath());
+        if (path.getHost().size() == 0)
+        {
+            path.setHost(_hostName);
+        }
+        if (path.getNameSpace().isNull())
+        {
+            path.setNameSpace(context->_nameSpace);
+        }
+    }
+
+    dataResponse->enumerationContext = context->_contextId;
+    dataResponse->endOfSequence = context->_providersComplete &&
+        context->_cache.size() == 0 &&
+        context->_error.getCode() == CIM_ERR_SUCCESS;
+
+    if (dataResponse->endOfSequence)
+    {
+        _close(context);
+    }
+    else
+    {
+        context->_expirationTime = _getCurrentTimeUsec() +
+            Uint64(context->_operationTimeout) * 1000000;
+        _signalCacheSpace(context);
+    }
+
+    return response.release();
+}
+
+void EnumerationContextTable::_close(PullEnumerationContext* context)
+{
+    PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL4,
+        "Closing enumeration context %s",
+        (const char*)context->_contextId.getCString()));
+
+    _contexts.remove(context->_contextId);
+    context->_closed = true;
+    _removeCachedInstances(context, context->_cache.size());
+    context->_cache = CIMResponseData(CIMResponseData::RESP_INSTANCES);
+
+    _signalCacheSpace(context);
+
+    // Otherwise the last provider response deletes the context
+    if (context->_providersComplete)
+    {
+        delete context;
+    }
+}
+
+void EnumerationContextTable::_signalCacheSpace(PullEnumerationContext* context)
+{
+    for (Uint32 i = 0; i < context->_waiters; i++)
+    {
+        context->_cacheSpace.signal();
+    }
+}
+
+void EnumerationContextTable::_addCachedInstances(
+    PullEnumerationContext* context,
+    Uint32 count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    _cachedInstances += count;
+
+    Uint32* userCachedInstances;
+    if (_userCachedInstances.lookupReference(
+            context->_userName, userCachedInstances))
+    {
+        *userCachedInstances += count;
+    }
+    else
+    {
+        _userCachedInstances.insert(context->_userName, count);
+    }
+}
+
+void EnumerationContextTable::_removeCachedInstances(
+    PullEnumerationContext* context,
+    Uint32 count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    PEGASUS_ASSERT(_cachedInstances >= count);
+    _cachedInstances -= count;
+
+    Uint32* userCachedInstances;
+    if (_userCachedInstances.lookupReference(
+            context->_userName, userCachedInstances))
+    {
+        PEGASUS_ASSERT(*userCachedInstances >= count);
+        *userCachedInstances -= count;
+
+        if (*userCachedInstances == 0)
+        {
+            _userCachedInstances.remove(context->_userName);
+        }
+    }
+}
+
+void EnumerationContextTable::_reapExpiredContexts()
+{
+    while (!_stopReaper.time_wait(
+        PEGASUS_ENUMERATION_CONTEXT_REAPER_INTERVAL_MSEC))
+    {
+        AutoMutex autoMut(_mutex);
+
+        Uint64 now = _getCurrentTimeUsec();
+        Array<PullEnumerationContext*> expired;
+
+        for (ContextTable::Iterator i = _contexts.start(); i; i++)
+        {
+            PullEnumerationContext* context = i.value();
+            if (context->_expirationTime != 0 &&
+                context->_expirationTime <= now)
+            {
+                expired.append(context);
+            }
+        }
+
+        for (Uint32 i = 0; i < expired.size(); i++)
+        {
+            PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL2,
+                "Enumeration context %s expired",
+                (const char*)expired[i]->_contextId.getCString()));
+            _close(expired[i]);
+        }
+    }
+}
+
+ThreadReturnType PEGASUS_THREAD_CDECL EnumerationContextTable::_reaperThread(
+    void* parm)
+{
+    Thread* myself = reinterpret_cast<Thread*>(parm);
+    EnumerationContextTable* table =
+        reinterpret_cast<EnumerationContextTable*>(myself->get_parm());
+
+    try
+    {
+        table->_reapExpiredContexts();
+    }
+    catch (Exception& e)
+    {
+        PEG_TRACE((TRC_DISPATCHER, Tracer::LEVEL1,
+            "Exception caught in EnumerationContextTable::_reaperThread: %s",
+            (const char*)e.getMessage().getCString()));
+    }
+    catch (...)
+    {
+        PEG_TRACE_CSTRING(TRC_DISPATCHER, Tracer::LEVEL1,
+            "Unknown exception caught in "
+                "EnumerationContextTable::_reaperThread");
+    }
+
+    return 0;
+}
+
+PEGASUS_NAMESPACE_END
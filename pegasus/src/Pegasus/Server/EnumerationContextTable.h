@@ -0,0 +1,296 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef Pegasus_EnumerationContextTable_h
+#define Pegasus_EnumerationContextTable_h
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/CIMMessage.h>
+#include <Pegasus/Common/HashTable.h>
+#include <Pegasus/Common/Mutex.h>
+#include <Pegasus/Common/Condition.h>
+#include <Pegasus/Common/Semaphore.h>
+#include <Pegasus/Common/Thread.h>
+#include <Pegasus/Common/AutoPtr.h>
+#include <Pegasus/Server/Linkage.h>
+
+PEGASUS_NAMESPACE_BEGIN
+
+/**
+    The state of an enumeration opened by OpenEnumerateInstances and
+    continued by PullInstancesWithPath.  The instances returned by the
+    providers are cached here until the client pulls them.  All members
+    are protected by the mutex of the owning EnumerationContextTable.
+*/
+class PEGASUS_SERVER_LINKAGE PullEnumerationContext
+{
+public:
+
+    const String& getContextId() const
+    {
+        return _contextId;
+    }
+
+private:
+
+    friend class EnumerationContextTable;
+
+    PullEnumerationContext(
+        const String& contextId,
+        const CIMNamespaceName& nameSpace,
+        const String& userName,
+        Uint32 operationTimeout,
+        Uint32 maxObjectCount);
+
+    ~PullEnumerationContext();
+
+    PullEnumerationContext(const PullEnumerationContext&);
+    PullEnumerationContext& operator=(const PullEnumerationContext&);
+
+    String _contextId;
+    CIMNamespaceName _nameSpace;
+    String _userName;
+
+    // Seconds the context may stay idle between two operations
+    Uint32 _operationTimeout;
+
+    // Time (microseconds) at which the idle context expires; zero while an
+    // open or pull operation is in progress
+    Uint64 _expirationTime;
+
+    // Instances received from the providers and not yet returned
+    CIMResponseData _cache;
+
+    // Number of cached instances at which the enumeration waits for the
+    // client to pull; the largest MaxObjectCount of the open and pull
+    // operations, but at least PEGASUS_MIN_ENUMERATION_CACHE_LIMIT
+    Uint32 _cacheLimit;
+
+    // The first error returned by a provider.  It ends the enumeration once
+    // the instances received before it have been pulled.
+    CIMException _error;
+
+    // Open or pull request waiting for more instances, and its
+    // MaxObjectCount
+    CIMOperationRequestMessage* _pendingRequest;
+    Uint32 _pendingMaxObjectCount;
+
+    Boolean _providersComplete;
+    Boolean _closed;
+
+    Uint32 _waiters;
+    Condition _cacheSpace;
+};
+
+/**
+    Holds the open enumeration contexts of the pull operations.
+
+    The instance enumeration run on behalf of an OpenEnumerateInstances
+    request delivers its responses to putCache() instead of to the client.
+    putCache() never blocks.  The thread that delivered the response then
+    calls waitCacheSpace(), which holds it back while the context caches
+    its cache limit or more, if the thread serves this enumeration only:
+    the thread of an in-process provider, or the thread that reads the
+    repository instances.  The responses of a provider agent are read by
+    a thread shared by all the requests to the agent, which does not
+    wait; they are queued in the context until the client pulls them.
+    The server memory used by a context is thus bounded by the
+    MaxObjectCount of the client rather than by the size of the result,
+    except for the responses of provider agents, which are bounded by the
+    limits below.
+
+    A context is closed when the enumeration is exhausted, on
+    CloseEnumeration, on the first error, or when the client leaves it
+    idle for longer than its operation timeout.  A closed context is
+    deleted once all its providers have completed.
+
+    The table counts the instances cached by all contexts and by the
+    contexts of each user.  No new context is created while either count
+    has reached its limit (PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES and
+    PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES_PER_USER), and a response that
+    would take either count past its limit fails the open context it
+    belongs to with CIM_ERR_SERVER_LIMITS_EXCEEDED.
+*/
+class PEGASUS_SERVER_LINKAGE EnumerationContextTable
+{
+public:
+
+    EnumerationContextTable();
+
+    ~EnumerationContextTable();
+
+    /**
+        Creates a context for a new enumeration.
+        @param operationTimeout Seconds the context may stay idle.
+        @param maxObjectCount MaxObjectCount of the open request.
+        @exception CIMException CIM_ERR_SERVER_LIMITS_EXCEEDED if the open
+            contexts of all users or of this user already cache the
+            maximum number of instances.
+    */
+    PullEnumerationContext* createContext(
+        const CIMNamespaceName& nameSpace,
+        const String& userName,
+        Uint32 operationTimeout,
+        Uint32 maxObjectCount);
+
+    /**
+        Deletes a context for which the enumeration could not be started.
+    */
+    void removeContext(PullEnumerationContext* context);
+
+    /**
+        Processes the open request of an enumeration once the enumeration
+        has been started.  Takes ownership of the request.
+        @return The response to the open request, or 0 if the request is
+            answered by a later call to putCache().
+    */
+    CIMResponseMessage* open(
+        PullEnumerationContext* context,
+        CIMOperationRequestMessage* request,
+        Uint32 maxObjectCount);
+
+    /**
+        Processes a pull request.  Takes ownership of the request.
+        @return The response to the pull request, or 0 if the request is
+            answered by a later call to putCache().
+        @exception CIMException CIM_ERR_INVALID_ENUMERATION_CONTEXT if the
+            context does not exist, belongs to another namespace or user, or
+            another operation is in progress on it.
+    */
+    CIMResponseMessage* pull(
+        const String& contextId,
+        const CIMNamespaceName& nameSpace,
+        const String& userName,
+        CIMOperationRequestMessage* request,
+        Uint32 maxObjectCount);
+
+    /**
+        Closes a context on request of the client.
+        @return The response to a pull request abandoned by the close,
+            or 0.
+        @exception CIMException CIM_ERR_INVALID_ENUMERATION_CONTEXT if the
+            context does not exist or belongs to another namespace or user.
+    */
+    CIMResponseMessage* close(
+        const String& contextId,
+        const CIMNamespaceName& nameSpace,
+        const String& userName);
+
+    /**
+        Adds a response of the enumeration to the context.  Takes ownership
+        of the response.
+        @param isComplete True if all the providers have completed.
+        @return The response to a waiting open or pull request which can
+            now be answered, or 0.
+    */
+    CIMResponseMessage* putCache(
+        PullEnumerationContext* context,
+        CIMResponseMessage* response,
+        Boolean isComplete);
+
+    /**
+        Blocks the calling thread while the context is open and holds at
+        least as many instances as its cache limit.  Only to be called by a
+        thread dedicated to the enumeration, never by the thread that reads
+        the responses of a provider agent.  Returns at once when the table
+        is being destroyed.
+        @return False if the context has been closed or has failed, or the
+            table is being destroyed; the enumeration should then stop.
+    */
+    Boolean waitCacheSpace(PullEnumerationContext* context);
+
+private:
+
+    EnumerationContextTable(const EnumerationContextTable&);
+    EnumerationContextTable& operator=(const EnumerationContextTable&);
+
+    PullEnumerationContext* _find(
+        const String& contextId,
+        const CIMNamespaceName& nameSpace,
+        const String& userName);
+
+    Boolean _canRespond(PullEnumerationContext* context, Uint32 maxObjectCount);
+
+    CIMResponseMessage* _respond(
+        PullEnumerationContext* context,
+        CIMOperationRequestMessage* request,
+        Uint32 maxObjectCount);
+
+    CIMResponseMessage* _startOperation(
+        PullEnumerationContext* context,
+        CIMOperationRequestMessage* request,
+        Uint32 maxObjectCount);
+
+    void _close(PullEnumerationContext* context);
+
+    void _signalCacheSpace(PullEnumerationContext* context);
+
+    void _addCachedInstances(PullEnumerationContext* context, Uint32 count);
+    void _removeCachedInstances(
+        PullEnumerationContext* context,
+        Uint32 count);
+
+    void _reapExpiredContexts();
+
+    static ThreadReturnType PEGASUS_THREAD_CDECL _reaperThread(void* parm);
+
+    typedef HashTable<String, PullEnumerationContext*,
+        EqualFunc<String>, HashFunc<String> > ContextTable;
+
+    ContextTable _contexts;
+    Mutex _mutex;
+
+    typedef HashTable<String, Uint32,
+        EqualFunc<String>, HashFunc<String> > UserCacheTable;
+
+    // Number of instances cached by all contexts and by the contexts of
+    // each user (users without cached instances are not in the table)
+    Uint32 _cachedInstances;
+    UserCacheTable _userCachedInstances;
+
+    Uint32 _contextCounter;
+    String _hostName;
+
+    // Number of threads in waitCacheSpace(), drained by the destructor
+    Uint32 _waitingThreads;
+    Boolean _destroying;
+    Condition _waitersDone;
+
+    // Closes the contexts left idle past their timeout; started with the
+    // first context
+    AutoPtr<Thread> _reaper;
+    Semaphore _stopReaper;
+};
+
+PEGASUS_NAMESPACE_END
+
+#endif /* Pegasus_EnumerationContextTable_h */
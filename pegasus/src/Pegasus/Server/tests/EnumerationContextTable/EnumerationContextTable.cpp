@@ -0,0 +1,553 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+
+#include <cstdio>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/Constants.h>
+#include <Pegasus/Common/AutoPtr.h>
+#include <Pegasus/Server/EnumerationContextTable.h>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+static Boolean verbose;
+
+static const CIMNamespaceName NAMESPACE("aa/bb");
+static const CIMName CLASSNAME("MyClass");
+
+// Number of instances a provider delivers per response
+static const Uint32 CHUNK_SIZE = 100;
+
+static CIMOperationRequestMessage* _openRequest(
+    const String& userName,
+    Uint32 maxObjectCount)
+{
+    return new CIMOpenEnumerateInstancesRequestMessage(
+        "open",
+        NAMESPACE,
+        CLASSNAME,
+        true, // deepInheritance
+        false, // includeClassOrigin
+        CIMPropertyList(),
+        String::EMPTY,
+        String::EMPTY,
+        30, // operationTimeout
+        false, // continueOnError
+        maxObjectCount,
+        QueueIdStack(1),
+        String::EMPTY,
+        userName);
+}
+
+static CIMOperationRequestMessage* _pullRequest(
+    const String& contextId,
+    const String& userName,
+    Uint32 maxObjectCount)
+{
+    return new CIMPullInstancesWithPathRequestMessage(
+        "pull",
+        NAMESPACE,
+        contextId,
+        maxObjectCount,
+        QueueIdStack(1),
+        String::EMPTY,
+        userName);
+}
+
+/*
+    Builds a response of an enumeration provider carrying count instances.
+*/
+static CIMResponseMessage* _providerResponse(Uint32 count)
+{
+    CIMEnumerateInstancesResponseMessage* response =
+        new CIMEnumerateInstancesResponseMessage(
+            "enum", CIMException(), QueueIdStack(1));
+
+    // The instances share their representation, which keeps the tests of
+    // the server-wide limits small
+    static CIMInstance instance(CLASSNAME);
+
+    Array<CIMInstance> instances;
+    for (Uint32 i = 0; i < count; i++)
+    {
+        instances.append(instance);
+    }
+    response->getResponseData().setInstances(instances);
+
+    return response;
+}
+
+/*
+    Opens an enumeration with a MaxObjectCount of zero, which is answered
+    at once, and returns its context.
+*/
+static PullEnumerationContext* _open(
+    EnumerationContextTable& table,
+    const String& userName,
+    Uint32 maxObjectCount)
+{
+    PullEnumerationContext* context =
+        table.createContext(NAMESPACE, userName, 30, maxObjectCount);
+
+    AutoPtr<CIMResponseMessage> response(
+        table.open(context, _openRequest(userName, 0), 0));
+    PEGASUS_TEST_ASSERT(response.get());
+    PEGASUS_TEST_ASSERT(
+        response->cimException.getCode() == CIM_ERR_SUCCESS);
+
+    return context;
+}
+
+/*
+    Pulls up to maxObjectCount instances and returns how many were
+    returned.  Sets code to the status of the response and
+    endOfSequence to whether the enumeration is exhausted.
+*/
+static Uint32 _pull(
+    EnumerationContextTable& table,
+    PullEnumerationContext* context,
+    const String& userName,
+    Uint32 maxObjectCount,
+    CIMStatusCode& code,
+    Boolean& endOfSequence)
+{
+    String contextId = context->getContextId();
+    AutoPtr<CIMResponseMessage> response(table.pull(
+        contextId,
+        NAMESPACE,
+        userName,
+        _pullRequest(contextId, userName, maxObjectCount),
+        maxObjectCount));
+    PEGASUS_TEST_ASSERT(response.get());
+
+    code = response->cimException.getCode();
+    if (code != CIM_ERR_SUCCESS)
+    {
+        endOfSequence = true;
+        return 0;
+    }
+
+    CIMOpenOrPullResponseDataMessage* dataResponse =
+        dynamic_cast<CIMOpenOrPullResponseDataMessage*>(response.get());
+    PEGASUS_TEST_ASSERT(dataResponse);
+    endOfSequence = dataResponse->endOfSequence;
+    return dataResponse->getResponseData().size();
+}
+
+/*
+    A provider that delivers more instances than the cache limit while the
+    client pulls them is not limited by the cache limit.
+*/
+static void _testProviderPulledWhileDelivering()
+{
+    EnumerationContextTable table;
+    PullEnumerationContext* context = _open(table, "user", 0);
+
+    const Uint32 total = 6 * PEGASUS_MIN_ENUMERATION_CACHE_LIMIT;
+    Uint32 delivered = 0;
+    Uint32 pulled = 0;
+    CIMStatusCode code;
+    Boolean endOfSequence = false;
+
+    while (delivered < total)
+    {
+        for (Uint32 i = 0; i < PEGASUS_MIN_ENUMERATION_CACHE_LIMIT;
+             i += CHUNK_SIZE)
+        {
+            delivered += CHUNK_SIZE;
+            PEGASUS_TEST_ASSERT(table.putCache(
+                context, _providerResponse(CHUNK_SIZE), false) == 0);
+        }
+
+        pulled += _pull(table, context, "user",
+            PEGASUS_MIN_ENUMERATION_CACHE_LIMIT, code, endOfSequence);
+        PEGASUS_TEST_ASSERT(code == CIM_ERR_SUCCESS);
+        PEGASUS_TEST_ASSERT(!endOfSequence);
+    }
+
+    PEGASUS_TEST_ASSERT(
+        table.putCache(context, _providerResponse(0), true) == 0);
+
+    pulled += _pull(table, context, "user", 0, code, endOfSequence);
+    PEGASUS_TEST_ASSERT(code == CIM_ERR_SUCCESS);
+    PEGASUS_TEST_ASSERT(endOfSequence);
+    PEGASUS_TEST_ASSERT(pulled == total);
+}
+
+/*
+    A provider whose responses cannot be held back (those of a provider
+    agent) may deliver far past the cache limit before the client pulls.
+    The enumeration returns all its instances.
+*/
+static void _testProviderPastCacheLimit()
+{
+    EnumerationContextTable table;
+    PullEnumerationContext* context = _open(table, "user", 0);
+
+    const Uint32 total = 8 * PEGASUS_MIN_ENUMERATION_CACHE_LIMIT;
+
+    for (Uint32 i = 0; i < total; i += CHUNK_SIZE)
+    {
+        PEGASUS_TEST_ASSERT(table.putCache(
+            context, _providerResponse(CHUNK_SIZE), false) == 0);
+    }
+    PEGASUS_TEST_ASSERT(
+        table.putCache(context, _providerResponse(0), true) == 0);
+
+    CIMStatusCode code;
+    Boolean endOfSequence = false;
+    Uint32 pulled = 0;
+
+    while (!endOfSequence)
+    {
+        pulled += _pull(table, context, "user",
+            PEGASUS_MAX_PULL_OBJECT_COUNT / 4, code, endOfSequence);
+        PEGASUS_TEST_ASSERT(code == CIM_ERR_SUCCESS);
+    }
+    PEGASUS_TEST_ASSERT(pulled == total);
+}
+
+// Number of instances the client pulls at a time
+static const Uint32 PULL_SIZE = 300;
+
+struct Provider
+{
+    EnumerationContextTable* table;
+    PullEnumerationContext* context;
+    Uint32 total;
+    Mutex mutex;
+    Uint32 delivered;
+    Uint32 pulled;
+    // Largest number of instances delivered but not yet counted as pulled
+    Uint32 maxAhead;
+
+    Uint32 getDelivered()
+    {
+        AutoMutex autoMut(mutex);
+        return delivered;
+    }
+
+    // Number of instances the client can pull at once
+    Uint32 getCached()
+    {
+        AutoMutex autoMut(mutex);
+        return delivered - pulled;
+    }
+};
+
+static ThreadReturnType PEGASUS_THREAD_CDECL _provider(void* parm)
+{
+    Provider* provider = (Provider*) ((Thread*) parm)->get_parm();
+
+    for (Uint32 i = 0; i < provider->total; i += CHUNK_SIZE)
+    {
+        Boolean isComplete = i + CHUNK_SIZE >= provider->total;
+
+        PEGASUS_TEST_ASSERT(provider->table->putCache(
+            provider->context,
+            _providerResponse(CHUNK_SIZE),
+            isComplete) == 0);
+
+        {
+            AutoMutex autoMut(provider->mutex);
+            provider->delivered += CHUNK_SIZE;
+            Uint32 ahead = provider->delivered - provider->pulled;
+            if (ahead > provider->maxAhead)
+            {
+                provider->maxAhead = ahead;
+            }
+        }
+
+        // As the dispatcher does for a provider that runs on a thread of
+        // its own
+        if (!isComplete)
+        {
+            provider->table->waitCacheSpace(provider->context);
+        }
+    }
+
+    return ThreadReturnType(0);
+}
+
+/*
+    A provider running on a thread of its own is held back while its
+    context caches the cache limit, until the client pulls.
+*/
+static void _testProviderHeldBack()
+{
+    EnumerationContextTable table;
+
+    Provider provider;
+    provider.table = &table;
+    provider.context = _open(table, "user", 0);
+    provider.total = 10 * PEGASUS_MIN_ENUMERATION_CACHE_LIMIT;
+    provider.delivered = 0;
+    provider.pulled = 0;
+    provider.maxAhead = 0;
+
+    Thread thread(_provider, &provider, false);
+    PEGASUS_TEST_ASSERT(thread.run() == PEGASUS_THREAD_OK);
+
+    // The provider stops at the cache limit while the client does not pull
+    while (provider.getDelivered() < PEGASUS_MIN_ENUMERATION_CACHE_LIMIT)
+    {
+        Threads::sleep(10);
+    }
+    Threads::sleep(100);
+    PEGASUS_TEST_ASSERT(
+        provider.getDelivered() == PEGASUS_MIN_ENUMERATION_CACHE_LIMIT);
+
+    CIMStatusCode code;
+    Boolean endOfSequence = false;
+
+    while (!endOfSequence)
+    {
+        // A pull that waits for instances would be answered by putCache()
+        // on the provider thread, so only cached instances are pulled
+        while (provider.getCached() < PULL_SIZE &&
+            provider.getDelivered() < provider.total)
+        {
+            Threads::sleep(1);
+        }
+
+        Uint32 count = _pull(table, provider.context, "user",
+            PULL_SIZE, code, endOfSequence);
+        PEGASUS_TEST_ASSERT(code == CIM_ERR_SUCCESS);
+
+        AutoMutex autoMut(provider.mutex);
+        provider.pulled += count;
+    }
+
+    thread.join();
+    PEGASUS_TEST_ASSERT(provider.pulled == provider.total);
+
+    // The instances of the last pull may not have been counted yet
+    PEGASUS_TEST_ASSERT(provider.maxAhead <=
+        PEGASUS_MIN_ENUMERATION_CACHE_LIMIT + CHUNK_SIZE + PULL_SIZE);
+}
+
+/*
+    Delivers provider responses to the context until it has cached count
+    instances.
+*/
+static void _fill(
+    EnumerationContextTable& table,
+    PullEnumerationContext* context,
+    Uint32 count)
+{
+    for (Uint32 i = 0; i < count; i += CHUNK_SIZE)
+    {
+        PEGASUS_TEST_ASSERT(table.putCache(
+            context, _providerResponse(CHUNK_SIZE), false) == 0);
+    }
+}
+
+/*
+    Checks that the next provider response fails the context: the pull
+    returns the count instances cached before it, and the next pull the
+    error.
+*/
+static void _checkStoppedAt(
+    EnumerationContextTable& table,
+    PullEnumerationContext* context,
+    const String& userName,
+    Uint32 count)
+{
+    PEGASUS_TEST_ASSERT(table.putCache(
+        context, _providerResponse(CHUNK_SIZE), false) == 0);
+
+    CIMStatusCode code;
+    Boolean endOfSequence;
+
+    Uint32 pulled = 0;
+    while (pulled < count)
+    {
+        pulled += _pull(table, context, userName,
+            PEGASUS_MAX_PULL_OBJECT_COUNT, code, endOfSequence);
+        PEGASUS_TEST_ASSERT(code == CIM_ERR_SUCCESS);
+        PEGASUS_TEST_ASSERT(!endOfSequence);
+    }
+    PEGASUS_TEST_ASSERT(pulled == count);
+
+    _pull(table, context, userName, PEGASUS_MAX_PULL_OBJECT_COUNT,
+        code, endOfSequence);
+    PEGASUS_TEST_ASSERT(code == CIM_ERR_SERVER_LIMITS_EXCEEDED);
+
+    PEGASUS_TEST_ASSERT(
+        table.putCache(context, _providerResponse(0), true) == 0);
+}
+
+/*
+    Delivers the last provider response to the context and checks that the
+    client pulls the count instances cached before it and its own.
+*/
+static void _checkCompleted(
+    EnumerationContextTable& table,
+    PullEnumerationContext* context,
+    const String& userName,
+    Uint32 count)
+{
+    PEGASUS_TEST_ASSERT(table.putCache(
+        context, _providerResponse(CHUNK_SIZE), true) == 0);
+
+    CIMStatusCode code;
+    Boolean endOfSequence = false;
+
+    Uint32 pulled = 0;
+    while (!endOfSequence)
+    {
+        pulled += _pull(table, context, userName,
+            PEGASUS_MAX_PULL_OBJECT_COUNT, code, endOfSequence);
+        PEGASUS_TEST_ASSERT(code == CIM_ERR_SUCCESS);
+    }
+    PEGASUS_TEST_ASSERT(pulled == count + CHUNK_SIZE);
+}
+
+/*
+    An open enumeration stops at the per-user limit of cached instances,
+    while the other enumerations of the user and those of other users go
+    on.
+*/
+static void _testUserLimit()
+{
+    EnumerationContextTable table;
+
+    const Uint32 contextFill =
+        PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES_PER_USER * 4 / 5;
+
+    PullEnumerationContext* first =
+        _open(table, "user", PEGASUS_MAX_PULL_OBJECT_COUNT);
+    PullEnumerationContext* second =
+        _open(table, "user", PEGASUS_MAX_PULL_OBJECT_COUNT);
+    PullEnumerationContext* other =
+        _open(table, "other", PEGASUS_MAX_PULL_OBJECT_COUNT);
+
+    _fill(table, first, contextFill);
+    _fill(table, second,
+        PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES_PER_USER - contextFill);
+
+    _checkStoppedAt(table, second, "user",
+        PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES_PER_USER - contextFill);
+
+    // The failed context released its instances
+    _fill(table, other, CHUNK_SIZE);
+    _fill(table, first, CHUNK_SIZE);
+
+    _checkCompleted(table, other, "other", CHUNK_SIZE);
+    _checkCompleted(table, first, "user", contextFill + CHUNK_SIZE);
+}
+
+/*
+    An open enumeration stops at the server-wide limit of cached
+    instances, whatever its user, while the other enumerations go on.
+*/
+static void _testTotalLimit()
+{
+    EnumerationContextTable table;
+
+    const Uint32 contextFill =
+        PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES_PER_USER * 4 / 5;
+    const Uint32 numUsers =
+        PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES / contextFill;
+    PEGASUS_TEST_ASSERT(
+        numUsers * contextFill == PEGASUS_MAX_ENUMERATION_CACHE_INSTANCES);
+
+    Array<PullEnumerationContext*> contexts;
+    Array<String> userNames;
+    for (Uint32 i = 0; i <= numUsers; i++)
+    {
+        char userName[32];
+        sprintf(userName, "user%u", i);
+        userNames.append(userName);
+        contexts.append(
+            _open(table, userNames[i], PEGASUS_MAX_PULL_OBJECT_COUNT));
+    }
+
+    for (Uint32 i = 0; i < numUsers; i++)
+    {
+        _fill(table, contexts[i], contextFill);
+    }
+
+    _checkStoppedAt(table, contexts[numUsers], userNames[numUsers], 0);
+
+    _checkStoppedAt(table, contexts[0], userNames[0], contextFill);
+
+    for (Uint32 i = 1; i < numUsers; i++)
+    {
+        _checkCompleted(table, contexts[i], userNames[i], contextFill);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    try
+    {
+        if (verbose)
+        {
+            cout << "Testing provider pulled while delivering." << endl;
+        }
+        _testProviderPulledWhileDelivering();
+
+        if (verbose)
+        {
+            cout << "Testing provider past the cache limit." << endl;
+        }
+        _testProviderPastCacheLimit();
+
+        if (verbose)
+        {
+            cout << "Testing provider held back at the cache limit." << endl;
+        }
+        _testProviderHeldBack();
+
+        if (verbose)
+        {
+            cout << "Testing per-user cache limit." << endl;
+        }
+        _testUserLimit();
+
+        if (verbose)
+        {
+            cout << "Testing total cache limit." << endl;
+        }
+        _testTotalLimit();
+    }
+    catch (Exception& e)
+    {
+        cerr << "Error: " << e.getMessage() << endl;
+        exit(1);
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+
+    return 0;
+}
@@ -0,0 +1,218 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+//
+//%/////////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/Config.h>
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/XmlParser.h>
+#include <Pegasus/Common/FileSystem.h>
+#include <Pegasus/General/Stopwatch.h>
+#include <Pegasus/Server/CIMOperationRequestDecoder.h>
+#include <cstring>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+static Boolean verbose;
+
+// Number of bytes decoded per round and number of rounds per payload. The
+// fastest round is reported, which filters out the noise of other processes.
+static const Uint32 BYTES_PER_ROUND = 2 * 1024 * 1024;
+static const Uint32 ROUNDS = 8;
+
+//
+// Receives the decoded requests in place of the dispatcher, and the error
+// responses in place of the HTTP connection.
+//
+class RequestSink : public MessageQueue
+{
+public:
+
+    RequestSink() : MessageQueue("RequestSink"), requests(0), errors(0)
+    {
+    }
+
+    virtual void enqueue(Message* message)
+    {
+        if (dynamic_cast<CIMOperationRequestMessage*>(message))
+        {
+            requests++;
+        }
+        else
+        {
+            errors++;
+        }
+
+        delete message;
+    }
+
+    virtual void handleEnqueue()
+    {
+    }
+
+    Uint32 requests;
+    Uint32 errors;
+};
+
+//
+// Gets the method name and the namespace of the request, which the decoder
+// compares with the CIMMethod and CIMObject HTTP headers.
+//
+static void _getHeaders(const Buffer& payload, String& method, String& ns)
+{
+    Buffer text(payload);
+    XmlParser parser((char*)text.getData());
+    XmlEntry entry;
+
+    while (parser.next(entry))
+    {
+        if ((entry.type == XmlEntry::START_TAG) &&
+            (strcmp(entry.text, "IMETHODCALL") == 0))
+        {
+            entry.getAttributeValue("NAME", method);
+        }
+        else if ((entry.type == XmlEntry::EMPTY_TAG) &&
+            (strcmp(entry.text, "NAMESPACE") == 0))
+        {
+            String name;
+            entry.getAttributeValue("NAME", name);
+            ns.append(ns.size() ? "/" : "");
+            ns.append(name);
+        }
+        else if ((entry.type == XmlEntry::END_TAG) &&
+            (strcmp(entry.text, "LOCALNAMESPACEPATH") == 0))
+        {
+            break;
+        }
+    }
+}
+
+static void _testPayload(
+    CIMOperationRequestDecoder& decoder,
+    RequestSink& sink,
+    const char* fileName)
+{
+    Buffer payload;
+    FileSystem::loadFileToMemory(payload, fileName);
+    payload.append('\0');
+
+    String method;
+    String ns;
+    _getHeaders(payload, method, ns);
+    PEGASUS_TEST_ASSERT(method.size() && ns.size());
+
+    Uint32 size = payload.size();
+    Buffer text(payload);
+    Uint32 passes = BYTES_PER_ROUND / size + 1;
+    double seconds = 0;
+
+    for (Uint32 round = 0; round < ROUNDS; round++)
+    {
+        Stopwatch stopwatch;
+        stopwatch.start();
+
+        for (Uint32 i = 0; i < passes; i++)
+        {
+            memcpy((char*)text.getData(), payload.getData(), size);
+            decoder.handleMethodCall(
+                sink.getQueueId(),
+                HTTP_METHOD__POST,
+                (char*)text.getData(),
+                size,
+                "1.0",
+                method,
+                ns,
+                String::EMPTY,
+                String::EMPTY,
+                String::EMPTY,
+                String::EMPTY,
+                AcceptLanguageList(),
+                ContentLanguageList(),
+                false,
+                false,
+                false,
+                false,
+                false);
+        }
+
+        stopwatch.stop();
+
+        if (round == 0 || stopwatch.getElapsed() < seconds)
+        {
+            seconds = stopwatch.getElapsed();
+        }
+    }
+
+    PEGASUS_TEST_ASSERT(sink.requests == ROUNDS * passes);
+    PEGASUS_TEST_ASSERT(sink.errors == 0);
+    sink.requests = 0;
+
+    if (verbose)
+    {
+        const char* name = strrchr(fileName, '/');
+        name = name ? name + 1 : fileName;
+
+        printf("%-32s %6u bytes %8.1f MB/s %8.1f requests/ms\n",
+            name,
+            size - 1,
+            double(size) * passes / seconds / (1024 * 1024),
+            double(passes) / seconds / 1000);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    if (argc < 2)
+    {
+        cerr << "Usage: " << argv[0] << " xml-filename ..." << endl;
+        return 1;
+    }
+
+    try
+    {
+        RequestSink sink;
+        CIMOperationRequestDecoder decoder(&sink, sink.getQueueId());
+
+        for (int i = 1; i < argc; i++)
+        {
+            _testPayload(decoder, sink, argv[i]);
+        }
+    }
+    catch (Exception& e)
+    {
+        cerr << "Error: " << e.getMessage() << endl;
+        return 1;
+    }
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+    return 0;
+}
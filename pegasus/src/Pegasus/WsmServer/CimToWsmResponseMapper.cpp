@@ -106,7 +106,9 @@ WsmResponse* CimToWsmResponseMapper::mapToWsmResponse(
                 {
                     wsmResponse.reset(_mapToWsenEnumerateResponseObject(
                         (WsenEnumerateRequest*) wsmRequest,
-                        (CIMEnumerateInstancesResponseMessage*) message));
+                        ((CIMEnumerateInstancesResponseMessage*) message)->
+                            getResponseData(),
+                        message->operationContext));
                 }
                 else if (((WsenEnumerateRequest*)
                               wsmRequest)->enumerationMode ==
@@ -114,7 +116,9 @@ WsmResponse* CimToWsmResponseMapper::mapToWsmResponse(
                 {
                     wsmResponse.reset(_mapToWsenEnumerateResponseObjectAndEPR(
                         (WsenEnumerateRequest*) wsmRequest,
-                        (CIMEnumerateInstancesResponseMessage*) message));
+                        ((CIMEnumerateInstancesResponseMessage*) message)->
+                            getResponseData(),
+                        message->operationContext));
                 }
                 else if (((WsenEnumerateRequest*) wsmRequest)->
                          enumerationMode == WSEN_EM_EPR)
@@ -145,6 +149,21 @@ WsmResponse* CimToWsmResponseMapper::mapToWsmResponse(
     return wsmResponse.release();
 }
 
+WsenEnumerateResponse* CimToWsmResponseMapper::mapToWsenEnumerateResponse(
+    const WsenEnumerateRequest* wsmRequest,
+    CIMOpenOrPullResponseDataMessage* message)
+{
+    if (wsmRequest->enumerationMode == WSEN_EM_OBJECT_AND_EPR)
+    {
+        return _mapToWsenEnumerateResponseObjectAndEPR(
+            wsmRequest, message->getResponseData(), message->operationContext);
+    }
+
+    PEGASUS_ASSERT(wsmRequest->enumerationMode == WSEN_EM_OBJECT);
+    return _mapToWsenEnumerateResponseObject(
+        wsmRequest, message->getResponseData(), message->operationContext);
+}
+
 WsmFaultResponse* CimToWsmResponseMapper::_mapToWsmFaultResponse(
     const WsmRequest* wsmRequest,
     const CIMResponseMessage* response)
@@ -226,6 +245,21 @@ WsmFault CimToWsmResponseMapper::mapCimExceptionToWsmFault(
             faultDetail = WSMAN_FAULTDETAIL_ACTIONMISMATCH;
             break;
 
+        case CIM_ERR_SERVER_LIMITS_EXCEEDED:
+            // Only the open enumeration of a streamed Enumerate operation
+            subcode = WsmFault::wsman_QuotaLimit;
+            break;
+
+        case CIM_ERR_INVALID_ENUMERATION_CONTEXT:
+        case CIM_ERR_PULL_HAS_BEEN_ABANDONED:
+            // Only the pull of a streamed Enumerate operation
+            subcode = WsmFault::wsen_InvalidEnumerationContext;
+            break;
+
+        case CIM_ERR_INVALID_OPERATION_TIMEOUT:
+            subcode = WsmFault::wsen_InvalidExpirationTime;
+            break;
+
         case CIM_ERR_QUERY_LANGUAGE_NOT_SUPPORTED:
             // DSP0227 section 15.1.11 indicates that ExecuteQuery operations
             // through WS-Management use CQL filter dialect.  If this status
@@ -313,12 +347,12 @@ WxfDeleteResponse* CimToWsmResponseMapper::_mapToWxfDeleteResponse(
 WsenEnumerateResponse*
     CimToWsmResponseMapper::_mapToWsenEnumerateResponseObject(
     const WsenEnumerateRequest* wsmRequest,
-    CIMEnumerateInstancesResponseMessage* response)
+    CIMResponseData& responseData,
+    const OperationContext& operationContext)
 {
     Array<WsmInstance> instances;
     Array<WsmEndpointReference> EPRs;
-    Array<CIMInstance>& namedInstances =
-        response->getResponseData().getInstances();
+    Array<CIMInstance>& namedInstances = responseData.getInstances();
 
     if (wsmRequest->selectStatement)
     {
@@ -364,7 +398,7 @@ WsenEnumerateResponse*
                 instances,
                 instances.size(),
                 wsmRequest,
-                _getContentLanguages(response->operationContext));
+                _getContentLanguages(operationContext));
 
         return wsmResponse;
     }
@@ -386,7 +420,7 @@ WsenEnumerateResponse*
                 instances,
                 instances.size(),
                 wsmRequest,
-                _getContentLanguages(response->operationContext));
+                _getContentLanguages(operationContext));
 
         return wsmResponse;
     }
@@ -395,12 +429,12 @@ WsenEnumerateResponse*
 WsenEnumerateResponse*
     CimToWsmResponseMapper::_mapToWsenEnumerateResponseObjectAndEPR(
     const WsenEnumerateRequest* wsmRequest,
-    CIMEnumerateInstancesResponseMessage* response)
+    CIMResponseData& responseData,
+    const OperationContext& operationContext)
 {
     Array<WsmInstance> instances;
     Array<WsmEndpointReference> EPRs;
-    Array<CIMInstance>& namedInstances =
-        response->getResponseData().getInstances();
+    Array<CIMInstance>& namedInstances = responseData.getInstances();
     for (Uint32 i = 0; i < namedInstances.size(); i++)
     {
         WsmInstance wsmInstance;
@@ -426,7 +460,7 @@ WsenEnumerateResponse*
             EPRs,
             instances.size(),
             wsmRequest,
-            _getContentLanguages(response->operationContext));
+            _getContentLanguages(operationContext));
 
     return wsmResponse;
 }
@@ -53,6 +53,15 @@ public:
         const CIMResponseMessage* message);
     WsmFault mapCimExceptionToWsmFault(const CIMException& cimException);
 
+    /**
+        Maps the instances returned by an open or pull operation of a
+        streamed enumeration to an enumerate response holding the
+        corresponding items of the enumeration mode of the request.
+    */
+    WsenEnumerateResponse* mapToWsenEnumerateResponse(
+        const WsenEnumerateRequest* wsmRequest,
+        CIMOpenOrPullResponseDataMessage* message);
+
     void convertCimToWsmInstance(
         const String& resourceUri,
         const CIMConstInstance& cimInstance,
@@ -95,10 +104,12 @@ private:
         const CIMDeleteInstanceResponseMessage* response);
     WsenEnumerateResponse* _mapToWsenEnumerateResponseObject(
         const WsenEnumerateRequest* wsmRequest,
-        CIMEnumerateInstancesResponseMessage* response);
+        CIMResponseData& responseData,
+        const OperationContext& operationContext);
     WsenEnumerateResponse* _mapToWsenEnumerateResponseObjectAndEPR(
         const WsenEnumerateRequest* wsmRequest,
-        CIMEnumerateInstancesResponseMessage* response);
+        CIMResponseData& responseData,
+        const OperationContext& operationContext);
     WsenEnumerateResponse* _mapToWsenEnumerateResponseEPR(
         const WsenEnumerateRequest* wsmRequest,
         CIMEnumerateInstanceNamesResponseMessage* response);
@@ -36,6 +36,8 @@
 #include <Pegasus/Common/MessageLoader.h>
 #include <Pegasus/Common/StringConversion.h>
 #include <Pegasus/Common/AutoPtr.h>
+#include <Pegasus/Common/Constants.h>
+#include <Pegasus/Common/TimeValue.h>
 #include "WsmConstants.h"
 #include "SoapResponse.h"
 #include "WsmProcessor.h"
@@ -44,6 +46,20 @@ PEGASUS_USING_STD;
 
 PEGASUS_NAMESPACE_BEGIN
 
+/**
+    Interval (milliseconds) at which the enumeration contexts are checked
+    for expiration.
+*/
+#define PEGASUS_WSM_ENUMERATION_CONTEXT_SWEEPER_INTERVAL_MSEC 10000
+
+/**
+    Time (seconds) an open enumeration may stay idle before it is refreshed.
+    With the sweeper interval, it is refreshed well within the operation
+    timeout of an enumeration that expires later than that timeout.
+*/
+#define PEGASUS_WSM_OPEN_ENUMERATION_REFRESH_SECONDS \
+    (PEGASUS_MAX_PULL_OPERATION_TIMEOUT_SECONDS / 2)
+
 Uint64 WsmProcessor::_currentEnumContext = 0;
 
 WsmProcessor::WsmProcessor(
@@ -54,17 +70,28 @@ WsmProcessor::WsmProcessor(
       _wsmRequestDecoder(this),
       _cimOperationProcessorQueue(cimOperationProcessorQueue),
       _repository(repository),
-      _wsmToCimRequestMapper(repository)
+      _wsmToCimRequestMapper(repository),
+      _stopSweeper(0)
 {
 }
 
 WsmProcessor::~WsmProcessor()
 {
+    if (_sweeper.get())
+    {
+        _stopSweeper.signal();
+        _sweeper->join();
+    }
+
     // Clean up enumeration responses that have not been pulled or released.
+    // The open enumerations of the streamed enumerations expire in the
+    // CIM server.
     for (EnumerationContextTable::Iterator i =
              _enumerationContextTable.start(); i; i++)
     {
         delete i.value().response;
+        delete i.value().request;
+        delete i.value().deferredRequest;
     }
 }
 
@@ -117,11 +144,21 @@ void WsmProcessor::handleRequest(WsmRequest* wsmRequest)
             switch (wsmRequest->getType())
             {
                 case WS_ENUMERATION_PULL:
-                    _handlePullRequest((WsenPullRequest*) wsmRequest);
+                    if (_handlePullRequest((WsenPullRequest*) wsmRequest))
+                    {
+                        // The request waits for a pull of the open
+                        // enumeration
+                        wsmRequestDestroyer.release();
+                    }
                     break;
 
                 case WS_ENUMERATION_RELEASE:
-                    _handleReleaseRequest((WsenReleaseRequest*) wsmRequest);
+                    if (_handleReleaseRequest((WsenReleaseRequest*) wsmRequest))
+                    {
+                        // The request waits for a refresh of the open
+                        // enumeration
+                        wsmRequestDestroyer.release();
+                    }
                     break;
 
                 default:
@@ -178,11 +215,26 @@ void WsmProcessor::handleResponse(CIMResponseMessage* cimResponse)
 
     AutoPtr<CIMResponseMessage> cimResponseDestroyer(cimResponse);
 
-    // Lookup the request this response corresponds to
+    // Lookup the request this response corresponds to.  The refresh of an
+    // open enumeration and the close of the open enumeration of a released
+    // or expired streamed enumeration have no request.
     WsmRequest* wsmRequest;
-    Boolean gotRequest =
-        _requestTable.lookup(cimResponse->messageId, wsmRequest);
-    PEGASUS_ASSERT(gotRequest);
+    if (!_requestTable.lookup(cimResponse->messageId, wsmRequest))
+    {
+        if (_handleRefreshResponse(cimResponse))
+        {
+            PEG_METHOD_EXIT();
+            return;
+        }
+
+        PEGASUS_ASSERT(cimResponse->getType() ==
+            CIM_CLOSE_ENUMERATION_RESPONSE_MESSAGE);
+        PEG_TRACE((TRC_WSMSERVER, Tracer::LEVEL4,
+            "Open enumeration closed with status %u",
+            Uint32(cimResponse->cimException.getCode())));
+        PEG_METHOD_EXIT();
+        return;
+    }
     AutoPtr<WsmRequest> wsmRequestDestroyer(wsmRequest);
     _requestTable.remove(cimResponse->messageId);
 
@@ -191,9 +243,20 @@ void WsmProcessor::handleResponse(CIMResponseMessage* cimResponse)
         switch (wsmRequest->getType())
         {
             case WS_ENUMERATION_ENUMERATE:
-                _handleEnumerateResponse(
-                    cimResponse,
-                    (WsenEnumerateRequest*) wsmRequest);
+                if (_handleEnumerateResponse(
+                        cimResponse,
+                        (WsenEnumerateRequest*) wsmRequest))
+                {
+                    // The request is retained by the context of the
+                    // streamed enumeration
+                    wsmRequestDestroyer.release();
+                }
+                break;
+
+            case WS_ENUMERATION_PULL:
+                _handlePullResponse(
+                    (CIMPullInstancesWithPathResponseMessage*) cimResponse,
+                    (WsenPullRequest*) wsmRequest);
                 break;
 
             default:
@@ -251,20 +314,28 @@ Uint32 WsmProcessor::getWsmRequestDecoderQueueId()
     return _wsmRequestDecoder.getQueueId();
 }
 
-void WsmProcessor::_handleEnumerateResponse(
+Boolean WsmProcessor::_handleEnumerateResponse(
     CIMResponseMessage* cimResponse,
     WsenEnumerateRequest* wsmRequest)
 {
     if (cimResponse->cimException.getCode() != CIM_ERR_SUCCESS)
     {
         _handleDefaultResponse(cimResponse, wsmRequest);
-        return;
+        return false;
+    }
+
+    if (cimResponse->getType() == CIM_OPEN_ENUMERATE_INSTANCES_RESPONSE_MESSAGE)
+    {
+        return _handleStreamedEnumerateResponse(
+            (CIMOpenEnumerateInstancesResponseMessage*) cimResponse,
+            wsmRequest);
     }
 
     AutoPtr<SoapResponse> soapResponse;
 
     {
         AutoMutex lock(_enumerationContextTableLock);
+        _startSweeper();
 
         AutoPtr<WsenEnumerateResponse> wsmResponse(
             (WsenEnumerateResponse*) _cimToWsmResponseMapper.
@@ -325,11 +396,215 @@ void WsmProcessor::_handleEnumerateResponse(
     }
 
     _wsmResponseEncoder.sendResponse(soapResponse.get());
+    return false;
+}
+
+Boolean WsmProcessor::_handleStreamedEnumerateResponse(
+    CIMOpenEnumerateInstancesResponseMessage* cimResponse,
+    WsenEnumerateRequest* wsmRequest)
+{
+    // Get the enumeration expiration time
+    CIMDateTime expiration;
+    try
+    {
+        _getExpirationDatetime(wsmRequest->expiration, expiration);
+    }
+    catch (...)
+    {
+        if (!cimResponse->endOfSequence)
+        {
+            _enqueueCloseRequest(
+                _wsmToCimRequestMapper.mapToCimCloseEnumerationRequest(
+                    wsmRequest, cimResponse->enumerationContext));
+        }
+        throw;
+    }
+
+    AutoPtr<SoapResponse> soapResponse;
+    Boolean retained = false;
+
+    {
+        AutoMutex lock(_enumerationContextTableLock);
+        _startSweeper();
+
+        AutoPtr<WsenEnumerateResponse> wsmResponse(
+            _mapStreamedResponse(wsmRequest, cimResponse));
+
+        Uint64 contextId = _currentEnumContext++;
+        wsmResponse->setEnumerationContext(contextId);
+
+        // Get the requested chunk of results
+        AutoPtr<WsenEnumerateResponse> splitResponse(
+            _splitEnumerateResponse(wsmRequest, wsmResponse.get(),
+                wsmRequest->optimized ? wsmRequest->maxElements : 0));
+        splitResponse->setEnumerationContext(contextId);
+
+        if (wsmResponse->getSize() == 0 && cimResponse->endOfSequence)
+        {
+            splitResponse->setComplete();
+        }
+
+        Uint32 numDataItemsEncoded = 0;
+        soapResponse.reset(_wsmResponseEncoder.encodeWsenEnumerateResponse(
+            splitResponse.get(), numDataItemsEncoded));
+
+        if (splitResponse->getSize() > numDataItemsEncoded)
+        {
+            // Add unprocessed items back to the context
+            splitResponse->remove(0, numDataItemsEncoded);
+            wsmResponse->merge(splitResponse.get());
+        }
+
+        // Keep a context unless both the items fetched and the open
+        // enumeration are exhausted
+        if (wsmResponse->getSize() != 0 || !cimResponse->endOfSequence)
+        {
+            EnumerationContext enumContext(
+                contextId,
+                wsmRequest->userName,
+                wsmRequest->enumerationMode,
+                expiration,
+                wsmRequest->epr,
+                wsmResponse.release(),
+                wsmRequest,
+                cimResponse->endOfSequence ?
+                    String::EMPTY : cimResponse->enumerationContext);
+            enumContext.cimActivityTime =
+                TimeValue::getCurrentTime().toMicroseconds();
+            _enumerationContextTable.insert(contextId, enumContext);
+            retained = true;
+        }
+    }
+
+    _wsmResponseEncoder.sendResponse(soapResponse.get());
+    return retained;
+}
+
+void WsmProcessor::_handlePullResponse(
+    CIMPullInstancesWithPathResponseMessage* cimResponse,
+    WsenPullRequest* wsmRequest)
+{
+    AutoPtr<SoapResponse> soapResponse;
+
+    {
+        AutoMutex lock(_enumerationContextTableLock);
+        EnumerationContext* enumContext;
+
+        // Neither Release nor expiration remove a context while a pull
+        // of its open enumeration is in progress
+        if (!_enumerationContextTable.lookupReference(
+                wsmRequest->enumerationContext, enumContext))
+        {
+            PEGASUS_ASSERT(0);
+            throw WsmFault(
+                WsmFault::wsen_InvalidEnumerationContext,
+                MessageLoaderParms(
+                    "WsmServer.WsmProcessor.INVALID_ENUMERATION_CONTEXT",
+                    "Enumeration context \"$0\" is not valid.",
+                    wsmRequest->enumerationContext));
+        }
+
+        enumContext->pullPending = false;
+        enumContext->cimActivityTime =
+            TimeValue::getCurrentTime().toMicroseconds();
+
+        if (cimResponse->cimException.getCode() != CIM_ERR_SUCCESS)
+        {
+            // The open enumeration is closed on error
+            WsmFault fault = _cimToWsmResponseMapper.mapCimExceptionToWsmFault(
+                cimResponse->cimException);
+            enumContext->cimEnumerationContext.clear();
+            _removeContext(enumContext);
+            throw fault;
+        }
+
+        AutoPtr<WsenEnumerateResponse> wsmResponse(
+            _mapStreamedResponse(enumContext->request, cimResponse));
+        enumContext->response->merge(wsmResponse.get());
+
+        if (cimResponse->endOfSequence)
+        {
+            enumContext->cimEnumerationContext.clear();
+        }
+        else
+        {
+            enumContext->cimEnumerationContext =
+                cimResponse->enumerationContext;
+        }
+
+        soapResponse.reset(_encodePullResponse(wsmRequest, enumContext));
+    }
+
+    _wsmResponseEncoder.sendResponse(soapResponse.get());
+}
+
+Boolean WsmProcessor::_handleRefreshResponse(CIMResponseMessage* cimResponse)
+{
+    WsmRequest* deferredRequest;
+
+    {
+        AutoMutex lock(_enumerationContextTableLock);
+
+        Uint64 contextId;
+        if (!_refreshTable.lookup(cimResponse->messageId, contextId))
+        {
+            return false;
+        }
+        _refreshTable.remove(cimResponse->messageId);
+
+        // Neither Release nor expiration remove a context while a refresh
+        // of its open enumeration is in progress
+        EnumerationContext* enumContext;
+        if (!_enumerationContextTable.lookupReference(contextId, enumContext))
+        {
+            PEGASUS_ASSERT(0);
+            return true;
+        }
+
+        enumContext->refreshPending = false;
+        enumContext->cimActivityTime =
+            TimeValue::getCurrentTime().toMicroseconds();
+
+        CIMPullInstancesWithPathResponseMessage* pullResponse =
+            (CIMPullInstancesWithPathResponseMessage*) cimResponse;
+
+        if (cimResponse->cimException.getCode() != CIM_ERR_SUCCESS)
+        {
+            // The open enumeration is closed on error
+            PEG_TRACE((TRC_WSMSERVER, Tracer::LEVEL2,
+                "Refresh of enumeration context %s failed with status %u",
+                (const char*)
+                    enumContext->cimEnumerationContext.getCString(),
+                Uint32(cimResponse->cimException.getCode())));
+            enumContext->cimError = cimResponse->cimException;
+            enumContext->cimEnumerationContext.clear();
+        }
+        else if (pullResponse->endOfSequence)
+        {
+            enumContext->cimEnumerationContext.clear();
+        }
+        else
+        {
+            enumContext->cimEnumerationContext =
+                pullResponse->enumerationContext;
+        }
+
+        deferredRequest = enumContext->deferredRequest;
+        enumContext->deferredRequest = 0;
+    }
+
+    if (deferredRequest)
+    {
+        handleRequest(deferredRequest);
+    }
+
+    return true;
 }
 
-void WsmProcessor::_handlePullRequest(WsenPullRequest* wsmRequest)
+Boolean WsmProcessor::_handlePullRequest(WsenPullRequest* wsmRequest)
 {
     AutoPtr<SoapResponse> soapResponse;
+    AutoPtr<CIMPullInstancesWithPathRequestMessage> cimRequest;
 
     {
         AutoMutex lock(_enumerationContextTableLock);
@@ -363,30 +638,53 @@ void WsmProcessor::_handlePullRequest(WsenPullRequest* wsmRequest)
                 throw WsmFault(WsmFault::wsman_AccessDenied);
             }
 
-            AutoPtr<WsenPullResponse> wsmResponse(_splitPullResponse(
-                wsmRequest, enumContext->response, wsmRequest->maxElements));
-            wsmResponse->setEnumerationContext(enumContext->contextId);
-            if (enumContext->response->getSize() == 0)
+            if (enumContext->cimEnumerationContext.size() &&
+                enumContext->response->getSize() < wsmRequest->maxElements)
             {
-                wsmResponse->setComplete();
+                // Pull the missing items from the open enumeration
+                if (enumContext->pullPending || enumContext->deferredRequest)
+                {
+                    throw WsmFault(
+                        WsmFault::wsman_Concurrency,
+                        MessageLoaderParms(
+                            "WsmServer.WsmProcessor.PULL_IN_PROGRESS",
+                            "A Pull request of enumeration context \"$0\" "
+                                "is in progress.",
+                            wsmRequest->enumerationContext));
+                }
+
+                if (enumContext->refreshPending)
+                {
+                    // Handled again once the refresh completes
+                    enumContext->deferredRequest = wsmRequest;
+                    return true;
+                }
+
+                cimRequest.reset(_wsmToCimRequestMapper.
+                    mapToCimPullInstancesWithPathRequest(
+                        enumContext->request,
+                        enumContext->cimEnumerationContext,
+                        wsmRequest->maxElements -
+                            enumContext->response->getSize()));
+                enumContext->pullPending = true;
+
+                // Save the request until the pull response comes back
+                _requestTable.insert(cimRequest->messageId, wsmRequest);
             }
-
-            Uint32 numDataItemsEncoded = 0;
-            soapResponse.reset(_wsmResponseEncoder.encodeWsenPullResponse(
-                wsmResponse.get(), numDataItemsEncoded));
-
-            if (wsmResponse->getSize() > numDataItemsEncoded)
+            else if (enumContext->response->getSize() == 0 &&
+                enumContext->cimError.getCode() != CIM_ERR_SUCCESS)
             {
-                // Add unprocessed items back to the context
-                wsmResponse->remove(0, numDataItemsEncoded);
-                enumContext->response->merge(wsmResponse.get());
+                // The open enumeration was closed on error by a refresh
+                WsmFault fault =
+                    _cimToWsmResponseMapper.mapCimExceptionToWsmFault(
+                        enumContext->cimError);
+                _removeContext(enumContext);
+                throw fault;
             }
-
-            // Remove the context if there are no instances left
-            if (enumContext->response->getSize() == 0)
+            else
             {
-                delete enumContext->response;
-                _enumerationContextTable.remove(wsmRequest->enumerationContext);
+                soapResponse.reset(
+                    _encodePullResponse(wsmRequest, enumContext));
             }
         }
         else
@@ -400,22 +698,119 @@ void WsmProcessor::_handlePullRequest(WsenPullRequest* wsmRequest)
         }
     }
 
+    if (cimRequest.get())
+    {
+        cimRequest->queueIds.push(getQueueId());
+        _cimOperationProcessorQueue->enqueue(cimRequest.release());
+        return true;
+    }
+
     _wsmResponseEncoder.sendResponse(soapResponse.get());
+    return false;
 }
 
-void WsmProcessor::_handleReleaseRequest(WsenReleaseRequest* wsmRequest)
+SoapResponse* WsmProcessor::_encodePullResponse(
+    WsenPullRequest* wsmRequest,
+    EnumerationContext* enumContext)
+{
+    AutoPtr<WsenPullResponse> wsmResponse(_splitPullResponse(
+        wsmRequest, enumContext->response, wsmRequest->maxElements));
+    wsmResponse->setEnumerationContext(enumContext->contextId);
+
+    // A streamed enumeration is complete once its open enumeration is
+    // exhausted as well.  The error that closed the open enumeration is
+    // returned by the next Pull request.
+    Boolean complete = enumContext->cimEnumerationContext.size() == 0 &&
+        enumContext->cimError.getCode() == CIM_ERR_SUCCESS;
+
+    if (enumContext->response->getSize() == 0 && complete)
+    {
+        wsmResponse->setComplete();
+    }
+
+    Uint32 numDataItemsEncoded = 0;
+    AutoPtr<SoapResponse> soapResponse(
+        _wsmResponseEncoder.encodeWsenPullResponse(
+            wsmResponse.get(), numDataItemsEncoded));
+
+    if (wsmResponse->getSize() > numDataItemsEncoded)
+    {
+        // Add unprocessed items back to the context
+        wsmResponse->remove(0, numDataItemsEncoded);
+        enumContext->response->merge(wsmResponse.get());
+    }
+
+    // Remove the context if there are no instances left
+    if (enumContext->response->getSize() == 0 && complete)
+    {
+        _removeContext(enumContext);
+    }
+
+    return soapResponse.release();
+}
+
+WsenEnumerateResponse* WsmProcessor::_mapStreamedResponse(
+    WsenEnumerateRequest* wsmRequest,
+    CIMOpenOrPullResponseDataMessage* cimResponse)
+{
+    // The open and pull operations return full instance paths.  The host
+    // is removed so that the EPRs match those of a buffered enumeration.
+    Array<CIMInstance>& instances =
+        cimResponse->getResponseData().getInstances();
+    for (Uint32 i = 0, n = instances.size(); i < n; i++)
+    {
+        const_cast<CIMObjectPath&>(instances[i].getPath()).setHost(
+            String::EMPTY);
+    }
+
+    return _cimToWsmResponseMapper.mapToWsenEnumerateResponse(
+        wsmRequest, cimResponse);
+}
+
+CIMCloseEnumerationRequestMessage* WsmProcessor::_removeContext(
+    EnumerationContext* enumContext)
+{
+    CIMCloseEnumerationRequestMessage* cimRequest = 0;
+
+    if (enumContext->cimEnumerationContext.size())
+    {
+        cimRequest = _wsmToCimRequestMapper.mapToCimCloseEnumerationRequest(
+            enumContext->request, enumContext->cimEnumerationContext);
+    }
+
+    delete enumContext->response;
+    delete enumContext->request;
+    delete enumContext->deferredRequest;
+    _enumerationContextTable.remove(enumContext->contextId);
+
+    return cimRequest;
+}
+
+void WsmProcessor::_enqueueCloseRequest(
+    CIMCloseEnumerationRequestMessage* cimRequest)
+{
+    if (cimRequest)
+    {
+        // The response is discarded by handleResponse()
+        cimRequest->queueIds.push(getQueueId());
+        _cimOperationProcessorQueue->enqueue(cimRequest);
+    }
+}
+
+Boolean WsmProcessor::_handleReleaseRequest(WsenReleaseRequest* wsmRequest)
 {
     AutoPtr<WsenReleaseResponse> wsmResponse;
+    AutoPtr<CIMCloseEnumerationRequestMessage> cimRequest;
 
     {
         AutoMutex lock(_enumerationContextTableLock);
 
-        EnumerationContext enumContext;
-        if (_enumerationContextTable.lookup(
+        EnumerationContext* enumContext;
+        if (_enumerationContextTable.lookupReference(
                 wsmRequest->enumerationContext, enumContext))
         {
             // EPRs of the request and the enumeration context must match
-            if (wsmRequest->epr != enumContext.epr)
+            if (wsmRequest->epr != enumContext->epr)
             {
                 throw WsmFault(
                     WsmFault::wsa_MessageInformationHeaderRequired,
@@ -427,7 +822,7 @@ void WsmProcessor::_handleReleaseRequest(WsenReleaseRequest* wsmRequest)
 
             // User credentials of the request and the enumeration context must
             // match.
-            if (wsmRequest->userName != enumContext.userName)
+            if (wsmRequest->userName != enumContext->userName)
             {
                 // DSP0226 R8.1-6:  The wsen:Pull and wsen:Release operations
                 // are a continuation of the original wsen:Enumerate operation.
@@ -439,11 +834,28 @@ void WsmProcessor::_handleReleaseRequest(WsenReleaseRequest* wsmRequest)
                 throw WsmFault(WsmFault::wsman_AccessDenied);
             }
 
+            if (enumContext->pullPending || enumContext->deferredRequest)
+            {
+                throw WsmFault(
+                    WsmFault::wsman_Concurrency,
+                    MessageLoaderParms(
+                        "WsmServer.WsmProcessor.PULL_IN_PROGRESS",
+                        "A Pull request of enumeration context \"$0\" "
+                            "is in progress.",
+                        wsmRequest->enumerationContext));
+            }
+
+            if (enumContext->refreshPending)
+            {
+                // Handled again once the refresh completes
+                enumContext->deferredRequest = wsmRequest;
+                return true;
+            }
+
             wsmResponse.reset(new WsenReleaseResponse(
-                wsmRequest, enumContext.response->getContentLanguages()));
+                wsmRequest, enumContext->response->getContentLanguages()));
 
-            delete enumContext.response;
-            _enumerationContextTable.remove(wsmRequest->enumerationContext);
+            cimRequest.reset(_removeContext(enumContext));
         }
         else
         {
@@ -456,7 +868,9 @@ void WsmProcessor::_handleReleaseRequest(WsenReleaseRequest* wsmRequest)
         }
     }
 
+    _enqueueCloseRequest(cimRequest.release());
     _wsmResponseEncoder.enqueue(wsmResponse.get());
+    return false;
 }
 
 void WsmProcessor::_handleDefaultResponse(
@@ -555,26 +969,145 @@ void WsmProcessor::_getExpirationDatetime(
 void WsmProcessor::cleanupExpiredContexts()
 {
     CIMDateTime currentDT = CIMDateTime::getCurrentDateTime();
-    Array<Uint64> expiredContextIds;
-    Array<WsenEnumerateResponse*> expiredResponses;
+    Uint64 refreshTime = TimeValue::getCurrentTime().toMicroseconds() -
+        Uint64(PEGASUS_WSM_OPEN_ENUMERATION_REFRESH_SECONDS) * 1000000;
+    Array<CIMCloseEnumerationRequestMessage*> closeRequests;
+    Array<CIMPullInstancesWithPathRequestMessage*> refreshRequests;
 
-    AutoMutex lock(_enumerationContextTableLock);
-    for (EnumerationContextTable::Iterator i =
-             _enumerationContextTable.start (); i; i++)
     {
-        EnumerationContext context = i.value();
-        if (context.expiration < currentDT)
+        AutoMutex lock(_enumerationContextTableLock);
+
+        // A context is not expired while a pull or a refresh is in progress
+        Array<Uint64> expiredContextIds;
+        Array<Uint64> idleContextIds;
+        for (EnumerationContextTable::Iterator i =
+                 _enumerationContextTable.start(); i; i++)
+        {
+            const EnumerationContext& context = i.value();
+
+            if (context.pullPending || context.refreshPending)
+            {
+                continue;
+            }
+
+            if (context.expiration < currentDT)
+            {
+                expiredContextIds.append(context.contextId);
+            }
+            else if (context.cimEnumerationContext.size() &&
+                context.cimActivityTime < refreshTime)
+            {
+                idleContextIds.append(context.contextId);
+            }
+        }
+
+        for (Uint32 i = 0; i < idleContextIds.size(); i++)
         {
-            expiredContextIds.append(context.contextId);
-            expiredResponses.append(context.response);
+            EnumerationContext* enumContext;
+            _enumerationContextTable.lookupReference(
+                idleContextIds[i], enumContext);
+
+            // Pull no items, which restarts the operation timeout of the
+            // idle open enumeration
+            CIMPullInstancesWithPathRequestMessage* cimRequest =
+                _wsmToCimRequestMapper.mapToCimPullInstancesWithPathRequest(
+                    enumContext->request,
+                    enumContext->cimEnumerationContext,
+                    0);
+            _refreshTable.insert(cimRequest->messageId, enumContext->contextId);
+            enumContext->refreshPending = true;
+            refreshRequests.append(cimRequest);
         }
+
+        for (Uint32 i = 0; i < expiredContextIds.size(); i++)
+        {
+            EnumerationContext* enumContext;
+            _enumerationContextTable.lookupReference(
+                expiredContextIds[i], enumContext);
+
+            CIMCloseEnumerationRequestMessage* cimRequest =
+                _removeContext(enumContext);
+            if (cimRequest)
+            {
+                closeRequests.append(cimRequest);
+            }
+        }
+
+        if (expiredContextIds.size())
+        {
+            PEG_TRACE((TRC_WSMSERVER, Tracer::LEVEL4,
+                "Removed %u expired enumeration contexts",
+                expiredContextIds.size()));
+        }
+    }
+
+    for (Uint32 i = 0; i < closeRequests.size(); i++)
+    {
+        _enqueueCloseRequest(closeRequests[i]);
     }
 
-    for (Uint32 i = 0; i < expiredContextIds.size(); i++)
+    if (refreshRequests.size())
     {
-        delete expiredResponses[i];
-        _enumerationContextTable.remove(expiredContextIds[i]);
+        PEG_TRACE((TRC_WSMSERVER, Tracer::LEVEL4,
+            "Refreshing %u idle open enumerations",
+            refreshRequests.size()));
     }
+
+    for (Uint32 i = 0; i < refreshRequests.size(); i++)
+    {
+        // The response is handled by handleResponse()
+        refreshRequests[i]->queueIds.push(getQueueId());
+        _cimOperationProcessorQueue->enqueue(refreshRequests[i]);
+    }
+}
+
+void WsmProcessor::_startSweeper()
+{
+    if (_sweeper.get())
+    {
+        return;
+    }
+
+    AutoPtr<Thread> sweeper(new Thread(_sweeperThread, this, false));
+
+    if (sweeper->run() != PEGASUS_THREAD_OK)
+    {
+        // Started with a later enumeration
+        PEG_TRACE_CSTRING(TRC_WSMSERVER, Tracer::LEVEL1,
+            "Could not start the enumeration context sweeper thread");
+        return;
+    }
+
+    _sweeper.reset(sweeper.release());
+}
+
+ThreadReturnType PEGASUS_THREAD_CDECL WsmProcessor::_sweeperThread(void* parm)
+{
+    Thread* myself = reinterpret_cast<Thread*>(parm);
+    WsmProcessor* processor =
+        reinterpret_cast<WsmProcessor*>(myself->get_parm());
+
+    while (!processor->_stopSweeper.time_wait(
+        PEGASUS_WSM_ENUMERATION_CONTEXT_SWEEPER_INTERVAL_MSEC))
+    {
+        try
+        {
+            processor->cleanupExpiredContexts();
+        }
+        catch (Exception& e)
+        {
+            PEG_TRACE((TRC_WSMSERVER, Tracer::LEVEL1,
+                "Exception caught in WsmProcessor::_sweeperThread: %s",
+                (const char*)e.getMessage().getCString()));
+        }
+        catch (...)
+        {
+            PEG_TRACE_CSTRING(TRC_WSMSERVER, Tracer::LEVEL1,
+                "Unknown exception caught in WsmProcessor::_sweeperThread");
+        }
+    }
+
+    return 0;
 }
 
 PEGASUS_NAMESPACE_END
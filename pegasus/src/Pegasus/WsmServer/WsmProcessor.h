@@ -35,6 +35,9 @@
 #include <Pegasus/Common/Config.h>
 #include <Pegasus/Common/MessageQueue.h>
 #include <Pegasus/Common/CIMMessage.h>
+#include <Pegasus/Common/Thread.h>
+#include <Pegasus/Common/Semaphore.h>
+#include <Pegasus/Common/AutoPtr.h>
 #include <Pegasus/Repository/CIMRepository.h>
 #include <Pegasus/WsmServer/WsmRequestDecoder.h>
 #include <Pegasus/WsmServer/WsmResponseEncoder.h>
@@ -44,23 +47,44 @@
 
 PEGASUS_NAMESPACE_BEGIN
 
+/**
+    An EnumerationContext holds the items of an enumeration that were not
+    pulled yet.  A buffered enumeration holds all its remaining items.  A
+    streamed enumeration holds the items fetched but not returned (those
+    that did not fit in a response envelope) and pulls the following items
+    from the open enumeration of the CIM server on demand.
+*/
 class EnumerationContext
 {
 public:
-    EnumerationContext() {}
+    EnumerationContext()
+        : response(0),
+          request(0),
+          pullPending(false),
+          refreshPending(false),
+          deferredRequest(0),
+          cimActivityTime(0) {}
     EnumerationContext(
         Uint64 contextId_,
         const String& userName_,
         WsenEnumerationMode enumerationMode_,
         CIMDateTime expiration_,
         WsmEndpointReference epr_,
-        WsenEnumerateResponse* response_)
+        WsenEnumerateResponse* response_,
+        WsenEnumerateRequest* request_ = 0,
+        const String& cimEnumerationContext_ = String::EMPTY)
         : contextId(contextId_),
           userName(userName_),
           enumerationMode(enumerationMode_),
           expiration(expiration_),
           epr(epr_),
-          response(response_) {}
+          response(response_),
+          request(request_),
+          cimEnumerationContext(cimEnumerationContext_),
+          pullPending(false),
+          refreshPending(false),
+          deferredRequest(0),
+          cimActivityTime(0) {}
 
     Uint64 contextId;
     String userName;
@@ -68,6 +92,47 @@ public:
     CIMDateTime expiration;
     WsmEndpointReference epr;
     WsenEnumerateResponse* response;
+
+    /**
+        The Enumerate request of a streamed enumeration, used to map its
+        pull and close operations.  Null for a buffered enumeration.
+    */
+    WsenEnumerateRequest* request;
+
+    /**
+        The context of the open enumeration of a streamed enumeration.
+        Empty once the open enumeration is exhausted.
+    */
+    String cimEnumerationContext;
+
+    /**
+        Whether a pull of the open enumeration is in progress.
+    */
+    Boolean pullPending;
+
+    /**
+        Whether a refresh of the open enumeration, a pull of no items that
+        keeps it from timing out, is in progress.
+    */
+    Boolean refreshPending;
+
+    /**
+        A Pull or Release request that waits for the refresh in progress
+        to complete.
+    */
+    WsmRequest* deferredRequest;
+
+    /**
+        The time (microseconds) of the last response of the open
+        enumeration.
+    */
+    Uint64 cimActivityTime;
+
+    /**
+        The error that closed the open enumeration during a refresh.  It is
+        returned by the Pull request that finds no items left.
+    */
+    CIMException cimError;
 };
 
 
@@ -106,15 +171,41 @@ public:
         _wsmRequestDecoder.setServerTerminating(flag);
     }
 
+    /**
+        Removes the enumeration contexts past their expiration time and
+        closes their open enumerations.  Refreshes the open enumerations
+        that are idle for half the maximum pull operation timeout, so that
+        a streamed enumeration lasts until its own expiration time.  Called
+        periodically by the sweeper thread, started with the first
+        enumeration.
+    */
     void cleanupExpiredContexts();
 
 private:
 
-    void _handlePullRequest(WsenPullRequest* wsmRequest);
-    void _handleReleaseRequest(WsenReleaseRequest* wsmRequest);
-    void _handleEnumerateResponse(
+    Boolean _handlePullRequest(WsenPullRequest* wsmRequest);
+    Boolean _handleReleaseRequest(WsenReleaseRequest* wsmRequest);
+    Boolean _handleEnumerateResponse(
         CIMResponseMessage* cimResponse,
         WsenEnumerateRequest* wsmRequest);
+    Boolean _handleStreamedEnumerateResponse(
+        CIMOpenEnumerateInstancesResponseMessage* cimResponse,
+        WsenEnumerateRequest* wsmRequest);
+    void _handlePullResponse(
+        CIMPullInstancesWithPathResponseMessage* cimResponse,
+        WsenPullRequest* wsmRequest);
+    Boolean _handleRefreshResponse(CIMResponseMessage* cimResponse);
+    SoapResponse* _encodePullResponse(
+        WsenPullRequest* wsmRequest,
+        EnumerationContext* enumContext);
+    WsenEnumerateResponse* _mapStreamedResponse(
+        WsenEnumerateRequest* wsmRequest,
+        CIMOpenOrPullResponseDataMessage* cimResponse);
+    CIMCloseEnumerationRequestMessage* _removeContext(
+        EnumerationContext* enumContext);
+    void _enqueueCloseRequest(CIMCloseEnumerationRequestMessage* cimRequest);
+    void _startSweeper();
+    static ThreadReturnType PEGASUS_THREAD_CDECL _sweeperThread(void* parm);
     void _handleDefaultResponse(
         CIMResponseMessage* cimResponse,
         WsmRequest* wsmRequest);
@@ -161,8 +252,21 @@ private:
         EqualFunc<Uint64>, HashFunc<Uint64> > EnumerationContextTable;
 
     EnumerationContextTable _enumerationContextTable;
+
+    typedef HashTable<String,
+        Uint64, EqualFunc<String>, HashFunc<String> > RefreshTable;
+    /**
+        The RefreshTable maps the message IDs of the refreshes in progress
+        to their enumeration contexts.
+    */
+    RefreshTable _refreshTable;
+
+    /** Protects _enumerationContextTable and _refreshTable */
     Mutex _enumerationContextTableLock;
     static Uint64 _currentEnumContext;
+
+    AutoPtr<Thread> _sweeper;
+    Semaphore _stopSweeper;
 };
 
 PEGASUS_NAMESPACE_END
@@ -105,7 +105,12 @@ CIMOperationRequestMessage* WsmToCimRequestMapper::mapToCimRequest(
             break;
 
         case WS_ENUMERATION_ENUMERATE:
-            if (((WsenEnumerateRequest*) request)->enumerationMode ==
+            if (isStreamedEnumeration((WsenEnumerateRequest*) request))
+            {
+                cimRequest.reset(mapToCimOpenEnumerateInstancesRequest(
+                    (WsenEnumerateRequest*) request));
+            }
+            else if (((WsenEnumerateRequest*) request)->enumerationMode ==
                 WSEN_EM_OBJECT ||
                 ((WsenEnumerateRequest*) request)->enumerationMode ==
                 WSEN_EM_OBJECT_AND_EPR)
@@ -144,21 +149,28 @@ CIMOperationRequestMessage* WsmToCimRequestMapper::mapToCimRequest(
 
     if (cimRequest.get())
     {
-        cimRequest->operationContext.insert(
-            IdentityContainer(request->userName));
-        cimRequest->operationContext.set(
-            AcceptLanguageListContainer(request->acceptLanguages));
-        cimRequest->operationContext.set(
-            ContentLanguageListContainer(request->contentLanguages));
-        cimRequest->setHttpMethod(request->httpMethod);
-        cimRequest->setCloseConnect(request->httpCloseConnect);
-        cimRequest->binaryRequest = true;
-        cimRequest->binaryResponse = true;
+        _setRequestContext(cimRequest.get(), request);
     }
 
     return cimRequest.release();
 }
 
+void WsmToCimRequestMapper::_setRequestContext(
+    CIMOperationRequestMessage* cimRequest,
+    WsmRequest* request)
+{
+    cimRequest->operationContext.insert(
+        IdentityContainer(request->userName));
+    cimRequest->operationContext.set(
+        AcceptLanguageListContainer(request->acceptLanguages));
+    cimRequest->operationContext.set(
+        ContentLanguageListContainer(request->contentLanguages));
+    cimRequest->setHttpMethod(request->httpMethod);
+    cimRequest->setCloseConnect(request->httpCloseConnect);
+    cimRequest->binaryRequest = true;
+    cimRequest->binaryResponse = true;
+}
+
 CIMGetInstanceRequestMessage*
     WsmToCimRequestMapper::mapToCimGetInstanceRequest(
     WxfGetRequest* request)
@@ -338,6 +350,147 @@ CIMEnumerateInstanceNamesRequestMessage*
     return cimRequest;
 }
 
+Boolean WsmToCimRequestMapper::isStreamedEnumeration(
+    const WsenEnumerateRequest* request)
+{
+    return request->optimized &&
+        (request->enumerationMode == WSEN_EM_OBJECT ||
+         request->enumerationMode == WSEN_EM_OBJECT_AND_EPR) &&
+        !request->requestItemCount;
+}
+
+Uint64 WsmToCimRequestMapper::_getExpirationSeconds(const String& wsmDT)
+{
+    if (wsmDT.size() == 0)
+    {
+        return 0;
+    }
+
+    CIMDateTime dt;
+    try
+    {
+        convertWsmToCimDatetime(wsmDT, dt);
+    }
+    catch (...)
+    {
+        return 0;
+    }
+
+    Uint64 usec = dt.toMicroSeconds();
+
+    if (!dt.isInterval())
+    {
+        Uint64 now = CIMDateTime::getCurrentDateTime().toMicroSeconds();
+        usec = usec > now ? usec - now : 0;
+    }
+
+    return (usec + 999999) / 1000000;
+}
+
+Uint32 WsmToCimRequestMapper::_getOperationTimeout(const String& wsmDT)
+{
+    // An enumeration that expires within the maximum pull operation timeout
+    // is closed by the CIM server if it stays idle until then.  A later
+    // expiration (or the default) is reached by refreshing the open
+    // enumeration (see WsmProcessor::cleanupExpiredContexts()).
+    Uint64 seconds = _getExpirationSeconds(wsmDT);
+
+    if (seconds == 0 || seconds > PEGASUS_MAX_PULL_OPERATION_TIMEOUT_SECONDS)
+    {
+        return PEGASUS_MAX_PULL_OPERATION_TIMEOUT_SECONDS;
+    }
+
+    return (Uint32)seconds;
+}
+
+CIMOpenEnumerateInstancesRequestMessage*
+    WsmToCimRequestMapper::mapToCimOpenEnumerateInstancesRequest(
+        WsenEnumerateRequest* request)
+{
+    CIMObjectPath objPath;
+    convertEPRToObjectPath(request->epr, objPath);
+
+    // The optimized enumeration returns its first items with the Enumerate
+    // response.
+    Uint32 maxObjectCount = 0;
+    if (request->optimized)
+    {
+        maxObjectCount = request->maxElements < PEGASUS_MAX_PULL_OBJECT_COUNT ?
+            request->maxElements : PEGASUS_MAX_PULL_OBJECT_COUNT;
+    }
+
+    CIMOpenEnumerateInstancesRequestMessage* cimRequest =
+        new CIMOpenEnumerateInstancesRequestMessage(
+            XmlWriter::getNextMessageId(),
+            objPath.getNameSpace(),
+            objPath.getClassName(),
+            request->polymorphismMode == WSMB_PM_INCLUDE_SUBCLASS_PROPERTIES,
+            false, // includeClassOrigin
+            CIMPropertyList(),
+            String::EMPTY, // filterQueryLanguage
+            String::EMPTY, // filterQuery
+            _getOperationTimeout(request->expiration),
+            false, // continueOnError
+            maxObjectCount,
+            QueueIdStack(request->queueId),
+            request->authType,
+            request->userName);
+    cimRequest->ipAddress = request->ipAddress;
+
+    return cimRequest;
+}
+
+CIMPullInstancesWithPathRequestMessage*
+    WsmToCimRequestMapper::mapToCimPullInstancesWithPathRequest(
+        WsenEnumerateRequest* request,
+        const String& enumerationContext,
+        Uint32 maxObjectCount)
+{
+    CIMObjectPath objPath;
+    convertEPRToObjectPath(request->epr, objPath);
+
+    if (maxObjectCount > PEGASUS_MAX_PULL_OBJECT_COUNT)
+    {
+        maxObjectCount = PEGASUS_MAX_PULL_OBJECT_COUNT;
+    }
+
+    CIMPullInstancesWithPathRequestMessage* cimRequest =
+        new CIMPullInstancesWithPathRequestMessage(
+            XmlWriter::getNextMessageId(),
+            objPath.getNameSpace(),
+            enumerationContext,
+            maxObjectCount,
+            QueueIdStack(request->queueId),
+            request->authType,
+            request->userName);
+    cimRequest->ipAddress = request->ipAddress;
+    _setRequestContext(cimRequest, request);
+
+    return cimRequest;
+}
+
+CIMCloseEnumerationRequestMessage*
+    WsmToCimRequestMapper::mapToCimCloseEnumerationRequest(
+        WsenEnumerateRequest* request,
+        const String& enumerationContext)
+{
+    CIMObjectPath objPath;
+    convertEPRToObjectPath(request->epr, objPath);
+
+    CIMCloseEnumerationRequestMessage* cimRequest =
+        new CIMCloseEnumerationRequestMessage(
+            XmlWriter::getNextMessageId(),
+            objPath.getNameSpace(),
+            enumerationContext,
+            QueueIdStack(request->queueId),
+            request->authType,
+            request->userName);
+    cimRequest->ipAddress = request->ipAddress;
+    _setRequestContext(cimRequest, request);
+
+    return cimRequest;
+}
+
 CIMInvokeMethodRequestMessage*
 WsmToCimRequestMapper::mapToCimInvokeMethodRequest(
     WsInvokeRequest* request)
@@ -63,6 +63,49 @@ public:
         WsenEnumerateRequest* request);
     CIMEnumerateInstanceNamesRequestMessage*
         mapToCimEnumerateInstanceNamesRequest(WsenEnumerateRequest* request);
+
+    /**
+        Maps an Enumerate request to an open enumeration whose instances
+        are pulled by the subsequent Pull requests instead of being
+        returned all at once (streamed enumeration).
+    */
+    CIMOpenEnumerateInstancesRequestMessage*
+        mapToCimOpenEnumerateInstancesRequest(WsenEnumerateRequest* request);
+
+    /**
+        Maps a Pull request of a streamed enumeration to a pull of the
+        open enumeration.  The request is built from the Enumerate request
+        of the enumeration, since the Pull request carries no operation
+        parameters and its credentials must match those of the Enumerate.
+        @param request The Enumerate request of the enumeration.
+        @param enumerationContext The context of the open enumeration.
+        @param maxObjectCount Maximum number of instances to pull.
+    */
+    CIMPullInstancesWithPathRequestMessage*
+        mapToCimPullInstancesWithPathRequest(
+            WsenEnumerateRequest* request,
+            const String& enumerationContext,
+            Uint32 maxObjectCount);
+
+    /**
+        Maps the release of a streamed enumeration to the close of the
+        open enumeration.
+        @param request The Enumerate request of the enumeration.
+        @param enumerationContext The context of the open enumeration.
+    */
+    CIMCloseEnumerationRequestMessage* mapToCimCloseEnumerationRequest(
+        WsenEnumerateRequest* request,
+        const String& enumerationContext);
+
+    /**
+        Returns whether an Enumerate request is mapped to a streamed
+        enumeration.  Optimized instance enumerations that do not request
+        the total item count are streamed, whatever their expiration time.
+        They are subject to the per-user and total enumeration cache
+        limits.  Other enumerations are buffered, as the provider
+        responses read for them cannot be held back until they are pulled.
+    */
+    static Boolean isStreamedEnumeration(const WsenEnumerateRequest* request);
     CIMInvokeMethodRequestMessage* mapToCimInvokeMethodRequest(
         WsInvokeRequest* request);
 
@@ -110,6 +153,24 @@ private:
     CIMRepository* _repository;
 
     void _disallowAllClassesResourceUri(const String& resourceUri);
+
+    /**
+        Returns the number of seconds from now to the expiration time of an
+        Enumerate request, rounded up, or 0 if the request does not set a
+        valid expiration time.
+    */
+    static Uint64 _getExpirationSeconds(const String& wsmDT);
+
+    /**
+        Returns the operation timeout of the open enumeration of a streamed
+        enumeration: the expiration time of the Enumerate request, limited
+        to the maximum pull operation timeout.
+    */
+    static Uint32 _getOperationTimeout(const String& wsmDT);
+
+    void _setRequestContext(
+        CIMOperationRequestMessage* cimRequest,
+        WsmRequest* request);
 };
 
 PEGASUS_NAMESPACE_END
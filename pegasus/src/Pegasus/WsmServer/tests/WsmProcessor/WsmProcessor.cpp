@@ -0,0 +1,456 @@
+//%LICENSE////////////////////////////////////////////////////////////////
+//
+// Licensed to The Open Group (TOG) under one or more contributor license
+// agreements.  Refer to the OpenPegasusNOTICE.txt file distributed with
+// this work for additional information regarding copyright ownership.
+// Each contributor licenses this file to you under the OpenPegasus Open
+// Source License; you may not use this file except in compliance with the
+// License.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <Pegasus/Common/PegasusAssert.h>
+#include <Pegasus/Common/FileSystem.h>
+#include <Pegasus/Common/Constants.h>
+#include <Pegasus/Common/Threads.h>
+#include <Pegasus/WsmServer/WsmConstants.h>
+#include <Pegasus/WsmServer/WsmProcessor.h>
+#include <Pegasus/WsmServer/CimToWsmResponseMapper.h>
+
+PEGASUS_USING_PEGASUS;
+PEGASUS_USING_STD;
+
+static Boolean verbose;
+static String repositoryRoot;
+
+static const String NAMESPACE = "aa/bb";
+static const String CLASSNAME = "MyClass";
+
+/*
+    Stands in for the CIM operation dispatcher.  It keeps the CIM requests
+    of the WsmProcessor; the test answers them.  The responses of the
+    WsmProcessor are discarded, since the requests have no connection.
+*/
+class TestDispatcher : public MessageQueue
+{
+public:
+
+    TestDispatcher() : MessageQueue("TestDispatcher")
+    {
+    }
+
+    ~TestDispatcher()
+    {
+        for (Uint32 i = 0; i < _requests.size(); i++)
+        {
+            delete _requests[i];
+        }
+    }
+
+    virtual void enqueue(Message* message)
+    {
+        AutoMutex lock(_mutex);
+        _requests.append((CIMOperationRequestMessage*) message);
+    }
+
+    Uint32 getRequestCount()
+    {
+        AutoMutex lock(_mutex);
+        return _requests.size();
+    }
+
+    CIMOperationRequestMessage* takeRequest()
+    {
+        AutoMutex lock(_mutex);
+        PEGASUS_TEST_ASSERT(_requests.size() != 0);
+        CIMOperationRequestMessage* request = _requests[0];
+        _requests.remove(0);
+        return request;
+    }
+
+private:
+
+    Mutex _mutex;
+    Array<CIMOperationRequestMessage*> _requests;
+};
+
+static WsmEndpointReference _getEPR()
+{
+    WsmEndpointReference epr;
+    epr.address = "http://localhost:5988/wsman";
+    epr.resourceUri = String(WSM_RESOURCEURI_CIMSCHEMAV2) + "/" + CLASSNAME;
+    epr.selectorSet->selectors.append(
+        WsmSelector("__cimnamespace", NAMESPACE));
+    return epr;
+}
+
+static void _enumerate(
+    WsmProcessor& processor,
+    const String& expiration,
+    Boolean optimized = true,
+    Uint32 maxElements = 1)
+{
+    processor.handleRequest(new WsenEnumerateRequest(
+        "uuid:1",
+        _getEPR(),
+        expiration,
+        false, // requestItemCount
+        optimized,
+        maxElements,
+        WSEN_EM_OBJECT,
+        WSMB_PM_INCLUDE_SUBCLASS_PROPERTIES,
+        String::EMPTY,
+        String::EMPTY,
+        SharedPtr<WQLSelectStatement>()));
+}
+
+static void _pull(
+    WsmProcessor& processor,
+    Uint64 enumerationContext,
+    Uint32 maxElements)
+{
+    processor.handleRequest(new WsenPullRequest(
+        "uuid:2",
+        _getEPR(),
+        enumerationContext,
+        String::EMPTY,
+        false, // requestItemCount
+        maxElements,
+        0)); // maxCharacters
+}
+
+static void _release(WsmProcessor& processor, Uint64 enumerationContext)
+{
+    processor.handleRequest(new WsenReleaseRequest(
+        "uuid:3",
+        _getEPR(),
+        enumerationContext));
+}
+
+static void _appendInstances(
+    CIMResponseData& responseData,
+    Uint32 instanceCount)
+{
+    for (Uint32 i = 0; i < instanceCount; i++)
+    {
+        CIMInstance instance(CLASSNAME);
+        instance.addProperty(CIMProperty(CIMName("prop1"), String("value")));
+        instance.setPath(CIMObjectPath(
+            "localhost", NAMESPACE, CLASSNAME,
+            Array<CIMKeyBinding>()));
+        responseData.appendInstance(instance);
+    }
+}
+
+/*
+    Answers an open or pull request with the given number of instances.
+*/
+static void _respond(
+    WsmProcessor& processor,
+    CIMOperationRequestMessage* request,
+    const String& enumerationContext,
+    Uint32 instanceCount,
+    Boolean endOfSequence)
+{
+    AutoPtr<CIMOperationRequestMessage> requestDestroyer(request);
+    CIMOpenOrPullResponseDataMessage* response =
+        (CIMOpenOrPullResponseDataMessage*) request->buildResponse();
+
+    _appendInstances(response->getResponseData(), instanceCount);
+
+    response->enumerationContext = enumerationContext;
+    response->endOfSequence = endOfSequence;
+    processor.handleResponse(response);
+}
+
+static void _respondError(
+    WsmProcessor& processor,
+    CIMOperationRequestMessage* request,
+    CIMStatusCode code)
+{
+    AutoPtr<CIMOperationRequestMessage> requestDestroyer(request);
+    CIMResponseMessage* response = request->buildResponse();
+    response->cimException = PEGASUS_CIM_EXCEPTION(code, String::EMPTY);
+    processor.handleResponse(response);
+}
+
+static void _respondClose(
+    WsmProcessor& processor,
+    CIMOperationRequestMessage* request,
+    const String& enumerationContext)
+{
+    AutoPtr<CIMOperationRequestMessage> requestDestroyer(request);
+    PEGASUS_TEST_ASSERT(
+        request->getType() == CIM_CLOSE_ENUMERATION_REQUEST_MESSAGE);
+    PEGASUS_TEST_ASSERT(((CIMCloseEnumerationRequestMessage*) request)->
+        enumerationContext == enumerationContext);
+    processor.handleResponse(request->buildResponse());
+}
+
+static CIMPullInstancesWithPathRequestMessage* _takePullRequest(
+    TestDispatcher& dispatcher,
+    const String& enumerationContext,
+    Uint32 maxObjectCount)
+{
+    CIMOperationRequestMessage* request = dispatcher.takeRequest();
+    PEGASUS_TEST_ASSERT(
+        request->getType() == CIM_PULL_INSTANCES_WITH_PATH_REQUEST_MESSAGE);
+
+    CIMPullInstancesWithPathRequestMessage* pullRequest =
+        (CIMPullInstancesWithPathRequestMessage*) request;
+    PEGASUS_TEST_ASSERT(
+        pullRequest->enumerationContext == enumerationContext);
+    PEGASUS_TEST_ASSERT(pullRequest->maxObjectCount == maxObjectCount);
+
+    return pullRequest;
+}
+
+static void _testBuffered(
+    WsmProcessor& processor,
+    TestDispatcher& dispatcher,
+    Uint64& contextId)
+{
+    // An Enumerate that is not optimized is buffered: the whole result is
+    // fetched with a single request
+    _enumerate(processor, String::EMPTY, false, 0);
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 1);
+    CIMOperationRequestMessage* request = dispatcher.takeRequest();
+    PEGASUS_TEST_ASSERT(
+        request->getType() == CIM_ENUMERATE_INSTANCES_REQUEST_MESSAGE);
+
+    AutoPtr<CIMOperationRequestMessage> requestDestroyer(request);
+    CIMEnumerateInstancesResponseMessage* response =
+        (CIMEnumerateInstancesResponseMessage*) request->buildResponse();
+    _appendInstances(response->getResponseData(), 5);
+    processor.handleResponse(response);
+    Uint64 buffered = contextId++;
+
+    // The Pulls return the buffered items without further requests
+    _pull(processor, buffered, 3);
+    _pull(processor, buffered, 3);
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 0);
+
+    // The enumeration is complete and its context removed
+    _release(processor, buffered);
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 0);
+}
+
+static void _testStreamedPull(
+    WsmProcessor& processor,
+    TestDispatcher& dispatcher,
+    Uint64& contextId)
+{
+    // An optimized Enumerate with the default expiration is streamed as
+    // well; the open enumeration is refreshed until the enumeration expires
+    _enumerate(processor, String::EMPTY);
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 1);
+    CIMOperationRequestMessage* request = dispatcher.takeRequest();
+    PEGASUS_TEST_ASSERT(request->getType() ==
+        CIM_OPEN_ENUMERATE_INSTANCES_REQUEST_MESSAGE);
+    PEGASUS_TEST_ASSERT(
+        ((CIMOpenEnumerateInstancesRequestMessage*) request)->
+            operationTimeout == PEGASUS_MAX_PULL_OPERATION_TIMEOUT_SECONDS);
+    PEGASUS_TEST_ASSERT(
+        ((CIMOpenEnumerateInstancesRequestMessage*) request)->
+            maxObjectCount == 1);
+    _respond(processor, request, "ctx1", 0, false);
+    Uint64 streamed = contextId++;
+
+    // A Pull fetches its items from the open enumeration
+    _pull(processor, streamed, 5);
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 1);
+    CIMPullInstancesWithPathRequestMessage* pullRequest =
+        _takePullRequest(dispatcher, "ctx1", 5);
+
+    // A Pull or Release while the pull is in progress fails with
+    // wsman:Concurrency and leaves the context as it is
+    _pull(processor, streamed, 5);
+    _release(processor, streamed);
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 0);
+
+    _respond(processor, pullRequest, "ctx1", 5, false);
+
+    // The next Pull continues the open enumeration
+    _pull(processor, streamed, 3);
+    pullRequest = _takePullRequest(dispatcher, "ctx1", 3);
+    _respond(processor, pullRequest, "ctx1", 2, true);
+
+    // The enumeration is complete and its context removed
+    _pull(processor, streamed, 3);
+    _release(processor, streamed);
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 0);
+}
+
+static void _testStreamedRelease(
+    WsmProcessor& processor,
+    TestDispatcher& dispatcher,
+    Uint64& contextId)
+{
+    // The open enumeration of an Enumerate that expires within the
+    // maximum pull operation timeout expires with it
+    _enumerate(processor, "PT30S");
+    CIMOperationRequestMessage* request = dispatcher.takeRequest();
+    PEGASUS_TEST_ASSERT(
+        ((CIMOpenEnumerateInstancesRequestMessage*) request)->
+            operationTimeout == 30);
+    _respond(processor, request, "ctx2", 0, false);
+    Uint64 streamed = contextId++;
+
+    // A Release closes the open enumeration
+    _release(processor, streamed);
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 1);
+    _respondClose(processor, dispatcher.takeRequest(), "ctx2");
+
+    _pull(processor, streamed, 1);
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 0);
+}
+
+static void _testQuotaLimit(
+    WsmProcessor& processor,
+    TestDispatcher& dispatcher,
+    Uint64& contextId)
+{
+    // The CIM server refuses an open enumeration past its cache limits;
+    // no context is created
+    _enumerate(processor, String::EMPTY);
+    _respondError(
+        processor, dispatcher.takeRequest(), CIM_ERR_SERVER_LIMITS_EXCEEDED);
+
+    _pull(processor, contextId, 1);
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 0);
+
+    // The error is reported as wsman:QuotaLimit
+    CimToWsmResponseMapper mapper;
+    WsmFault fault = mapper.mapCimExceptionToWsmFault(
+        PEGASUS_CIM_EXCEPTION(CIM_ERR_SERVER_LIMITS_EXCEEDED, String::EMPTY));
+    PEGASUS_TEST_ASSERT(fault.getSubcode() == "wsman:QuotaLimit");
+}
+
+static void _testExpiration(
+    WsmProcessor& processor,
+    TestDispatcher& dispatcher,
+    Uint64& contextId)
+{
+    _enumerate(processor, "PT1S");
+    CIMOperationRequestMessage* request = dispatcher.takeRequest();
+    PEGASUS_TEST_ASSERT(
+        ((CIMOpenEnumerateInstancesRequestMessage*) request)->
+            operationTimeout == 1);
+    _respond(processor, request, "ctx3", 0, false);
+    Uint64 expired = contextId++;
+
+    _enumerate(processor, "PT1S");
+    _respond(processor, dispatcher.takeRequest(), "ctx4", 0, false);
+    Uint64 pulled = contextId++;
+    _pull(processor, pulled, 1);
+    CIMPullInstancesWithPathRequestMessage* pullRequest =
+        _takePullRequest(dispatcher, "ctx4", 1);
+
+    Threads::sleep(2000);
+
+    // The expired context is removed and its open enumeration closed.  A
+    // context does not expire while a pull is in progress.
+    processor.cleanupExpiredContexts();
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 1);
+    _respondClose(processor, dispatcher.takeRequest(), "ctx3");
+
+    _pull(processor, expired, 1);
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 0);
+
+    _respond(processor, pullRequest, "ctx4", 0, false);
+    processor.cleanupExpiredContexts();
+    PEGASUS_TEST_ASSERT(dispatcher.getRequestCount() == 1);
+    _respondClose(processor, dispatcher.takeRequest(), "ctx4");
+}
+
+int main(int argc, char** argv)
+{
+    verbose = getenv("PEGASUS_TEST_VERBOSE") ? true : false;
+
+    const char* tmpDir = getenv ("PEGASUS_TMP");
+    if (tmpDir == NULL)
+    {
+        repositoryRoot = ".";
+    }
+    else
+    {
+        repositoryRoot = tmpDir;
+    }
+    repositoryRoot.append("/repository");
+
+    FileSystem::removeDirectoryHier(repositoryRoot);
+
+    try
+    {
+        CIMRepository repository(repositoryRoot, CIMRepository::MODE_XML);
+        repository.createNameSpace(NAMESPACE);
+        CIMClass cimClass(CLASSNAME);
+        cimClass.addProperty(CIMProperty(CIMName("prop1"), String::EMPTY));
+        repository.createClass(NAMESPACE, cimClass);
+
+        TestDispatcher dispatcher;
+        WsmProcessor processor(&dispatcher, &repository);
+
+        // Enumeration contexts are numbered from 0
+        Uint64 contextId = 0;
+
+        if (verbose)
+        {
+            cout << "Testing buffered enumeration." << endl;
+        }
+        _testBuffered(processor, dispatcher, contextId);
+
+        if (verbose)
+        {
+            cout << "Testing streamed Pull." << endl;
+        }
+        _testStreamedPull(processor, dispatcher, contextId);
+
+        if (verbose)
+        {
+            cout << "Testing streamed Release." << endl;
+        }
+        _testStreamedRelease(processor, dispatcher, contextId);
+
+        if (verbose)
+        {
+            cout << "Testing quota limit." << endl;
+        }
+        _testQuotaLimit(processor, dispatcher, contextId);
+
+        if (verbose)
+        {
+            cout << "Testing expiration." << endl;
+        }
+        _testExpiration(processor, dispatcher, contextId);
+    }
+    catch (Exception& e)
+    {
+        cerr << "Error: " << e.getMessage() << endl;
+        exit(1);
+    }
+
+    FileSystem::removeDirectoryHier(repositoryRoot);
+
+    cout << argv[0] << " +++++ passed all tests" << endl;
+
+    return 0;
+}
@@ -1225,4 +1225,40 @@ CIMValue WMIClientRep::invokeMethod(
     return(retValue);
 }
 
+CIMResponseData WMIClientRep::openEnumerateInstances(
+    String& enumerationContext,
+    Boolean& endOfSequence,
+    const CIMNamespaceName& nameSpace,
+    const CIMName& className,
+    Boolean deepInheritance,
+    Boolean includeClassOrigin,
+    const CIMPropertyList& propertyList,
+    const String& filterQueryLanguage,
+    const String& filterQuery,
+    Uint32 operationTimeout,
+    Boolean continueOnError,
+    Uint32 maxObjectCount)
+{
+    throw PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED,
+        "openEnumerateInstances()");
+}
+
+CIMResponseData WMIClientRep::pullInstancesWithPath(
+    String& enumerationContext,
+    Boolean& endOfSequence,
+    const CIMNamespaceName& nameSpace,
+    Uint32 maxObjectCount)
+{
+    throw PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED,
+        "pullInstancesWithPath()");
+}
+
+void WMIClientRep::closeEnumeration(
+    const String& enumerationContext,
+    const CIMNamespaceName& nameSpace)
+{
+    throw PEGASUS_CIM_EXCEPTION(CIM_ERR_NOT_SUPPORTED,
+        "closeEnumeration()");
+}
+
 PEGASUS_NAMESPACE_END
@@ -299,6 +299,30 @@ public:
     Array<CIMParamValue>& outParameters
     );
 
+    virtual CIMResponseData openEnumerateInstances(
+        String& enumerationContext,
+        Boolean& endOfSequence,
+        const CIMNamespaceName& nameSpace,
+        const CIMName& className,
+        Boolean deepInheritance,
+        Boolean includeClassOrigin,
+        const CIMPropertyList& propertyList,
+        const String& filterQueryLanguage,
+        const String& filterQuery,
+        Uint32 operationTimeout,
+        Boolean continueOnError,
+        Uint32 maxObjectCount);
+
+    virtual CIMResponseData pullInstancesWithPath(
+        String& enumerationContext,
+        Boolean& endOfSequence,
+        const CIMNamespaceName& nameSpace,
+        Uint32 maxObjectCount);
+
+    virtual void closeEnumeration(
+        const String& enumerationContext,
+        const CIMNamespaceName& nameSpace);
+
 private:
     Boolean _connected;
     Uint32 _timeoutMilliseconds;